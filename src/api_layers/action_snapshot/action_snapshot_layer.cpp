@@ -0,0 +1,625 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Answers xrGetActionState* calls from a snapshot of the action states taken at xrSyncActions.
+//
+// Action states only change at xrSyncActions.  The layer remembers which (action, subactionPath) pairs
+// the application queried since the previous sync, and when xrSyncActions returns it gets the state of
+// each of them from the runtime into a flat table.  Until the next sync, queries for those pairs are
+// answered from the table; queries for other pairs are passed down and their result added to it.
+// xrAttachSessionActionSets, xrSuggestInteractionProfileBindings and
+// XrEventDataInteractionProfileChanged drop the snapshot, and queries are passed down until the next
+// xrSyncActions.
+
+#include "platform_utils.hpp"
+#include "xr_generated_dispatch_table.h"
+
+#include <openxr/openxr.h>
+#include <openxr/openxr_loader_negotiation.h>
+
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef __ANDROID__
+#include "android/log.h"
+#endif
+
+#if defined(__GNUC__) && __GNUC__ >= 4
+#define LAYER_EXPORT __attribute__((visibility("default")))
+#elif defined(__SUNPRO_C) && (__SUNPRO_C >= 0x590)
+#define LAYER_EXPORT __attribute__((visibility("default")))
+#elif defined(_WIN32)
+#define LAYER_EXPORT __declspec(dllexport)
+#else
+#define LAYER_EXPORT
+#endif
+
+// For routing platform_utils.hpp messages.
+void LogPlatformUtilsError(const std::string &message) {
+    (void)message;  // maybe unused
+#if !defined(NDEBUG)
+    std::cerr << message << std::endl;
+#endif
+
+#if defined(XR_OS_WINDOWS)
+    OutputDebugStringA((message + "\n").c_str());
+#elif defined(XR_OS_ANDROID)
+    __android_log_write(ANDROID_LOG_ERROR, "OpenXR-ActionSnapshot", message.c_str());
+#endif
+}
+
+// Which xrGetActionState* command a table entry was queried with.
+enum ActionStateKind : uint32_t {
+    ACTION_STATE_BOOLEAN,
+    ACTION_STATE_FLOAT,
+    ACTION_STATE_VECTOR2F,
+    ACTION_STATE_POSE,
+};
+
+struct ActionStateKey {
+    XrAction action;
+    XrPath subaction_path;
+    ActionStateKind kind;
+
+    bool operator==(const ActionStateKey &other) const {
+        return action == other.action && subaction_path == other.subaction_path && kind == other.kind;
+    }
+};
+
+union ActionState {
+    XrActionStateBoolean boolean;
+    XrActionStateFloat float_state;
+    XrActionStateVector2f vector2f;
+    XrActionStatePose pose;
+};
+
+struct ActionStateEntry {
+    // The state is only returned once it has been filled in since the last sync.
+    bool valid;
+    // Queried by the application since the last sync, so it is fetched again at the next one.
+    bool queried;
+    ActionState state;
+};
+
+struct SessionSnapshot {
+    // Set when xrSyncActions returns; cleared when the snapshot is dropped.
+    bool synced = false;
+    // Changes whenever the states are invalidated, so results of calls that started before are not stored.
+    uint64_t generation = 0;
+    // Keys and states are kept apart so that a lookup only scans the keys.
+    std::vector<ActionStateKey> keys;
+    std::vector<ActionStateEntry> entries;
+
+    size_t Find(const ActionStateKey &key) const {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (keys[i] == key) {
+                return i;
+            }
+        }
+        return keys.size();
+    }
+
+    void Invalidate() {
+        for (ActionStateEntry &entry : entries) {
+            entry.valid = false;
+        }
+        synced = false;
+        generation++;
+    }
+
+    template <typename Predicate>
+    void EraseIf(Predicate predicate) {
+        size_t kept = 0;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (!predicate(keys[i], entries[i])) {
+                keys[kept] = keys[i];
+                entries[kept] = entries[i];
+                kept++;
+            }
+        }
+        keys.resize(kept);
+        entries.resize(kept);
+        generation++;
+    }
+};
+
+// The layer supports one instance at a time; a second xrCreateInstance replaces the dispatch table.
+static XrGeneratedDispatchTable *g_next_dispatch = nullptr;
+// Guards everything below.  Held only briefly, never during a call down the chain.
+static std::mutex g_snapshot_mutex;
+static std::unordered_map<XrSession, std::unique_ptr<SessionSnapshot>> g_sessions;
+// The action set of each action, to forget the actions of a destroyed action set.
+static std::unordered_map<XrAction, XrActionSet> g_action_sets;
+
+// The state structure and command of each kind of action state.
+template <typename State>
+struct ActionStateTraits;
+
+template <>
+struct ActionStateTraits<XrActionStateBoolean> {
+    static constexpr XrStructureType kType = XR_TYPE_ACTION_STATE_BOOLEAN;
+    static constexpr ActionStateKind kKind = ACTION_STATE_BOOLEAN;
+    static XrActionStateBoolean &Get(ActionState &state) { return state.boolean; }
+    static XrResult Next(XrSession session, const XrActionStateGetInfo *getInfo, XrActionStateBoolean *state) {
+        return g_next_dispatch->GetActionStateBoolean(session, getInfo, state);
+    }
+};
+
+template <>
+struct ActionStateTraits<XrActionStateFloat> {
+    static constexpr XrStructureType kType = XR_TYPE_ACTION_STATE_FLOAT;
+    static constexpr ActionStateKind kKind = ACTION_STATE_FLOAT;
+    static XrActionStateFloat &Get(ActionState &state) { return state.float_state; }
+    static XrResult Next(XrSession session, const XrActionStateGetInfo *getInfo, XrActionStateFloat *state) {
+        return g_next_dispatch->GetActionStateFloat(session, getInfo, state);
+    }
+};
+
+template <>
+struct ActionStateTraits<XrActionStateVector2f> {
+    static constexpr XrStructureType kType = XR_TYPE_ACTION_STATE_VECTOR2F;
+    static constexpr ActionStateKind kKind = ACTION_STATE_VECTOR2F;
+    static XrActionStateVector2f &Get(ActionState &state) { return state.vector2f; }
+    static XrResult Next(XrSession session, const XrActionStateGetInfo *getInfo, XrActionStateVector2f *state) {
+        return g_next_dispatch->GetActionStateVector2f(session, getInfo, state);
+    }
+};
+
+template <>
+struct ActionStateTraits<XrActionStatePose> {
+    static constexpr XrStructureType kType = XR_TYPE_ACTION_STATE_POSE;
+    static constexpr ActionStateKind kKind = ACTION_STATE_POSE;
+    static XrActionStatePose &Get(ActionState &state) { return state.pose; }
+    static XrResult Next(XrSession session, const XrActionStateGetInfo *getInfo, XrActionStatePose *state) {
+        return g_next_dispatch->GetActionStatePose(session, getInfo, state);
+    }
+};
+
+// Copy a state into the application's structure, leaving its type and next chain alone.
+template <typename State>
+static void CopyActionState(const State &from, State *to) {
+    void *next = to->next;
+    *to = from;
+    to->type = ActionStateTraits<State>::kType;
+    to->next = next;
+}
+
+// Get one state from the next layer into an entry of the table.
+static XrResult FetchActionState(XrSession session, const ActionStateKey &key, ActionState &state) {
+    XrActionStateGetInfo get_info{XR_TYPE_ACTION_STATE_GET_INFO};
+    get_info.action = key.action;
+    get_info.subactionPath = key.subaction_path;
+    switch (key.kind) {
+        case ACTION_STATE_BOOLEAN:
+            state.boolean = {XR_TYPE_ACTION_STATE_BOOLEAN};
+            return g_next_dispatch->GetActionStateBoolean(session, &get_info, &state.boolean);
+        case ACTION_STATE_FLOAT:
+            state.float_state = {XR_TYPE_ACTION_STATE_FLOAT};
+            return g_next_dispatch->GetActionStateFloat(session, &get_info, &state.float_state);
+        case ACTION_STATE_VECTOR2F:
+            state.vector2f = {XR_TYPE_ACTION_STATE_VECTOR2F};
+            return g_next_dispatch->GetActionStateVector2f(session, &get_info, &state.vector2f);
+        case ACTION_STATE_POSE:
+            state.pose = {XR_TYPE_ACTION_STATE_POSE};
+            return g_next_dispatch->GetActionStatePose(session, &get_info, &state.pose);
+    }
+    return XR_ERROR_RUNTIME_FAILURE;
+}
+
+template <typename State>
+static XrResult GetActionState(XrSession session, const XrActionStateGetInfo *getInfo, State *state) {
+    using Traits = ActionStateTraits<State>;
+    // Only plain queries are answered from the table.
+    if (getInfo == nullptr || getInfo->type != XR_TYPE_ACTION_STATE_GET_INFO || getInfo->next != nullptr || state == nullptr ||
+        state->type != Traits::kType || state->next != nullptr) {
+        return Traits::Next(session, getInfo, state);
+    }
+
+    const ActionStateKey key{getInfo->action, getInfo->subactionPath, Traits::kKind};
+    uint64_t generation = 0;
+    {
+        std::unique_lock<std::mutex> lock(g_snapshot_mutex);
+        auto it = g_sessions.find(session);
+        if (it == g_sessions.end() || !it->second->synced) {
+            lock.unlock();
+            return Traits::Next(session, getInfo, state);
+        }
+        SessionSnapshot &snapshot = *it->second;
+        size_t index = snapshot.Find(key);
+        if (index == snapshot.keys.size()) {
+            snapshot.keys.push_back(key);
+            snapshot.entries.push_back(ActionStateEntry{});
+        }
+        ActionStateEntry &entry = snapshot.entries[index];
+        entry.queried = true;
+        if (entry.valid) {
+            CopyActionState(Traits::Get(entry.state), state);
+            return XR_SUCCESS;
+        }
+        generation = snapshot.generation;
+    }
+
+    XrResult result = Traits::Next(session, getInfo, state);
+    if (result == XR_SUCCESS) {
+        std::unique_lock<std::mutex> lock(g_snapshot_mutex);
+        auto it = g_sessions.find(session);
+        if (it != g_sessions.end() && it->second->generation == generation) {
+            SessionSnapshot &snapshot = *it->second;
+            size_t index = snapshot.Find(key);
+            if (index != snapshot.keys.size()) {
+                ActionStateEntry &entry = snapshot.entries[index];
+                Traits::Get(entry.state) = *state;
+                Traits::Get(entry.state).next = nullptr;
+                entry.valid = true;
+            }
+        }
+    }
+    return result;
+}
+
+PFN_xrVoidFunction ActionSnapshotLayerInnerGetInstanceProcAddr(const char *name);
+
+XRAPI_ATTR XrResult XRAPI_CALL ActionSnapshotLayerXrDestroyInstance(XrInstance instance) {
+    XrGeneratedDispatchTable *next_dispatch = g_next_dispatch;
+    XrResult result = next_dispatch->DestroyInstance(instance);
+
+    {
+        std::unique_lock<std::mutex> lock(g_snapshot_mutex);
+        g_sessions.clear();
+        g_action_sets.clear();
+    }
+
+    g_next_dispatch = nullptr;
+    delete next_dispatch;
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ActionSnapshotLayerXrPollEvent(XrInstance instance, XrEventDataBuffer *eventData) {
+    XrResult result = g_next_dispatch->PollEvent(instance, eventData);
+    if (result == XR_SUCCESS && eventData->type == XR_TYPE_EVENT_DATA_INTERACTION_PROFILE_CHANGED) {
+        // The bindings changed, so the snapshot may no longer say what the next query would.
+        const auto *profile_changed = reinterpret_cast<const XrEventDataInteractionProfileChanged *>(eventData);
+        std::unique_lock<std::mutex> lock(g_snapshot_mutex);
+        auto it = g_sessions.find(profile_changed->session);
+        if (it != g_sessions.end()) {
+            it->second->Invalidate();
+        }
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ActionSnapshotLayerXrCreateSession(XrInstance instance, const XrSessionCreateInfo *createInfo,
+                                                                  XrSession *session) {
+    XrResult result = g_next_dispatch->CreateSession(instance, createInfo, session);
+    if (XR_SUCCEEDED(result)) {
+        std::unique_lock<std::mutex> lock(g_snapshot_mutex);
+        g_sessions[*session].reset(new SessionSnapshot());
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ActionSnapshotLayerXrDestroySession(XrSession session) {
+    {
+        std::unique_lock<std::mutex> lock(g_snapshot_mutex);
+        g_sessions.erase(session);
+    }
+    return g_next_dispatch->DestroySession(session);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ActionSnapshotLayerXrDestroyActionSet(XrActionSet actionSet) {
+    {
+        std::unique_lock<std::mutex> lock(g_snapshot_mutex);
+        // Destroying an action set destroys its actions too.
+        for (auto &session : g_sessions) {
+            session.second->EraseIf([actionSet](const ActionStateKey &key, const ActionStateEntry &) {
+                auto action_set = g_action_sets.find(key.action);
+                return action_set != g_action_sets.end() && action_set->second == actionSet;
+            });
+        }
+        for (auto it = g_action_sets.begin(); it != g_action_sets.end();) {
+            if (it->second == actionSet) {
+                it = g_action_sets.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    return g_next_dispatch->DestroyActionSet(actionSet);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ActionSnapshotLayerXrCreateAction(XrActionSet actionSet, const XrActionCreateInfo *createInfo,
+                                                                 XrAction *action) {
+    XrResult result = g_next_dispatch->CreateAction(actionSet, createInfo, action);
+    if (XR_SUCCEEDED(result)) {
+        std::unique_lock<std::mutex> lock(g_snapshot_mutex);
+        g_action_sets[*action] = actionSet;
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ActionSnapshotLayerXrDestroyAction(XrAction action) {
+    {
+        std::unique_lock<std::mutex> lock(g_snapshot_mutex);
+        for (auto &session : g_sessions) {
+            session.second->EraseIf([action](const ActionStateKey &key, const ActionStateEntry &) { return key.action == action; });
+        }
+        g_action_sets.erase(action);
+    }
+    return g_next_dispatch->DestroyAction(action);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ActionSnapshotLayerXrSuggestInteractionProfileBindings(
+    XrInstance instance, const XrInteractionProfileSuggestedBinding *suggestedBindings) {
+    XrResult result = g_next_dispatch->SuggestInteractionProfileBindings(instance, suggestedBindings);
+    if (XR_SUCCEEDED(result)) {
+        std::unique_lock<std::mutex> lock(g_snapshot_mutex);
+        for (auto &session : g_sessions) {
+            session.second->Invalidate();
+        }
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ActionSnapshotLayerXrAttachSessionActionSets(XrSession session,
+                                                                            const XrSessionActionSetsAttachInfo *attachInfo) {
+    XrResult result = g_next_dispatch->AttachSessionActionSets(session, attachInfo);
+    if (XR_SUCCEEDED(result)) {
+        std::unique_lock<std::mutex> lock(g_snapshot_mutex);
+        auto it = g_sessions.find(session);
+        if (it != g_sessions.end()) {
+            it->second->EraseIf([](const ActionStateKey &, const ActionStateEntry &) { return true; });
+            it->second->Invalidate();
+        }
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ActionSnapshotLayerXrSyncActions(XrSession session, const XrActionsSyncInfo *syncInfo) {
+    // Reused between syncs, so that taking the snapshot does not allocate every frame.
+    static thread_local std::vector<ActionStateKey> keys;
+    static thread_local std::vector<ActionState> states;
+    static thread_local std::vector<XrResult> results;
+
+    {
+        // Queries made while the sync is under way must not be answered from the old states.
+        std::unique_lock<std::mutex> lock(g_snapshot_mutex);
+        auto it = g_sessions.find(session);
+        if (it != g_sessions.end()) {
+            it->second->Invalidate();
+        }
+    }
+
+    XrResult result = g_next_dispatch->SyncActions(session, syncInfo);
+    if (XR_FAILED(result)) {
+        return result;
+    }
+
+    // Keep the pairs queried since the previous sync, and fetch their new states.
+    uint64_t generation = 0;
+    keys.clear();
+    {
+        std::unique_lock<std::mutex> lock(g_snapshot_mutex);
+        auto it = g_sessions.find(session);
+        if (it == g_sessions.end()) {
+            return result;
+        }
+        SessionSnapshot &snapshot = *it->second;
+        snapshot.EraseIf([](const ActionStateKey &, const ActionStateEntry &entry) { return !entry.queried; });
+        for (ActionStateEntry &entry : snapshot.entries) {
+            entry.queried = false;
+        }
+        keys = snapshot.keys;
+        generation = snapshot.generation;
+    }
+
+    states.resize(keys.size());
+    results.resize(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        results[i] = FetchActionState(session, keys[i], states[i]);
+    }
+
+    std::unique_lock<std::mutex> lock(g_snapshot_mutex);
+    auto it = g_sessions.find(session);
+    if (it != g_sessions.end() && it->second->generation == generation) {
+        SessionSnapshot &snapshot = *it->second;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            snapshot.entries[i].valid = results[i] == XR_SUCCESS;
+            snapshot.entries[i].state = states[i];
+        }
+        snapshot.synced = true;
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ActionSnapshotLayerXrGetActionStateBoolean(XrSession session, const XrActionStateGetInfo *getInfo,
+                                                                          XrActionStateBoolean *state) {
+    return GetActionState(session, getInfo, state);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ActionSnapshotLayerXrGetActionStateFloat(XrSession session, const XrActionStateGetInfo *getInfo,
+                                                                        XrActionStateFloat *state) {
+    return GetActionState(session, getInfo, state);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ActionSnapshotLayerXrGetActionStateVector2f(XrSession session, const XrActionStateGetInfo *getInfo,
+                                                                           XrActionStateVector2f *state) {
+    return GetActionState(session, getInfo, state);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ActionSnapshotLayerXrGetActionStatePose(XrSession session, const XrActionStateGetInfo *getInfo,
+                                                                       XrActionStatePose *state) {
+    return GetActionState(session, getInfo, state);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ActionSnapshotLayerXrGetInstanceProcAddr(XrInstance instance, const char *name,
+                                                                        PFN_xrVoidFunction *function) {
+    try {
+        *function = ActionSnapshotLayerInnerGetInstanceProcAddr(name);
+
+        if (*function != nullptr) {
+            return XR_SUCCESS;
+        }
+
+        // We have not found it, so pass it down to the next layer/runtime
+        if (nullptr == g_next_dispatch) {
+            return XR_ERROR_HANDLE_INVALID;
+        }
+        return g_next_dispatch->GetInstanceProcAddr(instance, name, function);
+    } catch (...) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ActionSnapshotLayerXrCreateApiLayerInstance(const XrInstanceCreateInfo *info,
+                                                                           const struct XrApiLayerCreateInfo *apiLayerInfo,
+                                                                           XrInstance *instance) {
+    try {
+        XrApiLayerCreateInfo new_api_layer_info = {};
+
+        // Validate the API layer info and next API layer info structures before we try to use them
+        if (nullptr == apiLayerInfo || XR_LOADER_INTERFACE_STRUCT_API_LAYER_CREATE_INFO != apiLayerInfo->structType ||
+            XR_API_LAYER_CREATE_INFO_STRUCT_VERSION > apiLayerInfo->structVersion ||
+            sizeof(XrApiLayerCreateInfo) > apiLayerInfo->structSize || nullptr == apiLayerInfo->nextInfo ||
+            XR_LOADER_INTERFACE_STRUCT_API_LAYER_NEXT_INFO != apiLayerInfo->nextInfo->structType ||
+            XR_API_LAYER_NEXT_INFO_STRUCT_VERSION > apiLayerInfo->nextInfo->structVersion ||
+            sizeof(XrApiLayerNextInfo) > apiLayerInfo->nextInfo->structSize ||
+            0 != strcmp("XR_APILAYER_KHRONOS_action_snapshot", apiLayerInfo->nextInfo->layerName) ||
+            nullptr == apiLayerInfo->nextInfo->nextGetInstanceProcAddr ||
+            nullptr == apiLayerInfo->nextInfo->nextCreateApiLayerInstance) {
+            return XR_ERROR_INITIALIZATION_FAILED;
+        }
+
+        // Copy the contents of the layer info struct, but then move the next info up by
+        // one slot so that the next layer gets information.
+        memcpy(&new_api_layer_info, apiLayerInfo, sizeof(XrApiLayerCreateInfo));
+        new_api_layer_info.nextInfo = apiLayerInfo->nextInfo->next;
+
+        // Get the function pointers we need
+        PFN_xrGetInstanceProcAddr next_get_instance_proc_addr = apiLayerInfo->nextInfo->nextGetInstanceProcAddr;
+        PFN_xrCreateApiLayerInstance next_create_api_layer_instance = apiLayerInfo->nextInfo->nextCreateApiLayerInstance;
+
+        // Create the instance using the layer create instance command for the next layer
+        XrInstance returned_instance = *instance;
+        XrResult result = next_create_api_layer_instance(info, &new_api_layer_info, &returned_instance);
+        *instance = returned_instance;
+
+        if (XR_SUCCEEDED(result)) {
+            // Create the dispatch table to the next levels
+            auto *next_dispatch = new XrGeneratedDispatchTable();
+            GeneratedXrPopulateDispatchTable(next_dispatch, returned_instance, next_get_instance_proc_addr);
+            delete g_next_dispatch;
+            g_next_dispatch = next_dispatch;
+        }
+
+        return result;
+    } catch (...) {
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+}
+
+// Function used to negotiate an interface betewen the loader and an API layer.  Each library exposing one or
+// more API layers needs to expose at least this function.
+extern "C" LAYER_EXPORT XRAPI_ATTR XrResult XRAPI_CALL xrNegotiateLoaderApiLayerInterface(
+    const XrNegotiateLoaderInfo *loaderInfo, const char * /*apiLayerName*/, XrNegotiateApiLayerRequest *apiLayerRequest) {
+    if (loaderInfo == nullptr || loaderInfo->structType != XR_LOADER_INTERFACE_STRUCT_LOADER_INFO ||
+        loaderInfo->structVersion != XR_LOADER_INFO_STRUCT_VERSION || loaderInfo->structSize != sizeof(XrNegotiateLoaderInfo)) {
+        LogPlatformUtilsError("loaderInfo struct is not valid");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (loaderInfo->minInterfaceVersion > XR_CURRENT_LOADER_API_LAYER_VERSION ||
+        loaderInfo->maxInterfaceVersion < XR_CURRENT_LOADER_API_LAYER_VERSION) {
+        LogPlatformUtilsError("loader interface version is not in the range [minInterfaceVersion, maxInterfaceVersion]");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (loaderInfo->minApiVersion > XR_CURRENT_API_VERSION || loaderInfo->maxApiVersion < XR_CURRENT_API_VERSION) {
+        LogPlatformUtilsError("loader api version is not in the range [minApiVersion, maxApiVersion]");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (apiLayerRequest == nullptr || apiLayerRequest->structType != XR_LOADER_INTERFACE_STRUCT_API_LAYER_REQUEST ||
+        apiLayerRequest->structVersion != XR_API_LAYER_INFO_STRUCT_VERSION ||
+        apiLayerRequest->structSize != sizeof(XrNegotiateApiLayerRequest)) {
+        LogPlatformUtilsError("apiLayerRequest is not valid");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    apiLayerRequest->layerInterfaceVersion = XR_CURRENT_LOADER_API_LAYER_VERSION;
+    apiLayerRequest->layerApiVersion = XR_CURRENT_API_VERSION;
+    apiLayerRequest->getInstanceProcAddr = ActionSnapshotLayerXrGetInstanceProcAddr;
+    apiLayerRequest->createApiLayerInstance = ActionSnapshotLayerXrCreateApiLayerInstance;
+
+    return XR_SUCCESS;
+}
+
+PFN_xrVoidFunction ActionSnapshotLayerInnerGetInstanceProcAddr(const char *name) {
+    std::string func_name = name;
+
+    if (func_name == "xrGetInstanceProcAddr") {
+        return reinterpret_cast<PFN_xrVoidFunction>(ActionSnapshotLayerXrGetInstanceProcAddr);
+    }
+    if (func_name == "xrDestroyInstance") {
+        return reinterpret_cast<PFN_xrVoidFunction>(ActionSnapshotLayerXrDestroyInstance);
+    }
+    if (func_name == "xrPollEvent") {
+        return reinterpret_cast<PFN_xrVoidFunction>(ActionSnapshotLayerXrPollEvent);
+    }
+    if (func_name == "xrCreateSession") {
+        return reinterpret_cast<PFN_xrVoidFunction>(ActionSnapshotLayerXrCreateSession);
+    }
+    if (func_name == "xrDestroySession") {
+        return reinterpret_cast<PFN_xrVoidFunction>(ActionSnapshotLayerXrDestroySession);
+    }
+    if (func_name == "xrDestroyActionSet") {
+        return reinterpret_cast<PFN_xrVoidFunction>(ActionSnapshotLayerXrDestroyActionSet);
+    }
+    if (func_name == "xrCreateAction") {
+        return reinterpret_cast<PFN_xrVoidFunction>(ActionSnapshotLayerXrCreateAction);
+    }
+    if (func_name == "xrDestroyAction") {
+        return reinterpret_cast<PFN_xrVoidFunction>(ActionSnapshotLayerXrDestroyAction);
+    }
+    if (func_name == "xrSuggestInteractionProfileBindings") {
+        return reinterpret_cast<PFN_xrVoidFunction>(ActionSnapshotLayerXrSuggestInteractionProfileBindings);
+    }
+    if (func_name == "xrAttachSessionActionSets") {
+        return reinterpret_cast<PFN_xrVoidFunction>(ActionSnapshotLayerXrAttachSessionActionSets);
+    }
+    if (func_name == "xrSyncActions") {
+        return reinterpret_cast<PFN_xrVoidFunction>(ActionSnapshotLayerXrSyncActions);
+    }
+    if (func_name == "xrGetActionStateBoolean") {
+        return reinterpret_cast<PFN_xrVoidFunction>(ActionSnapshotLayerXrGetActionStateBoolean);
+    }
+    if (func_name == "xrGetActionStateFloat") {
+        return reinterpret_cast<PFN_xrVoidFunction>(ActionSnapshotLayerXrGetActionStateFloat);
+    }
+    if (func_name == "xrGetActionStateVector2f") {
+        return reinterpret_cast<PFN_xrVoidFunction>(ActionSnapshotLayerXrGetActionStateVector2f);
+    }
+    if (func_name == "xrGetActionStatePose") {
+        return reinterpret_cast<PFN_xrVoidFunction>(ActionSnapshotLayerXrGetActionStatePose);
+    }
+    return nullptr;
+}
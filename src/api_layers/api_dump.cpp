@@ -20,10 +20,15 @@
 // Author: Dave Houlton <daveh@lunarg.com>
 //
 
+#include "api_dump_binary.h"
+#include "api_dump_filter.h"
+#include "api_dump_format.h"
+#include "api_dump_writer.h"
 #include "hex_and_handles.h"
 #include "platform_utils.hpp"
 #include "xr_generated_api_dump.hpp"
 #include "xr_generated_dispatch_table.h"
+#include "xr_layer_handle_data.h"
 
 #include <openxr/openxr.h>
 #include <openxr/openxr_loader_negotiation.h>
@@ -34,10 +39,8 @@
 #include <fstream>
 #include <iostream>
 #include <mutex>
-#include <sstream>
 #include <stdexcept>
 #include <string>
-#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -62,6 +65,7 @@ enum ApiDumpRecordType {
     RECORD_TEXT_FILE,
     RECORD_HTML_FILE,
     RECORD_CODE_FILE,
+    RECORD_BINARY_FILE,
 };
 
 struct ApiDumpRecordInfo {
@@ -71,7 +75,38 @@ struct ApiDumpRecordInfo {
 };
 
 static ApiDumpRecordInfo g_record_info = {};
-static std::mutex g_record_mutex = {};
+
+// Loader-provided per-handle slots, used in place of the dispatch maps when the loader offers them.
+static XrLayerHandleDataTable *g_handle_data_table = nullptr;
+static uint32_t g_handle_data_slot = 0;
+
+XrGeneratedDispatchTable *ApiDumpLayerGetHandleDispatchTable(XrObjectType object_type, uint64_t handle) {
+    if (nullptr == g_handle_data_table) {
+        return nullptr;
+    }
+    return static_cast<XrGeneratedDispatchTable *>(
+        XrLayerHandleDataGet(g_handle_data_table, object_type, handle, g_handle_data_slot));
+}
+
+void ApiDumpLayerSetHandleDispatchTable(XrObjectType object_type, uint64_t handle, XrGeneratedDispatchTable *table) {
+    if (nullptr != g_handle_data_table) {
+        // On failure the handle is simply found through the dispatch maps instead.
+        (void)g_handle_data_table->set(object_type, handle, g_handle_data_slot, table);
+    }
+}
+
+static void ApiDumpLayerAcquireHandleDataSlot(XrInstance instance, PFN_xrGetInstanceProcAddr next_get_instance_proc_addr) {
+    PFN_xrGetLayerHandleDataTableLOADER get_table = nullptr;
+    XrLayerHandleDataTable *table = nullptr;
+    if (XR_SUCCEEDED(next_get_instance_proc_addr(instance, XR_LOADER_LAYER_HANDLE_DATA_FUNCTION_NAME,
+                                                 reinterpret_cast<PFN_xrVoidFunction *>(&get_table))) &&
+        nullptr != get_table && XR_SUCCEEDED(get_table(instance, &table)) && XrLayerHandleDataTableIsCompatible(table) &&
+        XR_SUCCEEDED(table->acquire_slot("XR_APILAYER_LUNARG_api_dump", &g_handle_data_slot))) {
+        g_handle_data_table = table;
+    } else {
+        g_handle_data_table = nullptr;
+    }
+}
 
 // For routing platform_utils.hpp messages.
 void LogPlatformUtilsError(const std::string &message) {
@@ -90,107 +125,10 @@ void LogPlatformUtilsError(const std::string &message) {
 // HTML utilities
 bool ApiDumpLayerWriteHtmlHeader() {
     try {
-        std::unique_lock<std::mutex> mlock(g_record_mutex);
-        std::ofstream html_file;
-        html_file.open(g_record_info.file_name, std::ios::out);
-        html_file << "<!doctype html>\n"
-                     "<html>\n"
-                     "    <head>\n"
-                     "        <title>OpenXR API Dump</title>\n"
-                     "        <style type='text/css'>\n"
-                     "        html {\n"
-                     "            background-color: #0b1e48;\n"
-                     "            background-image: url('https://vulkan.lunarg.com/img/bg-starfield.jpg');\n"
-                     "            background-position: center;\n"
-                     "            -webkit-background-size: cover;\n"
-                     "            -moz-background-size: cover;\n"
-                     "            -o-background-size: cover;\n"
-                     "            background-size: cover;\n"
-                     "            background-attachment: fixed;\n"
-                     "            background-repeat: no-repeat;\n"
-                     "            height: 100%;\n"
-                     "        }\n"
-                     "        #header {\n"
-                     "            z-index: -1;\n"
-                     "        }\n"
-                     "        #header>img {\n"
-                     "            position: absolute;\n"
-                     "            width: 160px;\n"
-                     "            margin-left: -280px;\n"
-                     "            top: -10px;\n"
-                     "            left: 50%;\n"
-                     "        }\n"
-                     "        #header>h1 {\n"
-                     "            font-family: Arial, 'Helvetica Neue', Helvetica, sans-serif;\n"
-                     "            font-size: 44px;\n"
-                     "            font-weight: 200;\n"
-                     "            text-shadow: 4px 4px 5px #000;\n"
-                     "            color: #eee;\n"
-                     "            position: absolute;\n"
-                     "            width: 400px;\n"
-                     "            margin-left: -80px;\n"
-                     "            top: 8px;\n"
-                     "            left: 50%;\n"
-                     "        }\n"
-                     "        body {\n"
-                     "            font-family: Consolas, monaco, monospace;\n"
-                     "            font-size: 14px;\n"
-                     "            line-height: 20px;\n"
-                     "            color: #eee;\n"
-                     "            height: 100%;\n"
-                     "            margin: 0;\n"
-                     "            overflow: hidden;\n"
-                     "        }\n"
-                     "        #wrapper {\n"
-                     "            background-color: rgba(0, 0, 0, 0.7);\n"
-                     "            border: 1px solid #446;\n"
-                     "            box-shadow: 0px 0px 10px #000;\n"
-                     "            padding: 8px 12px;\n"
-                     "            display: inline-block;\n"
-                     "            position: absolute;\n"
-                     "            top: 80px;\n"
-                     "            bottom: 25px;\n"
-                     "            left: 50px;\n"
-                     "            right: 50px;\n"
-                     "            overflow: auto;\n"
-                     "        }\n"
-                     "        details>*:not(summary) {\n"
-                     "            margin-left: 22px;\n"
-                     "        }\n"
-                     "        summary:only-child {\n"
-                     "            display: block;\n"
-                     "            padding-left: 15px;\n"
-                     "        }\n"
-                     "        details>summary:only-child::-webkit-details-marker {\n"
-                     "            display: none;\n"
-                     "            padding-left: 15px;\n"
-                     "        }\n"
-                     "        .headervar, .headertype, .headerval {\n"
-                     "            display: inline;\n"
-                     "            margin: 0 9px;\n"
-                     "        }\n"
-                     "        .var, .type, .val {\n"
-                     "            display: inline;\n"
-                     "            margin: 0 6px;\n"
-                     "        }\n"
-                     "        .headertype, .type {\n"
-                     "            color: #acf;\n"
-                     "        }\n"
-                     "        .headerval, .val {\n"
-                     "            color: #afa;\n"
-                     "            text-align: right;\n"
-                     "        }\n"
-                     "        .thd {\n"
-                     "            color: #888;\n"
-                     "        }\n"
-                     "        </style>\n"
-                     "    </head>\n"
-                     "    <body>\n"
-                     "        <div id='header'>\n"
-                     "            <img src='https://lunarg.com/wp-content/uploads/2016/02/LunarG-wReg-150.png' />\n"
-                     "            <h1>OpenXR API Dump</h1>\n"
-                     "        </div>\n"
-                     "        <div id='wrapper'>\n";
+        if (!GetApiDumpWriter().Open(g_record_info.file_name, true)) {
+            return false;
+        }
+        GetApiDumpWriter().WriteDirect(kApiDumpHtmlHeader);
         return true;
     } catch (...) {
         return false;
@@ -199,12 +137,8 @@ bool ApiDumpLayerWriteHtmlHeader() {
 
 bool ApiDumpLayerWriteHtmlFooter() {
     try {
-        std::unique_lock<std::mutex> mlock(g_record_mutex);
-        std::ofstream html_file;
-        html_file.open(g_record_info.file_name, std::ios::out | std::ios::app);
-        html_file << "        </div>\n"
-                     "    </body>\n"
-                     "</html>";
+        GetApiDumpWriter().WriteDirect(kApiDumpHtmlFooter);
+        GetApiDumpWriter().Close();
 
         // Writing the footer means we're done.
         if (g_record_info.initialized) {
@@ -218,6 +152,72 @@ bool ApiDumpLayerWriteHtmlFooter() {
     }
 }
 
+// Binary capture utilities.  The file header is only written when the file is first created; later
+// instances in the same process append to it.
+static bool ApiDumpLayerOpenBinaryFile(bool create) {
+    try {
+        if (!GetApiDumpWriter().Open(g_record_info.file_name, create)) {
+            return false;
+        }
+        if (create) {
+            std::string header(kApiDumpBinaryMagic, sizeof(kApiDumpBinaryMagic));
+            uint32_t version = API_DUMP_BINARY_FORMAT_VERSION;
+            header.append(reinterpret_cast<const char *>(&version), sizeof(version));
+            GetApiDumpWriter().WriteDirect(header);
+        }
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool ApiDumpLayerBinaryEnabled() { return g_record_info.type == RECORD_BINARY_FILE; }
+
+// Hand a finished record to the writer, or hold it back until a call fails in trigger-on-error mode.
+static void ApiDumpLayerAppendRecord(const std::string &record) {
+    if (g_api_dump_filter.TriggerOnError()) {
+        g_api_dump_filter.Hold(record);
+    } else {
+        GetApiDumpWriter().Append(record);
+    }
+}
+
+void ApiDumpLayerRecordBinary(const std::string &record) {
+    if (g_record_info.initialized && GetApiDumpWriter().IsOpen()) {
+        ApiDumpLayerAppendRecord(record);
+    }
+}
+
+void ApiDumpLayerCallFailed() {
+    if (g_api_dump_filter.TriggerOnError() && GetApiDumpWriter().IsOpen()) {
+        g_api_dump_filter.Release(GetApiDumpWriter());
+        GetApiDumpWriter().Flush();
+    }
+}
+
+// Read the filtering and sampling settings.  Settings that cannot be applied are reported and skipped.
+static void ApiDumpLayerConfigureFilter() {
+    ApiDumpFilterSettings settings;
+#if !defined(ANDROID)
+    settings.include = PlatformUtilsGetEnv("XR_API_DUMP_INCLUDE");
+    settings.exclude = PlatformUtilsGetEnv("XR_API_DUMP_EXCLUDE");
+    settings.rate_limit = PlatformUtilsGetEnv("XR_API_DUMP_RATE_LIMIT");
+    settings.frames = PlatformUtilsGetEnv("XR_API_DUMP_FRAMES");
+    settings.trigger_on_error = PlatformUtilsGetEnv("XR_API_DUMP_TRIGGER_ON_ERROR");
+#else
+    settings.include = PlatformUtilsGetAndroidSystemProperty("debug.api_dump_include");
+    settings.exclude = PlatformUtilsGetAndroidSystemProperty("debug.api_dump_exclude");
+    settings.rate_limit = PlatformUtilsGetAndroidSystemProperty("debug.api_dump_rate_limit");
+    settings.frames = PlatformUtilsGetAndroidSystemProperty("debug.api_dump_frames");
+    settings.trigger_on_error = PlatformUtilsGetAndroidSystemProperty("debug.api_dump_trigger_on_error");
+#endif
+    std::vector<std::string> errors;
+    g_api_dump_filter.Configure(settings, kApiDumpBinaryCommandNames, API_DUMP_BINARY_COMMAND_COUNT, errors);
+    for (const std::string &error : errors) {
+        LogPlatformUtilsError(error);
+    }
+}
+
 // Api Dump Utility function to return an instance based on the generated dispatch table
 // pointer.
 XrInstance FindInstanceFromDispatchTable(XrGeneratedDispatchTable *dispatch_table) {
@@ -232,202 +232,33 @@ XrInstance FindInstanceFromDispatchTable(XrGeneratedDispatchTable *dispatch_tabl
     return instance;
 }
 
-// Function to record all the API dump information
-bool ApiDumpLayerRecordContent(std::vector<std::tuple<std::string, std::string, std::string>> contents) {
-    bool success = false;
-    if (g_record_info.initialized) {
-        std::unique_lock<std::mutex> mlock(g_record_mutex);
-        uint32_t count = 0;
-        switch (g_record_info.type) {
-            case RECORD_TEXT_COUT: {
-#if defined(ANDROID)
-#define ALOGI(...)       \
-    printf(__VA_ARGS__); \
-    __android_log_print(ANDROID_LOG_INFO, "api_dump", __VA_ARGS__)
-#else
-#define ALOGI(...) printf(__VA_ARGS__)
-#endif
-                for (const auto &content : contents) {
-                    std::string content_type;
-                    std::string content_name;
-                    std::string content_value;
-                    std::tie(content_type, content_name, content_value) = content;
-
-                    const char *indent = (count++ != 0) ? "    " : "";
-
-                    if (!content_value.empty()) {
-                        ALOGI("%s%s %s = %s", indent, content_type.c_str(), content_name.c_str(), content_value.c_str());
-                    } else {
-                        ALOGI("%s%s %s", indent, content_type.c_str(), content_name.c_str());
-                    }
-                }
-                success = true;
-                break;
-#undef ALOGI
-            }
-            case RECORD_TEXT_FILE: {
-                std::ofstream text_file;
-                text_file.open(g_record_info.file_name, std::ios::out | std::ios::app);
-                for (const auto &content : contents) {
-                    std::string content_type;
-                    std::string content_name;
-                    std::string content_value;
-                    std::tie(content_type, content_name, content_value) = content;
-                    if (count++ != 0) {
-                        text_file << "    ";
-                    }
-                    if (!content_value.empty()) {
-                        text_file << content_type << " " << content_name << " = " << content_value << "\n";
-                    } else {
-                        text_file << content_type << " " << content_name << "\n";
-                    }
-                }
-                text_file.close();
-                success = true;
-                break;
-            }
-            case RECORD_HTML_FILE: {
-                std::ofstream text_file;
-                text_file.open(g_record_info.file_name, std::ios::out | std::ios::app);
-                text_file << "<details class='data'>\n";
-                std::vector<std::string> prefixes;
-                uint32_t last_deref_count = 0;
-                for (uint32_t content_index = 0; content_index < contents.size(); ++content_index) {
-                    std::string content_type;
-                    std::string content_name;
-                    std::string content_value;
-                    std::tie(content_type, content_name, content_value) = contents[content_index];
-                    if (content_index == 0) {
-                        text_file << "   <summary>\n"
-                                  << "      <div class='headertype'>" << content_type << "</div>\n"
-                                  << "      <div class='headervar'>" << content_name << "</div>\n"
-                                  << "   </summary>\n";
-                    } else {
-                        uint32_t cur_deref_count = 0;
-                        uint32_t next_deref_count = 0;
-
-                        // Count number of structure and pointer dereferences for the current line
-                        cur_deref_count = static_cast<uint32_t>(std::count(content_name.begin(), content_name.end(), '.'));
-                        std::string::size_type start = 0;
-                        while ((start = content_name.find("->", start)) != std::string::npos) {
-                            ++cur_deref_count;
-                            start += 2;
-                        }
-                        // Now look for array dereferences
-                        start = 0;
-                        while ((start = content_name.find('[', start)) != std::string::npos) {
-                            ++cur_deref_count;
-                            start++;
-                        }
-
-                        // If there's something after this, see if it's a sub-component of this.
-                        if (content_index < contents.size() - 1) {
-                            std::string next_content_type;
-                            std::string next_content_name;
-                            std::string next_content_value;
-                            std::tie(next_content_type, next_content_name, next_content_value) = contents[content_index + 1];
-
-                            // Count number of structure and pointer dereferences for the next line
-                            next_deref_count =
-                                static_cast<uint32_t>(std::count(next_content_name.begin(), next_content_name.end(), '.'));
-                            start = 0;
-                            while ((start = next_content_name.find("->", start)) != std::string::npos) {
-                                ++next_deref_count;
-                                start += 2;
-                            }
-                            // Now look for array dereferences
-                            start = 0;
-                            while ((start = next_content_name.find('[', start)) != std::string::npos) {
-                                ++next_deref_count;
-                                start++;
-                            }
-                        }
-
-                        // If we've reduced the number of dereferences in the name from last time, we need
-                        // to close up those detail sections.
-                        if (cur_deref_count < last_deref_count) {
-                            uint32_t diff_count = last_deref_count - cur_deref_count;
-                            while ((diff_count--) != 0u) {
-                                text_file << "   </details>\n";
-                                prefixes.pop_back();
-                            }
-                        }
-
-                        // Look through any prefixes we've saved (going backwards through the list)
-                        // and find the one that matches our beginning.
-                        std::string short_name = content_name;
-                        if (cur_deref_count > 0) {
-                            for (auto it = prefixes.rbegin(); it != prefixes.rend(); ++it) {
-                                if (content_name.find(*it) == 0) {
-                                    std::string::size_type additional_offset = it->size() + 1;
-                                    if (content_name[additional_offset - 1] == '-') {
-                                        additional_offset++;
-                                    } else if (content_name[additional_offset - 1] == '[') {
-                                        additional_offset--;
-                                    }
-                                    short_name = content_name.substr(additional_offset);
-                                    break;
-                                }
-                            }
-                        }
-
-                        bool writing_summary = false;
-
-                        // If the next item contains this item as a prefix, start the summary.  Otherwise,
-                        // start a <div> marker so that each component lands on its own line.
-                        if (cur_deref_count < next_deref_count) {
-                            text_file << "   <details class='data'>\n"
-                                      << "      <summary>\n";
-                            writing_summary = true;
-                            prefixes.push_back(content_name);
-                        } else {
-                            text_file << "      <div class='data'>\n";
-                        }
-
-                        // Write out the content
-                        text_file << "         <div class='type'>" << content_type << "</div>\n"
-                                  << "         <div class='var'>" << short_name << "</div>\n";
-                        bool value_needs_printing = true;
-                        if (content_type.find("char") != std::string::npos) {
-                            uint64_t star_count = std::count(content_type.begin(), content_type.end(), '*');
-                            uint64_t bracket_count = std::count(content_type.begin(), content_type.end(), '[');
-                            if (star_count + bracket_count < 2) {
-                                text_file << "         <div class='val'>\"" << content_value << "\"</div>";
-                                value_needs_printing = false;
-                            }
-                        }
-                        if (!content_value.empty() && value_needs_printing) {
-                            text_file << "         <div class='val'>" << content_value << "</div>";
-                        }
-                        text_file << "\n";
-
-                        // Wrap up any summary we may have started.  Otherwise, just wrap up the
-                        // <div> marker wrapping this entry.
-                        if (writing_summary) {
-                            text_file << "      </summary>\n";
-                        } else {
-                            text_file << "      </div>\n";
-                        }
-
-                        last_deref_count = cur_deref_count;
-                    }
-                }
+ApiDumpContents &ApiDumpLayerThreadContents() {
+    thread_local ApiDumpContents contents;
+    contents.Clear();
+    return contents;
+}
 
-                // Wrap up any remaining items
-                if (last_deref_count != 0u) {
-                    while ((last_deref_count--) != 0u) {
-                        text_file << "   </details>\n";
-                        prefixes.pop_back();
-                    }
-                }
-                text_file << "</details>\n";
-                break;
-            }
-            default:
-                break;
-        }
+// Function to record all the API dump information.  The record is formatted on the calling thread
+// and handed to the buffered writer, which keeps the output open and writes from its own thread.
+bool ApiDumpLayerRecordContent(const ApiDumpContents &contents) {
+    if (!g_record_info.initialized || !GetApiDumpWriter().IsOpen()) {
+        return false;
     }
-    return success;
+    thread_local std::string record;
+    record.clear();
+    switch (g_record_info.type) {
+        case RECORD_TEXT_COUT:
+        case RECORD_TEXT_FILE:
+            ApiDumpFormatText(contents, record);
+            break;
+        case RECORD_HTML_FILE:
+            ApiDumpFormatHtml(contents, record);
+            break;
+        default:
+            return false;
+    }
+    ApiDumpLayerAppendRecord(record);
+    return true;
 }
 
 XRAPI_ATTR XrResult XRAPI_CALL ApiDumpLayerXrCreateInstance(const XrInstanceCreateInfo * /*info*/, XrInstance * /*instance*/) {
@@ -442,12 +273,18 @@ XRAPI_ATTR XrResult XRAPI_CALL ApiDumpLayerXrGetInstanceProcAddr(XrInstance inst
                                                                  PFN_xrVoidFunction *function) {
     try {
         // Generate output for this command
-        std::vector<std::tuple<std::string, std::string, std::string>> contents;
-        contents.emplace_back("XrResult", "xrGetInstanceProcAddr", "");
-        contents.emplace_back("XrInstance", "instance", HandleToHexString(instance));
-        contents.emplace_back("const char*", "name", name);
-        contents.emplace_back("PFN_xrVoidFunction*", "function", PointerToHexString(reinterpret_cast<const void *>(function)));
-        ApiDumpLayerRecordContent(contents);
+        if (!g_api_dump_filter.ShouldRecord(API_DUMP_BINARY_COMMAND_xrGetInstanceProcAddr)) {
+            // Left out by the filter settings
+        } else if (ApiDumpLayerBinaryEnabled()) {
+            ApiDumpBinaryRecordXrGetInstanceProcAddr(instance, name, function);
+        } else {
+            ApiDumpContents &contents = ApiDumpLayerThreadContents();
+            contents.Add("XrResult", "xrGetInstanceProcAddr", "");
+            contents.AddHandle("XrInstance", "instance", instance);
+            contents.AddString("const char*", "name", name);
+            contents.AddPointer("PFN_xrVoidFunction*", "function", reinterpret_cast<const void *>(function));
+            ApiDumpLayerRecordContent(contents);
+        }
 
         *function = ApiDumpLayerInnerGetInstanceProcAddr(name);
 
@@ -525,6 +362,27 @@ XRAPI_ATTR XrResult XRAPI_CALL ApiDumpLayerXrCreateApiLayerInstance(const XrInst
                 }
             } else if (export_type_lower == "code") {
                 g_record_info.type = RECORD_CODE_FILE;
+            } else if (export_type_lower == "binary") {
+                // Binary captures are meaningless on a console, so they need a file name.
+                if (g_record_info.file_name.empty()) {
+                    LogPlatformUtilsError("XR_API_DUMP_EXPORT_TYPE=binary requires XR_API_DUMP_FILE_NAME, writing text instead");
+                    g_record_info.type = RECORD_TEXT_COUT;
+                } else {
+                    g_record_info.type = RECORD_BINARY_FILE;
+                    if (!ApiDumpLayerOpenBinaryFile(first_time)) {
+                        return XR_ERROR_INITIALIZATION_FAILED;
+                    }
+                }
+            }
+        }
+
+        ApiDumpLayerConfigureFilter();
+
+        // Text output goes through the same buffered writer; HTML opened it above when writing the header.
+        if (g_record_info.type == RECORD_TEXT_FILE || g_record_info.type == RECORD_TEXT_COUT) {
+            std::string output_file = g_record_info.type == RECORD_TEXT_FILE ? g_record_info.file_name : std::string();
+            if (!GetApiDumpWriter().Open(output_file, false)) {
+                return XR_ERROR_INITIALIZATION_FAILED;
             }
         }
 
@@ -542,59 +400,54 @@ XRAPI_ATTR XrResult XRAPI_CALL ApiDumpLayerXrCreateApiLayerInstance(const XrInst
         }
 
         // Generate output for this command as if it were the standard xrCreateInstance
-        std::vector<std::tuple<std::string, std::string, std::string>> contents;
-        contents.emplace_back("XrResult", "xrCreateInstance", "");
-        contents.emplace_back("const XrInstanceCreateInfo*", "info", PointerToHexString(info));
-        if (nullptr != info) {
-            std::string info_prefix = "info->";
-            contents.emplace_back("XrStructureType", "info->type", std::to_string(info->type));
-            std::string next_prefix = info_prefix;
-            next_prefix += "next";
-            // Decode the next chain if it exists
-            if (!ApiDumpDecodeNextChain(nullptr, info->next, next_prefix, contents)) {
-                throw std::invalid_argument("Invalid Operation");
-            }
-            std::string flags_prefix = info_prefix;
-            flags_prefix += "createFlags";
-            contents.emplace_back("XrInstanceCreateFlags", flags_prefix, std::to_string(info->createFlags));
-            std::string applicationinfo_prefix = info_prefix;
-            applicationinfo_prefix += "applicationInfo";
-            if (!ApiDumpOutputXrStruct(nullptr, &info->applicationInfo, applicationinfo_prefix, "XrApplicationInfo", true,
-                                       contents)) {
-                throw std::invalid_argument("Invalid Operation");
-            }
-            std::string enabledapilayercount_prefix = info_prefix;
-            enabledapilayercount_prefix += "enabledApiLayerCount";
-            std::ostringstream oss_enabledApiLayerCount;
-            oss_enabledApiLayerCount << "0x" << std::hex << (info->enabledApiLayerCount);
-            contents.emplace_back("uint32_t", enabledapilayercount_prefix, oss_enabledApiLayerCount.str());
-            std::string enabledapilayernames_prefix = info_prefix;
-            enabledapilayernames_prefix += "enabledApiLayerNames";
-            std::ostringstream oss_enabledApiLayerNames_array;
-            oss_enabledApiLayerNames_array << "0x" << std::hex << (info->enabledApiLayerNames);
-            contents.emplace_back("const char* const*", enabledapilayernames_prefix, oss_enabledApiLayerNames_array.str());
-            for (uint32_t i = 0; i < info->enabledApiLayerCount; ++i) {
-                std::string prefix = enabledapilayernames_prefix + "[" + std::to_string(i) + "]";
-                contents.emplace_back("const char* const*", prefix, info->enabledApiLayerNames[i]);
-            }
-            std::string enabledextensioncount_prefix = info_prefix;
-            enabledextensioncount_prefix += "enabledExtensionCount";
-            std::ostringstream oss_enabledExtensionCount;
-            oss_enabledExtensionCount << "0x" << std::hex << (info->enabledExtensionCount);
-            contents.emplace_back("uint32_t", enabledextensioncount_prefix, oss_enabledExtensionCount.str());
-            std::string enabledextensionnames_prefix = info_prefix;
-            enabledextensionnames_prefix += "enabledExtensionNames";
-            std::ostringstream oss_enabledExtensionNames_array;
-            oss_enabledExtensionNames_array << "0x" << std::hex << (info->enabledExtensionNames);
-            contents.emplace_back("const char* const*", enabledextensionnames_prefix, oss_enabledExtensionNames_array.str());
-            for (uint32_t ii = 0; ii < info->enabledExtensionCount; ++ii) {
-                std::string prefix = enabledextensionnames_prefix + "[" + std::to_string(ii) + "]";
-                contents.emplace_back("const char* const*", prefix, info->enabledExtensionNames[ii]);
+        if (!g_api_dump_filter.ShouldRecord(API_DUMP_BINARY_COMMAND_xrCreateInstance)) {
+            // Left out by the filter settings
+        } else if (ApiDumpLayerBinaryEnabled()) {
+            ApiDumpBinaryRecordXrCreateInstance(info, instance);
+        } else {
+            ApiDumpContents &contents = ApiDumpLayerThreadContents();
+            contents.Add("XrResult", "xrCreateInstance", "");
+            contents.AddPointer("const XrInstanceCreateInfo*", "info", info);
+            if (nullptr != info) {
+                ApiDumpNameScope info_name(contents, "info->");
+                contents.AddInt("XrStructureType", "type", info->type);
+                {
+                    // Decode the next chain if it exists
+                    ApiDumpNameScope next_name(contents, "next");
+                    if (!ApiDumpDecodeNextChain(nullptr, info->next, contents)) {
+                        throw std::invalid_argument("Invalid Operation");
+                    }
+                }
+                contents.AddInt("XrInstanceCreateFlags", "createFlags", info->createFlags);
+                {
+                    ApiDumpNameScope application_info_name(contents, "applicationInfo");
+                    if (!ApiDumpOutputXrStruct(nullptr, &info->applicationInfo, "XrApplicationInfo", true, contents)) {
+                        throw std::invalid_argument("Invalid Operation");
+                    }
+                }
+                contents.AddHex("uint32_t", "enabledApiLayerCount", info->enabledApiLayerCount);
+                contents.AddAddress("const char* const*", "enabledApiLayerNames", info->enabledApiLayerNames);
+                {
+                    ApiDumpNameScope layer_names_name(contents, "enabledApiLayerNames");
+                    for (uint32_t i = 0; i < info->enabledApiLayerCount; ++i) {
+                        ApiDumpNameScope index_name(contents, i);
+                        contents.AddString("const char* const*", "", info->enabledApiLayerNames[i]);
+                    }
+                }
+                contents.AddHex("uint32_t", "enabledExtensionCount", info->enabledExtensionCount);
+                contents.AddAddress("const char* const*", "enabledExtensionNames", info->enabledExtensionNames);
+                {
+                    ApiDumpNameScope extension_names_name(contents, "enabledExtensionNames");
+                    for (uint32_t i = 0; i < info->enabledExtensionCount; ++i) {
+                        ApiDumpNameScope index_name(contents, i);
+                        contents.AddString("const char* const*", "", info->enabledExtensionNames[i]);
+                    }
+                }
             }
-        }
 
-        contents.emplace_back("XrInstance*", "instance", PointerToHexString(instance));
-        ApiDumpLayerRecordContent(contents);
+            contents.AddPointer("XrInstance*", "instance", instance);
+            ApiDumpLayerRecordContent(contents);
+        }
 
         // Copy the contents of the layer info struct, but then move the next info up by
         // one slot so that the next layer gets information.
@@ -609,6 +462,9 @@ XRAPI_ATTR XrResult XRAPI_CALL ApiDumpLayerXrCreateApiLayerInstance(const XrInst
         XrInstance returned_instance = *instance;
         XrResult result = next_create_api_layer_instance(info, &new_api_layer_info, &returned_instance);
         *instance = returned_instance;
+        if (XR_FAILED(result)) {
+            ApiDumpLayerCallFailed();
+        }
 
         // Create the dispatch table to the next levels
         auto *next_dispatch = new XrGeneratedDispatchTable();
@@ -617,6 +473,11 @@ XRAPI_ATTR XrResult XRAPI_CALL ApiDumpLayerXrCreateApiLayerInstance(const XrInst
         std::unique_lock<std::mutex> mlock(g_instance_dispatch_mutex);
         g_instance_dispatch_map[returned_instance] = next_dispatch;
 
+        if (XR_SUCCEEDED(result)) {
+            ApiDumpLayerAcquireHandleDataSlot(returned_instance, next_get_instance_proc_addr);
+            ApiDumpLayerSetHandleDispatchTable(XR_OBJECT_TYPE_INSTANCE, MakeHandleGeneric(returned_instance), next_dispatch);
+        }
+
         return result;
     } catch (...) {
         return XR_ERROR_INITIALIZATION_FAILED;
@@ -625,10 +486,16 @@ XRAPI_ATTR XrResult XRAPI_CALL ApiDumpLayerXrCreateApiLayerInstance(const XrInst
 
 XRAPI_ATTR XrResult XRAPI_CALL ApiDumpLayerXrDestroyInstance(XrInstance instance) {
     // Generate output for this command
-    std::vector<std::tuple<std::string, std::string, std::string>> contents;
-    contents.emplace_back("XrResult", "xrDestroyInstance", "");
-    contents.emplace_back("XrInstance", "instance", HandleToHexString(instance));
-    ApiDumpLayerRecordContent(contents);
+    if (!g_api_dump_filter.ShouldRecord(API_DUMP_BINARY_COMMAND_xrDestroyInstance)) {
+        // Left out by the filter settings
+    } else if (ApiDumpLayerBinaryEnabled()) {
+        ApiDumpBinaryRecordXrDestroyInstance(instance);
+    } else {
+        ApiDumpContents &contents = ApiDumpLayerThreadContents();
+        contents.Add("XrResult", "xrDestroyInstance", "");
+        contents.AddHandle("XrInstance", "instance", instance);
+        ApiDumpLayerRecordContent(contents);
+    }
 
     XrGeneratedDispatchTable *next_dispatch = nullptr;
     {
@@ -643,13 +510,20 @@ XRAPI_ATTR XrResult XRAPI_CALL ApiDumpLayerXrDestroyInstance(XrInstance instance
         return XR_ERROR_HANDLE_INVALID;
     }
 
+    ApiDumpLayerSetHandleDispatchTable(XR_OBJECT_TYPE_INSTANCE, MakeHandleGeneric(instance), nullptr);
     next_dispatch->DestroyInstance(instance);
+    g_handle_data_table = nullptr;
     ApiDumpCleanUpMapsForTable(next_dispatch);
     delete next_dispatch;
 
-    // Write out the HTML footer if we destroy the last instance
+    // Write out the HTML footer if we destroy the last instance, and otherwise make sure everything
+    // recorded so far has reached the output.
     if (g_instance_dispatch_map.empty() && g_record_info.type == RECORD_HTML_FILE) {
         ApiDumpLayerWriteHtmlFooter();
+    } else if (g_instance_dispatch_map.empty()) {
+        GetApiDumpWriter().Close();
+    } else {
+        GetApiDumpWriter().Flush();
     }
     return XR_SUCCESS;
 }
@@ -0,0 +1,91 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "api_dump_binary.h"
+
+#include <atomic>
+#include <chrono>
+
+static uint32_t ApiDumpBinaryThreadIndex() {
+    static std::atomic<uint32_t> next_index{0};
+    thread_local uint32_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+static std::string& ApiDumpBinaryThreadBuffer() {
+    thread_local std::string buffer;
+    return buffer;
+}
+
+ApiDumpBinaryEncoder::ApiDumpBinaryEncoder(uint16_t command_id) : data_(ApiDumpBinaryThreadBuffer()) {
+    data_.clear();
+    uint32_t length = 0;
+    Value(length);
+    ApiDumpBinaryRecordHeader header{};
+    header.command_id = command_id;
+    header.thread_index = ApiDumpBinaryThreadIndex();
+    header.timestamp_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    Value(header);
+}
+
+void ApiDumpBinaryEncoder::String(const char* string) {
+    if (string == nullptr) {
+        Value(kApiDumpBinaryNullString);
+        return;
+    }
+    auto length = static_cast<uint32_t>(strlen(string));
+    Value(length);
+    Append(string, length);
+}
+
+void ApiDumpBinaryEncoder::Struct(const void* value, size_t size, bool typed) {
+    Pointer(value);
+    if (value == nullptr) {
+        return;
+    }
+    auto base = reinterpret_cast<const XrBaseInStructure*>(value);
+    if (typed) {
+        // The parameter may be declared as a base header; record the whole derived struct.
+        size_t typed_size = ApiDumpBinaryStructSize(base->type);
+        if (typed_size != 0) {
+            size = typed_size;
+        }
+    }
+    Value(static_cast<uint32_t>(size));
+    Append(value, size);
+    if (typed) {
+        for (auto next = base->next; next != nullptr; next = next->next) {
+            auto next_size = static_cast<uint32_t>(ApiDumpBinaryStructSize(next->type));
+            if (next_size == 0) {
+                // Unknown extension struct: nothing after it can be walked safely.
+                break;
+            }
+            Value(static_cast<uint32_t>(next->type));
+            Value(next_size);
+            Append(next, next_size);
+        }
+    }
+    uint32_t end_of_chain = 0;
+    Value(end_of_chain);
+}
+
+const std::string& ApiDumpBinaryEncoder::Finish() {
+    auto length = static_cast<uint32_t>(data_.size() - sizeof(uint32_t));
+    memcpy(&data_[0], &length, sizeof(length));
+    return data_;
+}
@@ -0,0 +1,157 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#pragma once
+
+#include <openxr/openxr.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+class ApiDumpContents;
+
+// Binary capture format written by api_dump when XR_API_DUMP_EXPORT_TYPE=binary, and read back by
+// api_dump_convert.
+//
+// The file starts with kApiDumpBinaryMagic followed by a uint32_t format version.  Each call is one
+// record: a uint32_t byte count for the rest of the record, then the ApiDumpBinaryRecordHeader, then
+// the parameters in declaration order.  Parameters are encoded by the generated encoders as:
+//   - values (handles, enums, scalars, structs passed by value): their raw bytes
+//   - const char*: uint32_t length (kApiDumpBinaryNullString for nullptr) then the characters
+//   - const pointer to a single struct: its address as a uint64_t and, if not null, a uint32_t size,
+//     the struct's raw bytes and its next chain as (uint32_t type, uint32_t size, bytes) entries,
+//     ending with a type of 0
+//   - any other pointer: its address as a uint64_t
+// Pointers inside structs, other than next, are recorded by address only.  Command ids follow the
+// order of xr.xml, so a capture must be converted by an api_dump_convert built from the same registry.
+//
+// The encoder is implemented in api_dump_binary.cpp and built into the layer; the reader and the
+// value formatting helpers are in api_dump_binary_reader.cpp and built into the converter.
+
+#define API_DUMP_BINARY_FORMAT_VERSION 1
+
+static const char kApiDumpBinaryMagic[8] = {'X', 'R', 'D', 'U', 'M', 'P', 'B', '\0'};
+static const uint32_t kApiDumpBinaryNullString = UINT32_MAX;
+
+#pragma pack(push, 1)
+struct ApiDumpBinaryRecordHeader {
+    uint16_t command_id;
+    uint16_t reserved;
+    uint32_t thread_index;
+    uint64_t timestamp_ns;
+};
+#pragma pack(pop)
+
+// Size of the struct identified by type, or 0 if it is not known.  Generated.
+size_t ApiDumpBinaryStructSize(XrStructureType type);
+
+// Serializes one call into a reusable thread-local buffer.
+class ApiDumpBinaryEncoder {
+   public:
+    explicit ApiDumpBinaryEncoder(uint16_t command_id);
+
+    template <typename T>
+    void Value(const T& value) {
+        Append(&value, sizeof(T));
+    }
+    void Pointer(const void* pointer) { Value(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pointer))); }
+    void String(const char* string);
+    // `typed` structs start with type and next: their real size comes from the type, and the next
+    // chain is recorded after them.
+    void Struct(const void* value, size_t size, bool typed);
+
+    // Patch the length prefix and return the finished record.
+    const std::string& Finish();
+
+   private:
+    void Append(const void* data, size_t size) { data_.append(static_cast<const char*>(data), size); }
+
+    std::string& data_;
+};
+
+// A struct read back from a capture, with its next chain.
+struct ApiDumpBinaryStruct {
+    uint64_t address = 0;
+    std::string bytes;
+    struct ChainEntry {
+        XrStructureType type;
+        std::string bytes;
+    };
+    std::vector<ChainEntry> chain;
+};
+using ApiDumpBinaryChain = std::vector<ApiDumpBinaryStruct::ChainEntry>;
+
+// Copy captured bytes into a zero-initialized struct, tolerating captures from older or newer headers.
+template <typename T>
+T ApiDumpBinaryCopy(const std::string& bytes) {
+    T value{};
+    memcpy(&value, bytes.data(), bytes.size() < sizeof(T) ? bytes.size() : sizeof(T));
+    return value;
+}
+
+// Reads the parameters of one record.  Once a read runs past the end, Ok() returns false and every
+// further read yields zeros.
+class ApiDumpBinaryReader {
+   public:
+    ApiDumpBinaryReader(const uint8_t* data, size_t size) : cur_(data), end_(data + size) {}
+
+    bool Read(void* out, size_t size) {
+        if (static_cast<size_t>(end_ - cur_) < size) {
+            memset(out, 0, size);
+            cur_ = end_;
+            ok_ = false;
+            return false;
+        }
+        memcpy(out, cur_, size);
+        cur_ += size;
+        return true;
+    }
+    template <typename T>
+    T Value() {
+        T value{};
+        Read(&value, sizeof(T));
+        return value;
+    }
+    uint64_t Pointer() { return Value<uint64_t>(); }
+    // Returns false for a null string.
+    bool String(std::string& out);
+    void Struct(ApiDumpBinaryStruct& out);
+
+    bool Ok() const { return ok_; }
+
+   private:
+    // Read a uint32_t length and size `out` to it, failing if it runs past the record.
+    bool Length(std::string& out);
+
+    const uint8_t* cur_;
+    const uint8_t* end_;
+    bool ok_ = true;
+};
+
+// Value formatting shared by the generated decoders, matching the text output.
+std::string ApiDumpBinaryHex(uint64_t value);
+std::string ApiDumpBinaryAddress(uint64_t address);
+std::string ApiDumpBinaryFloat(double value, int precision);
+std::string ApiDumpBinaryBytes(const void* data, size_t size);
+
+// Name of a command id, or nullptr if unknown.  Generated.
+const char* ApiDumpBinaryCommandName(uint16_t command_id);
+
+// Render one record's parameters in the same form the text and HTML outputs use.  Generated.
+bool ApiDumpBinaryDecodeCommand(uint16_t command_id, ApiDumpBinaryReader& reader, ApiDumpContents& contents);
@@ -0,0 +1,95 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "api_dump_binary.h"
+#include "api_dump_format.h"
+
+bool ApiDumpBinaryReader::Length(std::string& out) {
+    auto length = Value<uint32_t>();
+    if (length > static_cast<size_t>(end_ - cur_)) {
+        cur_ = end_;
+        ok_ = false;
+        out.clear();
+        return false;
+    }
+    out.resize(length);
+    return true;
+}
+
+bool ApiDumpBinaryReader::String(std::string& out) {
+    out.clear();
+    const uint8_t* start = cur_;
+    if (Value<uint32_t>() == kApiDumpBinaryNullString) {
+        return false;
+    }
+    cur_ = start;
+    if (!Length(out)) {
+        return false;
+    }
+    return out.empty() || Read(&out[0], out.size());
+}
+
+void ApiDumpBinaryReader::Struct(ApiDumpBinaryStruct& out) {
+    out.address = Pointer();
+    out.bytes.clear();
+    out.chain.clear();
+    if (out.address == 0) {
+        return;
+    }
+    if (Length(out.bytes) && !out.bytes.empty()) {
+        Read(&out.bytes[0], out.bytes.size());
+    }
+    while (Ok()) {
+        auto type = Value<uint32_t>();
+        if (type == 0) {
+            break;
+        }
+        ApiDumpBinaryStruct::ChainEntry entry;
+        entry.type = static_cast<XrStructureType>(type);
+        if (Length(entry.bytes) && !entry.bytes.empty()) {
+            Read(&entry.bytes[0], entry.bytes.size());
+        }
+        out.chain.push_back(std::move(entry));
+    }
+}
+
+std::string ApiDumpBinaryHex(uint64_t value) {
+    char buffer[kApiDumpValueBufferSize];
+    return std::string(buffer, ApiDumpFormatHex(buffer, value, true));
+}
+
+std::string ApiDumpBinaryAddress(uint64_t address) {
+    char buffer[kApiDumpValueBufferSize];
+    return std::string(buffer, ApiDumpFormatAddress(buffer, address));
+}
+
+std::string ApiDumpBinaryFloat(double value, int precision) {
+    char buffer[kApiDumpValueBufferSize];
+    return std::string(buffer, ApiDumpFormatFloat(buffer, value, precision));
+}
+
+std::string ApiDumpBinaryBytes(const void* data, size_t size) {
+    // Raw bytes in memory order, for types the decoder has no formatter for.
+    static const char kHexDigits[] = "0123456789abcdef";
+    std::string out = "0x";
+    auto bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        out += kHexDigits[bytes[i] >> 4];
+        out += kHexDigits[bytes[i] & 0xf];
+    }
+    return out;
+}
@@ -0,0 +1,164 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Renders a capture written by api_dump with XR_API_DUMP_EXPORT_TYPE=binary as the text or HTML
+// output the layer would have produced directly.
+
+#include "api_dump_binary.h"
+#include "api_dump_format.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static void PrintUsage() {
+    std::cerr << "Usage: api_dump_convert [--html] [--annotate] <capture> [<output>]\n"
+              << "  --html      write HTML instead of text\n"
+              << "  --annotate  add the recording thread and time since the first call to each command\n"
+              << "Output goes to stdout when no output file is given.\n";
+}
+
+int main(int argc, char* argv[]) {
+    bool html = false;
+    bool annotate = false;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--html") {
+            html = true;
+        } else if (arg == "--annotate") {
+            annotate = true;
+        } else if (arg == "--help" || arg == "-h") {
+            PrintUsage();
+            return 0;
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "Unknown option " << arg << "\n";
+            PrintUsage();
+            return 1;
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.empty() || files.size() > 2) {
+        PrintUsage();
+        return 1;
+    }
+
+    std::ifstream input(files[0], std::ios::binary);
+    if (!input) {
+        std::cerr << "Unable to open " << files[0] << "\n";
+        return 1;
+    }
+    std::vector<uint8_t> capture((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+    uint32_t version = 0;
+    if (capture.size() < sizeof(kApiDumpBinaryMagic) + sizeof(version) ||
+        memcmp(capture.data(), kApiDumpBinaryMagic, sizeof(kApiDumpBinaryMagic)) != 0) {
+        std::cerr << files[0] << " is not an api_dump binary capture\n";
+        return 1;
+    }
+    memcpy(&version, capture.data() + sizeof(kApiDumpBinaryMagic), sizeof(version));
+    if (version != API_DUMP_BINARY_FORMAT_VERSION) {
+        std::cerr << files[0] << " uses capture format version " << version << ", expected " << API_DUMP_BINARY_FORMAT_VERSION
+                  << "\n";
+        return 1;
+    }
+
+    std::ofstream output_file;
+    if (files.size() > 1) {
+        output_file.open(files[1], std::ios::binary | std::ios::trunc);
+        if (!output_file) {
+            std::cerr << "Unable to open " << files[1] << "\n";
+            return 1;
+        }
+    }
+    std::ostream& output = files.size() > 1 ? output_file : std::cout;
+
+    std::string out;
+    if (html) {
+        out += kApiDumpHtmlHeader;
+    }
+
+    uint64_t record_count = 0;
+    uint64_t undecoded_count = 0;
+    uint64_t first_timestamp = 0;
+    bool truncated = false;
+    ApiDumpContents contents;
+    size_t offset = sizeof(kApiDumpBinaryMagic) + sizeof(version);
+    while (offset < capture.size()) {
+        uint32_t length = 0;
+        ApiDumpBinaryRecordHeader header{};
+        if (capture.size() - offset < sizeof(length)) {
+            truncated = true;
+            break;
+        }
+        memcpy(&length, capture.data() + offset, sizeof(length));
+        offset += sizeof(length);
+        if (length < sizeof(header) || length > capture.size() - offset) {
+            truncated = true;
+            break;
+        }
+        memcpy(&header, capture.data() + offset, sizeof(header));
+        ApiDumpBinaryReader reader(capture.data() + offset + sizeof(header), length - sizeof(header));
+        offset += length;
+
+        if (record_count++ == 0) {
+            first_timestamp = header.timestamp_ns;
+        }
+        contents.Clear();
+        if (!ApiDumpBinaryDecodeCommand(header.command_id, reader, contents)) {
+            ++undecoded_count;
+            if (contents.Empty()) {
+                const char* name = ApiDumpBinaryCommandName(header.command_id);
+                contents.Add("?", name != nullptr ? name : "command " + std::to_string(header.command_id), "");
+            }
+        }
+        if (annotate) {
+            contents.SetValue(0, "thread " + std::to_string(header.thread_index) + ", +" +
+                                     std::to_string(header.timestamp_ns - first_timestamp) + " ns");
+        }
+        if (html) {
+            ApiDumpFormatHtml(contents, out);
+        } else {
+            ApiDumpFormatText(contents, out);
+        }
+        if (out.size() >= 1024 * 1024) {
+            output.write(out.data(), static_cast<std::streamsize>(out.size()));
+            out.clear();
+        }
+    }
+
+    if (html) {
+        out += kApiDumpHtmlFooter;
+    }
+    output.write(out.data(), static_cast<std::streamsize>(out.size()));
+    output.flush();
+
+    std::cerr << record_count << " calls converted";
+    if (undecoded_count != 0) {
+        std::cerr << ", " << undecoded_count << " could not be fully decoded";
+    }
+    if (truncated) {
+        std::cerr << ", capture ends with a truncated record";
+    }
+    std::cerr << "\n";
+    return output ? 0 : 1;
+}
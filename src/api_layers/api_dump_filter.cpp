@@ -0,0 +1,236 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "api_dump_filter.h"
+#include "api_dump_writer.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+ApiDumpFilter& g_api_dump_filter = *new ApiDumpFilter();
+
+namespace {
+
+// Split a comma-separated list, trimming spaces and dropping empty entries.
+std::vector<std::string> SplitList(const std::string& list) {
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        size_t first = list.find_first_not_of(" \t", start);
+        size_t last = list.find_last_not_of(" \t", end == 0 ? 0 : end - 1);
+        if (first != std::string::npos && first < end && last != std::string::npos && last >= first) {
+            items.push_back(list.substr(first, last - first + 1));
+        }
+        start = end + 1;
+    }
+    return items;
+}
+
+// Parse a whole string as an unsigned decimal number.
+bool ParseUnsigned(const std::string& text, uint64_t& value) {
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    value = std::strtoull(text.c_str(), nullptr, 10);
+    return true;
+}
+
+uint32_t FindCommand(const std::string& name, const char* const* command_names, uint32_t command_count) {
+    for (uint32_t command = 1; command < command_count; ++command) {
+        if (command_names[command] != nullptr && name == command_names[command]) {
+            return command;
+        }
+    }
+    return 0;
+}
+
+uint64_t NowNs() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+}  // namespace
+
+void ApiDumpFilter::Configure(const ApiDumpFilterSettings& settings, const char* const* command_names,
+                              uint32_t command_count, std::vector<std::string>& errors) {
+    if (command_count > kApiDumpFilterMaxCommands) {
+        command_count = kApiDumpFilterMaxCommands;
+    }
+
+    uint64_t excluded[kWords] = {};
+    std::vector<std::string> included = SplitList(settings.include);
+    if (!included.empty()) {
+        memset(excluded, 0xff, sizeof(excluded));
+        for (const std::string& name : included) {
+            const uint32_t command = FindCommand(name, command_names, command_count);
+            if (command == 0) {
+                errors.push_back("api_dump include list names unknown command " + name);
+                continue;
+            }
+            excluded[command >> 6] &= ~(uint64_t(1) << (command & 63));
+        }
+    }
+    for (const std::string& name : SplitList(settings.exclude)) {
+        const uint32_t command = FindCommand(name, command_names, command_count);
+        if (command == 0) {
+            errors.push_back("api_dump exclude list names unknown command " + name);
+            continue;
+        }
+        excluded[command >> 6] |= uint64_t(1) << (command & 63);
+    }
+
+    for (uint32_t command = 0; command < kApiDumpFilterMaxCommands; ++command) {
+        rate_limit_[command].store(0, std::memory_order_relaxed);
+        rate_window_start_ns_[command].store(0, std::memory_order_relaxed);
+        rate_window_count_[command].store(0, std::memory_order_relaxed);
+    }
+    for (const std::string& entry : SplitList(settings.rate_limit)) {
+        const size_t colon = entry.rfind(':');
+        uint64_t limit = 0;
+        if (colon == std::string::npos || !ParseUnsigned(entry.substr(colon + 1), limit) || limit == 0 || limit > UINT32_MAX) {
+            errors.push_back("api_dump rate limit " + entry + " is not of the form command:calls_per_second");
+            continue;
+        }
+        const std::string name = entry.substr(0, colon);
+        if (name == "*") {
+            for (uint32_t command = 1; command < command_count; ++command) {
+                rate_limit_[command].store(static_cast<uint32_t>(limit), std::memory_order_relaxed);
+            }
+            continue;
+        }
+        const uint32_t command = FindCommand(name, command_names, command_count);
+        if (command == 0) {
+            errors.push_back("api_dump rate limit names unknown command " + name);
+            continue;
+        }
+        rate_limit_[command].store(static_cast<uint32_t>(limit), std::memory_order_relaxed);
+    }
+
+    for (uint32_t word = 0; word < kWords; ++word) {
+        excluded_[word].store(excluded[word], std::memory_order_relaxed);
+    }
+
+    bool frame_window = false;
+    if (!settings.frames.empty()) {
+        const size_t dash = settings.frames.find('-');
+        uint64_t first = 0;
+        uint64_t last = 0;
+        bool valid = false;
+        if (dash == std::string::npos) {
+            valid = ParseUnsigned(settings.frames, first);
+            last = first;
+        } else {
+            valid = ParseUnsigned(settings.frames.substr(0, dash), first) &&
+                    ParseUnsigned(settings.frames.substr(dash + 1), last) && first <= last;
+        }
+        if (valid) {
+            frame_first_.store(first, std::memory_order_relaxed);
+            frame_last_.store(last, std::memory_order_relaxed);
+            frame_count_.store(0, std::memory_order_relaxed);
+            frame_window = true;
+        } else {
+            errors.push_back("api_dump frame window " + settings.frames + " is not of the form N-M or N");
+        }
+    }
+    frame_window_.store(frame_window, std::memory_order_relaxed);
+    if (frame_window) {
+        CloseWindow();
+    } else {
+        OpenWindow();
+    }
+
+    uint64_t held = 0;
+    if (!settings.trigger_on_error.empty() && (!ParseUnsigned(settings.trigger_on_error, held) || held == 0)) {
+        errors.push_back("api_dump trigger-on-error call count " + settings.trigger_on_error + " is not a positive number");
+        held = 0;
+    }
+    {
+        std::unique_lock<std::mutex> lock(held_mutex_);
+        held_.resize(static_cast<size_t>(held));
+        held_next_ = 0;
+        held_count_ = 0;
+    }
+    trigger_on_error_.store(held != 0, std::memory_order_relaxed);
+}
+
+bool ApiDumpFilter::Admit(uint32_t command, uint32_t limit) {
+    const uint64_t now = NowNs();
+    uint64_t start = rate_window_start_ns_[command].load(std::memory_order_relaxed);
+    if (now - start >= 1000000000ULL &&
+        rate_window_start_ns_[command].compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+        rate_window_count_[command].store(0, std::memory_order_relaxed);
+    }
+    return rate_window_count_[command].fetch_add(1, std::memory_order_relaxed) < limit;
+}
+
+void ApiDumpFilter::BeginWindowFrame() {
+    const uint64_t frame = frame_count_.fetch_add(1, std::memory_order_relaxed);
+    if (frame == frame_first_.load(std::memory_order_relaxed)) {
+        OpenWindow();
+    } else if (frame > frame_last_.load(std::memory_order_relaxed)) {
+        // The last frame never reached xrEndFrame.
+        CloseWindow();
+    }
+}
+
+void ApiDumpFilter::EndWindowFrame() {
+    const uint64_t count = frame_count_.load(std::memory_order_relaxed);
+    if (count != 0 && count - 1 >= frame_last_.load(std::memory_order_relaxed)) {
+        CloseWindow();
+    }
+}
+
+void ApiDumpFilter::OpenWindow() {
+    for (uint32_t word = 0; word < kWords; ++word) {
+        filtered_[word].store(excluded_[word].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+void ApiDumpFilter::CloseWindow() {
+    for (uint32_t word = 0; word < kWords; ++word) {
+        filtered_[word].store(UINT64_MAX, std::memory_order_relaxed);
+    }
+}
+
+void ApiDumpFilter::Hold(const std::string& record) {
+    std::unique_lock<std::mutex> lock(held_mutex_);
+    if (held_.empty()) {
+        return;
+    }
+    held_[held_next_].assign(record);
+    held_next_ = (held_next_ + 1) % held_.size();
+    if (held_count_ < held_.size()) {
+        ++held_count_;
+    }
+}
+
+void ApiDumpFilter::Release(ApiDumpWriter& writer) {
+    std::unique_lock<std::mutex> lock(held_mutex_);
+    if (held_count_ == 0) {
+        return;
+    }
+    const size_t first = (held_next_ + held_.size() - held_count_) % held_.size();
+    for (size_t i = 0; i < held_count_; ++i) {
+        writer.Append(held_[(first + i) % held_.size()]);
+    }
+    held_count_ = 0;
+}
@@ -0,0 +1,109 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class ApiDumpWriter;
+
+// Selects which calls api_dump records.
+//
+// Commands are identified by their ApiDumpBinaryCommand id.  A bitset marks the ids that are not
+// recorded: it holds the include/exclude lists, and every bit is set while a frame window is closed,
+// so a call that is filtered out costs a single test.  Calls that pass are then checked against their
+// per-command rate limit, if they have one.  In trigger-on-error mode, finished records are held in a
+// ring of the last K calls and only written out when a call fails.
+constexpr uint32_t kApiDumpFilterMaxCommands = 1024;
+
+struct ApiDumpFilterSettings {
+    std::string include;           // comma-separated command names; empty records every command
+    std::string exclude;           // comma-separated command names
+    std::string rate_limit;        // comma-separated name:calls_per_second, "*" for every command
+    std::string frames;            // "N-M" or "N"; frames are counted from 0 by xrBeginFrame
+    std::string trigger_on_error;  // number of calls to keep before a failure
+};
+
+class ApiDumpFilter {
+   public:
+    // Apply settings, replacing any earlier ones.  command_names[id] is the name of command id, or
+    // nullptr.  Anything that cannot be parsed is skipped and described in `errors`.
+    void Configure(const ApiDumpFilterSettings& settings, const char* const* command_names, uint32_t command_count,
+                   std::vector<std::string>& errors);
+
+    bool ShouldRecord(uint32_t command) {
+        if ((filtered_[command >> 6].load(std::memory_order_relaxed) >> (command & 63)) & 1) {
+            return false;
+        }
+        const uint32_t limit = rate_limit_[command].load(std::memory_order_relaxed);
+        return limit == 0 || Admit(command, limit);
+    }
+
+    // Called by xrBeginFrame before it is recorded, and by xrEndFrame after it is recorded.
+    void BeginFrame() {
+        if (frame_window_.load(std::memory_order_relaxed)) {
+            BeginWindowFrame();
+        }
+    }
+    void EndFrame() {
+        if (frame_window_.load(std::memory_order_relaxed)) {
+            EndWindowFrame();
+        }
+    }
+
+    bool TriggerOnError() const { return trigger_on_error_.load(std::memory_order_relaxed); }
+    // Keep a finished record in the ring, dropping the oldest once it is full.
+    void Hold(const std::string& record);
+    // Pass the held records to `writer` in call order and empty the ring.
+    void Release(ApiDumpWriter& writer);
+
+   private:
+    static constexpr uint32_t kWords = kApiDumpFilterMaxCommands / 64;
+
+    bool Admit(uint32_t command, uint32_t limit);
+    void BeginWindowFrame();
+    void EndWindowFrame();
+    void OpenWindow();
+    void CloseWindow();
+
+    std::atomic<uint64_t> filtered_[kWords] = {};
+    // Ids left out by the include/exclude lists; copied into filtered_ when the frame window opens.
+    std::atomic<uint64_t> excluded_[kWords] = {};
+    std::atomic<uint32_t> rate_limit_[kApiDumpFilterMaxCommands] = {};
+    std::atomic<uint64_t> rate_window_start_ns_[kApiDumpFilterMaxCommands] = {};
+    std::atomic<uint32_t> rate_window_count_[kApiDumpFilterMaxCommands] = {};
+
+    std::atomic<bool> frame_window_{false};
+    std::atomic<uint64_t> frame_first_{0};
+    std::atomic<uint64_t> frame_last_{0};
+    std::atomic<uint64_t> frame_count_{0};
+
+    std::atomic<bool> trigger_on_error_{false};
+    std::mutex held_mutex_;
+    std::vector<std::string> held_;
+    size_t held_next_ = 0;
+    size_t held_count_ = 0;
+};
+
+// Intentionally leaked, like the writer, since recording threads may still be running while static
+// destructors execute.  A plain reference rather than a function-local static keeps the filter test
+// free of an initialization guard.
+extern ApiDumpFilter& g_api_dump_filter;
@@ -0,0 +1,312 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+// Copyright (c) 2017-2019 Valve Corporation
+// Copyright (c) 2017-2019 LunarG, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Author: Mark Young <marky@lunarg.com>
+// Author: Dave Houlton <daveh@lunarg.com>
+//
+
+#include "api_dump_format.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+
+const char* const kApiDumpHtmlHeader =
+    "<!doctype html>\n"
+    "<html>\n"
+    "    <head>\n"
+    "        <title>OpenXR API Dump</title>\n"
+    "        <style type='text/css'>\n"
+    "        html {\n"
+    "            background-color: #0b1e48;\n"
+    "            background-image: url('https://vulkan.lunarg.com/img/bg-starfield.jpg');\n"
+    "            background-position: center;\n"
+    "            -webkit-background-size: cover;\n"
+    "            -moz-background-size: cover;\n"
+    "            -o-background-size: cover;\n"
+    "            background-size: cover;\n"
+    "            background-attachment: fixed;\n"
+    "            background-repeat: no-repeat;\n"
+    "            height: 100%;\n"
+    "        }\n"
+    "        #header {\n"
+    "            z-index: -1;\n"
+    "        }\n"
+    "        #header>img {\n"
+    "            position: absolute;\n"
+    "            width: 160px;\n"
+    "            margin-left: -280px;\n"
+    "            top: -10px;\n"
+    "            left: 50%;\n"
+    "        }\n"
+    "        #header>h1 {\n"
+    "            font-family: Arial, 'Helvetica Neue', Helvetica, sans-serif;\n"
+    "            font-size: 44px;\n"
+    "            font-weight: 200;\n"
+    "            text-shadow: 4px 4px 5px #000;\n"
+    "            color: #eee;\n"
+    "            position: absolute;\n"
+    "            width: 400px;\n"
+    "            margin-left: -80px;\n"
+    "            top: 8px;\n"
+    "            left: 50%;\n"
+    "        }\n"
+    "        body {\n"
+    "            font-family: Consolas, monaco, monospace;\n"
+    "            font-size: 14px;\n"
+    "            line-height: 20px;\n"
+    "            color: #eee;\n"
+    "            height: 100%;\n"
+    "            margin: 0;\n"
+    "            overflow: hidden;\n"
+    "        }\n"
+    "        #wrapper {\n"
+    "            background-color: rgba(0, 0, 0, 0.7);\n"
+    "            border: 1px solid #446;\n"
+    "            box-shadow: 0px 0px 10px #000;\n"
+    "            padding: 8px 12px;\n"
+    "            display: inline-block;\n"
+    "            position: absolute;\n"
+    "            top: 80px;\n"
+    "            bottom: 25px;\n"
+    "            left: 50px;\n"
+    "            right: 50px;\n"
+    "            overflow: auto;\n"
+    "        }\n"
+    "        details>*:not(summary) {\n"
+    "            margin-left: 22px;\n"
+    "        }\n"
+    "        summary:only-child {\n"
+    "            display: block;\n"
+    "            padding-left: 15px;\n"
+    "        }\n"
+    "        details>summary:only-child::-webkit-details-marker {\n"
+    "            display: none;\n"
+    "            padding-left: 15px;\n"
+    "        }\n"
+    "        .headervar, .headertype, .headerval {\n"
+    "            display: inline;\n"
+    "            margin: 0 9px;\n"
+    "        }\n"
+    "        .var, .type, .val {\n"
+    "            display: inline;\n"
+    "            margin: 0 6px;\n"
+    "        }\n"
+    "        .headertype, .type {\n"
+    "            color: #acf;\n"
+    "        }\n"
+    "        .headerval, .val {\n"
+    "            color: #afa;\n"
+    "            text-align: right;\n"
+    "        }\n"
+    "        .thd {\n"
+    "            color: #888;\n"
+    "        }\n"
+    "        </style>\n"
+    "    </head>\n"
+    "    <body>\n"
+    "        <div id='header'>\n"
+    "            <img src='https://lunarg.com/wp-content/uploads/2016/02/LunarG-wReg-150.png' />\n"
+    "            <h1>OpenXR API Dump</h1>\n"
+    "        </div>\n"
+    "        <div id='wrapper'>\n";
+
+const char* const kApiDumpHtmlFooter =
+    "        </div>\n"
+    "    </body>\n"
+    "</html>";
+
+size_t ApiDumpFormatHex(char *out, uint64_t value, bool prefix) {
+    size_t size = 0;
+    if (prefix) {
+        out[size++] = '0';
+        out[size++] = 'x';
+    }
+    return static_cast<size_t>(std::to_chars(out + size, out + kApiDumpValueBufferSize, value, 16).ptr - out);
+}
+
+size_t ApiDumpFormatFixedHex(char *out, uint64_t value, size_t digits) {
+    static const char kHexDigits[] = "0123456789abcdef";
+    out[0] = '0';
+    out[1] = 'x';
+    for (size_t i = 0; i < digits; ++i) {
+        out[1 + digits - i] = kHexDigits[(value >> (4 * i)) & 0xf];
+    }
+    return digits + 2;
+}
+
+size_t ApiDumpFormatAddress(char *out, uint64_t address) {
+    if (0 == address) {
+        out[0] = '0';
+        return 1;
+    }
+    return ApiDumpFormatHex(out, address, true);
+}
+
+size_t ApiDumpFormatInt(char *out, int64_t value) {
+    return static_cast<size_t>(std::to_chars(out, out + kApiDumpValueBufferSize, value).ptr - out);
+}
+
+size_t ApiDumpFormatUint(char *out, uint64_t value) {
+    return static_cast<size_t>(std::to_chars(out, out + kApiDumpValueBufferSize, value).ptr - out);
+}
+
+size_t ApiDumpFormatFloat(char *out, double value, int precision) {
+    // Streams print floating point values with "%.*g", so this matches them digit for digit.
+    int size = std::snprintf(out, kApiDumpValueBufferSize, "%.*g", precision, value);
+    if (size < 0) {
+        return 0;
+    }
+    return std::min(static_cast<size_t>(size), kApiDumpValueBufferSize - 1);
+}
+
+// Count the structure, pointer and array dereferences in a content name, which gives its nesting depth.
+static uint32_t ApiDumpCountDereferences(std::string_view name) {
+    auto count = static_cast<uint32_t>(std::count(name.begin(), name.end(), '.'));
+    std::string_view::size_type start = 0;
+    while ((start = name.find("->", start)) != std::string_view::npos) {
+        ++count;
+        start += 2;
+    }
+    count += static_cast<uint32_t>(std::count(name.begin(), name.end(), '['));
+    return count;
+}
+
+void ApiDumpFormatText(const ApiDumpContents &contents, std::string &out) {
+    for (size_t content_index = 0; content_index < contents.Size(); ++content_index) {
+        const std::string_view content_type = contents.Type(content_index);
+        const std::string_view content_name = contents.Name(content_index);
+        const std::string_view content_value = contents.Value(content_index);
+        if (content_index != 0) {
+            out += "    ";
+        }
+        out += content_type;
+        out += ' ';
+        out += content_name;
+        if (!content_value.empty()) {
+            out += " = ";
+            out += content_value;
+        }
+        out += '\n';
+    }
+}
+
+void ApiDumpFormatHtml(const ApiDumpContents &contents, std::string &out) {
+    out += "<details class='data'>\n";
+    // Names of the entries currently open as <details>, which all live in `contents`.
+    thread_local std::vector<std::string_view> prefixes;
+    prefixes.clear();
+    uint32_t last_deref_count = 0;
+    for (size_t content_index = 0; content_index < contents.Size(); ++content_index) {
+        const std::string_view content_type = contents.Type(content_index);
+        const std::string_view content_name = contents.Name(content_index);
+        const std::string_view content_value = contents.Value(content_index);
+        if (content_index == 0) {
+            out += "   <summary>\n      <div class='headertype'>";
+            out += content_type;
+            out += "</div>\n      <div class='headervar'>";
+            out += content_name;
+            out += "</div>\n   </summary>\n";
+            continue;
+        }
+
+        // Count number of structure, pointer and array dereferences for the current line and,
+        // if there's something after this, the next one to see if it's a sub-component of this.
+        uint32_t cur_deref_count = ApiDumpCountDereferences(content_name);
+        uint32_t next_deref_count = 0;
+        if (content_index < contents.Size() - 1) {
+            next_deref_count = ApiDumpCountDereferences(contents.Name(content_index + 1));
+        }
+
+        // If we've reduced the number of dereferences in the name from last time, we need
+        // to close up those detail sections.
+        if (cur_deref_count < last_deref_count) {
+            uint32_t diff_count = last_deref_count - cur_deref_count;
+            while ((diff_count--) != 0u) {
+                out += "   </details>\n";
+                prefixes.pop_back();
+            }
+        }
+
+        // Look through any prefixes we've saved (going backwards through the list)
+        // and find the one that matches our beginning.
+        std::string_view short_name = content_name;
+        if (cur_deref_count > 0) {
+            for (auto it = prefixes.rbegin(); it != prefixes.rend(); ++it) {
+                if (content_name.find(*it) == 0) {
+                    std::string_view::size_type additional_offset = it->size() + 1;
+                    if (content_name[additional_offset - 1] == '-') {
+                        additional_offset++;
+                    } else if (content_name[additional_offset - 1] == '[') {
+                        additional_offset--;
+                    }
+                    short_name = content_name.substr(additional_offset);
+                    break;
+                }
+            }
+        }
+
+        // If the next item contains this item as a prefix, start the summary.  Otherwise,
+        // start a <div> marker so that each component lands on its own line.
+        bool writing_summary = false;
+        if (cur_deref_count < next_deref_count) {
+            out += "   <details class='data'>\n      <summary>\n";
+            writing_summary = true;
+            prefixes.push_back(content_name);
+        } else {
+            out += "      <div class='data'>\n";
+        }
+
+        // Write out the content
+        out += "         <div class='type'>";
+        out += content_type;
+        out += "</div>\n         <div class='var'>";
+        out += short_name;
+        out += "</div>\n";
+        bool value_needs_printing = true;
+        if (content_type.find("char") != std::string_view::npos) {
+            uint64_t star_count = std::count(content_type.begin(), content_type.end(), '*');
+            uint64_t bracket_count = std::count(content_type.begin(), content_type.end(), '[');
+            if (star_count + bracket_count < 2) {
+                out += "         <div class='val'>\"";
+                out += content_value;
+                out += "\"</div>";
+                value_needs_printing = false;
+            }
+        }
+        if (!content_value.empty() && value_needs_printing) {
+            out += "         <div class='val'>";
+            out += content_value;
+            out += "</div>";
+        }
+        out += '\n';
+
+        // Wrap up any summary we may have started.  Otherwise, just wrap up the
+        // <div> marker wrapping this entry.
+        out += writing_summary ? "      </summary>\n" : "      </div>\n";
+
+        last_deref_count = cur_deref_count;
+    }
+
+    // Wrap up any remaining items
+    while ((last_deref_count--) != 0u) {
+        out += "   </details>\n";
+    }
+    out += "</details>\n";
+}
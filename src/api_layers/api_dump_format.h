@@ -0,0 +1,205 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+// Copyright (c) 2017-2019 Valve Corporation
+// Copyright (c) 2017-2019 LunarG, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Author: Mark Young <marky@lunarg.com>
+// Author: Dave Houlton <daveh@lunarg.com>
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Rendering of recorded calls, shared by the api_dump layer and api_dump_convert.  Each call is a list
+// of (type, name, value) entries: the command itself first, then its parameters and their members.
+
+extern const char* const kApiDumpHtmlHeader;
+extern const char* const kApiDumpHtmlFooter;
+
+// Fixed-size value formatters.  Each writes at most kApiDumpValueBufferSize characters to `out`
+// (without a terminator) and returns the number written.
+constexpr size_t kApiDumpValueBufferSize = 96;
+// "0x" (if `prefix`) followed by the value in lowercase hex, as `std::hex` streams it.
+size_t ApiDumpFormatHex(char* out, uint64_t value, bool prefix);
+// "0x" followed by `digits` zero-padded hex digits, as PointerToHexString and HandleToHexString write.
+size_t ApiDumpFormatFixedHex(char* out, uint64_t value, size_t digits);
+// An address as streaming a pointer writes it: "0" for null, unpadded "0x..." otherwise.
+size_t ApiDumpFormatAddress(char* out, uint64_t address);
+size_t ApiDumpFormatInt(char* out, int64_t value);
+size_t ApiDumpFormatUint(char* out, uint64_t value);
+// `precision` significant digits, as `std::setprecision(precision)` streams it.
+size_t ApiDumpFormatFloat(char* out, double value, int precision);
+
+// The entries of one call.  Storage is kept between calls, so once it has grown to fit, recording a
+// call does not allocate.  Types are referenced rather than copied and must outlive the contents
+// (they are string literals everywhere they are recorded).  Entry names are the current name parts,
+// pushed by ApiDumpNameScope for each struct, member or array element being expanded, followed by
+// the name given to the Add call.
+class ApiDumpContents {
+   public:
+    void Clear() {
+        entries_.clear();
+        text_.clear();
+        name_.clear();
+    }
+
+    size_t Size() const { return entries_.size(); }
+    bool Empty() const { return entries_.empty(); }
+    std::string_view Type(size_t index) const { return entries_[index].type; }
+    std::string_view Name(size_t index) const {
+        return std::string_view(text_).substr(entries_[index].name_offset, entries_[index].name_size);
+    }
+    std::string_view Value(size_t index) const {
+        return std::string_view(text_).substr(entries_[index].value_offset, entries_[index].value_size);
+    }
+
+    void Add(std::string_view type, std::string_view name, std::string_view value) {
+        BeginEntry(type, name);
+        text_.append(value.data(), value.size());
+        EndEntry();
+    }
+    // A C string, or "(nullptr)".
+    void AddString(std::string_view type, std::string_view name, const char* value) {
+        Add(type, name, nullptr != value ? std::string_view(value) : std::string_view("(nullptr)"));
+    }
+    void AddHex(std::string_view type, std::string_view name, uint64_t value, bool prefix = true) {
+        char buffer[kApiDumpValueBufferSize];
+        Add(type, name, std::string_view(buffer, ApiDumpFormatHex(buffer, value, prefix)));
+    }
+    void AddFloat(std::string_view type, std::string_view name, double value, int precision) {
+        char buffer[kApiDumpValueBufferSize];
+        Add(type, name, std::string_view(buffer, ApiDumpFormatFloat(buffer, value, precision)));
+    }
+    // Pointers to and arrays of numbers are written as their address, as streaming them does.
+    void AddHex(std::string_view type, std::string_view name, const void* address, bool /*prefix*/ = true) {
+        AddAddress(type, name, address);
+    }
+    void AddFloat(std::string_view type, std::string_view name, const void* address, int /*precision*/) {
+        AddAddress(type, name, address);
+    }
+    void AddAddress(std::string_view type, std::string_view name, const void* address) {
+        char buffer[kApiDumpValueBufferSize];
+        Add(type, name, std::string_view(buffer, ApiDumpFormatAddress(buffer, reinterpret_cast<uintptr_t>(address))));
+    }
+    void AddPointer(std::string_view type, std::string_view name, const void* pointer) {
+        char buffer[kApiDumpValueBufferSize];
+        Add(type, name,
+            std::string_view(buffer, ApiDumpFormatFixedHex(buffer, reinterpret_cast<uintptr_t>(pointer), sizeof(void*) * 2)));
+    }
+    // A handle as HandleToHexString writes it.
+    template <typename T>
+    void AddHandle(std::string_view type, std::string_view name, T handle) {
+        uint64_t value = 0;
+        if constexpr (std::is_pointer<T>::value) {
+            value = reinterpret_cast<uintptr_t>(handle);
+        } else {
+            value = static_cast<uint64_t>(handle);
+        }
+        char buffer[kApiDumpValueBufferSize];
+        Add(type, name, std::string_view(buffer, ApiDumpFormatFixedHex(buffer, value, sizeof(T) * 2)));
+    }
+    // Integers and enums in decimal, as std::to_string writes them.
+    template <typename T>
+    void AddInt(std::string_view type, std::string_view name, T value) {
+        char buffer[kApiDumpValueBufferSize];
+        size_t size = 0;
+        if constexpr (std::is_enum<T>::value || std::is_signed<T>::value) {
+            size = ApiDumpFormatInt(buffer, static_cast<int64_t>(value));
+        } else {
+            size = ApiDumpFormatUint(buffer, static_cast<uint64_t>(value));
+        }
+        Add(type, name, std::string_view(buffer, size));
+    }
+
+    // Replace the value of an entry that has already been added.
+    void SetValue(size_t index, std::string_view value) {
+        entries_[index].value_offset = text_.size();
+        entries_[index].value_size = value.size();
+        text_.append(value.data(), value.size());
+    }
+
+    size_t NameSize() const { return name_.size(); }
+    void PushName(std::string_view part) { name_.append(part.data(), part.size()); }
+    void PushIndex(uint32_t index) {
+        char buffer[kApiDumpValueBufferSize];
+        name_ += '[';
+        name_.append(buffer, ApiDumpFormatUint(buffer, index));
+        name_ += ']';
+    }
+    void PopName(size_t size) { name_.resize(size); }
+
+   private:
+    struct Entry {
+        std::string_view type;
+        size_t name_offset;
+        size_t name_size;
+        size_t value_offset;
+        size_t value_size;
+    };
+
+    void BeginEntry(std::string_view type, std::string_view name) {
+        Entry entry;
+        entry.type = type;
+        entry.name_offset = text_.size();
+        entry.name_size = name_.size() + name.size();
+        entry.value_offset = 0;
+        entry.value_size = 0;
+        text_.append(name_);
+        text_.append(name.data(), name.size());
+        entries_.push_back(entry);
+    }
+    void EndEntry() {
+        Entry& entry = entries_.back();
+        entry.value_offset = entry.name_offset + entry.name_size;
+        entry.value_size = text_.size() - entry.value_offset;
+    }
+
+    std::vector<Entry> entries_;
+    // Entry names and values, back to back.
+    std::string text_;
+    // Name parts of whatever is currently being expanded.
+    std::string name_;
+};
+
+// Appends a name part (a member name, "->", "." or an array index) for the lifetime of the scope.
+class ApiDumpNameScope {
+   public:
+    ApiDumpNameScope(ApiDumpContents& contents, std::string_view part) : contents_(contents), size_(contents.NameSize()) {
+        contents.PushName(part);
+    }
+    ApiDumpNameScope(ApiDumpContents& contents, uint32_t index) : contents_(contents), size_(contents.NameSize()) {
+        contents.PushIndex(index);
+    }
+    ~ApiDumpNameScope() { contents_.PopName(size_); }
+    ApiDumpNameScope(const ApiDumpNameScope&) = delete;
+    ApiDumpNameScope& operator=(const ApiDumpNameScope&) = delete;
+
+   private:
+    ApiDumpContents& contents_;
+    size_t size_;
+};
+
+// Append one call to `out` as indented text lines.
+void ApiDumpFormatText(const ApiDumpContents& contents, std::string& out);
+
+// Append one call to `out` as a collapsible HTML block, for use between the HTML header and footer.
+void ApiDumpFormatHtml(const ApiDumpContents& contents, std::string& out);
@@ -0,0 +1,220 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "api_dump_writer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#ifdef __ANDROID__
+#include "android/log.h"
+#endif
+
+ApiDumpWriter& GetApiDumpWriter() {
+    // Intentionally leaked: recording threads may still be running while static destructors execute.
+    static ApiDumpWriter* writer = new ApiDumpWriter();
+    return *writer;
+}
+
+ApiDumpWriter::~ApiDumpWriter() { Close(); }
+
+ApiDumpWriter::ThreadBufferOwner::~ThreadBufferOwner() {
+    if (buffer) {
+        buffer->retired.store(true, std::memory_order_release);
+    }
+}
+
+bool ApiDumpWriter::Open(const std::string& file_name, bool truncate) {
+    std::unique_lock<std::mutex> flush_lock(flush_mutex_);
+    if (open_.load(std::memory_order_acquire)) {
+        return true;
+    }
+    if (file_name.empty()) {
+        file_ = stdout;
+        owns_file_ = false;
+    } else {
+        file_ = std::fopen(file_name.c_str(), truncate ? "wb" : "ab");
+        if (file_ == nullptr) {
+            return false;
+        }
+        owns_file_ = true;
+    }
+
+    {
+        std::unique_lock<std::mutex> wake_lock(wake_mutex_);
+        stop_ = false;
+    }
+    thread_ = std::thread(&ApiDumpWriter::WriterThread, this);
+    open_.store(true, std::memory_order_release);
+    return true;
+}
+
+void ApiDumpWriter::Close() {
+    if (!open_.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> wake_lock(wake_mutex_);
+        stop_ = true;
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    std::unique_lock<std::mutex> flush_lock(flush_mutex_);
+    DrainLocked();
+    if (owns_file_) {
+        std::fclose(file_);
+    } else if (file_ != nullptr) {
+        std::fflush(file_);
+    }
+    file_ = nullptr;
+    owns_file_ = false;
+}
+
+ApiDumpWriter::ThreadBuffer& ApiDumpWriter::GetThreadBuffer() {
+    thread_local ThreadBufferOwner owner;
+    if (!owner.buffer) {
+        owner.buffer = std::make_shared<ThreadBuffer>();
+        std::unique_lock<std::mutex> lock(buffers_mutex_);
+        buffers_.push_back(owner.buffer);
+    }
+    return *owner.buffer;
+}
+
+void ApiDumpWriter::Append(const char* data, size_t size) {
+    ThreadBuffer& buffer = GetThreadBuffer();
+    {
+        // The sequence number is taken under the buffer lock so that a drain, which holds every
+        // buffer lock at once, never sees a later call without also seeing all earlier ones.
+        std::unique_lock<std::mutex> lock(buffer.mutex);
+        Record record;
+        record.sequence = next_sequence_.fetch_add(1, std::memory_order_relaxed);
+        record.offset = buffer.data.size();
+        record.size = size;
+        buffer.data.append(data, size);
+        buffer.records.push_back(record);
+    }
+    if (buffered_bytes_.fetch_add(size, std::memory_order_relaxed) + size >= kFlushThresholdBytes) {
+        wake_.notify_one();
+    }
+}
+
+void ApiDumpWriter::Flush() {
+    std::unique_lock<std::mutex> flush_lock(flush_mutex_);
+    DrainLocked();
+}
+
+void ApiDumpWriter::WriteDirect(const std::string& text) {
+    std::unique_lock<std::mutex> flush_lock(flush_mutex_);
+    DrainLocked();
+    WriteOut(text.data(), text.size());
+    if (file_ != nullptr) {
+        std::fflush(file_);
+    }
+}
+
+void ApiDumpWriter::WriterThread() {
+    std::unique_lock<std::mutex> wake_lock(wake_mutex_);
+    while (!stop_) {
+        wake_.wait_for(wake_lock, std::chrono::milliseconds(kFlushIntervalMs));
+        if (stop_) {
+            break;
+        }
+        wake_lock.unlock();
+        Flush();
+        wake_lock.lock();
+    }
+}
+
+void ApiDumpWriter::DrainLocked() {
+    if (drain_callback_) {
+        drain_callback_();
+    }
+    {
+        std::unique_lock<std::mutex> list_lock(buffers_mutex_);
+        if (batches_.size() < buffers_.size()) {
+            batches_.resize(buffers_.size());
+        }
+
+        std::vector<std::unique_lock<std::mutex>> buffer_locks;
+        buffer_locks.reserve(buffers_.size());
+        for (auto& buffer : buffers_) {
+            buffer_locks.emplace_back(buffer->mutex);
+        }
+        for (size_t i = 0; i < buffers_.size(); ++i) {
+            batches_[i].data.clear();
+            batches_[i].records.clear();
+            std::swap(batches_[i].data, buffers_[i]->data);
+            std::swap(batches_[i].records, buffers_[i]->records);
+        }
+        buffered_bytes_.store(0, std::memory_order_relaxed);
+        buffer_locks.clear();
+
+        // Buffers whose thread has gone away were just emptied for the last time.
+        size_t kept = 0;
+        for (size_t i = 0; i < buffers_.size(); ++i) {
+            if (!buffers_[i]->retired.load(std::memory_order_acquire)) {
+                if (kept != i) {
+                    std::swap(buffers_[kept], buffers_[i]);
+                    std::swap(batches_[kept], batches_[i]);
+                }
+                ++kept;
+            }
+        }
+        // Retired batches were moved past `kept` but still hold records to write below.
+        merge_.clear();
+        for (size_t i = 0; i < buffers_.size(); ++i) {
+            for (const Record& record : batches_[i].records) {
+                merge_.push_back({record.sequence, batches_[i].data.data() + record.offset, record.size});
+            }
+        }
+        buffers_.resize(kept);
+    }
+
+    if (merge_.empty() || file_ == nullptr) {
+        return;
+    }
+    std::sort(merge_.begin(), merge_.end(),
+              [](const MergeEntry& a, const MergeEntry& b) { return a.sequence < b.sequence; });
+    for (const MergeEntry& entry : merge_) {
+        WriteOut(entry.data, entry.size);
+    }
+    std::fflush(file_);
+}
+
+void ApiDumpWriter::WriteOut(const char* data, size_t size) {
+    if (file_ == nullptr || size == 0) {
+        return;
+    }
+    std::fwrite(data, 1, size, file_);
+#ifdef __ANDROID__
+    if (file_ == stdout) {
+        // Mirror to logcat one line at a time, as the unbuffered layer used to.
+        const char* end = data + size;
+        while (data < end) {
+            const char* newline = static_cast<const char*>(std::memchr(data, '\n', static_cast<size_t>(end - data)));
+            const char* line_end = newline != nullptr ? newline : end;
+            std::string line(data, line_end);
+            __android_log_write(ANDROID_LOG_INFO, log_tag_, line.c_str());
+            data = newline != nullptr ? newline + 1 : end;
+        }
+    }
+#endif
+}
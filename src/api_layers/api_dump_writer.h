@@ -0,0 +1,140 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Buffered output for the api_dump layer.
+//
+// Each recording thread appends already-formatted records to its own buffer, tagged with a global
+// sequence number.  A background thread periodically takes every buffer at once, merges the records
+// back into call order and writes them to a file (or stdout) that stays open for the whole session.
+// Output is flushed when the buffered size crosses a threshold, after a fixed interval, and whenever
+// Flush() is called (api_dump does this on xrDestroyInstance).  The api_stats and core validation
+// layers write through it as well.
+class ApiDumpWriter {
+   public:
+    static constexpr size_t kFlushThresholdBytes = 1024 * 1024;
+    static constexpr uint32_t kFlushIntervalMs = 100;
+
+    ApiDumpWriter() = default;
+    ~ApiDumpWriter();
+    ApiDumpWriter(const ApiDumpWriter&) = delete;
+    ApiDumpWriter& operator=(const ApiDumpWriter&) = delete;
+
+    // Direct output to file_name, or to stdout when it is empty, and start the background thread.
+    // A file is truncated if `truncate` is set and appended to otherwise.  Does nothing if already open.
+    bool Open(const std::string& file_name, bool truncate);
+
+    // Flush everything and stop the background thread.  Open() may be called again afterwards.
+    void Close();
+
+    bool IsOpen() const { return open_.load(std::memory_order_acquire); }
+
+    // Called at the start of every drain, with draining serialized, so that a user queueing
+    // unformatted data of its own can format and Append it there.  Set before Open().
+    void SetDrainCallback(std::function<void()> callback) { drain_callback_ = std::move(callback); }
+
+    // Tag of the logcat copy of stdout output on Android.  Set before Open().
+    void SetLogTag(const char* tag) { log_tag_ = tag; }
+
+    // Have the background thread drain now rather than at the next interval.
+    void Wake() { wake_.notify_one(); }
+
+    // Queue one formatted record from the calling thread.
+    void Append(const char* data, size_t size);
+    void Append(const std::string& record) { Append(record.data(), record.size()); }
+
+    // Write everything queued so far, in call order, and flush the underlying stream.
+    void Flush();
+
+    // Flush, then write `text` directly, bypassing the per-thread buffers (used for HTML header/footer).
+    void WriteDirect(const std::string& text);
+
+   private:
+    struct Record {
+        uint64_t sequence;
+        size_t offset;
+        size_t size;
+    };
+
+    struct ThreadBuffer {
+        std::mutex mutex;
+        std::string data;
+        std::vector<Record> records;
+        // Set once the owning thread has exited; the buffer is dropped after its last drain.
+        std::atomic<bool> retired{false};
+    };
+
+    struct Batch {
+        std::string data;
+        std::vector<Record> records;
+    };
+
+    struct MergeEntry {
+        uint64_t sequence;
+        const char* data;
+        size_t size;
+    };
+
+    // Releases a thread's buffer back to the writer when the thread exits.
+    struct ThreadBufferOwner {
+        std::shared_ptr<ThreadBuffer> buffer;
+        ~ThreadBufferOwner();
+    };
+
+    ThreadBuffer& GetThreadBuffer();
+    void WriterThread();
+    // Caller must hold flush_mutex_.
+    void DrainLocked();
+    void WriteOut(const char* data, size_t size);
+
+    std::atomic<bool> open_{false};
+    std::FILE* file_ = nullptr;
+    bool owns_file_ = false;
+    std::function<void()> drain_callback_;
+    const char* log_tag_ = "api_dump";
+
+    // Protects the list of thread buffers; held while swapping them out so sequence order is preserved.
+    std::mutex buffers_mutex_;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+    std::atomic<uint64_t> next_sequence_{0};
+    std::atomic<size_t> buffered_bytes_{0};
+
+    // Serializes draining and writing.
+    std::mutex flush_mutex_;
+    std::vector<Batch> batches_;
+    std::vector<MergeEntry> merge_;
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+ApiDumpWriter& GetApiDumpWriter();
@@ -0,0 +1,98 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Shared between the generated api_stats commands and api_stats_layer.cpp: the time stamps taken
+// around each call and the buckets of the latency histograms.
+
+#pragma once
+
+#include "xr_generated_api_stats.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define API_STATS_USE_TSC
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define API_STATS_USE_TSC
+#endif
+
+struct XrGeneratedDispatchTable;
+
+// The layer supports one instance at a time; a second xrCreateInstance replaces the dispatch table.
+extern XrGeneratedDispatchTable *g_api_stats_next_dispatch;
+// Set once, before the first call is timed, if the time stamp counter runs at a constant rate.
+extern bool g_api_stats_use_tsc;
+
+// Latencies are kept in log-linear histograms, like HdrHistogram: values below 2 * kApiStatsSubBuckets
+// ticks get a bucket each, and every power of two above that is split into kApiStatsSubBuckets buckets,
+// so a bucket is never wider than 1/kApiStatsSubBuckets of the values it holds.  Values of 2^41 ticks
+// (minutes) and more share the last bucket.
+static constexpr uint32_t kApiStatsSubBucketBits = 4;
+static constexpr uint32_t kApiStatsSubBuckets = 1u << kApiStatsSubBucketBits;
+static constexpr uint32_t kApiStatsMaxExponent = 40;
+static constexpr uint32_t kApiStatsBuckets = (kApiStatsMaxExponent - kApiStatsSubBucketBits + 2) << kApiStatsSubBucketBits;
+
+// Time stamp in ticks: time stamp counter cycles if g_api_stats_use_tsc is set, nanoseconds otherwise.
+inline uint64_t ApiStatsTimestamp() {
+#if defined(API_STATS_USE_TSC)
+    if (g_api_stats_use_tsc) {
+        return __rdtsc();
+    }
+#endif
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+inline uint32_t ApiStatsHighestBit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - static_cast<uint32_t>(__builtin_clzll(value));
+#else
+    uint32_t bit = 0;
+    while ((value >>= 1) != 0) {
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+inline uint32_t ApiStatsBucket(uint64_t ticks) {
+    if (ticks < 2 * kApiStatsSubBuckets) {
+        return static_cast<uint32_t>(ticks);
+    }
+    const uint32_t exponent = ApiStatsHighestBit(ticks);
+    if (exponent > kApiStatsMaxExponent) {
+        return kApiStatsBuckets - 1;
+    }
+    const uint32_t shift = exponent - kApiStatsSubBucketBits;
+    return (shift << kApiStatsSubBucketBits) + static_cast<uint32_t>(ticks >> shift);
+}
+
+// Largest value, in ticks, counted in a bucket.
+inline uint64_t ApiStatsBucketUpperBound(uint32_t bucket) {
+    if (bucket < 2 * kApiStatsSubBuckets) {
+        return bucket;
+    }
+    const uint32_t shift = (bucket >> kApiStatsSubBucketBits) - 1;
+    const uint64_t mantissa = (bucket & (kApiStatsSubBuckets - 1)) + kApiStatsSubBuckets;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+// Account for a call to `command` that started at `start` and has just returned.
+void ApiStatsRecord(ApiStatsCommand command, uint64_t start, bool failed);
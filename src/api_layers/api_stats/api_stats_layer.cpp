@@ -0,0 +1,552 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Counts the calls to every command and the time spent below the layer, and periodically writes
+// per-command call rates and latency percentiles.  The generated wrappers in xr_generated_api_stats.cpp
+// time each call and pass it to ApiStatsRecord; this file holds the per-thread counters, the thread
+// that merges and reports them, and the instance commands.
+//
+// Every thread that calls into the layer owns one ApiStatsThreadCounters block, and within it one
+// ApiStatsCommandCounters per command it has called.  Only the owning thread writes to a block, with
+// relaxed loads and stores, so recording a call takes no lock and no atomic read-modify-write.  The
+// reporting thread reads the blocks of all threads with relaxed loads and adds them up.
+
+#include "api_stats.h"
+#include "api_dump_writer.h"
+
+#include "platform_utils.hpp"
+#include "xr_generated_dispatch_table.h"
+
+#include <openxr/openxr.h>
+#include <openxr/openxr_loader_negotiation.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(API_STATS_USE_TSC) && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+#ifdef __ANDROID__
+#include "android/log.h"
+#endif
+
+#if defined(__GNUC__) && __GNUC__ >= 4
+#define LAYER_EXPORT __attribute__((visibility("default")))
+#elif defined(__SUNPRO_C) && (__SUNPRO_C >= 0x590)
+#define LAYER_EXPORT __attribute__((visibility("default")))
+#elif defined(_WIN32)
+#define LAYER_EXPORT __declspec(dllexport)
+#else
+#define LAYER_EXPORT
+#endif
+
+// For routing platform_utils.hpp messages.
+void LogPlatformUtilsError(const std::string &message) {
+    (void)message;  // maybe unused
+#if !defined(NDEBUG)
+    std::cerr << message << std::endl;
+#endif
+
+#if defined(XR_OS_WINDOWS)
+    OutputDebugStringA((message + "\n").c_str());
+#elif defined(XR_OS_ANDROID)
+    __android_log_write(ANDROID_LOG_ERROR, "OpenXR-ApiStats", message.c_str());
+#endif
+}
+
+XrGeneratedDispatchTable *g_api_stats_next_dispatch = nullptr;
+bool g_api_stats_use_tsc = false;
+
+static constexpr uint32_t kDefaultIntervalMs = 10000;
+
+struct ApiStatsCommandCounters {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> failures{0};
+    std::atomic<uint64_t> total_ticks{0};
+    std::atomic<uint64_t> buckets[kApiStatsBuckets] = {};
+};
+
+struct ApiStatsThreadCounters {
+    // Allocated by the owning thread the first time it calls the command.
+    std::atomic<ApiStatsCommandCounters *> commands[API_STATS_COMMAND_COUNT] = {};
+};
+
+// The block of the calling thread, or nullptr if it has not called into the layer yet.
+static thread_local ApiStatsThreadCounters *t_api_stats_thread = nullptr;
+
+// Merged counts of one command.
+struct ApiStatsTotals {
+    uint64_t calls = 0;
+    uint64_t failures = 0;
+    uint64_t total_ticks = 0;
+    uint64_t buckets[kApiStatsBuckets] = {};
+
+    void Add(const ApiStatsCommandCounters &counters) {
+        calls += counters.calls.load(std::memory_order_relaxed);
+        failures += counters.failures.load(std::memory_order_relaxed);
+        total_ticks += counters.total_ticks.load(std::memory_order_relaxed);
+        for (uint32_t bucket = 0; bucket < kApiStatsBuckets; ++bucket) {
+            buckets[bucket] += counters.buckets[bucket].load(std::memory_order_relaxed);
+        }
+    }
+
+    void Add(const ApiStatsTotals &totals) {
+        calls += totals.calls;
+        failures += totals.failures;
+        total_ticks += totals.total_ticks;
+        for (uint32_t bucket = 0; bucket < kApiStatsBuckets; ++bucket) {
+            buckets[bucket] += totals.buckets[bucket];
+        }
+    }
+};
+
+using ApiStatsSnapshot = std::vector<std::unique_ptr<ApiStatsTotals>>;  // indexed by ApiStatsCommand
+
+// All per-thread blocks, and the counts of threads that have exited.
+struct ApiStatsRegistry {
+    std::mutex mutex;
+    std::vector<ApiStatsThreadCounters *> threads;
+    ApiStatsSnapshot retired = ApiStatsSnapshot(API_STATS_COMMAND_COUNT);
+};
+
+// Never destroyed, so threads that exit during process teardown can still hand over their counts.
+static ApiStatsRegistry &GetApiStatsRegistry() {
+    static ApiStatsRegistry *registry = new ApiStatsRegistry();
+    return *registry;
+}
+
+// Folds the counts of the thread into the registry when the thread exits.
+struct ApiStatsThreadOwner {
+    ApiStatsThreadCounters counters;
+
+    ~ApiStatsThreadOwner() {
+        ApiStatsRegistry &registry = GetApiStatsRegistry();
+        std::unique_lock<std::mutex> lock(registry.mutex);
+        for (uint32_t command = 0; command < API_STATS_COMMAND_COUNT; ++command) {
+            ApiStatsCommandCounters *command_counters = counters.commands[command].load(std::memory_order_acquire);
+            if (command_counters != nullptr) {
+                if (!registry.retired[command]) {
+                    registry.retired[command].reset(new ApiStatsTotals());
+                }
+                registry.retired[command]->Add(*command_counters);
+                delete command_counters;
+            }
+        }
+        registry.threads.erase(std::remove(registry.threads.begin(), registry.threads.end(), &counters), registry.threads.end());
+        t_api_stats_thread = nullptr;
+    }
+};
+
+static ApiStatsThreadCounters *ApiStatsRegisterThread() {
+    static thread_local ApiStatsThreadOwner owner;
+    ApiStatsRegistry &registry = GetApiStatsRegistry();
+    std::unique_lock<std::mutex> lock(registry.mutex);
+    registry.threads.push_back(&owner.counters);
+    t_api_stats_thread = &owner.counters;
+    return t_api_stats_thread;
+}
+
+static ApiStatsCommandCounters *ApiStatsAddCommand(ApiStatsThreadCounters &thread, ApiStatsCommand command) {
+    auto *counters = new ApiStatsCommandCounters();
+    thread.commands[command].store(counters, std::memory_order_release);
+    return counters;
+}
+
+// Only the owning thread changes its counters, so a load and a store are enough.
+static inline void ApiStatsAdd(std::atomic<uint64_t> &counter, uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+void ApiStatsRecord(ApiStatsCommand command, uint64_t start, bool failed) {
+    const uint64_t ticks = ApiStatsTimestamp() - start;
+    ApiStatsThreadCounters *thread = t_api_stats_thread;
+    if (thread == nullptr) {
+        thread = ApiStatsRegisterThread();
+    }
+    ApiStatsCommandCounters *counters = thread->commands[command].load(std::memory_order_relaxed);
+    if (counters == nullptr) {
+        counters = ApiStatsAddCommand(*thread, command);
+    }
+    ApiStatsAdd(counters->calls, 1);
+    ApiStatsAdd(counters->total_ticks, ticks);
+    ApiStatsAdd(counters->buckets[ApiStatsBucket(ticks)], 1);
+    if (failed) {
+        ApiStatsAdd(counters->failures, 1);
+    }
+}
+
+// Sum of the counts of all threads, live and exited.
+static ApiStatsSnapshot ApiStatsTakeSnapshot() {
+    ApiStatsSnapshot snapshot(API_STATS_COMMAND_COUNT);
+    ApiStatsRegistry &registry = GetApiStatsRegistry();
+    std::unique_lock<std::mutex> lock(registry.mutex);
+    for (uint32_t command = 0; command < API_STATS_COMMAND_COUNT; ++command) {
+        if (registry.retired[command]) {
+            snapshot[command].reset(new ApiStatsTotals(*registry.retired[command]));
+        }
+        for (ApiStatsThreadCounters *thread : registry.threads) {
+            const ApiStatsCommandCounters *counters = thread->commands[command].load(std::memory_order_acquire);
+            if (counters != nullptr) {
+                if (!snapshot[command]) {
+                    snapshot[command].reset(new ApiStatsTotals());
+                }
+                snapshot[command]->Add(*counters);
+            }
+        }
+    }
+    return snapshot;
+}
+
+static bool ApiStatsTscIsInvariant() {
+#if defined(API_STATS_USE_TSC)
+    uint32_t registers[4] = {};
+#if defined(_MSC_VER)
+    int msvc_registers[4] = {};
+    __cpuid(msvc_registers, 0x80000000);
+    if (static_cast<uint32_t>(msvc_registers[0]) < 0x80000007) {
+        return false;
+    }
+    __cpuid(msvc_registers, 0x80000007);
+    memcpy(registers, msvc_registers, sizeof(registers));
+#else
+    if (__get_cpuid(0x80000007, &registers[0], &registers[1], &registers[2], &registers[3]) == 0) {
+        return false;
+    }
+#endif
+    // EDX bit 8: the counter runs at a constant rate in every power state.
+    return (registers[3] & (1u << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+static std::string ApiStatsSetting(const char *env_name, const char *property_name) {
+#if !defined(XR_OS_ANDROID)
+    (void)property_name;
+    return PlatformUtilsGetEnv(env_name);
+#else
+    (void)env_name;
+    return PlatformUtilsGetAndroidSystemProperty(property_name);
+#endif
+}
+
+// Writes the statistics every interval from a background thread, and once more at xrDestroyInstance.
+class ApiStatsReporter {
+   public:
+    void Start(const std::string &file_name, uint32_t interval_ms) {
+        // Later instances of the process append to the file of the first.
+        if (!GetApiDumpWriter().Open(file_name, !opened_)) {
+            LogPlatformUtilsError("API stats layer unable to open " + file_name);
+            return;
+        }
+        opened_ = true;
+        start_ticks_ = ApiStatsTimestamp();
+        start_time_ = std::chrono::steady_clock::now();
+        last_ticks_ = start_ticks_;
+        // Counts are kept for the life of the process; each instance reports the calls made since it was created.
+        start_snapshot_ = ApiStatsTakeSnapshot();
+        last_snapshot_ = ApiStatsTakeSnapshot();
+        stop_ = false;
+        if (interval_ms != 0) {
+            thread_ = std::thread(&ApiStatsReporter::Run, this, interval_ms);
+        }
+    }
+
+    void Stop() {
+        if (!GetApiDumpWriter().IsOpen()) {
+            return;
+        }
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        condition_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+
+        ApiStatsSnapshot snapshot = ApiStatsTakeSnapshot();
+        const uint64_t now_ticks = ApiStatsTimestamp();
+        Write("since xrCreateInstance", snapshot, start_snapshot_, now_ticks - start_ticks_);
+        GetApiDumpWriter().Close();
+    }
+
+   private:
+    void Run(uint32_t interval_ms) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!condition_.wait_for(lock, std::chrono::milliseconds(interval_ms), [this] { return stop_; })) {
+            lock.unlock();
+            ApiStatsSnapshot snapshot = ApiStatsTakeSnapshot();
+            const uint64_t now_ticks = ApiStatsTimestamp();
+            Write("last interval", snapshot, last_snapshot_, now_ticks - last_ticks_);
+            last_snapshot_ = std::move(snapshot);
+            last_ticks_ = now_ticks;
+            lock.lock();
+        }
+    }
+
+    // Nanoseconds per tick, measured against the steady clock since Start().
+    double NsPerTick() {
+        if (!g_api_stats_use_tsc) {
+            return 1.0;
+        }
+        // A short run gives too coarse a rate; wait until the measurement spans at least 50 ms.
+        const auto min_elapsed = std::chrono::milliseconds(50);
+        const auto elapsed = std::chrono::steady_clock::now() - start_time_;
+        if (elapsed < min_elapsed) {
+            std::this_thread::sleep_for(min_elapsed - elapsed);
+        }
+        const uint64_t ticks = ApiStatsTimestamp() - start_ticks_;
+        const double ns = static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time_).count());
+        return ticks == 0 ? 1.0 : ns / static_cast<double>(ticks);
+    }
+
+    // Value, in ticks, below which `fraction` of the calls completed.
+    static uint64_t Percentile(const ApiStatsTotals &totals, uint64_t count, double fraction) {
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * static_cast<double>(count) + 0.5));
+        uint64_t seen = 0;
+        for (uint32_t bucket = 0; bucket < kApiStatsBuckets; ++bucket) {
+            seen += totals.buckets[bucket];
+            if (seen >= rank) {
+                return ApiStatsBucketUpperBound(bucket);
+            }
+        }
+        return ApiStatsBucketUpperBound(kApiStatsBuckets - 1);
+    }
+
+    // Write one table with the counts in `snapshot` less those in `previous`, over `elapsed_ticks`.
+    void Write(const char *heading, const ApiStatsSnapshot &snapshot, const ApiStatsSnapshot &previous, uint64_t elapsed_ticks) {
+        const double ns_per_tick = NsPerTick();
+        const double elapsed_s = static_cast<double>(elapsed_ticks) * ns_per_tick / 1e9;
+
+        struct Row {
+            uint32_t command;
+            ApiStatsTotals totals;
+        };
+        std::vector<std::unique_ptr<Row>> rows;
+        for (uint32_t command = 0; command < API_STATS_COMMAND_COUNT; ++command) {
+            if (!snapshot[command]) {
+                continue;
+            }
+            std::unique_ptr<Row> row(new Row());
+            row->command = command;
+            row->totals = *snapshot[command];
+            if (previous[command]) {
+                const ApiStatsTotals &before = *previous[command];
+                row->totals.calls -= before.calls;
+                row->totals.failures -= before.failures;
+                row->totals.total_ticks -= before.total_ticks;
+                for (uint32_t bucket = 0; bucket < kApiStatsBuckets; ++bucket) {
+                    row->totals.buckets[bucket] -= before.buckets[bucket];
+                }
+            }
+            if (row->totals.calls != 0) {
+                rows.push_back(std::move(row));
+            }
+        }
+        std::sort(rows.begin(), rows.end(), [](const std::unique_ptr<Row> &a, const std::unique_ptr<Row> &b) {
+            return a->totals.total_ticks > b->totals.total_ticks;
+        });
+
+        char line[256];
+        snprintf(line, sizeof(line), "==== OpenXR API statistics, %s (%.3f s) ====\n", heading, elapsed_s);
+        std::string text = line;
+        snprintf(line, sizeof(line), "%-48s %10s %10s %8s %12s %10s %10s %10s %10s\n", "command", "calls", "calls/s", "failed",
+                 "total ms", "mean us", "p50 us", "p99 us", "p99.9 us");
+        text += line;
+        for (const std::unique_ptr<Row> &row : rows) {
+            const ApiStatsTotals &totals = row->totals;
+            // The bucket counts are read separately from the call count, so use their sum for the percentiles.
+            uint64_t count = 0;
+            for (uint32_t bucket = 0; bucket < kApiStatsBuckets; ++bucket) {
+                count += totals.buckets[bucket];
+            }
+            const double us_per_tick = ns_per_tick / 1000.0;
+            snprintf(line, sizeof(line), "%-48s %10llu %10.2f %8llu %12.3f %10.3f %10.3f %10.3f %10.3f\n",
+                     kApiStatsCommandNames[row->command], static_cast<unsigned long long>(totals.calls),
+                     elapsed_s > 0.0 ? static_cast<double>(totals.calls) / elapsed_s : 0.0,
+                     static_cast<unsigned long long>(totals.failures), static_cast<double>(totals.total_ticks) * us_per_tick / 1000.0,
+                     static_cast<double>(totals.total_ticks) * us_per_tick / static_cast<double>(totals.calls),
+                     static_cast<double>(Percentile(totals, count, 0.5)) * us_per_tick,
+                     static_cast<double>(Percentile(totals, count, 0.99)) * us_per_tick,
+                     static_cast<double>(Percentile(totals, count, 0.999)) * us_per_tick);
+            text += line;
+        }
+        text += "\n";
+        GetApiDumpWriter().WriteDirect(text);
+    }
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stop_ = false;
+    bool opened_ = false;
+    std::thread thread_;
+    uint64_t start_ticks_ = 0;
+    std::chrono::steady_clock::time_point start_time_;
+    uint64_t last_ticks_ = 0;
+    ApiStatsSnapshot start_snapshot_;
+    ApiStatsSnapshot last_snapshot_;
+};
+
+static ApiStatsReporter g_reporter;
+
+XRAPI_ATTR XrResult XRAPI_CALL ApiStatsLayerXrDestroyInstance(XrInstance instance) {
+    XrGeneratedDispatchTable *next_dispatch = g_api_stats_next_dispatch;
+    XrResult result = next_dispatch->DestroyInstance(instance);
+
+    g_reporter.Stop();
+
+    g_api_stats_next_dispatch = nullptr;
+    delete next_dispatch;
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ApiStatsLayerXrGetInstanceProcAddr(XrInstance instance, const char *name,
+                                                                  PFN_xrVoidFunction *function) {
+    try {
+        std::string func_name = name;
+        if (func_name == "xrGetInstanceProcAddr") {
+            *function = reinterpret_cast<PFN_xrVoidFunction>(ApiStatsLayerXrGetInstanceProcAddr);
+        } else if (func_name == "xrDestroyInstance") {
+            *function = reinterpret_cast<PFN_xrVoidFunction>(ApiStatsLayerXrDestroyInstance);
+        } else {
+            *function = ApiStatsLayerInnerGetInstanceProcAddr(name);
+        }
+
+        if (*function != nullptr) {
+            return XR_SUCCESS;
+        }
+
+        // We have not found it, so pass it down to the next layer/runtime
+        if (nullptr == g_api_stats_next_dispatch) {
+            return XR_ERROR_HANDLE_INVALID;
+        }
+        return g_api_stats_next_dispatch->GetInstanceProcAddr(instance, name, function);
+    } catch (...) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ApiStatsLayerXrCreateApiLayerInstance(const XrInstanceCreateInfo *info,
+                                                                     const struct XrApiLayerCreateInfo *apiLayerInfo,
+                                                                     XrInstance *instance) {
+    try {
+        XrApiLayerCreateInfo new_api_layer_info = {};
+
+        // Validate the API layer info and next API layer info structures before we try to use them
+        if (nullptr == apiLayerInfo || XR_LOADER_INTERFACE_STRUCT_API_LAYER_CREATE_INFO != apiLayerInfo->structType ||
+            XR_API_LAYER_CREATE_INFO_STRUCT_VERSION > apiLayerInfo->structVersion ||
+            sizeof(XrApiLayerCreateInfo) > apiLayerInfo->structSize || nullptr == apiLayerInfo->nextInfo ||
+            XR_LOADER_INTERFACE_STRUCT_API_LAYER_NEXT_INFO != apiLayerInfo->nextInfo->structType ||
+            XR_API_LAYER_NEXT_INFO_STRUCT_VERSION > apiLayerInfo->nextInfo->structVersion ||
+            sizeof(XrApiLayerNextInfo) > apiLayerInfo->nextInfo->structSize ||
+            0 != strcmp("XR_APILAYER_KHRONOS_api_stats", apiLayerInfo->nextInfo->layerName) ||
+            nullptr == apiLayerInfo->nextInfo->nextGetInstanceProcAddr ||
+            nullptr == apiLayerInfo->nextInfo->nextCreateApiLayerInstance) {
+            return XR_ERROR_INITIALIZATION_FAILED;
+        }
+
+        // The tick source is chosen once and never changes, as wrappers of an earlier instance may still
+        // be timing a call.
+        static std::once_flag tick_source_once;
+        std::call_once(tick_source_once, [] { g_api_stats_use_tsc = ApiStatsTscIsInvariant(); });
+
+        // Copy the contents of the layer info struct, but then move the next info up by
+        // one slot so that the next layer gets information.
+        memcpy(&new_api_layer_info, apiLayerInfo, sizeof(XrApiLayerCreateInfo));
+        new_api_layer_info.nextInfo = apiLayerInfo->nextInfo->next;
+
+        // Get the function pointers we need
+        PFN_xrGetInstanceProcAddr next_get_instance_proc_addr = apiLayerInfo->nextInfo->nextGetInstanceProcAddr;
+        PFN_xrCreateApiLayerInstance next_create_api_layer_instance = apiLayerInfo->nextInfo->nextCreateApiLayerInstance;
+
+        // Create the instance using the layer create instance command for the next layer
+        XrInstance returned_instance = *instance;
+        XrResult result = next_create_api_layer_instance(info, &new_api_layer_info, &returned_instance);
+        *instance = returned_instance;
+
+        if (XR_SUCCEEDED(result)) {
+            // Create the dispatch table to the next levels
+            auto *next_dispatch = new XrGeneratedDispatchTable();
+            GeneratedXrPopulateDispatchTable(next_dispatch, returned_instance, next_get_instance_proc_addr);
+            delete g_api_stats_next_dispatch;
+            g_api_stats_next_dispatch = next_dispatch;
+
+            if (!GetApiDumpWriter().IsOpen()) {
+                uint32_t interval_ms = kDefaultIntervalMs;
+                std::string interval = ApiStatsSetting("XR_API_STATS_INTERVAL_MS", "debug.api_stats_interval_ms");
+                if (!interval.empty()) {
+                    interval_ms = static_cast<uint32_t>(strtoul(interval.c_str(), nullptr, 10));
+                }
+                g_reporter.Start(ApiStatsSetting("XR_API_STATS_FILE", "debug.api_stats_file"), interval_ms);
+            }
+        }
+
+        return result;
+    } catch (...) {
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+}
+
+// Function used to negotiate an interface betewen the loader and an API layer.  Each library exposing one or
+// more API layers needs to expose at least this function.
+extern "C" LAYER_EXPORT XRAPI_ATTR XrResult XRAPI_CALL xrNegotiateLoaderApiLayerInterface(
+    const XrNegotiateLoaderInfo *loaderInfo, const char * /*apiLayerName*/, XrNegotiateApiLayerRequest *apiLayerRequest) {
+    if (loaderInfo == nullptr || loaderInfo->structType != XR_LOADER_INTERFACE_STRUCT_LOADER_INFO ||
+        loaderInfo->structVersion != XR_LOADER_INFO_STRUCT_VERSION || loaderInfo->structSize != sizeof(XrNegotiateLoaderInfo)) {
+        LogPlatformUtilsError("loaderInfo struct is not valid");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (loaderInfo->minInterfaceVersion > XR_CURRENT_LOADER_API_LAYER_VERSION ||
+        loaderInfo->maxInterfaceVersion < XR_CURRENT_LOADER_API_LAYER_VERSION) {
+        LogPlatformUtilsError("loader interface version is not in the range [minInterfaceVersion, maxInterfaceVersion]");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (loaderInfo->minApiVersion > XR_CURRENT_API_VERSION || loaderInfo->maxApiVersion < XR_CURRENT_API_VERSION) {
+        LogPlatformUtilsError("loader api version is not in the range [minApiVersion, maxApiVersion]");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (apiLayerRequest == nullptr || apiLayerRequest->structType != XR_LOADER_INTERFACE_STRUCT_API_LAYER_REQUEST ||
+        apiLayerRequest->structVersion != XR_API_LAYER_INFO_STRUCT_VERSION ||
+        apiLayerRequest->structSize != sizeof(XrNegotiateApiLayerRequest)) {
+        LogPlatformUtilsError("apiLayerRequest is not valid");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    apiLayerRequest->layerInterfaceVersion = XR_CURRENT_LOADER_API_LAYER_VERSION;
+    apiLayerRequest->layerApiVersion = XR_CURRENT_API_VERSION;
+    apiLayerRequest->getInstanceProcAddr = ApiStatsLayerXrGetInstanceProcAddr;
+    apiLayerRequest->createApiLayerInstance = ApiStatsLayerXrCreateApiLayerInstance;
+
+    return XR_SUCCESS;
+}
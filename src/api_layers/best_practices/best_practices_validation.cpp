@@ -10,21 +10,26 @@
 #include "hex_and_handles.h"
 #include "platform_utils.hpp"
 #include "xr_generated_dispatch_table.h"
+#include "xr_layer_handle_data.h"
 
 #include <openxr/openxr.h>
 #include <openxr/openxr_loader_negotiation.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <iostream>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
@@ -70,42 +75,305 @@ struct FrameState {
     XrTime predictedDisplayTime;
     XrTime predictedDisplayPeriod;
     uint32_t frameIndex;
+    uint32_t viewCount;
     XrView views[2];
+    // Steady clock time, in nanoseconds, at which xrWaitFrame returned.
+    int64_t waitFrameReturnTime;
 };
 
-static LockedDispatchTable g_nextDispatch{};
-static std::deque<FrameState> g_framesInFlight;
-static std::mutex g_frameMutex;
-static uint32_t g_frameIndex;
-static XrTime g_lastEndFramePDT;
+// A quad layer as submitted to the previous xrEndFrame.
+struct QuadLayerRecord {
+    XrCompositionLayerQuad layer;
+    // xrReleaseSwapchainImage calls on the swapchain of the layer, up to that xrEndFrame.
+    uint64_t releaseCount;
+    // Consecutive frames that submitted this layer unchanged but with a newly rendered image.
+    uint32_t rerenderedFrames;
+};
+
+// Frame tracking for one XrSession.
+struct SessionState {
+    // Guards everything below.  Only contended when the application calls the frame functions of this session
+    // from more than one thread at the same time.  It is never held while calling down, so a runtime that blocks
+    // in one frame function does not hold up the bookkeeping of the others.
+    std::mutex frameMutex;
+    std::deque<FrameState> framesInFlight;
+    uint32_t frameIndex = 0;
+    XrTime lastEndFramePDT = 0;
+
+    // Performance lint state.
+    uint32_t locateSpaceCalls = 0;  // since the last xrEndFrame
+    uint32_t locateViewsCalls = 0;  // since the last xrEndFrame
+    std::vector<std::pair<XrAction, XrPath>> actionStatesQueried;  // since the last xrSyncActions
+    std::thread::id lastEndFrameThread;
+    int64_t lastEndFrameTime = 0;
+    XrDuration lastPredictedDisplayPeriod = 0;
+    uint64_t framesEnded = 0;
+    std::vector<QuadLayerRecord> quadLayers;
+    std::vector<QuadLayerRecord> nextQuadLayers;
+    std::unordered_map<XrSwapchain, uint64_t> swapchainReleases;
+};
+
+// Maps XrSession, XrSpace and XrSwapchain handles to their SessionState.  When the loader provides per-handle data
+// slots, the state is also stored in the layer's slot of each handle and found there without locking.  Each map is
+// split into shards behind their own shared_mutex, so a lookup that falls back to the maps only takes a shared lock on
+// one shard, and creating or destroying a handle only locks the shard it falls in.  A SessionState is freed when its
+// session is destroyed; the application may not use the session or its children on another thread at that point.
+class SessionRegistry {
+   public:
+    SessionState *Find(XrSession session) const { return Lookup(m_sessionMap, XR_OBJECT_TYPE_SESSION, session); }
+    SessionState *FindBySpace(XrSpace space) const { return Lookup(m_spaceMap, XR_OBJECT_TYPE_SPACE, space); }
+    SessionState *FindBySwapchain(XrSwapchain swapchain) const {
+        return Lookup(m_swapchainMap, XR_OBJECT_TYPE_SWAPCHAIN, swapchain);
+    }
+
+    // Use the loader's per-handle data slots for the handles added from now on, until Clear().
+    void UseHandleDataTable(XrLayerHandleDataTable *table, uint32_t slot) {
+        std::unique_lock<std::mutex> lock{m_writeMutex};
+        m_handleDataSlot = slot;
+        m_handleData.store(table, std::memory_order_release);
+    }
+
+    void AddSession(XrSession session) {
+        std::unique_lock<std::mutex> lock{m_writeMutex};
+        auto &state = m_sessionStates[session];
+        state = std::make_unique<SessionState>();
+        m_sessionMap.Set(session, state.get());
+        SetHandleData(XR_OBJECT_TYPE_SESSION, session, state.get());
+    }
+
+    // Also forgets the spaces and swapchains of the session, which are destroyed with it.
+    void RemoveSession(XrSession session) {
+        std::unique_lock<std::mutex> lock{m_writeMutex};
+        auto it = m_sessionStates.find(session);
+        if (it == m_sessionStates.end()) return;
+        SetHandleData(XR_OBJECT_TYPE_SESSION, session, nullptr);
+        m_sessionMap.Erase(session);
+        m_spaceMap.EraseValue(it->second.get(), [this](XrSpace space) { SetHandleData(XR_OBJECT_TYPE_SPACE, space, nullptr); });
+        m_swapchainMap.EraseValue(it->second.get(), [this](XrSwapchain swapchain) {
+            SetHandleData(XR_OBJECT_TYPE_SWAPCHAIN, swapchain, nullptr);
+        });
+        m_sessionStates.erase(it);
+    }
+
+    void AddSpace(XrSpace space, XrSession session) { AddChild(m_spaceMap, XR_OBJECT_TYPE_SPACE, space, session); }
+    void RemoveSpace(XrSpace space) { RemoveChild(m_spaceMap, XR_OBJECT_TYPE_SPACE, space); }
+    void AddSwapchain(XrSwapchain swapchain, XrSession session) {
+        AddChild(m_swapchainMap, XR_OBJECT_TYPE_SWAPCHAIN, swapchain, session);
+    }
+    void RemoveSwapchain(XrSwapchain swapchain) { RemoveChild(m_swapchainMap, XR_OBJECT_TYPE_SWAPCHAIN, swapchain); }
+
+    // No other call may be in flight.  The loader clears the slots itself when the instance is destroyed.
+    void Clear() {
+        std::unique_lock<std::mutex> lock{m_writeMutex};
+        m_handleData.store(nullptr, std::memory_order_release);
+        m_sessionMap.Clear();
+        m_spaceMap.Clear();
+        m_swapchainMap.Clear();
+        m_sessionStates.clear();
+    }
+
+   private:
+    template <typename Handle>
+    class ShardedMap {
+       public:
+        SessionState *Find(Handle handle) const {
+            const Shard &shard = ShardOf(handle);
+            std::shared_lock<std::shared_mutex> lock{shard.mutex};
+            auto it = shard.map.find(handle);
+            return it == shard.map.end() ? nullptr : it->second;
+        }
+
+        void Set(Handle handle, SessionState *state) {
+            Shard &shard = ShardOf(handle);
+            std::unique_lock<std::shared_mutex> lock{shard.mutex};
+            shard.map[handle] = state;
+        }
+
+        void Erase(Handle handle) {
+            Shard &shard = ShardOf(handle);
+            std::unique_lock<std::shared_mutex> lock{shard.mutex};
+            shard.map.erase(handle);
+        }
+
+        template <typename OnErase>
+        void EraseValue(const SessionState *state, OnErase &&onErase) {
+            for (Shard &shard : m_shards) {
+                std::unique_lock<std::shared_mutex> lock{shard.mutex};
+                for (auto it = shard.map.begin(); it != shard.map.end();) {
+                    if (it->second == state) {
+                        onErase(it->first);
+                        it = shard.map.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+        }
+
+        void Clear() {
+            for (Shard &shard : m_shards) {
+                std::unique_lock<std::shared_mutex> lock{shard.mutex};
+                shard.map.clear();
+            }
+        }
+
+       private:
+        static constexpr size_t kShardCount = 16;
+
+        // Each shard on its own cache line, so that readers of different shards do not share one.
+        struct alignas(64) Shard {
+            mutable std::shared_mutex mutex;
+            std::unordered_map<Handle, SessionState *> map;
+        };
+
+        // Handles are often aligned pointers, so mix the bits before picking a shard.
+        Shard &ShardOf(Handle handle) { return m_shards[ShardIndex(handle)]; }
+        const Shard &ShardOf(Handle handle) const { return m_shards[ShardIndex(handle)]; }
+        static size_t ShardIndex(Handle handle) {
+            uint64_t value = MakeHandleGeneric(handle);
+            value ^= value >> 33;
+            value *= 0xff51afd7ed558ccdULL;
+            return static_cast<size_t>(value >> 60) % kShardCount;
+        }
+
+        Shard m_shards[kShardCount];
+    };
+
+    template <typename Handle>
+    SessionState *Lookup(const ShardedMap<Handle> &map, XrObjectType objectType, Handle handle) const {
+        const XrLayerHandleDataTable *table = m_handleData.load(std::memory_order_acquire);
+        if (table != nullptr) {
+            void *state = XrLayerHandleDataGet(table, objectType, MakeHandleGeneric(handle), m_handleDataSlot);
+            if (state != nullptr) return static_cast<SessionState *>(state);
+        }
+        return map.Find(handle);
+    }
 
-std::unordered_map<std::string, int> BPLogger::errorCounts;
+    // On failure, such as a full table, the handle is simply found through the maps.
+    template <typename Handle>
+    void SetHandleData(XrObjectType objectType, Handle handle, SessionState *state) {
+        XrLayerHandleDataTable *table = m_handleData.load(std::memory_order_relaxed);
+        if (table != nullptr) {
+            (void)table->set(objectType, MakeHandleGeneric(handle), m_handleDataSlot, state);
+        }
+    }
+
+    template <typename Handle>
+    void AddChild(ShardedMap<Handle> &children, XrObjectType objectType, Handle handle, XrSession session) {
+        std::unique_lock<std::mutex> lock{m_writeMutex};
+        auto it = m_sessionStates.find(session);
+        if (it != m_sessionStates.end()) {
+            children.Set(handle, it->second.get());
+            SetHandleData(objectType, handle, it->second.get());
+        }
+    }
+
+    template <typename Handle>
+    void RemoveChild(ShardedMap<Handle> &children, XrObjectType objectType, Handle handle) {
+        std::unique_lock<std::mutex> lock{m_writeMutex};
+        SetHandleData(objectType, handle, nullptr);
+        children.Erase(handle);
+    }
+
+    // Loader-provided per-handle data slots, or nullptr when the loader does not offer them.
+    std::atomic<XrLayerHandleDataTable *> m_handleData{nullptr};
+    uint32_t m_handleDataSlot = 0;
+
+    ShardedMap<XrSession> m_sessionMap;
+    ShardedMap<XrSpace> m_spaceMap;
+    ShardedMap<XrSwapchain> m_swapchainMap;
+
+    // Serializes adding and removing sessions, which own their state.
+    std::mutex m_writeMutex;
+    std::unordered_map<XrSession, std::unique_ptr<SessionState>> m_sessionStates;
+};
+
+static AtomicDispatchTable g_nextDispatch{};
+static SessionRegistry g_sessions{};
+
+// Performance lint settings.  More xrLocateSpace calls than this in one frame could have been one xrLocateSpaces call.
+static constexpr uint32_t kLocateSpaceBatchThreshold = 4;
+// A quad layer re-rendered unchanged for this many frames in a row is reported (again every this many frames).
+static constexpr uint32_t kUnchangedQuadLayerFrames = 90;
+// A summary of all messages is written every this many frames of a session; 0 disables it.
+static constexpr uint32_t kDefaultSummaryInterval = 1000;
+static uint32_t g_summaryInterval = kDefaultSummaryInterval;
+static const std::string kLocateSpaceNotBatchedMessage =
+    "xrLocateSpace was called more than " + std::to_string(kLocateSpaceBatchThreshold) +
+    " times in one frame. Locating all spaces with one xrLocateSpaces call is cheaper.";
+static const std::string kUnchangedQuadLayerMessage =
+    "A quad layer was submitted unchanged for " + std::to_string(kUnchangedQuadLayerFrames) +
+    " frames while its swapchain image was rendered again every frame. If its content is static, render it once (possibly "
+    "with XR_SWAPCHAIN_CREATE_STATIC_IMAGE_BIT) and keep submitting that image.";
+// Whether xrLocateSpaces (OpenXR 1.1) or xrLocateSpacesKHR can be used by the application.
+static bool g_locateSpacesAvailable = false;
+
+static int64_t SteadyTimeNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool SameQuadLayer(const XrCompositionLayerQuad &a, const XrCompositionLayerQuad &b) {
+    return a.layerFlags == b.layerFlags && a.space == b.space && a.eyeVisibility == b.eyeVisibility &&
+           a.subImage.swapchain == b.subImage.swapchain && a.subImage.imageRect.offset.x == b.subImage.imageRect.offset.x &&
+           a.subImage.imageRect.offset.y == b.subImage.imageRect.offset.y &&
+           a.subImage.imageRect.extent.width == b.subImage.imageRect.extent.width &&
+           a.subImage.imageRect.extent.height == b.subImage.imageRect.extent.height &&
+           a.subImage.imageArrayIndex == b.subImage.imageArrayIndex && a.pose.orientation.x == b.pose.orientation.x &&
+           a.pose.orientation.y == b.pose.orientation.y && a.pose.orientation.z == b.pose.orientation.z &&
+           a.pose.orientation.w == b.pose.orientation.w && a.pose.position.x == b.pose.position.x &&
+           a.pose.position.y == b.pose.position.y && a.pose.position.z == b.pose.position.z && a.size.width == b.size.width &&
+           a.size.height == b.size.height;
+}
 
 PFN_xrVoidFunction BestPracticesLayerInnerGetInstanceProcAddr(const char *name);
 
+// The frame in flight with the given index, or nullptr if another thread has retired it in the meantime.
+// Caller must hold state.frameMutex.
+static FrameState *FindFrameInFlight(SessionState &state, uint32_t frameIndex) {
+    for (auto it = state.framesInFlight.rbegin(); it != state.framesInFlight.rend(); ++it) {
+        if (it->frameIndex == frameIndex) {
+            return &*it;
+        }
+    }
+    return nullptr;
+}
+
 XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrWaitFrame(XrSession session, const XrFrameWaitInfo *frameWaitInfo,
                                                              XrFrameState *frameState) {
-    XrResult result = XR_SUCCESS;
+    SessionState *state = g_sessions.Find(session);
+    if (state == nullptr) {
+        return g_nextDispatch.Get<PFN_xrWaitFrame>(&XrGeneratedDispatchTable::WaitFrame)(session, frameWaitInfo, frameState);
+    }
+
+    uint32_t frameIndex = 0;
+    XrDuration waitOnRenderThreadPeriod = 0;
     {
-        std::unique_lock<std::mutex> frameLock(g_frameMutex);
+        std::unique_lock<std::mutex> frameLock(state->frameMutex);
 
         // Remove any invalid frames that were created just because xrWaitFrame failed and the application tried again immediately.
-        for (auto it = g_framesInFlight.begin(); it != g_framesInFlight.end();) {
+        for (auto it = state->framesInFlight.begin(); it != state->framesInFlight.end();) {
             if (it->waitFrameCalled && it->waitFrameResult != XR_SUCCESS && !it->beginFrameCalled) {
-                it = g_framesInFlight.erase(it);
+                it = state->framesInFlight.erase(it);
             } else {
                 ++it;
             }
         }
 
-        if (g_framesInFlight.size() > 0) {
-            FrameState &frontFrame = g_framesInFlight.front();
+        // Waiting on the thread that submitted the previous frame is normal; it is only reported below if the wait
+        // then blocks for longer than a display period, which means that frame was late.
+        if (state->lastEndFrameThread == std::this_thread::get_id()) {
+            waitOnRenderThreadPeriod = state->lastPredictedDisplayPeriod;
+        }
+
+        if (state->framesInFlight.size() > 0) {
+            FrameState &frontFrame = state->framesInFlight.front();
             // If the frame in front failed xrBeginFrame, we can assume it's on it's way to be an invalid frame. Reset
             // beginFrameCalled so it can be easily cleaned up in the next xrBeginFrame call.
             if (frontFrame.beginFrameCalled && frontFrame.beginFrameResult != XR_SUCCESS) {
                 frontFrame.beginFrameCalled = false;
             } else if (!frontFrame.beginFrameCalled) {
                 BPLogger::LogMessage(
+                    BP_MESSAGE_WAIT_FRAME_CALLED_TWICE,
                     "xrWaitFrame was called twice in a row, the last xrWaitFrame was not followed by a xrBeginFrame.");
             }
         }
@@ -120,75 +388,222 @@ XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrWaitFrame(XrSession session,
         newFrameState.beginFrameResult = XR_SUCCESS;
         newFrameState.endFrameResult = XR_SUCCESS;
 
-        newFrameState.frameIndex = ++g_frameIndex;
+        newFrameState.frameIndex = frameIndex = ++state->frameIndex;
 
-        g_framesInFlight.push_back(newFrameState);
+        state->framesInFlight.push_back(newFrameState);
     }
 
-    result = g_nextDispatch.Get<PFN_xrWaitFrame>(&XrGeneratedDispatchTable::WaitFrame)(session, frameWaitInfo, frameState);
+    // xrWaitFrame may block, so the session is not locked during the call.
+    const int64_t waitStartTime = SteadyTimeNs();
+    XrResult result =
+        g_nextDispatch.Get<PFN_xrWaitFrame>(&XrGeneratedDispatchTable::WaitFrame)(session, frameWaitInfo, frameState);
+    const int64_t waitReturnTime = SteadyTimeNs();
+    if (XR_SUCCEEDED(result) && waitOnRenderThreadPeriod > 0 && waitReturnTime - waitStartTime > waitOnRenderThreadPeriod) {
+        BPLogger::LogMessage(BP_MESSAGE_PERF_WAIT_FRAME_ON_RENDER_THREAD,
+                             "xrWaitFrame blocked for longer than a display period on the thread that submitted the previous "
+                             "frame, so that frame missed its display time. Consider calling xrWaitFrame from a separate "
+                             "thread so that simulation and rendering of consecutive frames overlap.");
+    }
     {
-        std::unique_lock<std::mutex> frameLock(g_frameMutex);
-
-        FrameState &currentFrameState = g_framesInFlight.back();
-        currentFrameState.waitFrameCalled = true;
-        currentFrameState.waitFrameResult = result;
-        currentFrameState.predictedDisplayTime = frameState->predictedDisplayTime;
-        currentFrameState.predictedDisplayPeriod = frameState->predictedDisplayPeriod;
+        std::unique_lock<std::mutex> frameLock(state->frameMutex);
+
+        // Another thread may have changed the queue in the meantime, find the frame again.
+        FrameState *frame = FindFrameInFlight(*state, frameIndex);
+        if (frame != nullptr) {
+            frame->waitFrameCalled = true;
+            frame->waitFrameResult = result;
+            frame->waitFrameReturnTime = waitReturnTime;
+            if (frameState != nullptr) {
+                frame->predictedDisplayTime = frameState->predictedDisplayTime;
+                frame->predictedDisplayPeriod = frameState->predictedDisplayPeriod;
+            }
+        }
     }
 
     return result;
 }
 
 XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrBeginFrame(XrSession session, const XrFrameBeginInfo *frameBeginInfo) {
-    XrResult result = XR_SUCCESS;
-    {
-        std::unique_lock<std::mutex> frameLock(g_frameMutex);
-
-        if (g_framesInFlight.empty()) {
-            BPLogger::LogMessage("There are no frames in queue. XrWaitFrame has not been called");
-        }
-
-        FrameState &currentFrameState = g_framesInFlight.front();
+    SessionState *state = g_sessions.Find(session);
+    if (state == nullptr) {
+        return g_nextDispatch.Get<PFN_xrBeginFrame>(&XrGeneratedDispatchTable::BeginFrame)(session, frameBeginInfo);
+    }
 
-        if (currentFrameState.beginFrameCalled) {
-            if (currentFrameState.beginFrameResult >= XR_SUCCESS) {
-                // Failure case where xrEndFrame from the last frame was not successful, but everything else was.
-                if (!currentFrameState.endFrameCalled || currentFrameState.endFrameResult != XR_SUCCESS) {
-                    BPLogger::LogMessage(
-                        "xrEndFrame was not successful for the previous frame. This xrBeginFrame is for a new frame.");
-                    g_framesInFlight.pop_front();
-                    if (g_framesInFlight.size() > 0) currentFrameState = g_framesInFlight.front();
+    // 0 when there is no frame in flight to begin.
+    uint32_t frameIndex = 0;
+    {
+        std::unique_lock<std::mutex> frameLock(state->frameMutex);
+        std::deque<FrameState> &framesInFlight = state->framesInFlight;
+
+        FrameState *currentFrameState = framesInFlight.empty() ? nullptr : &framesInFlight.front();
+        if (currentFrameState != nullptr) {
+            if (currentFrameState->beginFrameCalled) {
+                if (currentFrameState->beginFrameResult >= XR_SUCCESS) {
+                    // Failure case where xrEndFrame from the last frame was not successful, but everything else was.
+                    if (!currentFrameState->endFrameCalled || currentFrameState->endFrameResult != XR_SUCCESS) {
+                        BPLogger::LogMessage(
+                            BP_MESSAGE_BEGIN_FRAME_PREVIOUS_END_FRAME_FAILED,
+                            "xrEndFrame was not successful for the previous frame. This xrBeginFrame is for a new frame.");
+                        framesInFlight.pop_front();
+                        currentFrameState = framesInFlight.empty() ? nullptr : &framesInFlight.front();
+                    }
+                } else {
+                    // Application is retrying xrBeginFrame and frame state may still be valid if this call succeeds.
+                    BPLogger::LogMessage(BP_MESSAGE_BEGIN_FRAME_RETRIED,
+                                         "Application is retrying xrBeginFrame after a previous failure. Consider calling "
+                                         "xrWaitFrame to start a new frame instead");
                 }
             } else {
-                // Application is retrying xrBeginFrame and frame state may still be valid if this call succeeds.
-                BPLogger::LogMessage(
-                    "Application is retrying xrBeginFrame after a previous failure. Consider calling xrWaitFrame to start a new "
-                    "frame instead");
+                // beginFrameCalled being false but having a failure result means this frame was reset in xrWaitFrame for being
+                // invalid, remove it here.
+                if (currentFrameState->beginFrameResult != XR_SUCCESS) {
+                    framesInFlight.pop_front();
+                    currentFrameState = framesInFlight.empty() ? nullptr : &framesInFlight.front();
+                }
             }
+        }
+
+        if (currentFrameState == nullptr) {
+            BPLogger::LogMessage(BP_MESSAGE_BEGIN_FRAME_NO_FRAMES_IN_FLIGHT,
+                                 "There are no frames in queue. XrWaitFrame has not been called");
         } else {
-            // beginFrameCalled being false but having a failure result means this frame was reset in xrWaitFrame for being invalid,
-            // remove it here.
-            if (currentFrameState.beginFrameResult != XR_SUCCESS) {
-                g_framesInFlight.pop_front();
-                if (g_framesInFlight.size() > 0) currentFrameState = g_framesInFlight.front();
+            if (!currentFrameState->waitFrameCalled || currentFrameState->waitFrameResult != XR_SUCCESS) {
+                BPLogger::LogMessage(BP_MESSAGE_BEGIN_FRAME_WITHOUT_WAIT_FRAME, "XrWaitFrame was not called or failed",
+                                     currentFrameState->frameIndex);
+            } else if (currentFrameState->predictedDisplayPeriod > 0 &&
+                       SteadyTimeNs() - currentFrameState->waitFrameReturnTime > currentFrameState->predictedDisplayPeriod) {
+                BPLogger::LogMessage(BP_MESSAGE_PERF_LATE_BEGIN_FRAME,
+                                     "xrBeginFrame was called more than one predictedDisplayPeriod after xrWaitFrame returned, "
+                                     "leaving the frame little time to render. Start rendering as soon as xrWaitFrame returns.");
             }
+            frameIndex = currentFrameState->frameIndex;
         }
+    }
+
+    XrResult result = g_nextDispatch.Get<PFN_xrBeginFrame>(&XrGeneratedDispatchTable::BeginFrame)(session, frameBeginInfo);
 
-        if (!currentFrameState.waitFrameCalled || currentFrameState.waitFrameResult != XR_SUCCESS) {
-            BPLogger::LogMessage("XrWaitFrame was not called or failed for frame " + std::to_string(currentFrameState.frameIndex));
+    if (frameIndex != 0) {
+        std::unique_lock<std::mutex> frameLock(state->frameMutex);
+        FrameState *frame = FindFrameInFlight(*state, frameIndex);
+        if (frame != nullptr) {
+            frame->beginFrameResult = result;
+            frame->beginFrameCalled = true;
         }
+    }
 
-        result = g_nextDispatch.Get<PFN_xrBeginFrame>(&XrGeneratedDispatchTable::BeginFrame)(session, frameBeginInfo);
+    return result;
+}
 
-        currentFrameState.beginFrameResult = result;
-        currentFrameState.beginFrameCalled = true;
+// Report quad layers that are submitted exactly as in the previous frame, but whose swapchain image was rendered again.
+// Caller must hold state.frameMutex.
+static void CheckQuadLayers(SessionState &state, const XrFrameEndInfo *frameEndInfo) {
+    state.nextQuadLayers.clear();
+    for (uint32_t i = 0; i < frameEndInfo->layerCount; i++) {
+        const XrCompositionLayerBaseHeader *layer = frameEndInfo->layers[i];
+        if (layer == nullptr || layer->type != XR_TYPE_COMPOSITION_LAYER_QUAD) {
+            continue;
+        }
+        QuadLayerRecord record{};
+        record.layer = *reinterpret_cast<const XrCompositionLayerQuad *>(layer);
+        record.layer.next = nullptr;
+        auto releases = state.swapchainReleases.find(record.layer.subImage.swapchain);
+        record.releaseCount = releases == state.swapchainReleases.end() ? 0 : releases->second;
+
+        // Quad layers are matched with the previous frame by their order.
+        size_t quadIndex = state.nextQuadLayers.size();
+        if (quadIndex < state.quadLayers.size()) {
+            const QuadLayerRecord &previous = state.quadLayers[quadIndex];
+            if (SameQuadLayer(previous.layer, record.layer) && previous.releaseCount != record.releaseCount) {
+                record.rerenderedFrames = previous.rerenderedFrames + 1;
+                if (record.rerenderedFrames % kUnchangedQuadLayerFrames == 0) {
+                    BPLogger::LogMessage(BP_MESSAGE_PERF_UNCHANGED_QUAD_LAYER, kUnchangedQuadLayerMessage.c_str());
+                }
+            }
+        }
+        state.nextQuadLayers.push_back(record);
     }
+    std::swap(state.quadLayers, state.nextQuadLayers);
+}
 
-    return result;
+// The checks of xrEndFrame against the frame it ends and the frames before it.
+// Caller must hold state.frameMutex.
+static void CheckEndFrame(SessionState &state, const FrameState &currentFrameState, const XrFrameEndInfo *frameEndInfo) {
+    if (!currentFrameState.waitFrameCalled || currentFrameState.waitFrameResult != XR_SUCCESS) {
+        BPLogger::LogMessage(BP_MESSAGE_END_FRAME_WITHOUT_WAIT_FRAME,
+                             "xrWaitFrame was not called or failed before calling XrEndFrame", currentFrameState.frameIndex);
+    }
+
+    if (!currentFrameState.beginFrameCalled || currentFrameState.beginFrameResult != XR_SUCCESS) {
+        BPLogger::LogMessage(BP_MESSAGE_END_FRAME_WITHOUT_BEGIN_FRAME,
+                             "xrBeginFrame was not called or failed before calling XrEndFrame", currentFrameState.frameIndex);
+    }
+
+    if (currentFrameState.predictedDisplayTime != 0 && frameEndInfo->displayTime != currentFrameState.predictedDisplayTime) {
+        BPLogger::LogMessage(BP_MESSAGE_END_FRAME_DISPLAY_TIME_MISMATCH,
+                             "xrEndFrame was called with a different displayTime than what was obtained from xrWaitFrame.");
+    }
+
+    for (uint32_t i = 0; i < frameEndInfo->layerCount; i++) {
+        const XrCompositionLayerBaseHeader *layer = frameEndInfo->layers[i];
+        if (layer->type == XR_TYPE_COMPOSITION_LAYER_PROJECTION) {
+            const XrCompositionLayerProjection *projLayer = reinterpret_cast<const XrCompositionLayerProjection *>(layer);
+            for (uint32_t view = 0; view < projLayer->viewCount; view++) {
+                const XrCompositionLayerProjectionView &projView = projLayer->views[view];
+
+                if (projView.fov.angleLeft == 0.0f && projView.fov.angleRight == 0.0f && projView.fov.angleDown == 0.0f &&
+                    projView.fov.angleUp == 0.0f) {
+                    BPLogger::LogMessage(BP_MESSAGE_END_FRAME_ZERO_FOV, "xrEndFrame Projection Layer needs to have a non-zero FOV");
+                }
+
+                // Only the views located by xrLocateViews for this frame can be compared.
+                if (view >= currentFrameState.viewCount) {
+                    continue;
+                }
+                const XrView &locatedView = currentFrameState.views[view];
+
+                if (projView.fov.angleLeft != locatedView.fov.angleLeft || projView.fov.angleRight != locatedView.fov.angleRight ||
+                    projView.fov.angleDown != locatedView.fov.angleDown || projView.fov.angleUp != locatedView.fov.angleUp) {
+                    BPLogger::LogMessage(BP_MESSAGE_END_FRAME_FOV_MISMATCH,
+                                         "xrEndFrame Projection Layer has a different FOV from what was acquired in xrLocateViews");
+                }
+
+                if (projView.pose.position.x != locatedView.pose.position.x ||
+                    projView.pose.position.y != locatedView.pose.position.y ||
+                    projView.pose.position.z != locatedView.pose.position.z) {
+                    BPLogger::LogMessage(
+                        BP_MESSAGE_END_FRAME_POSITION_MISMATCH,
+                        "xrEndFrame Projection Layer has a different positional pose from what was acquired in xrLocateViews");
+                }
+
+                if (projView.pose.orientation.x != locatedView.pose.orientation.x ||
+                    projView.pose.orientation.y != locatedView.pose.orientation.y ||
+                    projView.pose.orientation.z != locatedView.pose.orientation.z ||
+                    projView.pose.orientation.w != locatedView.pose.orientation.w) {
+                    BPLogger::LogMessage(
+                        BP_MESSAGE_END_FRAME_ORIENTATION_MISMATCH,
+                        "xrEndFrame Projection Layer has a different rotational pose from what was acquired in xrLocateViews");
+                }
+            }
+        }
+    }
+
+    CheckQuadLayers(state, frameEndInfo);
+
+    if (g_locateSpacesAvailable && state.locateSpaceCalls > kLocateSpaceBatchThreshold) {
+        BPLogger::LogMessage(BP_MESSAGE_PERF_LOCATE_SPACE_NOT_BATCHED, kLocateSpaceNotBatchedMessage.c_str());
+    }
+    state.locateSpaceCalls = 0;
+    state.locateViewsCalls = 0;
+
+    // This is Scenario B in the xrEndFrame failure flow, if the app is retrying we warn that the frame should be discarded
+    // instead.
+    if (state.lastEndFramePDT != 0 && frameEndInfo->displayTime == state.lastEndFramePDT) {
+        BPLogger::LogMessage(BP_MESSAGE_END_FRAME_RETRIED,
+                             "xrEndFrame was retried with the same display time, consider discarding the frame instead.");
+    }
 }
 
 XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrEndFrame(XrSession session, const XrFrameEndInfo *frameEndInfo) {
-    XrResult result = XR_SUCCESS;
     if (frameEndInfo->environmentBlendMode == XR_ENVIRONMENT_BLEND_MODE_ALPHA_BLEND) {
         bool sourceAlphaSet = true;
         for (uint32_t i = 0; i < frameEndInfo->layerCount; i++) {
@@ -199,98 +614,88 @@ XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrEndFrame(XrSession session, c
         }
         if (!sourceAlphaSet) {
             BPLogger::LogMessage(
+                BP_MESSAGE_END_FRAME_ALPHA_BLEND_WITHOUT_SOURCE_ALPHA,
                 "Environment Blend Mode was set to XR_ENVIRONMENT_BLEND_MODE_ALPHA_BLEND but no layer has "
                 "XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT set. Either add "
                 "XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT or do not use XR_ENVIRONMENT_BLEND_MODE_ALPHA_BLEND.");
         }
     }
 
-    {
-        std::unique_lock<std::mutex> frameLock(g_frameMutex);
-        FrameState &currentFrameState = g_framesInFlight.front();
-
-        if (!currentFrameState.waitFrameCalled || currentFrameState.waitFrameResult != XR_SUCCESS) {
-            BPLogger::LogMessage("xrWaitFrame was not called or failed before calling XrEndFrame for frame " +
-                                 std::to_string(currentFrameState.frameIndex));
-        }
-
-        if (!currentFrameState.beginFrameCalled || currentFrameState.beginFrameResult != XR_SUCCESS) {
-            BPLogger::LogMessage("xrBeginFrame was not called or failed before calling XrEndFrame for frame " +
-                                 std::to_string(currentFrameState.frameIndex));
-        }
-
-        if (currentFrameState.predictedDisplayTime != 0 && frameEndInfo->displayTime != currentFrameState.predictedDisplayTime) {
-            BPLogger::LogMessage("xrEndFrame was called with a different displayTime than what was obtained from xrWaitFrame.");
-        }
-
-        for (uint32_t i = 0; i < frameEndInfo->layerCount; i++) {
-            const XrCompositionLayerBaseHeader *layer = frameEndInfo->layers[i];
-            if (layer->type == XR_TYPE_COMPOSITION_LAYER_PROJECTION) {
-                const XrCompositionLayerProjection *projLayer = reinterpret_cast<const XrCompositionLayerProjection *>(layer);
-                for (uint32_t view = 0; view < projLayer->viewCount; view++) {
-                    if (projLayer->views[view].fov.angleLeft != currentFrameState.views[view].fov.angleLeft ||
-                        projLayer->views[view].fov.angleRight != currentFrameState.views[view].fov.angleRight ||
-                        projLayer->views[view].fov.angleDown != currentFrameState.views[view].fov.angleDown ||
-                        projLayer->views[view].fov.angleUp != currentFrameState.views[view].fov.angleUp) {
-                        BPLogger::LogMessage(
-                            "xrEndFrame Projection Layer has a different FOV from what was acquired in xrLocateViews");
-                    }
-
-                    if (projLayer->views[view].fov.angleLeft == 0.0f && projLayer->views[view].fov.angleRight == 0.0f &&
-                        projLayer->views[view].fov.angleDown == 0.0f && projLayer->views[view].fov.angleUp == 0.0f) {
-                        BPLogger::LogMessage("xrEndFrame Projection Layer needs to have a non-zero FOV");
-                    }
-
-                    if (projLayer->views[view].pose.position.x != currentFrameState.views[view].pose.position.x ||
-                        projLayer->views[view].pose.position.y != currentFrameState.views[view].pose.position.y ||
-                        projLayer->views[view].pose.position.z != currentFrameState.views[view].pose.position.z) {
-                        BPLogger::LogMessage(
-                            "xrEndFrame Projection Layer has a different positional pose from what was acquired in xrLocateViews");
-                    }
+    SessionState *state = g_sessions.Find(session);
+    if (state == nullptr) {
+        return g_nextDispatch.Get<PFN_xrEndFrame>(&XrGeneratedDispatchTable::EndFrame)(session, frameEndInfo);
+    }
 
-                    if (projLayer->views[view].pose.orientation.x != currentFrameState.views[view].pose.orientation.x ||
-                        projLayer->views[view].pose.orientation.y != currentFrameState.views[view].pose.orientation.y ||
-                        projLayer->views[view].pose.orientation.z != currentFrameState.views[view].pose.orientation.z ||
-                        projLayer->views[view].pose.orientation.w != currentFrameState.views[view].pose.orientation.w) {
-                        BPLogger::LogMessage(
-                            "xrEndFrame Projection Layer has a different rotational pose from what was acquired in xrLocateViews");
-                    }
-                }
-            }
+    // 0 when there is no frame in flight to end.
+    uint32_t frameIndex = 0;
+    XrDuration predictedDisplayPeriod = 0;
+    {
+        std::unique_lock<std::mutex> frameLock(state->frameMutex);
+        if (state->framesInFlight.empty()) {
+            BPLogger::LogMessage(BP_MESSAGE_END_FRAME_WITHOUT_WAIT_FRAME,
+                                 "xrWaitFrame was not called or failed before calling XrEndFrame", state->frameIndex + 1);
+        } else {
+            const FrameState &currentFrameState = state->framesInFlight.front();
+            frameIndex = currentFrameState.frameIndex;
+            predictedDisplayPeriod = currentFrameState.predictedDisplayPeriod;
+            CheckEndFrame(*state, currentFrameState, frameEndInfo);
         }
+    }
 
-        result = g_nextDispatch.Get<PFN_xrEndFrame>(&XrGeneratedDispatchTable::EndFrame)(session, frameEndInfo);
+    XrResult result = g_nextDispatch.Get<PFN_xrEndFrame>(&XrGeneratedDispatchTable::EndFrame)(session, frameEndInfo);
+    if (frameIndex == 0) {
+        return result;
+    }
 
-        // If we get to this point, xrWaitFrame, xrBeginFrame, and xrEndFrame were all successful so we can retire this frame data.
+    // If we get to this point, xrWaitFrame, xrBeginFrame, and xrEndFrame were all successful so we can retire this frame data.
+    bool writeSummary = false;
+    {
+        std::unique_lock<std::mutex> frameLock(state->frameMutex);
         if (result >= XR_SUCCESS) {
-            g_framesInFlight.pop_front();
+            state->lastEndFrameThread = std::this_thread::get_id();
+            state->lastEndFrameTime = SteadyTimeNs();
+            state->lastPredictedDisplayPeriod = predictedDisplayPeriod;
+            writeSummary = g_summaryInterval != 0 && ++state->framesEnded % g_summaryInterval == 0;
+
+            auto frame = std::find_if(state->framesInFlight.begin(), state->framesInFlight.end(),
+                                      [frameIndex](const FrameState &inFlight) { return inFlight.frameIndex == frameIndex; });
+            if (frame != state->framesInFlight.end()) {
+                state->framesInFlight.erase(frame);
+            }
+            state->lastEndFramePDT = 0;
         } else {
-            currentFrameState.endFrameResult = result;
-            g_lastEndFramePDT = frameEndInfo->displayTime;
+            FrameState *frame = FindFrameInFlight(*state, frameIndex);
+            if (frame != nullptr) {
+                frame->endFrameCalled = true;
+                frame->endFrameResult = result;
+            }
+            state->lastEndFramePDT = frameEndInfo->displayTime;
         }
+    }
 
-        // This is Scenario B in the xrEndFrame failure flow, if the app is retrying we warn that the frame should be discarded
-        // instead.
-        if (frameEndInfo->displayTime == g_lastEndFramePDT) {
-            BPLogger::LogMessage("xrEndFrame was retried with the same display time, consider discarding the frame instead.");
-        }
+    if (writeSummary) {
+        BPLogger::WriteSummary("Best practices messages in the last " + std::to_string(g_summaryInterval) + " frames:");
     }
 
     return result;
 }
 
 XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrSyncActions(XrSession session, const XrActionsSyncInfo *syncInfo) {
-    XrResult result = XR_SUCCESS;
+    SessionState *state = g_sessions.Find(session);
+    if (state == nullptr) {
+        return g_nextDispatch.Get<PFN_xrSyncActions>(&XrGeneratedDispatchTable::SyncActions)(session, syncInfo);
+    }
+
     {
+        std::unique_lock<std::mutex> frameLock(state->frameMutex);
         bool syncCalledBeforeWait = false;
-        std::unique_lock<std::mutex> frameLock(g_frameMutex);
 
-        if (g_framesInFlight.empty()) {
+        if (state->framesInFlight.empty()) {
             // If there are no frames in flight, xrSyncActions was called outside the frame loop which is probably before
             // xrWaitFrame.
             syncCalledBeforeWait = true;
         } else {
-            FrameState &currentFrameState = g_framesInFlight.front();
+            FrameState &currentFrameState = state->framesInFlight.front();
             // In a pipelined system, if we begin frame N but get a call to XrSyncActions after the fact, it's probably for frame
             // N+1 which hasn't even had xrWaitFrame called which is too early.
             if (currentFrameState.waitFrameCalled && currentFrameState.waitFrameResult >= XR_SUCCESS &&
@@ -300,24 +705,25 @@ XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrSyncActions(XrSession session
 
             if (currentFrameState.syncActionsSucceeded) {
                 BPLogger::LogMessage(
+                    BP_MESSAGE_SYNC_ACTIONS_CALLED_TWICE,
                     "xrSyncActions was called multiple times in the frame. It's best practice to avoid unnecessary extra calls.");
             }
         }
 
         if (syncCalledBeforeWait) {
-            BPLogger::LogMessage(
-                "xrSyncActions was called between xrBeginFrame and xrEndFrame. If this is before next frame's xrWaitFrame, "
-                "consider doing it after.");
+            BPLogger::LogMessage(BP_MESSAGE_SYNC_ACTIONS_INSIDE_FRAME,
+                                 "xrSyncActions was called between xrBeginFrame and xrEndFrame. If this is before next frame's "
+                                 "xrWaitFrame, consider doing it after.");
         }
     }
 
-    result = g_nextDispatch.Get<PFN_xrSyncActions>(&XrGeneratedDispatchTable::SyncActions)(session, syncInfo);
+    XrResult result = g_nextDispatch.Get<PFN_xrSyncActions>(&XrGeneratedDispatchTable::SyncActions)(session, syncInfo);
 
-    {
-        std::unique_lock<std::mutex> frameLock(g_frameMutex);
-        if (result == XR_SUCCESS && !g_framesInFlight.empty()) {
-            FrameState &currentFrameState = g_framesInFlight.front();
-            currentFrameState.syncActionsSucceeded = true;
+    if (result == XR_SUCCESS) {
+        std::unique_lock<std::mutex> frameLock(state->frameMutex);
+        state->actionStatesQueried.clear();
+        if (!state->framesInFlight.empty()) {
+            state->framesInFlight.front().syncActionsSucceeded = true;
         }
     }
     return result;
@@ -325,71 +731,223 @@ XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrSyncActions(XrSession session
 
 XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrLocateSpace(XrSpace space, XrSpace baseSpace, XrTime time,
                                                                XrSpaceLocation *location) {
-    XrResult result = XR_SUCCESS;
-    {
+    // Spaces created by extension functions are not tracked and are not checked.
+    SessionState *state = g_sessions.FindBySpace(space);
+    if (state != nullptr) {
         bool locateCalledBeforeWait = false;
-        std::unique_lock<std::mutex> frameLock(g_frameMutex);
-
-        if (g_framesInFlight.empty()) {
-            // If there are no frames in flight, xrSyncActions was called outside the frame loop which is probably before
+        {
+            std::unique_lock<std::mutex> frameLock(state->frameMutex);
+            // If there are no frames in flight, xrLocateSpace was called outside the frame loop which is probably before
             // xrWaitFrame.
-            locateCalledBeforeWait = true;
-        } else {
-            FrameState &currentFrameState = g_framesInFlight.front();
-            if (!currentFrameState.waitFrameCalled) {
-                locateCalledBeforeWait = true;
-            }
+            locateCalledBeforeWait = state->framesInFlight.empty() || !state->framesInFlight.front().waitFrameCalled;
+            ++state->locateSpaceCalls;
         }
 
         if (locateCalledBeforeWait) {
-            BPLogger::LogMessage(
-                "xrLocateSpace was called before xrWaitFrame. It's best practice to call xrLocateSpace after xrWaitFrame to have "
-                "more accurate tracking data.");
+            BPLogger::LogMessage(BP_MESSAGE_LOCATE_SPACE_BEFORE_WAIT_FRAME,
+                                 "xrLocateSpace was called before xrWaitFrame. It's best practice to call xrLocateSpace after "
+                                 "xrWaitFrame to have more accurate tracking data.");
         }
     }
 
-    result = g_nextDispatch.Get<PFN_xrLocateSpace>(&XrGeneratedDispatchTable::LocateSpace)(space, baseSpace, time, location);
-
-    return result;
+    return g_nextDispatch.Get<PFN_xrLocateSpace>(&XrGeneratedDispatchTable::LocateSpace)(space, baseSpace, time, location);
 }
 
 XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrLocateViews(XrSession session, const XrViewLocateInfo *viewLocateInfo,
                                                                XrViewState *viewState, uint32_t viewCapacityInput,
                                                                uint32_t *viewCountOutput, XrView *views) {
-    XrResult result = XR_SUCCESS;
+    SessionState *state = g_sessions.Find(session);
+    if (state == nullptr) {
+        return g_nextDispatch.Get<PFN_xrLocateViews>(&XrGeneratedDispatchTable::LocateViews)(
+            session, viewLocateInfo, viewState, viewCapacityInput, viewCountOutput, views);
+    }
+
+    // 0 when there is no frame in flight to locate the views for.
+    uint32_t frameIndex = 0;
     {
-        std::unique_lock<std::mutex> frameLock(g_frameMutex);
-        if (!g_framesInFlight.empty()) {
-            FrameState &currentFrameState = g_framesInFlight.front();
+        std::unique_lock<std::mutex> frameLock(state->frameMutex);
+        if (++state->locateViewsCalls == 2) {
+            BPLogger::LogMessage(BP_MESSAGE_PERF_LOCATE_VIEWS_REPEATED,
+                                 "xrLocateViews was called more than once in a frame. Locate the views once per frame and reuse "
+                                 "the result.");
+        }
+        if (!state->framesInFlight.empty()) {
+            FrameState &currentFrameState = state->framesInFlight.front();
             if (currentFrameState.predictedDisplayTime != 0 &&
                 viewLocateInfo->displayTime != currentFrameState.predictedDisplayTime) {
                 BPLogger::LogMessage(
+                    BP_MESSAGE_LOCATE_VIEWS_DISPLAY_TIME_MISMATCH,
                     "xrLocateViews was called with a different displayTime than what was obtained from xrWaitFrame.");
             }
+            frameIndex = currentFrameState.frameIndex;
         }
     }
 
-    result = g_nextDispatch.Get<PFN_xrLocateViews>(&XrGeneratedDispatchTable::LocateViews)(
+    XrResult result = g_nextDispatch.Get<PFN_xrLocateViews>(&XrGeneratedDispatchTable::LocateViews)(
         session, viewLocateInfo, viewState, viewCapacityInput, viewCountOutput, views);
 
-    {
-        std::unique_lock<std::mutex> frameLock(g_frameMutex);
-        if (!g_framesInFlight.empty()) {
-            if (viewCapacityInput != 0) {
-                FrameState &currentFrameState = g_framesInFlight.front();
-                for (uint32_t i = 0; i < viewCapacityInput; i++) {
-                    currentFrameState.views[i] = views[i];
+    if (frameIndex != 0) {
+        if (result >= XR_SUCCESS && viewCapacityInput != 0 && views != nullptr) {
+            std::unique_lock<std::mutex> frameLock(state->frameMutex);
+            FrameState *frame = FindFrameInFlight(*state, frameIndex);
+            if (frame != nullptr) {
+                const uint32_t maxViews = static_cast<uint32_t>(sizeof(frame->views) / sizeof(frame->views[0]));
+                frame->viewCount = std::min(std::min(viewCapacityInput, *viewCountOutput), maxViews);
+                for (uint32_t i = 0; i < frame->viewCount; i++) {
+                    frame->views[i] = views[i];
                 }
             }
-        } else {
-            BPLogger::LogMessage(
-                "xrLocateViews was called before xrWaitFrame with no frames in flight. Consider making the call between "
-                "xrBeginFrame and xrEndFrame.");
         }
+    } else {
+        BPLogger::LogMessage(BP_MESSAGE_LOCATE_VIEWS_BEFORE_WAIT_FRAME,
+                             "xrLocateViews was called before xrWaitFrame with no frames in flight. Consider making the call "
+                             "between xrBeginFrame and xrEndFrame.");
+    }
+    return result;
+}
+
+// Report an action state that was already queried since the last xrSyncActions; it cannot have changed.
+static void CheckActionStateQuery(XrSession session, const XrActionStateGetInfo *getInfo) {
+    SessionState *state = g_sessions.Find(session);
+    if (state == nullptr || getInfo == nullptr) {
+        return;
+    }
+    std::unique_lock<std::mutex> frameLock(state->frameMutex);
+    const std::pair<XrAction, XrPath> query{getInfo->action, getInfo->subactionPath};
+    if (std::find(state->actionStatesQueried.begin(), state->actionStatesQueried.end(), query) !=
+        state->actionStatesQueried.end()) {
+        BPLogger::LogMessage(BP_MESSAGE_PERF_REPEATED_ACTION_STATE,
+                             "The state of an action was queried more than once between two xrSyncActions calls. It only "
+                             "changes on xrSyncActions, query it once and reuse the result.");
+    } else {
+        state->actionStatesQueried.push_back(query);
+    }
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrGetActionStateBoolean(XrSession session, const XrActionStateGetInfo *getInfo,
+                                                                         XrActionStateBoolean *actionState) {
+    CheckActionStateQuery(session, getInfo);
+    return g_nextDispatch.Get<PFN_xrGetActionStateBoolean>(&XrGeneratedDispatchTable::GetActionStateBoolean)(session, getInfo,
+                                                                                                             actionState);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrGetActionStateFloat(XrSession session, const XrActionStateGetInfo *getInfo,
+                                                                       XrActionStateFloat *actionState) {
+    CheckActionStateQuery(session, getInfo);
+    return g_nextDispatch.Get<PFN_xrGetActionStateFloat>(&XrGeneratedDispatchTable::GetActionStateFloat)(session, getInfo,
+                                                                                                         actionState);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrGetActionStateVector2f(XrSession session, const XrActionStateGetInfo *getInfo,
+                                                                          XrActionStateVector2f *actionState) {
+    CheckActionStateQuery(session, getInfo);
+    return g_nextDispatch.Get<PFN_xrGetActionStateVector2f>(&XrGeneratedDispatchTable::GetActionStateVector2f)(
+        session, getInfo, actionState);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrGetActionStatePose(XrSession session, const XrActionStateGetInfo *getInfo,
+                                                                      XrActionStatePose *actionState) {
+    CheckActionStateQuery(session, getInfo);
+    return g_nextDispatch.Get<PFN_xrGetActionStatePose>(&XrGeneratedDispatchTable::GetActionStatePose)(session, getInfo,
+                                                                                                       actionState);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrCreateSwapchain(XrSession session, const XrSwapchainCreateInfo *createInfo,
+                                                                   XrSwapchain *swapchain) {
+    XrResult result =
+        g_nextDispatch.Get<PFN_xrCreateSwapchain>(&XrGeneratedDispatchTable::CreateSwapchain)(session, createInfo, swapchain);
+    if (XR_SUCCEEDED(result)) {
+        g_sessions.AddSwapchain(*swapchain, session);
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrDestroySwapchain(XrSwapchain swapchain) {
+    SessionState *state = g_sessions.FindBySwapchain(swapchain);
+    XrResult result = g_nextDispatch.Get<PFN_xrDestroySwapchain>(&XrGeneratedDispatchTable::DestroySwapchain)(swapchain);
+    if (XR_SUCCEEDED(result) && state != nullptr) {
+        {
+            std::unique_lock<std::mutex> frameLock(state->frameMutex);
+            state->swapchainReleases.erase(swapchain);
+        }
+        g_sessions.RemoveSwapchain(swapchain);
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrReleaseSwapchainImage(XrSwapchain swapchain,
+                                                                         const XrSwapchainImageReleaseInfo *releaseInfo) {
+    XrResult result =
+        g_nextDispatch.Get<PFN_xrReleaseSwapchainImage>(&XrGeneratedDispatchTable::ReleaseSwapchainImage)(swapchain, releaseInfo);
+    if (XR_SUCCEEDED(result)) {
+        SessionState *state = g_sessions.FindBySwapchain(swapchain);
+        if (state != nullptr) {
+            std::unique_lock<std::mutex> frameLock(state->frameMutex);
+            ++state->swapchainReleases[swapchain];
+        }
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrCreateSession(XrInstance instance, const XrSessionCreateInfo *createInfo,
+                                                                 XrSession *session) {
+    XrResult result =
+        g_nextDispatch.Get<PFN_xrCreateSession>(&XrGeneratedDispatchTable::CreateSession)(instance, createInfo, session);
+    if (XR_SUCCEEDED(result)) {
+        g_sessions.AddSession(*session);
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrDestroySession(XrSession session) {
+    XrResult result = g_nextDispatch.Get<PFN_xrDestroySession>(&XrGeneratedDispatchTable::DestroySession)(session);
+    if (XR_SUCCEEDED(result)) {
+        g_sessions.RemoveSession(session);
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrCreateReferenceSpace(XrSession session,
+                                                                        const XrReferenceSpaceCreateInfo *createInfo,
+                                                                        XrSpace *space) {
+    XrResult result = g_nextDispatch.Get<PFN_xrCreateReferenceSpace>(&XrGeneratedDispatchTable::CreateReferenceSpace)(
+        session, createInfo, space);
+    if (XR_SUCCEEDED(result)) {
+        g_sessions.AddSpace(*space, session);
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrCreateActionSpace(XrSession session, const XrActionSpaceCreateInfo *createInfo,
+                                                                     XrSpace *space) {
+    XrResult result =
+        g_nextDispatch.Get<PFN_xrCreateActionSpace>(&XrGeneratedDispatchTable::CreateActionSpace)(session, createInfo, space);
+    if (XR_SUCCEEDED(result)) {
+        g_sessions.AddSpace(*space, session);
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrDestroySpace(XrSpace space) {
+    XrResult result = g_nextDispatch.Get<PFN_xrDestroySpace>(&XrGeneratedDispatchTable::DestroySpace)(space);
+    if (XR_SUCCEEDED(result)) {
+        g_sessions.RemoveSpace(space);
     }
     return result;
 }
 
+XRAPI_ATTR XrResult XRAPI_CALL BestPracticesLayerXrDestroyInstance(XrInstance instance) {
+    XrResult result = g_nextDispatch.Get<PFN_xrDestroyInstance>(&XrGeneratedDispatchTable::DestroyInstance)(instance);
+
+    BPLogger::WriteSummary("Best practices messages since the last summary:");
+
+    // Nothing else may be running on this instance any more, so the session state and old tables can go.
+    g_sessions.Clear();
+    g_nextDispatch.Reset();
+
+    return result;
+}
+
 XRAPI_ATTR XrResult XRAPI_CALL BestPracticesValidationLayerXrGetInstanceProcAddr(XrInstance instance, const char *name,
                                                                                  PFN_xrVoidFunction *function) {
     try {
@@ -450,8 +1008,37 @@ XRAPI_ATTR XrResult XRAPI_CALL BestPracticesXrCreateApiLayerInstance(const XrIns
 
         g_nextDispatch.Reset(std::move(next_dispatch));
 
-        g_frameIndex = 0;
-        g_lastEndFramePDT = 0;
+        PFN_xrGetLayerHandleDataTableLOADER get_handle_data_table = nullptr;
+        XrLayerHandleDataTable *handle_data_table = nullptr;
+        uint32_t handle_data_slot = 0;
+        if (XR_SUCCEEDED(next_result) &&
+            XR_SUCCEEDED(next_get_instance_proc_addr(returned_instance, XR_LOADER_LAYER_HANDLE_DATA_FUNCTION_NAME,
+                                                     reinterpret_cast<PFN_xrVoidFunction *>(&get_handle_data_table))) &&
+            nullptr != get_handle_data_table && XR_SUCCEEDED(get_handle_data_table(returned_instance, &handle_data_table)) &&
+            XrLayerHandleDataTableIsCompatible(handle_data_table) &&
+            XR_SUCCEEDED(handle_data_table->acquire_slot("XR_APILAYER_KHRONOS_best_practices_validation", &handle_data_slot))) {
+            g_sessions.UseHandleDataTable(handle_data_table, handle_data_slot);
+        }
+
+        g_locateSpacesAvailable = XR_VERSION_MAJOR(info->applicationInfo.apiVersion) > 1 ||
+                                  XR_VERSION_MINOR(info->applicationInfo.apiVersion) >= 1;
+        for (uint32_t i = 0; i < info->enabledExtensionCount; ++i) {
+            if (0 == strcmp(info->enabledExtensionNames[i], XR_KHR_LOCATE_SPACES_EXTENSION_NAME)) {
+                g_locateSpacesAvailable = true;
+            }
+        }
+
+#if !defined(ANDROID)
+        std::string summaryInterval = PlatformUtilsGetEnv("XR_BEST_PRACTICES_SUMMARY_INTERVAL");
+        std::string fileName = PlatformUtilsGetEnv("XR_BEST_PRACTICES_FILE_NAME");
+#else
+        // adb shell "setprop debug.best_practices_summary_interval 0"
+        std::string summaryInterval = PlatformUtilsGetAndroidSystemProperty("debug.best_practices_summary_interval");
+        std::string fileName = PlatformUtilsGetAndroidSystemProperty("debug.best_practices_file_name");
+#endif
+        g_summaryInterval = summaryInterval.empty() ? kDefaultSummaryInterval
+                                                    : static_cast<uint32_t>(strtoul(summaryInterval.c_str(), nullptr, 10));
+        BPLogger::SetOutputFile(fileName);
 
         return next_result;
 
@@ -521,5 +1108,44 @@ PFN_xrVoidFunction BestPracticesLayerInnerGetInstanceProcAddr(const char *name)
     if (func_name == "xrLocateViews") {
         return reinterpret_cast<PFN_xrVoidFunction>(BestPracticesLayerXrLocateViews);
     }
+    if (func_name == "xrGetActionStateBoolean") {
+        return reinterpret_cast<PFN_xrVoidFunction>(BestPracticesLayerXrGetActionStateBoolean);
+    }
+    if (func_name == "xrGetActionStateFloat") {
+        return reinterpret_cast<PFN_xrVoidFunction>(BestPracticesLayerXrGetActionStateFloat);
+    }
+    if (func_name == "xrGetActionStateVector2f") {
+        return reinterpret_cast<PFN_xrVoidFunction>(BestPracticesLayerXrGetActionStateVector2f);
+    }
+    if (func_name == "xrGetActionStatePose") {
+        return reinterpret_cast<PFN_xrVoidFunction>(BestPracticesLayerXrGetActionStatePose);
+    }
+    if (func_name == "xrCreateSwapchain") {
+        return reinterpret_cast<PFN_xrVoidFunction>(BestPracticesLayerXrCreateSwapchain);
+    }
+    if (func_name == "xrDestroySwapchain") {
+        return reinterpret_cast<PFN_xrVoidFunction>(BestPracticesLayerXrDestroySwapchain);
+    }
+    if (func_name == "xrReleaseSwapchainImage") {
+        return reinterpret_cast<PFN_xrVoidFunction>(BestPracticesLayerXrReleaseSwapchainImage);
+    }
+    if (func_name == "xrCreateSession") {
+        return reinterpret_cast<PFN_xrVoidFunction>(BestPracticesLayerXrCreateSession);
+    }
+    if (func_name == "xrDestroySession") {
+        return reinterpret_cast<PFN_xrVoidFunction>(BestPracticesLayerXrDestroySession);
+    }
+    if (func_name == "xrCreateReferenceSpace") {
+        return reinterpret_cast<PFN_xrVoidFunction>(BestPracticesLayerXrCreateReferenceSpace);
+    }
+    if (func_name == "xrCreateActionSpace") {
+        return reinterpret_cast<PFN_xrVoidFunction>(BestPracticesLayerXrCreateActionSpace);
+    }
+    if (func_name == "xrDestroySpace") {
+        return reinterpret_cast<PFN_xrVoidFunction>(BestPracticesLayerXrDestroySpace);
+    }
+    if (func_name == "xrDestroyInstance") {
+        return reinterpret_cast<PFN_xrVoidFunction>(BestPracticesLayerXrDestroyInstance);
+    }
     return nullptr;
 }
@@ -5,7 +5,121 @@
 
 #include "layer_utils.h"
 
-void LockedDispatchTable::Reset(std::unique_ptr<XrGeneratedDispatchTable> &&newTable) {
-    std::unique_lock<std::mutex> lock{m_mutex};
-    m_dispatch = std::move(newTable);
+#include <fstream>
+
+void AtomicDispatchTable::Reset(std::unique_ptr<XrGeneratedDispatchTable> &&newTable) {
+    std::unique_lock<std::mutex> lock{m_tableMutex};
+    std::unique_ptr<XrGeneratedDispatchTable> retired = std::move(m_table);
+    m_table = std::move(newTable);
+    m_dispatch.store(m_table.get(), std::memory_order_seq_cst);
+
+    // A reader that loads the retired table was counted before the store above, so under the epoch that ends here.
+    // Readers that start after the flip are counted under the new epoch, so each shard's count for the old one only
+    // drains, and is seen at zero once its last such reader is done.
+    if (retired) {
+        const uint32_t previousEpoch = m_epoch.fetch_add(1, std::memory_order_seq_cst) & 1;
+        for (ReaderShard &shard : m_readers) {
+            while (shard.count[previousEpoch].load(std::memory_order_acquire) != 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
+
+const char *BPMessageName(BPMessageId id) {
+    switch (id) {
+        case BP_MESSAGE_WAIT_FRAME_CALLED_TWICE:
+            return "BestPractices-WaitFrame-CalledTwice";
+        case BP_MESSAGE_BEGIN_FRAME_NO_FRAMES_IN_FLIGHT:
+            return "BestPractices-BeginFrame-NoFramesInFlight";
+        case BP_MESSAGE_BEGIN_FRAME_PREVIOUS_END_FRAME_FAILED:
+            return "BestPractices-BeginFrame-PreviousEndFrameFailed";
+        case BP_MESSAGE_BEGIN_FRAME_RETRIED:
+            return "BestPractices-BeginFrame-Retried";
+        case BP_MESSAGE_BEGIN_FRAME_WITHOUT_WAIT_FRAME:
+            return "BestPractices-BeginFrame-WithoutWaitFrame";
+        case BP_MESSAGE_END_FRAME_ALPHA_BLEND_WITHOUT_SOURCE_ALPHA:
+            return "BestPractices-EndFrame-AlphaBlendWithoutSourceAlpha";
+        case BP_MESSAGE_END_FRAME_WITHOUT_WAIT_FRAME:
+            return "BestPractices-EndFrame-WithoutWaitFrame";
+        case BP_MESSAGE_END_FRAME_WITHOUT_BEGIN_FRAME:
+            return "BestPractices-EndFrame-WithoutBeginFrame";
+        case BP_MESSAGE_END_FRAME_DISPLAY_TIME_MISMATCH:
+            return "BestPractices-EndFrame-DisplayTimeMismatch";
+        case BP_MESSAGE_END_FRAME_FOV_MISMATCH:
+            return "BestPractices-EndFrame-FovMismatch";
+        case BP_MESSAGE_END_FRAME_ZERO_FOV:
+            return "BestPractices-EndFrame-ZeroFov";
+        case BP_MESSAGE_END_FRAME_POSITION_MISMATCH:
+            return "BestPractices-EndFrame-PositionMismatch";
+        case BP_MESSAGE_END_FRAME_ORIENTATION_MISMATCH:
+            return "BestPractices-EndFrame-OrientationMismatch";
+        case BP_MESSAGE_END_FRAME_RETRIED:
+            return "BestPractices-EndFrame-Retried";
+        case BP_MESSAGE_SYNC_ACTIONS_CALLED_TWICE:
+            return "BestPractices-SyncActions-CalledTwice";
+        case BP_MESSAGE_SYNC_ACTIONS_INSIDE_FRAME:
+            return "BestPractices-SyncActions-InsideFrame";
+        case BP_MESSAGE_LOCATE_SPACE_BEFORE_WAIT_FRAME:
+            return "BestPractices-LocateSpace-BeforeWaitFrame";
+        case BP_MESSAGE_LOCATE_VIEWS_DISPLAY_TIME_MISMATCH:
+            return "BestPractices-LocateViews-DisplayTimeMismatch";
+        case BP_MESSAGE_LOCATE_VIEWS_BEFORE_WAIT_FRAME:
+            return "BestPractices-LocateViews-BeforeWaitFrame";
+        case BP_MESSAGE_PERF_LATE_BEGIN_FRAME:
+            return "BestPractices-Perf-LateBeginFrame";
+        case BP_MESSAGE_PERF_WAIT_FRAME_ON_RENDER_THREAD:
+            return "BestPractices-Perf-WaitFrameOnRenderThread";
+        case BP_MESSAGE_PERF_LOCATE_SPACE_NOT_BATCHED:
+            return "BestPractices-Perf-LocateSpaceNotBatched";
+        case BP_MESSAGE_PERF_REPEATED_ACTION_STATE:
+            return "BestPractices-Perf-RepeatedActionState";
+        case BP_MESSAGE_PERF_LOCATE_VIEWS_REPEATED:
+            return "BestPractices-Perf-LocateViewsRepeated";
+        case BP_MESSAGE_PERF_UNCHANGED_QUAD_LAYER:
+            return "BestPractices-Perf-UnchangedQuadLayer";
+        case BP_MESSAGE_COUNT:
+            break;
+    }
+    return "BestPractices-Unknown";
+}
+
+std::atomic<uint32_t> BPLogger::messageCounts[BP_MESSAGE_COUNT];
+std::atomic<uint32_t> BPLogger::summaryCounts[BP_MESSAGE_COUNT];
+std::atomic<bool> BPLogger::fileOpen{false};
+
+// The output file set with BPLogger::SetOutputFile, and the lock serializing the lines written to it.
+static std::mutex g_outputFileMutex;
+static std::ofstream g_outputFile;
+
+void BPLogger::SetOutputFile(const std::string &fileName) {
+    std::unique_lock<std::mutex> lock(g_outputFileMutex);
+    fileOpen.store(false, std::memory_order_release);
+    if (g_outputFile.is_open()) {
+        g_outputFile.close();
+    }
+    if (!fileName.empty()) {
+        g_outputFile.open(fileName, std::ios::out | std::ios::app);
+        fileOpen.store(g_outputFile.is_open(), std::memory_order_release);
+    }
+}
+
+void BPLogger::WriteToFile(const std::string &message) {
+    std::unique_lock<std::mutex> lock(g_outputFileMutex);
+    if (g_outputFile.is_open()) {
+        g_outputFile << message << std::endl;
+    }
+}
+
+void BPLogger::WriteSummary(const std::string &heading) {
+    std::string summary;
+    for (uint32_t id = 0; id < BP_MESSAGE_COUNT; ++id) {
+        uint32_t count = summaryCounts[id].exchange(0, std::memory_order_relaxed);
+        if (count != 0) {
+            summary += "\n  " + std::string(BPMessageName(static_cast<BPMessageId>(id))) + ": " + std::to_string(count);
+        }
+    }
+    if (!summary.empty()) {
+        Write(heading + summary);
+    }
 }
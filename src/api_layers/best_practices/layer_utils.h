@@ -7,69 +7,155 @@
 
 #include <xr_generated_dispatch_table.h>
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <iostream>
 #include <string>
-#include <unordered_map>
+#include <thread>
+#include <vector>
 
 #ifdef __ANDROID__
 #include "android/log.h"
 #endif
 
-class LockedDispatchTable {
+// Dispatch table to the next layer or runtime, read without locking by every forwarded call.  A reader is counted in
+// its thread's shard of reader counts, under the current epoch, while it loads a function pointer.  Reset() starts a
+// new epoch and waits only for the readers counted under the previous one, the only ones that may still see the table
+// it replaces, so it can free that table straight away however busy the other threads keep the new epoch's counts.
+class AtomicDispatchTable {
    public:
-    LockedDispatchTable() = default;
-    LockedDispatchTable(const LockedDispatchTable&) = delete;
-    LockedDispatchTable(LockedDispatchTable&&) = delete;
+    AtomicDispatchTable() = default;
+    AtomicDispatchTable(const AtomicDispatchTable&) = delete;
+    AtomicDispatchTable(AtomicDispatchTable&&) = delete;
 
     void Reset(std::unique_ptr<XrGeneratedDispatchTable>&& newTable = {});
 
     template <typename PFN>
     PFN Get(PFN(XrGeneratedDispatchTable::*p)) {
-        std::unique_lock<std::mutex> lock{m_mutex};
-        return m_dispatch.get()->*p;
+        const uint32_t epoch = m_epoch.load(std::memory_order_seq_cst) & 1;
+        std::atomic<uint32_t>& readers = m_readers[ThisThreadShard()].count[epoch];
+        readers.fetch_add(1, std::memory_order_seq_cst);
+        PFN function = m_dispatch.load(std::memory_order_seq_cst)->*p;
+        readers.fetch_sub(1, std::memory_order_release);
+        return function;
     }
 
-    bool isValid() { return m_dispatch.get() != nullptr; }
+    bool isValid() { return m_dispatch.load(std::memory_order_acquire) != nullptr; }
 
    private:
-    std::unique_ptr<XrGeneratedDispatchTable> m_dispatch{};
-    std::mutex m_mutex;
+    static constexpr size_t kReaderShards = 16;
+
+    // Each shard on its own cache line, so that threads in different shards do not share one.
+    struct alignas(64) ReaderShard {
+        // By epoch parity.
+        std::atomic<uint32_t> count[2]{{0}, {0}};
+    };
+
+    static size_t ThisThreadShard() {
+        static std::atomic<size_t> nextShard{0};
+        thread_local const size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % kReaderShards;
+        return shard;
+    }
+
+    std::atomic<XrGeneratedDispatchTable*> m_dispatch{nullptr};
+    std::atomic<uint32_t> m_epoch{0};
+    ReaderShard m_readers[kReaderShards];
+    std::mutex m_tableMutex;
+    std::unique_ptr<XrGeneratedDispatchTable> m_table;
+};
+
+// Every message the layer can report; rate limiting is per message ID, not per message text.  The
+// BP_MESSAGE_PERF_* IDs are performance lints rather than API usage problems.
+enum BPMessageId {
+    BP_MESSAGE_WAIT_FRAME_CALLED_TWICE = 0,
+    BP_MESSAGE_BEGIN_FRAME_NO_FRAMES_IN_FLIGHT,
+    BP_MESSAGE_BEGIN_FRAME_PREVIOUS_END_FRAME_FAILED,
+    BP_MESSAGE_BEGIN_FRAME_RETRIED,
+    BP_MESSAGE_BEGIN_FRAME_WITHOUT_WAIT_FRAME,
+    BP_MESSAGE_END_FRAME_ALPHA_BLEND_WITHOUT_SOURCE_ALPHA,
+    BP_MESSAGE_END_FRAME_WITHOUT_WAIT_FRAME,
+    BP_MESSAGE_END_FRAME_WITHOUT_BEGIN_FRAME,
+    BP_MESSAGE_END_FRAME_DISPLAY_TIME_MISMATCH,
+    BP_MESSAGE_END_FRAME_FOV_MISMATCH,
+    BP_MESSAGE_END_FRAME_ZERO_FOV,
+    BP_MESSAGE_END_FRAME_POSITION_MISMATCH,
+    BP_MESSAGE_END_FRAME_ORIENTATION_MISMATCH,
+    BP_MESSAGE_END_FRAME_RETRIED,
+    BP_MESSAGE_SYNC_ACTIONS_CALLED_TWICE,
+    BP_MESSAGE_SYNC_ACTIONS_INSIDE_FRAME,
+    BP_MESSAGE_LOCATE_SPACE_BEFORE_WAIT_FRAME,
+    BP_MESSAGE_LOCATE_VIEWS_DISPLAY_TIME_MISMATCH,
+    BP_MESSAGE_LOCATE_VIEWS_BEFORE_WAIT_FRAME,
+    BP_MESSAGE_PERF_LATE_BEGIN_FRAME,
+    BP_MESSAGE_PERF_WAIT_FRAME_ON_RENDER_THREAD,
+    BP_MESSAGE_PERF_LOCATE_SPACE_NOT_BATCHED,
+    BP_MESSAGE_PERF_REPEATED_ACTION_STATE,
+    BP_MESSAGE_PERF_LOCATE_VIEWS_REPEATED,
+    BP_MESSAGE_PERF_UNCHANGED_QUAD_LAYER,
+    BP_MESSAGE_COUNT,
 };
 
+// Machine-readable name of a message ID, written in front of every message, e.g.
+// "BestPractices-Perf-LateBeginFrame".
+const char* BPMessageName(BPMessageId id);
+
 class BPLogger {
    public:
-    static void LogMessage(const std::string& message) {
-        bool printError = false;
-        if (errorCounts.find(message) != errorCounts.end()) {
-            if (errorCounts[message] < 10) {
-                printError = true;
-            } else if (errorCounts[message] % 1000 == 0) {
-#if defined(XR_OS_WINDOWS)
-                OutputDebugStringA(
-                    (message + " (Limiting further occurrences [" + std::to_string(errorCounts[message]) + "])\n").c_str());
-#elif defined(XR_OS_ANDROID)
-                __android_log_write(
-                    ANDROID_LOG_ERROR, "OpenXR-BestPractices",
-                    (message + " (Limiting further occurrences [" + std::to_string(errorCounts[message]) + "])").c_str());
-#endif
-            }
-            errorCounts[message]++;
-        } else {
-            errorCounts[message] = 1;
-            printError = true;
+    // The first kReportLimit occurrences of a message ID are written, then every 1000th.
+    static constexpr uint32_t kReportLimit = 10;
+
+    static void LogMessage(BPMessageId id, const char* message) {
+        uint32_t occurrence = Count(id);
+        if (occurrence < kReportLimit) {
+            Write(Prefix(id) + message);
+        } else if (occurrence % 1000 == 0) {
+            Write(Prefix(id) + message + " (Limiting further occurrences [" + std::to_string(occurrence) + "])");
         }
+    }
 
-        if (printError) {
+    // Same as above, with " for frame <frameIndex>" appended; the string is only built when written.
+    static void LogMessage(BPMessageId id, const char* message, uint32_t frameIndex) {
+        uint32_t occurrence = Count(id);
+        if (occurrence < kReportLimit) {
+            Write(Prefix(id) + message + " for frame " + std::to_string(frameIndex));
+        } else if (occurrence % 1000 == 0) {
+            Write(Prefix(id) + message + " for frame " + std::to_string(frameIndex) + " (Limiting further occurrences [" +
+                  std::to_string(occurrence) + "])");
+        }
+    }
+
+    // Write how often each message ID occurred since the last summary, rate limited or not, and start counting
+    // afresh.  Nothing is written if there were no messages.
+    static void WriteSummary(const std::string& heading);
+
+    // Also append every message to this file from now on, one per line; an empty name stops doing so.
+    static void SetOutputFile(const std::string& fileName);
+
+   private:
+    static uint32_t Count(BPMessageId id) {
+        summaryCounts[id].fetch_add(1, std::memory_order_relaxed);
+        return messageCounts[id].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static std::string Prefix(BPMessageId id) { return std::string("[") + BPMessageName(id) + "] "; }
+
+    static void Write(const std::string& message) {
+        (void)message;  // maybe unused
 #if defined(XR_OS_WINDOWS)
-            OutputDebugStringA((message + "\n").c_str());
+        OutputDebugStringA((message + "\n").c_str());
 #elif defined(XR_OS_ANDROID)
-            __android_log_write(ANDROID_LOG_ERROR, "OpenXR-BestPractices", message.c_str());
+        __android_log_write(ANDROID_LOG_ERROR, "OpenXR-BestPractices", message.c_str());
 #endif
+        if (fileOpen.load(std::memory_order_acquire)) {
+            WriteToFile(message);
         }
     }
 
-   private:
-    static std::unordered_map<std::string, int> errorCounts;
+    static void WriteToFile(const std::string& message);
+
+    static std::atomic<uint32_t> messageCounts[BP_MESSAGE_COUNT];
+    static std::atomic<bool> fileOpen;
+    static std::atomic<uint32_t> summaryCounts[BP_MESSAGE_COUNT];
 };
@@ -0,0 +1,748 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Records the calls listed in capture_trace.h, with the data they return, so that xr_replay can
+// play them back against another runtime or layer stack.
+
+#include "api_dump_writer.h"
+#include "capture_trace.h"
+
+#include "hex_and_handles.h"
+#include "platform_utils.hpp"
+#include "xr_generated_dispatch_table.h"
+
+#include <openxr/openxr.h>
+#include <openxr/openxr_loader_negotiation.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#ifdef __ANDROID__
+#include "android/log.h"
+#endif
+
+#if defined(__GNUC__) && __GNUC__ >= 4
+#define LAYER_EXPORT __attribute__((visibility("default")))
+#elif defined(__SUNPRO_C) && (__SUNPRO_C >= 0x590)
+#define LAYER_EXPORT __attribute__((visibility("default")))
+#elif defined(_WIN32)
+#define LAYER_EXPORT __declspec(dllexport)
+#else
+#define LAYER_EXPORT
+#endif
+
+// For routing platform_utils.hpp messages.
+void LogPlatformUtilsError(const std::string &message) {
+    (void)message;  // maybe unused
+#if !defined(NDEBUG)
+    std::cerr << message << std::endl;
+#endif
+
+#if defined(XR_OS_WINDOWS)
+    OutputDebugStringA((message + "\n").c_str());
+#elif defined(XR_OS_ANDROID)
+    __android_log_write(ANDROID_LOG_ERROR, "OpenXR-Capture", message.c_str());
+#endif
+}
+
+// The layer supports one instance at a time; a second xrCreateInstance replaces the dispatch table.
+static XrGeneratedDispatchTable *g_next_dispatch = nullptr;
+static std::mutex g_capture_mutex;
+static bool g_capture_file_started = false;
+static std::chrono::steady_clock::time_point g_capture_start;
+
+static uint64_t CaptureLayerNowNs() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_capture_start).count());
+}
+
+static uint32_t CaptureLayerThreadIndex() {
+    static std::atomic<uint32_t> next_index{0};
+    thread_local uint32_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+// One record being built on the calling thread.  Inputs are written before Call() and outputs after
+// it; Finish() fills in the header and hands the record to the writer.
+class CaptureRecord {
+   public:
+    explicit CaptureRecord(CaptureTraceCommand command) : data_(ThreadBuffer()) {
+        data_.clear();
+        data_.append(sizeof(uint32_t) + sizeof(CaptureTraceRecordHeader), '\0');
+        header_.command_id = command;
+        header_.thread_index = CaptureLayerThreadIndex();
+    }
+
+    template <typename T>
+    void Value(const T &value) {
+        data_.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+    template <typename T>
+    void Handle(T handle) {
+        Value(MakeHandleGeneric(handle));
+    }
+    void String(const char *string) {
+        if (string == nullptr) {
+            Value(kCaptureTraceNullString);
+            return;
+        }
+        const uint32_t length = static_cast<uint32_t>(strlen(string));
+        Value(length);
+        data_.append(string, length);
+    }
+    void Count(uint32_t count) { Value(count); }
+    void Bytes(const void *data, size_t size) { data_.append(static_cast<const char *>(data), size); }
+
+    // Make the call down the chain, timing it.
+    template <typename F>
+    XrResult Call(F &&call) {
+        header_.start_ns = CaptureLayerNowNs();
+        header_.result = call();
+        header_.duration_ns = CaptureLayerNowNs() - header_.start_ns;
+        return static_cast<XrResult>(header_.result);
+    }
+
+    void Finish() {
+        const uint32_t length = static_cast<uint32_t>(data_.size() - sizeof(uint32_t));
+        memcpy(&data_[0], &length, sizeof(length));
+        memcpy(&data_[sizeof(length)], &header_, sizeof(header_));
+        if (GetApiDumpWriter().IsOpen()) {
+            GetApiDumpWriter().Append(data_);
+        }
+    }
+
+   private:
+    static std::string &ThreadBuffer() {
+        thread_local std::string buffer;
+        return buffer;
+    }
+
+    std::string &data_;
+    CaptureTraceRecordHeader header_{};
+};
+
+static bool CaptureLayerOpenFile() {
+    std::string file_name;
+#if !defined(ANDROID)
+    file_name = PlatformUtilsGetEnv("XR_CAPTURE_FILE_NAME");
+#else
+    file_name = PlatformUtilsGetAndroidSystemProperty("debug.capture_file_name");
+#endif
+    if (file_name.empty()) {
+        file_name = "xr_capture.trace";
+    }
+
+    // The file header is only written when the file is first created; later instances in the same
+    // process append to it, with times still relative to the first capture.
+    std::unique_lock<std::mutex> lock(g_capture_mutex);
+    const bool create = !g_capture_file_started;
+    if (!GetApiDumpWriter().Open(file_name, create)) {
+        LogPlatformUtilsError("Capture layer unable to open " + file_name);
+        return false;
+    }
+    if (create) {
+        g_capture_start = std::chrono::steady_clock::now();
+        std::string header(kCaptureTraceMagic, sizeof(kCaptureTraceMagic));
+        uint32_t version = CAPTURE_TRACE_FORMAT_VERSION;
+        header.append(reinterpret_cast<const char *>(&version), sizeof(version));
+        GetApiDumpWriter().WriteDirect(header);
+        g_capture_file_started = true;
+    }
+    return true;
+}
+
+PFN_xrVoidFunction CaptureLayerInnerGetInstanceProcAddr(const char *name);
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrDestroyInstance(XrInstance instance) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrDestroyInstance);
+    record.Handle(instance);
+    XrGeneratedDispatchTable *next_dispatch = g_next_dispatch;
+    XrResult result = record.Call([&] { return next_dispatch->DestroyInstance(instance); });
+    record.Finish();
+
+    GetApiDumpWriter().Close();
+    g_next_dispatch = nullptr;
+    delete next_dispatch;
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrGetSystem(XrInstance instance, const XrSystemGetInfo *getInfo, XrSystemId *systemId) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrGetSystem);
+    record.Handle(instance);
+    record.Value(getInfo->formFactor);
+    XrResult result = record.Call([&] { return g_next_dispatch->GetSystem(instance, getInfo, systemId); });
+    record.Value(XR_SUCCEEDED(result) ? *systemId : XR_NULL_SYSTEM_ID);
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrPollEvent(XrInstance instance, XrEventDataBuffer *eventData) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrPollEvent);
+    record.Handle(instance);
+    XrResult result = record.Call([&] { return g_next_dispatch->PollEvent(instance, eventData); });
+    record.Value(result == XR_SUCCESS ? eventData->type : XR_TYPE_UNKNOWN);
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrStringToPath(XrInstance instance, const char *pathString, XrPath *path) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrStringToPath);
+    record.Handle(instance);
+    record.String(pathString);
+    XrResult result = record.Call([&] { return g_next_dispatch->StringToPath(instance, pathString, path); });
+    record.Value(XR_SUCCEEDED(result) ? *path : XR_NULL_PATH);
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrCreateSession(XrInstance instance, const XrSessionCreateInfo *createInfo,
+                                                           XrSession *session) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrCreateSession);
+    record.Handle(instance);
+    record.Value(createInfo->systemId);
+    record.Value(createInfo->createFlags);
+    XrResult result = record.Call([&] { return g_next_dispatch->CreateSession(instance, createInfo, session); });
+    record.Handle(XR_SUCCEEDED(result) ? *session : XR_NULL_HANDLE);
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrDestroySession(XrSession session) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrDestroySession);
+    record.Handle(session);
+    XrResult result = record.Call([&] { return g_next_dispatch->DestroySession(session); });
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrBeginSession(XrSession session, const XrSessionBeginInfo *beginInfo) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrBeginSession);
+    record.Handle(session);
+    record.Value(beginInfo->primaryViewConfigurationType);
+    XrResult result = record.Call([&] { return g_next_dispatch->BeginSession(session, beginInfo); });
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrEndSession(XrSession session) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrEndSession);
+    record.Handle(session);
+    XrResult result = record.Call([&] { return g_next_dispatch->EndSession(session); });
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrRequestExitSession(XrSession session) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrRequestExitSession);
+    record.Handle(session);
+    XrResult result = record.Call([&] { return g_next_dispatch->RequestExitSession(session); });
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrCreateActionSet(XrInstance instance, const XrActionSetCreateInfo *createInfo,
+                                                             XrActionSet *actionSet) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrCreateActionSet);
+    record.Handle(instance);
+    record.String(createInfo->actionSetName);
+    record.String(createInfo->localizedActionSetName);
+    record.Value(createInfo->priority);
+    XrResult result = record.Call([&] { return g_next_dispatch->CreateActionSet(instance, createInfo, actionSet); });
+    record.Handle(XR_SUCCEEDED(result) ? *actionSet : XR_NULL_HANDLE);
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrDestroyActionSet(XrActionSet actionSet) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrDestroyActionSet);
+    record.Handle(actionSet);
+    XrResult result = record.Call([&] { return g_next_dispatch->DestroyActionSet(actionSet); });
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrCreateAction(XrActionSet actionSet, const XrActionCreateInfo *createInfo,
+                                                          XrAction *action) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrCreateAction);
+    record.Handle(actionSet);
+    record.String(createInfo->actionName);
+    record.Value(createInfo->actionType);
+    record.String(createInfo->localizedActionName);
+    record.Count(createInfo->countSubactionPaths);
+    for (uint32_t i = 0; i < createInfo->countSubactionPaths; ++i) {
+        record.Value(createInfo->subactionPaths[i]);
+    }
+    XrResult result = record.Call([&] { return g_next_dispatch->CreateAction(actionSet, createInfo, action); });
+    record.Handle(XR_SUCCEEDED(result) ? *action : XR_NULL_HANDLE);
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrDestroyAction(XrAction action) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrDestroyAction);
+    record.Handle(action);
+    XrResult result = record.Call([&] { return g_next_dispatch->DestroyAction(action); });
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrSuggestInteractionProfileBindings(
+    XrInstance instance, const XrInteractionProfileSuggestedBinding *suggestedBindings) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrSuggestInteractionProfileBindings);
+    record.Handle(instance);
+    record.Value(suggestedBindings->interactionProfile);
+    record.Count(suggestedBindings->countSuggestedBindings);
+    for (uint32_t i = 0; i < suggestedBindings->countSuggestedBindings; ++i) {
+        record.Handle(suggestedBindings->suggestedBindings[i].action);
+        record.Value(suggestedBindings->suggestedBindings[i].binding);
+    }
+    XrResult result = record.Call([&] { return g_next_dispatch->SuggestInteractionProfileBindings(instance, suggestedBindings); });
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrAttachSessionActionSets(XrSession session,
+                                                                     const XrSessionActionSetsAttachInfo *attachInfo) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrAttachSessionActionSets);
+    record.Handle(session);
+    record.Count(attachInfo->countActionSets);
+    for (uint32_t i = 0; i < attachInfo->countActionSets; ++i) {
+        record.Handle(attachInfo->actionSets[i]);
+    }
+    XrResult result = record.Call([&] { return g_next_dispatch->AttachSessionActionSets(session, attachInfo); });
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrSyncActions(XrSession session, const XrActionsSyncInfo *syncInfo) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrSyncActions);
+    record.Handle(session);
+    record.Count(syncInfo->countActiveActionSets);
+    for (uint32_t i = 0; i < syncInfo->countActiveActionSets; ++i) {
+        record.Handle(syncInfo->activeActionSets[i].actionSet);
+        record.Value(syncInfo->activeActionSets[i].subactionPath);
+    }
+    XrResult result = record.Call([&] { return g_next_dispatch->SyncActions(session, syncInfo); });
+    record.Finish();
+    return result;
+}
+
+// The action state queries share their inputs and record the returned state struct without its
+// type and next members.
+template <typename State, typename Call>
+static XrResult CaptureLayerActionState(CaptureTraceCommand command, XrSession session, const XrActionStateGetInfo *getInfo,
+                                        State *state, Call &&call) {
+    CaptureRecord record(command);
+    record.Handle(session);
+    record.Handle(getInfo->action);
+    record.Value(getInfo->subactionPath);
+    XrResult result = record.Call(call);
+    State recorded{};
+    if (XR_SUCCEEDED(result)) {
+        recorded = *state;
+    }
+    record.Bytes(reinterpret_cast<const char *>(&recorded) + sizeof(XrBaseOutStructure), sizeof(State) - sizeof(XrBaseOutStructure));
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrGetActionStateBoolean(XrSession session, const XrActionStateGetInfo *getInfo,
+                                                                   XrActionStateBoolean *state) {
+    return CaptureLayerActionState(CAPTURE_TRACE_COMMAND_xrGetActionStateBoolean, session, getInfo, state,
+                                   [&] { return g_next_dispatch->GetActionStateBoolean(session, getInfo, state); });
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrGetActionStateFloat(XrSession session, const XrActionStateGetInfo *getInfo,
+                                                                 XrActionStateFloat *state) {
+    return CaptureLayerActionState(CAPTURE_TRACE_COMMAND_xrGetActionStateFloat, session, getInfo, state,
+                                   [&] { return g_next_dispatch->GetActionStateFloat(session, getInfo, state); });
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrGetActionStateVector2f(XrSession session, const XrActionStateGetInfo *getInfo,
+                                                                    XrActionStateVector2f *state) {
+    return CaptureLayerActionState(CAPTURE_TRACE_COMMAND_xrGetActionStateVector2f, session, getInfo, state,
+                                   [&] { return g_next_dispatch->GetActionStateVector2f(session, getInfo, state); });
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrGetActionStatePose(XrSession session, const XrActionStateGetInfo *getInfo,
+                                                                XrActionStatePose *state) {
+    return CaptureLayerActionState(CAPTURE_TRACE_COMMAND_xrGetActionStatePose, session, getInfo, state,
+                                   [&] { return g_next_dispatch->GetActionStatePose(session, getInfo, state); });
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrCreateReferenceSpace(XrSession session, const XrReferenceSpaceCreateInfo *createInfo,
+                                                                  XrSpace *space) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrCreateReferenceSpace);
+    record.Handle(session);
+    record.Value(createInfo->referenceSpaceType);
+    record.Value(createInfo->poseInReferenceSpace);
+    XrResult result = record.Call([&] { return g_next_dispatch->CreateReferenceSpace(session, createInfo, space); });
+    record.Handle(XR_SUCCEEDED(result) ? *space : XR_NULL_HANDLE);
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrCreateActionSpace(XrSession session, const XrActionSpaceCreateInfo *createInfo,
+                                                               XrSpace *space) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrCreateActionSpace);
+    record.Handle(session);
+    record.Handle(createInfo->action);
+    record.Value(createInfo->subactionPath);
+    record.Value(createInfo->poseInActionSpace);
+    XrResult result = record.Call([&] { return g_next_dispatch->CreateActionSpace(session, createInfo, space); });
+    record.Handle(XR_SUCCEEDED(result) ? *space : XR_NULL_HANDLE);
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrDestroySpace(XrSpace space) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrDestroySpace);
+    record.Handle(space);
+    XrResult result = record.Call([&] { return g_next_dispatch->DestroySpace(space); });
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrLocateSpace(XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation *location) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrLocateSpace);
+    record.Handle(space);
+    record.Handle(baseSpace);
+    record.Value(time);
+    XrResult result = record.Call([&] { return g_next_dispatch->LocateSpace(space, baseSpace, time, location); });
+    const bool located = XR_SUCCEEDED(result);
+    record.Value(located ? location->locationFlags : XrSpaceLocationFlags{0});
+    record.Value(located ? location->pose : XrPosef{});
+    record.Finish();
+    return result;
+}
+
+// xrLocateSpaces and xrLocateSpacesKHR are recorded the same way.
+template <typename Call>
+static XrResult CaptureLayerLocateSpaces(XrSession session, const XrSpacesLocateInfo *locateInfo, XrSpaceLocations *spaceLocations,
+                                         Call &&call) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrLocateSpaces);
+    record.Handle(session);
+    record.Handle(locateInfo->baseSpace);
+    record.Value(locateInfo->time);
+    record.Count(locateInfo->spaceCount);
+    for (uint32_t i = 0; i < locateInfo->spaceCount; ++i) {
+        record.Handle(locateInfo->spaces[i]);
+    }
+    XrResult result = record.Call(call);
+    const uint32_t located = XR_SUCCEEDED(result) ? spaceLocations->locationCount : 0;
+    record.Count(located);
+    for (uint32_t i = 0; i < located; ++i) {
+        record.Value(spaceLocations->locations[i].locationFlags);
+        record.Value(spaceLocations->locations[i].pose);
+    }
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrLocateSpaces(XrSession session, const XrSpacesLocateInfo *locateInfo,
+                                                          XrSpaceLocations *spaceLocations) {
+    return CaptureLayerLocateSpaces(session, locateInfo, spaceLocations,
+                                    [&] { return g_next_dispatch->LocateSpaces(session, locateInfo, spaceLocations); });
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrLocateSpacesKHR(XrSession session, const XrSpacesLocateInfo *locateInfo,
+                                                             XrSpaceLocations *spaceLocations) {
+    return CaptureLayerLocateSpaces(session, locateInfo, spaceLocations,
+                                    [&] { return g_next_dispatch->LocateSpacesKHR(session, locateInfo, spaceLocations); });
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrWaitFrame(XrSession session, const XrFrameWaitInfo *frameWaitInfo,
+                                                       XrFrameState *frameState) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrWaitFrame);
+    record.Handle(session);
+    XrResult result = record.Call([&] { return g_next_dispatch->WaitFrame(session, frameWaitInfo, frameState); });
+    const bool waited = XR_SUCCEEDED(result);
+    record.Value(waited ? frameState->predictedDisplayTime : XrTime{0});
+    record.Value(waited ? frameState->predictedDisplayPeriod : XrDuration{0});
+    record.Value(waited ? frameState->shouldRender : XrBool32{XR_FALSE});
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrBeginFrame(XrSession session, const XrFrameBeginInfo *frameBeginInfo) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrBeginFrame);
+    record.Handle(session);
+    XrResult result = record.Call([&] { return g_next_dispatch->BeginFrame(session, frameBeginInfo); });
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrEndFrame(XrSession session, const XrFrameEndInfo *frameEndInfo) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrEndFrame);
+    record.Handle(session);
+    record.Value(frameEndInfo->displayTime);
+    record.Value(frameEndInfo->environmentBlendMode);
+    record.Count(frameEndInfo->layerCount);
+    XrResult result = record.Call([&] { return g_next_dispatch->EndFrame(session, frameEndInfo); });
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrLocateViews(XrSession session, const XrViewLocateInfo *viewLocateInfo,
+                                                         XrViewState *viewState, uint32_t viewCapacityInput,
+                                                         uint32_t *viewCountOutput, XrView *views) {
+    CaptureRecord record(CAPTURE_TRACE_COMMAND_xrLocateViews);
+    record.Handle(session);
+    record.Value(viewLocateInfo->viewConfigurationType);
+    record.Value(viewLocateInfo->displayTime);
+    record.Handle(viewLocateInfo->space);
+    record.Value(viewCapacityInput);
+    XrResult result = record.Call(
+        [&] { return g_next_dispatch->LocateViews(session, viewLocateInfo, viewState, viewCapacityInput, viewCountOutput, views); });
+    const bool located = XR_SUCCEEDED(result);
+    record.Value(located ? viewState->viewStateFlags : XrViewStateFlags{0});
+    const uint32_t count = located && views != nullptr ? std::min(*viewCountOutput, viewCapacityInput) : 0;
+    record.Count(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        record.Value(views[i].pose);
+        record.Value(views[i].fov);
+    }
+    record.Finish();
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrGetInstanceProcAddr(XrInstance instance, const char *name,
+                                                                 PFN_xrVoidFunction *function) {
+    try {
+        *function = CaptureLayerInnerGetInstanceProcAddr(name);
+
+        if (*function != nullptr) {
+            return XR_SUCCESS;
+        }
+
+        // We have not found it, so pass it down to the next layer/runtime
+        if (nullptr == g_next_dispatch) {
+            return XR_ERROR_HANDLE_INVALID;
+        }
+        return g_next_dispatch->GetInstanceProcAddr(instance, name, function);
+    } catch (...) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL CaptureLayerXrCreateApiLayerInstance(const XrInstanceCreateInfo *info,
+                                                                    const struct XrApiLayerCreateInfo *apiLayerInfo,
+                                                                    XrInstance *instance) {
+    try {
+        XrApiLayerCreateInfo new_api_layer_info = {};
+
+        // Validate the API layer info and next API layer info structures before we try to use them
+        if (nullptr == apiLayerInfo || XR_LOADER_INTERFACE_STRUCT_API_LAYER_CREATE_INFO != apiLayerInfo->structType ||
+            XR_API_LAYER_CREATE_INFO_STRUCT_VERSION > apiLayerInfo->structVersion ||
+            sizeof(XrApiLayerCreateInfo) > apiLayerInfo->structSize || nullptr == apiLayerInfo->nextInfo ||
+            XR_LOADER_INTERFACE_STRUCT_API_LAYER_NEXT_INFO != apiLayerInfo->nextInfo->structType ||
+            XR_API_LAYER_NEXT_INFO_STRUCT_VERSION > apiLayerInfo->nextInfo->structVersion ||
+            sizeof(XrApiLayerNextInfo) > apiLayerInfo->nextInfo->structSize ||
+            0 != strcmp("XR_APILAYER_KHRONOS_capture", apiLayerInfo->nextInfo->layerName) ||
+            nullptr == apiLayerInfo->nextInfo->nextGetInstanceProcAddr ||
+            nullptr == apiLayerInfo->nextInfo->nextCreateApiLayerInstance) {
+            return XR_ERROR_INITIALIZATION_FAILED;
+        }
+
+        if (!CaptureLayerOpenFile()) {
+            return XR_ERROR_INITIALIZATION_FAILED;
+        }
+
+        // Copy the contents of the layer info struct, but then move the next info up by
+        // one slot so that the next layer gets information.
+        memcpy(&new_api_layer_info, apiLayerInfo, sizeof(XrApiLayerCreateInfo));
+        new_api_layer_info.nextInfo = apiLayerInfo->nextInfo->next;
+
+        // Get the function pointers we need
+        PFN_xrGetInstanceProcAddr next_get_instance_proc_addr = apiLayerInfo->nextInfo->nextGetInstanceProcAddr;
+        PFN_xrCreateApiLayerInstance next_create_api_layer_instance = apiLayerInfo->nextInfo->nextCreateApiLayerInstance;
+
+        // Record this command as the standard xrCreateInstance.  Enabled API layers are not recorded,
+        // since the replay chooses its own layer stack.
+        CaptureRecord record(CAPTURE_TRACE_COMMAND_xrCreateInstance);
+        record.String(info->applicationInfo.applicationName);
+        record.Value(info->applicationInfo.applicationVersion);
+        record.String(info->applicationInfo.engineName);
+        record.Value(info->applicationInfo.engineVersion);
+        record.Value(info->applicationInfo.apiVersion);
+        record.Count(info->enabledExtensionCount);
+        for (uint32_t i = 0; i < info->enabledExtensionCount; ++i) {
+            record.String(info->enabledExtensionNames[i]);
+        }
+
+        // Create the instance using the layer create instance command for the next layer
+        XrInstance returned_instance = *instance;
+        XrResult result =
+            record.Call([&] { return next_create_api_layer_instance(info, &new_api_layer_info, &returned_instance); });
+        *instance = returned_instance;
+        record.Handle(XR_SUCCEEDED(result) ? returned_instance : XR_NULL_HANDLE);
+        record.Finish();
+
+        if (XR_SUCCEEDED(result)) {
+            // Create the dispatch table to the next levels
+            auto *next_dispatch = new XrGeneratedDispatchTable();
+            GeneratedXrPopulateDispatchTable(next_dispatch, returned_instance, next_get_instance_proc_addr);
+            delete g_next_dispatch;
+            g_next_dispatch = next_dispatch;
+        }
+
+        return result;
+    } catch (...) {
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+}
+
+// Function used to negotiate an interface betewen the loader and an API layer.  Each library exposing one or
+// more API layers needs to expose at least this function.
+extern "C" LAYER_EXPORT XRAPI_ATTR XrResult XRAPI_CALL xrNegotiateLoaderApiLayerInterface(
+    const XrNegotiateLoaderInfo *loaderInfo, const char * /*apiLayerName*/, XrNegotiateApiLayerRequest *apiLayerRequest) {
+    if (loaderInfo == nullptr || loaderInfo->structType != XR_LOADER_INTERFACE_STRUCT_LOADER_INFO ||
+        loaderInfo->structVersion != XR_LOADER_INFO_STRUCT_VERSION || loaderInfo->structSize != sizeof(XrNegotiateLoaderInfo)) {
+        LogPlatformUtilsError("loaderInfo struct is not valid");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (loaderInfo->minInterfaceVersion > XR_CURRENT_LOADER_API_LAYER_VERSION ||
+        loaderInfo->maxInterfaceVersion < XR_CURRENT_LOADER_API_LAYER_VERSION) {
+        LogPlatformUtilsError("loader interface version is not in the range [minInterfaceVersion, maxInterfaceVersion]");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (loaderInfo->minApiVersion > XR_CURRENT_API_VERSION || loaderInfo->maxApiVersion < XR_CURRENT_API_VERSION) {
+        LogPlatformUtilsError("loader api version is not in the range [minApiVersion, maxApiVersion]");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (apiLayerRequest == nullptr || apiLayerRequest->structType != XR_LOADER_INTERFACE_STRUCT_API_LAYER_REQUEST ||
+        apiLayerRequest->structVersion != XR_API_LAYER_INFO_STRUCT_VERSION ||
+        apiLayerRequest->structSize != sizeof(XrNegotiateApiLayerRequest)) {
+        LogPlatformUtilsError("apiLayerRequest is not valid");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    apiLayerRequest->layerInterfaceVersion = XR_CURRENT_LOADER_API_LAYER_VERSION;
+    apiLayerRequest->layerApiVersion = XR_CURRENT_API_VERSION;
+    apiLayerRequest->getInstanceProcAddr = CaptureLayerXrGetInstanceProcAddr;
+    apiLayerRequest->createApiLayerInstance = CaptureLayerXrCreateApiLayerInstance;
+
+    return XR_SUCCESS;
+}
+
+PFN_xrVoidFunction CaptureLayerInnerGetInstanceProcAddr(const char *name) {
+    std::string func_name = name;
+
+    if (func_name == "xrGetInstanceProcAddr") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrGetInstanceProcAddr);
+    }
+    if (func_name == "xrDestroyInstance") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrDestroyInstance);
+    }
+    if (func_name == "xrGetSystem") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrGetSystem);
+    }
+    if (func_name == "xrPollEvent") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrPollEvent);
+    }
+    if (func_name == "xrStringToPath") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrStringToPath);
+    }
+    if (func_name == "xrCreateSession") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrCreateSession);
+    }
+    if (func_name == "xrDestroySession") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrDestroySession);
+    }
+    if (func_name == "xrBeginSession") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrBeginSession);
+    }
+    if (func_name == "xrEndSession") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrEndSession);
+    }
+    if (func_name == "xrRequestExitSession") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrRequestExitSession);
+    }
+    if (func_name == "xrCreateActionSet") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrCreateActionSet);
+    }
+    if (func_name == "xrDestroyActionSet") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrDestroyActionSet);
+    }
+    if (func_name == "xrCreateAction") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrCreateAction);
+    }
+    if (func_name == "xrDestroyAction") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrDestroyAction);
+    }
+    if (func_name == "xrSuggestInteractionProfileBindings") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrSuggestInteractionProfileBindings);
+    }
+    if (func_name == "xrAttachSessionActionSets") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrAttachSessionActionSets);
+    }
+    if (func_name == "xrSyncActions") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrSyncActions);
+    }
+    if (func_name == "xrGetActionStateBoolean") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrGetActionStateBoolean);
+    }
+    if (func_name == "xrGetActionStateFloat") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrGetActionStateFloat);
+    }
+    if (func_name == "xrGetActionStateVector2f") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrGetActionStateVector2f);
+    }
+    if (func_name == "xrGetActionStatePose") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrGetActionStatePose);
+    }
+    if (func_name == "xrCreateReferenceSpace") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrCreateReferenceSpace);
+    }
+    if (func_name == "xrCreateActionSpace") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrCreateActionSpace);
+    }
+    if (func_name == "xrDestroySpace") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrDestroySpace);
+    }
+    if (func_name == "xrLocateSpace") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrLocateSpace);
+    }
+    if (func_name == "xrLocateSpaces") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrLocateSpaces);
+    }
+    if (func_name == "xrLocateSpacesKHR") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrLocateSpacesKHR);
+    }
+    if (func_name == "xrWaitFrame") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrWaitFrame);
+    }
+    if (func_name == "xrBeginFrame") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrBeginFrame);
+    }
+    if (func_name == "xrEndFrame") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrEndFrame);
+    }
+    if (func_name == "xrLocateViews") {
+        return reinterpret_cast<PFN_xrVoidFunction>(CaptureLayerXrLocateViews);
+    }
+    return nullptr;
+}
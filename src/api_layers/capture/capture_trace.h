@@ -0,0 +1,183 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#pragma once
+
+#include <openxr/openxr.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// Trace format written by the capture layer and read back by xr_replay.
+//
+// The file starts with kCaptureTraceMagic followed by a uint32_t format version.  Each call is one
+// record: a uint32_t byte count for the rest of the record, then the CaptureTraceRecordHeader, then
+// the command's inputs followed by its outputs.  Values are written as their raw bytes, strings as a
+// uint32_t length (kCaptureTraceNullString for nullptr) followed by the characters, and arrays as a
+// uint32_t count followed by the elements.  Handles, paths and system ids are written as the values
+// the application saw, and are mapped to the replay's own values by xr_replay.
+//
+// Only the commands in CaptureTraceCommand are recorded: the session lifecycle, action setup and
+// state queries, space creation and location, and the frame loop.  Together they reproduce an
+// application's per-frame API traffic; graphics bindings, swapchains and composition layers are not
+// recorded, so a replay runs headless and submits frames without layers.
+
+#define CAPTURE_TRACE_FORMAT_VERSION 1
+
+static const char kCaptureTraceMagic[8] = {'X', 'R', 'T', 'R', 'A', 'C', 'E', '\0'};
+static const uint32_t kCaptureTraceNullString = UINT32_MAX;
+
+enum CaptureTraceCommand : uint16_t {
+    CAPTURE_TRACE_COMMAND_UNKNOWN = 0,
+    CAPTURE_TRACE_COMMAND_xrCreateInstance,
+    CAPTURE_TRACE_COMMAND_xrDestroyInstance,
+    CAPTURE_TRACE_COMMAND_xrGetSystem,
+    CAPTURE_TRACE_COMMAND_xrPollEvent,
+    CAPTURE_TRACE_COMMAND_xrStringToPath,
+    CAPTURE_TRACE_COMMAND_xrCreateSession,
+    CAPTURE_TRACE_COMMAND_xrDestroySession,
+    CAPTURE_TRACE_COMMAND_xrBeginSession,
+    CAPTURE_TRACE_COMMAND_xrEndSession,
+    CAPTURE_TRACE_COMMAND_xrRequestExitSession,
+    CAPTURE_TRACE_COMMAND_xrCreateActionSet,
+    CAPTURE_TRACE_COMMAND_xrDestroyActionSet,
+    CAPTURE_TRACE_COMMAND_xrCreateAction,
+    CAPTURE_TRACE_COMMAND_xrDestroyAction,
+    CAPTURE_TRACE_COMMAND_xrSuggestInteractionProfileBindings,
+    CAPTURE_TRACE_COMMAND_xrAttachSessionActionSets,
+    CAPTURE_TRACE_COMMAND_xrSyncActions,
+    CAPTURE_TRACE_COMMAND_xrGetActionStateBoolean,
+    CAPTURE_TRACE_COMMAND_xrGetActionStateFloat,
+    CAPTURE_TRACE_COMMAND_xrGetActionStateVector2f,
+    CAPTURE_TRACE_COMMAND_xrGetActionStatePose,
+    CAPTURE_TRACE_COMMAND_xrCreateReferenceSpace,
+    CAPTURE_TRACE_COMMAND_xrCreateActionSpace,
+    CAPTURE_TRACE_COMMAND_xrDestroySpace,
+    CAPTURE_TRACE_COMMAND_xrLocateSpace,
+    CAPTURE_TRACE_COMMAND_xrLocateSpaces,
+    CAPTURE_TRACE_COMMAND_xrWaitFrame,
+    CAPTURE_TRACE_COMMAND_xrBeginFrame,
+    CAPTURE_TRACE_COMMAND_xrEndFrame,
+    CAPTURE_TRACE_COMMAND_xrLocateViews,
+    CAPTURE_TRACE_COMMAND_COUNT,
+};
+
+inline constexpr const char* kCaptureTraceCommandNames[CAPTURE_TRACE_COMMAND_COUNT] = {
+    nullptr,
+    "xrCreateInstance",
+    "xrDestroyInstance",
+    "xrGetSystem",
+    "xrPollEvent",
+    "xrStringToPath",
+    "xrCreateSession",
+    "xrDestroySession",
+    "xrBeginSession",
+    "xrEndSession",
+    "xrRequestExitSession",
+    "xrCreateActionSet",
+    "xrDestroyActionSet",
+    "xrCreateAction",
+    "xrDestroyAction",
+    "xrSuggestInteractionProfileBindings",
+    "xrAttachSessionActionSets",
+    "xrSyncActions",
+    "xrGetActionStateBoolean",
+    "xrGetActionStateFloat",
+    "xrGetActionStateVector2f",
+    "xrGetActionStatePose",
+    "xrCreateReferenceSpace",
+    "xrCreateActionSpace",
+    "xrDestroySpace",
+    "xrLocateSpace",
+    "xrLocateSpaces",
+    "xrWaitFrame",
+    "xrBeginFrame",
+    "xrEndFrame",
+    "xrLocateViews",
+};
+
+#pragma pack(push, 1)
+struct CaptureTraceRecordHeader {
+    uint16_t command_id;
+    uint16_t reserved;
+    uint32_t thread_index;
+    // Time the call started, relative to the start of the capture, and how long it took.
+    uint64_t start_ns;
+    uint64_t duration_ns;
+    int32_t result;
+};
+#pragma pack(pop)
+
+// Reads the inputs and outputs of one record.  Once a read runs past the end, Ok() returns false and
+// every further read yields zeros.
+class CaptureTraceReader {
+   public:
+    CaptureTraceReader(const uint8_t* data, size_t size) : cur_(data), end_(data + size) {}
+
+    bool Read(void* out, size_t size) {
+        if (static_cast<size_t>(end_ - cur_) < size) {
+            memset(out, 0, size);
+            cur_ = end_;
+            ok_ = false;
+            return false;
+        }
+        memcpy(out, cur_, size);
+        cur_ += size;
+        return true;
+    }
+    template <typename T>
+    T Value() {
+        T value{};
+        Read(&value, sizeof(T));
+        return value;
+    }
+    uint64_t Handle() { return Value<uint64_t>(); }
+    // Returns false for a null string.
+    bool String(std::string& out) {
+        const uint32_t length = Value<uint32_t>();
+        out.clear();
+        if (length == kCaptureTraceNullString) {
+            return false;
+        }
+        if (static_cast<size_t>(end_ - cur_) < length) {
+            cur_ = end_;
+            ok_ = false;
+            return false;
+        }
+        out.assign(reinterpret_cast<const char*>(cur_), length);
+        cur_ += length;
+        return true;
+    }
+    // Read an array count, failing if fewer than count elements of element_size remain.
+    uint32_t Count(size_t element_size) {
+        const uint32_t count = Value<uint32_t>();
+        if (element_size != 0 && static_cast<size_t>(end_ - cur_) / element_size < count) {
+            cur_ = end_;
+            ok_ = false;
+            return 0;
+        }
+        return count;
+    }
+
+    bool Ok() const { return ok_; }
+
+   private:
+    const uint8_t* cur_;
+    const uint8_t* end_;
+    bool ok_ = true;
+};
@@ -0,0 +1,633 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Replays a trace written by the capture layer against the active runtime, through whatever API
+// layers are enabled, and reports the latency of every command.
+
+#include "capture_trace.h"
+
+#include <openxr/openxr.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct CommandStats {
+    std::vector<uint64_t> captured_ns;
+    std::vector<uint64_t> replayed_ns;
+    uint64_t result_mismatches = 0;
+};
+
+uint64_t Percentile(std::vector<uint64_t>& values, double fraction) {
+    if (values.empty()) {
+        return 0;
+    }
+    const size_t index = std::min(values.size() - 1, static_cast<size_t>(fraction * static_cast<double>(values.size())));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+    return values[index];
+}
+
+uint64_t Mean(const std::vector<uint64_t>& values) {
+    if (values.empty()) {
+        return 0;
+    }
+    uint64_t sum = 0;
+    for (uint64_t value : values) {
+        sum += value;
+    }
+    return sum / values.size();
+}
+
+bool IsGraphicsEnableExtension(const std::string& name) {
+    static const char* const kGraphicsExtensions[] = {
+        "XR_KHR_opengl_enable",  "XR_KHR_opengl_es_enable", "XR_KHR_vulkan_enable", "XR_KHR_vulkan_enable2",
+        "XR_KHR_D3D11_enable",   "XR_KHR_D3D12_enable",     "XR_MNDX_egl_enable",   "XR_KHR_metal_enable",
+    };
+    for (const char* extension : kGraphicsExtensions) {
+        if (name == extension) {
+            return true;
+        }
+    }
+    return false;
+}
+
+class Replayer {
+   public:
+    explicit Replayer(bool original_timing) : original_timing_(original_timing) {}
+
+    // Replay one record.  Returns false if the record could not be decoded.
+    bool Replay(const CaptureTraceRecordHeader& header, CaptureTraceReader& reader);
+
+    void Report(std::ostream& out);
+    uint64_t Replayed() const { return replayed_; }
+    uint64_t Skipped() const { return skipped_; }
+
+   private:
+    template <typename T>
+    T Map(uint64_t captured) const {
+        auto it = handles_.find(captured);
+        return reinterpret_cast<T>(it != handles_.end() ? it->second : 0);
+    }
+    template <typename T>
+    void Bind(uint64_t captured, T replayed) {
+        if (captured != 0) {
+            handles_[captured] = reinterpret_cast<uint64_t>(replayed);
+        }
+    }
+    XrPath MapPath(XrPath captured) const {
+        auto it = paths_.find(captured);
+        return it != paths_.end() ? it->second : XR_NULL_PATH;
+    }
+    XrTime MapTime(XrTime captured) const { return captured + time_offset_; }
+
+    // Time one replayed call and account it against the captured one.
+    template <typename F>
+    XrResult Time(const CaptureTraceRecordHeader& header, F&& call) {
+        const auto start = std::chrono::steady_clock::now();
+        const XrResult result = call();
+        const auto end = std::chrono::steady_clock::now();
+        CommandStats& stats = stats_[header.command_id];
+        stats.captured_ns.push_back(header.duration_ns);
+        stats.replayed_ns.push_back(
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+        if (XR_SUCCEEDED(result) != XR_SUCCEEDED(static_cast<XrResult>(header.result))) {
+            ++stats.result_mismatches;
+        }
+        ++replayed_;
+        return result;
+    }
+
+    // Drain the event queue, as the application would between frames.
+    void PumpEvents();
+
+    bool original_timing_;
+    bool started_ = false;
+    uint64_t first_start_ns_ = 0;
+    std::chrono::steady_clock::time_point replay_start_;
+
+    XrInstance instance_ = XR_NULL_HANDLE;
+    PFN_xrLocateSpaces locate_spaces_ = nullptr;
+    std::unordered_map<uint64_t, uint64_t> handles_;
+    std::unordered_map<XrPath, XrPath> paths_;
+    std::unordered_map<XrSystemId, XrSystemId> systems_;
+    XrTime time_offset_ = 0;
+    CommandStats stats_[CAPTURE_TRACE_COMMAND_COUNT];
+    uint64_t replayed_ = 0;
+    uint64_t skipped_ = 0;
+};
+
+void Replayer::PumpEvents() {
+    if (instance_ == XR_NULL_HANDLE) {
+        return;
+    }
+    XrEventDataBuffer event{XR_TYPE_EVENT_DATA_BUFFER};
+    while (xrPollEvent(instance_, &event) == XR_SUCCESS) {
+        event = {XR_TYPE_EVENT_DATA_BUFFER};
+    }
+}
+
+bool Replayer::Replay(const CaptureTraceRecordHeader& header, CaptureTraceReader& reader) {
+    if (!started_) {
+        started_ = true;
+        first_start_ns_ = header.start_ns;
+        replay_start_ = std::chrono::steady_clock::now();
+    }
+    if (original_timing_ && header.start_ns > first_start_ns_) {
+        std::this_thread::sleep_until(replay_start_ + std::chrono::nanoseconds(header.start_ns - first_start_ns_));
+    }
+
+    switch (header.command_id) {
+        case CAPTURE_TRACE_COMMAND_xrCreateInstance: {
+            std::string application_name;
+            std::string engine_name;
+            XrInstanceCreateInfo create_info{XR_TYPE_INSTANCE_CREATE_INFO};
+            reader.String(application_name);
+            create_info.applicationInfo.applicationVersion = reader.Value<uint32_t>();
+            reader.String(engine_name);
+            create_info.applicationInfo.engineVersion = reader.Value<uint32_t>();
+            create_info.applicationInfo.apiVersion = reader.Value<XrVersion>();
+            strncpy(create_info.applicationInfo.applicationName, application_name.c_str(), XR_MAX_APPLICATION_NAME_SIZE - 1);
+            strncpy(create_info.applicationInfo.engineName, engine_name.c_str(), XR_MAX_ENGINE_NAME_SIZE - 1);
+
+            // Graphics bindings are not captured, so replace the graphics API with a headless session.
+            std::vector<std::string> extensions;
+            const uint32_t extension_count = reader.Count(sizeof(uint32_t));
+            for (uint32_t i = 0; i < extension_count; ++i) {
+                std::string name;
+                reader.String(name);
+                if (!IsGraphicsEnableExtension(name)) {
+                    extensions.push_back(name);
+                }
+            }
+            uint32_t available_count = 0;
+            xrEnumerateInstanceExtensionProperties(nullptr, 0, &available_count, nullptr);
+            std::vector<XrExtensionProperties> available(available_count, {XR_TYPE_EXTENSION_PROPERTIES});
+            xrEnumerateInstanceExtensionProperties(nullptr, available_count, &available_count, available.data());
+            for (const XrExtensionProperties& properties : available) {
+                if (strcmp(properties.extensionName, XR_MND_HEADLESS_EXTENSION_NAME) == 0 &&
+                    std::find(extensions.begin(), extensions.end(), XR_MND_HEADLESS_EXTENSION_NAME) == extensions.end()) {
+                    extensions.push_back(XR_MND_HEADLESS_EXTENSION_NAME);
+                }
+            }
+            std::vector<const char*> extension_names;
+            for (const std::string& name : extensions) {
+                extension_names.push_back(name.c_str());
+            }
+            create_info.enabledExtensionCount = static_cast<uint32_t>(extension_names.size());
+            create_info.enabledExtensionNames = extension_names.data();
+            const uint64_t captured = reader.Handle();
+            if (!reader.Ok()) {
+                return false;
+            }
+
+            XrInstance instance = XR_NULL_HANDLE;
+            if (XR_SUCCEEDED(Time(header, [&] { return xrCreateInstance(&create_info, &instance); }))) {
+                instance_ = instance;
+                Bind(captured, instance);
+                if (XR_FAILED(xrGetInstanceProcAddr(instance, "xrLocateSpaces",
+                                                    reinterpret_cast<PFN_xrVoidFunction*>(&locate_spaces_)))) {
+                    xrGetInstanceProcAddr(instance, "xrLocateSpacesKHR", reinterpret_cast<PFN_xrVoidFunction*>(&locate_spaces_));
+                }
+            }
+            return true;
+        }
+        case CAPTURE_TRACE_COMMAND_xrDestroyInstance: {
+            XrInstance instance = Map<XrInstance>(reader.Handle());
+            Time(header, [&] { return xrDestroyInstance(instance); });
+            if (instance == instance_) {
+                instance_ = XR_NULL_HANDLE;
+                locate_spaces_ = nullptr;
+            }
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrGetSystem: {
+            XrInstance instance = Map<XrInstance>(reader.Handle());
+            XrSystemGetInfo get_info{XR_TYPE_SYSTEM_GET_INFO};
+            get_info.formFactor = reader.Value<XrFormFactor>();
+            const XrSystemId captured = reader.Value<XrSystemId>();
+            XrSystemId system_id = XR_NULL_SYSTEM_ID;
+            if (XR_SUCCEEDED(Time(header, [&] { return xrGetSystem(instance, &get_info, &system_id); }))) {
+                systems_[captured] = system_id;
+            }
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrPollEvent: {
+            XrInstance instance = Map<XrInstance>(reader.Handle());
+            XrEventDataBuffer event{XR_TYPE_EVENT_DATA_BUFFER};
+            Time(header, [&] { return xrPollEvent(instance, &event); });
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrStringToPath: {
+            XrInstance instance = Map<XrInstance>(reader.Handle());
+            std::string path_string;
+            reader.String(path_string);
+            const XrPath captured = reader.Value<XrPath>();
+            XrPath path = XR_NULL_PATH;
+            if (XR_SUCCEEDED(Time(header, [&] { return xrStringToPath(instance, path_string.c_str(), &path); }))) {
+                paths_[captured] = path;
+            }
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrCreateSession: {
+            XrInstance instance = Map<XrInstance>(reader.Handle());
+            XrSessionCreateInfo create_info{XR_TYPE_SESSION_CREATE_INFO};
+            const XrSystemId captured_system = reader.Value<XrSystemId>();
+            create_info.systemId = systems_.count(captured_system) != 0 ? systems_[captured_system] : XR_NULL_SYSTEM_ID;
+            create_info.createFlags = reader.Value<XrSessionCreateFlags>();
+            const uint64_t captured = reader.Handle();
+            XrSession session = XR_NULL_HANDLE;
+            if (XR_SUCCEEDED(Time(header, [&] { return xrCreateSession(instance, &create_info, &session); }))) {
+                Bind(captured, session);
+            }
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrDestroySession: {
+            XrSession session = Map<XrSession>(reader.Handle());
+            Time(header, [&] { return xrDestroySession(session); });
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrBeginSession: {
+            XrSession session = Map<XrSession>(reader.Handle());
+            XrSessionBeginInfo begin_info{XR_TYPE_SESSION_BEGIN_INFO};
+            begin_info.primaryViewConfigurationType = reader.Value<XrViewConfigurationType>();
+            PumpEvents();
+            Time(header, [&] { return xrBeginSession(session, &begin_info); });
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrEndSession: {
+            XrSession session = Map<XrSession>(reader.Handle());
+            PumpEvents();
+            Time(header, [&] { return xrEndSession(session); });
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrRequestExitSession: {
+            XrSession session = Map<XrSession>(reader.Handle());
+            Time(header, [&] { return xrRequestExitSession(session); });
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrCreateActionSet: {
+            XrInstance instance = Map<XrInstance>(reader.Handle());
+            XrActionSetCreateInfo create_info{XR_TYPE_ACTION_SET_CREATE_INFO};
+            std::string name;
+            std::string localized_name;
+            reader.String(name);
+            reader.String(localized_name);
+            strncpy(create_info.actionSetName, name.c_str(), XR_MAX_ACTION_SET_NAME_SIZE - 1);
+            strncpy(create_info.localizedActionSetName, localized_name.c_str(), XR_MAX_LOCALIZED_ACTION_SET_NAME_SIZE - 1);
+            create_info.priority = reader.Value<uint32_t>();
+            const uint64_t captured = reader.Handle();
+            XrActionSet action_set = XR_NULL_HANDLE;
+            if (XR_SUCCEEDED(Time(header, [&] { return xrCreateActionSet(instance, &create_info, &action_set); }))) {
+                Bind(captured, action_set);
+            }
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrDestroyActionSet: {
+            XrActionSet action_set = Map<XrActionSet>(reader.Handle());
+            Time(header, [&] { return xrDestroyActionSet(action_set); });
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrCreateAction: {
+            XrActionSet action_set = Map<XrActionSet>(reader.Handle());
+            XrActionCreateInfo create_info{XR_TYPE_ACTION_CREATE_INFO};
+            std::string name;
+            std::string localized_name;
+            reader.String(name);
+            create_info.actionType = reader.Value<XrActionType>();
+            reader.String(localized_name);
+            strncpy(create_info.actionName, name.c_str(), XR_MAX_ACTION_NAME_SIZE - 1);
+            strncpy(create_info.localizedActionName, localized_name.c_str(), XR_MAX_LOCALIZED_ACTION_NAME_SIZE - 1);
+            std::vector<XrPath> subaction_paths(reader.Count(sizeof(XrPath)));
+            for (XrPath& path : subaction_paths) {
+                path = MapPath(reader.Value<XrPath>());
+            }
+            create_info.countSubactionPaths = static_cast<uint32_t>(subaction_paths.size());
+            create_info.subactionPaths = subaction_paths.data();
+            const uint64_t captured = reader.Handle();
+            XrAction action = XR_NULL_HANDLE;
+            if (XR_SUCCEEDED(Time(header, [&] { return xrCreateAction(action_set, &create_info, &action); }))) {
+                Bind(captured, action);
+            }
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrDestroyAction: {
+            XrAction action = Map<XrAction>(reader.Handle());
+            Time(header, [&] { return xrDestroyAction(action); });
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrSuggestInteractionProfileBindings: {
+            XrInstance instance = Map<XrInstance>(reader.Handle());
+            XrInteractionProfileSuggestedBinding suggested{XR_TYPE_INTERACTION_PROFILE_SUGGESTED_BINDING};
+            suggested.interactionProfile = MapPath(reader.Value<XrPath>());
+            std::vector<XrActionSuggestedBinding> bindings(reader.Count(sizeof(uint64_t) + sizeof(XrPath)));
+            for (XrActionSuggestedBinding& binding : bindings) {
+                binding.action = Map<XrAction>(reader.Handle());
+                binding.binding = MapPath(reader.Value<XrPath>());
+            }
+            suggested.countSuggestedBindings = static_cast<uint32_t>(bindings.size());
+            suggested.suggestedBindings = bindings.data();
+            Time(header, [&] { return xrSuggestInteractionProfileBindings(instance, &suggested); });
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrAttachSessionActionSets: {
+            XrSession session = Map<XrSession>(reader.Handle());
+            std::vector<XrActionSet> action_sets(reader.Count(sizeof(uint64_t)));
+            for (XrActionSet& action_set : action_sets) {
+                action_set = Map<XrActionSet>(reader.Handle());
+            }
+            XrSessionActionSetsAttachInfo attach_info{XR_TYPE_SESSION_ACTION_SETS_ATTACH_INFO};
+            attach_info.countActionSets = static_cast<uint32_t>(action_sets.size());
+            attach_info.actionSets = action_sets.data();
+            Time(header, [&] { return xrAttachSessionActionSets(session, &attach_info); });
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrSyncActions: {
+            XrSession session = Map<XrSession>(reader.Handle());
+            std::vector<XrActiveActionSet> active(reader.Count(sizeof(uint64_t) + sizeof(XrPath)));
+            for (XrActiveActionSet& action_set : active) {
+                action_set.actionSet = Map<XrActionSet>(reader.Handle());
+                action_set.subactionPath = MapPath(reader.Value<XrPath>());
+            }
+            XrActionsSyncInfo sync_info{XR_TYPE_ACTIONS_SYNC_INFO};
+            sync_info.countActiveActionSets = static_cast<uint32_t>(active.size());
+            sync_info.activeActionSets = active.data();
+            Time(header, [&] { return xrSyncActions(session, &sync_info); });
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrGetActionStateBoolean:
+        case CAPTURE_TRACE_COMMAND_xrGetActionStateFloat:
+        case CAPTURE_TRACE_COMMAND_xrGetActionStateVector2f:
+        case CAPTURE_TRACE_COMMAND_xrGetActionStatePose: {
+            XrSession session = Map<XrSession>(reader.Handle());
+            XrActionStateGetInfo get_info{XR_TYPE_ACTION_STATE_GET_INFO};
+            get_info.action = Map<XrAction>(reader.Handle());
+            get_info.subactionPath = MapPath(reader.Value<XrPath>());
+            switch (header.command_id) {
+                case CAPTURE_TRACE_COMMAND_xrGetActionStateBoolean: {
+                    XrActionStateBoolean state{XR_TYPE_ACTION_STATE_BOOLEAN};
+                    Time(header, [&] { return xrGetActionStateBoolean(session, &get_info, &state); });
+                    break;
+                }
+                case CAPTURE_TRACE_COMMAND_xrGetActionStateFloat: {
+                    XrActionStateFloat state{XR_TYPE_ACTION_STATE_FLOAT};
+                    Time(header, [&] { return xrGetActionStateFloat(session, &get_info, &state); });
+                    break;
+                }
+                case CAPTURE_TRACE_COMMAND_xrGetActionStateVector2f: {
+                    XrActionStateVector2f state{XR_TYPE_ACTION_STATE_VECTOR2F};
+                    Time(header, [&] { return xrGetActionStateVector2f(session, &get_info, &state); });
+                    break;
+                }
+                default: {
+                    XrActionStatePose state{XR_TYPE_ACTION_STATE_POSE};
+                    Time(header, [&] { return xrGetActionStatePose(session, &get_info, &state); });
+                    break;
+                }
+            }
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrCreateReferenceSpace: {
+            XrSession session = Map<XrSession>(reader.Handle());
+            XrReferenceSpaceCreateInfo create_info{XR_TYPE_REFERENCE_SPACE_CREATE_INFO};
+            create_info.referenceSpaceType = reader.Value<XrReferenceSpaceType>();
+            create_info.poseInReferenceSpace = reader.Value<XrPosef>();
+            const uint64_t captured = reader.Handle();
+            XrSpace space = XR_NULL_HANDLE;
+            if (XR_SUCCEEDED(Time(header, [&] { return xrCreateReferenceSpace(session, &create_info, &space); }))) {
+                Bind(captured, space);
+            }
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrCreateActionSpace: {
+            XrSession session = Map<XrSession>(reader.Handle());
+            XrActionSpaceCreateInfo create_info{XR_TYPE_ACTION_SPACE_CREATE_INFO};
+            create_info.action = Map<XrAction>(reader.Handle());
+            create_info.subactionPath = MapPath(reader.Value<XrPath>());
+            create_info.poseInActionSpace = reader.Value<XrPosef>();
+            const uint64_t captured = reader.Handle();
+            XrSpace space = XR_NULL_HANDLE;
+            if (XR_SUCCEEDED(Time(header, [&] { return xrCreateActionSpace(session, &create_info, &space); }))) {
+                Bind(captured, space);
+            }
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrDestroySpace: {
+            XrSpace space = Map<XrSpace>(reader.Handle());
+            Time(header, [&] { return xrDestroySpace(space); });
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrLocateSpace: {
+            XrSpace space = Map<XrSpace>(reader.Handle());
+            XrSpace base_space = Map<XrSpace>(reader.Handle());
+            const XrTime time = MapTime(reader.Value<XrTime>());
+            XrSpaceLocation location{XR_TYPE_SPACE_LOCATION};
+            Time(header, [&] { return xrLocateSpace(space, base_space, time, &location); });
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrLocateSpaces: {
+            XrSession session = Map<XrSession>(reader.Handle());
+            XrSpacesLocateInfo locate_info{XR_TYPE_SPACES_LOCATE_INFO};
+            locate_info.baseSpace = Map<XrSpace>(reader.Handle());
+            locate_info.time = MapTime(reader.Value<XrTime>());
+            std::vector<XrSpace> spaces(reader.Count(sizeof(uint64_t)));
+            for (XrSpace& space : spaces) {
+                space = Map<XrSpace>(reader.Handle());
+            }
+            std::vector<XrSpaceLocationData> locations(spaces.size());
+            locate_info.spaceCount = static_cast<uint32_t>(spaces.size());
+            locate_info.spaces = spaces.data();
+            XrSpaceLocations space_locations{XR_TYPE_SPACE_LOCATIONS};
+            space_locations.locationCount = static_cast<uint32_t>(locations.size());
+            space_locations.locations = locations.data();
+            if (locate_spaces_ == nullptr) {
+                ++skipped_;
+                return reader.Ok();
+            }
+            Time(header, [&] { return locate_spaces_(session, &locate_info, &space_locations); });
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrWaitFrame: {
+            XrSession session = Map<XrSession>(reader.Handle());
+            const XrTime captured_display_time = reader.Value<XrTime>();
+            XrFrameWaitInfo wait_info{XR_TYPE_FRAME_WAIT_INFO};
+            XrFrameState frame_state{XR_TYPE_FRAME_STATE};
+            if (XR_SUCCEEDED(Time(header, [&] { return xrWaitFrame(session, &wait_info, &frame_state); }))) {
+                // Later times in the trace are relative to this frame's predicted display time.
+                time_offset_ = frame_state.predictedDisplayTime - captured_display_time;
+            }
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrBeginFrame: {
+            XrSession session = Map<XrSession>(reader.Handle());
+            XrFrameBeginInfo begin_info{XR_TYPE_FRAME_BEGIN_INFO};
+            Time(header, [&] { return xrBeginFrame(session, &begin_info); });
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrEndFrame: {
+            XrSession session = Map<XrSession>(reader.Handle());
+            XrFrameEndInfo end_info{XR_TYPE_FRAME_END_INFO};
+            end_info.displayTime = MapTime(reader.Value<XrTime>());
+            end_info.environmentBlendMode = reader.Value<XrEnvironmentBlendMode>();
+            // The captured layers reference swapchains that do not exist here, so frames are ended empty.
+            (void)reader.Value<uint32_t>();
+            Time(header, [&] { return xrEndFrame(session, &end_info); });
+            return reader.Ok();
+        }
+        case CAPTURE_TRACE_COMMAND_xrLocateViews: {
+            XrSession session = Map<XrSession>(reader.Handle());
+            XrViewLocateInfo locate_info{XR_TYPE_VIEW_LOCATE_INFO};
+            locate_info.viewConfigurationType = reader.Value<XrViewConfigurationType>();
+            locate_info.displayTime = MapTime(reader.Value<XrTime>());
+            locate_info.space = Map<XrSpace>(reader.Handle());
+            const uint32_t capacity = reader.Value<uint32_t>();
+            std::vector<XrView> views(capacity, {XR_TYPE_VIEW});
+            XrViewState view_state{XR_TYPE_VIEW_STATE};
+            uint32_t view_count = 0;
+            Time(header, [&] {
+                return xrLocateViews(session, &locate_info, &view_state, capacity, &view_count, views.empty() ? nullptr : views.data());
+            });
+            return reader.Ok();
+        }
+        default:
+            ++skipped_;
+            return true;
+    }
+}
+
+void Replayer::Report(std::ostream& out) {
+    char line[256];
+    snprintf(line, sizeof(line), "%-40s %8s %10s %10s %10s %10s %10s %10s %8s\n", "command", "calls", "capt mean", "capt p50",
+             "capt p99", "mean", "p50", "p99", "mismatch");
+    out << line;
+    out << "(latencies in microseconds; \"capt\" columns are from the capture, the others from this replay)\n";
+    for (uint32_t command = 1; command < CAPTURE_TRACE_COMMAND_COUNT; ++command) {
+        CommandStats& stats = stats_[command];
+        if (stats.replayed_ns.empty()) {
+            continue;
+        }
+        snprintf(line, sizeof(line), "%-40s %8zu %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f %8" PRIu64 "\n",
+                 kCaptureTraceCommandNames[command], stats.replayed_ns.size(), Mean(stats.captured_ns) / 1000.0,
+                 Percentile(stats.captured_ns, 0.5) / 1000.0, Percentile(stats.captured_ns, 0.99) / 1000.0,
+                 Mean(stats.replayed_ns) / 1000.0, Percentile(stats.replayed_ns, 0.5) / 1000.0,
+                 Percentile(stats.replayed_ns, 0.99) / 1000.0, stats.result_mismatches);
+        out << line;
+    }
+}
+
+void PrintUsage() {
+    std::cerr << "Usage: xr_replay [--original-timing] <trace>\n"
+              << "  --original-timing  start each call at the same offset it had in the capture\n"
+              << "By default calls are replayed back to back, as fast as the runtime allows.\n"
+              << "The runtime and API layers are chosen as for any application (XR_RUNTIME_JSON,\n"
+              << "XR_ENABLE_API_LAYERS).\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    bool original_timing = false;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--original-timing") {
+            original_timing = true;
+        } else if (arg == "--help" || arg == "-h") {
+            PrintUsage();
+            return 0;
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "Unknown option " << arg << "\n";
+            PrintUsage();
+            return 1;
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.size() != 1) {
+        PrintUsage();
+        return 1;
+    }
+
+    std::ifstream input(files[0], std::ios::binary);
+    if (!input) {
+        std::cerr << "Unable to open " << files[0] << "\n";
+        return 1;
+    }
+    std::vector<uint8_t> trace((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+    uint32_t version = 0;
+    if (trace.size() < sizeof(kCaptureTraceMagic) + sizeof(version) ||
+        memcmp(trace.data(), kCaptureTraceMagic, sizeof(kCaptureTraceMagic)) != 0) {
+        std::cerr << files[0] << " is not a capture trace\n";
+        return 1;
+    }
+    memcpy(&version, trace.data() + sizeof(kCaptureTraceMagic), sizeof(version));
+    if (version != CAPTURE_TRACE_FORMAT_VERSION) {
+        std::cerr << files[0] << " uses trace format version " << version << ", expected " << CAPTURE_TRACE_FORMAT_VERSION << "\n";
+        return 1;
+    }
+
+    Replayer replayer(original_timing);
+    uint64_t undecoded_count = 0;
+    bool truncated = false;
+    size_t offset = sizeof(kCaptureTraceMagic) + sizeof(version);
+    while (offset < trace.size()) {
+        uint32_t length = 0;
+        CaptureTraceRecordHeader header{};
+        if (trace.size() - offset < sizeof(length)) {
+            truncated = true;
+            break;
+        }
+        memcpy(&length, trace.data() + offset, sizeof(length));
+        offset += sizeof(length);
+        if (length < sizeof(header) || length > trace.size() - offset) {
+            truncated = true;
+            break;
+        }
+        memcpy(&header, trace.data() + offset, sizeof(header));
+        CaptureTraceReader reader(trace.data() + offset + sizeof(header), length - sizeof(header));
+        offset += length;
+        if (!replayer.Replay(header, reader)) {
+            ++undecoded_count;
+        }
+    }
+
+    replayer.Report(std::cout);
+    std::cerr << replayer.Replayed() << " calls replayed";
+    if (replayer.Skipped() != 0) {
+        std::cerr << ", " << replayer.Skipped() << " skipped";
+    }
+    if (undecoded_count != 0) {
+        std::cerr << ", " << undecoded_count << " could not be decoded";
+    }
+    if (truncated) {
+        std::cerr << ", trace ends with a truncated record";
+    }
+    std::cerr << "\n";
+    return 0;
+}
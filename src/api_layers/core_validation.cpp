@@ -20,6 +20,7 @@
 //
 
 #include "api_layer_platform_defines.h"
+#include "core_validation_writer.h"
 #include "extra_algorithms.h"
 #include "hex_and_handles.h"
 #include "platform_utils.hpp"
@@ -33,9 +34,8 @@
 #include <algorithm>
 #include <cctype>
 #include <chrono>
+#include <cstdlib>
 #include <cstring>
-#include <fstream>
-#include <iomanip>
 #include <iostream>
 #include <inttypes.h>
 #include <memory>
@@ -43,6 +43,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -61,14 +62,6 @@
 #define LAYER_EXPORT
 #endif
 
-// Log recording information
-enum CoreValidationRecordType {
-    RECORD_NONE = 0,
-    RECORD_TEXT_COUT,
-    RECORD_TEXT_FILE,
-    RECORD_HTML_FILE,
-};
-
 struct CoreValidationRecordInfo {
     bool initialized;
     CoreValidationRecordType type;
@@ -81,10 +74,11 @@ static std::mutex g_record_mutex = {};
 // HTML utilities
 bool CoreValidationWriteHtmlHeader() {
     try {
-        std::unique_lock<std::mutex> mlock(g_record_mutex);
-        std::ofstream html_file;
-        html_file.open(g_record_info.file_name, std::ios::out);
-        html_file << "<!doctype html>\n"
+        if (!GetCoreValidationWriter().Open(RECORD_HTML_FILE, g_record_info.file_name, true)) {
+            return false;
+        }
+        GetCoreValidationWriter().WriteDirect(
+                     "<!doctype html>\n"
                      "<html>\n"
                      "    <head>\n"
                      "        <title>OpenXR Core Validation</title>\n"
@@ -194,7 +188,7 @@ bool CoreValidationWriteHtmlHeader() {
                      "            <img src='https://lunarg.com/wp-content/uploads/2016/02/LunarG-wReg-150.png' />\n"
                      "            <h1>OpenXR Core Validation</h1>\n"
                      "        </div>\n"
-                     "        <div id='wrapper'>\n";
+                     "        <div id='wrapper'>\n");
         return true;
     } catch (...) {
         return false;
@@ -203,12 +197,12 @@ bool CoreValidationWriteHtmlHeader() {
 
 bool CoreValidationWriteHtmlFooter() {
     try {
-        std::unique_lock<std::mutex> mlock(g_record_mutex);
-        std::ofstream html_file;
-        html_file.open(g_record_info.file_name, std::ios::out | std::ios::app);
-        html_file << "        </div>\n"
-                     "    </body>\n"
-                     "</html>";
+        GetCoreValidationWriter().ReportSuppressed();
+        GetCoreValidationWriter().WriteDirect(
+            "        </div>\n"
+            "    </body>\n"
+            "</html>");
+        GetCoreValidationWriter().Close();
 
         // Writing the footer means we're done.
         if (g_record_info.initialized) {
@@ -235,219 +229,98 @@ void LogPlatformUtilsError(const std::string &message) {
 #endif
 }
 
-// Get the current time as a string
-std::string GenerateTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-    std::tm local_tm = *std::localtime(&now_c);
-    std::ostringstream oss;
-    oss << std::put_time(&local_tm, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
-}
-
-// Function to record all the core validation information
+// Function to record all the core validation information.  Debug-utils messengers are called right
+// away; the text or HTML output is queued for the background writer.
 void CoreValidLogMessage(GenValidUsageXrInstanceInfo *instance_info, const std::string &message_id,
                          GenValidUsageDebugSeverity message_severity, const std::string &command_name,
-                         std::vector<GenValidUsageXrObjectInfo> objects_info, const std::string &message) {
-    if (g_record_info.initialized) {
-        std::unique_lock<std::mutex> mlock(g_record_mutex);
+                         std::vector<GenValidUsageXrObjectInfo> objects_info, const std::string &message_text) {
+    if (!g_record_info.initialized) {
+        return;
+    }
+    const auto message_time = std::chrono::steady_clock::now();
+
+    // A call validated on the deferred validation thread also says which call it was.
+    std::string message = message_text;
+    const GenValidUsageDeferredCall *deferred_call = GenValidUsageDeferredValidator::currentCall();
+    if (nullptr != deferred_call) {
+        std::ostringstream oss;
+        oss << " (deferred call " << deferred_call->sequence << " from thread " << deferred_call->thread << ")";
+        message += oss.str();
+    }
 
-        // Generate a timestamp
-        std::string timestamp = GenerateTimestamp();
+    std::vector<std::string> session_labels;
+    // If we have instance information, see if we need to log this information out to a debug messenger
+    // callback.
+    if (nullptr != instance_info && !instance_info->debug_messengers.empty()) {
+        std::unique_lock<std::mutex> mlock(g_record_mutex);
 
-        // Debug Utils items (in case we need them)
         XrDebugUtilsMessageSeverityFlagsEXT debug_utils_severity = 0;
-
-        std::string severity_string;
         switch (message_severity) {
             case VALID_USAGE_DEBUG_SEVERITY_DEBUG:
-                severity_string = "VALID_DEBUG";
                 debug_utils_severity = XR_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT;
                 break;
             case VALID_USAGE_DEBUG_SEVERITY_INFO:
-                severity_string = "VALID_INFO";
                 debug_utils_severity = XR_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT;
                 break;
             case VALID_USAGE_DEBUG_SEVERITY_WARNING:
-                severity_string = "VALID_WARNING";
                 debug_utils_severity = XR_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT;
                 break;
             case VALID_USAGE_DEBUG_SEVERITY_ERROR:
-                severity_string = "VALID_ERROR";
                 debug_utils_severity = XR_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
                 break;
             default:
-                severity_string = "VALID_UNKNOWN";
                 break;
         }
+
+        std::vector<XrSdkLogObjectInfo> objects;
+        objects.reserve(objects_info.size());
+        std::transform(objects_info.begin(), objects_info.end(), std::back_inserter(objects),
+                       [](GenValidUsageXrObjectInfo const &info) {
+                           return XrSdkLogObjectInfo{info.handle, info.type};  // force code wrap
+                       });
+
+        // Setup our callback data once
         NamesAndLabels names_and_labels;
-        // If we have instance information, see if we need to log this information out to a debug messenger
-        // callback.
-        if (nullptr != instance_info) {
-            if (!instance_info->debug_messengers.empty()) {
-                std::vector<XrSdkLogObjectInfo> objects;
-                objects.reserve(objects_info.size());
-                std::transform(objects_info.begin(), objects_info.end(), std::back_inserter(objects),
-                               [](GenValidUsageXrObjectInfo const &info) {
-                                   return XrSdkLogObjectInfo{info.handle, info.type};  // force code wrap
-                               });
-
-                // Setup our callback data once
-                XrDebugUtilsMessengerCallbackDataEXT callback_data = {XR_TYPE_DEBUG_UTILS_MESSENGER_CALLBACK_DATA_EXT};
-                callback_data.messageId = message_id.c_str();
-                callback_data.functionName = command_name.c_str();
-                callback_data.message = message.c_str();
-                if (!instance_info->debug_data.Empty()) {
-                    names_and_labels = instance_info->debug_data.PopulateNamesAndLabels(std::move(objects));
-                    names_and_labels.PopulateCallbackData(callback_data);
-                }
+        XrDebugUtilsMessengerCallbackDataEXT callback_data = {XR_TYPE_DEBUG_UTILS_MESSENGER_CALLBACK_DATA_EXT};
+        callback_data.messageId = message_id.c_str();
+        callback_data.functionName = command_name.c_str();
+        callback_data.message = message.c_str();
+        if (!instance_info->debug_data.Empty()) {
+            names_and_labels = instance_info->debug_data.PopulateNamesAndLabels(std::move(objects));
+            names_and_labels.PopulateCallbackData(callback_data);
+        }
 
-                // Loop through all active messengers and give each a chance to output information
-                for (const auto &debug_messenger : instance_info->debug_messengers) {
-                    CoreValidationMessengerInfo *validation_messenger_info = debug_messenger.get();
-                    XrDebugUtilsMessengerCreateInfoEXT *messenger_create_info = validation_messenger_info->create_info;
-                    // If a callback exists, and the message is of a type this callback cares about, call it.
-                    if (nullptr != messenger_create_info->userCallback &&
-                        0 != (messenger_create_info->messageSeverities & debug_utils_severity) &&
-                        0 != (messenger_create_info->messageTypes & XR_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT)) {
-                        XrBool32 ret_val = messenger_create_info->userCallback(debug_utils_severity,
-                                                                               XR_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT,
-                                                                               &callback_data, messenger_create_info->userData);
-                    }
-                }
+        // Loop through all active messengers and give each a chance to output information
+        for (const auto &debug_messenger : instance_info->debug_messengers) {
+            CoreValidationMessengerInfo *validation_messenger_info = debug_messenger.get();
+            XrDebugUtilsMessengerCreateInfoEXT *messenger_create_info = validation_messenger_info->create_info;
+            // If a callback exists, and the message is of a type this callback cares about, call it.
+            if (nullptr != messenger_create_info->userCallback &&
+                0 != (messenger_create_info->messageSeverities & debug_utils_severity) &&
+                0 != (messenger_create_info->messageTypes & XR_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT)) {
+                XrBool32 ret_val = messenger_create_info->userCallback(debug_utils_severity,
+                                                                       XR_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT,
+                                                                       &callback_data, messenger_create_info->userData);
             }
         }
 
-        switch (g_record_info.type) {
-            case RECORD_TEXT_COUT: {
-#if defined(ANDROID)
-#define ALOGI(...)       \
-    printf(__VA_ARGS__); \
-    __android_log_print(ANDROID_LOG_INFO, "core_validation", __VA_ARGS__)
-#else
-#define ALOGI(...) printf(__VA_ARGS__)
-#endif
-                ALOGI("[%s][%s|%s|%s]: %s \n", timestamp.c_str(), severity_string.c_str(), message_id.c_str(), command_name.c_str(),
-                      message.c_str());
-                if (!objects_info.empty()) {
-                    ALOGI("  Objects:\n");
-                    uint32_t count = 0;
-                    for (const auto &object_info : objects_info) {
-                        std::string object_type = GenValidUsageXrObjectTypeToString(object_info.type);
-                        std::string hexString = Uint64ToHexString(object_info.handle);
-                        ALOGI("   [%" PRIu32 "] - %s (%s)\n", count++, object_type.c_str(), hexString.c_str());
-                    }
-                }
-                if (!names_and_labels.labels.empty()) {
-                    ALOGI("  Session Labels:\n");
-                    uint32_t count = 0;
-                    for (const auto &session_label : names_and_labels.labels) {
-                        ALOGI("   [%" PRIu32 "] - %s\n", count++, session_label.labelName);
-#undef ALOGI
-                    }
-                }
-                break;
-            }
-            case RECORD_TEXT_FILE: {
-                std::ofstream text_file;
-                text_file.open(g_record_info.file_name, std::ios::out | std::ios::app);
-                text_file << "[" << timestamp << "]"  // force code wrap
-                          << "[" << severity_string << " | " << message_id << " | " << command_name << "] : " << message
-                          << std::endl;
-
-                if (!objects_info.empty()) {
-                    text_file << "  Objects:" << std::endl;
-                    uint32_t count = 0;
-                    for (const auto &object_info : objects_info) {
-                        std::string object_type = GenValidUsageXrObjectTypeToString(object_info.type);
-                        text_file << "   [" << std::to_string(count++) << "] - " << object_type << " ("
-                                  << Uint64ToHexString(object_info.handle) << ")";
-                        text_file << std::endl;
-                    }
-                }
-                if (!names_and_labels.labels.empty()) {
-                    text_file << "  Session Labels:" << std::endl;
-                    uint32_t count = 0;
-                    for (const auto &session_label : names_and_labels.labels) {
-                        text_file << "   [" << std::to_string(count++) << "] - " << session_label.labelName << std::endl;
-                    }
-                }
-                text_file << std::flush;
-                text_file.close();
-                break;
-            }
-            case RECORD_HTML_FILE: {
-                std::ofstream text_file;
-                text_file.open(g_record_info.file_name, std::ios::out | std::ios::app);
-                text_file << "<details class='data'>\n";
-                std::string header_type = "generalheadertype";
-                switch (message_severity) {
-                    case VALID_USAGE_DEBUG_SEVERITY_DEBUG:
-                        header_type = "debugheadertype";
-                        severity_string = "Debug Message";
-                        break;
-                    case VALID_USAGE_DEBUG_SEVERITY_INFO:
-                        severity_string = "Info Message";
-                        break;
-                    case VALID_USAGE_DEBUG_SEVERITY_WARNING:
-                        header_type = "warningheadertype";
-                        severity_string = "Warning Message";
-                        break;
-                    case VALID_USAGE_DEBUG_SEVERITY_ERROR:
-                        header_type = "errorheadertype";
-                        severity_string = "Error Message";
-                        break;
-                    default:
-                        severity_string = "Unknown Message";
-                        break;
-                }
-                text_file << "   <summary>\n"
-                          << "      <div class='timestampval'>[" << timestamp << "]</div>\n"
-                          << "      <div class='" << header_type << "'>" << severity_string << "</div>\n"
-                          << "      <div class='headerval'>" << command_name << "</div>\n"
-                          << "      <div class='headervar'>" << message_id << "</div>\n"
-                          << "   </summary>\n";
-                text_file << "   <div class='data'>\n";
-                text_file << "      <div class='val'>" << message << "</div>\n";
-                if (!objects_info.empty()) {
-                    text_file << "      <details class='data'>\n";
-                    text_file << "         <summary>\n";
-                    text_file << "            <div class='type'>Relevant OpenXR Objects</div>\n";
-                    text_file << "         </summary>\n";
-                    uint32_t count = 0;
-                    for (const auto &object_info : objects_info) {
-                        std::string object_type = GenValidUsageXrObjectTypeToString(object_info.type);
-                        text_file << "         <div class='data'>\n";
-                        text_file << "             <div class='var'>[" << count++ << "]</div>\n";
-                        text_file << "             <div class='type'>" << object_type << "</div>\n";
-                        text_file << "             <div class='val'>" << Uint64ToHexString(object_info.handle) << "</div>\n";
-                        text_file << "         </div>\n";
-                    }
-                    text_file << "      </details>\n";
-                    text_file << std::flush;
-                }
-                if (!names_and_labels.labels.empty()) {
-                    text_file << "      <details class='data'>\n";
-                    text_file << "         <summary>\n";
-                    text_file << "            <div class='type'>Relevant Session Labels</div>\n";
-                    text_file << "         </summary>\n";
-                    uint32_t count = 0;
-                    for (const auto &session_label : names_and_labels.labels) {
-                        text_file << "         <div class='data'>\n";
-                        text_file << "             <div class='var'>[" << count++ << "]</div>\n";
-                        text_file << "             <div class='type'>" << session_label.labelName << "</div>\n";
-                        text_file << "         </div>\n";
-                    }
-                    text_file << "      </details>\n";
-                }
-                text_file << "   </div>\n";
-                text_file << "</details>\n";
-                break;
-            }
-            default:
-                break;
+        for (const auto &session_label : names_and_labels.labels) {
+            session_labels.emplace_back(session_label.labelName);
         }
     }
+
+    if (RECORD_NONE == g_record_info.type) {
+        return;
+    }
+    CoreValidationMessage record;
+    record.time = message_time;
+    record.severity = message_severity;
+    record.message_id = message_id;
+    record.command_name = command_name;
+    record.message = std::move(message);
+    record.objects = std::move(objects_info);
+    record.session_labels = std::move(session_labels);
+    GetCoreValidationWriter().Append(std::move(record));
 }
 
 void reportInternalError(std::string const &message) {
@@ -455,8 +328,385 @@ void reportInternalError(std::string const &message) {
     throw std::runtime_error("Internal validation layer error: " + message);
 }
 
-void InvalidStructureType(GenValidUsageXrInstanceInfo *instance_info, const std::string &command_name,
-                          std::vector<GenValidUsageXrObjectInfo> &objects_info, const char *structure_name, XrStructureType type,
+namespace {
+// Wrappers are carved from chunks that are never freed, so that a stale handle can always be read to
+// find its tag cleared.  Released wrappers wait in a FIFO quarantine before reuse: were the last one
+// released handed out first, destroying a handle and creating another would give the stale handle the
+// new one's tag and owner, and a use after destroy would reach the new object unreported.
+struct WrappedHandlePool {
+    std::mutex mutex;
+    // Never handed out.
+    GenValidUsageWrappedHandle *fresh = nullptr;
+    // Released, oldest first.
+    GenValidUsageWrappedHandle *quarantine_head = nullptr;
+    GenValidUsageWrappedHandle *quarantine_tail = nullptr;
+    size_t quarantine_size = 0;
+    std::vector<std::unique_ptr<GenValidUsageWrappedHandle[]>> chunks;
+};
+WrappedHandlePool &GetWrappedHandlePool() {
+    // Leaked so that handles destroyed during static destruction are still safe to release.
+    static WrappedHandlePool *pool = new WrappedHandlePool;
+    return *pool;
+}
+constexpr size_t kWrappedHandleChunkSize = 256;
+// A released wrapper is reused only once this many others have been released after it.
+constexpr size_t kWrappedHandleQuarantineSize = 4096;
+}  // namespace
+
+GenValidUsageWrappedHandle *GenValidUsageAllocateWrappedHandle() {
+    WrappedHandlePool &pool = GetWrappedHandlePool();
+    std::unique_lock<std::mutex> lock(pool.mutex);
+    GenValidUsageWrappedHandle *wrapper = nullptr;
+    if (pool.quarantine_size > kWrappedHandleQuarantineSize) {
+        wrapper = pool.quarantine_head;
+        pool.quarantine_head = wrapper->next_free;
+        --pool.quarantine_size;
+    } else {
+        if (pool.fresh == nullptr) {
+            pool.chunks.emplace_back(new GenValidUsageWrappedHandle[kWrappedHandleChunkSize]);
+            GenValidUsageWrappedHandle *chunk = pool.chunks.back().get();
+            for (size_t i = 0; i < kWrappedHandleChunkSize; ++i) {
+                chunk[i].next_free = pool.fresh;
+                pool.fresh = &chunk[i];
+            }
+        }
+        wrapper = pool.fresh;
+        pool.fresh = wrapper->next_free;
+    }
+    wrapper->next_free = nullptr;
+    return wrapper;
+}
+
+void GenValidUsageReleaseWrappedHandle(GenValidUsageWrappedHandle *wrapper) {
+    wrapper->tag.store(0, std::memory_order_release);
+    WrappedHandlePool &pool = GetWrappedHandlePool();
+    std::unique_lock<std::mutex> lock(pool.mutex);
+    wrapper->next_free = nullptr;
+    if (pool.quarantine_size == 0) {
+        pool.quarantine_head = wrapper;
+    } else {
+        pool.quarantine_tail->next_free = wrapper;
+    }
+    pool.quarantine_tail = wrapper;
+    ++pool.quarantine_size;
+}
+
+void GenValidUsageCommandTier::apply(const GenValidUsageTierSettings &settings) {
+    GenValidUsageTier tier = generated_tier_;
+    auto command_tier = settings.command_tiers.find(command_name_);
+    if (command_tier != settings.command_tiers.end()) {
+        tier = command_tier->second;
+    } else if (settings.has_default_tier) {
+        tier = settings.default_tier;
+    }
+    sample_first_.store(settings.sample_first, std::memory_order_relaxed);
+    sample_interval_.store(settings.sample_interval, std::memory_order_relaxed);
+    call_count_.store(0, std::memory_order_relaxed);
+    tier_.store(tier, std::memory_order_relaxed);
+}
+
+static bool CoreValidationParseTier(std::string name, GenValidUsageTier &tier) {
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (name == "full") {
+        tier = VALID_USAGE_TIER_FULL;
+    } else if (name == "sampled") {
+        tier = VALID_USAGE_TIER_SAMPLED;
+    } else if (name == "structural") {
+        tier = VALID_USAGE_TIER_STRUCTURAL;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Reads the validation tier settings.  The tier setting is a comma-separated list whose entries are
+// either a tier, which becomes the default of every tiered command, or "<command>=<tier>".
+static GenValidUsageTierSettings CoreValidationReadTierSettings(const std::string &tier_setting, const std::string &sample_first,
+                                                                const std::string &sample_interval) {
+    GenValidUsageTierSettings settings;
+    std::istringstream entries(tier_setting);
+    std::string entry;
+    while (std::getline(entries, entry, ',')) {
+        entry.erase(std::remove_if(entry.begin(), entry.end(), [](unsigned char c) { return std::isspace(c); }), entry.end());
+        if (entry.empty()) {
+            continue;
+        }
+        GenValidUsageTier tier;
+        size_t equals = entry.find('=');
+        bool valid;
+        if (equals == std::string::npos) {
+            valid = CoreValidationParseTier(entry, tier);
+            if (valid) {
+                settings.default_tier = tier;
+                settings.has_default_tier = true;
+            }
+        } else {
+            valid = CoreValidationParseTier(entry.substr(equals + 1), tier);
+            if (valid) {
+                settings.command_tiers[entry.substr(0, equals)] = tier;
+            }
+        }
+        if (!valid) {
+            CoreValidLogMessage(nullptr, "VUID-CoreValidation-Tier", VALID_USAGE_DEBUG_SEVERITY_WARNING, "xrCreateApiLayerInstance",
+                                std::vector<GenValidUsageXrObjectInfo>(),
+                                "Ignoring unknown validation tier entry \"" + entry + "\", expected full, sampled or structural");
+        }
+    }
+    if (!sample_first.empty()) {
+        settings.sample_first = static_cast<uint32_t>(std::strtoul(sample_first.c_str(), nullptr, 10));
+    }
+    if (!sample_interval.empty()) {
+        settings.sample_interval = static_cast<uint32_t>(std::strtoul(sample_interval.c_str(), nullptr, 10));
+    }
+    return settings;
+}
+
+GenValidUsageDeferredValidator g_deferred_validation;
+
+static thread_local const GenValidUsageDeferredCall *g_current_deferred_call = nullptr;
+
+// The calls queued by one thread.  Only that thread advances the tail and only the validation thread
+// advances the head, which it does after validating the call, so a slot is reused only once its call
+// has been validated.  Each slot holds about 1KB of inline copies, so the ring is kept short; a thread
+// that gets that far ahead of the validation thread validates its calls itself.
+struct GenValidUsageDeferredValidator::ThreadQueue {
+    static constexpr uint64_t kCapacity = 128;
+    GenValidUsageDeferredCall calls[kCapacity];
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> tail{0};
+    // Set under the validator's mutex once the thread that owns the queue has exited.
+    bool retired = false;
+};
+
+// Retires the queue of a thread when the thread exits.
+struct GenValidUsageDeferredValidator::ThreadQueueOwner {
+    GenValidUsageDeferredValidator *validator = nullptr;
+    std::shared_ptr<ThreadQueue> queue;
+    ~ThreadQueueOwner() {
+        if (queue) {
+            validator->retire(queue);
+        }
+    }
+};
+
+void GenValidUsageDeferredValidator::setEnabled(bool enabled) {
+    if (!enabled) {
+        stop();
+    }
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+const GenValidUsageDeferredCall *GenValidUsageDeferredValidator::currentCall() { return g_current_deferred_call; }
+
+GenValidUsageDeferredValidator::ThreadQueue &GenValidUsageDeferredValidator::threadQueue() {
+    static thread_local ThreadQueueOwner owner;
+    if (!owner.queue) {
+        owner.validator = this;
+        owner.queue = std::make_shared<ThreadQueue>();
+        std::unique_lock<std::mutex> lock(mutex_);
+        queues_.push_back(owner.queue);
+    }
+    return *owner.queue;
+}
+
+// A queue that still holds calls stays in the list until the validation thread has drained it.
+void GenValidUsageDeferredValidator::retire(const std::shared_ptr<ThreadQueue> &queue) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (queue->head.load(std::memory_order_acquire) == queue->tail.load(std::memory_order_relaxed)) {
+        queues_.erase(std::remove(queues_.begin(), queues_.end(), queue), queues_.end());
+    } else {
+        queue->retired = true;
+        wake_.notify_one();
+    }
+}
+
+GenValidUsageDeferredCall *GenValidUsageDeferredValidator::reserve() {
+    ThreadQueue &queue = threadQueue();
+    uint64_t tail = queue.tail.load(std::memory_order_relaxed);
+    if (tail - queue.head.load(std::memory_order_acquire) >= ThreadQueue::kCapacity) {
+        // The validation thread has fallen behind; rather than wait for it, the caller validates the call.
+        return nullptr;
+    }
+    return &queue.calls[tail % ThreadQueue::kCapacity];
+}
+
+void GenValidUsageDeferredValidator::enqueue(GenValidUsageDeferredCall *call) {
+    call->sequence = next_sequence_.fetch_add(1, std::memory_order_relaxed);
+    call->thread = std::this_thread::get_id();
+    ThreadQueue &queue = threadQueue();
+    queue.tail.store(queue.tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    if (!running_.load(std::memory_order_acquire)) {
+        start();
+    } else if (sleeping_.load(std::memory_order_acquire)) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.notify_one();
+    }
+}
+
+void GenValidUsageDeferredValidator::start() {
+    std::unique_lock<std::mutex> thread_lock(thread_mutex_);
+    if (running_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stopping_ = false;
+    }
+    thread_ = std::thread(&GenValidUsageDeferredValidator::run, this);
+    running_.store(true, std::memory_order_release);
+}
+
+// Validates whatever each queue holds, returning whether there was anything.  Queues of exited
+// threads are dropped once they are empty.
+bool GenValidUsageDeferredValidator::validateQueued() {
+    std::vector<std::shared_ptr<ThreadQueue>> queues;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        queues = queues_;
+    }
+    bool validated = false;
+    for (auto &queue : queues) {
+        uint64_t head = queue->head.load(std::memory_order_relaxed);
+        uint64_t tail = queue->tail.load(std::memory_order_acquire);
+        for (; head != tail; ++head) {
+            GenValidUsageDeferredCall &call = queue->calls[head % ThreadQueue::kCapacity];
+            g_current_deferred_call = &call;
+            try {
+                call.validate(call.arguments);
+            } catch (...) {
+            }
+            g_current_deferred_call = nullptr;
+            // Any overflow copies are freed here rather than on the calling thread.
+            call.copies.reset();
+            queue->head.store(head + 1, std::memory_order_release);
+            validated = true;
+        }
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    queues_.erase(std::remove_if(queues_.begin(), queues_.end(),
+                                 [](const std::shared_ptr<ThreadQueue> &queue) {
+                                     return queue->retired && queue->head.load(std::memory_order_relaxed) ==
+                                                                  queue->tail.load(std::memory_order_acquire);
+                                 }),
+                  queues_.end());
+    if (validated) {
+        validated_.notify_all();
+    }
+    return validated;
+}
+
+void GenValidUsageDeferredValidator::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        lock.unlock();
+        bool validated = validateQueued();
+        lock.lock();
+        if (validated) {
+            continue;
+        }
+        if (stopping_) {
+            break;
+        }
+        // Callers only notify while this is set, so queueing a call normally costs no system call.
+        // The timeout covers a call queued just before going to sleep.
+        sleeping_.store(true, std::memory_order_release);
+        wake_.wait_for(lock, std::chrono::milliseconds(10));
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
+
+void GenValidUsageDeferredValidator::flush() {
+    if (!running_.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::vector<std::pair<std::shared_ptr<ThreadQueue>, uint64_t>> pending;
+    for (auto &queue : queues_) {
+        pending.emplace_back(queue, queue->tail.load(std::memory_order_acquire));
+    }
+    wake_.notify_one();
+    // The validation thread advances the heads before it takes the mutex to notify.
+    validated_.wait(lock, [&pending]() {
+        for (auto &queue_and_tail : pending) {
+            if (queue_and_tail.first->head.load(std::memory_order_acquire) < queue_and_tail.second) {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+void GenValidUsageDeferredValidator::stop() {
+    std::unique_lock<std::mutex> thread_lock(thread_mutex_);
+    if (!running_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stopping_ = true;
+        wake_.notify_one();
+    }
+    thread_.join();
+    running_.store(false, std::memory_order_release);
+}
+
+std::vector<GenValidUsageXrObjectInfo> GenValidUsageObjectList::toVector() const {
+    std::vector<GenValidUsageXrObjectInfo> objects;
+    objects.reserve(count_);
+    objects.insert(objects.end(), inline_objects_, inline_objects_ + (std::min)(count_, kInlineObjects));
+    objects.insert(objects.end(), overflow_objects_.begin(), overflow_objects_.end());
+    return objects;
+}
+
+void GenValidUsageReport(GenValidUsageXrInstanceInfo *instance_info, const char *message_id,
+                         GenValidUsageDebugSeverity message_severity, const char *command_name,
+                         const GenValidUsageObjectList &objects_info, const char *message) {
+    CoreValidLogMessage(instance_info, message_id, message_severity, command_name, objects_info.toVector(), message);
+}
+
+void GenValidUsageReportValue(GenValidUsageXrInstanceInfo *instance_info, const char *message_id, const char *command_name,
+                              const GenValidUsageObjectList &objects_info, const char *message, uint64_t value,
+                              const char *suffix) {
+    std::string error_message = message;
+    error_message += Uint64ToHexString(value);
+    error_message += suffix;
+    CoreValidLogMessage(instance_info, message_id, VALID_USAGE_DEBUG_SEVERITY_ERROR, command_name, objects_info.toVector(),
+                        error_message);
+}
+
+void GenValidUsageReportElement(GenValidUsageXrInstanceInfo *instance_info, const char *message_id, const char *command_name,
+                                const GenValidUsageObjectList &objects_info, const char *description, size_t index,
+                                const char *suffix) {
+    std::ostringstream oss;
+    oss << description << "[" << index << "]" << suffix;
+    CoreValidLogMessage(instance_info, message_id, VALID_USAGE_DEBUG_SEVERITY_ERROR, command_name, objects_info.toVector(),
+                        oss.str());
+}
+
+void GenValidUsageReportHandlePair(GenValidUsageXrInstanceInfo *instance_info, const char *message_id, const char *command_name,
+                                   const GenValidUsageObjectList &objects_info, const char *first, uint64_t first_handle,
+                                   const char *relation, uint64_t second_handle, const char *suffix) {
+    std::string error_message = first;
+    error_message += Uint64ToHexString(first_handle);
+    error_message += relation;
+    error_message += Uint64ToHexString(second_handle);
+    error_message += suffix;
+    CoreValidLogMessage(instance_info, message_id, VALID_USAGE_DEBUG_SEVERITY_ERROR, command_name, objects_info.toVector(),
+                        error_message);
+}
+
+void GenValidUsageReportParameter(GenValidUsageXrInstanceInfo *instance_info, const char *vuid_scope, const char *vuid_item,
+                                  const char *command_name, const GenValidUsageObjectList &objects_info, const char *message) {
+    std::string vuid = "VUID-";
+    vuid += vuid_scope;
+    vuid += "-";
+    vuid += vuid_item;
+    vuid += "-parameter";
+    CoreValidLogMessage(instance_info, vuid, VALID_USAGE_DEBUG_SEVERITY_ERROR, command_name, objects_info.toVector(), message);
+}
+
+void InvalidStructureType(GenValidUsageXrInstanceInfo *instance_info, const char *command_name,
+                          const GenValidUsageObjectList &objects_info, const char *structure_name, XrStructureType type,
                           const char *vuid, XrStructureType expected, const char *expected_name) {
     std::ostringstream oss_type;
     oss_type << structure_name << " has an invalid XrStructureType ";
@@ -466,14 +716,16 @@ void InvalidStructureType(GenValidUsageXrInstanceInfo *instance_info, const std:
         oss_type << " (" << expected_name << ")";
     }
     if (vuid != nullptr) {
-        CoreValidLogMessage(instance_info, vuid, VALID_USAGE_DEBUG_SEVERITY_ERROR, command_name, objects_info, oss_type.str());
+        CoreValidLogMessage(instance_info, vuid, VALID_USAGE_DEBUG_SEVERITY_ERROR, command_name, objects_info.toVector(),
+                            oss_type.str());
     } else {
         CoreValidLogMessage(instance_info, "VUID-" + std::string(structure_name) + "-type-type", VALID_USAGE_DEBUG_SEVERITY_ERROR,
-                            command_name, objects_info, oss_type.str());
+                            command_name, objects_info.toVector(), oss_type.str());
     }
 }
 
-std::string StructTypesToString(GenValidUsageXrInstanceInfo *instance_info, const std::unordered_set<XrStructureType> &structs) {
+static std::string StructTypesToString(GenValidUsageXrInstanceInfo *instance_info, const XrStructureType *begin,
+                                       const XrStructureType *end) {
     char struct_type_buffer[XR_MAX_STRUCTURE_NAME_SIZE];
     std::string error_message;
     if (nullptr == instance_info) {
@@ -481,8 +733,8 @@ std::string StructTypesToString(GenValidUsageXrInstanceInfo *instance_info, cons
         return error_message;
     }
     bool wrote_struct = false;
-    for (auto &s : structs)
-        if (XR_SUCCESS == instance_info->dispatch_table->StructureTypeToString(instance_info->instance, s, struct_type_buffer)) {
+    for (const XrStructureType *s = begin; s != end; ++s)
+        if (XR_SUCCESS == instance_info->dispatch_table->StructureTypeToString(instance_info->instance, *s, struct_type_buffer)) {
             if (wrote_struct) {
                 error_message += ", ";
             }
@@ -491,6 +743,62 @@ std::string StructTypesToString(GenValidUsageXrInstanceInfo *instance_info, cons
         }
     return error_message;
 }
+
+std::string StructTypesToString(GenValidUsageXrInstanceInfo *instance_info, GenValidUsageStructTypeSet structs) {
+    return StructTypesToString(instance_info, structs.begin(), structs.end());
+}
+
+static std::string NextChainUnknownStructTypesToString(GenValidUsageXrInstanceInfo *instance_info, const void *next,
+                                                       GenValidUsageStructTypeSet valid_structs) {
+    std::vector<XrStructureType> unknown_structs;
+    for (auto next_header = reinterpret_cast<const XrBaseInStructure *>(next); next_header != nullptr;
+         next_header = next_header->next) {
+        if (!valid_structs.contains(next_header->type) &&
+            std::find(unknown_structs.begin(), unknown_structs.end(), next_header->type) == unknown_structs.end()) {
+            unknown_structs.push_back(next_header->type);
+        }
+    }
+    return StructTypesToString(instance_info, unknown_structs.data(), unknown_structs.data() + unknown_structs.size());
+}
+
+static std::string NextChainDuplicateStructTypesToString(GenValidUsageXrInstanceInfo *instance_info, const void *next) {
+    std::vector<XrStructureType> encountered_structs;
+    std::vector<XrStructureType> duplicate_structs;
+    for (auto next_header = reinterpret_cast<const XrBaseInStructure *>(next); next_header != nullptr;
+         next_header = next_header->next) {
+        if (std::find(encountered_structs.begin(), encountered_structs.end(), next_header->type) == encountered_structs.end()) {
+            encountered_structs.push_back(next_header->type);
+        } else if (std::find(duplicate_structs.begin(), duplicate_structs.end(), next_header->type) == duplicate_structs.end()) {
+            duplicate_structs.push_back(next_header->type);
+        }
+    }
+    return StructTypesToString(instance_info, duplicate_structs.data(), duplicate_structs.data() + duplicate_structs.size());
+}
+
+void GenValidUsageReportUnknownNextStructs(GenValidUsageXrInstanceInfo *instance_info, const char *struct_name,
+                                           const char *command_name, const GenValidUsageObjectList &objects_info, const void *next,
+                                           GenValidUsageStructTypeSet valid_structs) {
+    std::string error_message = "Unknown structures type(s) in \"next\" chain for ";
+    error_message += struct_name;
+    error_message += " : ";
+    error_message += NextChainUnknownStructTypesToString(instance_info, next, valid_structs);
+    error_message += ", the valid structure type(s) are ";
+    error_message += StructTypesToString(instance_info, valid_structs);
+    CoreValidLogMessage(instance_info, "VUID-" + std::string(struct_name) + "-next-unknown", VALID_USAGE_DEBUG_SEVERITY_DEBUG,
+                        command_name, objects_info.toVector(), error_message);
+}
+
+void GenValidUsageReportDuplicateNextStructs(GenValidUsageXrInstanceInfo *instance_info, const char *struct_name,
+                                             const char *command_name, const GenValidUsageObjectList &objects_info,
+                                             const void *next) {
+    std::string error_message = "Multiple structures of the same type(s) in \"next\" chain for ";
+    error_message += struct_name;
+    error_message += " : ";
+    error_message += NextChainDuplicateStructTypesToString(instance_info, next);
+    CoreValidLogMessage(instance_info, "VUID-" + std::string(struct_name) + "-next-unique", VALID_USAGE_DEBUG_SEVERITY_DEBUG,
+                        command_name, objects_info.toVector(), error_message);
+}
+
 // NOTE: Can't validate the following VUIDs since the command never enters a layer:
 // Command: xrEnumerateApiLayerProperties
 //      VUIDs:  "VUID-xrEnumerateApiLayerProperties-propertyCountOutput-parameter"
@@ -534,12 +842,22 @@ XRAPI_ATTR XrResult XRAPI_CALL CoreValidationXrCreateApiLayerInstance(const XrIn
 #if !defined(ANDROID)
         std::string export_type = PlatformUtilsGetEnv("XR_CORE_VALIDATION_EXPORT_TYPE");
         std::string file_name = PlatformUtilsGetEnv("XR_CORE_VALIDATION_FILE_NAME");
+        std::string tier = PlatformUtilsGetEnv("XR_CORE_VALIDATION_TIER");
+        std::string sample_first = PlatformUtilsGetEnv("XR_CORE_VALIDATION_SAMPLE_FIRST");
+        std::string sample_interval = PlatformUtilsGetEnv("XR_CORE_VALIDATION_SAMPLE_INTERVAL");
+        std::string deferred = PlatformUtilsGetEnv("XR_CORE_VALIDATION_DEFERRED");
+        std::string duplicate_limit = PlatformUtilsGetEnv("XR_CORE_VALIDATION_DUPLICATE_LIMIT");
 #else
         // We match the pattern used by the Vulkan api_dump layer here
         // (we replace the `XR_` prefix with `debug.` and make it lowercase.)
         // adb shell "setprop debug.api_dump_file_name '/sdcard/xr_apidump.txt'"
         std::string export_type = PlatformUtilsGetAndroidSystemProperty("debug.core_validation_export_type");
         std::string file_name = PlatformUtilsGetAndroidSystemProperty("debug.core_validation_file_name");
+        std::string tier = PlatformUtilsGetAndroidSystemProperty("debug.core_validation_tier");
+        std::string sample_first = PlatformUtilsGetAndroidSystemProperty("debug.core_validation_sample_first");
+        std::string sample_interval = PlatformUtilsGetAndroidSystemProperty("debug.core_validation_sample_interval");
+        std::string deferred = PlatformUtilsGetAndroidSystemProperty("debug.core_validation_deferred");
+        std::string duplicate_limit = PlatformUtilsGetAndroidSystemProperty("debug.core_validation_duplicate_limit");
 #endif
         if (!file_name.empty()) {
             g_record_info.file_name = file_name;
@@ -561,12 +879,21 @@ XRAPI_ATTR XrResult XRAPI_CALL CoreValidationXrCreateApiLayerInstance(const XrIn
                 g_record_info.type = RECORD_NONE;
             }
         }
+        if (!duplicate_limit.empty()) {
+            GetCoreValidationWriter().SetDuplicateLimit(static_cast<uint32_t>(std::strtoul(duplicate_limit.c_str(), nullptr, 10)));
+        }
+        if (!GetCoreValidationWriter().Open(g_record_info.type, g_record_info.file_name, false)) {
+            return XR_ERROR_INITIALIZATION_FAILED;
+        }
         std::cerr << "Core Validation output type: " << (export_type.empty() ? "text" : export_type)
                   << ", first time = " << (first_time ? "true" : "false") << std::endl;
 
         CoreValidLogMessage(nullptr, "VUID-CoreValidation-Initialize", VALID_USAGE_DEBUG_SEVERITY_DEBUG, "xrCreateApiLayerInstance",
                             std::vector<GenValidUsageXrObjectInfo>(), "Core Validation Layer is initialized");
 
+        GenValidUsageApplyTierSettings(CoreValidationReadTierSettings(tier, sample_first, sample_interval));
+        g_deferred_validation.setEnabled(!deferred.empty() && deferred != "0");
+
         // Call the generated pre valid usage check.
         validation_result = GenValidUsageInputsXrCreateInstance(info, instance);
 
@@ -630,13 +957,12 @@ XRAPI_ATTR XrResult XRAPI_CALL CoreValidationXrCreateApiLayerInstance(const XrIn
 
 void EraseAllInstanceTableMapElements(GenValidUsageXrInstanceInfo *search_value) {
     typedef typename InstanceHandleInfo::value_t value_t;
-    auto map_with_lock = g_instance_info.lockMap();
-    auto &map = map_with_lock.second;
-
-    map_erase_if(map, [=](value_t const &data) { return data.second.get() == search_value; });
+    g_instance_info.eraseIf([=](value_t const &data) { return data.second.get() == search_value; });
 }
 
 XRAPI_ATTR XrResult XRAPI_CALL CoreValidationXrDestroyInstance(XrInstance instance) {
+    // Report what is still queued while the instance's debug messengers exist.
+    g_deferred_validation.stop();
     GenValidUsageInputsXrDestroyInstance(instance);
     if (XR_NULL_HANDLE != instance) {
         auto info_with_lock = g_instance_info.getWithLock(instance);
@@ -652,6 +978,15 @@ XRAPI_ATTR XrResult XRAPI_CALL CoreValidationXrDestroyInstance(XrInstance instan
     XrResult result = GenValidUsageNextXrDestroyInstance(instance);
     if (!g_instance_info.empty() && g_record_info.type == RECORD_HTML_FILE) {
         CoreValidationWriteHtmlFooter();
+    } else {
+        GetCoreValidationWriter().ReportSuppressed();
+        if (g_instance_info.empty()) {
+            // The loader may unload the layer once its last instance is gone, so end the writer thread now.
+            // The next xrCreateInstance opens the writer again.
+            GetCoreValidationWriter().Close();
+        } else {
+            GetCoreValidationWriter().Flush();
+        }
     }
     return result;
 }
@@ -840,6 +1175,10 @@ XRAPI_ATTR XrResult XRAPI_CALL CoreValidationXrSessionBeginDebugUtilsLabelRegion
             GenValidUsageXrInstanceInfo *gen_instance_info = info_with_lock.second->instance_info;
             if (nullptr != gen_instance_info) {
                 gen_instance_info->debug_data.BeginLabelRegion(session, *labelInfo);
+                // The loader records session labels itself when the runtime does not implement them.
+                if (nullptr == gen_instance_info->dispatch_table->SessionBeginDebugUtilsLabelRegionEXT) {
+                    return XR_SUCCESS;
+                }
             }
         }
     }
@@ -857,6 +1196,10 @@ XRAPI_ATTR XrResult XRAPI_CALL CoreValidationXrSessionEndDebugUtilsLabelRegionEX
             GenValidUsageXrInstanceInfo *gen_instance_info = info_with_lock.second->instance_info;
             if (nullptr != gen_instance_info) {
                 gen_instance_info->debug_data.EndLabelRegion(session);
+                // The loader records session labels itself when the runtime does not implement them.
+                if (nullptr == gen_instance_info->dispatch_table->SessionEndDebugUtilsLabelRegionEXT) {
+                    return XR_SUCCESS;
+                }
             }
         }
     }
@@ -875,6 +1218,10 @@ XRAPI_ATTR XrResult XRAPI_CALL CoreValidationXrSessionInsertDebugUtilsLabelEXT(X
             GenValidUsageXrInstanceInfo *gen_instance_info = info_with_lock.second->instance_info;
             if (nullptr != gen_instance_info) {
                 gen_instance_info->debug_data.InsertLabel(session, *labelInfo);
+                // The loader records session labels itself when the runtime does not implement them.
+                if (nullptr == gen_instance_info->dispatch_table->SessionInsertDebugUtilsLabelEXT) {
+                    return XR_SUCCESS;
+                }
             }
         }
     }
@@ -0,0 +1,266 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "core_validation_writer.h"
+
+#include "hex_and_handles.h"
+#include "xr_generated_core_validation.hpp"
+
+#include <cstdio>
+#include <ctime>
+#include <utility>
+
+CoreValidationWriter& GetCoreValidationWriter() {
+    // Never destroyed, so that a message found on another thread during static destruction has a writer to go to.
+    static CoreValidationWriter* writer = new CoreValidationWriter();
+    return *writer;
+}
+
+CoreValidationWriter::CoreValidationWriter() {
+    writer_.SetDrainCallback([this]() { FormatQueued(); });
+    writer_.SetLogTag("core_validation");
+}
+
+CoreValidationWriter::~CoreValidationWriter() { Close(); }
+
+bool CoreValidationWriter::Open(CoreValidationRecordType type, const std::string& file_name, bool truncate) {
+    if (type == RECORD_NONE || writer_.IsOpen()) {
+        return true;
+    }
+    // The writer is not running, so nothing formats concurrently.
+    type_ = type;
+    wall_base_ = std::chrono::system_clock::now();
+    steady_base_ = std::chrono::steady_clock::now();
+    timestamp_second_ = -1;
+    return writer_.Open(type == RECORD_TEXT_COUT ? std::string() : file_name, truncate);
+}
+
+void CoreValidationWriter::Close() { writer_.Close(); }
+
+void CoreValidationWriter::Append(CoreValidationMessage&& message) {
+    if (!writer_.IsOpen()) {
+        return;
+    }
+    const uint32_t limit = duplicate_limit_.load(std::memory_order_relaxed);
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        if (limit != 0) {
+            // Messages are told apart by their ID and the first object they name.
+            const GenValidUsageXrObjectInfo object =
+                message.objects.empty() ? GenValidUsageXrObjectInfo{} : message.objects.front();
+            std::string key = message.message_id;
+            key.append(reinterpret_cast<const char*>(&object.handle), sizeof(object.handle));
+            DuplicateCount& count = duplicates_[key];
+            if (++count.seen > limit) {
+                return;
+            }
+            if (count.seen == 1) {
+                count.severity = message.severity;
+                count.command_name = message.command_name;
+                count.object = object;
+            }
+        }
+        queue_.push_back(std::move(message));
+    }
+    // Wake the writer once per batch rather than for every message.
+    if (!wake_pending_.exchange(true, std::memory_order_acq_rel)) {
+        writer_.Wake();
+    }
+}
+
+void CoreValidationWriter::ReportSuppressed() {
+    if (!writer_.IsOpen()) {
+        return;
+    }
+    const uint32_t limit = duplicate_limit_.load(std::memory_order_relaxed);
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    for (const auto& key_and_count : duplicates_) {
+        const DuplicateCount& count = key_and_count.second;
+        if (count.seen <= limit) {
+            continue;
+        }
+        CoreValidationMessage message;
+        message.time = std::chrono::steady_clock::now();
+        message.severity = count.severity;
+        message.message_id = key_and_count.first.substr(0, key_and_count.first.size() - sizeof(uint64_t));
+        message.command_name = count.command_name;
+        message.message = std::to_string(count.seen - limit) + " more messages like this one were suppressed after the first " +
+                          std::to_string(limit);
+        if (count.object.type != XR_OBJECT_TYPE_UNKNOWN || count.object.handle != 0) {
+            message.objects.push_back(count.object);
+        }
+        queue_.push_back(std::move(message));
+    }
+    duplicates_.clear();
+}
+
+void CoreValidationWriter::Flush() { writer_.Flush(); }
+
+void CoreValidationWriter::WriteDirect(const std::string& text) { writer_.WriteDirect(text); }
+
+void CoreValidationWriter::FormatQueued() {
+    wake_pending_.store(false, std::memory_order_release);
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        batch_.clear();
+        std::swap(batch_, queue_);
+    }
+    for (const CoreValidationMessage& message : batch_) {
+        output_.clear();
+        Format(message);
+        writer_.Append(output_);
+    }
+}
+
+const std::string& CoreValidationWriter::Timestamp(std::chrono::steady_clock::time_point time) {
+    const auto wall = wall_base_ + std::chrono::duration_cast<std::chrono::system_clock::duration>(time - steady_base_);
+    const auto since_epoch = std::chrono::duration_cast<std::chrono::milliseconds>(wall.time_since_epoch()).count();
+    const int64_t second = since_epoch / 1000;
+    if (second != timestamp_second_) {
+        // Only a change of second needs the calendar.
+        std::time_t wall_time = static_cast<std::time_t>(second);
+        std::tm local_tm = *std::localtime(&wall_time);
+        char date[32];
+        std::strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", &local_tm);
+        timestamp_date_ = date;
+        timestamp_second_ = second;
+    }
+    char milliseconds[8];
+    std::snprintf(milliseconds, sizeof(milliseconds), ".%03d", static_cast<int>(since_epoch % 1000));
+    timestamp_ = timestamp_date_;
+    timestamp_ += milliseconds;
+    return timestamp_;
+}
+
+void CoreValidationWriter::Format(const CoreValidationMessage& message) {
+    const std::string& timestamp = Timestamp(message.time);
+    std::string& out = output_;
+    switch (type_) {
+        case RECORD_TEXT_COUT:
+        case RECORD_TEXT_FILE: {
+            const char* severity_string = "VALID_UNKNOWN";
+            switch (message.severity) {
+                case VALID_USAGE_DEBUG_SEVERITY_DEBUG:
+                    severity_string = "VALID_DEBUG";
+                    break;
+                case VALID_USAGE_DEBUG_SEVERITY_INFO:
+                    severity_string = "VALID_INFO";
+                    break;
+                case VALID_USAGE_DEBUG_SEVERITY_WARNING:
+                    severity_string = "VALID_WARNING";
+                    break;
+                case VALID_USAGE_DEBUG_SEVERITY_ERROR:
+                    severity_string = "VALID_ERROR";
+                    break;
+                default:
+                    break;
+            }
+            const bool to_file = type_ == RECORD_TEXT_FILE;
+            out += "[" + timestamp + "][";
+            out += severity_string;
+            out += to_file ? " | " : "|";
+            out += message.message_id;
+            out += to_file ? " | " : "|";
+            out += message.command_name;
+            out += to_file ? "] : " : "]: ";
+            out += message.message;
+            out += to_file ? "\n" : " \n";
+            if (!message.objects.empty()) {
+                out += "  Objects:\n";
+                uint32_t count = 0;
+                for (const auto& object_info : message.objects) {
+                    out += "   [" + std::to_string(count++) + "] - " + GenValidUsageXrObjectTypeToString(object_info.type) +
+                           " (" + Uint64ToHexString(object_info.handle) + ")\n";
+                }
+            }
+            if (!message.session_labels.empty()) {
+                out += "  Session Labels:\n";
+                uint32_t count = 0;
+                for (const auto& session_label : message.session_labels) {
+                    out += "   [" + std::to_string(count++) + "] - " + session_label + "\n";
+                }
+            }
+            break;
+        }
+        case RECORD_HTML_FILE: {
+            std::string header_type = "generalheadertype";
+            const char* severity_string = "Unknown Message";
+            switch (message.severity) {
+                case VALID_USAGE_DEBUG_SEVERITY_DEBUG:
+                    header_type = "debugheadertype";
+                    severity_string = "Debug Message";
+                    break;
+                case VALID_USAGE_DEBUG_SEVERITY_INFO:
+                    severity_string = "Info Message";
+                    break;
+                case VALID_USAGE_DEBUG_SEVERITY_WARNING:
+                    header_type = "warningheadertype";
+                    severity_string = "Warning Message";
+                    break;
+                case VALID_USAGE_DEBUG_SEVERITY_ERROR:
+                    header_type = "errorheadertype";
+                    severity_string = "Error Message";
+                    break;
+                default:
+                    break;
+            }
+            out += "<details class='data'>\n";
+            out += "   <summary>\n";
+            out += "      <div class='timestampval'>[" + timestamp + "]</div>\n";
+            out += "      <div class='" + header_type + "'>" + severity_string + "</div>\n";
+            out += "      <div class='headerval'>" + message.command_name + "</div>\n";
+            out += "      <div class='headervar'>" + message.message_id + "</div>\n";
+            out += "   </summary>\n";
+            out += "   <div class='data'>\n";
+            out += "      <div class='val'>" + message.message + "</div>\n";
+            if (!message.objects.empty()) {
+                out += "      <details class='data'>\n";
+                out += "         <summary>\n";
+                out += "            <div class='type'>Relevant OpenXR Objects</div>\n";
+                out += "         </summary>\n";
+                uint32_t count = 0;
+                for (const auto& object_info : message.objects) {
+                    out += "         <div class='data'>\n";
+                    out += "             <div class='var'>[" + std::to_string(count++) + "]</div>\n";
+                    out += "             <div class='type'>" + GenValidUsageXrObjectTypeToString(object_info.type) + "</div>\n";
+                    out += "             <div class='val'>" + Uint64ToHexString(object_info.handle) + "</div>\n";
+                    out += "         </div>\n";
+                }
+                out += "      </details>\n";
+            }
+            if (!message.session_labels.empty()) {
+                out += "      <details class='data'>\n";
+                out += "         <summary>\n";
+                out += "            <div class='type'>Relevant Session Labels</div>\n";
+                out += "         </summary>\n";
+                uint32_t count = 0;
+                for (const auto& session_label : message.session_labels) {
+                    out += "         <div class='data'>\n";
+                    out += "             <div class='var'>[" + std::to_string(count++) + "]</div>\n";
+                    out += "             <div class='type'>" + session_label + "</div>\n";
+                    out += "         </div>\n";
+                }
+                out += "      </details>\n";
+            }
+            out += "   </div>\n";
+            out += "</details>\n";
+            break;
+        }
+        default:
+            break;
+    }
+}
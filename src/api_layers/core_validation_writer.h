@@ -0,0 +1,127 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#pragma once
+
+#include "api_dump_writer.h"
+#include "validation_utils.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Log recording information
+enum CoreValidationRecordType {
+    RECORD_NONE = 0,
+    RECORD_TEXT_COUT,
+    RECORD_TEXT_FILE,
+    RECORD_HTML_FILE,
+};
+
+// One validation message, as handed to the writer by the thread that found it.
+struct CoreValidationMessage {
+    std::chrono::steady_clock::time_point time;
+    GenValidUsageDebugSeverity severity = VALID_USAGE_DEBUG_SEVERITY_ERROR;
+    std::string message_id;
+    std::string command_name;
+    std::string message;
+    std::vector<GenValidUsageXrObjectInfo> objects;
+    std::vector<std::string> session_labels;
+};
+
+// Asynchronous text and HTML output for the core validation layer.
+//
+// Messages are queued as they are found and written through an ApiDumpWriter, whose background thread
+// formats them, timestamps included, as it drains and writes them to a file (or stdout) kept open for
+// the whole session.  Once a message ID has been written `duplicate limit` times for the same object,
+// further copies are only counted; the counts are written by ReportSuppressed() (core_validation does
+// this on xrDestroyInstance).  The debug-utils messengers are not affected, they are still called for
+// every message on the thread that found it.
+class CoreValidationWriter {
+   public:
+    static constexpr uint32_t kDefaultDuplicateLimit = 10;
+
+    CoreValidationWriter();
+    ~CoreValidationWriter();
+    CoreValidationWriter(const CoreValidationWriter&) = delete;
+    CoreValidationWriter& operator=(const CoreValidationWriter&) = delete;
+
+    // Direct output of the given type to file_name, or to stdout when it is empty, and start the
+    // background thread.  A file is truncated if `truncate` is set and appended to otherwise.  Does
+    // nothing if already open.
+    bool Open(CoreValidationRecordType type, const std::string& file_name, bool truncate);
+
+    // Write everything, then stop the background thread.  Open() may be called again afterwards.
+    void Close();
+
+    bool IsOpen() const { return writer_.IsOpen(); }
+
+    // How many times the same message ID is written for the same object; 0 writes every message.
+    void SetDuplicateLimit(uint32_t limit) { duplicate_limit_.store(limit, std::memory_order_relaxed); }
+
+    // Queue one message, unless it has been seen too often already.
+    void Append(CoreValidationMessage&& message);
+
+    // Queue a message for every message ID and object that had copies suppressed, saying how many,
+    // and start counting afresh.
+    void ReportSuppressed();
+
+    // Write everything queued so far and flush the underlying stream.
+    void Flush();
+
+    // Flush, then write `text` directly (used for the HTML header and footer).
+    void WriteDirect(const std::string& text);
+
+   private:
+    struct DuplicateCount {
+        uint64_t seen = 0;
+        GenValidUsageDebugSeverity severity = VALID_USAGE_DEBUG_SEVERITY_ERROR;
+        std::string command_name;
+        GenValidUsageXrObjectInfo object{};
+    };
+
+    // The writer's drain callback: formats the queued messages and hands them to the writer.
+    void FormatQueued();
+    void Format(const CoreValidationMessage& message);
+    const std::string& Timestamp(std::chrono::steady_clock::time_point time);
+
+    ApiDumpWriter writer_;
+    std::atomic<uint32_t> duplicate_limit_{kDefaultDuplicateLimit};
+    std::atomic<bool> wake_pending_{false};
+
+    // Protects the queue and the duplicate counts.
+    std::mutex queue_mutex_;
+    std::vector<CoreValidationMessage> queue_;
+    std::unordered_map<std::string, DuplicateCount> duplicates_;
+
+    // Only used by FormatQueued(), which the writer never runs twice at once.
+    CoreValidationRecordType type_ = RECORD_NONE;
+    std::vector<CoreValidationMessage> batch_;
+    std::string output_;
+    // Wall-clock time matching a steady-clock time, to turn the message times into dates.
+    std::chrono::system_clock::time_point wall_base_;
+    std::chrono::steady_clock::time_point steady_base_;
+    int64_t timestamp_second_ = -1;
+    std::string timestamp_date_;
+    std::string timestamp_;
+};
+
+CoreValidationWriter& GetCoreValidationWriter();
@@ -0,0 +1,553 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Times xrWaitFrame, xrBeginFrame and xrEndFrame of every session and publishes per-frame records
+// and per-session statistics to shared memory (see frame_timing_shm.h), where xr_frame_monitor can
+// watch them, and optionally to a CSV file.
+
+#include "api_dump_writer.h"
+#include "frame_timing_shm.h"
+
+#include "hex_and_handles.h"
+#include "platform_utils.hpp"
+#include "xr_generated_dispatch_table.h"
+
+#include <openxr/openxr.h>
+#include <openxr/openxr_loader_negotiation.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#if defined(XR_OS_LINUX) || defined(XR_OS_APPLE)
+#define FRAME_TIMING_USE_SHM
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __ANDROID__
+#include "android/log.h"
+#endif
+
+#if defined(__GNUC__) && __GNUC__ >= 4
+#define LAYER_EXPORT __attribute__((visibility("default")))
+#elif defined(__SUNPRO_C) && (__SUNPRO_C >= 0x590)
+#define LAYER_EXPORT __attribute__((visibility("default")))
+#elif defined(_WIN32)
+#define LAYER_EXPORT __declspec(dllexport)
+#else
+#define LAYER_EXPORT
+#endif
+
+// For routing platform_utils.hpp messages.
+void LogPlatformUtilsError(const std::string &message) {
+    (void)message;  // maybe unused
+#if !defined(NDEBUG)
+    std::cerr << message << std::endl;
+#endif
+
+#if defined(XR_OS_WINDOWS)
+    OutputDebugStringA((message + "\n").c_str());
+#elif defined(XR_OS_ANDROID)
+    __android_log_write(ANDROID_LOG_ERROR, "OpenXR-FrameTiming", message.c_str());
+#endif
+}
+
+// Histogram bin widths: 1 ms for durations, 0.25 ms for jitter.
+static constexpr uint64_t kDurationBinWidthNs = 1000000;
+static constexpr uint64_t kJitterBinWidthNs = 250000;
+// Weight of the newest frame in the moving averages is 1 / 2^kMeanShift.
+static constexpr int kMeanShift = 5;
+
+// A frame between xrWaitFrame and xrEndFrame.
+struct PendingFrame {
+    uint64_t frame_index;
+    int64_t wait_entry_ns;
+    int64_t wait_exit_ns;
+    int64_t begin_ns;  // 0 until xrBeginFrame
+    XrTime predicted_display_time;
+    XrDuration predicted_display_period;
+};
+
+struct SessionTiming {
+    // Statistics in the shared memory slot of the session, or in local_stats if there is none.
+    FrameTimingSessionStats *stats = nullptr;
+    FrameTimingSessionStats local_stats{};
+    uint32_t slot = kFrameTimingMaxSessions;
+    uint64_t frames_waited = 0;
+    std::deque<PendingFrame> pending;
+    int64_t last_wait_exit_ns = 0;
+    XrTime last_predicted_display_time = 0;
+};
+
+// The layer supports one instance at a time; a second xrCreateInstance replaces the dispatch table.
+static XrGeneratedDispatchTable *g_next_dispatch = nullptr;
+// Guards everything below.  Held only briefly, never during a call down the chain.
+static std::mutex g_timing_mutex;
+static std::unordered_map<XrSession, std::unique_ptr<SessionTiming>> g_sessions;
+static FrameTimingShm *g_shm = nullptr;
+static std::string g_shm_name;
+static bool g_csv = false;
+
+static int64_t FrameTimingNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static std::string FrameTimingSetting(const char *env_name, const char *property_name) {
+#if !defined(XR_OS_ANDROID)
+    (void)property_name;
+    return PlatformUtilsGetEnv(env_name);
+#else
+    (void)env_name;
+    return PlatformUtilsGetAndroidSystemProperty(property_name);
+#endif
+}
+
+static void FrameTimingOpenShm(const char *application_name) {
+#if defined(FRAME_TIMING_USE_SHM)
+    if (FrameTimingSetting("XR_FRAME_TIMING_SHM", "debug.frame_timing_shm") == "0") {
+        return;
+    }
+    g_shm_name = FRAME_TIMING_SHM_PREFIX + std::to_string(getpid());
+    int fd = shm_open(g_shm_name.c_str(), O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        LogPlatformUtilsError("Frame timing layer unable to create shared memory " + g_shm_name);
+        return;
+    }
+    void *memory = MAP_FAILED;
+    if (ftruncate(fd, sizeof(FrameTimingShm)) == 0) {
+        memory = mmap(nullptr, sizeof(FrameTimingShm), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (memory == MAP_FAILED) {
+        LogPlatformUtilsError("Frame timing layer unable to map shared memory " + g_shm_name);
+        shm_unlink(g_shm_name.c_str());
+        return;
+    }
+
+    // A new mapping is zero filled; the magic number is written last so a reader never sees a half
+    // initialized header.
+    g_shm = static_cast<FrameTimingShm *>(memory);
+    g_shm->version = FRAME_TIMING_SHM_VERSION;
+    g_shm->process_id = static_cast<uint32_t>(getpid());
+    g_shm->ring_size = kFrameTimingRingSize;
+    g_shm->max_sessions = kFrameTimingMaxSessions;
+    memcpy(g_shm->application_name, application_name,
+           std::min(strlen(application_name), sizeof(g_shm->application_name) - 1));
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(g_shm->magic, kFrameTimingShmMagic, sizeof(kFrameTimingShmMagic));
+#else
+    (void)application_name;
+#endif
+}
+
+static void FrameTimingCloseShm() {
+#if defined(FRAME_TIMING_USE_SHM)
+    if (g_shm != nullptr) {
+        munmap(g_shm, sizeof(FrameTimingShm));
+        shm_unlink(g_shm_name.c_str());
+        g_shm = nullptr;
+    }
+#endif
+}
+
+static void FrameTimingOpenCsv() {
+    std::string file_name = FrameTimingSetting("XR_FRAME_TIMING_CSV", "debug.frame_timing_csv");
+    if (file_name.empty()) {
+        return;
+    }
+    if (!GetApiDumpWriter().Open(file_name, true)) {
+        LogPlatformUtilsError("Frame timing layer unable to open " + file_name);
+        return;
+    }
+    GetApiDumpWriter().WriteDirect(
+        "session,frame,wait_entry_ns,wait_exit_ns,begin_ns,end_ns,predicted_display_time,predicted_display_period,"
+        "cpu_frame_ns,wait_ns,render_ns,jitter_ns,missed_frames\n");
+    g_csv = true;
+}
+
+static void FrameTimingUpdateMean(int64_t &mean, int64_t value) {
+    mean = mean == 0 ? value : mean + ((value - mean) >> kMeanShift);
+}
+
+// Caller must hold g_timing_mutex.
+static void FrameTimingInitStats(FrameTimingSessionStats &stats, XrSession session) {
+    stats.active = 1;
+    stats.session_handle = MakeHandleGeneric(session);
+    stats.frames = 0;
+    stats.missed_frames = 0;
+    stats.last_predicted_display_period = 0;
+    stats.mean_cpu_frame_ns = 0;
+    stats.mean_wait_ns = 0;
+    stats.mean_render_ns = 0;
+    stats.mean_abs_jitter_ns = 0;
+    for (FrameTimingHistogram *histogram : {&stats.cpu_frame, &stats.wait, &stats.render}) {
+        memset(histogram->bins, 0, sizeof(histogram->bins));
+        histogram->bin_width_ns = kDurationBinWidthNs;
+    }
+    memset(stats.abs_jitter.bins, 0, sizeof(stats.abs_jitter.bins));
+    stats.abs_jitter.bin_width_ns = kJitterBinWidthNs;
+}
+
+// Account for a frame that reached xrEndFrame.  Caller must hold g_timing_mutex.
+static void FrameTimingCompleteFrame(XrSession session, SessionTiming &timing, const PendingFrame &frame, int64_t end_ns) {
+    const int64_t cpu_frame_ns = end_ns - frame.wait_exit_ns;
+    const int64_t wait_ns = frame.wait_exit_ns - frame.wait_entry_ns;
+    const int64_t render_ns = frame.begin_ns != 0 ? end_ns - frame.begin_ns : 0;
+
+    int64_t jitter_ns = 0;
+    if (timing.last_wait_exit_ns != 0 && frame.predicted_display_period > 0) {
+        jitter_ns = (frame.wait_exit_ns - timing.last_wait_exit_ns) - frame.predicted_display_period;
+    }
+    timing.last_wait_exit_ns = frame.wait_exit_ns;
+
+    // The runtime's display times step by one period per displayed frame, so a larger step means the
+    // application missed frames in between.
+    uint32_t missed_frames = 0;
+    if (timing.last_predicted_display_time != 0 && frame.predicted_display_period > 0) {
+        const XrDuration step = frame.predicted_display_time - timing.last_predicted_display_time;
+        const int64_t periods = (step + frame.predicted_display_period / 2) / frame.predicted_display_period;
+        if (periods > 1) {
+            missed_frames = static_cast<uint32_t>(periods - 1);
+        }
+    }
+    timing.last_predicted_display_time = frame.predicted_display_time;
+
+    FrameTimingSessionStats &stats = *timing.stats;
+    FrameTimingBeginWrite(stats.sequence);
+    stats.frames++;
+    stats.missed_frames += missed_frames;
+    stats.last_predicted_display_period = frame.predicted_display_period;
+    FrameTimingUpdateMean(stats.mean_cpu_frame_ns, cpu_frame_ns);
+    FrameTimingUpdateMean(stats.mean_wait_ns, wait_ns);
+    FrameTimingUpdateMean(stats.mean_render_ns, render_ns);
+    FrameTimingUpdateMean(stats.mean_abs_jitter_ns, jitter_ns < 0 ? -jitter_ns : jitter_ns);
+    FrameTimingHistogramAdd(stats.cpu_frame, cpu_frame_ns);
+    FrameTimingHistogramAdd(stats.wait, wait_ns);
+    FrameTimingHistogramAdd(stats.render, render_ns);
+    FrameTimingHistogramAdd(stats.abs_jitter, jitter_ns < 0 ? -jitter_ns : jitter_ns);
+    FrameTimingEndWrite(stats.sequence);
+
+    if (g_shm != nullptr) {
+        const uint64_t index = g_shm->records_written.load(std::memory_order_relaxed);
+        FrameTimingRecord &record = g_shm->ring[index & (kFrameTimingRingSize - 1)];
+        FrameTimingBeginWrite(record.sequence);
+        record.session_slot = timing.slot;
+        record.missed_frames = missed_frames;
+        record.frame_index = frame.frame_index;
+        record.wait_entry_ns = frame.wait_entry_ns;
+        record.wait_exit_ns = frame.wait_exit_ns;
+        record.begin_ns = frame.begin_ns;
+        record.end_ns = end_ns;
+        record.predicted_display_time = frame.predicted_display_time;
+        record.predicted_display_period = frame.predicted_display_period;
+        record.jitter_ns = jitter_ns;
+        FrameTimingEndWrite(record.sequence);
+        g_shm->records_written.store(index + 1, std::memory_order_release);
+    }
+
+    if (g_csv) {
+        std::string row = HandleToHexString(session);
+        for (int64_t value : {static_cast<int64_t>(frame.frame_index), frame.wait_entry_ns, frame.wait_exit_ns, frame.begin_ns,
+                              end_ns, static_cast<int64_t>(frame.predicted_display_time),
+                              static_cast<int64_t>(frame.predicted_display_period), cpu_frame_ns, wait_ns, render_ns, jitter_ns,
+                              static_cast<int64_t>(missed_frames)}) {
+            row += ',';
+            row += std::to_string(value);
+        }
+        row += '\n';
+        GetApiDumpWriter().Append(row);
+    }
+}
+
+PFN_xrVoidFunction FrameTimingLayerInnerGetInstanceProcAddr(const char *name);
+
+XRAPI_ATTR XrResult XRAPI_CALL FrameTimingLayerXrDestroyInstance(XrInstance instance) {
+    XrGeneratedDispatchTable *next_dispatch = g_next_dispatch;
+    XrResult result = next_dispatch->DestroyInstance(instance);
+
+    {
+        std::unique_lock<std::mutex> lock(g_timing_mutex);
+        g_sessions.clear();
+        FrameTimingCloseShm();
+        if (g_csv) {
+            GetApiDumpWriter().Close();
+            g_csv = false;
+        }
+    }
+
+    g_next_dispatch = nullptr;
+    delete next_dispatch;
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL FrameTimingLayerXrCreateSession(XrInstance instance, const XrSessionCreateInfo *createInfo,
+                                                               XrSession *session) {
+    XrResult result = g_next_dispatch->CreateSession(instance, createInfo, session);
+    if (XR_SUCCEEDED(result)) {
+        std::unique_lock<std::mutex> lock(g_timing_mutex);
+        std::unique_ptr<SessionTiming> timing(new SessionTiming());
+        timing->stats = &timing->local_stats;
+        if (g_shm != nullptr) {
+            for (uint32_t slot = 0; slot < kFrameTimingMaxSessions; ++slot) {
+                if (g_shm->sessions[slot].active == 0) {
+                    timing->slot = slot;
+                    timing->stats = &g_shm->sessions[slot];
+                    break;
+                }
+            }
+        }
+        FrameTimingBeginWrite(timing->stats->sequence);
+        FrameTimingInitStats(*timing->stats, *session);
+        FrameTimingEndWrite(timing->stats->sequence);
+        g_sessions[*session] = std::move(timing);
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL FrameTimingLayerXrDestroySession(XrSession session) {
+    XrResult result = g_next_dispatch->DestroySession(session);
+    if (XR_SUCCEEDED(result)) {
+        std::unique_lock<std::mutex> lock(g_timing_mutex);
+        auto it = g_sessions.find(session);
+        if (it != g_sessions.end()) {
+            // The statistics stay readable until the slot is reused.
+            FrameTimingSessionStats &stats = *it->second->stats;
+            FrameTimingBeginWrite(stats.sequence);
+            stats.active = 0;
+            FrameTimingEndWrite(stats.sequence);
+            g_sessions.erase(it);
+        }
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL FrameTimingLayerXrWaitFrame(XrSession session, const XrFrameWaitInfo *frameWaitInfo,
+                                                           XrFrameState *frameState) {
+    const int64_t wait_entry_ns = FrameTimingNowNs();
+    XrResult result = g_next_dispatch->WaitFrame(session, frameWaitInfo, frameState);
+    const int64_t wait_exit_ns = FrameTimingNowNs();
+
+    if (XR_SUCCEEDED(result)) {
+        std::unique_lock<std::mutex> lock(g_timing_mutex);
+        auto it = g_sessions.find(session);
+        if (it != g_sessions.end()) {
+            SessionTiming &timing = *it->second;
+            PendingFrame frame{};
+            frame.frame_index = ++timing.frames_waited;
+            frame.wait_entry_ns = wait_entry_ns;
+            frame.wait_exit_ns = wait_exit_ns;
+            frame.predicted_display_time = frameState->predictedDisplayTime;
+            frame.predicted_display_period = frameState->predictedDisplayPeriod;
+            timing.pending.push_back(frame);
+            // An application that keeps calling xrWaitFrame without ending frames has abandoned them.
+            if (timing.pending.size() > 4) {
+                timing.pending.pop_front();
+            }
+        }
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL FrameTimingLayerXrBeginFrame(XrSession session, const XrFrameBeginInfo *frameBeginInfo) {
+    const int64_t begin_ns = FrameTimingNowNs();
+    XrResult result = g_next_dispatch->BeginFrame(session, frameBeginInfo);
+
+    if (XR_SUCCEEDED(result)) {
+        std::unique_lock<std::mutex> lock(g_timing_mutex);
+        auto it = g_sessions.find(session);
+        if (it != g_sessions.end()) {
+            // xrBeginFrame belongs to the oldest waited frame that has not begun.  XR_FRAME_DISCARDED means
+            // the frame before it was never ended.
+            std::deque<PendingFrame> &pending = it->second->pending;
+            if (result == XR_FRAME_DISCARDED) {
+                while (!pending.empty() && pending.front().begin_ns != 0) {
+                    pending.pop_front();
+                }
+            }
+            for (PendingFrame &frame : pending) {
+                if (frame.begin_ns == 0) {
+                    frame.begin_ns = begin_ns;
+                    break;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL FrameTimingLayerXrEndFrame(XrSession session, const XrFrameEndInfo *frameEndInfo) {
+    const int64_t end_ns = FrameTimingNowNs();
+    XrResult result = g_next_dispatch->EndFrame(session, frameEndInfo);
+
+    if (XR_SUCCEEDED(result)) {
+        std::unique_lock<std::mutex> lock(g_timing_mutex);
+        auto it = g_sessions.find(session);
+        if (it != g_sessions.end() && !it->second->pending.empty() && it->second->pending.front().begin_ns != 0) {
+            SessionTiming &timing = *it->second;
+            FrameTimingCompleteFrame(session, timing, timing.pending.front(), end_ns);
+            timing.pending.pop_front();
+        }
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL FrameTimingLayerXrGetInstanceProcAddr(XrInstance instance, const char *name,
+                                                                     PFN_xrVoidFunction *function) {
+    try {
+        *function = FrameTimingLayerInnerGetInstanceProcAddr(name);
+
+        if (*function != nullptr) {
+            return XR_SUCCESS;
+        }
+
+        // We have not found it, so pass it down to the next layer/runtime
+        if (nullptr == g_next_dispatch) {
+            return XR_ERROR_HANDLE_INVALID;
+        }
+        return g_next_dispatch->GetInstanceProcAddr(instance, name, function);
+    } catch (...) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL FrameTimingLayerXrCreateApiLayerInstance(const XrInstanceCreateInfo *info,
+                                                                        const struct XrApiLayerCreateInfo *apiLayerInfo,
+                                                                        XrInstance *instance) {
+    try {
+        XrApiLayerCreateInfo new_api_layer_info = {};
+
+        // Validate the API layer info and next API layer info structures before we try to use them
+        if (nullptr == apiLayerInfo || XR_LOADER_INTERFACE_STRUCT_API_LAYER_CREATE_INFO != apiLayerInfo->structType ||
+            XR_API_LAYER_CREATE_INFO_STRUCT_VERSION > apiLayerInfo->structVersion ||
+            sizeof(XrApiLayerCreateInfo) > apiLayerInfo->structSize || nullptr == apiLayerInfo->nextInfo ||
+            XR_LOADER_INTERFACE_STRUCT_API_LAYER_NEXT_INFO != apiLayerInfo->nextInfo->structType ||
+            XR_API_LAYER_NEXT_INFO_STRUCT_VERSION > apiLayerInfo->nextInfo->structVersion ||
+            sizeof(XrApiLayerNextInfo) > apiLayerInfo->nextInfo->structSize ||
+            0 != strcmp("XR_APILAYER_KHRONOS_frame_timing", apiLayerInfo->nextInfo->layerName) ||
+            nullptr == apiLayerInfo->nextInfo->nextGetInstanceProcAddr ||
+            nullptr == apiLayerInfo->nextInfo->nextCreateApiLayerInstance) {
+            return XR_ERROR_INITIALIZATION_FAILED;
+        }
+
+        // Copy the contents of the layer info struct, but then move the next info up by
+        // one slot so that the next layer gets information.
+        memcpy(&new_api_layer_info, apiLayerInfo, sizeof(XrApiLayerCreateInfo));
+        new_api_layer_info.nextInfo = apiLayerInfo->nextInfo->next;
+
+        // Get the function pointers we need
+        PFN_xrGetInstanceProcAddr next_get_instance_proc_addr = apiLayerInfo->nextInfo->nextGetInstanceProcAddr;
+        PFN_xrCreateApiLayerInstance next_create_api_layer_instance = apiLayerInfo->nextInfo->nextCreateApiLayerInstance;
+
+        // Create the instance using the layer create instance command for the next layer
+        XrInstance returned_instance = *instance;
+        XrResult result = next_create_api_layer_instance(info, &new_api_layer_info, &returned_instance);
+        *instance = returned_instance;
+
+        if (XR_SUCCEEDED(result)) {
+            // Create the dispatch table to the next levels
+            auto *next_dispatch = new XrGeneratedDispatchTable();
+            GeneratedXrPopulateDispatchTable(next_dispatch, returned_instance, next_get_instance_proc_addr);
+            delete g_next_dispatch;
+            g_next_dispatch = next_dispatch;
+
+            std::unique_lock<std::mutex> lock(g_timing_mutex);
+            if (g_shm == nullptr) {
+                FrameTimingOpenShm(info->applicationInfo.applicationName);
+            }
+            if (!g_csv) {
+                FrameTimingOpenCsv();
+            }
+        }
+
+        return result;
+    } catch (...) {
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+}
+
+// Function used to negotiate an interface betewen the loader and an API layer.  Each library exposing one or
+// more API layers needs to expose at least this function.
+extern "C" LAYER_EXPORT XRAPI_ATTR XrResult XRAPI_CALL xrNegotiateLoaderApiLayerInterface(
+    const XrNegotiateLoaderInfo *loaderInfo, const char * /*apiLayerName*/, XrNegotiateApiLayerRequest *apiLayerRequest) {
+    if (loaderInfo == nullptr || loaderInfo->structType != XR_LOADER_INTERFACE_STRUCT_LOADER_INFO ||
+        loaderInfo->structVersion != XR_LOADER_INFO_STRUCT_VERSION || loaderInfo->structSize != sizeof(XrNegotiateLoaderInfo)) {
+        LogPlatformUtilsError("loaderInfo struct is not valid");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (loaderInfo->minInterfaceVersion > XR_CURRENT_LOADER_API_LAYER_VERSION ||
+        loaderInfo->maxInterfaceVersion < XR_CURRENT_LOADER_API_LAYER_VERSION) {
+        LogPlatformUtilsError("loader interface version is not in the range [minInterfaceVersion, maxInterfaceVersion]");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (loaderInfo->minApiVersion > XR_CURRENT_API_VERSION || loaderInfo->maxApiVersion < XR_CURRENT_API_VERSION) {
+        LogPlatformUtilsError("loader api version is not in the range [minApiVersion, maxApiVersion]");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (apiLayerRequest == nullptr || apiLayerRequest->structType != XR_LOADER_INTERFACE_STRUCT_API_LAYER_REQUEST ||
+        apiLayerRequest->structVersion != XR_API_LAYER_INFO_STRUCT_VERSION ||
+        apiLayerRequest->structSize != sizeof(XrNegotiateApiLayerRequest)) {
+        LogPlatformUtilsError("apiLayerRequest is not valid");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    apiLayerRequest->layerInterfaceVersion = XR_CURRENT_LOADER_API_LAYER_VERSION;
+    apiLayerRequest->layerApiVersion = XR_CURRENT_API_VERSION;
+    apiLayerRequest->getInstanceProcAddr = FrameTimingLayerXrGetInstanceProcAddr;
+    apiLayerRequest->createApiLayerInstance = FrameTimingLayerXrCreateApiLayerInstance;
+
+    return XR_SUCCESS;
+}
+
+PFN_xrVoidFunction FrameTimingLayerInnerGetInstanceProcAddr(const char *name) {
+    std::string func_name = name;
+
+    if (func_name == "xrGetInstanceProcAddr") {
+        return reinterpret_cast<PFN_xrVoidFunction>(FrameTimingLayerXrGetInstanceProcAddr);
+    }
+    if (func_name == "xrDestroyInstance") {
+        return reinterpret_cast<PFN_xrVoidFunction>(FrameTimingLayerXrDestroyInstance);
+    }
+    if (func_name == "xrCreateSession") {
+        return reinterpret_cast<PFN_xrVoidFunction>(FrameTimingLayerXrCreateSession);
+    }
+    if (func_name == "xrDestroySession") {
+        return reinterpret_cast<PFN_xrVoidFunction>(FrameTimingLayerXrDestroySession);
+    }
+    if (func_name == "xrWaitFrame") {
+        return reinterpret_cast<PFN_xrVoidFunction>(FrameTimingLayerXrWaitFrame);
+    }
+    if (func_name == "xrBeginFrame") {
+        return reinterpret_cast<PFN_xrVoidFunction>(FrameTimingLayerXrBeginFrame);
+    }
+    if (func_name == "xrEndFrame") {
+        return reinterpret_cast<PFN_xrVoidFunction>(FrameTimingLayerXrEndFrame);
+    }
+    return nullptr;
+}
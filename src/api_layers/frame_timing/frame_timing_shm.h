@@ -0,0 +1,130 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Layout of the shared memory block the frame timing layer publishes and xr_frame_monitor reads.
+//
+// The block is named FRAME_TIMING_SHM_PREFIX followed by the process id of the application.  It
+// holds the statistics of up to kFrameTimingMaxSessions sessions and a ring with the timings of the
+// most recent kFrameTimingRingSize frames of all sessions.  Each session slot and each ring entry
+// is written by one thread at a time and guarded by a sequence counter: the counter is odd while
+// the entry is being written, so a reader copies the entry and retries if the counter was odd or
+// changed in the meantime.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#define FRAME_TIMING_SHM_PREFIX "/openxr_frame_timing."
+#define FRAME_TIMING_SHM_VERSION 1
+
+static const char kFrameTimingShmMagic[8] = {'X', 'R', 'F', 'T', 'I', 'M', 'E', '\0'};
+
+static constexpr uint32_t kFrameTimingMaxSessions = 4;
+static constexpr uint32_t kFrameTimingRingSize = 1024;  // must be a power of two
+static constexpr uint32_t kFrameTimingHistogramBins = 40;
+
+static_assert((kFrameTimingRingSize & (kFrameTimingRingSize - 1)) == 0, "ring size must be a power of two");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared memory counters must be lock free");
+
+// Times are in nanoseconds.  Layer timestamps come from the steady clock of the application process;
+// predicted display times and periods are the XrTime and XrDuration values returned by the runtime.
+struct FrameTimingRecord {
+    std::atomic<uint64_t> sequence;
+    uint32_t session_slot;
+    uint32_t missed_frames;     // frames the runtime displayed between the previous frame and this one
+    uint64_t frame_index;       // per session, starting at 1
+    int64_t wait_entry_ns;      // xrWaitFrame called
+    int64_t wait_exit_ns;       // xrWaitFrame returned
+    int64_t begin_ns;           // xrBeginFrame called
+    int64_t end_ns;             // xrEndFrame called
+    int64_t predicted_display_time;
+    int64_t predicted_display_period;
+    int64_t jitter_ns;          // wait_exit_ns interval minus predicted_display_period; 0 for the first frame
+};
+
+// Bin i counts values in [i * bin_width_ns, (i + 1) * bin_width_ns); the last bin also counts larger values.
+struct FrameTimingHistogram {
+    uint64_t bin_width_ns;
+    uint64_t bins[kFrameTimingHistogramBins];
+};
+
+struct FrameTimingSessionStats {
+    std::atomic<uint64_t> sequence;
+    uint32_t active;  // 0 once the session is destroyed
+    uint32_t reserved;
+    uint64_t session_handle;
+    uint64_t frames;
+    uint64_t missed_frames;
+    int64_t last_predicted_display_period;
+    // Exponential moving averages over roughly the last 32 frames.
+    int64_t mean_cpu_frame_ns;  // xrWaitFrame returned to xrEndFrame called
+    int64_t mean_wait_ns;       // xrWaitFrame called to xrWaitFrame returned
+    int64_t mean_render_ns;     // xrBeginFrame called to xrEndFrame called
+    int64_t mean_abs_jitter_ns;
+    // Since the session was created.
+    FrameTimingHistogram cpu_frame;
+    FrameTimingHistogram wait;
+    FrameTimingHistogram render;
+    FrameTimingHistogram abs_jitter;
+};
+
+struct FrameTimingShm {
+    char magic[8];
+    uint32_t version;
+    uint32_t process_id;
+    uint32_t ring_size;
+    uint32_t max_sessions;
+    char application_name[128];
+    // Number of records ever written to the ring; record n is in ring[n % ring_size].
+    std::atomic<uint64_t> records_written;
+    FrameTimingSessionStats sessions[kFrameTimingMaxSessions];
+    FrameTimingRecord ring[kFrameTimingRingSize];
+};
+
+// Writer side of the sequence counter: call before and after changing the guarded entry.
+inline void FrameTimingBeginWrite(std::atomic<uint64_t> &sequence) {
+    sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+inline void FrameTimingEndWrite(std::atomic<uint64_t> &sequence) {
+    sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// Reader side: copy `source` (everything after its sequence counter) to `copy`.  Returns false if the
+// entry was being written and the copy is torn.
+template <typename T>
+bool FrameTimingRead(const T &source, T &copy) {
+    const uint64_t before = source.sequence.load(std::memory_order_acquire);
+    if ((before & 1) != 0) {
+        return false;
+    }
+    const size_t offset = sizeof(std::atomic<uint64_t>);
+    memcpy(reinterpret_cast<char *>(&copy) + offset, reinterpret_cast<const char *>(&source) + offset, sizeof(T) - offset);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return source.sequence.load(std::memory_order_relaxed) == before;
+}
+
+inline void FrameTimingHistogramAdd(FrameTimingHistogram &histogram, int64_t value_ns) {
+    uint64_t bin = value_ns <= 0 ? 0 : static_cast<uint64_t>(value_ns) / histogram.bin_width_ns;
+    if (bin >= kFrameTimingHistogramBins) {
+        bin = kFrameTimingHistogramBins - 1;
+    }
+    histogram.bins[bin]++;
+}
@@ -0,0 +1,314 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Watches the shared memory published by the frame timing layer in a running application and prints
+// the frame timing of each of its sessions at a fixed interval.
+
+#include "frame_timing_shm.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+void PrintUsage() {
+    std::cerr << "Usage: xr_frame_monitor [--interval-ms N] [--count N] [--histograms] [pid]\n"
+              << "  Prints the frame timing of an application running with XR_APILAYER_KHRONOS_frame_timing.\n"
+              << "  Without a pid, the only such application running is watched; if there are several, they are listed.\n"
+              << "  --interval-ms N  time between reports, 1000 by default\n"
+              << "  --count N        stop after N reports\n"
+              << "  --histograms     also print the histograms since each session started\n";
+}
+
+// The shared memory of one application, mapped read only.
+class SharedTiming {
+   public:
+    ~SharedTiming() {
+        if (shm_ != nullptr) {
+            munmap(const_cast<FrameTimingShm*>(shm_), sizeof(FrameTimingShm));
+        }
+    }
+
+    bool Open(uint32_t pid) {
+        const std::string name = FRAME_TIMING_SHM_PREFIX + std::to_string(pid);
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info {};
+        void* memory = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(FrameTimingShm)) {
+            memory = mmap(nullptr, sizeof(FrameTimingShm), PROT_READ, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (memory == MAP_FAILED) {
+            return false;
+        }
+        shm_ = static_cast<const FrameTimingShm*>(memory);
+        if (memcmp(shm_->magic, kFrameTimingShmMagic, sizeof(kFrameTimingShmMagic)) != 0 ||
+            shm_->version != FRAME_TIMING_SHM_VERSION) {
+            std::cerr << name << " was not written by a compatible frame timing layer\n";
+            return false;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return true;
+    }
+
+    const FrameTimingShm& Get() const { return *shm_; }
+
+   private:
+    const FrameTimingShm* shm_ = nullptr;
+};
+
+std::vector<uint32_t> FindApplications() {
+    std::vector<uint32_t> pids;
+#if defined(__linux__)
+    const std::string prefix = std::string(FRAME_TIMING_SHM_PREFIX).substr(1);
+    DIR* dir = opendir("/dev/shm");
+    if (dir == nullptr) {
+        return pids;
+    }
+    while (dirent* entry = readdir(dir)) {
+        const std::string name = entry->d_name;
+        if (name.compare(0, prefix.size(), prefix) == 0) {
+            const uint32_t pid = static_cast<uint32_t>(strtoul(name.c_str() + prefix.size(), nullptr, 10));
+            // Skip what an application that crashed left behind.
+            if (pid != 0 && kill(static_cast<pid_t>(pid), 0) == 0) {
+                pids.push_back(pid);
+            }
+        }
+    }
+    closedir(dir);
+    std::sort(pids.begin(), pids.end());
+#endif
+    return pids;
+}
+
+struct Summary {
+    double mean_ms = 0;
+    double p50_ms = 0;
+    double p99_ms = 0;
+};
+
+Summary Summarize(std::vector<int64_t>& values_ns) {
+    Summary summary;
+    if (values_ns.empty()) {
+        return summary;
+    }
+    int64_t sum = 0;
+    for (int64_t value : values_ns) {
+        sum += value;
+    }
+    summary.mean_ms = static_cast<double>(sum) / static_cast<double>(values_ns.size()) / 1e6;
+    std::sort(values_ns.begin(), values_ns.end());
+    summary.p50_ms = static_cast<double>(values_ns[values_ns.size() / 2]) / 1e6;
+    summary.p99_ms = static_cast<double>(values_ns[std::min(values_ns.size() - 1, values_ns.size() * 99 / 100)]) / 1e6;
+    return summary;
+}
+
+// The frames of one session read from the ring during one interval.
+struct IntervalFrames {
+    std::vector<int64_t> cpu_frame_ns;
+    std::vector<int64_t> wait_ns;
+    std::vector<int64_t> render_ns;
+    std::vector<int64_t> abs_jitter_ns;
+    uint64_t missed_frames = 0;
+
+    void Clear() {
+        cpu_frame_ns.clear();
+        wait_ns.clear();
+        render_ns.clear();
+        abs_jitter_ns.clear();
+        missed_frames = 0;
+    }
+};
+
+void PrintHistogram(const char* name, const FrameTimingHistogram& histogram) {
+    uint64_t total = 0;
+    uint64_t largest = 0;
+    uint32_t last_bin = 0;
+    for (uint32_t bin = 0; bin < kFrameTimingHistogramBins; ++bin) {
+        total += histogram.bins[bin];
+        largest = std::max(largest, histogram.bins[bin]);
+        if (histogram.bins[bin] != 0) {
+            last_bin = bin;
+        }
+    }
+    printf("    %s (%" PRIu64 " frames)\n", name, total);
+    if (total == 0) {
+        return;
+    }
+    for (uint32_t bin = 0; bin <= last_bin; ++bin) {
+        const double low_ms = static_cast<double>(bin * histogram.bin_width_ns) / 1e6;
+        const int width = static_cast<int>(histogram.bins[bin] * 50 / largest);
+        printf("    %7.2f%s ms %10" PRIu64 " %s\n", low_ms, bin + 1 == kFrameTimingHistogramBins ? "+" : " ", histogram.bins[bin],
+               std::string(static_cast<size_t>(width), '#').c_str());
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t interval_ms = 1000;
+    uint64_t count = 0;
+    bool histograms = false;
+    uint32_t pid = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--interval-ms" && i + 1 < argc) {
+            interval_ms = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--count" && i + 1 < argc) {
+            count = strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--histograms") {
+            histograms = true;
+        } else if (arg == "--help" || arg == "-h") {
+            PrintUsage();
+            return 0;
+        } else if (!arg.empty() && arg[0] != '-' && pid == 0) {
+            pid = static_cast<uint32_t>(strtoul(arg.c_str(), nullptr, 10));
+        } else {
+            std::cerr << "Unknown option " << arg << "\n";
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (interval_ms == 0) {
+        interval_ms = 1;
+    }
+
+    if (pid == 0) {
+        std::vector<uint32_t> pids = FindApplications();
+        if (pids.empty()) {
+            std::cerr << "No application with the frame timing layer found, pass its pid\n";
+            return 1;
+        }
+        if (pids.size() > 1) {
+            std::cout << "Applications with the frame timing layer:\n";
+            for (uint32_t candidate : pids) {
+                SharedTiming timing;
+                if (timing.Open(candidate)) {
+                    std::cout << "  " << candidate << " " << timing.Get().application_name << "\n";
+                }
+            }
+            return 0;
+        }
+        pid = pids[0];
+    }
+
+    SharedTiming timing;
+    if (!timing.Open(pid)) {
+        std::cerr << "Unable to open the frame timing of process " << pid << "\n";
+        return 1;
+    }
+    const FrameTimingShm& shm = timing.Get();
+    printf("Watching %s (pid %" PRIu32 ")\n", shm.application_name, pid);
+
+    IntervalFrames frames[kFrameTimingMaxSessions];
+    uint64_t previous_frames[kFrameTimingMaxSessions] = {};
+    for (uint32_t slot = 0; slot < kFrameTimingMaxSessions; ++slot) {
+        FrameTimingSessionStats stats;
+        if (FrameTimingRead(shm.sessions[slot], stats) && stats.active != 0) {
+            previous_frames[slot] = stats.frames;
+        }
+    }
+    uint64_t next_record = shm.records_written.load(std::memory_order_acquire);
+    auto previous_time = std::chrono::steady_clock::now();
+    for (uint64_t report = 0; count == 0 || report < count; ++report) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+        if (kill(static_cast<pid_t>(pid), 0) != 0) {
+            std::cout << "Process " << pid << " exited\n";
+            break;
+        }
+
+        // Read the frames completed since the last report; if more than a ring's worth were written,
+        // the oldest are gone.
+        const uint64_t written = shm.records_written.load(std::memory_order_acquire);
+        if (written - next_record > kFrameTimingRingSize) {
+            next_record = written - kFrameTimingRingSize;
+        }
+        for (IntervalFrames& session_frames : frames) {
+            session_frames.Clear();
+        }
+        for (; next_record < written; ++next_record) {
+            FrameTimingRecord record;
+            if (!FrameTimingRead(shm.ring[next_record & (kFrameTimingRingSize - 1)], record) ||
+                record.session_slot >= kFrameTimingMaxSessions) {
+                continue;
+            }
+            IntervalFrames& session_frames = frames[record.session_slot];
+            session_frames.cpu_frame_ns.push_back(record.end_ns - record.wait_exit_ns);
+            session_frames.wait_ns.push_back(record.wait_exit_ns - record.wait_entry_ns);
+            session_frames.render_ns.push_back(record.begin_ns != 0 ? record.end_ns - record.begin_ns : 0);
+            session_frames.abs_jitter_ns.push_back(record.jitter_ns < 0 ? -record.jitter_ns : record.jitter_ns);
+            session_frames.missed_frames += record.missed_frames;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        const double seconds = std::chrono::duration<double>(now - previous_time).count();
+        previous_time = now;
+
+        printf("\n%-18s %7s %8s %7s %21s %21s %21s %21s\n", "session", "fps", "frames", "missed", "cpu frame ms mean/p50/p99",
+               "wait ms mean/p50/p99", "render ms mean/p50/p99", "|jitter| ms mean/p50/p99");
+        for (uint32_t slot = 0; slot < kFrameTimingMaxSessions; ++slot) {
+            FrameTimingSessionStats stats;
+            bool read = false;
+            for (int attempt = 0; attempt < 100 && !read; ++attempt) {
+                read = FrameTimingRead(shm.sessions[slot], stats);
+            }
+            if (!read || stats.active == 0) {
+                previous_frames[slot] = 0;
+                continue;
+            }
+            const double fps = static_cast<double>(stats.frames - std::min(stats.frames, previous_frames[slot])) / seconds;
+            previous_frames[slot] = stats.frames;
+
+            IntervalFrames& session_frames = frames[slot];
+            const Summary cpu = Summarize(session_frames.cpu_frame_ns);
+            const Summary wait = Summarize(session_frames.wait_ns);
+            const Summary render = Summarize(session_frames.render_ns);
+            const Summary jitter = Summarize(session_frames.abs_jitter_ns);
+            printf("0x%016" PRIx64 " %7.1f %8" PRIu64 " %7" PRIu64 " %6.2f/%6.2f/%7.2f %6.2f/%6.2f/%7.2f %6.2f/%6.2f/%7.2f %6.2f/%6.2f/%7.2f\n",
+                   stats.session_handle, fps, stats.frames, stats.missed_frames, cpu.mean_ms, cpu.p50_ms, cpu.p99_ms, wait.mean_ms,
+                   wait.p50_ms, wait.p99_ms, render.mean_ms, render.p50_ms, render.p99_ms, jitter.mean_ms, jitter.p50_ms,
+                   jitter.p99_ms);
+            if (histograms) {
+                PrintHistogram("cpu frame", stats.cpu_frame);
+                PrintHistogram("wait", stats.wait);
+                PrintHistogram("render", stats.render);
+                PrintHistogram("|jitter|", stats.abs_jitter);
+            }
+        }
+        fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,605 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Answers repeated xrLocateSpace calls within a frame from a cache, and fills the cache with one
+// xrLocateSpaces call for the spaces the application located in the previous frame.
+//
+// A frame starts when xrWaitFrame returns.  Within a frame, the location of a space relative to a base
+// space at a given time is only asked for once; later calls with the same (space, baseSpace, time) are
+// answered from the cache.  When xrLocateSpaces is available (OpenXR 1.1 or XR_KHR_locate_spaces), the
+// first xrLocateSpace of a frame for a base space and time locates, in one call, every space that was
+// located against that base space in the previous frame.  xrSyncActions clears the cache, as it may
+// change what action spaces are bound to.  Until the first xrWaitFrame of a session every call is passed
+// through.
+
+#include "platform_utils.hpp"
+#include "xr_generated_dispatch_table.h"
+
+#include <openxr/openxr.h>
+#include <openxr/openxr_loader_negotiation.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef __ANDROID__
+#include "android/log.h"
+#endif
+
+#if defined(__GNUC__) && __GNUC__ >= 4
+#define LAYER_EXPORT __attribute__((visibility("default")))
+#elif defined(__SUNPRO_C) && (__SUNPRO_C >= 0x590)
+#define LAYER_EXPORT __attribute__((visibility("default")))
+#elif defined(_WIN32)
+#define LAYER_EXPORT __declspec(dllexport)
+#else
+#define LAYER_EXPORT
+#endif
+
+// For routing platform_utils.hpp messages.
+void LogPlatformUtilsError(const std::string &message) {
+    (void)message;  // maybe unused
+#if !defined(NDEBUG)
+    std::cerr << message << std::endl;
+#endif
+
+#if defined(XR_OS_WINDOWS)
+    OutputDebugStringA((message + "\n").c_str());
+#elif defined(XR_OS_ANDROID)
+    __android_log_write(ANDROID_LOG_ERROR, "OpenXR-SpaceCache", message.c_str());
+#endif
+}
+
+struct LocateKey {
+    XrSpace space;
+    XrSpace base_space;
+    XrTime time;
+
+    bool operator==(const LocateKey &other) const {
+        return space == other.space && base_space == other.base_space && time == other.time;
+    }
+};
+
+struct CachedLocation {
+    LocateKey key;
+    XrSpaceLocationFlags location_flags;
+    XrPosef pose;
+    bool has_velocity;
+    XrSpaceVelocityFlags velocity_flags;
+    XrVector3f linear_velocity;
+    XrVector3f angular_velocity;
+};
+
+struct LocatedSpace {
+    XrSpace space;
+    bool velocity;
+};
+
+struct SessionCache {
+    XrSession session = XR_NULL_HANDLE;
+    // Set once xrWaitFrame has returned; nothing is cached before that.
+    bool frame_started = false;
+    // Changes whenever the cache is cleared, so results of calls that started before are not stored.
+    uint64_t generation = 0;
+    // A frame locates a handful of spaces, so a linear search beats hashing, and the vector keeps its
+    // storage from one frame to the next.
+    std::vector<CachedLocation> locations;
+    // Spaces located against each base space in this frame and in the previous one.
+    std::unordered_map<XrSpace, std::vector<LocatedSpace>> located;
+    std::unordered_map<XrSpace, std::vector<LocatedSpace>> previously_located;
+    // (base space, time) pairs already prefetched since the cache was last cleared.
+    std::vector<std::pair<XrSpace, XrTime>> prefetched;
+    // Held shared while a prefetch locates spaces the application did not pass to the call, and
+    // exclusively by xrDestroySpace, so that no space is destroyed while a prefetch still uses it.
+    std::shared_mutex prefetch_mutex;
+
+    CachedLocation *Find(const LocateKey &key) {
+        for (CachedLocation &entry : locations) {
+            if (entry.key == key) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    CachedLocation &FindOrAdd(const LocateKey &key) {
+        CachedLocation *entry = Find(key);
+        if (entry == nullptr) {
+            locations.push_back(CachedLocation{key});
+            entry = &locations.back();
+        }
+        return *entry;
+    }
+
+    void Clear() {
+        locations.clear();
+        prefetched.clear();
+        generation++;
+    }
+};
+
+// The layer supports one instance at a time; a second xrCreateInstance replaces the dispatch table.
+static XrGeneratedDispatchTable *g_next_dispatch = nullptr;
+// xrLocateSpaces or xrLocateSpacesKHR of the instance, or nullptr if neither is available or prefetching is off.
+static PFN_xrLocateSpaces g_locate_spaces = nullptr;
+// Guards everything below.  Held only briefly, never during a call down the chain.
+static std::mutex g_cache_mutex;
+static std::unordered_map<XrSession, std::unique_ptr<SessionCache>> g_sessions;
+static std::unordered_map<XrSpace, SessionCache *> g_spaces;
+
+static void CacheLocation(SessionCache &cache, const LocateKey &key, const XrSpaceLocation &location,
+                          const XrSpaceVelocity *velocity) {
+    CachedLocation &entry = cache.FindOrAdd(key);
+    entry.location_flags = location.locationFlags;
+    entry.pose = location.pose;
+    entry.has_velocity = velocity != nullptr;
+    if (velocity != nullptr) {
+        entry.velocity_flags = velocity->velocityFlags;
+        entry.linear_velocity = velocity->linearVelocity;
+        entry.angular_velocity = velocity->angularVelocity;
+    }
+}
+
+static void CopyLocation(const CachedLocation &entry, XrSpaceLocation *location, XrSpaceVelocity *velocity) {
+    location->locationFlags = entry.location_flags;
+    location->pose = entry.pose;
+    if (velocity != nullptr) {
+        velocity->velocityFlags = entry.velocity_flags;
+        velocity->linearVelocity = entry.linear_velocity;
+        velocity->angularVelocity = entry.angular_velocity;
+    }
+}
+
+static void AddLocatedSpace(std::vector<LocatedSpace> &spaces, XrSpace space, bool velocity) {
+    for (LocatedSpace &located : spaces) {
+        if (located.space == space) {
+            located.velocity = located.velocity || velocity;
+            return;
+        }
+    }
+    spaces.push_back({space, velocity});
+}
+
+// Remove every trace of a space about to be destroyed.  Caller must hold g_cache_mutex.
+static void ForgetSpace(SessionCache &cache, XrSpace space) {
+    cache.locations.erase(std::remove_if(cache.locations.begin(), cache.locations.end(),
+                                         [space](const CachedLocation &entry) {
+                                             return entry.key.space == space || entry.key.base_space == space;
+                                         }),
+                          cache.locations.end());
+    for (auto *located : {&cache.located, &cache.previously_located}) {
+        located->erase(space);
+        for (auto &base : *located) {
+            base.second.erase(std::remove_if(base.second.begin(), base.second.end(),
+                                             [space](const LocatedSpace &entry) { return entry.space == space; }),
+                              base.second.end());
+        }
+    }
+    cache.generation++;
+}
+
+PFN_xrVoidFunction SpaceCacheLayerInnerGetInstanceProcAddr(const char *name);
+
+XRAPI_ATTR XrResult XRAPI_CALL SpaceCacheLayerXrDestroyInstance(XrInstance instance) {
+    XrGeneratedDispatchTable *next_dispatch = g_next_dispatch;
+    XrResult result = next_dispatch->DestroyInstance(instance);
+
+    {
+        std::unique_lock<std::mutex> lock(g_cache_mutex);
+        g_spaces.clear();
+        g_sessions.clear();
+    }
+
+    g_next_dispatch = nullptr;
+    g_locate_spaces = nullptr;
+    delete next_dispatch;
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL SpaceCacheLayerXrCreateSession(XrInstance instance, const XrSessionCreateInfo *createInfo,
+                                                              XrSession *session) {
+    XrResult result = g_next_dispatch->CreateSession(instance, createInfo, session);
+    if (XR_SUCCEEDED(result)) {
+        std::unique_lock<std::mutex> lock(g_cache_mutex);
+        std::unique_ptr<SessionCache> cache(new SessionCache());
+        cache->session = *session;
+        g_sessions[*session] = std::move(cache);
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL SpaceCacheLayerXrDestroySession(XrSession session) {
+    {
+        std::unique_lock<std::mutex> lock(g_cache_mutex);
+        auto it = g_sessions.find(session);
+        if (it != g_sessions.end()) {
+            // Destroying a session destroys its spaces too.
+            SessionCache *cache = it->second.get();
+            for (auto space = g_spaces.begin(); space != g_spaces.end();) {
+                if (space->second == cache) {
+                    space = g_spaces.erase(space);
+                } else {
+                    ++space;
+                }
+            }
+            g_sessions.erase(it);
+        }
+    }
+    return g_next_dispatch->DestroySession(session);
+}
+
+static void SpaceCacheAddSpace(XrSession session, XrSpace space) {
+    std::unique_lock<std::mutex> lock(g_cache_mutex);
+    auto it = g_sessions.find(session);
+    if (it != g_sessions.end()) {
+        g_spaces[space] = it->second.get();
+    }
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL SpaceCacheLayerXrCreateReferenceSpace(XrSession session, const XrReferenceSpaceCreateInfo *createInfo,
+                                                                     XrSpace *space) {
+    XrResult result = g_next_dispatch->CreateReferenceSpace(session, createInfo, space);
+    if (XR_SUCCEEDED(result)) {
+        SpaceCacheAddSpace(session, *space);
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL SpaceCacheLayerXrCreateActionSpace(XrSession session, const XrActionSpaceCreateInfo *createInfo,
+                                                                  XrSpace *space) {
+    XrResult result = g_next_dispatch->CreateActionSpace(session, createInfo, space);
+    if (XR_SUCCEEDED(result)) {
+        SpaceCacheAddSpace(session, *space);
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL SpaceCacheLayerXrDestroySpace(XrSpace space) {
+    SessionCache *cache = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(g_cache_mutex);
+        auto it = g_spaces.find(space);
+        if (it != g_spaces.end()) {
+            cache = it->second;
+            ForgetSpace(*cache, space);
+            g_spaces.erase(it);
+        }
+    }
+    if (cache != nullptr) {
+        // No new prefetch can include the space now; wait for those already in flight.
+        std::unique_lock<std::shared_mutex> prefetch_lock(cache->prefetch_mutex);
+    }
+    return g_next_dispatch->DestroySpace(space);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL SpaceCacheLayerXrWaitFrame(XrSession session, const XrFrameWaitInfo *frameWaitInfo,
+                                                          XrFrameState *frameState) {
+    XrResult result = g_next_dispatch->WaitFrame(session, frameWaitInfo, frameState);
+    if (XR_SUCCEEDED(result)) {
+        std::unique_lock<std::mutex> lock(g_cache_mutex);
+        auto it = g_sessions.find(session);
+        if (it != g_sessions.end()) {
+            SessionCache &cache = *it->second;
+            cache.frame_started = true;
+            // Swapping keeps the vectors' storage, so a steady frame loop does not allocate here.
+            std::swap(cache.located, cache.previously_located);
+            for (auto &base : cache.located) {
+                base.second.clear();
+            }
+            cache.Clear();
+        }
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL SpaceCacheLayerXrSyncActions(XrSession session, const XrActionsSyncInfo *syncInfo) {
+    XrResult result = g_next_dispatch->SyncActions(session, syncInfo);
+    if (XR_SUCCEEDED(result)) {
+        std::unique_lock<std::mutex> lock(g_cache_mutex);
+        auto it = g_sessions.find(session);
+        if (it != g_sessions.end()) {
+            it->second->Clear();
+        }
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL SpaceCacheLayerXrLocateSpace(XrSpace space, XrSpace baseSpace, XrTime time,
+                                                            XrSpaceLocation *location) {
+    // Only plain locations, optionally with velocities, are cached.
+    XrSpaceVelocity *velocity = nullptr;
+    bool cacheable = location != nullptr && location->type == XR_TYPE_SPACE_LOCATION;
+    for (auto *next = cacheable ? reinterpret_cast<XrBaseOutStructure *>(location->next) : nullptr; next != nullptr;
+         next = next->next) {
+        if (next->type == XR_TYPE_SPACE_VELOCITY && velocity == nullptr) {
+            velocity = reinterpret_cast<XrSpaceVelocity *>(next);
+        } else {
+            cacheable = false;
+            break;
+        }
+    }
+    if (!cacheable) {
+        return g_next_dispatch->LocateSpace(space, baseSpace, time, location);
+    }
+
+    // Reused between calls, so that prefetching does not allocate every frame.
+    static thread_local std::vector<LocatedSpace> prefetch;
+    static thread_local std::vector<XrSpace> spaces;
+    static thread_local std::vector<XrSpaceLocationData> location_data;
+    static thread_local std::vector<XrSpaceVelocityData> velocity_data;
+
+    const LocateKey key{space, baseSpace, time};
+    XrSession session = XR_NULL_HANDLE;
+    uint64_t generation = 0;
+    prefetch.clear();
+    std::shared_lock<std::shared_mutex> prefetch_lock;
+    {
+        std::unique_lock<std::mutex> lock(g_cache_mutex);
+        auto space_it = g_spaces.find(space);
+        auto base_it = g_spaces.find(baseSpace);
+        if (space_it == g_spaces.end() || base_it == g_spaces.end() || space_it->second != base_it->second ||
+            !space_it->second->frame_started) {
+            lock.unlock();
+            return g_next_dispatch->LocateSpace(space, baseSpace, time, location);
+        }
+        SessionCache &cache = *space_it->second;
+        AddLocatedSpace(cache.located[baseSpace], space, velocity != nullptr);
+
+        const CachedLocation *cached = cache.Find(key);
+        if (cached != nullptr && (velocity == nullptr || cached->has_velocity)) {
+            CopyLocation(*cached, location, velocity);
+            return XR_SUCCESS;
+        }
+
+        if (g_locate_spaces != nullptr &&
+            std::find(cache.prefetched.begin(), cache.prefetched.end(), std::make_pair(baseSpace, time)) == cache.prefetched.end()) {
+            cache.prefetched.emplace_back(baseSpace, time);
+            auto previous = cache.previously_located.find(baseSpace);
+            if (previous != cache.previously_located.end()) {
+                prefetch.assign(previous->second.begin(), previous->second.end());
+                AddLocatedSpace(prefetch, space, velocity != nullptr);
+            }
+            if (prefetch.size() > 1) {
+                // Taken before g_cache_mutex is released, so destroying a space from now on waits for the prefetch.
+                prefetch_lock = std::shared_lock<std::shared_mutex>(cache.prefetch_mutex);
+            }
+        }
+        session = cache.session;
+        generation = cache.generation;
+    }
+
+    // Locate everything located against this base space last frame in one call, and answer from that.
+    if (prefetch.size() > 1) {
+        spaces.clear();
+        bool velocities_wanted = false;
+        for (const LocatedSpace &located : prefetch) {
+            spaces.push_back(located.space);
+            velocities_wanted = velocities_wanted || located.velocity;
+        }
+        location_data.resize(spaces.size());
+        velocity_data.resize(velocities_wanted ? spaces.size() : 0);
+
+        XrSpacesLocateInfo locate_info{XR_TYPE_SPACES_LOCATE_INFO};
+        locate_info.baseSpace = baseSpace;
+        locate_info.time = time;
+        locate_info.spaceCount = static_cast<uint32_t>(spaces.size());
+        locate_info.spaces = spaces.data();
+        XrSpaceVelocities velocities{XR_TYPE_SPACE_VELOCITIES};
+        velocities.velocityCount = static_cast<uint32_t>(velocity_data.size());
+        velocities.velocities = velocity_data.data();
+        XrSpaceLocations locations{XR_TYPE_SPACE_LOCATIONS};
+        locations.next = velocities_wanted ? &velocities : nullptr;
+        locations.locationCount = static_cast<uint32_t>(location_data.size());
+        locations.locations = location_data.data();
+
+        const XrResult prefetch_result = g_locate_spaces(session, &locate_info, &locations);
+        // Released before g_cache_mutex is taken, as a prefetch waiting for the shared lock holds that.
+        prefetch_lock.unlock();
+        if (prefetch_result == XR_SUCCESS) {
+            std::unique_lock<std::mutex> lock(g_cache_mutex);
+            auto space_it = g_spaces.find(space);
+            if (space_it != g_spaces.end() && space_it->second->generation == generation) {
+                SessionCache &cache = *space_it->second;
+                for (size_t i = 0; i < spaces.size(); ++i) {
+                    CachedLocation &entry = cache.FindOrAdd(LocateKey{spaces[i], baseSpace, time});
+                    entry.location_flags = location_data[i].locationFlags;
+                    entry.pose = location_data[i].pose;
+                    entry.has_velocity = velocities_wanted;
+                    if (velocities_wanted) {
+                        entry.velocity_flags = velocity_data[i].velocityFlags;
+                        entry.linear_velocity = velocity_data[i].linearVelocity;
+                        entry.angular_velocity = velocity_data[i].angularVelocity;
+                    }
+                }
+                const CachedLocation &entry = cache.FindOrAdd(key);
+                if (velocity == nullptr || entry.has_velocity) {
+                    CopyLocation(entry, location, velocity);
+                    return XR_SUCCESS;
+                }
+            }
+        }
+    }
+
+    XrResult result = g_next_dispatch->LocateSpace(space, baseSpace, time, location);
+    if (result == XR_SUCCESS) {
+        std::unique_lock<std::mutex> lock(g_cache_mutex);
+        auto space_it = g_spaces.find(space);
+        if (space_it != g_spaces.end() && space_it->second->generation == generation) {
+            CacheLocation(*space_it->second, key, *location, velocity);
+        }
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL SpaceCacheLayerXrGetInstanceProcAddr(XrInstance instance, const char *name,
+                                                                    PFN_xrVoidFunction *function) {
+    try {
+        *function = SpaceCacheLayerInnerGetInstanceProcAddr(name);
+
+        if (*function != nullptr) {
+            return XR_SUCCESS;
+        }
+
+        // We have not found it, so pass it down to the next layer/runtime
+        if (nullptr == g_next_dispatch) {
+            return XR_ERROR_HANDLE_INVALID;
+        }
+        return g_next_dispatch->GetInstanceProcAddr(instance, name, function);
+    } catch (...) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL SpaceCacheLayerXrCreateApiLayerInstance(const XrInstanceCreateInfo *info,
+                                                                       const struct XrApiLayerCreateInfo *apiLayerInfo,
+                                                                       XrInstance *instance) {
+    try {
+        XrApiLayerCreateInfo new_api_layer_info = {};
+
+        // Validate the API layer info and next API layer info structures before we try to use them
+        if (nullptr == apiLayerInfo || XR_LOADER_INTERFACE_STRUCT_API_LAYER_CREATE_INFO != apiLayerInfo->structType ||
+            XR_API_LAYER_CREATE_INFO_STRUCT_VERSION > apiLayerInfo->structVersion ||
+            sizeof(XrApiLayerCreateInfo) > apiLayerInfo->structSize || nullptr == apiLayerInfo->nextInfo ||
+            XR_LOADER_INTERFACE_STRUCT_API_LAYER_NEXT_INFO != apiLayerInfo->nextInfo->structType ||
+            XR_API_LAYER_NEXT_INFO_STRUCT_VERSION > apiLayerInfo->nextInfo->structVersion ||
+            sizeof(XrApiLayerNextInfo) > apiLayerInfo->nextInfo->structSize ||
+            0 != strcmp("XR_APILAYER_KHRONOS_space_cache", apiLayerInfo->nextInfo->layerName) ||
+            nullptr == apiLayerInfo->nextInfo->nextGetInstanceProcAddr ||
+            nullptr == apiLayerInfo->nextInfo->nextCreateApiLayerInstance) {
+            return XR_ERROR_INITIALIZATION_FAILED;
+        }
+
+        // Copy the contents of the layer info struct, but then move the next info up by
+        // one slot so that the next layer gets information.
+        memcpy(&new_api_layer_info, apiLayerInfo, sizeof(XrApiLayerCreateInfo));
+        new_api_layer_info.nextInfo = apiLayerInfo->nextInfo->next;
+
+        // Get the function pointers we need
+        PFN_xrGetInstanceProcAddr next_get_instance_proc_addr = apiLayerInfo->nextInfo->nextGetInstanceProcAddr;
+        PFN_xrCreateApiLayerInstance next_create_api_layer_instance = apiLayerInfo->nextInfo->nextCreateApiLayerInstance;
+
+        // Create the instance using the layer create instance command for the next layer
+        XrInstance returned_instance = *instance;
+        XrResult result = next_create_api_layer_instance(info, &new_api_layer_info, &returned_instance);
+        *instance = returned_instance;
+
+        if (XR_SUCCEEDED(result)) {
+            // Create the dispatch table to the next levels
+            auto *next_dispatch = new XrGeneratedDispatchTable();
+            GeneratedXrPopulateDispatchTable(next_dispatch, returned_instance, next_get_instance_proc_addr);
+            delete g_next_dispatch;
+            g_next_dispatch = next_dispatch;
+
+            // Prefetching needs xrLocateSpaces, from OpenXR 1.1 or XR_KHR_locate_spaces.
+            g_locate_spaces = nullptr;
+            if (PlatformUtilsGetEnv("XR_SPACE_CACHE_PREFETCH") != "0") {
+                const XrVersion api_version = info->applicationInfo.apiVersion;
+                if (XR_VERSION_MAJOR(api_version) > 1 || (XR_VERSION_MAJOR(api_version) == 1 && XR_VERSION_MINOR(api_version) >= 1)) {
+                    g_locate_spaces = next_dispatch->LocateSpaces;
+                }
+                for (uint32_t i = 0; g_locate_spaces == nullptr && i < info->enabledExtensionCount; ++i) {
+                    if (0 == strcmp(info->enabledExtensionNames[i], XR_KHR_LOCATE_SPACES_EXTENSION_NAME)) {
+                        g_locate_spaces = next_dispatch->LocateSpacesKHR;
+                    }
+                }
+            }
+        }
+
+        return result;
+    } catch (...) {
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+}
+
+// Function used to negotiate an interface betewen the loader and an API layer.  Each library exposing one or
+// more API layers needs to expose at least this function.
+extern "C" LAYER_EXPORT XRAPI_ATTR XrResult XRAPI_CALL xrNegotiateLoaderApiLayerInterface(
+    const XrNegotiateLoaderInfo *loaderInfo, const char * /*apiLayerName*/, XrNegotiateApiLayerRequest *apiLayerRequest) {
+    if (loaderInfo == nullptr || loaderInfo->structType != XR_LOADER_INTERFACE_STRUCT_LOADER_INFO ||
+        loaderInfo->structVersion != XR_LOADER_INFO_STRUCT_VERSION || loaderInfo->structSize != sizeof(XrNegotiateLoaderInfo)) {
+        LogPlatformUtilsError("loaderInfo struct is not valid");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (loaderInfo->minInterfaceVersion > XR_CURRENT_LOADER_API_LAYER_VERSION ||
+        loaderInfo->maxInterfaceVersion < XR_CURRENT_LOADER_API_LAYER_VERSION) {
+        LogPlatformUtilsError("loader interface version is not in the range [minInterfaceVersion, maxInterfaceVersion]");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (loaderInfo->minApiVersion > XR_CURRENT_API_VERSION || loaderInfo->maxApiVersion < XR_CURRENT_API_VERSION) {
+        LogPlatformUtilsError("loader api version is not in the range [minApiVersion, maxApiVersion]");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (apiLayerRequest == nullptr || apiLayerRequest->structType != XR_LOADER_INTERFACE_STRUCT_API_LAYER_REQUEST ||
+        apiLayerRequest->structVersion != XR_API_LAYER_INFO_STRUCT_VERSION ||
+        apiLayerRequest->structSize != sizeof(XrNegotiateApiLayerRequest)) {
+        LogPlatformUtilsError("apiLayerRequest is not valid");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    apiLayerRequest->layerInterfaceVersion = XR_CURRENT_LOADER_API_LAYER_VERSION;
+    apiLayerRequest->layerApiVersion = XR_CURRENT_API_VERSION;
+    apiLayerRequest->getInstanceProcAddr = SpaceCacheLayerXrGetInstanceProcAddr;
+    apiLayerRequest->createApiLayerInstance = SpaceCacheLayerXrCreateApiLayerInstance;
+
+    return XR_SUCCESS;
+}
+
+PFN_xrVoidFunction SpaceCacheLayerInnerGetInstanceProcAddr(const char *name) {
+    std::string func_name = name;
+
+    if (func_name == "xrGetInstanceProcAddr") {
+        return reinterpret_cast<PFN_xrVoidFunction>(SpaceCacheLayerXrGetInstanceProcAddr);
+    }
+    if (func_name == "xrDestroyInstance") {
+        return reinterpret_cast<PFN_xrVoidFunction>(SpaceCacheLayerXrDestroyInstance);
+    }
+    if (func_name == "xrCreateSession") {
+        return reinterpret_cast<PFN_xrVoidFunction>(SpaceCacheLayerXrCreateSession);
+    }
+    if (func_name == "xrDestroySession") {
+        return reinterpret_cast<PFN_xrVoidFunction>(SpaceCacheLayerXrDestroySession);
+    }
+    if (func_name == "xrCreateReferenceSpace") {
+        return reinterpret_cast<PFN_xrVoidFunction>(SpaceCacheLayerXrCreateReferenceSpace);
+    }
+    if (func_name == "xrCreateActionSpace") {
+        return reinterpret_cast<PFN_xrVoidFunction>(SpaceCacheLayerXrCreateActionSpace);
+    }
+    if (func_name == "xrDestroySpace") {
+        return reinterpret_cast<PFN_xrVoidFunction>(SpaceCacheLayerXrDestroySpace);
+    }
+    if (func_name == "xrWaitFrame") {
+        return reinterpret_cast<PFN_xrVoidFunction>(SpaceCacheLayerXrWaitFrame);
+    }
+    if (func_name == "xrSyncActions") {
+        return reinterpret_cast<PFN_xrVoidFunction>(SpaceCacheLayerXrSyncActions);
+    }
+    if (func_name == "xrLocateSpace") {
+        return reinterpret_cast<PFN_xrVoidFunction>(SpaceCacheLayerXrLocateSpace);
+    }
+    return nullptr;
+}
@@ -32,12 +32,21 @@
 #include <openxr/openxr.h>
 #include <openxr/openxr_platform.h>
 
+#include <algorithm>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
 #include <string>
 #include <mutex>
 #include <memory>
+#include <new>
+#include <shared_mutex>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <thread>
 
 /// Prints a message to stderr then throws an exception.
 ///
@@ -73,6 +82,85 @@ typedef std::unique_ptr<XrDebugUtilsObjectNameInfoEXT, XrDebugUtilsObjectNameInf
 
 typedef std::unique_ptr<CoreValidationMessengerInfo, CoreValidationMessengerInfoDeleter> UniqueCoreValidationMessengerInfo;
 
+/// The contents of a create-info structure, as the key of GenValidUsageCreateInfoCache.
+///
+/// The generated GenValidUsageMakeCreateInfoKey functions write the members one by one to their offsets,
+/// so the padding between them stays zero and two structures with equal members always get equal keys.
+class GenValidUsageCreateInfoKey {
+   public:
+    /// Structures larger than this are never memoized.
+    static constexpr size_t kMaxBytes = 256;
+
+    /// Starts the key of a structure of the given type and size; returns false if it does not fit.
+    bool reset(XrStructureType type, size_t size) {
+        type_ = type;
+        size_ = static_cast<uint32_t>(size);
+        hash_ = 0;
+        if (size > kMaxBytes) {
+            return false;
+        }
+        memset(bytes_, 0, size);
+        return true;
+    }
+
+    /// Copies one member of the structure at base into the key.
+    template <typename S, typename M>
+    void write(const S *base, const M &member) {
+        size_t offset = static_cast<size_t>(reinterpret_cast<const char *>(&member) - reinterpret_cast<const char *>(base));
+        memcpy(bytes_ + offset, &member, sizeof(M));
+    }
+
+    /// Completes the key once every member has been written.
+    void finish() {
+        // FNV-1a
+        uint64_t hash = 14695981039346656037ULL;
+        for (uint32_t i = 0; i < size_; ++i) {
+            hash = (hash ^ bytes_[i]) * 1099511628211ULL;
+        }
+        hash_ = hash;
+    }
+
+    uint64_t hash() const { return hash_; }
+
+    bool operator==(const GenValidUsageCreateInfoKey &other) const {
+        return type_ == other.type_ && size_ == other.size_ && hash_ == other.hash_ &&
+               memcmp(bytes_, other.bytes_, size_) == 0;
+    }
+
+   private:
+    XrStructureType type_ = XR_TYPE_UNKNOWN;
+    uint32_t size_ = 0;
+    uint64_t hash_ = 0;
+    uint8_t bytes_[kMaxBytes];
+};
+
+/// Create-info structures of one instance that have already passed validation.
+///
+/// Only structures without a next chain or any pointer or handle member are memoized: their
+/// validity then depends on nothing but their contents and the instance's enabled extensions, so an
+/// identical structure seen again does not need to be validated again.  The cache is a fixed table
+/// indexed by the key's hash; a new entry replaces whatever shared its slot.
+class GenValidUsageCreateInfoCache {
+   public:
+    /// Returns true if a structure with this key has been validated before.
+    bool contains(const GenValidUsageCreateInfoKey &key) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return slots_[key.hash() % kSlots] == key;
+    }
+
+    /// Records a structure that has just passed validation.
+    void insert(const GenValidUsageCreateInfoKey &key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        slots_[key.hash() % kSlots] = key;
+    }
+
+   private:
+    static constexpr size_t kSlots = 64;
+
+    mutable std::mutex mutex_;
+    GenValidUsageCreateInfoKey slots_[kSlots];
+};
+
 // Define the instance struct used for passing information around.
 // This information includes things like the dispatch table as well as the
 // enabled extensions.
@@ -84,6 +172,7 @@ struct GenValidUsageXrInstanceInfo {
     std::vector<std::string> enabled_extensions;
     std::vector<UniqueCoreValidationMessengerInfo> debug_messengers;
     DebugUtilsData debug_data;
+    GenValidUsageCreateInfoCache validated_create_infos;
 };
 
 // Structure used for storing information for other handles
@@ -122,6 +211,44 @@ struct GenValidUsageXrObjectInfo {
     GenValidUsageXrObjectInfo(T h, XrObjectType t) : handle(MakeHandleGeneric(h)), type(t) {}
 };
 
+// Marks the functions that only run once a problem is being reported, so that the compiler keeps
+// them, and the formatting they do, out of the code of the checks that call them.
+#if defined(__GNUC__) || defined(__clang__)
+#define XR_VALIDATION_COLD __attribute__((cold, noinline))
+#elif defined(_MSC_VER)
+#define XR_VALIDATION_COLD __declspec(noinline)
+#else
+#define XR_VALIDATION_COLD
+#endif
+
+/// The objects a command has been given, kept in case a problem with the command is reported.
+///
+/// Every validated call records its handles, but almost none of them report anything, so the first
+/// few are kept in place rather than in a vector that would have to be allocated on every call.
+class GenValidUsageObjectList {
+   public:
+    template <typename T>
+    void emplace_back(T handle, XrObjectType type) {
+        if (count_ < kInlineObjects) {
+            inline_objects_[count_] = GenValidUsageXrObjectInfo(handle, type);
+        } else {
+            overflow_objects_.emplace_back(handle, type);
+        }
+        ++count_;
+    }
+
+    bool empty() const { return count_ == 0; }
+    size_t size() const { return count_; }
+
+    std::vector<GenValidUsageXrObjectInfo> toVector() const;
+
+   private:
+    static constexpr size_t kInlineObjects = 4;
+    GenValidUsageXrObjectInfo inline_objects_[kInlineObjects];
+    std::vector<GenValidUsageXrObjectInfo> overflow_objects_;
+    size_t count_ = 0;
+};
+
 // Debug message severity levels for logging.
 enum GenValidUsageDebugSeverity {
     VALID_USAGE_DEBUG_SEVERITY_DEBUG = 0,
@@ -130,10 +257,92 @@ enum GenValidUsageDebugSeverity {
     VALID_USAGE_DEBUG_SEVERITY_ERROR = 21,
 };
 
+// Validation tiers of the per-frame commands, selected with XR_CORE_VALIDATION_TIER.
+enum GenValidUsageTier {
+    // Every call is fully validated.
+    VALID_USAGE_TIER_FULL,
+    // The first calls are fully validated, after that only one call in every sample interval.
+    VALID_USAGE_TIER_SAMPLED,
+    // Handles and structure types are validated, but not the next chains of the parameters.
+    VALID_USAGE_TIER_STRUCTURAL,
+};
+
+// How much of a single call to a tiered command gets validated.
+enum GenValidUsageCallDepth {
+    VALID_USAGE_CALL_DEPTH_SKIP,
+    VALID_USAGE_CALL_DEPTH_STRUCTURAL,
+    VALID_USAGE_CALL_DEPTH_FULL,
+};
+
+// The tier settings read when an instance is created.
+struct GenValidUsageTierSettings {
+    GenValidUsageTier default_tier = VALID_USAGE_TIER_FULL;
+    bool has_default_tier = false;
+    std::unordered_map<std::string, GenValidUsageTier> command_tiers;
+    uint32_t sample_first = 1000;
+    uint32_t sample_interval = 100;
+};
+
+/// Validation tier state of one tiered command.
+///
+/// The generated code keeps one of these per command listed as tiered in the generator, initialized
+/// with the tier the generator chose for it, and asks it for the depth of every call.
+class GenValidUsageCommandTier {
+   public:
+    GenValidUsageCommandTier(const char *command_name, GenValidUsageTier generated_tier)
+        : command_name_(command_name), generated_tier_(generated_tier), tier_(generated_tier) {}
+
+    /// Selects this command's tier from the settings: its own entry if there is one, else the
+    /// default tier if one was given, else the tier it was generated with.
+    void apply(const GenValidUsageTierSettings &settings);
+
+    GenValidUsageCallDepth nextCallDepth() {
+        switch (tier_.load(std::memory_order_relaxed)) {
+            case VALID_USAGE_TIER_STRUCTURAL:
+                return VALID_USAGE_CALL_DEPTH_STRUCTURAL;
+            case VALID_USAGE_TIER_SAMPLED: {
+                uint64_t call = call_count_.fetch_add(1, std::memory_order_relaxed);
+                uint32_t first = sample_first_.load(std::memory_order_relaxed);
+                uint32_t interval = sample_interval_.load(std::memory_order_relaxed);
+                if (call < first || (interval != 0 && (call - first) % interval == 0)) {
+                    return VALID_USAGE_CALL_DEPTH_FULL;
+                }
+#if defined(XR_CORE_VALIDATION_WRAP_HANDLES)
+                // Wrapped handles are dereferenced when they are unwrapped, so they are always verified.
+                return VALID_USAGE_CALL_DEPTH_STRUCTURAL;
+#else
+                return VALID_USAGE_CALL_DEPTH_SKIP;
+#endif
+            }
+            case VALID_USAGE_TIER_FULL:
+            default:
+                return VALID_USAGE_CALL_DEPTH_FULL;
+        }
+    }
+
+   private:
+    const char *const command_name_;
+    const GenValidUsageTier generated_tier_;
+    std::atomic<GenValidUsageTier> tier_;
+    std::atomic<uint32_t> sample_first_{0};
+    std::atomic<uint32_t> sample_interval_{0};
+    std::atomic<uint64_t> call_count_{0};
+};
+
 // in core_validation.cpp
 void EraseAllInstanceTableMapElements(GenValidUsageXrInstanceInfo *search_value);
 
 typedef std::unique_lock<std::mutex> UniqueLock;
+typedef std::unique_lock<std::shared_mutex> ExclusiveLock;
+typedef std::shared_lock<std::shared_mutex> SharedLock;
+
+/// Concurrent registry of the info for every live handle of one type.
+///
+/// Handles are spread over kShardCount shards, each an unordered_map behind its own shared_mutex.
+/// Validation looks handles up on every call from every thread, so lookups only take their shard's
+/// lock in shared mode and never wait on each other; insert and erase, which happen on create and
+/// destroy, lock a single shard exclusively.  getWithLock also locks exclusively, since its callers
+/// modify the info while holding the lock.
 template <typename HandleType, typename InfoType>
 class HandleInfoBase {
    public:
@@ -151,10 +360,10 @@ class HandleInfoBase {
     /// Throws if not found.
     InfoType *get(HandleType handle);
 
-    /// Lookup a handle, returning a pointer (if found) as well as a lock for this object's dispatch mutex.
-    std::pair<UniqueLock, InfoType *> getWithLock(HandleType handle);
+    /// Lookup a handle, returning a pointer (if found) as well as an exclusive lock on its shard.
+    std::pair<ExclusiveLock, InfoType *> getWithLock(HandleType handle);
 
-    bool empty() const { return info_map_.empty(); }
+    bool empty();
 
     /// Insert an info for the supplied handle.
     /// Throws if it's already there.
@@ -164,15 +373,29 @@ class HandleInfoBase {
     /// Throws if not found.
     void erase(HandleType handle);
 
-    /// Get a constant reference to the whole map as well as a lock for this object's dispatch mutex.
-    std::pair<UniqueLock, map_t const &> lockMapConst();
-
-    /// Get a  reference to the whole map as well as a lock for this object's dispatch mutex.
-    std::pair<UniqueLock, map_t &> lockMap();
+    /// Remove every entry for which the predicate returns true, locking one shard at a time.
+    template <typename Pred>
+    void eraseIf(Pred &&pred);
 
    protected:
-    map_t info_map_;
-    std::mutex dispatch_mutex_;
+    static constexpr size_t kShardCount = 16;
+
+    // Aligned so that readers of different shards do not share a cache line.
+    struct alignas(64) Shard {
+        std::shared_mutex mutex;
+        map_t map;
+    };
+
+    Shard &shardFor(HandleType handle) {
+        // Handles are often pointers or small counters, so mix the bits before picking a shard.
+        uint64_t bits = MakeHandleGeneric(handle);
+        bits ^= bits >> 33;
+        bits *= 0xff51afd7ed558ccdULL;
+        bits ^= bits >> 33;
+        return shards_[bits % kShardCount];
+    }
+
+    Shard shards_[kShardCount];
 };
 
 /// Subclass used exclusively for instances.
@@ -199,29 +422,340 @@ class HandleInfo : public HandleInfoBase<HandleType, GenValidUsageXrHandleInfo>
     void removeHandlesForInstance(GenValidUsageXrInstanceInfo *search_value);
 };
 
+/// Handle wrapping (BUILD_CORE_VALIDATION_HANDLE_WRAPPING).
+///
+/// In this mode every handle other than XrInstance that the layer returns is the address of a
+/// GenValidUsageWrappedHandle.  It holds the handle of the layer or runtime below together with the
+/// info a HandleInfo map would hold, so checking a handle is a tag compare and a dereference rather
+/// than a locked map lookup.  The generated next-functions unwrap handles, including those inside
+/// structures, arrays and next chains, before calling down.  Wrappers come from a pool that is never
+/// returned to the system, so a destroyed handle still points at readable memory with a cleared tag,
+/// and a released wrapper is not reused until thousands of others have been released after it;
+/// a value that was never a handle at all is dereferenced as-is, as in the Vulkan layers.
+constexpr uint64_t kGenValidUsageWrappedHandleTag = 0x444e414850415257ULL;
+
+struct GenValidUsageWrappedHandle {
+    std::atomic<uint64_t> tag{0};
+    // The WrappedHandleInfo that created this wrapper, which identifies the handle type.
+    const void *owner = nullptr;
+    uint64_t next_handle = 0;
+    GenValidUsageXrHandleInfo info{};
+    GenValidUsageWrappedHandle *next_free = nullptr;
+};
+
+/// Allocate a wrapper for a live handle, reusing one released long enough ago when possible.
+GenValidUsageWrappedHandle *GenValidUsageAllocateWrappedHandle();
+
+/// Clear a wrapper's tag and quarantine it for later reuse.
+void GenValidUsageReleaseWrappedHandle(GenValidUsageWrappedHandle *wrapper);
+
+/// The live wrapper a handle points at, or nullptr for XR_NULL_HANDLE and anything else that is not one.
+template <typename HandleType>
+inline GenValidUsageWrappedHandle *GenValidUsageWrappedHandleFromXrHandle(HandleType handle) {
+    const uint64_t address = MakeHandleGeneric(handle);
+    if (address == 0 || address > UINTPTR_MAX || (address % alignof(GenValidUsageWrappedHandle)) != 0) {
+        return nullptr;
+    }
+    auto *wrapper = reinterpret_cast<GenValidUsageWrappedHandle *>(static_cast<uintptr_t>(address));
+    if (wrapper->tag.load(std::memory_order_acquire) != kGenValidUsageWrappedHandleTag) {
+        return nullptr;
+    }
+    return wrapper;
+}
+
+/// The next layer's handle for one given to the application.  Anything that is not a live wrapped
+/// handle is passed on unchanged for the layers below to reject.
+template <typename HandleType>
+inline HandleType UnwrapXrHandle(HandleType handle) {
+    GenValidUsageWrappedHandle *wrapper = GenValidUsageWrappedHandleFromXrHandle(handle);
+    if (wrapper == nullptr) {
+        return handle;
+    }
+    return TreatIntegerAsHandle<HandleType>(wrapper->next_handle);
+}
+
+/// @overload for handles given as an XrObjectType and integer, as in XrDebugUtilsObjectNameInfoEXT.
+inline uint64_t UnwrapXrObjectHandle(XrObjectType type, uint64_t handle) {
+    if (type == XR_OBJECT_TYPE_INSTANCE || type == XR_OBJECT_TYPE_UNKNOWN) {
+        return handle;
+    }
+    GenValidUsageWrappedHandle *wrapper = GenValidUsageWrappedHandleFromXrHandle(handle);
+    return wrapper == nullptr ? handle : wrapper->next_handle;
+}
+
+/// Registry with the same interface as HandleInfo, backed by wrapped handles.
+template <typename HandleType>
+class WrappedHandleInfo {
+   public:
+    typedef GenValidUsageXrHandleInfo info_t;
+    typedef HandleType handle_t;
+
+    ValidateXrHandleResult verifyHandle(HandleType const *handle_to_check);
+
+    /// Lookup a handle.
+    /// Throws if not found.
+    GenValidUsageXrHandleInfo *get(HandleType handle);
+
+    /// Lookup a handle, returning a pointer (if found) as well as an exclusive lock on this registry.
+    std::pair<ExclusiveLock, GenValidUsageXrHandleInfo *> getWithLock(HandleType handle);
+
+    /// Lookup a handle and its instance info
+    /// Throws if not found.
+    std::pair<GenValidUsageXrHandleInfo *, GenValidUsageXrInstanceInfo *> getWithInstanceInfo(HandleType handle);
+
+    bool empty();
+
+    /// Wrap a handle created by the next layer, returning the handle to give to the application.
+    HandleType wrap(HandleType next_handle, std::unique_ptr<GenValidUsageXrHandleInfo> &&info);
+
+    /// The application's handle for one returned by the next layer outside of a create command, such as
+    /// in an event.  Handles seen for the first time are wrapped with the given parent.
+    HandleType wrapReturned(HandleType next_handle, GenValidUsageXrInstanceInfo *instance_info, XrObjectType parent_type,
+                            uint64_t parent_handle);
+
+    /// Release the wrapper of a destroyed handle.
+    /// Throws if not found.
+    void erase(HandleType handle);
+
+    /// Release the wrappers of every handle belonging to an instance.
+    void removeHandlesForInstance(GenValidUsageXrInstanceInfo *search_value);
+
+   private:
+    GenValidUsageWrappedHandle *find(HandleType handle) {
+        GenValidUsageWrappedHandle *wrapper = GenValidUsageWrappedHandleFromXrHandle(handle);
+        return wrapper != nullptr && wrapper->owner == this ? wrapper : nullptr;
+    }
+
+    // Guards wrapped_ and, through getWithLock, callers that modify an info.
+    std::shared_mutex mutex_;
+    // Live wrappers by the next layer's handle, used to map returned handles back to the application's.
+    std::unordered_map<uint64_t, GenValidUsageWrappedHandle *> wrapped_;
+    // Handles given to the application, so that one left unchanged in an output is not wrapped twice.
+    std::unordered_set<uint64_t> returned_;
+};
+
+/// Storage for the copies of a command's inputs: the unwrapped copies made while the command runs,
+/// or the copies a deferred call is validated with.  Small copies fit in the inline buffer, so the
+/// common cases do not allocate.
+class GenValidUsageUnwrapScratch {
+   public:
+    GenValidUsageUnwrapScratch() = default;
+    GenValidUsageUnwrapScratch(const GenValidUsageUnwrapScratch &) = delete;
+    GenValidUsageUnwrapScratch &operator=(const GenValidUsageUnwrapScratch &) = delete;
+
+    void *allocate(size_t size) {
+        size = (size + kAlignment - 1) & ~(kAlignment - 1);
+        if (size <= sizeof(inline_) - used_) {
+            void *memory = inline_ + used_;
+            used_ += size;
+            return memory;
+        }
+        overflow_.emplace_back(new uint64_t[size / sizeof(uint64_t)]);
+        return overflow_.back().get();
+    }
+
+    /// Copy `count` elements into scratch storage.
+    template <typename T>
+    T *copy(const T *source, size_t count = 1) {
+        T *destination = static_cast<T *>(allocate(sizeof(T) * count));
+        memcpy(static_cast<void *>(destination), source, sizeof(T) * count);
+        return destination;
+    }
+
+    /// Copy a null-terminated string, keeping a null pointer null.
+    const char *copyString(const char *source) {
+        if (source == nullptr) {
+            return nullptr;
+        }
+        return copy(source, strlen(source) + 1);
+    }
+
+    /// Forget every copy, so that the storage can be used again.
+    void reset() {
+        used_ = 0;
+        overflow_.clear();
+    }
+
+   private:
+    static constexpr size_t kAlignment = 16;
+    alignas(kAlignment) uint8_t inline_[1024];
+    size_t used_ = 0;
+    std::vector<std::unique_ptr<uint64_t[]>> overflow_;
+};
+
+/// A call to a per-frame command whose validation has been deferred, with copies of its inputs.
+/// The slots of a thread's queue are allocated once and reused, so deferring a call does not
+/// allocate unless its copies outgrow the inline scratch buffer.
+struct GenValidUsageDeferredCall {
+    // Order of the call among all deferred calls, and the thread that made it, for the messages.
+    uint64_t sequence = 0;
+    std::thread::id thread;
+    GenValidUsageUnwrapScratch copies;
+    // Validates the call from its arguments, which point into the copies.
+    void (*validate)(const void *arguments) = nullptr;
+    const void *arguments = nullptr;
+};
+
+/// Validates the calls of the per-frame commands on a thread of its own, selected with
+/// XR_CORE_VALIDATION_DEFERRED.
+///
+/// Each calling thread queues its calls in a ring that only it pushes to and only the validation
+/// thread pops from, so queueing a call takes no lock.  The ring is removed once its thread has
+/// exited and its calls have been validated.  Destroying a handle first waits for every call
+/// queued before it, so that a call is never validated against a handle destroyed after it.
+class GenValidUsageDeferredValidator {
+   public:
+    GenValidUsageDeferredValidator() = default;
+    GenValidUsageDeferredValidator(const GenValidUsageDeferredValidator &) = delete;
+    GenValidUsageDeferredValidator &operator=(const GenValidUsageDeferredValidator &) = delete;
+    ~GenValidUsageDeferredValidator() { stop(); }
+
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+    void setEnabled(bool enabled);
+
+    /// The next free slot of the calling thread's queue, to fill in and pass to enqueue, or nullptr
+    /// if the queue is full, in which case the caller validates the call right away instead.
+    GenValidUsageDeferredCall *reserve();
+
+    /// Queue the call in the slot returned by the last reserve() for validation.
+    void enqueue(GenValidUsageDeferredCall *call);
+
+    /// Wait until every call queued so far has been validated.
+    void flush();
+
+    /// Validate what is still queued, then end the validation thread.  Queueing a call starts it again.
+    void stop();
+
+    /// The call being validated on the calling thread, or nullptr if it is not validating a deferred call.
+    static const GenValidUsageDeferredCall *currentCall();
+
+   private:
+    struct ThreadQueue;
+    struct ThreadQueueOwner;
+
+    ThreadQueue &threadQueue();
+    void retire(const std::shared_ptr<ThreadQueue> &queue);
+    void start();
+    void run();
+    bool validateQueued();
+
+    std::atomic<bool> enabled_{false};
+    std::atomic<uint64_t> next_sequence_{0};
+    // Held while the validation thread is started or stopped.
+    std::mutex thread_mutex_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    // Protects the list of queues and the state the validation thread sleeps on.
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    // Notified when the validation thread has validated calls, for flush().
+    std::condition_variable validated_;
+    std::vector<std::shared_ptr<ThreadQueue>> queues_;
+    bool stopping_ = false;
+    std::atomic<bool> sleeping_{false};
+};
+
+extern GenValidUsageDeferredValidator g_deferred_validation;
+
+/// Copy an array of handles, replacing each with the next layer's handle.
+template <typename HandleType>
+HandleType *UnwrapXrHandleArray(const HandleType *handles, uint32_t count, GenValidUsageUnwrapScratch &scratch) {
+    if (handles == nullptr || count == 0) {
+        return const_cast<HandleType *>(handles);
+    }
+    HandleType *copy = scratch.copy(handles, count);
+    for (uint32_t i = 0; i < count; ++i) {
+        copy[i] = UnwrapXrHandle(copy[i]);
+    }
+    return copy;
+}
+
+/// Where handles first seen in an output came from, recorded as their parent when they are wrapped.
+struct GenValidUsageRewrapContext {
+    GenValidUsageXrInstanceInfo *instance_info;
+    XrObjectType parent_type;
+    uint64_t parent_handle;
+};
+
+/// Registry type used by the generated code for every handle except XrInstance.
+#if defined(XR_CORE_VALIDATION_WRAP_HANDLES)
+template <typename HandleType>
+using GenValidUsageHandleInfo = WrappedHandleInfo<HandleType>;
+#else
+template <typename HandleType>
+using GenValidUsageHandleInfo = HandleInfo<HandleType>;
+#endif
+
 /// Function to record all the core validation information
 void CoreValidLogMessage(GenValidUsageXrInstanceInfo *instance_info, const std::string &message_id,
                          GenValidUsageDebugSeverity message_severity, const std::string &command_name,
                          std::vector<GenValidUsageXrObjectInfo> objects_info, const std::string &message);
 
-void InvalidStructureType(GenValidUsageXrInstanceInfo *instance_info, const std::string &command_name,
-                          std::vector<GenValidUsageXrObjectInfo> &objects_info, const char *structure_name, XrStructureType type,
-                          const char *vuid = nullptr, XrStructureType expected = XrStructureType(0),
-                          const char *expected_name = "");
+XR_VALIDATION_COLD void InvalidStructureType(GenValidUsageXrInstanceInfo *instance_info, const char *command_name,
+                                             const GenValidUsageObjectList &objects_info, const char *structure_name,
+                                             XrStructureType type, const char *vuid = nullptr,
+                                             XrStructureType expected = XrStructureType(0), const char *expected_name = "");
+
+// Report a problem found by the generated checks.  The checks only pass string literals and the
+// values they have found to be wrong; the message is built here, after the check has failed.
+XR_VALIDATION_COLD void GenValidUsageReport(GenValidUsageXrInstanceInfo *instance_info, const char *message_id,
+                                            GenValidUsageDebugSeverity message_severity, const char *command_name,
+                                            const GenValidUsageObjectList &objects_info, const char *message);
+
+// The message is followed by the value in hexadecimal, then by the suffix.
+XR_VALIDATION_COLD void GenValidUsageReportValue(GenValidUsageXrInstanceInfo *instance_info, const char *message_id,
+                                                 const char *command_name, const GenValidUsageObjectList &objects_info,
+                                                 const char *message, uint64_t value, const char *suffix = "");
+
+// The message names an element of an array: "<description>[<index>]<suffix>".
+XR_VALIDATION_COLD void GenValidUsageReportElement(GenValidUsageXrInstanceInfo *instance_info, const char *message_id,
+                                                   const char *command_name, const GenValidUsageObjectList &objects_info,
+                                                   const char *description, size_t index, const char *suffix);
+
+// The message is "<first><first handle><relation><second handle><suffix>", for the checks on the
+// parents of two handles.
+XR_VALIDATION_COLD void GenValidUsageReportHandlePair(GenValidUsageXrInstanceInfo *instance_info, const char *message_id,
+                                                      const char *command_name, const GenValidUsageObjectList &objects_info,
+                                                      const char *first, uint64_t first_handle, const char *relation,
+                                                      uint64_t second_handle, const char *suffix);
+
+// The message ID is "VUID-<vuid_scope>-<vuid_item>-parameter", for the checks that are given the
+// names of the command or structure and of its member.
+XR_VALIDATION_COLD void GenValidUsageReportParameter(GenValidUsageXrInstanceInfo *instance_info, const char *vuid_scope,
+                                                     const char *vuid_item, const char *command_name,
+                                                     const GenValidUsageObjectList &objects_info, const char *message);
+
+/// The structure types allowed in a structure's next chain.
+///
+/// The generated code keeps the types of each structure in a constant table sorted by value, so that
+/// walking a chain looks them up with a binary search instead of building a set on every call.
+class GenValidUsageStructTypeSet {
+   public:
+    constexpr GenValidUsageStructTypeSet() = default;
+    template <size_t N>
+    constexpr GenValidUsageStructTypeSet(const XrStructureType (&types)[N]) : types_(types), count_(N) {}
 
-std::string StructTypesToString(GenValidUsageXrInstanceInfo *instance_info, const std::unordered_set<XrStructureType> &structs);
+    bool contains(XrStructureType type) const { return std::binary_search(begin(), end(), type); }
+    const XrStructureType *begin() const { return types_; }
+    const XrStructureType *end() const { return types_ + count_; }
 
-// -- Only implementations of templates follow --//
+   private:
+    const XrStructureType *types_ = nullptr;
+    size_t count_ = 0;
+};
 
-template <typename HT, typename IT>
-inline std::pair<UniqueLock, typename HandleInfoBase<HT, IT>::map_t const &> HandleInfoBase<HT, IT>::lockMapConst() {
-    return {UniqueLock(dispatch_mutex_), info_map_};
-}
+std::string StructTypesToString(GenValidUsageXrInstanceInfo *instance_info, GenValidUsageStructTypeSet structs);
 
-template <typename HT, typename IT>
-inline std::pair<UniqueLock, typename HandleInfoBase<HT, IT>::map_t &> HandleInfoBase<HT, IT>::lockMap() {
-    return {UniqueLock(dispatch_mutex_), info_map_};
-}
+// Report the types in a next chain that are not valid in it, or that occur in it more than once.
+XR_VALIDATION_COLD void GenValidUsageReportUnknownNextStructs(GenValidUsageXrInstanceInfo *instance_info, const char *struct_name,
+                                                              const char *command_name,
+                                                              const GenValidUsageObjectList &objects_info, const void *next,
+                                                              GenValidUsageStructTypeSet valid_structs);
+XR_VALIDATION_COLD void GenValidUsageReportDuplicateNextStructs(GenValidUsageXrInstanceInfo *instance_info,
+                                                                const char *struct_name, const char *command_name,
+                                                                const GenValidUsageObjectList &objects_info, const void *next);
+
+// -- Only implementations of templates follow --//
 
 template <typename HandleType, typename InfoType>
 inline ValidateXrHandleResult HandleInfoBase<HandleType, InfoType>::verifyHandle(HandleType const *handle_to_check) {
@@ -236,10 +770,11 @@ inline ValidateXrHandleResult HandleInfoBase<HandleType, InfoType>::verifyHandle
         }
 
         // Try to find the handle in the appropriate map
-        UniqueLock lock(dispatch_mutex_);
-        auto entry_returned = info_map_.find(*handle_to_check);
+        Shard &shard = shardFor(*handle_to_check);
+        SharedLock lock(shard.mutex);
+        auto entry_returned = shard.map.find(*handle_to_check);
         // If it is not a valid handle, it should return the end of the map.
-        if (info_map_.end() == entry_returned) {
+        if (shard.map.end() == entry_returned) {
             return VALIDATE_XR_HANDLE_INVALID;
         }
         return VALIDATE_XR_HANDLE_SUCCESS;
@@ -254,40 +789,54 @@ inline InfoType *HandleInfoBase<HandleType, InfoType>::get(HandleType handle) {
         reportInternalError("Null handle passed to HandleInfoBase::get()");
     }
     // Try to find the handle in the appropriate map
-    UniqueLock lock(dispatch_mutex_);
-    auto entry_returned = info_map_.find(handle);
-    if (entry_returned == info_map_.end()) {
+    Shard &shard = shardFor(handle);
+    SharedLock lock(shard.mutex);
+    auto entry_returned = shard.map.find(handle);
+    if (entry_returned == shard.map.end()) {
         reportInternalError("Handle passed to HandleInfoBase::insert() not inserted");
     }
     return entry_returned->second.get();
 }
 
 template <typename HandleType, typename InfoType>
-inline std::pair<UniqueLock, InfoType *> HandleInfoBase<HandleType, InfoType>::getWithLock(HandleType handle) {
+inline std::pair<ExclusiveLock, InfoType *> HandleInfoBase<HandleType, InfoType>::getWithLock(HandleType handle) {
     if (handle == XR_NULL_HANDLE) {
         reportInternalError("Null handle passed to HandleInfoBase::getWithLock()");
     }
     // Try to find the handle in the appropriate map
-    UniqueLock lock(dispatch_mutex_);
-    auto it = info_map_.find(handle);
+    Shard &shard = shardFor(handle);
+    ExclusiveLock lock(shard.mutex);
+    auto it = shard.map.find(handle);
     // If it is not a valid handle, it should return the end of the map.
-    if (info_map_.end() == it) {
+    if (shard.map.end() == it) {
         return {std::move(lock), nullptr};
     }
     return {std::move(lock), it->second.get()};
 }
 
+template <typename HandleType, typename InfoType>
+inline bool HandleInfoBase<HandleType, InfoType>::empty() {
+    for (Shard &shard : shards_) {
+        SharedLock lock(shard.mutex);
+        if (!shard.map.empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 template <typename HandleType, typename InfoType>
 inline void HandleInfoBase<HandleType, InfoType>::insert(HandleType handle, std::unique_ptr<InfoType> &&info) {
     if (handle == XR_NULL_HANDLE) {
         reportInternalError("Null handle passed to HandleInfoBase::insert()");
     }
-    UniqueLock lock(dispatch_mutex_);
-    auto entry_returned = info_map_.find(handle);
-    if (entry_returned != info_map_.end()) {
+    Shard &shard = shardFor(handle);
+    ExclusiveLock lock(shard.mutex);
+    auto entry_returned = shard.map.find(handle);
+    if (entry_returned != shard.map.end()) {
         reportInternalError("Handle passed to HandleInfoBase::insert() already inserted");
     }
-    info_map_[handle] = std::move(info);
+    shard.map[handle] = std::move(info);
 }
 
 template <typename HandleType, typename InfoType>
@@ -295,12 +844,22 @@ inline void HandleInfoBase<HandleType, InfoType>::erase(HandleType handle) {
     if (handle == XR_NULL_HANDLE) {
         reportInternalError("Null handle passed to HandleInfoBase::erase()");
     }
-    UniqueLock lock(dispatch_mutex_);
-    auto entry_returned = info_map_.find(handle);
-    if (entry_returned == info_map_.end()) {
+    Shard &shard = shardFor(handle);
+    ExclusiveLock lock(shard.mutex);
+    auto entry_returned = shard.map.find(handle);
+    if (entry_returned == shard.map.end()) {
         reportInternalError("Handle passed to HandleInfoBase::insert() not inserted");
     }
-    info_map_.erase(handle);
+    shard.map.erase(entry_returned);
+}
+
+template <typename HandleType, typename InfoType>
+template <typename Pred>
+inline void HandleInfoBase<HandleType, InfoType>::eraseIf(Pred &&pred) {
+    for (Shard &shard : shards_) {
+        ExclusiveLock lock(shard.mutex);
+        map_erase_if(shard.map, pred);
+    }
 }
 
 template <typename HandleType>
@@ -310,9 +869,10 @@ inline std::pair<GenValidUsageXrHandleInfo *, GenValidUsageXrInstanceInfo *> Han
         reportInternalError("Null handle passed to HandleInfoBase::getWithInstanceInfo()");
     }
     // Try to find the handle in the appropriate map
-    UniqueLock lock(this->dispatch_mutex_);
-    auto entry_returned = this->info_map_.find(handle);
-    if (entry_returned == this->info_map_.end()) {
+    auto &shard = this->shardFor(handle);
+    SharedLock lock(shard.mutex);
+    auto entry_returned = shard.map.find(handle);
+    if (entry_returned == shard.map.end()) {
         reportInternalError("Handle passed to HandleInfoBase::getWithInstanceInfo() not inserted");
     }
     GenValidUsageXrHandleInfo *info = entry_returned->second.get();
@@ -323,8 +883,130 @@ inline std::pair<GenValidUsageXrHandleInfo *, GenValidUsageXrInstanceInfo *> Han
 template <typename HandleType>
 inline void HandleInfo<HandleType>::removeHandlesForInstance(GenValidUsageXrInstanceInfo *search_value) {
     typedef typename base_t::value_t value_t;
-    UniqueLock lock(this->dispatch_mutex_);
-    map_erase_if(this->info_map_, [=](value_t const &data) { return data.second && data.second->instance_info == search_value; });
+    this->eraseIf([=](value_t const &data) { return data.second && data.second->instance_info == search_value; });
+}
+
+template <typename HandleType>
+inline ValidateXrHandleResult WrappedHandleInfo<HandleType>::verifyHandle(HandleType const *handle_to_check) {
+    if (nullptr == handle_to_check) {
+        return VALIDATE_XR_HANDLE_INVALID;
+    }
+    // XR_NULL_HANDLE is valid in some cases, so we want to return that we found that value
+    // and let the calling function decide what to do with it.
+    if (*handle_to_check == XR_NULL_HANDLE) {
+        return VALIDATE_XR_HANDLE_NULL;
+    }
+    return find(*handle_to_check) != nullptr ? VALIDATE_XR_HANDLE_SUCCESS : VALIDATE_XR_HANDLE_INVALID;
+}
+
+template <typename HandleType>
+inline GenValidUsageXrHandleInfo *WrappedHandleInfo<HandleType>::get(HandleType handle) {
+    if (handle == XR_NULL_HANDLE) {
+        reportInternalError("Null handle passed to WrappedHandleInfo::get()");
+    }
+    // Shared with erase and wrap, which release and refill wrappers.
+    SharedLock lock(mutex_);
+    GenValidUsageWrappedHandle *wrapper = find(handle);
+    if (wrapper == nullptr) {
+        reportInternalError("Handle passed to WrappedHandleInfo::get() not wrapped");
+    }
+    return &wrapper->info;
+}
+
+template <typename HandleType>
+inline std::pair<ExclusiveLock, GenValidUsageXrHandleInfo *> WrappedHandleInfo<HandleType>::getWithLock(HandleType handle) {
+    if (handle == XR_NULL_HANDLE) {
+        reportInternalError("Null handle passed to WrappedHandleInfo::getWithLock()");
+    }
+    ExclusiveLock lock(mutex_);
+    GenValidUsageWrappedHandle *wrapper = find(handle);
+    return {std::move(lock), wrapper != nullptr ? &wrapper->info : nullptr};
+}
+
+template <typename HandleType>
+inline std::pair<GenValidUsageXrHandleInfo *, GenValidUsageXrInstanceInfo *> WrappedHandleInfo<HandleType>::getWithInstanceInfo(
+    HandleType handle) {
+    GenValidUsageXrHandleInfo *info = get(handle);
+    return {info, info->instance_info};
+}
+
+template <typename HandleType>
+inline bool WrappedHandleInfo<HandleType>::empty() {
+    SharedLock lock(mutex_);
+    return wrapped_.empty();
+}
+
+template <typename HandleType>
+inline HandleType WrappedHandleInfo<HandleType>::wrap(HandleType next_handle, std::unique_ptr<GenValidUsageXrHandleInfo> &&info) {
+    if (next_handle == XR_NULL_HANDLE) {
+        reportInternalError("Null handle passed to WrappedHandleInfo::wrap()");
+    }
+    ExclusiveLock lock(mutex_);
+    GenValidUsageWrappedHandle *&entry = wrapped_[MakeHandleGeneric(next_handle)];
+    if (entry != nullptr) {
+        reportInternalError("Handle passed to WrappedHandleInfo::wrap() already wrapped");
+    }
+    GenValidUsageWrappedHandle *wrapper = GenValidUsageAllocateWrappedHandle();
+    wrapper->owner = this;
+    wrapper->next_handle = MakeHandleGeneric(next_handle);
+    wrapper->info = *info;
+    wrapper->tag.store(kGenValidUsageWrappedHandleTag, std::memory_order_release);
+    entry = wrapper;
+    const uint64_t application_handle = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(wrapper));
+    returned_.insert(application_handle);
+    return TreatIntegerAsHandle<HandleType>(application_handle);
+}
+
+template <typename HandleType>
+inline HandleType WrappedHandleInfo<HandleType>::wrapReturned(HandleType next_handle, GenValidUsageXrInstanceInfo *instance_info,
+                                                              XrObjectType parent_type, uint64_t parent_handle) {
+    if (next_handle == XR_NULL_HANDLE) {
+        return next_handle;
+    }
+    {
+        SharedLock lock(mutex_);
+        auto it = wrapped_.find(MakeHandleGeneric(next_handle));
+        if (it != wrapped_.end()) {
+            return TreatIntegerAsHandle<HandleType>(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(it->second)));
+        }
+        if (returned_.count(MakeHandleGeneric(next_handle)) != 0) {
+            return next_handle;
+        }
+    }
+    std::unique_ptr<GenValidUsageXrHandleInfo> info(new GenValidUsageXrHandleInfo());
+    info->instance_info = instance_info;
+    info->direct_parent_type = parent_type;
+    info->direct_parent_handle = parent_handle;
+    return wrap(next_handle, std::move(info));
+}
+
+template <typename HandleType>
+inline void WrappedHandleInfo<HandleType>::erase(HandleType handle) {
+    if (handle == XR_NULL_HANDLE) {
+        reportInternalError("Null handle passed to WrappedHandleInfo::erase()");
+    }
+    ExclusiveLock lock(mutex_);
+    GenValidUsageWrappedHandle *wrapper = find(handle);
+    if (wrapper == nullptr) {
+        reportInternalError("Handle passed to WrappedHandleInfo::erase() not wrapped");
+    }
+    wrapped_.erase(wrapper->next_handle);
+    returned_.erase(MakeHandleGeneric(handle));
+    GenValidUsageReleaseWrappedHandle(wrapper);
+}
+
+template <typename HandleType>
+inline void WrappedHandleInfo<HandleType>::removeHandlesForInstance(GenValidUsageXrInstanceInfo *search_value) {
+    ExclusiveLock lock(mutex_);
+    for (auto it = wrapped_.begin(); it != wrapped_.end();) {
+        if (it->second->info.instance_info == search_value) {
+            returned_.erase(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(it->second)));
+            GenValidUsageReleaseWrappedHandle(it->second);
+            it = wrapped_.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
 
 #endif  // VALIDATION_UTILS_H_
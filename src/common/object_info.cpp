@@ -108,8 +108,19 @@ static std::vector<XrDebugUtilsObjectNameInfoEXT> PopulateObjectNameInfo(std::ve
     return ret;
 }
 
+// Copy each label name into names and point the label at the copy.
+static void CopyLabelNames(std::vector<XrDebugUtilsLabelEXT>& labels, std::vector<std::string>& names) {
+    names.reserve(labels.size());
+    for (auto& label : labels) {
+        names.emplace_back(label.labelName != nullptr ? label.labelName : "");
+        label.labelName = names.back().c_str();
+    }
+}
+
 NamesAndLabels::NamesAndLabels(std::vector<XrSdkLogObjectInfo> obj, std::vector<XrDebugUtilsLabelEXT> lab)
-    : sdk_objects(std::move(obj)), objects(PopulateObjectNameInfo(sdk_objects)), labels(std::move(lab)) {}
+    : sdk_objects(std::move(obj)), objects(PopulateObjectNameInfo(sdk_objects)), labels(std::move(lab)) {
+    CopyLabelNames(labels, label_names);
+}
 
 void NamesAndLabels::PopulateCallbackData(XrDebugUtilsMessengerCallbackDataEXT& callback_data) const {
     callback_data.objects = objects.empty() ? nullptr : const_cast<XrDebugUtilsObjectNameInfoEXT*>(objects.data());
@@ -265,9 +276,14 @@ void DebugUtilsData::WrapCallbackData(AugmentedCallbackData* aug_data,
     aug_data->new_objects.assign(callback_data->objects, callback_data->objects + callback_data->objectCount);
 
     // Record (overwrite) the names of all incoming objects provided in our internal list
+    aug_data->object_names.reserve(aug_data->new_objects.size());
     for (auto& obj : aug_data->new_objects) {
-        object_info_.LookUpObjectName(obj);
+        if (object_info_.LookUpObjectName(obj)) {
+            aug_data->object_names.emplace_back(obj.objectName);
+            obj.objectName = aug_data->object_names.back().c_str();
+        }
     }
+    CopyLabelNames(aug_data->labels, aug_data->label_names);
 
     // Update local copy & point export to it
     aug_data->modified_data.objects = aug_data->new_objects.data();
@@ -164,6 +164,8 @@ struct NamesAndLabels {
 
     std::vector<XrDebugUtilsObjectNameInfoEXT> objects;
     std::vector<XrDebugUtilsLabelEXT> labels;
+    /// Copies of the label names, so the labels stay valid after the DebugUtilsData changes.
+    std::vector<std::string> label_names;
 
     /// Populate the debug utils callback data structure.
     void PopulateCallbackData(XrDebugUtilsMessengerCallbackDataEXT& data) const;
@@ -173,6 +175,9 @@ struct NamesAndLabels {
 struct AugmentedCallbackData {
     std::vector<XrDebugUtilsLabelEXT> labels;
     std::vector<XrDebugUtilsObjectNameInfoEXT> new_objects;
+    /// Copies of the names and labels found in the DebugUtilsData, which the modified data points at instead.
+    std::vector<std::string> object_names;
+    std::vector<std::string> label_names;
     XrDebugUtilsMessengerCallbackDataEXT modified_data;
     const XrDebugUtilsMessengerCallbackDataEXT* exported_data;
 };
@@ -0,0 +1,122 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0 OR MIT
+//
+
+/*!
+ * @file
+ *
+ * Loader-provided per-handle data slots for API layers.
+ *
+ * Rather than every layer keeping its own handle-to-info map behind its own mutex, a layer asks the
+ * loader for the shared table once it has created its instance (by querying
+ * XR_LOADER_LAYER_HANDLE_DATA_FUNCTION_NAME through its next xrGetInstanceProcAddr), acquires a slot
+ * index, and stores one pointer per handle in that slot when the handle is created.  Lookups are
+ * lock-free and usually resolve with a single probe; only slot updates take the loader's lock.
+ *
+ * Every entry carries a sequence number that is odd while the loader rewrites it, so a lookup that
+ * raced with the removal and reuse of its entry retries rather than returning another handle's data.
+ * The loader compacts the table in place once removed entries build up; the table generation is odd
+ * while it does, and lookups retry when it changed under them.
+ *
+ * The loader does not wrap handles, so the table is keyed by handle value and object type.  Layers
+ * must keep a fallback path for loaders that do not provide the table, or when it is full.
+ */
+
+#pragma once
+
+#include <openxr/openxr.h>
+
+#include <atomic>
+#include <stdint.h>
+#include <thread>
+
+#define XR_LOADER_LAYER_HANDLE_DATA_FUNCTION_NAME "xrGetLayerHandleDataTableLOADER"
+#define XR_LOADER_LAYER_HANDLE_DATA_TABLE_VERSION 2
+
+//! Number of layers that can hold a slot at the same time.
+constexpr uint32_t kXrLayerHandleDataMaxSlots = 8;
+//! Number of live handles the table can track.  Must be a power of two.
+constexpr uint32_t kXrLayerHandleDataCapacity = 4096;
+//! Handle value marking an entry whose handle has been removed; probing continues past it.
+constexpr uint64_t kXrLayerHandleDataTombstone = UINT64_MAX;
+
+struct XrLayerHandleDataEntry {
+    std::atomic<uint32_t> sequence;
+    std::atomic<uint64_t> handle;
+    std::atomic<int32_t> object_type;
+    std::atomic<void*> slots[kXrLayerHandleDataMaxSlots];
+};
+
+struct XrLayerHandleDataTable;
+
+//! Returns the slot index reserved for layer_name, reserving one if needed.  Calling it again with the
+//! same name returns the same slot.  Fails with XR_ERROR_LIMIT_REACHED when every slot is taken.
+typedef XrResult(XRAPI_PTR* PFN_XrLayerHandleDataAcquireSlot)(const char* layer_name, uint32_t* slot);
+
+//! Stores data for handle in slot.  Passing nullptr clears the slot, and the entry is released once
+//! no layer holds data for the handle any more.  Fails with XR_ERROR_LIMIT_REACHED when the table is full.
+typedef XrResult(XRAPI_PTR* PFN_XrLayerHandleDataSet)(XrObjectType object_type, uint64_t handle, uint32_t slot, void* data);
+
+struct XrLayerHandleDataTable {
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t max_slots;
+    PFN_XrLayerHandleDataAcquireSlot acquire_slot;
+    PFN_XrLayerHandleDataSet set;
+    std::atomic<uint32_t> generation;
+    XrLayerHandleDataEntry entries[kXrLayerHandleDataCapacity];
+};
+
+//! Signature of the function returned for XR_LOADER_LAYER_HANDLE_DATA_FUNCTION_NAME.
+typedef XrResult(XRAPI_PTR* PFN_xrGetLayerHandleDataTableLOADER)(XrInstance instance, XrLayerHandleDataTable** table);
+
+//! First probe position for a handle: a 64-bit finalizer mix, since handles are often aligned pointers.
+inline uint32_t XrLayerHandleDataIndex(uint64_t handle) {
+    handle ^= handle >> 33;
+    handle *= 0xff51afd7ed558ccdULL;
+    handle ^= handle >> 33;
+    return static_cast<uint32_t>(handle) & (kXrLayerHandleDataCapacity - 1);
+}
+
+//! True if a table returned by the loader has the layout this header describes.
+inline bool XrLayerHandleDataTableIsCompatible(const XrLayerHandleDataTable* table) {
+    return table != nullptr && table->version == XR_LOADER_LAYER_HANDLE_DATA_TABLE_VERSION &&
+           table->capacity == kXrLayerHandleDataCapacity && table->max_slots == kXrLayerHandleDataMaxSlots;
+}
+
+//! Lock-free lookup of the data a layer stored for handle.  Returns nullptr if there is none.
+inline void* XrLayerHandleDataGet(const XrLayerHandleDataTable* table, XrObjectType object_type, uint64_t handle,
+                                  uint32_t slot) {
+    for (;;) {
+        const uint32_t generation = table->generation.load(std::memory_order_acquire);
+        if ((generation & 1) != 0) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        void* data = nullptr;
+        bool consistent = true;
+        uint32_t index = XrLayerHandleDataIndex(handle);
+        for (uint32_t probe = 0; probe < kXrLayerHandleDataCapacity; ++probe) {
+            const XrLayerHandleDataEntry& entry = table->entries[index];
+            const uint32_t sequence = entry.sequence.load(std::memory_order_acquire);
+            const uint64_t key = entry.handle.load(std::memory_order_relaxed);
+            if (key == 0) {
+                break;
+            }
+            if (key == handle && entry.object_type.load(std::memory_order_relaxed) == static_cast<int32_t>(object_type)) {
+                data = entry.slots[slot].load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                consistent = (sequence & 1) == 0 && entry.sequence.load(std::memory_order_relaxed) == sequence;
+                break;
+            }
+            index = (index + 1) & (kXrLayerHandleDataCapacity - 1);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (consistent && table->generation.load(std::memory_order_relaxed) == generation) {
+            return data;
+        }
+    }
+}
@@ -16,6 +16,7 @@
 #include "hex_and_handles.h"
 #include "loader_init_data.hpp"
 #include "loader_instance.hpp"
+#include "loader_layer_handle_data.hpp"
 #include "loader_logger_recorders.hpp"
 #include "loader_logger.hpp"
 #include "loader_platform.hpp"
@@ -62,6 +63,17 @@ static XRAPI_ATTR XrResult XRAPI_CALL LoaderXrTermSubmitDebugUtilsMessageEXT(
 static XRAPI_ATTR XrResult XRAPI_CALL LoaderXrGetInstanceProcAddr(XrInstance instance, const char *name,
                                                                   PFN_xrVoidFunction *function);
 
+// Terminal function of xrGetLayerHandleDataTableLOADER, which hands the shared per-handle data slot table to API layers.
+static XRAPI_ATTR XrResult XRAPI_CALL LoaderXrTermGetLayerHandleDataTableLOADER(XrInstance /*instance*/,
+                                                                                XrLayerHandleDataTable **table) XRLOADER_ABI_TRY {
+    if (nullptr == table) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    *table = LayerHandleData::GetTable();
+    return XR_SUCCESS;
+}
+XRLOADER_ABI_CATCH_BAD_ALLOC_OOM XRLOADER_ABI_CATCH_FALLBACK
+
 // Utility template function meant to validate if a fixed size string contains
 // a null-terminator.
 template <size_t max_length>
@@ -437,6 +449,7 @@ static XRAPI_ATTR XrResult XRAPI_CALL LoaderXrTermCreateApiLayerInstance(const X
 static XRAPI_ATTR XrResult XRAPI_CALL LoaderXrTermDestroyInstance(XrInstance instance) XRLOADER_ABI_TRY {
     LoaderLogger::LogVerboseMessage("xrDestroyInstance", "Entering loader terminator");
     LoaderLogger::GetInstance().RemoveLogRecordersForXrInstance(instance);
+    LayerHandleData::Reset();
     XrResult result = RuntimeInterface::GetRuntime().DestroyInstance(instance);
     LoaderLogger::LogVerboseMessage("xrDestroyInstance", "Completed loader terminator");
     return result;
@@ -470,6 +483,8 @@ static XRAPI_ATTR XrResult XRAPI_CALL LoaderXrTermGetInstanceProcAddr(XrInstance
         // Special layer version of xrCreateInstance terminator.  If we get called this by a layer,
         // we simply re-direct the information back into the standard xrCreateInstance terminator.
         *function = reinterpret_cast<PFN_xrVoidFunction>(LoaderXrTermCreateApiLayerInstance);
+    } else if (0 == strcmp(name, XR_LOADER_LAYER_HANDLE_DATA_FUNCTION_NAME)) {
+        *function = reinterpret_cast<PFN_xrVoidFunction>(LoaderXrTermGetLayerHandleDataTableLOADER);
     }
 
     if (nullptr != *function) {
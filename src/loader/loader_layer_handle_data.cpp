@@ -0,0 +1,249 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0 OR MIT
+//
+
+#include "loader_layer_handle_data.hpp"
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Readers never take this; it only serializes slot reservation and entry insertion/removal.
+std::mutex& GetWriteMutex() {
+    static std::mutex write_mutex;
+    return write_mutex;
+}
+
+std::array<std::string, kXrLayerHandleDataMaxSlots>& GetSlotOwners() {
+    static std::array<std::string, kXrLayerHandleDataMaxSlots> slot_owners;
+    return slot_owners;
+}
+
+std::unique_ptr<XrLayerHandleDataTable>& GetTableStorage() {
+    static std::unique_ptr<XrLayerHandleDataTable> table;
+    return table;
+}
+
+// Removed entries still in the table.  Guarded by the write mutex.
+uint32_t& GetTombstoneCount() {
+    static uint32_t tombstones = 0;
+    return tombstones;
+}
+
+// The table is compacted once this many removed entries lengthen its probe chains.
+constexpr uint32_t kTombstoneCompactThreshold = kXrLayerHandleDataCapacity / 4;
+
+XRAPI_ATTR XrResult XRAPI_CALL AcquireSlot(const char* layer_name, uint32_t* slot) {
+    if (layer_name == nullptr || layer_name[0] == '\0' || slot == nullptr) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    std::unique_lock<std::mutex> lock(GetWriteMutex());
+    auto& owners = GetSlotOwners();
+    for (uint32_t i = 0; i < kXrLayerHandleDataMaxSlots; ++i) {
+        if (owners[i] == layer_name) {
+            *slot = i;
+            return XR_SUCCESS;
+        }
+    }
+    for (uint32_t i = 0; i < kXrLayerHandleDataMaxSlots; ++i) {
+        if (owners[i].empty()) {
+            owners[i] = layer_name;
+            *slot = i;
+            return XR_SUCCESS;
+        }
+    }
+    return XR_ERROR_LIMIT_REACHED;
+}
+
+bool EntryIsEmpty(const XrLayerHandleDataEntry& entry) {
+    for (const auto& slot : entry.slots) {
+        if (slot.load(std::memory_order_relaxed) != nullptr) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t NextIndex(uint32_t index) { return (index + 1) & (kXrLayerHandleDataCapacity - 1); }
+uint32_t PreviousIndex(uint32_t index) { return (index - 1) & (kXrLayerHandleDataCapacity - 1); }
+
+// Rewrites an entry between two sequence number increments, so that a reader that saw any part of
+// the change retries.  Caller must hold the write mutex.
+template <typename Modify>
+void RewriteEntry(XrLayerHandleDataEntry& entry, Modify&& modify) {
+    const uint32_t sequence = entry.sequence.load(std::memory_order_relaxed);
+    entry.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    modify();
+    entry.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void FillEntry(XrLayerHandleDataEntry& entry, XrObjectType object_type, uint64_t handle, void* const* slots) {
+    RewriteEntry(entry, [&] {
+        for (uint32_t i = 0; i < kXrLayerHandleDataMaxSlots; ++i) {
+            entry.slots[i].store(slots[i], std::memory_order_relaxed);
+        }
+        entry.object_type.store(static_cast<int32_t>(object_type), std::memory_order_relaxed);
+        entry.handle.store(handle, std::memory_order_relaxed);
+    });
+}
+
+// Removes the entry at index.  When the entry after it is free, no probe chain continues past it, so
+// it and the removed entries just before it become free too rather than tombstones.
+void RemoveEntry(XrLayerHandleDataTable* table, uint32_t index) {
+    uint32_t& tombstones = GetTombstoneCount();
+    if (table->entries[NextIndex(index)].handle.load(std::memory_order_relaxed) != 0) {
+        RewriteEntry(table->entries[index],
+                     [&] { table->entries[index].handle.store(kXrLayerHandleDataTombstone, std::memory_order_relaxed); });
+        ++tombstones;
+        return;
+    }
+    RewriteEntry(table->entries[index], [&] { table->entries[index].handle.store(0, std::memory_order_relaxed); });
+    for (index = PreviousIndex(index); table->entries[index].handle.load(std::memory_order_relaxed) == kXrLayerHandleDataTombstone;
+         index = PreviousIndex(index)) {
+        RewriteEntry(table->entries[index], [&] { table->entries[index].handle.store(0, std::memory_order_relaxed); });
+        --tombstones;
+    }
+}
+
+// Reinserts every live entry so that no tombstones are left.  Readers retry while the generation is odd.
+// Caller must hold the write mutex.
+void Compact(XrLayerHandleDataTable* table) {
+    struct LiveEntry {
+        uint64_t handle;
+        XrObjectType object_type;
+        void* slots[kXrLayerHandleDataMaxSlots];
+    };
+    std::vector<LiveEntry> live;
+    for (const auto& entry : table->entries) {
+        const uint64_t key = entry.handle.load(std::memory_order_relaxed);
+        if (key != 0 && key != kXrLayerHandleDataTombstone) {
+            LiveEntry copy{key, static_cast<XrObjectType>(entry.object_type.load(std::memory_order_relaxed)), {}};
+            for (uint32_t i = 0; i < kXrLayerHandleDataMaxSlots; ++i) {
+                copy.slots[i] = entry.slots[i].load(std::memory_order_relaxed);
+            }
+            live.push_back(copy);
+        }
+    }
+
+    const uint32_t generation = table->generation.load(std::memory_order_relaxed);
+    table->generation.store(generation + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (auto& entry : table->entries) {
+        if (entry.handle.load(std::memory_order_relaxed) != 0) {
+            RewriteEntry(entry, [&] { entry.handle.store(0, std::memory_order_relaxed); });
+        }
+    }
+    for (const LiveEntry& copy : live) {
+        uint32_t index = XrLayerHandleDataIndex(copy.handle);
+        while (table->entries[index].handle.load(std::memory_order_relaxed) != 0) {
+            index = NextIndex(index);
+        }
+        FillEntry(table->entries[index], copy.object_type, copy.handle, copy.slots);
+    }
+    table->generation.store(generation + 2, std::memory_order_release);
+    GetTombstoneCount() = 0;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL SetData(XrObjectType object_type, uint64_t handle, uint32_t slot, void* data) {
+    if (handle == 0 || handle == kXrLayerHandleDataTombstone || slot >= kXrLayerHandleDataMaxSlots) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    std::unique_lock<std::mutex> lock(GetWriteMutex());
+    XrLayerHandleDataTable* table = GetTableStorage().get();
+    if (table == nullptr) {
+        return XR_ERROR_RUNTIME_FAILURE;
+    }
+
+    // Find the existing entry, remembering the first reusable one in case there is none.
+    XrLayerHandleDataEntry* reusable = nullptr;
+    uint32_t index = XrLayerHandleDataIndex(handle);
+    for (uint32_t probe = 0; probe < kXrLayerHandleDataCapacity; ++probe) {
+        XrLayerHandleDataEntry& entry = table->entries[index];
+        const uint64_t key = entry.handle.load(std::memory_order_relaxed);
+        if (key == handle && entry.object_type.load(std::memory_order_relaxed) == static_cast<int32_t>(object_type)) {
+            RewriteEntry(entry, [&] { entry.slots[slot].store(data, std::memory_order_relaxed); });
+            if (data == nullptr && EntryIsEmpty(entry)) {
+                RemoveEntry(table, index);
+                if (GetTombstoneCount() >= kTombstoneCompactThreshold) {
+                    Compact(table);
+                }
+            }
+            return XR_SUCCESS;
+        }
+        if (key == kXrLayerHandleDataTombstone && reusable == nullptr) {
+            reusable = &entry;
+        }
+        if (key == 0) {
+            if (reusable == nullptr) {
+                reusable = &entry;
+            }
+            break;
+        }
+        index = NextIndex(index);
+    }
+
+    if (data == nullptr) {
+        return XR_SUCCESS;
+    }
+    if (reusable == nullptr) {
+        return XR_ERROR_LIMIT_REACHED;
+    }
+    if (reusable->handle.load(std::memory_order_relaxed) == kXrLayerHandleDataTombstone) {
+        --GetTombstoneCount();
+    }
+
+    void* slots[kXrLayerHandleDataMaxSlots] = {};
+    slots[slot] = data;
+    FillEntry(*reusable, object_type, handle, slots);
+    return XR_SUCCESS;
+}
+
+void ClearEntries(XrLayerHandleDataTable* table) {
+    table->generation.store(0, std::memory_order_relaxed);
+    for (auto& entry : table->entries) {
+        entry.sequence.store(0, std::memory_order_relaxed);
+        entry.handle.store(0, std::memory_order_relaxed);
+        entry.object_type.store(0, std::memory_order_relaxed);
+        for (auto& slot : entry.slots) {
+            slot.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+    GetTombstoneCount() = 0;
+}
+
+}  // namespace
+
+namespace LayerHandleData {
+
+XrLayerHandleDataTable* GetTable() {
+    std::unique_lock<std::mutex> lock(GetWriteMutex());
+    auto& table = GetTableStorage();
+    if (!table) {
+        table = std::make_unique<XrLayerHandleDataTable>();
+        table->version = XR_LOADER_LAYER_HANDLE_DATA_TABLE_VERSION;
+        table->capacity = kXrLayerHandleDataCapacity;
+        table->max_slots = kXrLayerHandleDataMaxSlots;
+        table->acquire_slot = AcquireSlot;
+        table->set = SetData;
+        ClearEntries(table.get());
+    }
+    return table.get();
+}
+
+void Reset() {
+    std::unique_lock<std::mutex> lock(GetWriteMutex());
+    for (auto& owner : GetSlotOwners()) {
+        owner.clear();
+    }
+    if (GetTableStorage()) {
+        ClearEntries(GetTableStorage().get());
+    }
+}
+
+}  // namespace LayerHandleData
@@ -0,0 +1,16 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0 OR MIT
+//
+
+#pragma once
+
+#include "xr_layer_handle_data.h"
+
+// Owns the per-handle data slot table that API layers share (see xr_layer_handle_data.h).
+namespace LayerHandleData {
+// Returns the table, allocating it the first time a layer asks for it.
+XrLayerHandleDataTable* GetTable();
+// Drop every entry and slot reservation.  Called when the instance is destroyed.
+void Reset();
+}  // namespace LayerHandleData
@@ -182,7 +182,12 @@ bool LoaderLogger::LogMessage(XrLoaderLogMessageSeverityFlagBits message_severit
     callback_data.command_name = command_name.c_str();
     callback_data.message = message.c_str();
 
-    auto names_and_labels = data_.PopulateNamesAndLabels(objects);
+    // The names and labels are copied out under the lock, so the recorders run without holding it.
+    NamesAndLabels names_and_labels;
+    {
+        std::lock_guard<std::mutex> data_lock(_data_mutex);
+        names_and_labels = data_.PopulateNamesAndLabels(objects);
+    }
     callback_data.objects = names_and_labels.sdk_objects.empty() ? nullptr : names_and_labels.sdk_objects.data();
     callback_data.object_count = static_cast<uint8_t>(names_and_labels.objects.size());
 
@@ -209,7 +214,10 @@ bool LoaderLogger::LogDebugUtilsMessage(XrDebugUtilsMessageSeverityFlagsEXT mess
     XrLoaderLogMessageTypeFlags log_message_type = DebugUtilsMessageTypesToLoaderLogMessageTypes(message_type);
 
     AugmentedCallbackData augmented_data;
-    data_.WrapCallbackData(&augmented_data, callback_data);
+    {
+        std::lock_guard<std::mutex> data_lock(_data_mutex);
+        data_.WrapCallbackData(&augmented_data, callback_data);
+    }
 
     // Loop through the recorders
     std::shared_lock<std::shared_timed_mutex> lock(_mutex);
@@ -227,17 +235,26 @@ bool LoaderLogger::LogDebugUtilsMessage(XrDebugUtilsMessageSeverityFlagsEXT mess
 }
 
 void LoaderLogger::AddObjectName(uint64_t object_handle, XrObjectType object_type, const std::string& object_name) {
+    std::lock_guard<std::mutex> data_lock(_data_mutex);
     data_.AddObjectName(object_handle, object_type, object_name);
 }
 
 void LoaderLogger::BeginLabelRegion(XrSession session, const XrDebugUtilsLabelEXT* label_info) {
+    std::lock_guard<std::mutex> data_lock(_data_mutex);
     data_.BeginLabelRegion(session, *label_info);
 }
 
-void LoaderLogger::EndLabelRegion(XrSession session) { data_.EndLabelRegion(session); }
+void LoaderLogger::EndLabelRegion(XrSession session) {
+    std::lock_guard<std::mutex> data_lock(_data_mutex);
+    data_.EndLabelRegion(session);
+}
 
 void LoaderLogger::InsertLabel(XrSession session, const XrDebugUtilsLabelEXT* label_info) {
+    std::lock_guard<std::mutex> data_lock(_data_mutex);
     data_.InsertLabel(session, *label_info);
 }
 
-void LoaderLogger::DeleteSessionLabels(XrSession session) { data_.DeleteSessionLabels(session); }
+void LoaderLogger::DeleteSessionLabels(XrSession session) {
+    std::lock_guard<std::mutex> data_lock(_data_mutex);
+    data_.DeleteSessionLabels(session);
+}
@@ -182,6 +182,9 @@ class LoaderLogger {
     // List of recorder objects only created specifically for an XrInstance
     std::unordered_map<XrInstance, std::unordered_set<uint64_t>> _recordersByInstance;
 
+    // Guards data_, which the label commands may change from any thread.  Never held while a recorder runs:
+    // messages carry copies of the names and labels, so a callback may name an object or add a label.
+    std::mutex _data_mutex;
     DebugUtilsData data_;
 };
 
@@ -40,6 +40,13 @@ MANUALLY_DEFINED_IN_LAYER = set((
     'xrDestroyInstance',
 ))
 
+# Functions implemented by or for the loader, which the layer never sees
+LOADER_FUNCTIONS = [
+    'xrInitializeLoaderKHR',
+    'xrNegotiateLoaderRuntimeInterface',
+    'xrNegotiateLoaderApiLayerInterface',
+]
+
 LOADER_STRUCTS = [
     'XrApiLayerNextInfo',
     'XrApiLayerCreateInfo',
@@ -75,21 +82,34 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
             preamble += '#include "api_layer_platform_defines.h"\n'
             preamble += '#include <openxr/openxr.h>\n'
             preamble += '#include <openxr/openxr_platform.h>\n\n'
+            preamble += '#include "api_dump_filter.h"\n'
+            preamble += '#include "api_dump_format.h"\n\n'
             preamble += '#include <mutex>\n'
             preamble += '#include <string>\n'
-            preamble += '#include <tuple>\n'
+            preamble += '#include <string_view>\n'
             preamble += '#include <unordered_map>\n'
             preamble += '#include <vector>\n\n'
             preamble += 'struct XrGeneratedDispatchTable;\n\n'
         elif self.genOpts.filename == 'xr_generated_api_dump.cpp':
             preamble += '#include "xr_generated_api_dump.hpp"\n'
             preamble += '#include "xr_generated_dispatch_table.h"\n'
+            preamble += '#include "api_dump_binary.h"\n'
             preamble += '#include "hex_and_handles.h"\n\n'
+            preamble += '#include <cstdio>\n'
             preamble += '#include <cstring>\n'
             preamble += '#include <mutex>\n'
-            preamble += '#include <sstream>\n'
-            preamble += '#include <iomanip>\n'
+            preamble += '#include <stdexcept>\n'
             preamble += '#include <unordered_map>\n\n'
+        elif self.genOpts.filename == 'xr_generated_api_dump_binary.cpp':
+            preamble += '#include "xr_generated_api_dump.hpp"\n'
+            preamble += '#include "api_dump_binary.h"\n'
+            preamble += '#include "api_dump_format.h"\n'
+            preamble += '#include "hex_and_handles.h"\n\n'
+            preamble += '#include <cstddef>\n'
+            preamble += '#include <cstring>\n'
+            preamble += '#include <string>\n'
+            preamble += '#include <string_view>\n'
+            preamble += '#include <vector>\n\n'
         write(preamble, file=self.outFile)
 
     # Write out all the information for the appropriate file,
@@ -100,12 +120,18 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
         if self.genOpts.filename == 'xr_generated_api_dump.hpp':
             file_data += self.outputLayerHeaderPrototypes()
             file_data += self.outputApiDumpExterns()
+            file_data += self.outputBinaryPrototypes()
 
         elif self.genOpts.filename == 'xr_generated_api_dump.cpp':
             file_data += self.outputApiDumpMapMutexItems()
             file_data += self.writeApiDumpUnionStructFuncs()
+            file_data += self.outputBinaryStructSize()
+            file_data += self.outputBinaryEncoders()
             file_data += self.outputLayerCommands()
 
+        elif self.genOpts.filename == 'xr_generated_api_dump_binary.cpp':
+            file_data += self.outputBinaryDecoders()
+
         write(file_data, file=self.outFile)
 
         # Finish processing in superclass
@@ -138,22 +164,24 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
         generated_prototypes += '// Api Dump Inner inner xrGetInstanceProcAddr helper\n'
         generated_prototypes += 'PFN_xrVoidFunction ApiDumpLayerInnerGetInstanceProcAddr(const char* name);\n\n'
         generated_prototypes += '// Api Dump Log Command\n'
-        generated_prototypes += 'bool ApiDumpLayerRecordContent(std::vector<std::tuple<std::string, std::string, std::string>> contents);\n\n'
+        generated_prototypes += 'ApiDumpContents& ApiDumpLayerThreadContents();\n'
+        generated_prototypes += 'bool ApiDumpLayerRecordContent(const ApiDumpContents& contents);\n\n'
         generated_prototypes += '// Api Dump Manual Functions\n'
         generated_prototypes += 'XrInstance FindInstanceFromDispatchTable(XrGeneratedDispatchTable* dispatch_table);\n'
         generated_prototypes += 'XRAPI_ATTR XrResult XRAPI_CALL ApiDumpLayerXrCreateInstance(const XrInstanceCreateInfo *info,\n'
         generated_prototypes += '                                      XrInstance *instance);\n'
         generated_prototypes += 'XRAPI_ATTR XrResult XRAPI_CALL ApiDumpLayerXrDestroyInstance(XrInstance instance);\n'
+        generated_prototypes += '\n// Loader-provided per-handle dispatch table slot (lookup returns nullptr when unavailable)\n'
+        generated_prototypes += 'XrGeneratedDispatchTable* ApiDumpLayerGetHandleDispatchTable(XrObjectType object_type, uint64_t handle);\n'
+        generated_prototypes += 'void ApiDumpLayerSetHandleDispatchTable(XrObjectType object_type, uint64_t handle, XrGeneratedDispatchTable* table);\n'
         generated_prototypes += '\n//Dump utility functions\n'
-        generated_prototypes += 'bool ApiDumpDecodeNextChain(XrGeneratedDispatchTable* gen_dispatch_table, const void* value, std::string prefix,\n'
-        generated_prototypes += '                            std::vector<std::tuple<std::string, std::string, std::string>> &contents);\n'
+        generated_prototypes += 'bool ApiDumpDecodeNextChain(XrGeneratedDispatchTable* gen_dispatch_table, const void* value, ApiDumpContents &contents);\n'
         generated_prototypes += '\n// Union/Structure Output Helper function prototypes\n'
         for xr_union in self.api_unions:
             if xr_union.protect_value:
                 generated_prototypes += f'#if {xr_union.protect_string}\n'
             generated_prototypes += f'bool ApiDumpOutputXrUnion(XrGeneratedDispatchTable* gen_dispatch_table, const {xr_union.name}* value,\n'
-            generated_prototypes += '                          std::string prefix, std::string type_string, bool is_pointer,\n'
-            generated_prototypes += '                          std::vector<std::tuple<std::string, std::string, std::string>> &contents);\n'
+            generated_prototypes += '                          std::string_view type_string, bool is_pointer, ApiDumpContents &contents);\n'
             if xr_union.protect_value:
                 generated_prototypes += f'#endif // {xr_union.protect_string}\n'
         for xr_struct in self.api_structures:
@@ -163,8 +191,7 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
             if xr_struct.protect_value:
                 generated_prototypes += f'#if {xr_struct.protect_string}\n'
             generated_prototypes += f'bool ApiDumpOutputXrStruct(XrGeneratedDispatchTable* gen_dispatch_table, const {xr_struct.name}* value,\n'
-            generated_prototypes += '                           std::string prefix, std::string type_string, bool is_pointer,\n'
-            generated_prototypes += '                           std::vector<std::tuple<std::string, std::string, std::string>> &contents);\n'
+            generated_prototypes += '                           std::string_view type_string, bool is_pointer, ApiDumpContents &contents);\n'
             if xr_struct.protect_value:
                 generated_prototypes += f'#endif // {xr_struct.protect_string}\n'
         return generated_prototypes
@@ -267,13 +294,13 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
         return False
 
     # Output a single entry's C++ output code.  This will generate the final resulting
-    # entry in the Api Dump content vector which is used to record the data to a file.
+    # entry in the Api Dump contents which are used to record the data to a file.
     #   self            the ApiDumpOutputGenerator object
     #   indent          the number of "tabs" to space in for the resulting C+ code.
     #   allow_deref     Boolean indicating if we want to allow a dereference
     #   member_param    the structure from automatic_source_generator for the member or parameter.
     #   base_type       the base type of the parameter being recorded
-    #   description     a description of the member/parameter
+    #   description     C++ string literal naming the member/parameter relative to the current name
     #   full_name       a full name of the parameter in C++ parlance including any structure/union/pointer dereferences
     #   cdecl           the C-style declaration for the parameter
     def outputSingleEntry(self, indent, allow_deref, member_param, base_type, description, full_name, cdecl):
@@ -344,51 +371,27 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
         write_string = ''
 
         if base_type == 'GUID':
+            write_string += self.writeIndent(indent)
             write_string += '{\n'
             indent = indent + 1
             write_string += self.writeIndent(indent)
-            write_string += f'std::ostringstream oss_{short_pname};\n'
-            write_string += self.writeIndent(indent)
-            write_string += f'oss_{short_pname} << std::uppercase;\n'
-            write_string += self.writeIndent(indent)
-            write_string += f'oss_{short_pname}.width(8);\n'
-            write_string += self.writeIndent(indent)
-            write_string += f'oss_{short_pname} << std::hex << {full_name}.Data1 << \'-\';\n'
-            write_string += self.writeIndent(indent)
-            write_string += f'oss_{short_pname}.width(4);\n'
-            write_string += self.writeIndent(indent)
-            write_string += f'oss_{short_pname} << std::hex << {full_name}.Data2 << \'-\';\n'
-            write_string += self.writeIndent(indent)
-            write_string += f'oss_{short_pname}.width(4);\n'
+            write_string += f'char {short_pname}_string[kApiDumpValueBufferSize];\n'
             write_string += self.writeIndent(indent)
-            write_string += f'oss_{short_pname} << std::hex << {full_name}.Data3 << \'-\';\n'
+            write_string += f'snprintf({short_pname}_string, sizeof({short_pname}_string), "%8lX-%4X-%4X-%2X%X-%X%X%X%X%X%X",\n'
             write_string += self.writeIndent(indent)
-            write_string += f'oss_{short_pname}.width(2);\n'
+            write_string += f'         static_cast<unsigned long>({full_name}.Data1), static_cast<unsigned>({full_name}.Data2),\n'
             write_string += self.writeIndent(indent)
-            write_string += f'oss_{short_pname} << std::hex\n'
+            write_string += f'         static_cast<unsigned>({full_name}.Data3), static_cast<unsigned>({full_name}.Data4[0]),\n'
             write_string += self.writeIndent(indent)
-            write_string += f'    << static_cast<short>({full_name}.Data4[0])\n'
+            write_string += f'         static_cast<unsigned>({full_name}.Data4[1]), static_cast<unsigned>({full_name}.Data4[2]),\n'
             write_string += self.writeIndent(indent)
-            write_string += f'    << static_cast<short>({full_name}.Data4[1])\n'
+            write_string += f'         static_cast<unsigned>({full_name}.Data4[3]), static_cast<unsigned>({full_name}.Data4[4]),\n'
             write_string += self.writeIndent(indent)
-            write_string += '    << \'-\'\n'
+            write_string += f'         static_cast<unsigned>({full_name}.Data4[5]), static_cast<unsigned>({full_name}.Data4[6]),\n'
             write_string += self.writeIndent(indent)
-            write_string += f'    << static_cast<short>({full_name}.Data4[2])\n'
+            write_string += f'         static_cast<unsigned>({full_name}.Data4[7]));\n'
             write_string += self.writeIndent(indent)
-            write_string += f'    << static_cast<short>({full_name}.Data4[3])\n'
-            write_string += self.writeIndent(indent)
-            write_string += f'    << static_cast<short>({full_name}.Data4[4])\n'
-            write_string += self.writeIndent(indent)
-            write_string += f'    << static_cast<short>({full_name}.Data4[5])\n'
-            write_string += self.writeIndent(indent)
-            write_string += f'    << static_cast<short>({full_name}.Data4[6])\n'
-            write_string += self.writeIndent(indent)
-            write_string += f'    << static_cast<short>({full_name}.Data4[7]);\n'
-            write_string += self.writeIndent(indent)
-            write_string += f'oss_{short_pname} << std::nouppercase;\n'
-            write_string += self.writeIndent(indent)
-            write_string += f'contents.emplace_back("{full_type}", {description}'
-            write_string += f', oss_{short_pname}.str());\n'
+            write_string += f'contents.AddString("{full_type}", {description}, {short_pname}_string);\n'
             indent = indent - 1
             write_string += self.writeIndent(indent)
             write_string += '}\n'
@@ -397,57 +400,40 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
             write_string += '{\n'
             indent = indent + 1
             write_string += self.writeIndent(indent)
-            write_string += f'std::ostringstream oss_{short_pname};\n'
-            write_string += self.writeIndent(indent)
-            write_string += f'oss_{short_pname} << std::uppercase;\n'
-            write_string += self.writeIndent(indent)
-            write_string += f'oss_{short_pname}.width(8);\n'
+            write_string += f'char {short_pname}_string[kApiDumpValueBufferSize];\n'
             write_string += self.writeIndent(indent)
-            write_string += f'oss_{short_pname} << std::hex << {full_name}.LowPart;\n'
+            write_string += f'snprintf({short_pname}_string, sizeof({short_pname}_string), "%8lX%lX",\n'
             write_string += self.writeIndent(indent)
-            write_string += f'oss_{short_pname} << std::hex << {full_name}.HighPart;\n'
+            write_string += f'         static_cast<unsigned long>({full_name}.LowPart), static_cast<unsigned long>({full_name}.HighPart));\n'
             write_string += self.writeIndent(indent)
-            write_string += f'oss_{short_pname} << std::nouppercase;\n'
-            write_string += self.writeIndent(indent)
-            write_string += f'contents.emplace_back("{full_type}", {description}'
-            write_string += f', oss_{short_pname}.str());\n'
+            write_string += f'contents.AddString("{full_type}", {description}, {short_pname}_string);\n'
             indent = indent - 1
             write_string += self.writeIndent(indent)
             write_string += '}\n'
         elif base_type == 'LARGE_INTEGER':
             # Unbeknownst to XR, this is actually a union. Append '.QuadPart' to get the entirety
             write_string += self.writeIndent(indent)
-            write_string += f'std::ostringstream oss_{short_pname};\n'
-            write_string += self.writeIndent(indent)
-            write_string += f'oss_{short_pname} << '
-            write_string += 'std::hex << reinterpret_cast<const void*>( ('
+            write_string += f'contents.AddAddress("{full_type}", {description}, reinterpret_cast<const void*>(('
             if pointer_count > 0:   # Ignore can_dereference, must deref to access union member
                 write_string += '*' * pointer_count
-            write_string += f'{full_name}).QuadPart );\n'
-            write_string += self.writeIndent(indent)
-            write_string += f'contents.emplace_back("{full_type}", {description}'
-            write_string += f', oss_{short_pname}.str());\n'
+            write_string += f'{full_name}).QuadPart));\n'
         elif base_type == 'timespec':
-            # Unbeknownst to XR, this is actually a struct.
+            # Unbeknownst to XR, this is actually a struct.  Written as whole seconds and nanoseconds.
+            deref = f"{'*' * pointer_count}"
             write_string += self.writeIndent(indent)
-            write_string += f'std::ostringstream oss_{short_pname};\n'
+            write_string += '{\n'
+            indent = indent + 1
             write_string += self.writeIndent(indent)
-            deref = f"{'*' * pointer_count}"
-
-            # Write whole seconds
-            write_string += f'oss_{short_pname} << ('
-            write_string += deref
-            write_string += f'{full_name}).tv_sec << ".";\n'
-
-            # Write nanoseconds as a decimal
+            write_string += f'char {short_pname}_string[kApiDumpValueBufferSize];\n'
             write_string += self.writeIndent(indent)
-            write_string += f"oss_{short_pname} << std::setw(9) << std::setfill('0') << ("
-            write_string += deref
-            write_string += f'{full_name}).tv_nsec << "s";\n'
-
+            write_string += f'snprintf({short_pname}_string, sizeof({short_pname}_string), "%lld.%09lds",\n'
+            write_string += self.writeIndent(indent)
+            write_string += f'         static_cast<long long>(({deref}{full_name}).tv_sec), static_cast<long>(({deref}{full_name}).tv_nsec));\n'
+            write_string += self.writeIndent(indent)
+            write_string += f'contents.AddString("{full_type}", {description}, {short_pname}_string);\n'
+            indent = indent - 1
             write_string += self.writeIndent(indent)
-            write_string += f'contents.emplace_back("{full_type}", {description}'
-            write_string += f', oss_{short_pname}.str());\n'
+            write_string += '}\n'
         else:
             if base_type == 'XrResult':
                 write_string += self.writeIndent(indent)
@@ -460,10 +446,9 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
                 write_string += self.writeIndent(indent)
                 write_string += f'                                   {full_name}, {short_pname}_string);\n'
                 write_string += self.writeIndent(indent)
-                write_string += f'contents.emplace_back("{full_type}", {description}, {short_pname}_string);\n'
+                write_string += f'contents.AddString("{full_type}", {description}, {short_pname}_string);\n'
                 write_string += self.writeIndent(indent - 1)
                 write_string += '} else {\n'
-                write_string += self.writeIndent(indent)
             elif base_type == 'XrStructureType':
                 write_string += self.writeIndent(indent)
                 write_string += 'if (nullptr != gen_dispatch_table) {\n'
@@ -475,59 +460,37 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
                 write_string += self.writeIndent(indent)
                 write_string += f'                                          {full_name}, {short_pname}_string);\n'
                 write_string += self.writeIndent(indent)
-                write_string += f'contents.emplace_back("{full_type}", {description}, {short_pname}_string);\n'
+                write_string += f'contents.AddString("{full_type}", {description}, {short_pname}_string);\n'
                 write_string += self.writeIndent(indent - 1)
                 write_string += '} else {\n'
-                write_string += self.writeIndent(indent)
 
-            # If we're outputting using a string stream, determine the type of information
-            # we're generating and format it appropriately.
+            value_expr = ''
+            if can_dereference and pointer_count > 0:
+                value_expr += '*' * pointer_count
+            value_expr += full_name
+
+            # Each value is formatted straight into the contents' own storage by a fixed-size
+            # formatter.  As with the stream these replace, pointers and arrays of numbers resolve to
+            # the overloads that write their address.
+            write_string += self.writeIndent(indent)
             if use_stream:
-                write_string += self.writeIndent(indent)
-                write_string += f'std::ostringstream oss_{short_pname};\n'
-                write_string += self.writeIndent(indent)
-                # Output the standard type information if we can, except for characters because the
-                # hex converter will try to use the string value in the char.
                 if is_standard_type and not is_char:
-                    if 'float' in base_type:
+                    if 'float' in base_type or 'double' in base_type:
                         precision = '32'
-                        if '64' in base_type:
+                        if '64' in base_type or 'double' in base_type:
                             precision = '64'
                         elif '16' in base_type:
                             precision = '16'
-                        write_string += f'oss_{short_pname} << std::setprecision({precision}) << ('
-                    elif 'double' in base_type:
-                        write_string += f'oss_{short_pname} << std::setprecision(64) << ('
+                        write_string += f'contents.AddFloat("{full_type}", {description}, {value_expr}, {precision});\n'
                     else:
-                        write_string += f'oss_{short_pname} << '
-                        if member_param.pointer_count == 0:
-                            write_string += '"0x" << '
-                        write_string += 'std::hex << ('
+                        hex_prefix = 'true' if member_param.pointer_count == 0 else 'false'
+                        write_string += f'contents.AddHex("{full_type}", {description}, {value_expr}, {hex_prefix});\n'
                 else:
-                    write_string += f'oss_{short_pname} << '
-                    write_string += 'std::hex << reinterpret_cast<const void*>('
-                if can_dereference and pointer_count > 0:
-                    write_string += '*' * pointer_count
-                write_string += f'{full_name});\n'
-                write_string += self.writeIndent(indent)
-                write_string += f'contents.emplace_back("{full_type}", {description}'
-                write_string += f', oss_{short_pname}.str());\n'
-
+                    write_string += f'contents.AddAddress("{full_type}", {description}, reinterpret_cast<const void*>({value_expr}));\n'
+            elif is_char:
+                write_string += f'contents.AddString("{full_type}", {description}, {value_expr});\n'
             else:
-                write_string += self.writeIndent(indent)
-                write_string += f'contents.emplace_back("{full_type}", {description}, '
-                if not is_char:
-                    write_string += 'std::to_string('
-                if can_dereference:
-                    write_string += '*' * pointer_count
-                if full_type == 'char*' and not member_param.is_static_array:
-                    write_string += f'({full_name} ? {full_name} : "(nullptr)")'
-                else:
-                    write_string += f'{full_name}'
-                # Close std::to_string
-                if not is_char:
-                    write_string += ')'
-                write_string += ');\n'
+                write_string += f'contents.AddInt("{full_type}", {description}, {value_expr});\n'
 
             if base_type in ('XrResult', 'XrStructureType'):
                 indent = indent - 1
@@ -535,32 +498,47 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
                 write_string += '}\n'
         return write_string
 
+    # Open a block that appends a name part to the names of all the entries written inside it.
+    # Returns the code and the indent to use inside the block; an empty name needs no block.
+    #   self            the ApiDumpOutputGenerator object
+    #   name_literal    a C++ string literal holding the name part
+    #   scope_name      the variable name for the ApiDumpNameScope
+    #   indent          the number of "tabs" to space in for the resulting C+ code.
+    def openNameScope(self, name_literal, scope_name, indent):
+        if name_literal == '""':
+            return '', indent
+        scope_string = self.writeIndent(indent)
+        scope_string += '{\n'
+        scope_string += self.writeIndent(indent + 1)
+        scope_string += f'ApiDumpNameScope {scope_name}(contents, {name_literal});\n'
+        return scope_string, indent + 1
+
+    # Close a block opened by openNameScope.
+    #   self            the ApiDumpOutputGenerator object
+    #   name_literal    the C++ string literal openNameScope was given
+    #   indent          the indent openNameScope returned
+    def closeNameScope(self, name_literal, indent):
+        if name_literal == '""':
+            return ''
+        return self.writeIndent(indent - 1) + '}\n'
+
     # Output a single parameter/member.
     #   self                The ApiDumpOutputGenerator object
     #   base_type           The base type of the parameter
     #   is_pointer          Boolean indicating whether or not the contents of the arrays are pointers
     #   pointer_count       The number of pointers per variable (void*[] would be one, void**[] would be two)
     #   member_param        The structure from automatic_source_generator for the member or parameter.
-    #   member_param_prefix The prefix to place in front of the member/param items
+    #   name_literal        C++ string literal naming this member/param relative to the current name
+    #                       (empty for array elements, whose index is already part of the name)
     #   member_param_name   The prefixed name of this member/param
-    #   has_prefix          Boolean indicates that there's an incoming C++ prefix that needs to be added to the variable.
-    #   prefix_string1      The first prefix string to add prior to writing out the variable information
-    #   prefix_string1      The second prefix string to add prior to writing out the variable information
     #   expand              Boolean indicates whether or not to try to expand/dereference the contents of this parameter
     #   indent              the number of "tabs" to space in for the resulting C+ code.
-    def writeExpandedMember(self, base_type, is_pointer, pointer_count, member_param, member_param_prefix, member_param_name, has_prefix, prefix_string1, prefix_string2, expand, indent):
+    def writeExpandedMember(self, base_type, is_pointer, pointer_count, member_param, name_literal, member_param_name, expand, indent):
         member_string = ''
         derefernce_str = ''
         if not is_pointer:
             derefernce_str = '&'
 
-        prefix_string = ''
-        if has_prefix:
-            prefix_string += self.writeIndent(indent)
-            prefix_string += prefix_string1
-            prefix_string += self.writeIndent(indent)
-            prefix_string += prefix_string2
-
         # If it's a structure or union, we can also only expand it if it's not
         # return-only
         # If this is a structure or union, save that info for easier use later
@@ -575,52 +553,66 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
         pointer_string = 'false'
         if is_pointer:
             pointer_string = 'true'
+        scope_name = f'{member_param.name.lower()}_name'
         if member_param.name == 'next':
-            member_string += prefix_string
             member_string += self.writeIndent(indent)
             member_string += '// Decode the next chain if it exists\n'
+            scope_string, indent = self.openNameScope(name_literal, scope_name, indent)
+            member_string += scope_string
             member_string += self.writeIndent(indent)
-            member_string += 'if (!ApiDumpDecodeNextChain(gen_dispatch_table, %s%s, %s, contents)) {\n' % (derefernce_str,
-                                                                                                           member_param_name,
-                                                                                                           member_param_prefix)
+            member_string += 'if (!ApiDumpDecodeNextChain(gen_dispatch_table, %s%s, contents)) {\n' % (derefernce_str,
+                                                                                                       member_param_name)
             member_string += self.writeIndent(indent + 1)
             member_string += 'throw std::invalid_argument("Invalid Operation");\n'
             member_string += self.writeIndent(indent)
             member_string += '}\n'
+            member_string += self.closeNameScope(name_literal, indent)
         elif is_struct_union and expand:
-            member_string += prefix_string
-            member_string += self.writeIndent(indent)
             # If it's optional, we still want to dump out NULL if it's present just so it's logged
-            if member_param.is_optional and is_pointer:
+            is_optional_pointer = member_param.is_optional and is_pointer
+            if is_optional_pointer:
+                member_string += self.writeIndent(indent)
                 member_string += 'if (nullptr == %s) {\n' % member_param_name
                 member_string += self.outputSingleEntry(indent + 1,
                                                         False,
                                                         member_param,
                                                         base_type,
-                                                        member_param_prefix,
+                                                        name_literal,
                                                         member_param_name,
                                                         member_param.cdecl)
                 member_string += self.writeIndent(indent)
-                member_string += '} else '
+                member_string += '} else {\n'
+                indent += 1
+                if name_literal != '""':
+                    member_string += self.writeIndent(indent)
+                    member_string += f'ApiDumpNameScope {scope_name}(contents, {name_literal});\n'
+            else:
+                scope_string, indent = self.openNameScope(name_literal, scope_name, indent)
+                member_string += scope_string
             # Otherwise, if it's not NULL, print out the contents
+            member_string += self.writeIndent(indent)
             if member_param_struct:
                 member_string += 'if (!ApiDumpOutputXrStruct(gen_dispatch_table, '
             else:
                 member_string += 'if (!ApiDumpOutputXrUnion(gen_dispatch_table, '
-            member_string += '%s%s, %s, "%s", %s, contents)) {\n' % (derefernce_str,
-                                                                     member_param_name,
-                                                                     member_param_prefix,
-                                                                     full_type,
-                                                                     pointer_string)
+            member_string += '%s%s, "%s", %s, contents)) {\n' % (derefernce_str,
+                                                                 member_param_name,
+                                                                 full_type,
+                                                                 pointer_string)
             member_string += self.writeIndent(indent + 1)
             member_string += 'throw std::invalid_argument("Invalid Operation");\n'
             member_string += self.writeIndent(indent)
             member_string += '}\n'
+            if is_optional_pointer:
+                indent -= 1
+                member_string += self.writeIndent(indent)
+                member_string += '}\n'
+            else:
+                member_string += self.closeNameScope(name_literal, indent)
         else:
             valid_extension_structs = None
             if member_param_struct or member_param_union:
                 valid_extension_structs = member_param.valid_extension_structs
-            member_string += prefix_string
 
             tmp_member_param = dataclasses.replace(member_param,
                                                    valid_extension_structs=valid_extension_structs,
@@ -634,7 +626,7 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
                                                         False,
                                                         tmp_member_param,
                                                         base_type,
-                                                        member_param_prefix,
+                                                        name_literal,
                                                         member_param_name,
                                                         member_param.cdecl)
                 member_string += self.writeIndent(indent - 1)
@@ -643,7 +635,7 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
                                                     True,
                                                     tmp_member_param,
                                                     base_type,
-                                                    member_param_prefix,
+                                                    name_literal,
                                                     member_param_name,
                                                     member_param.cdecl)
             if member_param.is_optional and member_param.is_const and member_param.pointer_count > 0:
@@ -659,13 +651,11 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
     #   pointer_count       The number of pointers per variable (void*[] would be one, void**[] would be two)
     #   member_param        The structure from automatic_source_generator for the member or parameter.
     #   array_param         The member/parameter used to indicate the size of the array (or None)
-    #   member_param_prefix The prefix to place in front of the member/param items
+    #   name_literal        C++ string literal naming this member/param relative to the current name
     #   member_param_name   The prefixed name of this member/param
-    #   has_prefix          Boolean indicates that there's an incoming C++ prefix that needs to be added to the variable.
-    #   prefix_string1      The first prefix string to add prior to writing out the variable information
-    #   prefix_string1      The second prefix string to add prior to writing out the variable information
+    #   has_prefix          Boolean indicates that this is a member accessed through the struct's value pointer.
     #   indent              the number of "tabs" to space in for the resulting C+ code.
-    def writeExpandedArray(self, base_type, is_pointer, pointer_count, member_param, array_param, member_param_prefix, member_param_name, has_prefix, prefix_string1, prefix_string2, indent):
+    def writeExpandedArray(self, base_type, is_pointer, pointer_count, member_param, array_param, name_literal, member_param_name, has_prefix, indent):
         member_array_string = ''
         loop_count_name = ''
         loop_param_name = ''
@@ -680,36 +670,23 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
             loop_param_name = 'value_'
         loop_param_name += member_param.name.lower()
         loop_param_name += '_inc'
-        member_array_string += self.writeIndent(indent)
-        member_array_string += prefix_string1
-        prefix_string1 = ''
-        member_array_string += self.writeIndent(indent)
-        member_array_string += prefix_string2
-        prefix_string2 = ''
         member_array_string += self.outputSingleEntry(indent,
                                                       False,
                                                       member_param,
                                                       base_type,
-                                                      member_param_prefix,
+                                                      name_literal,
                                                       member_param_name,
                                                       member_param.cdecl)
+        scope_string, indent = self.openNameScope(name_literal, f'{member_param.name.lower()}_name', indent)
+        member_array_string += scope_string
         member_array_string += self.writeIndent(indent)
         member_array_string += 'for (uint32_t %s = 0; %s < %s; ++%s) {\n' % (loop_param_name,
                                                                              loop_param_name,
                                                                              loop_count_name,
                                                                              loop_param_name)
         indent = indent + 1
-
-        # Make sure we set that we need a prefix (even if we didn't need one before) because
-        # of the array looping.
-        paranet_param_prefix = member_param_prefix
-        member_param_prefix = f'{member_param.name.lower()}_array_prefix'
-        prefix_string1 = f'std::string {member_param_prefix} = {paranet_param_prefix};\n'
-        prefix_string2 += f'{member_param_prefix} += "[";\n'
-        prefix_string2 += self.writeIndent(indent)
-        prefix_string2 += f'{member_param_prefix} += std::to_string({loop_param_name});\n'
-        prefix_string2 += self.writeIndent(indent)
-        prefix_string2 += f'{member_param_prefix} += "]";\n'
+        member_array_string += self.writeIndent(indent)
+        member_array_string += f'ApiDumpNameScope {loop_param_name}_name(contents, {loop_param_name});\n'
 
         member_param_name += f"[{loop_param_name}]"
         array_dimen = member_param.array_dimen - 1
@@ -739,16 +716,17 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
                                                pointer_count_var=pointer_count_var,)
 
         member_array_string += self.writeExpandedMember(base_type, is_pointer, pointer_count, tmp_member_param,
-                                                        member_param_prefix, member_param_name, True, prefix_string1, prefix_string2, True, indent)
+                                                        '""', member_param_name, True, indent)
         indent = indent - 1
         member_array_string += self.writeIndent(indent)
         member_array_string += '}\n'
+        member_array_string += self.closeNameScope(name_literal, indent)
         return member_array_string
 
     # Output a single parameter or member based on whether it is an array or not
     #   self            the ApiDumpOutputGenerator object
     #   member_param    the structure from automatic_source_generator for the member or parameter.
-    #   has_prefix      Boolean indicates that there's an incoming C++ prefix that needs to be added to the variable.
+    #   has_prefix      Boolean indicates that this is a member accessed through the struct's value pointer.
     #   expand_parent   Boolean indicating that the parent could or could not be expanded.
     #   indent          the number of "tabs" to space in for the resulting C+ code.
     def writeParamMember(self, member_param, has_prefix, expand_parent, indent):
@@ -795,18 +773,12 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
         if base_type == 'char' and is_array and not is_pointer:
             is_array = False
 
-        member_param_prefix = ''
-        prefix_string1 = ''
-        prefix_string2 = ''
+        # Entry names are built up by the contents as structs are expanded, so a member only
+        # supplies its own name.
+        name_literal = f'"{member_param.name}"'
         member_param_name = member_param.name
         if has_prefix:
-            member_param_prefix = f'{member_param.name.lower()}_prefix'
-            prefix_string1 = f'std::string {member_param_prefix} = prefix;\n'
-            prefix_string2 = f'{member_param_prefix} += "'
             member_param_name = f"value->{member_param.name}"
-            prefix_string2 += f'{member_param.name}";\n'
-        else:
-            member_param_prefix = f'"{member_param.name}"'
 
         if can_expand and is_array:
             is_relation_group = False
@@ -831,7 +803,7 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
                     member_param_string += 'if (%s[0].type == %s) {\n' % (
                         member_param_name, self.genXrStructureType(child))
                     member_param_string += self.writeExpandedArray(base_type, is_pointer, pointer_count, member_param, array_param,
-                                                                   member_param_prefix, member_param_name, has_prefix, prefix_string1, prefix_string2, indent + 1)
+                                                                   name_literal, member_param_name, has_prefix, indent + 1)
                     member_param_string += self.writeIndent(indent + 1)
                     member_param_string += f'{decoded_var} = true;\n'
                     member_param_string += self.writeIndent(indent)
@@ -842,14 +814,14 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
                 member_param_string += 'if (!%s) {\n' % decoded_var
                 indent += 1
             member_param_string += self.writeExpandedArray(base_type, is_pointer, pointer_count, member_param,
-                                                           array_param, member_param_prefix, member_param_name, has_prefix, prefix_string1, prefix_string2, indent)
+                                                           array_param, name_literal, member_param_name, has_prefix, indent)
             if is_relation_group:
                 indent -= 1
                 member_param_string += self.writeIndent(indent)
                 member_param_string += '}\n'
         else:
             member_param_string += self.writeExpandedMember(base_type, is_pointer, pointer_count, member_param,
-                                                            member_param_prefix, member_param_name, has_prefix, prefix_string1, prefix_string2, can_expand, indent)
+                                                            name_literal, member_param_name, can_expand, indent)
         return member_param_string
 
     # Generate the C++ output code for each member of a union or structure.
@@ -871,24 +843,15 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
             if xr_union.protect_value:
                 struct_union_check += f'#if {xr_union.protect_string}\n'
             struct_union_check += f'bool ApiDumpOutputXrUnion(XrGeneratedDispatchTable* gen_dispatch_table, const {xr_union.name}* value,\n'
-            struct_union_check += '                          std::string prefix, std::string type_string, bool is_pointer,\n'
-            struct_union_check += '                          std::vector<std::tuple<std::string, std::string, std::string>> &contents) {\n'
+            struct_union_check += '                          std::string_view type_string, bool is_pointer, ApiDumpContents &contents) {\n'
             struct_union_check += self.writeIndent(1)
             struct_union_check += '(void)gen_dispatch_table;  // silence warning\n'
             struct_union_check += self.writeIndent(1)
             struct_union_check += 'try {\n'
             struct_union_check += self.writeIndent(2)
-            struct_union_check += 'contents.emplace_back(type_string, prefix, PointerToHexString(value));\n'
-            struct_union_check += self.writeIndent(2)
-            struct_union_check += 'if (is_pointer) {\n'
-            struct_union_check += self.writeIndent(3)
-            struct_union_check += 'prefix += "->";\n'
+            struct_union_check += 'contents.AddPointer(type_string, "", value);\n'
             struct_union_check += self.writeIndent(2)
-            struct_union_check += '} else {\n'
-            struct_union_check += self.writeIndent(3)
-            struct_union_check += 'prefix += ".";\n'
-            struct_union_check += self.writeIndent(2)
-            struct_union_check += '}\n'
+            struct_union_check += 'ApiDumpNameScope member_name(contents, is_pointer ? "->" : ".");\n'
             struct_union_check += self.writeUnionStructMembers(xr_union, 2)
             struct_union_check += self.writeIndent(2)
             struct_union_check += 'return true;\n'
@@ -908,8 +871,7 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
             if xr_struct.protect_value:
                 struct_union_check += f'#if {xr_struct.protect_string}\n'
             struct_union_check += f'bool ApiDumpOutputXrStruct(XrGeneratedDispatchTable* gen_dispatch_table, const {xr_struct.name}* value,\n'
-            struct_union_check += '                           std::string prefix, std::string type_string, bool is_pointer,\n'
-            struct_union_check += '                           std::vector<std::tuple<std::string, std::string, std::string>> &contents) {\n'
+            struct_union_check += '                           std::string_view type_string, bool is_pointer, ApiDumpContents &contents) {\n'
             indent = 1
             struct_union_check += self.writeIndent(indent)
             struct_union_check += '(void)gen_dispatch_table;  // silence warning\n'
@@ -933,7 +895,7 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
                     struct_union_check += self.writeIndent(indent + 1)
                     struct_union_check += f'const {child}* new_value = reinterpret_cast<const {child}*>(value);\n'
                     struct_union_check += self.writeIndent(indent + 1)
-                    struct_union_check += 'return ApiDumpOutputXrStruct(gen_dispatch_table, new_value, prefix, type_string, is_pointer, contents);\n'
+                    struct_union_check += 'return ApiDumpOutputXrStruct(gen_dispatch_table, new_value, type_string, is_pointer, contents);\n'
                     struct_union_check += self.writeIndent(indent)
                     struct_union_check += '}\n'
                     if child_struct.protect_value:
@@ -941,17 +903,9 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
                 struct_union_check += self.writeIndent(indent)
                 struct_union_check += '// Fallback path - Just output generic information about the base struct\n'
             struct_union_check += self.writeIndent(indent)
-            struct_union_check += 'contents.emplace_back(type_string, prefix, PointerToHexString(value));\n'
+            struct_union_check += 'contents.AddPointer(type_string, "", value);\n'
             struct_union_check += self.writeIndent(indent)
-            struct_union_check += 'if (is_pointer) {\n'
-            struct_union_check += self.writeIndent(indent + 1)
-            struct_union_check += 'prefix += "->";\n'
-            struct_union_check += self.writeIndent(indent)
-            struct_union_check += '} else {\n'
-            struct_union_check += self.writeIndent(indent + 1)
-            struct_union_check += 'prefix += ".";\n'
-            struct_union_check += self.writeIndent(indent)
-            struct_union_check += '}\n'
+            struct_union_check += 'ApiDumpNameScope member_name(contents, is_pointer ? "->" : ".");\n'
             struct_union_check += self.writeUnionStructMembers(
                 xr_struct, indent)
             struct_union_check += self.writeIndent(indent)
@@ -967,12 +921,11 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
             if xr_struct.protect_value:
                 struct_union_check += f'#endif // {xr_struct.protect_string}\n'
             struct_union_check += '\n'
-        struct_union_check += 'bool ApiDumpDecodeNextChain(XrGeneratedDispatchTable* gen_dispatch_table, const void* value, std::string prefix,\n'
-        struct_union_check += '                            std::vector<std::tuple<std::string, std::string, std::string>> &contents) {\n'
+        struct_union_check += 'bool ApiDumpDecodeNextChain(XrGeneratedDispatchTable* gen_dispatch_table, const void* value, ApiDumpContents &contents) {\n'
         struct_union_check += self.writeIndent(1)
         struct_union_check += '(void)gen_dispatch_table;  // silence warning\n'
         struct_union_check += '    try {\n'
-        struct_union_check += '        contents.emplace_back("const void *", prefix, PointerToHexString(value));\n'
+        struct_union_check += '        contents.AddPointer("const void *", "", value);\n'
         struct_union_check += '        if (nullptr == value) {\n'
         struct_union_check += '            return true;\n'
         struct_union_check += '        }\n'
@@ -985,7 +938,7 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
         struct_union_check += self.writeIndent(3)
         struct_union_check += 'case XR_TYPE_UNKNOWN:\n'
         struct_union_check += self.writeIndent(4)
-        struct_union_check += 'if (!ApiDumpOutputXrStruct(gen_dispatch_table, next_header, prefix, "const XrBaseInStructure*", true, contents)) {\n'
+        struct_union_check += 'if (!ApiDumpOutputXrStruct(gen_dispatch_table, next_header, "const XrBaseInStructure*", true, contents)) {\n'
         struct_union_check += self.writeIndent(5)
         struct_union_check += 'return false;\n'
         struct_union_check += self.writeIndent(4)
@@ -1013,7 +966,7 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
                 struct_union_check += self.writeIndent(3)
                 struct_union_check += f'case {cur_value.name}:\n'
                 struct_union_check += self.writeIndent(4)
-                struct_union_check += 'if (!ApiDumpOutputXrStruct(gen_dispatch_table, reinterpret_cast<const %s*>(value), prefix, "const %s*", true, contents)) {\n' % (
+                struct_union_check += 'if (!ApiDumpOutputXrStruct(gen_dispatch_table, reinterpret_cast<const %s*>(value), "const %s*", true, contents)) {\n' % (
                     struct_define_name, struct_define_name)
                 struct_union_check += self.writeIndent(5)
                 struct_union_check += 'return false;\n'
@@ -1037,6 +990,384 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
         struct_union_check += '}\n\n'
         return struct_union_check
 
+    # Every command the layer records, generated or manual, in registry order.  The position in this
+    # list (plus one) is the command's id in binary captures.
+    #   self            the ApiDumpOutputGenerator object
+    def getBinaryRecordedCommands(self):
+        recorded = []
+        for commands in (self.core_commands, self.ext_commands):
+            for cur_cmd in commands:
+                if cur_cmd.name in self.no_trampoline_or_terminator or cur_cmd.name in LOADER_FUNCTIONS:
+                    continue
+                recorded.append(cur_cmd)
+        return recorded
+
+    # Name of the generated function that writes a binary record for a command.
+    #   self            the ApiDumpOutputGenerator object
+    #   cmd_name        the name of the command
+    def genBinaryRecordFuncName(self, cmd_name):
+        return f'ApiDumpBinaryRecord{cmd_name[0].upper()}{cmd_name[1:]}'
+
+    # How a command parameter is written into a binary record: 'value', 'string', 'struct' or 'pointer'.
+    # See api_dump_binary.h for the encoding of each.
+    #   self            the ApiDumpOutputGenerator object
+    #   param           the parameter to classify
+    def getBinaryParamKind(self, param):
+        if param.pointer_count == 0 and not param.is_array:
+            return 'value'
+        if param.pointer_count == 1 and param.is_const and not param.is_array:
+            if param.type == 'char':
+                return 'string'
+            if self.isStruct(param.type):
+                return 'struct'
+        return 'pointer'
+
+    # True if a struct starts with type and next, so its real type and next chain can be recorded.
+    #   self            the ApiDumpOutputGenerator object
+    #   type_name       the name of the struct
+    def isBinaryTypedStruct(self, type_name):
+        xr_struct = self.getStruct(type_name)
+        return xr_struct is not None and any(member.name == 'next' for member in xr_struct.members)
+
+    # Names of the structs a binary capture decoder can print: those with an XrStructureType, those
+    # passed to recorded commands, and anything they hold by value.
+    #   self            the ApiDumpOutputGenerator object
+    def getBinaryPrintedStructNames(self):
+        pending = []
+        enum_tuple = [x for x in self.api_enums if x.name == 'XrStructureType'][0]
+        for cur_value in enum_tuple.values:
+            struct_define_name = self.genXrStructureName(cur_value.name)
+            if struct_define_name:
+                pending.append(struct_define_name)
+        for cur_cmd in self.getBinaryRecordedCommands():
+            for param in cur_cmd.params:
+                if self.getBinaryParamKind(param) in ('value', 'struct') and self.isStruct(param.type):
+                    pending.append(param.type)
+        printed = set()
+        while pending:
+            struct_name = pending.pop()
+            xr_struct = self.getStruct(struct_name)
+            if xr_struct is None or xr_struct.name in printed or xr_struct.name in LOADER_STRUCTS:
+                continue
+            printed.add(xr_struct.name)
+            for member in xr_struct.members:
+                if member.pointer_count == 0 and not member.is_array and self.isStruct(member.type):
+                    pending.append(member.type)
+        return printed
+
+    # Type of a member or parameter as written in the text output.
+    #   self            the ApiDumpOutputGenerator object
+    #   member_param    the member or parameter
+    def genBinaryFullType(self, member_param):
+        cdecl = member_param.cdecl.strip()
+        full_type = cdecl[0:cdecl.rfind(' ')].strip()
+        if member_param.is_static_array:
+            full_type += '*'
+        return full_type
+
+    # C++ expression formatting a captured scalar the way the text output does.
+    #   self            the ApiDumpOutputGenerator object
+    #   type_name       the type of the value
+    #   expr            the expression holding the value
+    def genBinaryScalarString(self, type_name, expr):
+        base_type = self.getBaseType(type_name)
+        if self.isHandle(type_name) or (base_type is not None and self.isOpaque64(base_type.type)):
+            return f'ApiDumpBinaryAddress(MakeHandleGeneric({expr}))'
+        lower_type = type_name.lower()
+        if lower_type.startswith('float'):
+            precision = '32'
+            if '64' in lower_type:
+                precision = '64'
+            elif '16' in lower_type:
+                precision = '16'
+            return f'ApiDumpBinaryFloat({expr}, {precision})'
+        if lower_type.startswith('double'):
+            return f'ApiDumpBinaryFloat({expr}, 64)'
+        if 'unsigned ' in lower_type or 'uint' in lower_type:
+            return f'ApiDumpBinaryHex(static_cast<uint64_t>({expr}))'
+        if (self.isEnumType(type_name) or self.isFlagType(type_name) or base_type is not None or
+                type_name in ('char', 'int', 'int8_t', 'int16_t', 'int32_t', 'int64_t', 'size_t')):
+            return f'std::to_string({expr})'
+        # Platform types the registry does not describe
+        return f'ApiDumpBinaryBytes(&{expr}, sizeof({expr}))'
+
+    # Call the given function for every XrStructureType value that names a struct, skipping aliases
+    # that would produce duplicate switch cases, and wrap its output in the needed protection.
+    #   self            the ApiDumpOutputGenerator object
+    #   gen_case        function taking (enum value name, struct name) and returning the case text
+    def genBinaryStructureTypeCases(self, gen_case):
+        cases = ''
+        enum_tuple = [x for x in self.api_enums if x.name == 'XrStructureType'][0]
+        for cur_value in enum_tuple.values:
+            struct_define_name = self.genXrStructureName(cur_value.name)
+            if not struct_define_name or struct_define_name in LOADER_STRUCTS:
+                continue
+            cur_struct = self.getStruct(struct_define_name)
+            avoid_dupe = None
+            if cur_value.alias:
+                aliased = [x for x in enum_tuple.values if x.name == cur_value.alias]
+                aliased_value = aliased[0]
+                if aliased_value.protect_value and aliased_value.protect_value != cur_value.protect_value and aliased_value.protect_value != enum_tuple.protect_value:
+                    avoid_dupe = aliased_value.protect_string
+                    cases += f'#if !({avoid_dupe})\n'
+                else:
+                    # This would unconditionally cause a duplicate case
+                    continue
+            if cur_struct.protect_value:
+                cases += f'#if {cur_struct.protect_string}\n'
+            cases += gen_case(cur_value.name, struct_define_name)
+            if cur_struct.protect_value:
+                cases += f'#endif // {cur_struct.protect_string}\n'
+            if avoid_dupe:
+                cases += f'#endif // !({avoid_dupe})\n'
+        return cases
+
+    # Output the binary capture command ids and the prototypes of the generated binary encoders.
+    #   self            the ApiDumpOutputGenerator object
+    def outputBinaryPrototypes(self):
+        prototypes = '\n// Binary capture output (manually implemented)\n'
+        prototypes += 'bool ApiDumpLayerBinaryEnabled();\n'
+        prototypes += 'void ApiDumpLayerRecordBinary(const std::string& record);\n'
+        prototypes += '\n// Called when a command fails, to write out the calls held in trigger-on-error mode (manually implemented)\n'
+        prototypes += 'void ApiDumpLayerCallFailed();\n'
+        prototypes += '\n// Command ids used in binary captures.  These are not guarded by platform defines so that\n'
+        prototypes += '// they are the same in every build made from the same registry.\n'
+        prototypes += 'enum ApiDumpBinaryCommand : uint16_t {\n'
+        prototypes += '    API_DUMP_BINARY_COMMAND_UNKNOWN = 0,\n'
+        for command_id, cur_cmd in enumerate(self.getBinaryRecordedCommands(), 1):
+            prototypes += f'    API_DUMP_BINARY_COMMAND_{cur_cmd.name} = {command_id},\n'
+        prototypes += '    API_DUMP_BINARY_COMMAND_COUNT,\n'
+        prototypes += '};\n'
+        prototypes += 'static_assert(API_DUMP_BINARY_COMMAND_COUNT <= kApiDumpFilterMaxCommands, "api_dump filter bitsets are too small");\n'
+        prototypes += '\n// Command names indexed by command id.\n'
+        prototypes += 'inline constexpr const char* kApiDumpBinaryCommandNames[API_DUMP_BINARY_COMMAND_COUNT] = {\n'
+        prototypes += '    nullptr,\n'
+        for cur_cmd in self.getBinaryRecordedCommands():
+            prototypes += f'    "{cur_cmd.name}",\n'
+        prototypes += '};\n'
+        prototypes += '\n// Write a binary record for a command\n'
+        for cur_cmd in self.getBinaryRecordedCommands():
+            if cur_cmd.protect_value:
+                prototypes += f'#if {cur_cmd.protect_string}\n'
+            prototypes += f'void {self.genBinaryRecordFuncName(cur_cmd.name)}('
+            prototypes += ', '.join(param.cdecl.strip() for param in cur_cmd.params)
+            prototypes += ');\n'
+            if cur_cmd.protect_value:
+                prototypes += f'#endif // {cur_cmd.protect_string}\n'
+        return prototypes
+
+    # Output the lookup of struct sizes by XrStructureType used to capture derived structs and next chains.
+    #   self            the ApiDumpOutputGenerator object
+    def outputBinaryStructSize(self):
+        def gen_case(type_value, struct_name):
+            return f'        case {type_value}:\n            return sizeof({struct_name});\n'
+
+        struct_size = '// Size of a struct by its XrStructureType, for binary captures\n'
+        struct_size += 'size_t ApiDumpBinaryStructSize(XrStructureType type) {\n'
+        struct_size += '    switch (type) {\n'
+        struct_size += self.genBinaryStructureTypeCases(gen_case)
+        struct_size += '        default:\n'
+        struct_size += '            return 0;\n'
+        struct_size += '    }\n'
+        struct_size += '}\n\n'
+        return struct_size
+
+    # Output a binary record function for every recorded command.
+    #   self            the ApiDumpOutputGenerator object
+    def outputBinaryEncoders(self):
+        encoders = '// Binary record functions: a straight copy of each parameter, see api_dump_binary.h\n'
+        for cur_cmd in self.getBinaryRecordedCommands():
+            if cur_cmd.protect_value:
+                encoders += f'#if {cur_cmd.protect_string}\n'
+            encoders += f'void {self.genBinaryRecordFuncName(cur_cmd.name)}('
+            encoders += ', '.join(param.cdecl.strip() for param in cur_cmd.params)
+            encoders += ') {\n'
+            encoders += f'    ApiDumpBinaryEncoder encoder(API_DUMP_BINARY_COMMAND_{cur_cmd.name});\n'
+            for param in cur_cmd.params:
+                kind = self.getBinaryParamKind(param)
+                if kind == 'value':
+                    encoders += f'    encoder.Value({param.name});\n'
+                elif kind == 'string':
+                    encoders += f'    encoder.String({param.name});\n'
+                elif kind == 'struct':
+                    typed = 'true' if self.isBinaryTypedStruct(param.type) else 'false'
+                    encoders += f'    encoder.Struct({param.name}, sizeof({param.type}), {typed});\n'
+                else:
+                    encoders += f'    encoder.Pointer({param.name});\n'
+            encoders += '    ApiDumpLayerRecordBinary(encoder.Finish());\n'
+            encoders += '}\n'
+            if cur_cmd.protect_value:
+                encoders += f'#endif // {cur_cmd.protect_string}\n'
+            encoders += '\n'
+        return encoders
+
+    # Output the text for one struct member in a binary capture decoder.
+    #   self            the ApiDumpOutputGenerator object
+    #   struct_name     the name of the struct holding the member
+    #   member          the member
+    #   indent          the number of "tabs" to space in for the resulting C++ code
+    def genBinaryMemberOutput(self, struct_name, member, indent):
+        full_type = self.genBinaryFullType(member)
+        name_expr = f'prefix + "{member.name}"'
+        value_expr = f'value->{member.name}'
+        if member.name == 'next':
+            return self.writeIndent(indent) + f'ApiDumpBinaryDecodeNextChain(chain, next_index, reinterpret_cast<uintptr_t>({value_expr}), {name_expr}, contents);\n'
+        if member.is_static_array:
+            if member.type == 'char' and member.pointer_count == 0 and len(member.static_array_sizes) == 1:
+                value_string = f'std::string({value_expr}, strnlen({value_expr}, sizeof({value_expr})))'
+            else:
+                value_string = f'ApiDumpBinaryBytes({value_expr}, sizeof({value_expr}))'
+        elif member.pointer_count > 0 or member.is_array:
+            value_string = f'ApiDumpBinaryAddress(reinterpret_cast<uintptr_t>({value_expr}))'
+        elif self.isStruct(member.type):
+            output = self.writeIndent(indent)
+            output += f'ApiDumpBinaryOutputXrStruct(&{value_expr}, 0 == address ? 0 : address + offsetof({struct_name}, {member.name}),\n'
+            output += self.writeIndent(indent)
+            output += f'                            nullptr, 0, {name_expr}, "{full_type}", false, contents);\n'
+            return output
+        elif self.isUnion(member.type):
+            value_string = f'ApiDumpBinaryBytes(&{value_expr}, sizeof({value_expr}))'
+        else:
+            value_string = self.genBinaryScalarString(member.type, value_expr)
+        return self.writeIndent(indent) + f'contents.Add("{full_type}", {name_expr}, {value_string});\n'
+
+    # Output the binary capture decoders used by api_dump_convert: a printer per struct, lookup of
+    # structs by XrStructureType for next chains and base headers, and a decoder per command.
+    #   self            the ApiDumpOutputGenerator object
+    def outputBinaryDecoders(self):
+        contents_type = 'ApiDumpContents& contents'
+        decoders = '// Struct printers for binary captures.  Only the captured bytes are available, so pointers\n'
+        decoders += '// other than next are shown by address.\n'
+        decoders += 'static void ApiDumpBinaryDecodeNextChain(const ApiDumpBinaryChain* chain, size_t next_index, uint64_t address,\n'
+        decoders += f'                                         const std::string& prefix, {contents_type});\n'
+        printed_structs = self.getBinaryPrintedStructNames()
+        for xr_struct in self.api_structures:
+            if xr_struct.name not in printed_structs:
+                continue
+            if xr_struct.protect_value:
+                decoders += f'#if {xr_struct.protect_string}\n'
+            decoders += f'static void ApiDumpBinaryOutputXrStruct(const {xr_struct.name}* value, uint64_t address, const ApiDumpBinaryChain* chain,\n'
+            decoders += '                                        size_t next_index, std::string prefix, std::string_view type_string,\n'
+            decoders += f'                                        bool is_pointer, {contents_type});\n'
+            if xr_struct.protect_value:
+                decoders += f'#endif // {xr_struct.protect_string}\n'
+        decoders += '\n'
+
+        def gen_typed_case(type_value, struct_name):
+            case = f'        case {type_value}: {{\n'
+            case += f'            const {struct_name} value = ApiDumpBinaryCopy<{struct_name}>(bytes);\n'
+            case += '            ApiDumpBinaryOutputXrStruct(&value, address, chain, next_index, prefix,\n'
+            case += f'                                        nullptr != type_string ? type_string : "const {struct_name}*", true, contents);\n'
+            case += '            return true;\n'
+            case += '        }\n'
+            return case
+
+        decoders += '// Print captured bytes as the struct their XrStructureType names.  Returns false for unknown types.\n'
+        decoders += 'static bool ApiDumpBinaryOutputTypedStruct(XrStructureType type, const std::string& bytes, uint64_t address,\n'
+        decoders += '                                           const ApiDumpBinaryChain* chain, size_t next_index, const std::string& prefix,\n'
+        decoders += f'                                           const char* type_string, {contents_type}) {{\n'
+        decoders += '    switch (type) {\n'
+        decoders += self.genBinaryStructureTypeCases(gen_typed_case)
+        decoders += '        default:\n'
+        decoders += '            return false;\n'
+        decoders += '    }\n'
+        decoders += '}\n\n'
+
+        decoders += 'static void ApiDumpBinaryDecodeNextChain(const ApiDumpBinaryChain* chain, size_t next_index, uint64_t address,\n'
+        decoders += f'                                         const std::string& prefix, {contents_type}) {{\n'
+        decoders += '    contents.Add("const void *", prefix, ApiDumpBinaryAddress(address));\n'
+        decoders += '    if (0 != address && nullptr != chain && next_index < chain->size()) {\n'
+        decoders += '        const ApiDumpBinaryStruct::ChainEntry& entry = (*chain)[next_index];\n'
+        decoders += '        ApiDumpBinaryOutputTypedStruct(entry.type, entry.bytes, address, chain, next_index + 1, prefix, nullptr, contents);\n'
+        decoders += '    }\n'
+        decoders += '}\n\n'
+
+        for xr_struct in self.api_structures:
+            if xr_struct.name not in printed_structs:
+                continue
+            if xr_struct.protect_value:
+                decoders += f'#if {xr_struct.protect_string}\n'
+            decoders += f'static void ApiDumpBinaryOutputXrStruct(const {xr_struct.name}* value, uint64_t address, const ApiDumpBinaryChain* chain,\n'
+            decoders += '                                        size_t next_index, std::string prefix, std::string_view type_string,\n'
+            decoders += f'                                        bool is_pointer, {contents_type}) {{\n'
+            if not self.isBinaryTypedStruct(xr_struct.name):
+                decoders += '    (void)chain;  // silence warning\n'
+                decoders += '    (void)next_index;  // silence warning\n'
+            decoders += '    contents.Add(type_string, prefix, ApiDumpBinaryAddress(address));\n'
+            decoders += '    prefix += is_pointer ? "->" : ".";\n'
+            for member in xr_struct.members:
+                decoders += self.genBinaryMemberOutput(xr_struct.name, member, 1)
+            decoders += '}\n'
+            if xr_struct.protect_value:
+                decoders += f'#endif // {xr_struct.protect_string}\n'
+            decoders += '\n'
+
+        decoders += '// Print a struct passed by pointer, as its real type when it starts with type and next.\n'
+        decoders += 'template <typename T>\n'
+        decoders += 'static void ApiDumpBinaryOutputStructParam(const ApiDumpBinaryStruct& param, const char* name, const char* type_string,\n'
+        decoders += f'                                           bool typed, {contents_type}) {{\n'
+        decoders += '    if (0 == param.address) {\n'
+        decoders += '        contents.Add(type_string, name, ApiDumpBinaryAddress(0));\n'
+        decoders += '        return;\n'
+        decoders += '    }\n'
+        decoders += '    if (typed && ApiDumpBinaryOutputTypedStruct(ApiDumpBinaryCopy<XrBaseInStructure>(param.bytes).type, param.bytes,\n'
+        decoders += '                                                param.address, &param.chain, 0, name, type_string, contents)) {\n'
+        decoders += '        return;\n'
+        decoders += '    }\n'
+        decoders += '    const T value = ApiDumpBinaryCopy<T>(param.bytes);\n'
+        decoders += '    ApiDumpBinaryOutputXrStruct(&value, param.address, &param.chain, 0, name, type_string, true, contents);\n'
+        decoders += '}\n\n'
+
+        recorded = self.getBinaryRecordedCommands()
+        decoders += 'const char* ApiDumpBinaryCommandName(uint16_t command_id) {\n'
+        decoders += '    return command_id < API_DUMP_BINARY_COMMAND_COUNT ? kApiDumpBinaryCommandNames[command_id] : nullptr;\n'
+        decoders += '}\n\n'
+
+        decoders += 'bool ApiDumpBinaryDecodeCommand(uint16_t command_id, ApiDumpBinaryReader& reader,\n'
+        decoders += f'                                {contents_type}) {{\n'
+        decoders += '    switch (command_id) {\n'
+        for cur_cmd in recorded:
+            if cur_cmd.protect_value:
+                decoders += f'#if {cur_cmd.protect_string}\n'
+            return_type = 'void'
+            if cur_cmd.return_type is not None and cur_cmd.return_type.text:
+                return_type = cur_cmd.return_type.text
+            decoders += f'        case API_DUMP_BINARY_COMMAND_{cur_cmd.name}: {{\n'
+            decoders += f'            contents.Add("{return_type}", "{cur_cmd.name}", "");\n'
+            for param in cur_cmd.params:
+                kind = self.getBinaryParamKind(param)
+                full_type = self.genBinaryFullType(param)
+                if kind == 'value':
+                    decoders += f'            const {param.type} {param.name} = reader.Value<{param.type}>();\n'
+                    if self.isStruct(param.type):
+                        decoders += f'            ApiDumpBinaryOutputXrStruct(&{param.name}, 0, nullptr, 0, "{param.name}", "{full_type}", false, contents);\n'
+                    else:
+                        if self.isUnion(param.type):
+                            value_string = f'ApiDumpBinaryBytes(&{param.name}, sizeof({param.name}))'
+                        else:
+                            value_string = self.genBinaryScalarString(param.type, param.name)
+                        decoders += f'            contents.Add("{full_type}", "{param.name}", {value_string});\n'
+                elif kind == 'string':
+                    decoders += f'            std::string {param.name};\n'
+                    decoders += f'            contents.Add("{full_type}", "{param.name}", reader.String({param.name}) ? {param.name} : std::string("(nullptr)"));\n'
+                elif kind == 'struct':
+                    typed = 'true' if self.isBinaryTypedStruct(param.type) else 'false'
+                    decoders += f'            ApiDumpBinaryStruct {param.name};\n'
+                    decoders += f'            reader.Struct({param.name});\n'
+                    decoders += f'            ApiDumpBinaryOutputStructParam<{param.type}>({param.name}, "{param.name}", "{full_type}", {typed}, contents);\n'
+                else:
+                    decoders += f'            contents.Add("{full_type}", "{param.name}", ApiDumpBinaryAddress(reader.Pointer()));\n'
+            decoders += '            break;\n'
+            decoders += '        }\n'
+            if cur_cmd.protect_value:
+                decoders += f'#endif // {cur_cmd.protect_string}\n'
+        decoders += '        default:\n'
+        decoders += '            return false;\n'
+        decoders += '    }\n'
+        decoders += '    return reader.Ok();\n'
+        decoders += '}\n'
+        return decoders
+
     # Write the C++ Api Dump function for every command we know about
     #   self            the ApiDumpOutputGenerator object
     def outputLayerCommands(self):
@@ -1062,12 +1393,6 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
                 if cur_cmd.name == 'xrCreateApiLayerInstance':
                     continue
 
-                LOADER_FUNCTIONS = [
-                    'xrInitializeLoaderKHR',
-                    'xrNegotiateLoaderRuntimeInterface',
-                    'xrNegotiateLoaderApiLayerInterface',
-                ]
-
                 # functions implemented by or for the loader are different
                 if cur_cmd.name in LOADER_FUNCTIONS:
                     continue
@@ -1108,7 +1433,6 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
 
                 generated_commands += '    try {\n'
                 generated_commands += '        // Generate output for this command\n'
-                generated_commands += '        std::vector<std::tuple<std::string, std::string, std::string>> contents;\n'
 
                 # Next, we have to call down to the next implementation of this command in the call chain.
                 # Before we can do that, we have to figure out what the dispatch table is
@@ -1116,8 +1440,9 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
                     handle_param = cur_cmd.params[0]
                     base_handle_name = undecorate(handle_param.type)
                     first_handle_name = self.getFirstHandleName(handle_param)
-                    generated_commands += f'        XrGeneratedDispatchTable *gen_dispatch_table = nullptr;\n\n'
-                    generated_commands += f'        {{\n'
+                    generated_commands += f'        XrGeneratedDispatchTable *gen_dispatch_table = ApiDumpLayerGetHandleDispatchTable(\n'
+                    generated_commands += f'            {self.genXrObjectType(handle_param.type)}, MakeHandleGeneric({first_handle_name}));\n'
+                    generated_commands += f'        if (nullptr == gen_dispatch_table) {{\n'
                     generated_commands += f'            std::unique_lock<std::mutex> mlock(g_{base_handle_name}_dispatch_mutex);\n'
                     generated_commands += f'            auto map_iter = g_{base_handle_name}_dispatch_map.find({first_handle_name});\n'
                     generated_commands += f'            if (map_iter == g_{base_handle_name}_dispatch_map.end()) {{\n'
@@ -1129,12 +1454,26 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
                     generated_commands += self.printCodeGenErrorMessage(
                         f'Command {cur_cmd.name} does not have an OpenXR Object handle as the first parameter.')
 
-                # Print out a tuple for the header
+                # Frame windows open on xrBeginFrame, before it is recorded
+                if cur_cmd.name == 'xrBeginFrame':
+                    generated_commands += '        g_api_dump_filter.BeginFrame();\n'
+
+                # Calls left out by the filter settings skip all of the recording.
+                # Binary captures only copy the parameters; everything else is formatted as text here
+                generated_commands += f'        if (g_api_dump_filter.ShouldRecord(API_DUMP_BINARY_COMMAND_{cur_cmd.name})) {{\n'
+                generated_commands += '            if (ApiDumpLayerBinaryEnabled()) {\n'
+                generated_commands += f'                {self.genBinaryRecordFuncName(cur_cmd.name)}('
+                generated_commands += ', '.join(param.name for param in cur_cmd.params)
+                generated_commands += ');\n'
+                generated_commands += '            } else {\n'
+
+                # Print out an entry for the header
+                generated_commands += '                ApiDumpContents& contents = ApiDumpLayerThreadContents();\n'
                 if has_return:
-                    generated_commands += '        contents.emplace_back("%s", "%s", "");\n' % (
+                    generated_commands += '                contents.Add("%s", "%s", "");\n' % (
                         cur_cmd.return_type.text, cur_cmd.name)
                 else:
-                    generated_commands += f'        contents.emplace_back("void", "{cur_cmd.name}", "");\n'
+                    generated_commands += f'                contents.Add("void", "{cur_cmd.name}", "");\n'
                 # Print out information for each parameter
                 for param in cur_cmd.params:
                     can_expand = False
@@ -1143,13 +1482,23 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
                             (param.is_const or param.pointer_count == 0)):
                         can_expand = True
                     generated_commands += self.writeParamMember(
-                        param, False, can_expand, 2)
+                        param, False, can_expand, 4)
 
                 # Now record the information
-                generated_commands += '        ApiDumpLayerRecordContent(contents);\n\n'
+                generated_commands += '                ApiDumpLayerRecordContent(contents);\n'
+                generated_commands += '            }\n'
+                generated_commands += '        }\n'
+                if cur_cmd.name == 'xrEndFrame':
+                    generated_commands += '        g_api_dump_filter.EndFrame();\n'
+                generated_commands += '\n'
 
                 # Call down, looking for the returned result if required.
+                # The loader implements the session label commands itself when the runtime
+                # does not, so the next entry in the chain may be missing.
                 generated_commands += '        '
+                if cur_cmd.name in ('xrSessionBeginDebugUtilsLabelRegionEXT', 'xrSessionEndDebugUtilsLabelRegionEXT',
+                                    'xrSessionInsertDebugUtilsLabelEXT'):
+                    generated_commands += f'if (nullptr != gen_dispatch_table->{base_name}) '
                 if has_return:
                     generated_commands += 'result = '
                 generated_commands += f'gen_dispatch_table->{base_name}('
@@ -1161,6 +1510,10 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
                     generated_commands += param.name
                     count = count + 1
                 generated_commands += ');\n'
+                if has_return and cur_cmd.return_type.text == 'XrResult':
+                    generated_commands += '        if (XR_FAILED(result)) {\n'
+                    generated_commands += '            ApiDumpLayerCallFailed();\n'
+                    generated_commands += '        }\n'
 
                 # If this is a create command, we have to create an entry in the appropriate
                 # unordered_map pointing to the correct dispatch table for the newly created
@@ -1178,8 +1531,12 @@ class ApiDumpOutputGenerator(AutomaticSourceOutputGenerator):
                         generated_commands += '                g_%s_dispatch_map[*%s] = gen_dispatch_table;\n' % (
                             second_base_handle_name, cur_cmd.params[-1].name)
                         generated_commands += '            }\n'
+                        generated_commands += '            ApiDumpLayerSetHandleDispatchTable(%s, MakeHandleGeneric(*%s), gen_dispatch_table);\n' % (
+                            self.genXrObjectType(cur_cmd.params[-1].type), cur_cmd.params[-1].name)
                         generated_commands += '        }\n'
                     elif is_destroy:
+                        generated_commands += '        ApiDumpLayerSetHandleDispatchTable(%s, MakeHandleGeneric(%s), nullptr);\n' % (
+                            self.genXrObjectType(cur_cmd.params[-1].type), cur_cmd.params[-1].name)
                         generated_commands += '        auto exists = g_%s_dispatch_map.find(%s);\n' % (
                             second_base_handle_name, cur_cmd.params[-1].name)
                         generated_commands += '        if (exists != g_%s_dispatch_map.end()) {\n' % second_base_handle_name
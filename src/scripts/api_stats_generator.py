@@ -0,0 +1,190 @@
+#!/usr/bin/env python3 -i
+#
+# Copyright (c) 2017-2026 The Khronos Group Inc.
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# Purpose:      This file utilizes the content formatted in the
+#               automatic_source_generator.py class to produce the
+#               generated source code for the API Stats layer.
+
+from automatic_source_generator import AutomaticSourceOutputGenerator, CurrentExtensionTracker
+from generator import write
+
+# The following commands are implemented by hand in api_stats_layer.cpp
+MANUALLY_DEFINED_IN_LAYER = set((
+    'xrGetInstanceProcAddr',
+    'xrCreateInstance',
+    'xrDestroyInstance',
+))
+
+# The loader implements these itself when the runtime does not, so the next entry
+# in the chain may be missing.
+OPTIONAL_IN_CHAIN = set((
+    'xrSessionBeginDebugUtilsLabelRegionEXT',
+    'xrSessionEndDebugUtilsLabelRegionEXT',
+    'xrSessionInsertDebugUtilsLabelEXT',
+))
+
+# ApiStatsOutputGenerator - subclass of AutomaticSourceOutputGenerator.
+
+
+class ApiStatsOutputGenerator(AutomaticSourceOutputGenerator):
+    """Generate API Stats layer source using XML element attributes from registry"""
+
+    # Override the base class header warning so the comment indicates this file.
+    #   self            the AutomaticSourceOutputGenerator object
+    def outputGeneratedHeaderWarning(self):
+        # File Comment
+        generated_warning = '// *********** THIS FILE IS GENERATED - DO NOT EDIT ***********\n'
+        generated_warning += '//     See api_stats_generator.py for modifications\n'
+        generated_warning += '// ************************************************************\n'
+        write(generated_warning, file=self.outFile)
+
+    # Call the base class to properly begin the file, and then add
+    # the file-specific header information.
+    #   self            the ApiStatsOutputGenerator object
+    #   gen_opts        the ApiStatsGeneratorOptions object
+    def beginFile(self, genOpts):
+        AutomaticSourceOutputGenerator.beginFile(self, genOpts)
+        preamble = ''
+        if self.genOpts.filename == 'xr_generated_api_stats.hpp':
+            preamble += '#pragma once\n\n'
+            preamble += '#include <openxr/openxr.h>\n\n'
+        elif self.genOpts.filename == 'xr_generated_api_stats.cpp':
+            preamble += '#include "api_stats.h"\n'
+            preamble += '#include "api_layer_platform_defines.h"\n'
+            preamble += '#include "xr_generated_dispatch_table.h"\n\n'
+            preamble += '#include <openxr/openxr_platform.h>\n\n'
+            preamble += '#include <string>\n\n'
+        write(preamble, file=self.outFile)
+
+    # Write out all the information for the appropriate file,
+    # and then call down to the base class to wrap everything up.
+    #   self            the ApiStatsOutputGenerator object
+    def endFile(self):
+        file_data = ''
+        if self.genOpts.filename == 'xr_generated_api_stats.hpp':
+            file_data += self.outputCommandEnum()
+        elif self.genOpts.filename == 'xr_generated_api_stats.cpp':
+            file_data += self.outputCommandNames()
+            file_data += self.outputLayerCommands()
+
+        write(file_data, file=self.outFile)
+
+        # Finish processing in superclass
+        AutomaticSourceOutputGenerator.endFile(self)
+
+    # Commands the layer passes through and times, in the order of their ApiStatsCommand values.
+    #   self            the ApiStatsOutputGenerator object
+    def timedCommands(self):
+        commands = []
+        for cur_cmd in self.core_commands + self.ext_commands:
+            if cur_cmd.name in self.no_trampoline_or_terminator or cur_cmd.name in MANUALLY_DEFINED_IN_LAYER:
+                continue
+            commands.append(cur_cmd)
+        return commands
+
+    # Output one enum value per timed command, indexing the per-command statistics.
+    # Every command gets a value, whether or not its platform is enabled in this build.
+    #   self            the ApiStatsOutputGenerator object
+    def outputCommandEnum(self):
+        enum_data = '\n// Index of each command the api_stats layer times\n'
+        enum_data += 'enum ApiStatsCommand : uint32_t {\n'
+        for cur_cmd in self.timedCommands():
+            enum_data += f'    API_STATS_COMMAND_{cur_cmd.name},\n'
+        enum_data += '    API_STATS_COMMAND_COUNT\n'
+        enum_data += '};\n\n'
+        enum_data += 'extern const char* const kApiStatsCommandNames[API_STATS_COMMAND_COUNT];\n\n'
+        enum_data += '// Returns the api_stats function for a command name, or nullptr if the layer does not time it.\n'
+        enum_data += 'PFN_xrVoidFunction ApiStatsLayerInnerGetInstanceProcAddr(const char* name);\n'
+        return enum_data
+
+    # Output the name of each timed command, in ApiStatsCommand order.
+    #   self            the ApiStatsOutputGenerator object
+    def outputCommandNames(self):
+        names_data = 'const char* const kApiStatsCommandNames[API_STATS_COMMAND_COUNT] = {\n'
+        for cur_cmd in self.timedCommands():
+            names_data += f'    "{cur_cmd.name}",\n'
+        names_data += '};\n'
+        return names_data
+
+    # Output a wrapper for each timed command that measures the time spent in the rest
+    # of the chain, and the lookup function returning those wrappers.
+    #   self            the ApiStatsOutputGenerator object
+    def outputLayerCommands(self):
+        cur_extension = CurrentExtensionTracker(self.conventions.api_version_prefix)
+        generated_commands = '\n// Automatically generated api_stats layer commands\n'
+        timed_commands = self.timedCommands()
+        for cur_cmd in timed_commands:
+            assert cur_cmd.ext_name
+            generated_commands += cur_extension.format_if_extension_changed(cur_cmd.ext_name, "\n// ---- {} commands\n")
+
+            has_return = cur_cmd.return_type is not None
+            base_name = cur_cmd.name[2:]
+
+            if cur_cmd.protect_value:
+                generated_commands += f'#if {cur_cmd.protect_string}\n'
+
+            prototype = cur_cmd.cdecl.replace(" xr", " ApiStatsLayerXr")
+            prototype = prototype.replace(";", " {\n")
+            generated_commands += prototype
+
+            call = f'g_api_stats_next_dispatch->{base_name}('
+            call += ', '.join(param.name for param in cur_cmd.params)
+            call += ')'
+
+            if cur_cmd.name in OPTIONAL_IN_CHAIN:
+                generated_commands += f'    if (nullptr == g_api_stats_next_dispatch->{base_name}) {{\n'
+                generated_commands += '        return XR_SUCCESS;\n'
+                generated_commands += '    }\n'
+
+            generated_commands += '    const uint64_t start = ApiStatsTimestamp();\n'
+            if has_return:
+                generated_commands += f'    {cur_cmd.return_type.text} result = {call};\n'
+                failed = 'XR_FAILED(result)' if cur_cmd.return_type.text == 'XrResult' else 'false'
+                generated_commands += f'    ApiStatsRecord(API_STATS_COMMAND_{cur_cmd.name}, start, {failed});\n'
+                generated_commands += '    return result;\n'
+            else:
+                generated_commands += f'    {call};\n'
+                generated_commands += f'    ApiStatsRecord(API_STATS_COMMAND_{cur_cmd.name}, start, false);\n'
+            generated_commands += '}\n\n'
+
+            if cur_cmd.protect_value:
+                generated_commands += f'#endif // {cur_cmd.protect_string}\n'
+
+        generated_commands += 'PFN_xrVoidFunction ApiStatsLayerInnerGetInstanceProcAddr(const char* name) {\n'
+        generated_commands += '    std::string func_name = name;\n'
+
+        # reset the state
+        cur_extension = CurrentExtensionTracker(self.conventions.api_version_prefix)
+
+        for cur_cmd in timed_commands:
+            generated_commands += cur_extension.format_if_extension_changed(cur_cmd.ext_name, "\n    // ---- {} commands\n")
+
+            if cur_cmd.protect_value:
+                generated_commands += f'#if {cur_cmd.protect_string}\n'
+
+            layer_command_name = cur_cmd.name.replace("xr", "ApiStatsLayerXr", 1)
+            generated_commands += f'    if (func_name == "{cur_cmd.name}") {{\n'
+            generated_commands += f'        return reinterpret_cast<PFN_xrVoidFunction>({layer_command_name});\n'
+            generated_commands += '    }\n'
+            if cur_cmd.protect_value:
+                generated_commands += f'#endif // {cur_cmd.protect_string}\n'
+
+        generated_commands += '    return nullptr;\n'
+        generated_commands += '}\n'
+
+        return generated_commands
@@ -28,6 +28,7 @@ sys.path.append(os.path.join(base_dir, 'src', 'scripts'))
 sys.path.append(os.path.join(base_dir, 'specification', 'scripts'))
 
 from api_dump_generator import ApiDumpOutputGenerator
+from api_stats_generator import ApiStatsOutputGenerator
 from automatic_source_generator import AutomaticSourceGeneratorOptions
 from generator import write
 from loader_source_generator import LoaderSourceOutputGenerator
@@ -324,6 +325,65 @@ def makeGenOpts(args):
             apientryp='XRAPI_PTR *')
     ]
 
+    # Binary capture decoders for api_dump_convert
+    genOpts['xr_generated_api_dump_binary.cpp'] = [
+        ApiDumpOutputGenerator,
+        AutomaticSourceGeneratorOptions(
+            conventions=conventions,
+            filename='xr_generated_api_dump_binary.cpp',
+            directory=directory,
+            apiname='openxr',
+            profile=None,
+            versions=featuresPat,
+            emitversions=featuresPat,
+            defaultExtensions='openxr',
+            addExtensions=None,
+            removeExtensions=None,
+            emitExtensions=emitExtensionsPat,
+            apicall='XRAPI_ATTR ',
+            apientry='XRAPI_CALL ',
+            apientryp='XRAPI_PTR *')
+    ]
+
+    # Source files generated for the api_stats layer
+    genOpts['xr_generated_api_stats.hpp'] = [
+        ApiStatsOutputGenerator,
+        AutomaticSourceGeneratorOptions(
+            conventions=conventions,
+            filename='xr_generated_api_stats.hpp',
+            directory=directory,
+            apiname='openxr',
+            profile=None,
+            versions=featuresPat,
+            emitversions=featuresPat,
+            defaultExtensions='openxr',
+            addExtensions=None,
+            removeExtensions=None,
+            emitExtensions=emitExtensionsPat,
+            apicall='XRAPI_ATTR ',
+            apientry='XRAPI_CALL ',
+            apientryp='XRAPI_PTR *')
+    ]
+
+    genOpts['xr_generated_api_stats.cpp'] = [
+        ApiStatsOutputGenerator,
+        AutomaticSourceGeneratorOptions(
+            conventions=conventions,
+            filename='xr_generated_api_stats.cpp',
+            directory=directory,
+            apiname='openxr',
+            profile=None,
+            versions=featuresPat,
+            emitversions=featuresPat,
+            defaultExtensions='openxr',
+            addExtensions=None,
+            removeExtensions=None,
+            emitExtensions=emitExtensionsPat,
+            apicall='XRAPI_ATTR ',
+            apientry='XRAPI_CALL ',
+            apientryp='XRAPI_PTR *')
+    ]
+
     # Source files generated for the core validation layer
     genOpts['xr_generated_core_validation.hpp'] = [
         ValidationSourceOutputGenerator,
@@ -363,6 +423,26 @@ def makeGenOpts(args):
             apientryp='XRAPI_PTR *')
     ]
 
+    # Core validation layer source for BUILD_CORE_VALIDATION_HANDLE_WRAPPING
+    genOpts['xr_generated_core_validation_wrapped.cpp'] = [
+        ValidationSourceOutputGenerator,
+        AutomaticSourceGeneratorOptions(
+            conventions=conventions,
+            filename='xr_generated_core_validation_wrapped.cpp',
+            directory=directory,
+            apiname='openxr',
+            profile=None,
+            versions=featuresPat,
+            emitversions=featuresPat,
+            defaultExtensions='openxr',
+            addExtensions=None,
+            removeExtensions=None,
+            emitExtensions=emitExtensionsPat,
+            apicall='XRAPI_ATTR ',
+            apientry='XRAPI_CALL ',
+            apientryp='XRAPI_PTR *')
+    ]
+
 
 def genTarget(args):
     """Create an API generator and corresponding generator options based on
@@ -42,6 +42,41 @@ VALID_USAGE_MANUALLY_DEFINED = set((
     'xrSessionInsertDebugUtilsLabelEXT',
 ))
 
+# Per-frame commands whose validation depth can be lowered at run time with
+# XR_CORE_VALIDATION_TIER, mapped to the tier each one uses when that setting
+# does not name one.
+VALID_USAGE_TIERED_COMMANDS = {
+    'xrWaitFrame': 'VALID_USAGE_TIER_FULL',
+    'xrBeginFrame': 'VALID_USAGE_TIER_FULL',
+    'xrEndFrame': 'VALID_USAGE_TIER_FULL',
+    'xrLocateViews': 'VALID_USAGE_TIER_FULL',
+    'xrLocateSpace': 'VALID_USAGE_TIER_FULL',
+    'xrLocateSpaces': 'VALID_USAGE_TIER_FULL',
+    'xrSyncActions': 'VALID_USAGE_TIER_FULL',
+    'xrGetActionStateBoolean': 'VALID_USAGE_TIER_FULL',
+    'xrGetActionStateFloat': 'VALID_USAGE_TIER_FULL',
+    'xrGetActionStateVector2f': 'VALID_USAGE_TIER_FULL',
+    'xrGetActionStatePose': 'VALID_USAGE_TIER_FULL',
+}
+
+# C types that deferred validation copies when a structure points at them.  Pointers to
+# other types from outside the registry (Display, ID3D11Device, ...) are kept as they are:
+# those types may be incomplete, and their contents are never validated.
+VALID_USAGE_DEEP_COPY_C_TYPES = set((
+    'char',
+    'float',
+    'double',
+    'int8_t',
+    'uint8_t',
+    'int16_t',
+    'uint16_t',
+    'int32_t',
+    'uint32_t',
+    'int64_t',
+    'uint64_t',
+    'size_t',
+))
+
 LOADER_STRUCTS = [
     'XrApiLayerNextInfo',
     'XrApiLayerCreateInfo',
@@ -78,6 +113,10 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
     def beginFile(self, genOpts):
         AutomaticSourceOutputGenerator.beginFile(self, genOpts)
         assert self.genOpts
+        # The wrapped variant hands the application wrapped handles, see BUILD_CORE_VALIDATION_HANDLE_WRAPPING.
+        self.wrap_handles = self.genOpts.filename == 'xr_generated_core_validation_wrapped.cpp'
+        self.wrap_struct_info = None
+        self.deep_copy_structs = None
         preamble = ''
         if self.genOpts.filename == 'xr_generated_core_validation.hpp':
             preamble += '#pragma once\n'
@@ -95,7 +134,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
             preamble += '#include <unordered_map>\n'
             preamble += '#include <thread>\n'
             preamble += '#include <mutex>\n\n'
-        elif self.genOpts.filename == 'xr_generated_core_validation.cpp':
+        elif self.genOpts.filename in ('xr_generated_core_validation.cpp', 'xr_generated_core_validation_wrapped.cpp'):
             preamble += '#include "xr_generated_core_validation.hpp"\n'
             preamble += '\n'
             preamble += '#include "api_layer_platform_defines.h"\n'
@@ -120,6 +159,10 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
             preamble += '#include <utility>\n'
             preamble += '#include <vector>\n'
             preamble += '\n'
+            if self.wrap_handles:
+                preamble += '#if !defined(XR_CORE_VALIDATION_WRAP_HANDLES)\n'
+                preamble += '#error "Handle wrapping source built without XR_CORE_VALIDATION_WRAP_HANDLES"\n'
+                preamble += '#endif\n\n'
             preamble += '#ifdef __clang__\n'
             preamble += '#pragma GCC diagnostic ignored "-Wunused-parameter"\n'
             preamble += '#endif\n'
@@ -133,7 +176,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
         file_data = ''
         if self.genOpts.filename == 'xr_generated_core_validation.hpp':
             file_data += self.outputValidationHeaderInfo()
-        elif self.genOpts.filename == 'xr_generated_core_validation.cpp':
+        elif self.genOpts.filename in ('xr_generated_core_validation.cpp', 'xr_generated_core_validation_wrapped.cpp'):
             file_data += self.outputCommonTypesForValidation()
             file_data += self.outputValidationSourceFuncs()
         write(file_data, file=self.outFile)
@@ -158,7 +201,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
             if handle.name == 'XrInstance':
                 info_type = "InstanceHandleInfo"
             else:
-                info_type = f'HandleInfo<{handle_name}>'
+                info_type = f'GenValidUsageHandleInfo<{handle_name}>'
 
             lines.append(f'{extern_keyword}{info_type} {self.makeInfoName(handle)};')
             if handle.protect_value:
@@ -212,13 +255,12 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
         next_chain_info += '};\n\n'
         next_chain_info += '// Prototype for validateNextChain command (it uses the validate structure commands so add it after\n'
         next_chain_info += 'NextChainResult ValidateNextChain(GenValidUsageXrInstanceInfo *instance_info,\n'
-        next_chain_info += '                                  const std::string &command_name,\n'
-        next_chain_info += '                                  std::vector<GenValidUsageXrObjectInfo>& objects_info,\n'
+        next_chain_info += '                                  const char *command_name,\n'
+        next_chain_info += '                                  GenValidUsageObjectList& objects_info,\n'
         next_chain_info += '                                  const void* next,\n'
-        next_chain_info += '                                  std::unordered_set<XrStructureType>& valid_ext_structs,\n'
-        next_chain_info += '                                  std::unordered_set<XrStructureType>& encountered_structs,\n'
-        next_chain_info += '                                  std::unordered_set<XrStructureType>& unknown_structs,\n'
-        next_chain_info += '                                  std::unordered_set<XrStructureType>& duplicate_structs);\n\n'
+        next_chain_info += '                                  GenValidUsageStructTypeSet valid_ext_structs,\n'
+        next_chain_info += '                                  bool& has_unknown_structs,\n'
+        next_chain_info += '                                  bool& has_duplicate_structs);\n\n'
         return next_chain_info
 
     # Generate C++ enum and utility function prototypes for validating
@@ -280,10 +322,10 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                 enum_value_validate += f'#if {enum_tuple.protect_string}\n'
             enum_value_validate += f'// Function to validate {enum_tuple.name} enum\n'
             enum_value_validate += 'bool ValidateXrEnum(GenValidUsageXrInstanceInfo *instance_info,\n'
-            enum_value_validate += '                    const std::string &command_name,\n'
-            enum_value_validate += '                    const std::string &validation_name,\n'
-            enum_value_validate += '                    const std::string &item_name,\n'
-            enum_value_validate += '                    std::vector<GenValidUsageXrObjectInfo>& objects_info,\n'
+            enum_value_validate += '                    const char *command_name,\n'
+            enum_value_validate += '                    const char *validation_name,\n'
+            enum_value_validate += '                    const char *item_name,\n'
+            enum_value_validate += '                    GenValidUsageObjectList& objects_info,\n'
             enum_value_validate += '                    const %s value) {\n' % enum_tuple.name
             indent = 1
             enum_value_validate += self.writeIndent(indent)
@@ -305,25 +347,9 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                 enum_value_validate += 'if (nullptr != instance_info && !ExtensionEnabled(instance_info->enabled_extensions, "%s")) {\n' % enum_tuple.ext_name
                 indent += 1
                 enum_value_validate += self.writeIndent(indent)
-                enum_value_validate += 'std::string vuid = "VUID-";\n'
-                enum_value_validate += self.writeIndent(indent)
-                enum_value_validate += 'vuid += validation_name;\n'
-                enum_value_validate += self.writeIndent(indent)
-                enum_value_validate += 'vuid += "-";\n'
-                enum_value_validate += self.writeIndent(indent)
-                enum_value_validate += 'vuid += item_name;\n'
-                enum_value_validate += self.writeIndent(indent)
-                enum_value_validate += 'vuid += "-parameter";\n'
-                enum_value_validate += self.writeIndent(indent)
-                enum_value_validate += f'std::string error_str = "{enum_tuple.name} requires extension ";\n'
-                enum_value_validate += self.writeIndent(indent)
-                enum_value_validate += f'error_str += " \\"{enum_tuple.ext_name}\\" to be enabled, but it is not enabled";\n'
+                enum_value_validate += 'GenValidUsageReportParameter(instance_info, validation_name, item_name, command_name, objects_info,\n'
                 enum_value_validate += self.writeIndent(indent)
-                enum_value_validate += 'CoreValidLogMessage(instance_info, vuid,\n'
-                enum_value_validate += self.writeIndent(indent)
-                enum_value_validate += '                    VALID_USAGE_DEBUG_SEVERITY_ERROR, command_name,\n'
-                enum_value_validate += self.writeIndent(indent)
-                enum_value_validate += '                    objects_info, error_str);\n'
+                enum_value_validate += f'                             "{enum_tuple.name} requires extension  \\"{enum_tuple.ext_name}\\" to be enabled, but it is not enabled");\n'
                 enum_value_validate += self.writeIndent(indent)
                 enum_value_validate += 'return false;\n'
                 indent -= 1
@@ -359,28 +385,9 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                     enum_value_validate += 'if (nullptr != instance_info && !ExtensionEnabled(instance_info->enabled_extensions, "%s")) {\n' % cur_value.ext_name
                     indent += 1
                     enum_value_validate += self.writeIndent(indent)
-                    enum_value_validate += 'std::string vuid = "VUID-";\n'
-                    enum_value_validate += self.writeIndent(indent)
-                    enum_value_validate += 'vuid += validation_name;\n'
-                    enum_value_validate += self.writeIndent(indent)
-                    enum_value_validate += 'vuid += "-";\n'
-                    enum_value_validate += self.writeIndent(indent)
-                    enum_value_validate += 'vuid += item_name;\n'
-                    enum_value_validate += self.writeIndent(indent)
-                    enum_value_validate += 'vuid += "-parameter";\n'
-                    enum_value_validate += self.writeIndent(indent)
-                    enum_value_validate += 'std::string error_str = "%s value \\"%s\\"";\n' % (
-                        enum_tuple.name, cur_value.name)
+                    enum_value_validate += 'GenValidUsageReportParameter(instance_info, validation_name, item_name, command_name, objects_info,\n'
                     enum_value_validate += self.writeIndent(indent)
-                    enum_value_validate += 'error_str += " being used, which requires extension ";\n'
-                    enum_value_validate += self.writeIndent(indent)
-                    enum_value_validate += f'error_str += " \\"{cur_value.ext_name}\\" to be enabled, but it is not enabled";\n'
-                    enum_value_validate += self.writeIndent(indent)
-                    enum_value_validate += 'CoreValidLogMessage(instance_info, vuid,\n'
-                    enum_value_validate += self.writeIndent(indent)
-                    enum_value_validate += '                    VALID_USAGE_DEBUG_SEVERITY_ERROR, command_name,\n'
-                    enum_value_validate += self.writeIndent(indent)
-                    enum_value_validate += '                    objects_info, error_str);\n'
+                    enum_value_validate += f'                             "{enum_tuple.name} value \\"{cur_value.name}\\" being used, which requires extension  \\"{cur_value.ext_name}\\" to be enabled, but it is not enabled");\n'
                     enum_value_validate += self.writeIndent(indent)
                     enum_value_validate += 'return false;\n'
                     indent -= 1
@@ -435,8 +442,8 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
 
             if xr_struct.protect_value:
                 validation_internal_protos += f'#if {xr_struct.protect_string}\n'
-            validation_internal_protos += 'XrResult ValidateXrStruct(GenValidUsageXrInstanceInfo *instance_info, const std::string &command_name,\n'
-            validation_internal_protos += '                          std::vector<GenValidUsageXrObjectInfo>& objects_info, bool check_members, bool check_pnext,\n'
+            validation_internal_protos += 'XrResult ValidateXrStruct(GenValidUsageXrInstanceInfo *instance_info, const char *command_name,\n'
+            validation_internal_protos += '                          GenValidUsageObjectList& objects_info, bool check_members, bool check_pnext,\n'
             validation_internal_protos += f'                          const {xr_struct.name}* value);\n'
             if xr_struct.protect_value:
                 validation_internal_protos += f'#endif // {xr_struct.protect_string}\n'
@@ -448,13 +455,12 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
         indent = 1
         next_chain_info = ''
         next_chain_info += 'NextChainResult ValidateNextChain(GenValidUsageXrInstanceInfo *instance_info,\n'
-        next_chain_info += '                                  const std::string &command_name,\n'
-        next_chain_info += '                                  std::vector<GenValidUsageXrObjectInfo>& objects_info,\n'
+        next_chain_info += '                                  const char *command_name,\n'
+        next_chain_info += '                                  GenValidUsageObjectList& objects_info,\n'
         next_chain_info += '                                  const void* next,\n'
-        next_chain_info += '                                  std::unordered_set<XrStructureType>& valid_ext_structs,\n'
-        next_chain_info += '                                  std::unordered_set<XrStructureType>& encountered_structs,\n'
-        next_chain_info += '                                  std::unordered_set<XrStructureType>& unknown_structs,\n'
-        next_chain_info += '                                  std::unordered_set<XrStructureType>& duplicate_structs) {\n'
+        next_chain_info += '                                  GenValidUsageStructTypeSet valid_ext_structs,\n'
+        next_chain_info += '                                  bool& has_unknown_structs,\n'
+        next_chain_info += '                                  bool& has_duplicate_structs) {\n'
         next_chain_info += self.writeIndent(indent)
         next_chain_info += 'NextChainResult return_result = NEXT_CHAIN_RESULT_VALID;\n'
         # When validating structs along the next chain, we do it iteratively and only check the type to make sure it's allowed in the chain
@@ -464,45 +470,31 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
         next_chain_info += 'while (next_header != nullptr) {\n'
         indent += 1
         next_chain_info += self.writeIndent(indent)
-        next_chain_info += 'bool valid_ext = valid_ext_structs.count(next_header->type) > 0;\n'
-        next_chain_info += self.writeIndent(indent)
-        next_chain_info += 'if (!valid_ext) {\n'
+        next_chain_info += 'if (!valid_ext_structs.contains(next_header->type)) {\n'
         indent += 1
         next_chain_info += self.writeIndent(indent)
         next_chain_info += '// Not a known valid extension structure type for this next chain.\n'
         next_chain_info += self.writeIndent(indent)
-        next_chain_info += 'if (unknown_structs.count(next_header->type) > 0) {\n'
-        indent += 1
-        next_chain_info += self.writeIndent(indent)
-        next_chain_info += 'duplicate_structs.insert(next_header->type);\n'
-        indent -= 1
-        next_chain_info += self.writeIndent(indent)
-        next_chain_info += '} else {\n'
-        indent += 1
-        next_chain_info += self.writeIndent(indent)
-        next_chain_info += 'unknown_structs.insert(next_header->type);\n'
+        next_chain_info += 'has_unknown_structs = true;\n'
         indent -= 1
         next_chain_info += self.writeIndent(indent)
         next_chain_info += '}\n'
-        indent -= 1
         next_chain_info += self.writeIndent(indent)
-        next_chain_info += '} else {\n'
-        indent += 1
+        next_chain_info += '// Check to see if we\'ve already encountered this structure type.  Chains are short, so looking\n'
         next_chain_info += self.writeIndent(indent)
-        next_chain_info += '// Check to see if we\'ve already encountered this structure.\n'
+        next_chain_info += '// back over them is cheaper than keeping a set of the types seen.\n'
         next_chain_info += self.writeIndent(indent)
-        next_chain_info += 'bool already_encountered_ext = encountered_structs.count(next_header->type) > 0;\n'
+        next_chain_info += 'for (const XrBaseInStructure* earlier_header = reinterpret_cast<const XrBaseInStructure*>(next);\n'
         next_chain_info += self.writeIndent(indent)
-        next_chain_info += 'if (already_encountered_ext) {\n'
+        next_chain_info += '     earlier_header != next_header; earlier_header = earlier_header->next) {\n'
         indent += 1
         next_chain_info += self.writeIndent(indent)
-        next_chain_info += 'duplicate_structs.insert(next_header->type);\n'
-        indent -= 1
-        next_chain_info += self.writeIndent(indent)
-        next_chain_info += '} else {\n'
+        next_chain_info += 'if (earlier_header->type == next_header->type) {\n'
         indent += 1
         next_chain_info += self.writeIndent(indent)
-        next_chain_info += 'encountered_structs.insert(next_header->type);\n'
+        next_chain_info += 'has_duplicate_structs = true;\n'
+        next_chain_info += self.writeIndent(indent)
+        next_chain_info += 'break;\n'
         indent -= 1
         next_chain_info += self.writeIndent(indent)
         next_chain_info += '}\n'
@@ -640,7 +632,8 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
 
         validation_header_info += '\n// Externs for Core Validation\n'
         validation_header_info += self.outputInfoMapDeclarations(extern=True)
-        validation_header_info += 'void GenValidUsageCleanUpMaps(GenValidUsageXrInstanceInfo *instance_info);\n\n'
+        validation_header_info += 'void GenValidUsageCleanUpMaps(GenValidUsageXrInstanceInfo *instance_info);\n'
+        validation_header_info += 'void GenValidUsageApplyTierSettings(const GenValidUsageTierSettings &settings);\n\n'
 
         validation_header_info += '\n// Function to convert XrObjectType to string\n'
         validation_header_info += 'std::string GenValidUsageXrObjectTypeToString(const XrObjectType& type);\n\n'
@@ -675,9 +668,9 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
             elif extension.type == 'system':
                 number_of_system_extensions += 1
         verify_extensions += 'bool ValidateInstanceExtensionDependencies(GenValidUsageXrInstanceInfo *gen_instance_info,\n'
-        verify_extensions += '                                           const std::string &command,\n'
-        verify_extensions += '                                           const std::string &struct_name,\n'
-        verify_extensions += '                                           std::vector<GenValidUsageXrObjectInfo>& objects_info,\n'
+        verify_extensions += '                                           const char *command,\n'
+        verify_extensions += '                                           const char *struct_name,\n'
+        verify_extensions += '                                           GenValidUsageObjectList& objects_info,\n'
         verify_extensions += '                                           std::vector<std::string> &extensions) {\n'
         indent = 1
         if number_of_instance_extensions > 0:
@@ -721,19 +714,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                             verify_extensions += 'if (nullptr != gen_instance_info) {\n'
                             indent += 1
                             verify_extensions += self.writeIndent(indent)
-                            verify_extensions += 'std::string vuid = "VUID-";\n'
-                            verify_extensions += self.writeIndent(indent)
-                            verify_extensions += 'vuid += command;\n'
-                            verify_extensions += self.writeIndent(indent)
-                            verify_extensions += 'vuid += "-";\n'
-                            verify_extensions += self.writeIndent(indent)
-                            verify_extensions += 'vuid += struct_name;\n'
-                            verify_extensions += self.writeIndent(indent)
-                            verify_extensions += 'vuid += "-parameter";\n'
-                            verify_extensions += self.writeIndent(indent)
-                            verify_extensions += 'CoreValidLogMessage(gen_instance_info, vuid, VALID_USAGE_DEBUG_SEVERITY_ERROR,\n'
-                            verify_extensions += self.writeIndent(indent)
-                            verify_extensions += '                    command, objects_info,\n'
+                            verify_extensions += 'GenValidUsageReportParameter(gen_instance_info, command, struct_name, command, objects_info,\n'
                             verify_extensions += self.writeIndent(indent)
                             verify_extensions += f'                    "Missing extension dependency \\"{required_ext}\\" (required by extension" \\\n'
                             verify_extensions += self.writeIndent(indent)
@@ -763,9 +744,9 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
         verify_extensions += 'return true;\n'
         verify_extensions += '}\n\n'
         verify_extensions += 'bool ValidateSystemExtensionDependencies(GenValidUsageXrInstanceInfo *gen_instance_info,\n'
-        verify_extensions += '                                         const std::string &command,\n'
-        verify_extensions += '                                         const std::string &struct_name,\n'
-        verify_extensions += '                                         std::vector<GenValidUsageXrObjectInfo>& objects_info,\n'
+        verify_extensions += '                                         const char *command,\n'
+        verify_extensions += '                                         const char *struct_name,\n'
+        verify_extensions += '                                         GenValidUsageObjectList& objects_info,\n'
         verify_extensions += '                                         std::vector<std::string> &extensions) {\n'
         indent = 1
         if number_of_system_extensions > 0:
@@ -816,19 +797,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                                 verify_extensions += 'if (!ExtensionEnabled(extensions, "%s")) {\n' % required_ext
                             indent += 1
                             verify_extensions += self.writeIndent(indent)
-                            verify_extensions += 'std::string vuid = "VUID-";\n'
-                            verify_extensions += self.writeIndent(indent)
-                            verify_extensions += 'vuid += command;\n'
-                            verify_extensions += self.writeIndent(indent)
-                            verify_extensions += 'vuid += "-";\n'
-                            verify_extensions += self.writeIndent(indent)
-                            verify_extensions += 'vuid += struct_name;\n'
-                            verify_extensions += self.writeIndent(indent)
-                            verify_extensions += 'vuid += "-parameter";\n'
-                            verify_extensions += self.writeIndent(indent)
-                            verify_extensions += 'CoreValidLogMessage(gen_instance_info, vuid, VALID_USAGE_DEBUG_SEVERITY_ERROR,\n'
-                            verify_extensions += self.writeIndent(indent)
-                            verify_extensions += '                    command, objects_info,\n'
+                            verify_extensions += 'GenValidUsageReportParameter(gen_instance_info, command, struct_name, command, objects_info,\n'
                             verify_extensions += self.writeIndent(indent)
                             verify_extensions += f'                    "Missing extension dependency \\"{required_ext}\\" (required by extension" \\'
                             verify_extensions += self.writeIndent(indent)
@@ -1017,19 +986,8 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
         validate_struct_next = self.writeIndent(indent)
         validate_struct_next += 'if (check_pnext) {\n'
         indent += 1
-        validate_struct_next += self.writeIndent(indent)
-        validate_struct_next += 'std::unordered_set<XrStructureType> valid_ext_structs;\n'
-        validate_struct_next += self.writeIndent(indent)
-        validate_struct_next += 'std::unordered_set<XrStructureType> unknown_structs;\n'
-        validate_struct_next += self.writeIndent(indent)
-        validate_struct_next += 'std::unordered_set<XrStructureType> duplicate_ext_structs;\n'
-        validate_struct_next += self.writeIndent(indent)
-        validate_struct_next += 'std::unordered_set<XrStructureType> encountered_structs;\n'
-        # First add valid extension struct for this struct
-        if member.valid_extension_structs:
-            for valid_struct in member.valid_extension_structs:
-                validate_struct_next += self.writeIndent(indent)
-                validate_struct_next += f'valid_ext_structs.insert({self.genXrStructureType(valid_struct)});\n'
+        # First gather the valid extension structs for this struct
+        valid_structs = list(member.valid_extension_structs or [])
 
         # Then check if this struct is part of a relation group (extends a base struct) and add the base structs valid extension structs.
         for xr_struct in self.api_structures:
@@ -1045,22 +1003,40 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                     for parent_memeber in xr_struct.members:
                         if parent_memeber.name == 'next':
                             if parent_memeber.valid_extension_structs:
-                                for valid_struct in parent_memeber.valid_extension_structs:
-                                    validate_struct_next += self.writeIndent(indent)
-                                    validate_struct_next += f'valid_ext_structs.insert({self.genXrStructureType(valid_struct)});\n'
+                                valid_structs.extend(parent_memeber.valid_extension_structs)
                     break
 
+        # The types are emitted sorted by value, so that they can be looked up with a binary search
+        valid_types = {}
+        for valid_struct in valid_structs:
+            type_name = self.genXrStructureType(valid_struct)
+            valid_types.setdefault(self.getStructureTypeValue(type_name), type_name)
+        validate_struct_next += self.writeIndent(indent)
+        if valid_types:
+            validate_struct_next += 'static constexpr XrStructureType valid_ext_types[] = {\n'
+            for value in sorted(valid_types):
+                validate_struct_next += self.writeIndent(indent + 1)
+                validate_struct_next += f'{valid_types[value]},\n'
+            validate_struct_next += self.writeIndent(indent)
+            validate_struct_next += '};\n'
+            validate_struct_next += self.writeIndent(indent)
+            validate_struct_next += 'constexpr GenValidUsageStructTypeSet valid_ext_structs(valid_ext_types);\n'
+        else:
+            validate_struct_next += 'constexpr GenValidUsageStructTypeSet valid_ext_structs;\n'
+        validate_struct_next += self.writeIndent(indent)
+        validate_struct_next += 'bool has_unknown_structs = false;\n'
+        validate_struct_next += self.writeIndent(indent)
+        validate_struct_next += 'bool has_duplicate_structs = false;\n'
+
         validate_struct_next += self.writeIndent(indent)
         validate_struct_next += 'NextChainResult next_result = ValidateNextChain(instance_info, command_name, objects_info,\n'
         validate_struct_next += self.writeIndent(indent)
         validate_struct_next += '                                                 %s->%s, valid_ext_structs,\n' % (
             struct_name, member.name)
         validate_struct_next += self.writeIndent(indent)
-        validate_struct_next += '                                                 encountered_structs,\n'
-        validate_struct_next += self.writeIndent(indent)
-        validate_struct_next += '                                                 unknown_structs,\n'
+        validate_struct_next += '                                                 has_unknown_structs,\n'
         validate_struct_next += self.writeIndent(indent)
-        validate_struct_next += '                                                 duplicate_ext_structs);\n'
+        validate_struct_next += '                                                 has_duplicate_structs);\n'
         validate_struct_next += self.writeIndent(indent)
         validate_struct_next += '// No valid extension structs for this \'next\'.  Therefore, must be NULL\n'
         validate_struct_next += self.writeIndent(indent)
@@ -1068,7 +1044,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
         validate_struct_next += self.writeIndent(indent)
         validate_struct_next += 'if (NEXT_CHAIN_RESULT_ERROR == next_result) {\n'
         validate_struct_next += self.writeIndent(indent + 1)
-        validate_struct_next += f'CoreValidLogMessage(instance_info, "VUID-{struct_type}-{member.name}-next",\n'
+        validate_struct_next += f'GenValidUsageReport(instance_info, "VUID-{struct_type}-{member.name}-next",\n'
         validate_struct_next += self.writeIndent(indent + 1)
         validate_struct_next += '                    VALID_USAGE_DEBUG_SEVERITY_ERROR, command_name,\n'
         validate_struct_next += self.writeIndent(indent + 1)
@@ -1079,45 +1055,22 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
         validate_struct_next += self.writeIndent(indent)
         validate_struct_next += '}\n'
 
+        # The offending types are only gathered and formatted once a message is actually reported
         validate_struct_next += self.writeIndent(indent)
-        validate_struct_next += 'if (unknown_structs.size() > 0) {\n'
-        validate_struct_next += self.writeIndent(indent + 1)
-        validate_struct_next += 'std::string error_message = "Unknown structures type(s) in \\"next\\" chain for ";\n'
-        validate_struct_next += self.writeIndent(indent + 1)
-        validate_struct_next += f'error_message += "{struct_type} : ";\n'
-        validate_struct_next += self.writeIndent(indent + 1)
-        validate_struct_next += 'error_message += StructTypesToString(instance_info, unknown_structs);\n'
-        validate_struct_next += self.writeIndent(indent + 1)
-        validate_struct_next += 'error_message += ", the valid structure type(s) are ";\n'
-        validate_struct_next += self.writeIndent(indent + 1)
-        validate_struct_next += 'error_message += StructTypesToString(instance_info, valid_ext_structs);\n'
+        validate_struct_next += 'if (has_unknown_structs) {\n'
         validate_struct_next += self.writeIndent(indent + 1)
-        validate_struct_next += f'CoreValidLogMessage(instance_info, "VUID-{struct_type}-next-unknown",\n'
+        validate_struct_next += f'GenValidUsageReportUnknownNextStructs(instance_info, "{struct_type}", command_name, objects_info,\n'
         validate_struct_next += self.writeIndent(indent + 1)
-        validate_struct_next += '                    VALID_USAGE_DEBUG_SEVERITY_DEBUG, command_name,\n'
-        validate_struct_next += self.writeIndent(indent + 1)
-        validate_struct_next += '                    objects_info,\n'
-        validate_struct_next += self.writeIndent(indent + 1)
-        validate_struct_next += '                    error_message);\n'
+        validate_struct_next += f'                                      {struct_name}->{member.name}, valid_ext_structs);\n'
         validate_struct_next += self.writeIndent(indent)
         validate_struct_next += '}\n'
 
         validate_struct_next += self.writeIndent(indent)
-        validate_struct_next += 'if (duplicate_ext_structs.size() > 0) {\n'
-        validate_struct_next += self.writeIndent(indent + 1)
-        validate_struct_next += 'std::string error_message = "Multiple structures of the same type(s) in \\"next\\" chain for ";\n'
-        validate_struct_next += self.writeIndent(indent + 1)
-        validate_struct_next += f'error_message += "{struct_type} : ";\n'
+        validate_struct_next += 'if (has_duplicate_structs) {\n'
         validate_struct_next += self.writeIndent(indent + 1)
-        validate_struct_next += 'error_message += StructTypesToString(instance_info, duplicate_ext_structs);\n'
+        validate_struct_next += f'GenValidUsageReportDuplicateNextStructs(instance_info, "{struct_type}", command_name, objects_info,\n'
         validate_struct_next += self.writeIndent(indent + 1)
-        validate_struct_next += f'CoreValidLogMessage(instance_info, "VUID-{struct_type}-next-unique",\n'
-        validate_struct_next += self.writeIndent(indent + 1)
-        validate_struct_next += '                    VALID_USAGE_DEBUG_SEVERITY_DEBUG, command_name,\n'
-        validate_struct_next += self.writeIndent(indent + 1)
-        validate_struct_next += '                    objects_info,\n'
-        validate_struct_next += self.writeIndent(indent + 1)
-        validate_struct_next += '                    error_message);\n'
+        validate_struct_next += f'                                        {struct_name}->{member.name});\n'
         validate_struct_next += self.writeIndent(indent)
         validate_struct_next += '}\n'
         indent -= 1
@@ -1125,6 +1078,15 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
         validate_struct_next += '}\n'
         return validate_struct_next
 
+    # Look up the numeric value of an XrStructureType enumerant, following aliases.
+    #   self            the ValidationSourceOutputGenerator object
+    #   type_name       the name of the enumerant, e.g. XR_TYPE_INSTANCE_CREATE_INFO
+    def getStructureTypeValue(self, type_name):
+        elem = self.registry.enumdict[type_name].elem
+        if elem.get('alias'):
+            return self.getStructureTypeValue(elem.get('alias'))
+        return self.enumToValue(elem, True)[0]
+
     # Generate inline C++ code to check if a pointer to a variable or array is valid.
     #   self                the ValidationSourceOutputGenerator object
     #   cmd_struct_name     the name of the structure or command generating this validation check.
@@ -1159,7 +1121,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
             array_check += 'if (nullptr == %s) {\n' % pointer_to_check
             indent = indent + 1
             array_check += self.writeIndent(indent)
-            array_check += 'CoreValidLogMessage(%s, "VUID-%s-%s-parameter",\n' % (instance_info_string,
+            array_check += 'GenValidUsageReport(%s, "VUID-%s-%s-parameter",\n' % (instance_info_string,
                                                                                   cmd_struct_name,
                                                                                   member_param_name)
             array_check += self.writeIndent(indent)
@@ -1179,7 +1141,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                 pointer_to_check, full_count_var)
             indent = indent + 1
             array_check += self.writeIndent(indent)
-            array_check += 'CoreValidLogMessage(%s, "VUID-%s-%s-parameter",\n' % (instance_info_string,
+            array_check += 'GenValidUsageReport(%s, "VUID-%s-%s-parameter",\n' % (instance_info_string,
                                                                                   cmd_struct_name,
                                                                                   member_param_name)
             array_check += self.writeIndent(indent)
@@ -1197,6 +1159,38 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
         array_check += '}\n'
         return array_check
 
+    # Write a report that a member of a structure, or a parameter of a command, is invalid.  The
+    # message is only put together by GenValidUsageReport*, once the check has failed.
+    #   self                    the ValidationSourceOutputGenerator object
+    #   instance_info_variable  the name of the variable holding the instance information
+    #   struct_command_name     the name of the structure or command being validated
+    #   command_name_variable   the name of the variable, or literal, holding the command name
+    #   param_member            the member or parameter that is invalid
+    #   is_command              Boolean indicating that this is being called directly from inside a command
+    #   loop_param_name         the name of the index of the invalid element, or None if not an array
+    #   suffix                  the end of the message
+    #   indent                  the number of "tabs" to space in for the resulting C+ code.
+    def writeReportMember(self, instance_info_variable, struct_command_name, command_name_variable, param_member,
+                          is_command, loop_param_name, suffix, indent):
+        if is_command:
+            description = f'Command {struct_command_name} param {param_member.name}'
+        else:
+            description = f'Structure {struct_command_name} member {param_member.name}'
+        report = self.writeIndent(indent)
+        if loop_param_name:
+            report += 'GenValidUsageReportElement(%s, "VUID-%s-%s-parameter", %s, objects_info,\n' % (
+                instance_info_variable, struct_command_name, param_member.name, command_name_variable)
+            report += self.writeIndent(indent)
+            report += f'                           "{description}", {loop_param_name}, "{suffix}");\n'
+        else:
+            report += 'GenValidUsageReport(%s, "VUID-%s-%s-parameter",\n' % (
+                instance_info_variable, struct_command_name, param_member.name)
+            report += self.writeIndent(indent)
+            report += f'                    VALID_USAGE_DEBUG_SEVERITY_ERROR, {command_name_variable},\n'
+            report += self.writeIndent(indent)
+            report += f'                    objects_info, "{description}{suffix}");\n'
+        return report
+
     # Write an inline check to make sure an Enum is valid
     #   self                the ValidationSourceOutputGenerator object
     #   cmd_struct_name     the name of the structure or command generating this validation check.
@@ -1231,19 +1225,14 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
             instance_info_string, cmd_name_param, cmd_struct_name, param_name, pointer_string, full_param_name)
         int_indent = int_indent + 1
         inline_enum_str += self.writeIndent(int_indent)
-        inline_enum_str += 'std::ostringstream oss_enum;\n'
-        inline_enum_str += self.writeIndent(int_indent)
-        inline_enum_str += f'oss_enum << "{error_prefix} {param_type} \\"{param_name}\\" enum value ";\n'
+        inline_enum_str += 'GenValidUsageReportValue(%s, "VUID-%s-%s-parameter", %s, objects_info,\n' % (instance_info_string,
+                                                                                                       cmd_struct_name,
+                                                                                                       param_name,
+                                                                                                       cmd_name_param)
         inline_enum_str += self.writeIndent(int_indent)
-        inline_enum_str += f'oss_enum << Uint64ToHexString(static_cast<uint64_t>({pointer_string}{full_param_name}));\n'
+        inline_enum_str += f'                         "{error_prefix} {param_type} \\"{param_name}\\" enum value ",\n'
         inline_enum_str += self.writeIndent(int_indent)
-        inline_enum_str += 'CoreValidLogMessage(%s, "VUID-%s-%s-parameter",\n' % (instance_info_string,
-                                                                                  cmd_struct_name,
-                                                                                  param_name)
-        inline_enum_str += self.writeIndent(int_indent)
-        inline_enum_str += f'                    VALID_USAGE_DEBUG_SEVERITY_ERROR, {cmd_name_param},\n'
-        inline_enum_str += self.writeIndent(int_indent)
-        inline_enum_str += '                    objects_info, oss_enum.str());\n'
+        inline_enum_str += f'                         static_cast<uint64_t>({pointer_string}{full_param_name}));\n'
         inline_enum_str += self.writeIndent(int_indent)
         inline_enum_str += 'return XR_ERROR_VALIDATION_FAILURE;\n'
         int_indent = int_indent - 1
@@ -1298,7 +1287,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                 inline_flag_str += 'if (VALIDATE_XR_FLAGS_ZERO == %s) {\n' % result_name
                 int_indent = int_indent + 1
                 inline_flag_str += self.writeIndent(int_indent)
-                inline_flag_str += 'CoreValidLogMessage(%s, "VUID-%s-%s-requiredbitmask",\n' % (instance_info_string,
+                inline_flag_str += 'GenValidUsageReport(%s, "VUID-%s-%s-requiredbitmask",\n' % (instance_info_string,
                                                                                                 cmd_struct_name,
                                                                                                 param_name)
                 inline_flag_str += self.writeIndent(int_indent)
@@ -1320,22 +1309,14 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
             inline_flag_str += self.writeIndent(int_indent)
             inline_flag_str += '// Otherwise, flags must be valid.\n'
             inline_flag_str += self.writeIndent(int_indent)
-            inline_flag_str += 'std::ostringstream oss_enum;\n'
-            inline_flag_str += self.writeIndent(int_indent)
-            inline_flag_str += f'oss_enum << "{error_prefix} {param_type} \\"{param_name}\\" flag value ";\n'
+            inline_flag_str += 'GenValidUsageReportValue(%s, "VUID-%s-%s-parameter", %s, objects_info,\n' % (instance_info_string,
+                                                                                                           cmd_struct_name,
+                                                                                                           param_name,
+                                                                                                           cmd_name_param)
             inline_flag_str += self.writeIndent(int_indent)
-            inline_flag_str += 'oss_enum << Uint64ToHexString(static_cast<uint64_t>(%s%s));\n' % (pointer_string,
-                                                                                                  full_param_name)
-            inline_flag_str += self.writeIndent(int_indent)
-            inline_flag_str += 'oss_enum <<" contains illegal bit";\n'
-            inline_flag_str += self.writeIndent(int_indent)
-            inline_flag_str += 'CoreValidLogMessage(%s, "VUID-%s-%s-parameter",\n' % (instance_info_string,
-                                                                                      cmd_struct_name,
-                                                                                      param_name)
-            inline_flag_str += self.writeIndent(int_indent)
-            inline_flag_str += f'                    VALID_USAGE_DEBUG_SEVERITY_ERROR, {cmd_name_param},\n'
+            inline_flag_str += f'                         "{error_prefix} {param_type} \\"{param_name}\\" flag value ",\n'
             inline_flag_str += self.writeIndent(int_indent)
-            inline_flag_str += '                    objects_info, oss_enum.str());\n'
+            inline_flag_str += f'                         static_cast<uint64_t>({pointer_string}{full_param_name}), " contains illegal bit");\n'
             inline_flag_str += self.writeIndent(int_indent)
             inline_flag_str += 'return XR_ERROR_VALIDATION_FAILURE;\n'
             int_indent = int_indent - 1
@@ -1349,7 +1330,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
             inline_flag_str += 'if (VALIDATE_XR_FLAGS_ZERO != %s) {\n' % result_name
             int_indent = int_indent + 1
             inline_flag_str += self.writeIndent(int_indent)
-            inline_flag_str += 'CoreValidLogMessage(%s, "VUID-%s-%s-zerobitmask",\n' % (instance_info_string,
+            inline_flag_str += 'GenValidUsageReport(%s, "VUID-%s-%s-zerobitmask",\n' % (instance_info_string,
                                                                                         cmd_struct_name,
                                                                                         param_name)
             inline_flag_str += self.writeIndent(int_indent)
@@ -1416,7 +1397,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                 indent -= 1
                 inline_validate_handle += '// Exception for xrGetRecommendedLayerResolutionMETA, the swapchain image handle can be NULL.\n'
                 inline_validate_handle += self.writeIndent(indent)
-                inline_validate_handle += 'if (command_name == "xrGetRecommendedLayerResolutionMETA" && handle_result == VALIDATE_XR_HANDLE_NULL)\n'
+                inline_validate_handle += 'if (strcmp(command_name, "xrGetRecommendedLayerResolutionMETA") == 0 && handle_result == VALIDATE_XR_HANDLE_NULL)\n'
                 inline_validate_handle += self.writeIndent(indent + 1)
                 inline_validate_handle += 'return xr_result;\n'
                 inline_validate_handle += self.writeIndent(indent)
@@ -1431,19 +1412,14 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                 inline_validate_handle += self.writeIndent(indent)
                 inline_validate_handle += '// Not a valid handle or NULL (which is not valid in this case)\n'
             inline_validate_handle += self.writeIndent(indent)
-            inline_validate_handle += 'std::ostringstream oss;\n'
+            inline_validate_handle += 'GenValidUsageReportValue(%s, "VUID-%s-%s-parameter", %s, objects_info,\n' % (instance_info_name,
+                                                                                                                  vuid_name,
+                                                                                                                  member_param.name,
+                                                                                                                  cmd_name)
             inline_validate_handle += self.writeIndent(indent)
-            inline_validate_handle += f'oss << "Invalid {member_param.type} handle \\"{member_param.name}\\" ";\n'
+            inline_validate_handle += f'                         "Invalid {member_param.type} handle \\"{member_param.name}\\" ",\n'
             inline_validate_handle += self.writeIndent(indent)
-            inline_validate_handle += f'oss << HandleToHexString({mem_par_desc_name});\n'
-            inline_validate_handle += self.writeIndent(indent)
-            inline_validate_handle += 'CoreValidLogMessage(%s, "VUID-%s-%s-parameter",\n' % (instance_info_name,
-                                                                                             vuid_name,
-                                                                                             member_param.name)
-            inline_validate_handle += self.writeIndent(indent)
-            inline_validate_handle += f'                    VALID_USAGE_DEBUG_SEVERITY_ERROR, {cmd_name},\n'
-            inline_validate_handle += self.writeIndent(indent)
-            inline_validate_handle += '                    objects_info, oss.str());\n'
+            inline_validate_handle += f'                         MakeHandleGeneric({mem_par_desc_name}));\n'
             inline_validate_handle += self.writeIndent(indent)
             inline_validate_handle += 'return XR_ERROR_HANDLE_INVALID;\n'
             indent = indent - 1
@@ -1470,6 +1446,10 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
         prefixed_param_member_name = param_member_prefix
         prefixed_param_member_name += param_member.name
         pre_loop_prefixed_param_member_name = prefixed_param_member_name
+        # Tiered commands are told by their caller whether to walk their parameters' next chains
+        check_pnext_arg = ' true,'
+        if is_command and struct_command_name in VALID_USAGE_TIERED_COMMANDS:
+            check_pnext_arg = ' check_next_chains,'
         loop_param_name = 'value_'
         loop_param_name += param_member.name.lower()
         loop_param_name += '_inc'
@@ -1547,7 +1527,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                 param_member_contents += 'if (0 != %s && nullptr == %s%s) {\n' % (
                     prefixed_param_member_name, param_member_prefix, param_member.array_length_for)
                 param_member_contents += self.writeIndent(indent + 1)
-                param_member_contents += 'CoreValidLogMessage(%s, "VUID-%s-%s-parameter",\n' % (instance_info_variable,
+                param_member_contents += 'GenValidUsageReport(%s, "VUID-%s-%s-parameter",\n' % (instance_info_variable,
                                                                                                 struct_command_name,
                                                                                                 param_member.array_length_for)
                 param_member_contents += self.writeIndent(indent + 1)
@@ -1572,7 +1552,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                 param_member_contents += 'if (0 >= %s && nullptr != %s%s) {\n' % (
                     prefixed_param_member_name, param_member_prefix, param_member.array_length_for)
                 param_member_contents += self.writeIndent(indent + 1)
-                param_member_contents += 'CoreValidLogMessage(%s, "VUID-%s-%s-arraylength",\n' % (instance_info_variable,
+                param_member_contents += 'GenValidUsageReport(%s, "VUID-%s-%s-arraylength",\n' % (instance_info_variable,
                                                                                                   struct_command_name,
                                                                                                   param_member.name)
                 param_member_contents += self.writeIndent(indent + 1)
@@ -1645,31 +1625,9 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                 param_member_contents += f'if ({prefixed_param_member_name} == nullptr) {{\n'
 
                 indent += 1
-                param_member_contents += self.writeIndent(indent)
-                param_member_contents += 'std::string error_message = "'
-                if is_command:
-                    param_member_contents += f'Command {struct_command_name} param {param_member.name}";\n'
-                else:
-                    param_member_contents += f'Structure {struct_command_name} member {param_member.name}";\n'
-                if is_array:
-                    param_member_contents += self.writeIndent(indent)
-                    param_member_contents += 'error_message += "[";\n'
-                    param_member_contents += self.writeIndent(indent)
-                    param_member_contents += f'error_message += std::to_string({loop_param_name});\n'
-                    param_member_contents += self.writeIndent(indent)
-                    param_member_contents += 'error_message += "]";\n'
-                param_member_contents += self.writeIndent(indent)
-                param_member_contents += 'error_message += " is null";\n'
-
-                param_member_contents += self.writeIndent(indent)
-                param_member_contents += 'CoreValidLogMessage(%s, "VUID-%s-%s-parameter",\n' % (
-                    instance_info_variable, struct_command_name, param_member.name)
-                param_member_contents += self.writeIndent(indent)
-                param_member_contents += f'                    VALID_USAGE_DEBUG_SEVERITY_ERROR, {command_name_variable},\n'
-                param_member_contents += self.writeIndent(indent)
-                param_member_contents += '                    objects_info,\n'
-                param_member_contents += self.writeIndent(indent)
-                param_member_contents += '                    error_message);\n'
+                param_member_contents += self.writeReportMember(instance_info_variable, struct_command_name,
+                                                                command_name_variable, param_member, is_command,
+                                                                loop_param_name if is_array else None, ' is null', indent)
                 # Sometimes there is a preferred, more specific error here, but we do not know it in general.
                 param_member_contents += self.writeIndent(indent)
                 param_member_contents += 'return XR_ERROR_VALIDATION_FAILURE;\n'
@@ -1738,7 +1696,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                             param_member_contents += ' false,'
                         else:
                             param_member_contents += ' check_members,'
-                        param_member_contents += ' true,'
+                        param_member_contents += check_pnext_arg
                         if is_array:
                             if is_pointer:
                                 param_member_contents += f' new_{base_child_struct_name}_value[{loop_param_name}]);\n'
@@ -1756,7 +1714,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                             param_member_contents += 'false,'
                         else:
                             param_member_contents += ' check_members,'
-                        param_member_contents += ' true,'
+                        param_member_contents += check_pnext_arg
                         if is_array:
                             param_member_contents += f' new_{base_child_struct_name}_value[{loop_param_name}]);\n'
                         else:
@@ -1764,31 +1722,10 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                     param_member_contents += self.writeIndent(indent)
                     param_member_contents += 'if (XR_SUCCESS != xr_result) {\n'
                     indent = indent + 1
-                    param_member_contents += self.writeIndent(indent)
-                    param_member_contents += 'std::string error_message = "'
-                    if is_command:
-                        param_member_contents += f'Command {struct_command_name} param {param_member.name}";\n'
-                    else:
-                        param_member_contents += f'Structure {struct_command_name} member {param_member.name}";\n'
-                    if is_array:
-                        param_member_contents += self.writeIndent(indent)
-                        param_member_contents += 'error_message += "[";\n'
-                        param_member_contents += self.writeIndent(indent)
-                        param_member_contents += f'error_message += std::to_string({loop_param_name});\n'
-                        param_member_contents += self.writeIndent(indent)
-                        param_member_contents += 'error_message += "]";\n'
-                    param_member_contents += self.writeIndent(indent)
-                    param_member_contents += 'error_message += " is invalid";\n'
-
-                    param_member_contents += self.writeIndent(indent)
-                    param_member_contents += 'CoreValidLogMessage(%s, "VUID-%s-%s-parameter",\n' % (
-                        instance_info_variable, struct_command_name, param_member.name)
-                    param_member_contents += self.writeIndent(indent)
-                    param_member_contents += f'                    VALID_USAGE_DEBUG_SEVERITY_ERROR, {command_name_variable},\n'
-                    param_member_contents += self.writeIndent(indent)
-                    param_member_contents += '                    objects_info,\n'
-                    param_member_contents += self.writeIndent(indent)
-                    param_member_contents += '                    error_message);\n'
+                    param_member_contents += self.writeReportMember(instance_info_variable, struct_command_name,
+                                                                    command_name_variable, param_member, is_command,
+                                                                    loop_param_name if is_array else None, ' is invalid',
+                                                                    indent)
                     param_member_contents += self.writeIndent(indent)
                     param_member_contents += 'return XR_ERROR_VALIDATION_FAILURE;\n'
                     if is_array:
@@ -1822,6 +1759,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
 
                     if child_struct and child_struct.protect_value:
                         param_member_contents += f'#endif // {child_struct.protect_string}\n'
+            memoize_create_info = is_command and self.isMemoizableCreateInfo(struct_command_name, param_member)
             param_member_contents += self.writeIndent(indent)
             if is_relation_group:
                 param_member_contents += f'// Validate that the base-structure {param_member.type} is valid\n'
@@ -1841,9 +1779,19 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                         param_member_contents += ' false,'
                     else:
                         param_member_contents += ' check_members,'
-                    param_member_contents += ' true,'
+                    param_member_contents += check_pnext_arg
                     param_member_contents += f' {prefixed_param_member_name});\n'
                 else:
+                    if memoize_create_info:
+                        param_member_contents += 'GenValidUsageCreateInfoKey create_info_key;\n'
+                        param_member_contents += self.writeIndent(indent)
+                        param_member_contents += 'const bool memoize_create_info = '
+                        param_member_contents += f'GenValidUsageMakeCreateInfoKey({prefixed_param_member_name}, create_info_key);\n'
+                        param_member_contents += self.writeIndent(indent)
+                        param_member_contents += 'if (!memoize_create_info || '
+                        param_member_contents += f'!{instance_info_variable}->validated_create_infos.contains(create_info_key)) {{\n'
+                        indent = indent + 1
+                        param_member_contents += self.writeIndent(indent)
                     param_member_contents += 'xr_result = ValidateXrStruct(%s, %s, objects_info,\n' % (
                         instance_info_variable, command_name_variable)
                     param_member_contents += self.writeIndent(indent)
@@ -1855,7 +1803,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                             param_member_contents += 'false,'
                     else:
                         param_member_contents += ' check_members,'
-                    param_member_contents += ' true,'
+                    param_member_contents += check_pnext_arg
                     param_member_contents += f' {prefixed_param_member_name});\n'
             else:
                 param_member_contents += 'xr_result = ValidateXrStruct(%s, %s, objects_info,\n' % (
@@ -1866,13 +1814,13 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                     param_member_contents += 'true,'
                 else:
                     param_member_contents += ' check_members,'
-                param_member_contents += ' true,'
+                param_member_contents += check_pnext_arg
                 param_member_contents += f' &{prefixed_param_member_name});\n'
             param_member_contents += self.writeIndent(indent)
             param_member_contents += 'if (XR_SUCCESS != xr_result) {\n'
             indent = indent + 1
             param_member_contents += self.writeIndent(indent)
-            param_member_contents += 'CoreValidLogMessage(%s, "VUID-%s-%s-parameter",\n' % (
+            param_member_contents += 'GenValidUsageReport(%s, "VUID-%s-%s-parameter",\n' % (
                 instance_info_variable, struct_command_name, param_member.name)
             param_member_contents += self.writeIndent(indent)
             param_member_contents += f'                    VALID_USAGE_DEBUG_SEVERITY_ERROR, {command_name_variable},\n'
@@ -1894,6 +1842,16 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                 indent = indent - 1
             param_member_contents += self.writeIndent(indent)
             param_member_contents += '}\n'
+            if memoize_create_info:
+                param_member_contents += self.writeIndent(indent)
+                param_member_contents += 'if (memoize_create_info) {\n'
+                param_member_contents += self.writeIndent(indent + 1)
+                param_member_contents += f'{instance_info_variable}->validated_create_infos.insert(create_info_key);\n'
+                param_member_contents += self.writeIndent(indent)
+                param_member_contents += '}\n'
+                indent = indent - 1
+                param_member_contents += self.writeIndent(indent)
+                param_member_contents += '}\n'
         elif self.isEnumType(param_member.type):
             if is_array and not param_member.is_const:
                 param_member_contents += self.writeIndent(indent)
@@ -1935,7 +1893,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                     param_member.static_array_sizes[0], prefixed_param_member_name)
                 indent = indent + 1
                 param_member_contents += self.writeIndent(indent)
-                param_member_contents += 'CoreValidLogMessage(%s, "VUID-%s-%s-parameter",\n' % (
+                param_member_contents += 'GenValidUsageReport(%s, "VUID-%s-%s-parameter",\n' % (
                     instance_info_variable, struct_command_name, param_member.name)
                 param_member_contents += self.writeIndent(indent)
                 param_member_contents += f'                    VALID_USAGE_DEBUG_SEVERITY_ERROR, {command_name_variable},\n'
@@ -1984,8 +1942,8 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
 
             if xr_struct.protect_value:
                 struct_check += f'#if {xr_struct.protect_string}\n'
-            struct_check += 'XrResult ValidateXrStruct(GenValidUsageXrInstanceInfo *instance_info, const std::string &command_name,\n'
-            struct_check += '                          std::vector<GenValidUsageXrObjectInfo>& objects_info, bool check_members, bool check_pnext,\n'
+            struct_check += 'XrResult ValidateXrStruct(GenValidUsageXrInstanceInfo *instance_info, const char *command_name,\n'
+            struct_check += '                          GenValidUsageObjectList& objects_info, bool check_members, bool check_pnext,\n'
             struct_check += '                          const %s* value) {\n' % xr_struct.name
             setup_bail = False
             struct_check += '    XrResult xr_result = XR_SUCCESS;\n'
@@ -2026,17 +1984,15 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                         struct_check += 'if (nullptr != instance_info && !ExtensionEnabled(instance_info->enabled_extensions, "%s")) {\n' % child_struct.ext_name
                         indent += 1
                         struct_check += self.writeIndent(indent)
-                        struct_check += f'std::string error_str = "{xr_struct.name} being used with child struct type ";\n'
+                        struct_check += f'GenValidUsageReport(instance_info, "VUID-{xr_struct.name}-type-type",\n'
                         struct_check += self.writeIndent(indent)
-                        struct_check += f'error_str += "\\"{self.genXrStructureType(child)}\\"";\n'
+                        struct_check += '                    VALID_USAGE_DEBUG_SEVERITY_ERROR, command_name, objects_info,\n'
                         struct_check += self.writeIndent(indent)
-                        struct_check += f'error_str += " which requires extension \\"{child_struct.ext_name}\\" to be enabled, but it is not enabled";\n'
+                        struct_check += f'                    "{xr_struct.name} being used with child struct type "\n'
                         struct_check += self.writeIndent(indent)
-                        struct_check += f'CoreValidLogMessage(instance_info, "VUID-{xr_struct.name}-type-type",\n'
+                        struct_check += f'                    "\\"{self.genXrStructureType(child)}\\""\n'
                         struct_check += self.writeIndent(indent)
-                        struct_check += '                    VALID_USAGE_DEBUG_SEVERITY_ERROR, command_name,\n'
-                        struct_check += self.writeIndent(indent)
-                        struct_check += '                    objects_info, error_str);\n'
+                        struct_check += f'                    " which requires extension \\"{child_struct.ext_name}\\" to be enabled, but it is not enabled");\n'
                         struct_check += self.writeIndent(indent)
                         struct_check += 'return XR_ERROR_VALIDATION_FAILURE;\n'
                         indent -= 1
@@ -2211,34 +2167,21 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
             parent_check_string += '                    %s,  MakeHandleGeneric(%s%s), %s)) {\n' % (
                 self.genXrObjectType(cur_handle_mem_param.type), pointer_deref, cur_handle_desc_name, compare_flag)
         indent = indent + 1
-        parent_check_string += self.writeIndent(indent)
-        parent_check_string += 'std::ostringstream oss_error;\n'
-        parent_check_string += self.writeIndent(indent)
-        parent_check_string += 'oss_error << "%s " << HandleToHexString(%s);\n' % (
-            first_handle_mem_param.type, first_handle_desc_name)
         if first_handle_tuple.name == cur_handle_tuple.parent:
-            parent_check_string += self.writeIndent(indent)
-            parent_check_string += f'oss_error << " must be a parent to {cur_handle_mem_param.type} ";\n'
-            parent_check_string += self.writeIndent(indent)
-            parent_check_string += f'oss_error << HandleToHexString({cur_handle_desc_name});\n'
+            relation = f' must be a parent to {cur_handle_mem_param.type} '
+            suffix = ''
         elif cur_handle_tuple.name == first_handle_tuple.parent:
-            parent_check_string += self.writeIndent(indent)
-            parent_check_string += f'oss_error << " must be a child of {cur_handle_mem_param.type} ";\n'
-            parent_check_string += self.writeIndent(indent)
-            parent_check_string += f'oss_error << HandleToHexString({cur_handle_desc_name});\n'
+            relation = f' must be a child of {cur_handle_mem_param.type} '
+            suffix = ''
         else:
-            parent_check_string += self.writeIndent(indent)
-            parent_check_string += f'oss_error <<  " and {cur_handle_mem_param.type} ";\n'
-            parent_check_string += self.writeIndent(indent)
-            parent_check_string += f'oss_error << HandleToHexString({cur_handle_desc_name});\n'
-            parent_check_string += self.writeIndent(indent)
-            parent_check_string += 'oss_error <<  " must share a parent";\n'
+            relation = f' and {cur_handle_mem_param.type} '
+            suffix = ' must share a parent'
         parent_check_string += self.writeIndent(indent)
-        parent_check_string += f'CoreValidLogMessage({instance_info_string}, "VUID-{vuid_name}-{parent_id}",\n'
+        parent_check_string += f'GenValidUsageReportHandlePair({instance_info_string}, "VUID-{vuid_name}-{parent_id}", {cmd_name_param},\n'
         parent_check_string += self.writeIndent(indent)
-        parent_check_string += f'                    VALID_USAGE_DEBUG_SEVERITY_ERROR, {cmd_name_param},\n'
+        parent_check_string += f'                              objects_info, "{first_handle_mem_param.type} ", MakeHandleGeneric({first_handle_desc_name}),\n'
         parent_check_string += self.writeIndent(indent)
-        parent_check_string += '                    objects_info, oss_error.str());\n'
+        parent_check_string += f'                              "{relation}", MakeHandleGeneric({pointer_deref}{cur_handle_desc_name}), "{suffix}");\n'
         parent_check_string += self.writeIndent(indent)
         parent_check_string += 'return XR_ERROR_VALIDATION_FAILURE;\n'
         indent = indent - 1
@@ -2255,6 +2198,9 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
         pre_validate_func += f"XrResult {cur_command.name.replace('xr', 'GenValidUsageInputsXr')}("
         pre_validate_func += '\n'
         pre_validate_func += ',\n'.join((param.cdecl.strip() for param in cur_command.params))
+        if cur_command.name in VALID_USAGE_TIERED_COMMANDS:
+            # Structural validation of a tiered command does not walk its parameters' next chains
+            pre_validate_func += ',\nbool check_next_chains'
         pre_validate_func += ') {\n'
         wrote_handle_check_proto = False
 
@@ -2269,7 +2215,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
         pre_validate_func += self.writeIndent(indent)
         pre_validate_func += 'XrResult xr_result = XR_SUCCESS;\n'
         pre_validate_func += self.writeIndent(indent)
-        pre_validate_func += 'std::vector<GenValidUsageXrObjectInfo> objects_info;\n'
+        pre_validate_func += 'GenValidUsageObjectList objects_info;\n'
         first_param = cur_command.params[0]
         first_param_tuple = self.getHandle(first_param.type)
         if first_param_tuple is not None:
@@ -2376,9 +2322,9 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                     pre_validate_func += 'if (!%s_valid->%s) {\n' % (
                         undecorate(cur_state.type), cur_state.variable)
                     pre_validate_func += self.writeIndent(3)
-                    pre_validate_func += f'std::string error_msg = "{cur_command.name} is required to be called between successful calls to ";\n'
+                    pre_validate_func += f'const char *error_msg = "{cur_command.name} is required to be called between successful calls to "\n'
                     pre_validate_func += self.writeIndent(3)
-                    pre_validate_func += 'error_msg += "'
+                    pre_validate_func += '                        "'
                     cur_count = 0
                     for begin_command in cur_state.begin_commands:
                         if cur_count > 0:
@@ -2394,7 +2340,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                         pre_validate_func += f'{end_command}'
                     pre_validate_func += ' commands";\n'
                     pre_validate_func += self.writeIndent(3)
-                    pre_validate_func += 'CoreValidLogMessage(%s, "VUID-%s-%s-checkstate",\n' % (
+                    pre_validate_func += 'GenValidUsageReport(%s, "VUID-%s-%s-checkstate",\n' % (
                         instance_info_variable, cur_command.name, cur_state.state)
                     pre_validate_func += self.writeIndent(3)
                     pre_validate_func += f'                    VALID_USAGE_DEBUG_SEVERITY_ERROR, "{cur_command.name}", objects_info,\n'
@@ -2421,9 +2367,9 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                     pre_validate_func += 'if (%s_valid->%s) {\n' % (
                         undecorate(cur_state.type), cur_state.variable)
                     pre_validate_func += self.writeIndent(3)
-                    pre_validate_func += f'std::string error_msg = "{cur_command.name} is called again without first successfully calling ";\n'
+                    pre_validate_func += f'const char *error_msg = "{cur_command.name} is called again without first successfully calling "\n'
                     pre_validate_func += self.writeIndent(3)
-                    pre_validate_func += 'error_msg += "'
+                    pre_validate_func += '                        "'
                     cur_count = 0
                     for end_command in cur_state.end_commands:
                         if cur_count > 0:
@@ -2432,7 +2378,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                         pre_validate_func += f'{end_command}'
                     pre_validate_func += '";\n'
                     pre_validate_func += self.writeIndent(3)
-                    pre_validate_func += 'CoreValidLogMessage(%s, "VUID-%s-%s-beginstate",\n' % (
+                    pre_validate_func += 'GenValidUsageReport(%s, "VUID-%s-%s-beginstate",\n' % (
                         instance_info_variable, cur_command.name, cur_state.state)
                     pre_validate_func += self.writeIndent(3)
                     pre_validate_func += f'                    VALID_USAGE_DEBUG_SEVERITY_ERROR, "{cur_command.name}", objects_info,\n'
@@ -2464,9 +2410,9 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                     pre_validate_func += 'if (!%s_valid->%s) {\n' % (
                         undecorate(cur_state.type), cur_state.variable)
                     pre_validate_func += self.writeIndent(3)
-                    pre_validate_func += f'std::string error_msg = "{cur_command.name} is called again without first successfully calling ";\n'
+                    pre_validate_func += f'const char *error_msg = "{cur_command.name} is called again without first successfully calling "\n'
                     pre_validate_func += self.writeIndent(3)
-                    pre_validate_func += 'error_msg += "'
+                    pre_validate_func += '                        "'
                     cur_count = 0
                     for begin_command in cur_state.begin_commands:
                         if cur_count > 0:
@@ -2475,7 +2421,7 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                         pre_validate_func += f'{begin_command}'
                     pre_validate_func += '";\n'
                     pre_validate_func += self.writeIndent(3)
-                    pre_validate_func += 'CoreValidLogMessage(%s, "VUID-%s-%s-endstate",\n' % (
+                    pre_validate_func += 'GenValidUsageReport(%s, "VUID-%s-%s-endstate",\n' % (
                         instance_info_variable, cur_command.name, cur_state.state)
                     pre_validate_func += self.writeIndent(3)
                     pre_validate_func += f'                    VALID_USAGE_DEBUG_SEVERITY_ERROR, "{cur_command.name}", objects_info,\n'
@@ -2550,18 +2496,18 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                 next_validate_func += '        GenValidUsageXrInstanceInfo *gen_instance_info = info_with_instance.second;\n'
         else:
             next_validate_func += '#error("Bug")\n'
+        if is_destroy and not self.wrap_handles:
+            # Deferred validation of calls using the handle has to be done while it is still valid.
+            next_validate_func += '        g_deferred_validation.flush();\n'
+        call_arguments, uses_scratch = self.genNextCallArguments(cur_command)
+        if uses_scratch:
+            next_validate_func += '        GenValidUsageUnwrapScratch unwrap_scratch;\n'
         # Call down, looking for the returned result if required.
         next_validate_func += '        '
         if has_return:
             next_validate_func += 'result = '
         next_validate_func += f'gen_instance_info->dispatch_table->{cur_command.name[2:]}('
-
-        count = 0
-        for param in cur_command.params:
-            if count > 0:
-                next_validate_func += ', '
-            next_validate_func += param.name
-            count = count + 1
+        next_validate_func += ', '.join(call_arguments)
         next_validate_func += ');\n'
 
         # If this is a create command, we have to create an entry in the appropriate
@@ -2583,7 +2529,10 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                 next_validate_func += '            handle_info->direct_parent_type = %s;\n' % self.genXrObjectType(
                     first_param.type)
                 next_validate_func += f'            handle_info->direct_parent_handle = MakeHandleGeneric({first_param.name});\n'
-                next_validate_func += f'            {self.makeInfoName(last_handle_tuple)}.insert(*{last_handle_name}, std::move(handle_info));\n'
+                if self.wrap_handles:
+                    next_validate_func += f'            *{last_handle_name} = {self.makeInfoName(last_handle_tuple)}.wrap(*{last_handle_name}, std::move(handle_info));\n'
+                else:
+                    next_validate_func += f'            {self.makeInfoName(last_handle_tuple)}.insert(*{last_handle_name}, std::move(handle_info));\n'
 
                 # If this object contains a state that needs tracking, allocate it
                 valid_type_list = []
@@ -2640,6 +2589,9 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                 if 'xrDestroyInstance' in cur_command.name:
                     next_validate_func += '        GenValidUsageCleanUpMaps(gen_instance_info);\n'
 
+        if has_return:
+            next_validate_func += self.genNextRewrapOutputs(cur_command, last_param if is_create else None)
+
         # Catch any exceptions that may have occurred.  If any occurred between any of the
         # valid mutex lock/unlock statements, perform the unlock now.  Notice that a create can
         # also allocate items, so we want to special case catching the failure of the allocation.
@@ -2665,6 +2617,8 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
         prototype = cur_command.cdecl.replace(" xr", " GenValidUsageXr")
         prototype = prototype.replace(";", " {")
         auto_validate_func += f'{prototype}\n'
+        if cur_command.name in VALID_USAGE_TIERED_COMMANDS:
+            return auto_validate_func + self.genTieredValidateBody(cur_command)
         auto_validate_func += self.writeIndent(1)
         if has_return:
             auto_validate_func += f'{cur_command.return_type.text} test_result = '
@@ -2699,6 +2653,787 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
         auto_validate_func += '}\n\n'
         return auto_validate_func
 
+    # Determine whether a command's create-info parameter only has to be validated once for each distinct
+    # contents.  That holds for input structures without any pointer or handle besides their next chain,
+    # whose validity depends on nothing but their bytes and the instance's enabled extensions.
+    #   self            the ValidationSourceOutputGenerator object
+    #   command_name    the name of the command
+    #   param           the parameter of the command
+    def isMemoizableCreateInfo(self, command_name, param):
+        if (not command_name.startswith('xrCreate') or not param.is_const or param.is_optional or
+                param.is_array or param.pointer_count != 1):
+            return False
+        if self.getRelationGroupForBaseStruct(param.type) is not None:
+            return False
+
+        def is_plain(type_name, typed):
+            cur_struct = self.getStruct(type_name)
+            if cur_struct is None or cur_struct.returned_only:
+                return False
+            for member in cur_struct.members:
+                if typed and member.name in ('type', 'next'):
+                    continue
+                if member.is_handle or member.pointer_count > 0:
+                    return False
+                if self.isStruct(member.type) and (member.is_static_array or not is_plain(member.type, False)):
+                    return False
+            return True
+
+        return self.isStruct(param.type) and self.isTypedStruct(self.getStruct(param.type)) and is_plain(param.type, True)
+
+    # Generate the statements writing each member of a memoizable structure into its create-info key.
+    # Members of contained structures are written one by one as well, so no padding byte is ever copied.
+    #   self            the ValidationSourceOutputGenerator object
+    #   type_name       the name of the structure type
+    #   prefix          the expression naming the members of the structure, such as 'value->'
+    #   typed           whether the structure starts with type and next, which the key does not hold
+    def genCreateInfoKeyWrites(self, type_name, prefix, typed):
+        writes = ''
+        for member in self.getStruct(type_name).members:
+            if typed and member.name in ('type', 'next'):
+                continue
+            if self.isStruct(member.type):
+                writes += self.genCreateInfoKeyWrites(member.type, f'{prefix}{member.name}.', False)
+            else:
+                writes += self.writeIndent(1)
+                writes += f'key.write(value, {prefix}{member.name});\n'
+        return writes
+
+    # Generate the functions that build the memoization key of each create-info structure a command
+    # validates only once for each distinct contents.
+    #   self            the ValidationSourceOutputGenerator object
+    def outputCreateInfoKeyFuncs(self):
+        key_funcs = '// Memoization keys of the create-info structures that are validated once for each distinct contents\n'
+        seen_types = set()
+        for cur_cmd in self.core_commands + self.ext_commands:
+            for param in cur_cmd.params:
+                if param.type in seen_types or not self.isMemoizableCreateInfo(cur_cmd.name, param):
+                    continue
+                seen_types.add(param.type)
+                cur_struct = self.getStruct(param.type)
+                if cur_struct.protect_value:
+                    key_funcs += f'#if {cur_struct.protect_string}\n'
+                key_funcs += f'static bool GenValidUsageMakeCreateInfoKey(const {param.type} *value, '
+                key_funcs += 'GenValidUsageCreateInfoKey &key) {\n'
+                key_funcs += self.writeIndent(1)
+                key_funcs += f'if (nullptr != value->next || !key.reset(value->type, sizeof({param.type}))) {{\n'
+                key_funcs += self.writeIndent(2)
+                key_funcs += 'return false;\n'
+                key_funcs += self.writeIndent(1)
+                key_funcs += '}\n'
+                key_funcs += self.genCreateInfoKeyWrites(param.type, 'value->', True)
+                key_funcs += self.writeIndent(1)
+                key_funcs += 'key.finish();\n'
+                key_funcs += self.writeIndent(1)
+                key_funcs += 'return true;\n'
+                key_funcs += '}\n'
+                if cur_struct.protect_value:
+                    key_funcs += f'#endif // {cur_struct.protect_string}\n'
+                key_funcs += '\n'
+        return key_funcs
+
+    # Generate the body of the validation function of a tiered command, which validates each call
+    # as deeply as the command's tier asks for.
+    #   self            the ValidationSourceOutputGenerator object
+    #   cur_command     the tiered command
+    def genTieredValidateBody(self, cur_command):
+        param_names = ', '.join(param.name for param in cur_command.params)
+        body = self.writeIndent(1)
+        body += f'GenValidUsageCallDepth depth = {self.makeTierName(cur_command.name)}.nextCallDepth();\n'
+        if not self.wrap_handles:
+            body += self.writeIndent(1)
+            body += 'if (VALID_USAGE_CALL_DEPTH_SKIP != depth && g_deferred_validation.enabled()) {\n'
+            body += self.writeIndent(2)
+            body += f"{cur_command.name.replace('xr', 'GenValidUsageDeferXr')}({param_names}, VALID_USAGE_CALL_DEPTH_FULL == depth);\n"
+            body += self.writeIndent(1)
+            body += '} else if (VALID_USAGE_CALL_DEPTH_SKIP != depth) {\n'
+        else:
+            body += self.writeIndent(1)
+            body += 'if (VALID_USAGE_CALL_DEPTH_SKIP != depth) {\n'
+        body += self.writeIndent(2)
+        body += f"XrResult test_result = {cur_command.name.replace('xr', 'GenValidUsageInputsXr')}("
+        body += f'{param_names}, VALID_USAGE_CALL_DEPTH_FULL == depth);\n'
+        body += self.writeIndent(2)
+        body += 'if (XR_SUCCESS != test_result) {\n'
+        body += self.writeIndent(3)
+        body += 'return test_result;\n'
+        body += self.writeIndent(2)
+        body += '}\n'
+        body += self.writeIndent(1)
+        body += '}\n'
+        body += self.writeIndent(1)
+        body += f"return {cur_command.name.replace('xr', 'GenValidUsageNextXr')}({param_names});\n"
+        body += '}\n\n'
+        return body
+
+    # Name of the validation tier state of a tiered command, e.g. g_end_frame_tier for xrEndFrame.
+    #   self            the ValidationSourceOutputGenerator object
+    #   command_name    the name of the tiered command
+    def makeTierName(self, command_name):
+        return 'g_%s_tier' % re.sub(r'(?<!^)([A-Z])', r'_\1', command_name[2:]).lower()
+
+    # Generate the validation tier state of every tiered command and the function applying the
+    # tier settings to them.
+    #   self            the ValidationSourceOutputGenerator object
+    def outputCommandTiers(self):
+        command_names = [cur_cmd.name for cur_cmd in self.core_commands + self.ext_commands
+                         if cur_cmd.name in VALID_USAGE_TIERED_COMMANDS]
+        tiers = '// Validation tiers of the per-frame commands\n'
+        for command_name in command_names:
+            tiers += 'static GenValidUsageCommandTier %s("%s", %s);\n' % (
+                self.makeTierName(command_name), command_name, VALID_USAGE_TIERED_COMMANDS[command_name])
+        tiers += '\nvoid GenValidUsageApplyTierSettings(const GenValidUsageTierSettings &settings) {\n'
+        for command_name in command_names:
+            tiers += f'    {self.makeTierName(command_name)}.apply(settings);\n'
+        tiers += '}\n\n'
+        return tiers
+
+    # Work out which structures carry handles that the handle-wrapping mode has to translate.
+    # The results are cached because both the helper functions and every next function use them.
+    #   self            the ValidationSourceOutputGenerator object
+    def computeWrappedHandleStructs(self):
+        if self.wrap_struct_info is not None:
+            return self.wrap_struct_info
+        structs = {cur_struct.name: cur_struct for cur_struct in self.api_structures}
+        group_children = {}
+        for name in structs:
+            relation_group = self.getRelationGroupForBaseStruct(name)
+            if relation_group is not None:
+                group_children[name] = [child for child in relation_group.child_struct_names if child in structs]
+
+        def struct_type(member):
+            type_name = self.resolve_type_name_alias(member.type)
+            return type_name if type_name in structs else None
+
+        def has_member(cur_struct, member_name):
+            return any(member.name == member_name for member in cur_struct.members)
+
+        def is_wrapped_handle(member):
+            handle = self.getHandle(member.type) if member.is_handle else None
+            return handle is not None and handle.name != 'XrInstance'
+
+        def in_set(type_name, struct_set):
+            if type_name in struct_set:
+                return True
+            return any(child in struct_set for child in group_children.get(type_name, []))
+
+        # Input direction: handles the next layer has to be given its own values for.
+        unwrap_set = set()
+        changed = True
+        while changed:
+            changed = False
+            for cur_struct in structs.values():
+                if cur_struct.name in unwrap_set or cur_struct.returned_only:
+                    continue
+                for member in cur_struct.members:
+                    nested = struct_type(member)
+                    if (is_wrapped_handle(member) or
+                            (member.name == 'objectHandle' and has_member(cur_struct, 'objectType')) or
+                            (nested is not None and in_set(nested, unwrap_set))):
+                        unwrap_set.add(cur_struct.name)
+                        changed = True
+                        break
+
+        # Output direction: handles written by the next layer that have to be wrapped, in the structures
+        # that can be written by it at all.
+        output_structs = set()
+        pending = [cur_struct.name for cur_struct in structs.values() if cur_struct.returned_only]
+        for cur_command in self.core_commands + self.ext_commands:
+            for param in cur_command.params:
+                type_name = self.resolve_type_name_alias(param.type)
+                if type_name in structs and not param.is_const and param.pointer_count > 0:
+                    pending.append(type_name)
+        while pending:
+            type_name = pending.pop()
+            if type_name in output_structs:
+                continue
+            output_structs.add(type_name)
+            pending.extend(group_children.get(type_name, []))
+            for member in structs[type_name].members:
+                if member.is_const:
+                    continue
+                if member.name == 'next':
+                    pending.extend(self.resolve_type_name_alias(name) for name in member.valid_extension_structs or []
+                                   if self.resolve_type_name_alias(name) in structs)
+                elif struct_type(member) is not None:
+                    pending.append(struct_type(member))
+        rewrap_set = set()
+        changed = True
+        while changed:
+            changed = False
+            for cur_struct in structs.values():
+                if cur_struct.name in rewrap_set or cur_struct.name not in output_structs:
+                    continue
+                for member in cur_struct.members:
+                    if member.is_const:
+                        continue
+                    nested = struct_type(member)
+                    if ((is_wrapped_handle(member) and member.pointer_count <= 1) or
+                            (nested is not None and member.name != 'next' and in_set(nested, rewrap_set))):
+                        rewrap_set.add(cur_struct.name)
+                        changed = True
+                        break
+
+        self.wrap_struct_info = (structs, group_children, unwrap_set, rewrap_set)
+        return self.wrap_struct_info
+
+    # Is a structure one that starts with an XrStructureType type member?
+    #   self            the ValidationSourceOutputGenerator object
+    #   cur_struct      the StructUnionData to check
+    def isTypedStruct(self, cur_struct):
+        return len(cur_struct.members) > 1 and cur_struct.members[0].name == 'type' and \
+            cur_struct.members[0].type == 'XrStructureType'
+
+    # Write the body of GenValidUsageUnwrapMembers for one structure.
+    #   self            the ValidationSourceOutputGenerator object
+    #   cur_struct      the StructUnionData to unwrap the members of
+    def genUnwrapMembers(self, cur_struct):
+        structs, group_children, unwrap_set, _ = self.computeWrappedHandleStructs()
+        member_names = [member.name for member in cur_struct.members]
+        body = ''
+        for member in cur_struct.members:
+            value = f'value->{member.name}'
+            cast_prefix = '' if member.is_const else f'const_cast<{member.type} *>('
+            cast_suffix = '' if member.is_const else ')'
+            if member.name == 'next':
+                if member.is_const:
+                    body += f'    {value} = GenValidUsageUnwrapNextChain({value}, scratch);\n'
+                else:
+                    body += f'    {value} = const_cast<void *>(GenValidUsageUnwrapNextChain({value}, scratch));\n'
+                continue
+            if member.name == 'objectHandle' and 'objectType' in member_names:
+                body += f'    {value} = UnwrapXrObjectHandle(value->objectType, {value});\n'
+                continue
+            if member.is_static_array:
+                continue
+            count = member.pointer_count_var or None
+            if count is not None and count not in member_names:
+                continue
+            if member.is_handle:
+                handle = self.getHandle(member.type)
+                if handle is None or handle.name == 'XrInstance':
+                    continue
+                if member.pointer_count == 0:
+                    body += f'    {value} = UnwrapXrHandle({value});\n'
+                elif member.pointer_count == 1 and count is not None:
+                    body += f'    {value} = UnwrapXrHandleArray({value}, value->{count}, scratch);\n'
+                continue
+            type_name = self.resolve_type_name_alias(member.type)
+            if type_name not in structs:
+                continue
+            if type_name not in unwrap_set and not any(child in unwrap_set for child in group_children.get(type_name, [])):
+                continue
+            nested = structs[type_name]
+            if member.pointer_count == 0:
+                if type_name in unwrap_set:
+                    body += f'    GenValidUsageUnwrapMembers(&{value}, scratch);\n'
+            elif member.pointer_count == 1 and count is None:
+                if self.isTypedStruct(nested):
+                    body += f'    {value} = {cast_prefix}static_cast<const {member.type} *>(GenValidUsageUnwrapNextChain({value}, scratch)){cast_suffix};\n'
+                elif type_name in unwrap_set:
+                    body += f'    {value} = {cast_prefix}GenValidUsageUnwrapArray({value}, 1, scratch){cast_suffix};\n'
+            elif member.pointer_count == 1:
+                if type_name in unwrap_set:
+                    body += f'    {value} = {cast_prefix}GenValidUsageUnwrapArray({value}, value->{count}, scratch){cast_suffix};\n'
+            elif member.pointer_count == 2 and count is not None and self.isTypedStruct(nested):
+                body += f'    if ({value} != nullptr && value->{count} != 0) {{\n'
+                body += f'        auto *unwrapped = static_cast<const {member.type} **>(scratch.allocate(sizeof(const {member.type} *) * value->{count}));\n'
+                body += f'        for (uint32_t i = 0; i < value->{count}; ++i) {{\n'
+                body += f'            unwrapped[i] = static_cast<const {member.type} *>(GenValidUsageUnwrapNextChain({value}[i], scratch));\n'
+                body += '        }\n'
+                body += f'        {value} = unwrapped;\n'
+                body += '    }\n'
+        return body
+
+    # Write the body of GenValidUsageRewrapMembers for one structure.
+    #   self            the ValidationSourceOutputGenerator object
+    #   cur_struct      the StructUnionData to rewrap the members of
+    def genRewrapMembers(self, cur_struct):
+        structs, group_children, _, rewrap_set = self.computeWrappedHandleStructs()
+        member_names = [member.name for member in cur_struct.members]
+        body = ''
+        for member in cur_struct.members:
+            if member.is_const or member.is_static_array:
+                continue
+            value = f'value->{member.name}'
+            if member.name == 'next':
+                body += f'    GenValidUsageRewrapNextChain({value}, context);\n'
+                continue
+            count = member.pointer_count_var or None
+            if count is not None:
+                if count not in member_names:
+                    continue
+                # For two-call idiom arrays only the elements the next layer wrote are handles.
+                count_output = count.replace('CapacityInput', 'CountOutput')
+                if count.endswith('CapacityInput') and count_output in member_names:
+                    count = f'(std::min)(value->{count}, value->{count_output})'
+                else:
+                    count = f'value->{count}'
+            if member.is_handle:
+                handle = self.getHandle(member.type)
+                if handle is None or handle.name == 'XrInstance':
+                    continue
+                wrap_call = f'{self.makeInfoName(handle)}.wrapReturned(%s, context.instance_info, context.parent_type, context.parent_handle)'
+                if member.pointer_count == 0:
+                    body += f'    {value} = {wrap_call % value};\n'
+                elif member.pointer_count == 1 and count is not None:
+                    body += f'    if ({value} != nullptr) {{\n'
+                    body += f'        for (uint32_t i = 0; i < {count}; ++i) {{\n'
+                    body += f'            {value}[i] = {wrap_call % (value + "[i]")};\n'
+                    body += '        }\n'
+                    body += '    }\n'
+                continue
+            type_name = self.resolve_type_name_alias(member.type)
+            if type_name not in structs:
+                continue
+            if type_name not in rewrap_set and not any(child in rewrap_set for child in group_children.get(type_name, [])):
+                continue
+            nested = structs[type_name]
+            if member.pointer_count == 0:
+                if type_name in rewrap_set:
+                    body += f'    GenValidUsageRewrapMembers(&{value}, context);\n'
+            elif member.pointer_count == 1 and count is None:
+                if self.isTypedStruct(nested):
+                    body += f'    GenValidUsageRewrapNextChain({value}, context);\n'
+                elif type_name in rewrap_set:
+                    body += f'    if ({value} != nullptr) {{\n'
+                    body += f'        GenValidUsageRewrapMembers({value}, context);\n'
+                    body += '    }\n'
+            elif member.pointer_count == 1 and type_name in rewrap_set:
+                body += f'    if ({value} != nullptr) {{\n'
+                body += f'        for (uint32_t i = 0; i < {count}; ++i) {{\n'
+                body += f'            GenValidUsageRewrapMembers(&{value}[i], context);\n'
+                body += '        }\n'
+                body += '    }\n'
+        return body
+
+    # Generate the functions the handle-wrapping mode uses to translate handles inside structures.
+    #   self            the ValidationSourceOutputGenerator object
+    def outputHandleWrappingFuncs(self):
+        structs, _, unwrap_set, rewrap_set = self.computeWrappedHandleStructs()
+        ordered = [cur_struct for cur_struct in self.api_structures]
+
+        def protect_begin(cur_struct):
+            return f'#if {cur_struct.protect_string}\n' if cur_struct.protect_value else ''
+
+        def protect_end(cur_struct):
+            return f'#endif // {cur_struct.protect_string}\n' if cur_struct.protect_value else ''
+
+        funcs = '// Handle wrapping: copies of input structures with the next layer\'s handles, and wrapping of\n'
+        funcs += '// the handles in output structures.\n'
+        funcs += 'const void *GenValidUsageUnwrapNextChain(const void *next, GenValidUsageUnwrapScratch &scratch);\n'
+        funcs += 'void GenValidUsageRewrapNextChain(void *next, const GenValidUsageRewrapContext &context);\n'
+        for cur_struct in ordered:
+            if cur_struct.name not in unwrap_set and cur_struct.name not in rewrap_set:
+                continue
+            funcs += protect_begin(cur_struct)
+            if cur_struct.name in unwrap_set:
+                funcs += f'void GenValidUsageUnwrapMembers({cur_struct.name} *value, GenValidUsageUnwrapScratch &scratch);\n'
+            if cur_struct.name in rewrap_set:
+                funcs += f'void GenValidUsageRewrapMembers({cur_struct.name} *value, const GenValidUsageRewrapContext &context);\n'
+            funcs += protect_end(cur_struct)
+        funcs += '\n'
+        funcs += '// Copy an array of structures and unwrap the handles in each element.\n'
+        funcs += 'template <typename T>\n'
+        funcs += 'T *GenValidUsageUnwrapArray(const T *values, uint32_t count, GenValidUsageUnwrapScratch &scratch) {\n'
+        funcs += '    if (values == nullptr || count == 0) {\n'
+        funcs += '        return const_cast<T *>(values);\n'
+        funcs += '    }\n'
+        funcs += '    T *copy = scratch.copy(values, count);\n'
+        funcs += '    for (uint32_t i = 0; i < count; ++i) {\n'
+        funcs += '        GenValidUsageUnwrapMembers(&copy[i], scratch);\n'
+        funcs += '    }\n'
+        funcs += '    return copy;\n'
+        funcs += '}\n\n'
+
+        funcs += 'const void *GenValidUsageUnwrapNextChain(const void *next, GenValidUsageUnwrapScratch &scratch) {\n'
+        funcs += '    if (next == nullptr) {\n'
+        funcs += '        return nullptr;\n'
+        funcs += '    }\n'
+        funcs += '    const auto *link = static_cast<const XrBaseInStructure *>(next);\n'
+        funcs += '    switch (link->type) {\n'
+        seen_types = set()
+        for cur_struct in ordered:
+            if cur_struct.name not in unwrap_set or not self.isTypedStruct(cur_struct) or not cur_struct.members[0].values:
+                continue
+            type_value = cur_struct.members[0].values
+            if type_value in seen_types:
+                continue
+            seen_types.add(type_value)
+            funcs += protect_begin(cur_struct)
+            funcs += f'        case {type_value}:\n'
+            funcs += f'            return GenValidUsageUnwrapArray(reinterpret_cast<const {cur_struct.name} *>(link), 1, scratch);\n'
+            funcs += protect_end(cur_struct)
+        funcs += '        default:\n'
+        funcs += '            break;\n'
+        funcs += '    }\n'
+        funcs += '    // No handles in this structure; copy it only if something further down the chain changed.\n'
+        funcs += '    const void *rest = GenValidUsageUnwrapNextChain(link->next, scratch);\n'
+        funcs += '    const size_t size = GenValidUsageStructureSize(link->type);\n'
+        funcs += '    if (rest == link->next || size == 0) {\n'
+        funcs += '        return link;\n'
+        funcs += '    }\n'
+        funcs += '    auto *copy = static_cast<XrBaseInStructure *>(scratch.allocate(size));\n'
+        funcs += '    memcpy(copy, link, size);\n'
+        funcs += '    copy->next = static_cast<const XrBaseInStructure *>(rest);\n'
+        funcs += '    return copy;\n'
+        funcs += '}\n\n'
+
+        funcs += 'void GenValidUsageRewrapNextChain(void *next, const GenValidUsageRewrapContext &context) {\n'
+        funcs += '    auto *link = static_cast<XrBaseOutStructure *>(next);\n'
+        funcs += '    while (link != nullptr) {\n'
+        funcs += '        switch (link->type) {\n'
+        seen_types = set()
+        for cur_struct in ordered:
+            if cur_struct.name not in rewrap_set or not self.isTypedStruct(cur_struct) or not cur_struct.members[0].values:
+                continue
+            type_value = cur_struct.members[0].values
+            if type_value in seen_types:
+                continue
+            seen_types.add(type_value)
+            funcs += protect_begin(cur_struct)
+            funcs += f'            case {type_value}:\n'
+            funcs += '                // Continues along the rest of the chain itself.\n'
+            funcs += f'                GenValidUsageRewrapMembers(reinterpret_cast<{cur_struct.name} *>(link), context);\n'
+            funcs += '                return;\n'
+            funcs += protect_end(cur_struct)
+        funcs += '            default:\n'
+        funcs += '                break;\n'
+        funcs += '        }\n'
+        funcs += '        link = link->next;\n'
+        funcs += '    }\n'
+        funcs += '}\n\n'
+
+        for cur_struct in ordered:
+            if cur_struct.name not in unwrap_set and cur_struct.name not in rewrap_set:
+                continue
+            funcs += protect_begin(cur_struct)
+            if cur_struct.name in unwrap_set:
+                funcs += f'void GenValidUsageUnwrapMembers({cur_struct.name} *value, GenValidUsageUnwrapScratch &scratch) {{\n'
+                funcs += self.genUnwrapMembers(cur_struct)
+                funcs += '}\n'
+            if cur_struct.name in rewrap_set:
+                funcs += f'void GenValidUsageRewrapMembers({cur_struct.name} *value, const GenValidUsageRewrapContext &context) {{\n'
+                funcs += self.genRewrapMembers(cur_struct)
+                funcs += '}\n'
+            funcs += protect_end(cur_struct)
+        funcs += '\n'
+        return funcs
+
+    # Generate the function giving the size of each structure by its XrStructureType, which lets a
+    # structure be copied without knowing its type at compile time.
+    #   self            the ValidationSourceOutputGenerator object
+    def outputStructureSizeFunc(self):
+        func = 'size_t GenValidUsageStructureSize(XrStructureType type) {\n'
+        func += '    switch (type) {\n'
+        seen_types = set()
+        for cur_struct in self.api_structures:
+            if not self.isTypedStruct(cur_struct) or not cur_struct.members[0].values:
+                continue
+            type_value = cur_struct.members[0].values
+            if type_value in seen_types:
+                continue
+            seen_types.add(type_value)
+            if cur_struct.protect_value:
+                func += f'#if {cur_struct.protect_string}\n'
+            func += f'        case {type_value}:\n'
+            func += f'            return sizeof({cur_struct.name});\n'
+            if cur_struct.protect_value:
+                func += f'#endif // {cur_struct.protect_string}\n'
+        func += '        default:\n'
+        func += '            return 0;\n'
+        func += '    }\n'
+        func += '}\n\n'
+        return func
+
+    # Work out which structures hold pointers, directly or in structures they contain, and so need more
+    # than a memcpy to be copied deeply.  The result is cached.
+    #   self            the ValidationSourceOutputGenerator object
+    def computeDeepCopyStructs(self):
+        if self.deep_copy_structs is not None:
+            return self.deep_copy_structs
+        structs = {cur_struct.name: cur_struct for cur_struct in self.api_structures}
+        deep_set = set()
+        changed = True
+        while changed:
+            changed = False
+            for cur_struct in structs.values():
+                if cur_struct.name in deep_set:
+                    continue
+                for member in cur_struct.members:
+                    type_name = self.resolve_type_name_alias(member.type)
+                    if member.pointer_count > 0 or (type_name in deep_set and not member.is_static_array):
+                        deep_set.add(cur_struct.name)
+                        changed = True
+                        break
+        self.deep_copy_structs = (structs, deep_set)
+        return self.deep_copy_structs
+
+    # Write the statement replacing one pointer member or parameter with a deep copy of what it points
+    # to, or an empty string if it is kept as it is.
+    #   self            the ValidationSourceOutputGenerator object
+    #   member          the MemberOrParam to copy
+    #   value           the expression naming the member or parameter
+    #   count           the expression giving its element count, or None if it is not an array
+    #   indent          the indentation of the statement
+    def genDeepCopyStatement(self, member, value, count, indent):
+        structs, deep_set = self.computeDeepCopyStructs()
+        type_name = self.resolve_type_name_alias(member.type)
+        nested = structs.get(type_name)
+        prefix = self.writeIndent(indent)
+        if member.pointer_count == 0:
+            if type_name in deep_set and not member.is_static_array:
+                return f'{prefix}GenValidUsageDeepCopyMembers(&{value}, scratch);\n'
+            return ''
+        if member.type == 'void' or member.type.startswith('PFN_'):
+            # Opaque data and functions are never looked at by the validation.
+            return ''
+        if type_name not in structs and not member.type.startswith('Xr') and member.type not in VALID_USAGE_DEEP_COPY_C_TYPES:
+            return ''
+        if member.pointer_count == 1:
+            if member.type == 'char' and member.is_null_terminated:
+                return f'{prefix}{value} = scratch.copyString({value});\n'
+            if nested is not None and self.isTypedStruct(nested):
+                if count is not None and self.getRelationGroupForBaseStruct(type_name) is not None:
+                    # The elements are of a type derived from the base structure, whose size is not known here.
+                    return ''
+                if count is None:
+                    return f'{prefix}{value} = static_cast<{member.type} *>(GenValidUsageDeepCopyNextChain({value}, scratch));\n'
+            if count is None:
+                count = '1'
+            if type_name in deep_set:
+                return f'{prefix}{value} = GenValidUsageDeepCopyStructArray({value}, {count}, scratch);\n'
+            return f'{prefix}{value} = GenValidUsageDeepCopyArray({value}, {count}, scratch);\n'
+        if member.pointer_count == 2 and count is not None:
+            element = f'const {member.type} *' if member.is_const else f'{member.type} *'
+            if member.type == 'char':
+                copy_element = 'scratch.copyString(%s)'
+            elif nested is not None and self.isTypedStruct(nested):
+                copy_element = f'static_cast<{element}>(GenValidUsageDeepCopyNextChain(%s, scratch))'
+            else:
+                return ''
+            statement = f'{prefix}if ({value} != nullptr && {count} != 0) {{\n'
+            statement += f'{prefix}    auto **copy = static_cast<{element}*>(scratch.allocate(sizeof({element}) * {count}));\n'
+            statement += f'{prefix}    for (size_t i = 0; i < static_cast<size_t>({count}); ++i) {{\n'
+            statement += f'{prefix}        copy[i] = {copy_element % (value + "[i]")};\n'
+            statement += f'{prefix}    }}\n'
+            statement += f'{prefix}    {value} = copy;\n'
+            statement += f'{prefix}}}\n'
+            return statement
+        return ''
+
+    # Generate the functions making deep copies of structures and their next chains, which deferred
+    # validation checks instead of the application's memory.
+    #   self            the ValidationSourceOutputGenerator object
+    def outputDeepCopyFuncs(self):
+        structs, deep_set = self.computeDeepCopyStructs()
+        ordered = [cur_struct for cur_struct in self.api_structures
+                   if cur_struct.name in deep_set and cur_struct.name not in LOADER_STRUCTS]
+
+        def protect_begin(cur_struct):
+            return f'#if {cur_struct.protect_string}\n' if cur_struct.protect_value else ''
+
+        def protect_end(cur_struct):
+            return f'#endif // {cur_struct.protect_string}\n' if cur_struct.protect_value else ''
+
+        funcs = '// Deferred validation: deep copies of the inputs of a call.\n'
+        funcs += 'void *GenValidUsageDeepCopyNextChain(const void *next, GenValidUsageUnwrapScratch &scratch);\n'
+        for cur_struct in ordered:
+            funcs += protect_begin(cur_struct)
+            funcs += f'void GenValidUsageDeepCopyMembers({cur_struct.name} *value, GenValidUsageUnwrapScratch &scratch);\n'
+            funcs += protect_end(cur_struct)
+        funcs += '\n'
+        funcs += '// Copy an array of values that hold no pointers.\n'
+        funcs += 'template <typename T>\n'
+        funcs += 'T *GenValidUsageDeepCopyArray(const T *values, size_t count, GenValidUsageUnwrapScratch &scratch) {\n'
+        funcs += '    if (values == nullptr || count == 0) {\n'
+        funcs += '        return const_cast<T *>(values);\n'
+        funcs += '    }\n'
+        funcs += '    return scratch.copy(values, count);\n'
+        funcs += '}\n\n'
+        funcs += '// Copy an array of structures and everything their members point to.\n'
+        funcs += 'template <typename T>\n'
+        funcs += 'T *GenValidUsageDeepCopyStructArray(const T *values, size_t count, GenValidUsageUnwrapScratch &scratch) {\n'
+        funcs += '    if (values == nullptr || count == 0) {\n'
+        funcs += '        return const_cast<T *>(values);\n'
+        funcs += '    }\n'
+        funcs += '    T *copy = scratch.copy(values, count);\n'
+        funcs += '    for (size_t i = 0; i < count; ++i) {\n'
+        funcs += '        GenValidUsageDeepCopyMembers(&copy[i], scratch);\n'
+        funcs += '    }\n'
+        funcs += '    return copy;\n'
+        funcs += '}\n\n'
+
+        funcs += 'void *GenValidUsageDeepCopyNextChain(const void *next, GenValidUsageUnwrapScratch &scratch) {\n'
+        funcs += '    if (next == nullptr) {\n'
+        funcs += '        return nullptr;\n'
+        funcs += '    }\n'
+        funcs += '    const auto *link = static_cast<const XrBaseInStructure *>(next);\n'
+        funcs += '    size_t size = GenValidUsageStructureSize(link->type);\n'
+        funcs += '    if (size == 0) {\n'
+        funcs += '        // Of a structure the layer does not know, only the header is ever looked at.\n'
+        funcs += '        size = sizeof(XrBaseInStructure);\n'
+        funcs += '    }\n'
+        funcs += '    auto *copy = static_cast<XrBaseInStructure *>(scratch.allocate(size));\n'
+        funcs += '    memcpy(copy, link, size);\n'
+        funcs += '    switch (copy->type) {\n'
+        seen_types = set()
+        for cur_struct in ordered:
+            if not self.isTypedStruct(cur_struct) or not cur_struct.members[0].values:
+                continue
+            type_value = cur_struct.members[0].values
+            if type_value in seen_types:
+                continue
+            seen_types.add(type_value)
+            funcs += protect_begin(cur_struct)
+            funcs += f'        case {type_value}:\n'
+            funcs += '            // Copies the rest of the chain itself.\n'
+            funcs += f'            GenValidUsageDeepCopyMembers(reinterpret_cast<{cur_struct.name} *>(copy), scratch);\n'
+            funcs += '            return copy;\n'
+            funcs += protect_end(cur_struct)
+        funcs += '        default:\n'
+        funcs += '            break;\n'
+        funcs += '    }\n'
+        funcs += '    copy->next = static_cast<const XrBaseInStructure *>(GenValidUsageDeepCopyNextChain(copy->next, scratch));\n'
+        funcs += '    return copy;\n'
+        funcs += '}\n\n'
+
+        for cur_struct in ordered:
+            member_names = [member.name for member in cur_struct.members]
+            funcs += protect_begin(cur_struct)
+            funcs += f'void GenValidUsageDeepCopyMembers({cur_struct.name} *value, GenValidUsageUnwrapScratch &scratch) {{\n'
+            for member in cur_struct.members:
+                value = f'value->{member.name}'
+                if member.name == 'next':
+                    if member.type == 'void':
+                        funcs += f'    {value} = GenValidUsageDeepCopyNextChain({value}, scratch);\n'
+                    else:
+                        next_type = f'const {member.type}' if member.is_const else member.type
+                        funcs += f'    {value} = static_cast<{next_type} *>(GenValidUsageDeepCopyNextChain({value}, scratch));\n'
+                    continue
+                count = member.pointer_count_var or None
+                if count is not None:
+                    if count not in member_names:
+                        continue
+                    count = f'value->{count}'
+                funcs += self.genDeepCopyStatement(member, value, count, 1)
+            funcs += '}\n'
+            funcs += protect_end(cur_struct)
+        funcs += '\n'
+        return funcs
+
+    # Generate the function deferring the validation of a call to a tiered command: it copies the call's
+    # inputs and queues their validation on the deferred validation thread.
+    #   self            the ValidationSourceOutputGenerator object
+    #   cur_command     the tiered command
+    def genDeferValidateFunc(self, cur_command):
+        param_names = [param.name for param in cur_command.params]
+        validate_name = cur_command.name.replace('xr', 'GenValidUsageInputsXr')
+        func = f"static void {cur_command.name.replace('xr', 'GenValidUsageDeferXr')}(\n"
+        func += ',\n'.join((param.cdecl.strip() for param in cur_command.params))
+        func += ',\nbool check_next_chains) {\n'
+        func += '    GenValidUsageDeferredCall *call = g_deferred_validation.reserve();\n'
+        func += '    if (call == nullptr) {\n'
+        func += f"        {validate_name}({', '.join(param_names)}, check_next_chains);\n"
+        func += '        return;\n'
+        func += '    }\n'
+        func += '    GenValidUsageUnwrapScratch &scratch = call->copies;\n'
+        for param in cur_command.params:
+            count = param.pointer_count_var or None
+            if count is not None and count not in param_names:
+                continue
+            func += self.genDeepCopyStatement(param, param.name, count, 1)
+        func += '    struct Arguments {\n'
+        for param in cur_command.params:
+            func += f'        {param.cdecl.strip()};\n'
+        func += '        bool check_next_chains;\n'
+        func += '    };\n'
+        func += '    call->arguments = new (scratch.allocate(sizeof(Arguments)))\n'
+        func += f"        Arguments{{{', '.join(param_names)}, check_next_chains}};\n"
+        func += '    call->validate = [](const void *arguments) {\n'
+        func += '        const Arguments &a = *static_cast<const Arguments *>(arguments);\n'
+        func += f"        {validate_name}({', '.join('a.' + name for name in param_names)}, a.check_next_chains);\n"
+        func += '    };\n'
+        func += '    g_deferred_validation.enqueue(call);\n'
+        func += '}\n\n'
+        return func
+
+    # Generate the arguments a next function passes down, unwrapping them in the handle-wrapping mode.
+    #   self            the ValidationSourceOutputGenerator object
+    #   cur_command     the command generated in automatic_source_generator.py
+    def genNextCallArguments(self, cur_command):
+        if not self.wrap_handles:
+            return [param.name for param in cur_command.params], False
+        structs, group_children, unwrap_set, _ = self.computeWrappedHandleStructs()
+        param_names = [param.name for param in cur_command.params]
+        arguments = []
+        uses_scratch = False
+        for param in cur_command.params:
+            argument = param.name
+            type_name = self.resolve_type_name_alias(param.type)
+            count = param.pointer_count_var or None
+            if param.is_handle:
+                handle = self.getHandle(param.type)
+                if handle is not None and handle.name != 'XrInstance':
+                    if param.pointer_count == 0:
+                        argument = f'UnwrapXrHandle({param.name})'
+                    elif param.is_const and param.pointer_count == 1 and count in param_names:
+                        argument = f'UnwrapXrHandleArray({param.name}, {count}, unwrap_scratch)'
+                        uses_scratch = True
+            elif param.is_const and param.pointer_count == 1 and type_name in structs:
+                cur_struct = structs[type_name]
+                if count is None and self.isTypedStruct(cur_struct):
+                    # Dispatch on the type actually given, which may be a child of the declared structure.
+                    argument = f'static_cast<const {param.type} *>(GenValidUsageUnwrapNextChain({param.name}, unwrap_scratch))'
+                    uses_scratch = True
+                elif type_name in unwrap_set:
+                    count = count or '1'
+                    if count == '1' or count in param_names:
+                        argument = f'GenValidUsageUnwrapArray({param.name}, {count}, unwrap_scratch)'
+                        uses_scratch = True
+            arguments.append(argument)
+        return arguments, uses_scratch
+
+    # Generate the code wrapping handles the next layer returned outside of a create.
+    #   self            the ValidationSourceOutputGenerator object
+    #   cur_command     the command generated in automatic_source_generator.py
+    #   skip_param      the created handle parameter, which is wrapped separately, or None
+    def genNextRewrapOutputs(self, cur_command, skip_param):
+        if not self.wrap_handles:
+            return ''
+        structs, _, _, rewrap_set = self.computeWrappedHandleStructs()
+        first_param = cur_command.params[0]
+        lines = []
+        for param in cur_command.params:
+            if param is skip_param or param.is_const or param.pointer_count != 1 or param.pointer_count_var:
+                continue
+            type_name = self.resolve_type_name_alias(param.type)
+            if param.is_handle:
+                handle = self.getHandle(param.type)
+                if handle is None or handle.name == 'XrInstance':
+                    continue
+                lines.append(f'            if (nullptr != {param.name}) {{')
+                lines.append(f'                *{param.name} = {self.makeInfoName(handle)}.wrapReturned(*{param.name}, gen_instance_info, {self.genXrObjectType(first_param.type)},')
+                lines.append(f'                    MakeHandleGeneric({first_param.name}));')
+                lines.append('            }')
+            elif type_name in structs:
+                cur_struct = structs[type_name]
+                if self.isTypedStruct(cur_struct):
+                    call = f'GenValidUsageRewrapNextChain({param.name}, context);'
+                elif type_name in rewrap_set:
+                    call = f'GenValidUsageRewrapMembers({param.name}, context);'
+                else:
+                    continue
+                lines.append(f'            if (nullptr != {param.name}) {{')
+                lines.append('                GenValidUsageRewrapContext context{gen_instance_info, %s, MakeHandleGeneric(%s)};' % (
+                    self.genXrObjectType(first_param.type), first_param.name))
+                lines.append(f'                {call}')
+                lines.append('            }')
+        if not lines:
+            return ''
+        # Only XR_SUCCESS: other success codes such as XR_EVENT_UNAVAILABLE leave the outputs untouched.
+        return '        if (XR_SUCCESS == result) {\n' + '\n'.join(lines) + '\n        }\n'
+
     # Implementation for generated validation commands
     #   self                the ValidationSourceOutputGenerator object
     def outputValidationSourceFuncs(self):
@@ -2765,8 +3500,15 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
         validation_source_funcs += self.writeVerifyExtensions()
         validation_source_funcs += self.writeValidateHandleChecks()
         validation_source_funcs += self.writeValidateHandleParent()
+        validation_source_funcs += self.outputStructureSizeFunc()
+        if self.wrap_handles:
+            validation_source_funcs += self.outputHandleWrappingFuncs()
+        else:
+            validation_source_funcs += self.outputDeepCopyFuncs()
         validation_source_funcs += self.writeValidateStructFuncs()
         validation_source_funcs += self.outputValidationSourceNextChainFunc()
+        validation_source_funcs += self.outputCommandTiers()
+        validation_source_funcs += self.outputCreateInfoKeyFuncs()
 
         cur_extension = CurrentExtensionTracker(self.conventions.api_version_prefix)
 
@@ -2807,6 +3549,8 @@ class ValidationSourceOutputGenerator(AutomaticSourceOutputGenerator):
                     has_return = True
 
                 validation_source_funcs += self.genValidateInputsFunc(cur_cmd)
+                if cur_cmd.name in VALID_USAGE_TIERED_COMMANDS and not self.wrap_handles:
+                    validation_source_funcs += self.genDeferValidateFunc(cur_cmd)
                 validation_source_funcs += self.genNextValidateFunc(
                     cur_cmd, has_return, is_create, is_destroy, is_sempath_query)
                 if cur_cmd.name not in VALID_USAGE_MANUALLY_DEFINED:
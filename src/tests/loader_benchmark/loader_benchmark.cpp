@@ -0,0 +1,568 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Micro-benchmarks for the loader, run against the in-tree test_runtime and XrApiLayer_test.
+//
+// Every benchmark name carries the XR_LOADER_DEBUG level it was run with.  The loader only reads
+// XR_LOADER_DEBUG once, so logger overhead is measured by running the executable once per level
+// (see the loader_benchmark_report target) and diffing the JSON files written by --benchmark-json.
+//
+
+#include "loader_benchmark_utils.hpp"
+#include "loader_test_utils.hpp"
+#include "test_runtime_swapchain.h"
+
+#include "xr_dependencies.h"
+#include <openxr/openxr.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/internal/catch_clara.hpp>  // for customizing arg parsing
+#include <catch2/reporters/catch_reporter_event_listener.hpp>
+#include <catch2/reporters/catch_reporter_registrars.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string g_loader_debug_level;
+std::string g_benchmark_json_file;
+
+std::string Name(const std::string& benchmark) {
+    return benchmark + " [XR_LOADER_DEBUG=" + (g_loader_debug_level.empty() ? "unset" : g_loader_debug_level) + "]";
+}
+
+struct BenchmarkResult {
+    std::string name;
+    double mean_ns;
+    double std_dev_ns;
+    double median_ns;
+    double min_ns;
+    unsigned int samples;
+    int iterations;
+};
+
+std::string JsonEscape(const std::string& in) {
+    std::string out;
+    out.reserve(in.size());
+    for (char c : in) {
+        switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(static_cast<unsigned char>(c)));
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+                break;
+        }
+    }
+    return out;
+}
+
+// Collects every benchmark result and writes them out as JSON when the run ends, since Catch2's own
+// JSON reporter does not record benchmark statistics.
+class BenchmarkJsonListener : public Catch::EventListenerBase {
+   public:
+    using Catch::EventListenerBase::EventListenerBase;
+
+    void benchmarkEnded(Catch::BenchmarkStats<> const& stats) override {
+        std::vector<double> samples;
+        samples.reserve(stats.samples.size());
+        for (const auto& sample : stats.samples) {
+            samples.push_back(sample.count());
+        }
+        std::sort(samples.begin(), samples.end());
+        BenchmarkResult result{};
+        result.name = stats.info.name;
+        result.mean_ns = stats.mean.point.count();
+        result.std_dev_ns = stats.standardDeviation.point.count();
+        result.median_ns = samples.empty() ? 0.0 : samples[samples.size() / 2];
+        result.min_ns = samples.empty() ? 0.0 : samples.front();
+        result.samples = stats.info.samples;
+        result.iterations = stats.info.iterations;
+        results_.push_back(std::move(result));
+    }
+
+    void testRunEnded(Catch::TestRunStats const&) override {
+        if (g_benchmark_json_file.empty()) {
+            return;
+        }
+        std::ofstream json(g_benchmark_json_file, std::ios::out | std::ios::trunc);
+        json << "{\n";
+        json << "    \"loader_debug\": \"" << JsonEscape(g_loader_debug_level) << "\",\n";
+        json << "    \"benchmarks\": [";
+        for (size_t i = 0; i < results_.size(); ++i) {
+            const auto& result = results_[i];
+            json << (i == 0 ? "\n" : ",\n");
+            json << "        {\"name\": \"" << JsonEscape(result.name) << "\", \"mean_ns\": " << result.mean_ns
+                 << ", \"std_dev_ns\": " << result.std_dev_ns << ", \"median_ns\": " << result.median_ns
+                 << ", \"min_ns\": " << result.min_ns << ", \"samples\": " << result.samples
+                 << ", \"iterations\": " << result.iterations << "}";
+        }
+        json << "\n    ]\n}\n";
+    }
+
+   private:
+    std::vector<BenchmarkResult> results_;
+};
+
+}  // namespace
+
+CATCH_REGISTER_LISTENER(BenchmarkJsonListener)
+
+TEST_CASE("InstanceLifetime", "[benchmark]") {
+    const std::vector<const char*> no_layers;
+    const std::vector<const char*> test_layer{"XR_APILAYER_test"};
+
+    // Cold: the loader opens and closes the runtime (and layer) library on every iteration.
+    REQUIRE(XR_SUCCESS == LoaderBenchmarkCreateDestroyInstance(no_layers));
+    BENCHMARK(Name("xrCreateInstance+xrDestroyInstance cold")) { return LoaderBenchmarkCreateDestroyInstance(no_layers); };
+    BENCHMARK(Name("xrCreateInstance+xrDestroyInstance cold, XR_APILAYER_test")) {
+        return LoaderBenchmarkCreateDestroyInstance(test_layer);
+    };
+
+    // Warm: libraries stay mapped, so only manifest parsing, negotiation and dispatch setup remain.
+    LoaderBenchmarkLibraryPin pin;
+    BENCHMARK(Name("xrCreateInstance+xrDestroyInstance warm")) { return LoaderBenchmarkCreateDestroyInstance(no_layers); };
+    BENCHMARK(Name("xrCreateInstance+xrDestroyInstance warm, XR_APILAYER_test")) {
+        return LoaderBenchmarkCreateDestroyInstance(test_layer);
+    };
+
+    // Failure path: the loader logs an error for the missing layer on every call.
+    const std::vector<const char*> missing_layer{"XR_APILAYER_BENCHMARK_missing"};
+    BENCHMARK(Name("xrCreateInstance missing layer")) { return LoaderBenchmarkCreateDestroyInstance(missing_layer); };
+}
+
+TEST_CASE("GetInstanceProcAddr", "[benchmark]") {
+    LoaderBenchmarkSession session({}, {XR_EXT_DEBUG_UTILS_EXTENSION_NAME});
+    REQUIRE(XR_SUCCESS == session.Result());
+
+    const char* const names[] = {
+        "xrGetInstanceProcAddr",
+        "xrCreateSession",
+        "xrLocateSpace",
+        "xrSyncActions",
+        "xrWaitFrame",
+        "xrLocateSpaces",
+        "xrSubmitDebugUtilsMessageEXT",
+        "xrNotARealFunction",
+    };
+    for (const char* name : names) {
+        BENCHMARK(Name(std::string("xrGetInstanceProcAddr(") + name + ")")) {
+            PFN_xrVoidFunction function = nullptr;
+            xrGetInstanceProcAddr(session.instance, name, &function);
+            return function;
+        };
+    }
+}
+
+TEST_CASE("Trampolines", "[benchmark]") {
+    LoaderBenchmarkLibraryPin pin;
+    REQUIRE(pin.RuntimeGetInstanceProcAddr() != nullptr);
+
+    auto run = [&](const char* stack, std::vector<std::string> layers) {
+        LoaderBenchmarkSession session(std::move(layers));
+        REQUIRE(XR_SUCCESS == session.Result());
+
+        PFN_xrLocateSpace runtime_locate_space = nullptr;
+        PFN_xrSyncActions runtime_sync_actions = nullptr;
+        PFN_xrWaitFrame runtime_wait_frame = nullptr;
+        auto runtime_gipa = pin.RuntimeGetInstanceProcAddr();
+        REQUIRE(XR_SUCCESS ==
+                runtime_gipa(session.instance, "xrLocateSpace", reinterpret_cast<PFN_xrVoidFunction*>(&runtime_locate_space)));
+        REQUIRE(XR_SUCCESS ==
+                runtime_gipa(session.instance, "xrSyncActions", reinterpret_cast<PFN_xrVoidFunction*>(&runtime_sync_actions)));
+        REQUIRE(XR_SUCCESS ==
+                runtime_gipa(session.instance, "xrWaitFrame", reinterpret_cast<PFN_xrVoidFunction*>(&runtime_wait_frame)));
+
+        XrSpaceLocation location{XR_TYPE_SPACE_LOCATION};
+        XrFrameState frame_state{XR_TYPE_FRAME_STATE};
+        XrActiveActionSet active_action_set{session.action_set, XR_NULL_PATH};
+        XrActionsSyncInfo sync_info{XR_TYPE_ACTIONS_SYNC_INFO};
+        sync_info.countActiveActionSets = 1;
+        sync_info.activeActionSets = &active_action_set;
+        const XrTime time = 1;
+
+        BENCHMARK(Name(std::string("xrLocateSpace runtime direct, ") + stack)) {
+            return runtime_locate_space(session.view_space, session.local_space, time, &location);
+        };
+        BENCHMARK(Name(std::string("xrLocateSpace trampoline, ") + stack)) {
+            return xrLocateSpace(session.view_space, session.local_space, time, &location);
+        };
+        BENCHMARK(Name(std::string("xrSyncActions runtime direct, ") + stack)) {
+            return runtime_sync_actions(session.session, &sync_info);
+        };
+        BENCHMARK(Name(std::string("xrSyncActions trampoline, ") + stack)) { return xrSyncActions(session.session, &sync_info); };
+        BENCHMARK(Name(std::string("xrWaitFrame runtime direct, ") + stack)) {
+            return runtime_wait_frame(session.session, nullptr, &frame_state);
+        };
+        BENCHMARK(Name(std::string("xrWaitFrame trampoline, ") + stack)) {
+            return xrWaitFrame(session.session, nullptr, &frame_state);
+        };
+    };
+
+    run("no layers", {});
+    run("XR_APILAYER_test", {"XR_APILAYER_test"});
+}
+
+// Cost of api_dump formatting one xrLocateViews call (a typical per-frame call with struct inputs and
+// a struct array output), written to a null device so that only the layer's own work is measured.
+TEST_CASE("ApiDump", "[benchmark]") {
+    LoaderBenchmarkLibraryPin pin;
+    LoaderTestSetEnvironmentVariable("XR_API_DUMP_FILE_NAME", "/dev/null");
+
+    auto run = [&](const char* export_type, const char* variant) {
+        LoaderTestSetEnvironmentVariable("XR_API_DUMP_EXPORT_TYPE", export_type);
+        LoaderBenchmarkSession session({"XR_APILAYER_LUNARG_api_dump"});
+        REQUIRE(XR_SUCCESS == session.Result());
+
+        XrViewLocateInfo locate_info{XR_TYPE_VIEW_LOCATE_INFO};
+        locate_info.viewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+        locate_info.displayTime = 1;
+        locate_info.space = session.local_space;
+        XrViewState view_state{XR_TYPE_VIEW_STATE};
+        XrView views[2] = {{XR_TYPE_VIEW}, {XR_TYPE_VIEW}};
+        uint32_t view_count = 0;
+
+        BENCHMARK(Name(std::string("xrLocateViews, XR_APILAYER_LUNARG_api_dump ") + export_type + variant)) {
+            return xrLocateViews(session.session, &locate_info, &view_state, 2, &view_count, views);
+        };
+    };
+
+    run("text", "");
+    run("binary", "");
+    // A command left out by the filter settings should cost next to nothing.
+    LoaderTestSetEnvironmentVariable("XR_API_DUMP_EXCLUDE", "xrLocateViews");
+    run("text", ", excluded");
+    LoaderTestUnsetEnvironmentVariable("XR_API_DUMP_EXCLUDE");
+    LoaderTestUnsetEnvironmentVariable("XR_API_DUMP_EXPORT_TYPE");
+    LoaderTestUnsetEnvironmentVariable("XR_API_DUMP_FILE_NAME");
+}
+
+// A frame of an application locating 16 spaces one at a time, with and without the space cache layer,
+// against the same frame done with a single xrLocateSpaces call.
+TEST_CASE("SpaceCache", "[benchmark]") {
+    LoaderBenchmarkLibraryPin pin;
+    constexpr uint32_t kSpaceCount = 16;
+
+    auto run = [&](const char* stack, std::vector<std::string> layers) {
+        const bool no_layers = layers.empty();
+        LoaderBenchmarkSession session(std::move(layers));
+        REQUIRE(XR_SUCCESS == session.Result());
+
+        std::vector<XrSpace> spaces(kSpaceCount, XR_NULL_HANDLE);
+        XrReferenceSpaceCreateInfo space_create_info{XR_TYPE_REFERENCE_SPACE_CREATE_INFO};
+        space_create_info.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL;
+        space_create_info.poseInReferenceSpace.orientation.w = 1.0f;
+        for (uint32_t i = 0; i < kSpaceCount; ++i) {
+            space_create_info.poseInReferenceSpace.position.x = static_cast<float>(i);
+            REQUIRE(XR_SUCCESS == xrCreateReferenceSpace(session.session, &space_create_info, &spaces[i]));
+        }
+
+        XrFrameState frame_state{XR_TYPE_FRAME_STATE};
+        std::vector<XrSpaceLocation> locations(kSpaceCount, {XR_TYPE_SPACE_LOCATION});
+        BENCHMARK(Name(std::string("xrWaitFrame + 16 xrLocateSpace, ") + stack)) {
+            xrWaitFrame(session.session, nullptr, &frame_state);
+            for (uint32_t i = 0; i < kSpaceCount; ++i) {
+                xrLocateSpace(spaces[i], session.local_space, frame_state.predictedDisplayTime, &locations[i]);
+            }
+            return locations[0].pose.position.x;
+        };
+        // Rendering code commonly locates the same spaces again later in the frame.
+        BENCHMARK(Name(std::string("xrWaitFrame + 2 x 16 xrLocateSpace, ") + stack)) {
+            xrWaitFrame(session.session, nullptr, &frame_state);
+            for (uint32_t pass = 0; pass < 2; ++pass) {
+                for (uint32_t i = 0; i < kSpaceCount; ++i) {
+                    xrLocateSpace(spaces[i], session.local_space, frame_state.predictedDisplayTime, &locations[i]);
+                }
+            }
+            return locations[0].pose.position.x;
+        };
+
+        if (no_layers) {
+            std::vector<XrSpaceLocationData> location_data(kSpaceCount);
+            XrSpacesLocateInfo locate_info{XR_TYPE_SPACES_LOCATE_INFO};
+            locate_info.baseSpace = session.local_space;
+            locate_info.spaceCount = kSpaceCount;
+            locate_info.spaces = spaces.data();
+            XrSpaceLocations space_locations{XR_TYPE_SPACE_LOCATIONS};
+            space_locations.locationCount = kSpaceCount;
+            space_locations.locations = location_data.data();
+            BENCHMARK(Name(std::string("xrWaitFrame + xrLocateSpaces of 16, ") + stack)) {
+                xrWaitFrame(session.session, nullptr, &frame_state);
+                locate_info.time = frame_state.predictedDisplayTime;
+                return xrLocateSpaces(session.session, &locate_info, &space_locations);
+            };
+        }
+    };
+
+    run("no layers", {});
+    run("XR_APILAYER_KHRONOS_space_cache", {"XR_APILAYER_KHRONOS_space_cache"});
+}
+
+// Action state queries between two syncs, with and without the action snapshot layer.
+TEST_CASE("ActionSnapshot", "[benchmark]") {
+    LoaderBenchmarkLibraryPin pin;
+
+    auto run = [&](const char* stack, std::vector<std::string> layers) {
+        LoaderBenchmarkSession session(std::move(layers));
+        REQUIRE(XR_SUCCESS == session.Result());
+
+        XrActiveActionSet active_action_set{session.action_set, XR_NULL_PATH};
+        XrActionsSyncInfo sync_info{XR_TYPE_ACTIONS_SYNC_INFO};
+        sync_info.countActiveActionSets = 1;
+        sync_info.activeActionSets = &active_action_set;
+        XrActionStateGetInfo get_info{XR_TYPE_ACTION_STATE_GET_INFO};
+        get_info.action = session.float_action;
+        XrActionStateFloat state{XR_TYPE_ACTION_STATE_FLOAT};
+
+        // Two syncs, so that the pair is in the snapshot.
+        for (int i = 0; i < 2; ++i) {
+            REQUIRE(XR_SUCCEEDED(xrSyncActions(session.session, &sync_info)));
+            REQUIRE(XR_SUCCESS == xrGetActionStateFloat(session.session, &get_info, &state));
+        }
+
+        BENCHMARK(Name(std::string("xrGetActionStateFloat, ") + stack)) {
+            return xrGetActionStateFloat(session.session, &get_info, &state);
+        };
+        BENCHMARK(Name(std::string("xrSyncActions + 8 xrGetActionStateFloat, ") + stack)) {
+            xrSyncActions(session.session, &sync_info);
+            for (int i = 0; i < 8; ++i) {
+                xrGetActionStateFloat(session.session, &get_info, &state);
+            }
+            return state.isActive;
+        };
+    };
+
+    run("no layers", {});
+    run("XR_APILAYER_KHRONOS_action_snapshot", {"XR_APILAYER_KHRONOS_action_snapshot"});
+}
+
+// A headless frame loop on test_runtime host memory swapchains, with and without clearing the image.
+TEST_CASE("CpuSwapchainFrameLoop", "[benchmark]") {
+    LoaderBenchmarkLibraryPin pin;
+    LoaderBenchmarkSession session({});
+    REQUIRE(XR_SUCCESS == session.Result());
+
+    XrSwapchainCreateInfo swapchain_ci{XR_TYPE_SWAPCHAIN_CREATE_INFO};
+    swapchain_ci.usageFlags = XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT;
+    swapchain_ci.format = XR_SWAPCHAIN_FORMAT_R8G8B8A8_SRGB_TEST;
+    swapchain_ci.sampleCount = 1;
+    swapchain_ci.width = 1024;
+    swapchain_ci.height = 1024;
+    swapchain_ci.faceCount = 1;
+    swapchain_ci.arraySize = 2;
+    swapchain_ci.mipCount = 1;
+    XrSwapchain swapchain = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateSwapchain(session.session, &swapchain_ci, &swapchain));
+
+    uint32_t image_count = 0;
+    REQUIRE(XR_SUCCESS == xrEnumerateSwapchainImages(swapchain, 0, &image_count, nullptr));
+    std::vector<XrSwapchainImageCpuTEST> images(image_count, {XR_TYPE_SWAPCHAIN_IMAGE_CPU_TEST});
+    REQUIRE(XR_SUCCESS == xrEnumerateSwapchainImages(swapchain, image_count, &image_count,
+                                                     reinterpret_cast<XrSwapchainImageBaseHeader*>(images.data())));
+
+    auto frame = [&](bool clear) {
+        XrFrameState frame_state{XR_TYPE_FRAME_STATE};
+        xrWaitFrame(session.session, nullptr, &frame_state);
+        xrBeginFrame(session.session, nullptr);
+        uint32_t index = 0;
+        xrAcquireSwapchainImage(swapchain, nullptr, &index);
+        XrSwapchainImageWaitInfo wait_info{XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO};
+        wait_info.timeout = XR_INFINITE_DURATION;
+        xrWaitSwapchainImage(swapchain, &wait_info);
+        if (clear) {
+            memset(images[index].data, 0, static_cast<size_t>(images[index].size));
+        }
+        xrReleaseSwapchainImage(swapchain, nullptr);
+        XrFrameEndInfo end_info{XR_TYPE_FRAME_END_INFO};
+        end_info.displayTime = frame_state.predictedDisplayTime;
+        end_info.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+        return xrEndFrame(session.session, &end_info);
+    };
+
+    BENCHMARK(Name("xrWaitFrame to xrEndFrame, one swapchain")) { return frame(false); };
+    BENCHMARK(Name("xrWaitFrame to xrEndFrame, one swapchain, 2 x 1024x1024 RGBA8 clear")) { return frame(true); };
+
+    REQUIRE(XR_SUCCESS == xrDestroySwapchain(swapchain));
+}
+
+// The same frame loop with test_runtime pacing xrWaitFrame to a 1000 Hz display: each iteration should
+// take one period, and anything above it is pacing overhead.
+TEST_CASE("PacedFrameLoop", "[benchmark]") {
+    LoaderBenchmarkLibraryPin pin;
+    LoaderTestSetEnvironmentVariable("XR_TEST_RUNTIME_REFRESH_RATE", "1000");
+    LoaderBenchmarkSession session({});
+    LoaderTestUnsetEnvironmentVariable("XR_TEST_RUNTIME_REFRESH_RATE");
+    REQUIRE(XR_SUCCESS == session.Result());
+
+    BENCHMARK(Name("xrWaitFrame to xrEndFrame, paced at 1000 Hz")) {
+        XrFrameState frame_state{XR_TYPE_FRAME_STATE};
+        xrWaitFrame(session.session, nullptr, &frame_state);
+        xrBeginFrame(session.session, nullptr);
+        XrFrameEndInfo end_info{XR_TYPE_FRAME_END_INFO};
+        end_info.displayTime = frame_state.predictedDisplayTime;
+        end_info.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+        return xrEndFrame(session.session, &end_info);
+    };
+}
+
+// Path interning in test_runtime with 10k paths, roughly what a binding-heavy application creates.
+TEST_CASE("PathInterning", "[benchmark]") {
+    LoaderBenchmarkLibraryPin pin;
+    LoaderBenchmarkSession session({});
+    REQUIRE(XR_SUCCESS == session.Result());
+
+    constexpr size_t path_count = 10000;
+    std::vector<std::string> strings;
+    strings.reserve(path_count);
+    for (size_t i = 0; i < path_count; ++i) {
+        strings.push_back("/benchmark/path_" + std::to_string(i / 100) + "/input/component_" + std::to_string(i % 100));
+    }
+
+    std::vector<XrPath> paths(path_count, XR_NULL_PATH);
+    for (size_t i = 0; i < path_count; ++i) {
+        REQUIRE(XR_SUCCESS == xrStringToPath(session.instance, strings[i].c_str(), &paths[i]));
+    }
+
+    char buffer[XR_MAX_PATH_LENGTH];
+    for (size_t i = 0; i < path_count; ++i) {
+        uint32_t count = 0;
+        REQUIRE(XR_SUCCESS == xrPathToString(session.instance, paths[i], XR_MAX_PATH_LENGTH, &count, buffer));
+        REQUIRE(strings[i] == buffer);
+    }
+
+    BENCHMARK(Name("xrStringToPath x 10000, existing paths")) {
+        XrPath path = XR_NULL_PATH;
+        for (const std::string& string : strings) {
+            xrStringToPath(session.instance, string.c_str(), &path);
+        }
+        return path;
+    };
+    BENCHMARK(Name("xrPathToString x 10000")) {
+        uint32_t count = 0;
+        for (XrPath path : paths) {
+            xrPathToString(session.instance, path, XR_MAX_PATH_LENGTH, &count, buffer);
+        }
+        return count;
+    };
+}
+
+// Locating spaces and views on a recorded trajectory of a million samples (about three hours at 100 Hz,
+// 176 MB), against the same calls with static poses.  Times step by a prime number of microseconds so
+// that successive calls land on different samples.
+TEST_CASE("TrajectoryPlayback", "[benchmark]") {
+    LoaderBenchmarkLibraryPin pin;
+    REQUIRE(LoaderTestWriteTrajectoryFile("benchmark_trajectory.bin", 1000000, 10000000));
+
+    XrViewLocateInfo view_locate_info{XR_TYPE_VIEW_LOCATE_INFO};
+    view_locate_info.viewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+    XrViewState view_state{XR_TYPE_VIEW_STATE};
+    XrView views[2] = {{XR_TYPE_VIEW}, {XR_TYPE_VIEW}};
+    XrSpaceVelocity velocity{XR_TYPE_SPACE_VELOCITY};
+    XrSpaceLocation location{XR_TYPE_SPACE_LOCATION, &velocity};
+
+    for (const char* file : {"", "benchmark_trajectory.bin"}) {
+        LoaderTestSetEnvironmentVariable("XR_TEST_RUNTIME_TRAJECTORY_FILE", file);
+        LoaderBenchmarkSession session({});
+        LoaderTestUnsetEnvironmentVariable("XR_TEST_RUNTIME_TRAJECTORY_FILE");
+        REQUIRE(XR_SUCCESS == session.Result());
+        const std::string suffix = file[0] == '\0' ? ", static" : ", trajectory";
+
+        XrTime time = 1;
+        BENCHMARK(Name("xrLocateSpace view in local" + suffix)) {
+            time += 7919000;
+            return xrLocateSpace(session.view_space, session.local_space, time, &location);
+        };
+        view_locate_info.space = session.local_space;
+        BENCHMARK(Name("xrLocateViews" + suffix)) {
+            time += 7919000;
+            view_locate_info.displayTime = time;
+            uint32_t view_count = 0;
+            return xrLocateViews(session.session, &view_locate_info, &view_state, 2, &view_count, views);
+        };
+    }
+
+    std::remove("benchmark_trajectory.bin");
+}
+
+TEST_CASE("ManifestDiscovery", "[benchmark]") {
+    for (uint32_t count : {1u, 100u, 1000u}) {
+        const std::string directory = "synthetic_manifests/" + std::to_string(count);
+        REQUIRE(LoaderBenchmarkWriteSyntheticManifests(directory, count));
+        LoaderBenchmarkSetApiLayerPath(directory);
+
+        uint32_t property_count = 0;
+        REQUIRE(XR_SUCCESS == xrEnumerateApiLayerProperties(0, &property_count, nullptr));
+        REQUIRE(property_count >= count);
+        std::vector<XrApiLayerProperties> properties(property_count, {XR_TYPE_API_LAYER_PROPERTIES});
+
+        BENCHMARK(Name("xrEnumerateApiLayerProperties count, " + std::to_string(count) + " manifests")) {
+            uint32_t output = 0;
+            xrEnumerateApiLayerProperties(0, &output, nullptr);
+            return output;
+        };
+        BENCHMARK(Name("xrEnumerateApiLayerProperties fill, " + std::to_string(count) + " manifests")) {
+            uint32_t output = 0;
+            xrEnumerateApiLayerProperties(property_count, &output, properties.data());
+            return output;
+        };
+    }
+    LoaderBenchmarkSetApiLayerPath({});
+}
+
+int main(int argc, char* argv[]) {
+    Catch::Session session;
+
+    using namespace Catch::Clara;
+    auto cli = session.cli() |
+               Opt(g_loader_debug_level, "level")["--loader-debug"]("value of XR_LOADER_DEBUG for this run (none, error, warn, "
+                                                                    "info, verbose); leave unset for the loader default") |
+               Opt(g_benchmark_json_file, "file")["--benchmark-json"]("write benchmark results to this JSON file");
+    session.cli(cli);
+
+    int result = session.applyCommandLine(argc, argv);
+    if (result != 0) {
+        return result;
+    }
+
+    LoaderBenchmarkConfigureEnvironment(g_loader_debug_level);
+
+    return session.run();
+}
@@ -0,0 +1,218 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "loader_benchmark_utils.hpp"
+#include "loader_test_utils.hpp"
+
+#include <openxr/openxr_loader_negotiation.h>
+
+#include <dlfcn.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+void LoaderBenchmarkConfigureEnvironment(const std::string& loader_debug_level) {
+    LoaderTestSetEnvironmentVariable("XR_RUNTIME_JSON", LOADER_BENCHMARK_RUNTIME_JSON);
+    LoaderBenchmarkSetApiLayerPath({});
+    if (loader_debug_level.empty()) {
+        LoaderTestUnsetEnvironmentVariable("XR_LOADER_DEBUG");
+    } else {
+        LoaderTestSetEnvironmentVariable("XR_LOADER_DEBUG", loader_debug_level);
+    }
+}
+
+std::string LoaderBenchmarkDefaultApiLayerPath() { return LOADER_BENCHMARK_LAYER_DIR; }
+
+void LoaderBenchmarkSetApiLayerPath(const std::string& path) {
+    LoaderTestSetEnvironmentVariable("XR_API_LAYER_PATH", path.empty() ? LoaderBenchmarkDefaultApiLayerPath() : path);
+}
+
+bool LoaderBenchmarkWriteSyntheticManifests(const std::string& directory, uint32_t count) {
+    std::error_code ec;
+    std::filesystem::remove_all(directory, ec);
+    if (!std::filesystem::create_directories(directory, ec)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        const std::string name = "XR_APILAYER_BENCHMARK_synthetic_" + std::to_string(i);
+        std::ofstream manifest(std::filesystem::path(directory) / (name + ".json"));
+        if (!manifest) {
+            return false;
+        }
+        manifest << "{\n"
+                    "    \"file_format_version\": \"1.0.0\",\n"
+                    "    \"api_layer\": {\n"
+                    "        \"name\": \""
+                 << name
+                 << "\",\n"
+                    "        \"library_path\": \"" LOADER_BENCHMARK_TEST_LAYER_LIBRARY
+                    "\",\n"
+                    "        \"api_version\": \"1.1\",\n"
+                    "        \"implementation_version\": \"1\",\n"
+                    "        \"description\": \"Synthetic manifest for loader discovery benchmarks\"\n"
+                    "    }\n"
+                    "}\n";
+    }
+    return true;
+}
+
+LoaderBenchmarkLibraryPin::LoaderBenchmarkLibraryPin() {
+    runtime_library_ = dlopen(LOADER_BENCHMARK_RUNTIME_LIBRARY, RTLD_NOW | RTLD_LOCAL);
+    layer_library_ = dlopen(LOADER_BENCHMARK_TEST_LAYER_LIBRARY, RTLD_NOW | RTLD_LOCAL);
+    if (runtime_library_ == nullptr) {
+        return;
+    }
+
+    auto negotiate = reinterpret_cast<PFN_xrNegotiateLoaderRuntimeInterface>(
+        dlsym(runtime_library_, "xrNegotiateLoaderRuntimeInterface"));
+    if (negotiate == nullptr) {
+        return;
+    }
+
+    XrNegotiateLoaderInfo loader_info{};
+    loader_info.structType = XR_LOADER_INTERFACE_STRUCT_LOADER_INFO;
+    loader_info.structVersion = XR_LOADER_INFO_STRUCT_VERSION;
+    loader_info.structSize = sizeof(XrNegotiateLoaderInfo);
+    loader_info.minInterfaceVersion = 1;
+    loader_info.maxInterfaceVersion = XR_CURRENT_LOADER_RUNTIME_VERSION;
+    loader_info.minApiVersion = XR_MAKE_VERSION(1, 0, 0);
+    loader_info.maxApiVersion = XR_MAKE_VERSION(1, 0x3ff, 0xfff);
+
+    XrNegotiateRuntimeRequest runtime_request{};
+    runtime_request.structType = XR_LOADER_INTERFACE_STRUCT_RUNTIME_REQUEST;
+    runtime_request.structVersion = XR_RUNTIME_INFO_STRUCT_VERSION;
+    runtime_request.structSize = sizeof(XrNegotiateRuntimeRequest);
+    if (XR_SUCCEEDED(negotiate(&loader_info, &runtime_request))) {
+        runtime_gipa_ = runtime_request.getInstanceProcAddr;
+    }
+}
+
+LoaderBenchmarkLibraryPin::~LoaderBenchmarkLibraryPin() {
+    if (layer_library_ != nullptr) {
+        dlclose(layer_library_);
+    }
+    if (runtime_library_ != nullptr) {
+        dlclose(runtime_library_);
+    }
+}
+
+static XrInstanceCreateInfo MakeInstanceCreateInfo(const std::vector<const char*>& layers,
+                                                   const std::vector<const char*>& extensions) {
+    XrInstanceCreateInfo create_info{XR_TYPE_INSTANCE_CREATE_INFO};
+    strcpy(create_info.applicationInfo.applicationName, "loader_benchmark");
+    create_info.applicationInfo.applicationVersion = 1;
+    create_info.applicationInfo.apiVersion = XR_API_VERSION_1_1;
+    create_info.enabledApiLayerCount = static_cast<uint32_t>(layers.size());
+    create_info.enabledApiLayerNames = layers.empty() ? nullptr : layers.data();
+    create_info.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+    create_info.enabledExtensionNames = extensions.empty() ? nullptr : extensions.data();
+    return create_info;
+}
+
+XrResult LoaderBenchmarkCreateDestroyInstance(const std::vector<const char*>& layers) {
+    XrInstanceCreateInfo create_info = MakeInstanceCreateInfo(layers, {});
+    XrInstance instance = XR_NULL_HANDLE;
+    XrResult result = xrCreateInstance(&create_info, &instance);
+    if (XR_SUCCEEDED(result)) {
+        result = xrDestroyInstance(instance);
+    }
+    return result;
+}
+
+LoaderBenchmarkSession::LoaderBenchmarkSession(std::vector<std::string> layers, std::vector<std::string> extensions)
+    : layers_(std::move(layers)), extensions_(std::move(extensions)) {
+    extensions_.emplace_back(XR_MND_HEADLESS_EXTENSION_NAME);
+
+    std::vector<const char*> layer_names;
+    for (const auto& layer : layers_) {
+        layer_names.push_back(layer.c_str());
+    }
+    std::vector<const char*> extension_names;
+    for (const auto& extension : extensions_) {
+        extension_names.push_back(extension.c_str());
+    }
+
+    XrInstanceCreateInfo create_info = MakeInstanceCreateInfo(layer_names, extension_names);
+    if (XR_FAILED(Check(xrCreateInstance(&create_info, &instance)))) {
+        return;
+    }
+
+    XrSystemGetInfo system_get_info{XR_TYPE_SYSTEM_GET_INFO};
+    system_get_info.formFactor = XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY;
+    if (XR_FAILED(Check(xrGetSystem(instance, &system_get_info, &system_id)))) {
+        return;
+    }
+
+    XrSessionCreateInfo session_create_info{XR_TYPE_SESSION_CREATE_INFO};
+    session_create_info.systemId = system_id;
+    if (XR_FAILED(Check(xrCreateSession(instance, &session_create_info, &session)))) {
+        return;
+    }
+
+    XrSessionBeginInfo begin_info{XR_TYPE_SESSION_BEGIN_INFO};
+    begin_info.primaryViewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+    if (XR_FAILED(Check(xrBeginSession(session, &begin_info)))) {
+        return;
+    }
+
+    XrReferenceSpaceCreateInfo space_create_info{XR_TYPE_REFERENCE_SPACE_CREATE_INFO};
+    space_create_info.poseInReferenceSpace.orientation.w = 1.0f;
+    space_create_info.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL;
+    if (XR_FAILED(Check(xrCreateReferenceSpace(session, &space_create_info, &local_space)))) {
+        return;
+    }
+    space_create_info.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_VIEW;
+    if (XR_FAILED(Check(xrCreateReferenceSpace(session, &space_create_info, &view_space)))) {
+        return;
+    }
+
+    XrActionSetCreateInfo action_set_create_info{XR_TYPE_ACTION_SET_CREATE_INFO};
+    strcpy(action_set_create_info.actionSetName, "benchmark");
+    strcpy(action_set_create_info.localizedActionSetName, "Benchmark");
+    if (XR_FAILED(Check(xrCreateActionSet(instance, &action_set_create_info, &action_set)))) {
+        return;
+    }
+
+    XrActionCreateInfo action_create_info{XR_TYPE_ACTION_CREATE_INFO};
+    action_create_info.actionType = XR_ACTION_TYPE_FLOAT_INPUT;
+    strcpy(action_create_info.actionName, "value");
+    strcpy(action_create_info.localizedActionName, "Value");
+    if (XR_FAILED(Check(xrCreateAction(action_set, &action_create_info, &float_action)))) {
+        return;
+    }
+
+    XrSessionActionSetsAttachInfo attach_info{XR_TYPE_SESSION_ACTION_SETS_ATTACH_INFO};
+    attach_info.countActionSets = 1;
+    attach_info.actionSets = &action_set;
+    Check(xrAttachSessionActionSets(session, &attach_info));
+}
+
+LoaderBenchmarkSession::~LoaderBenchmarkSession() {
+    if (instance != XR_NULL_HANDLE) {
+        // Destroying the instance destroys every child handle as well.
+        xrDestroyInstance(instance);
+    }
+}
+
+XrResult LoaderBenchmarkSession::Check(XrResult result) {
+    if (XR_FAILED(result) && XR_SUCCEEDED(result_)) {
+        result_ = result;
+    }
+    return result;
+}
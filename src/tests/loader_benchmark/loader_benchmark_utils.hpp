@@ -0,0 +1,88 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#pragma once
+
+#include "xr_dependencies.h"
+#include <openxr/openxr.h>
+
+#include <string>
+#include <vector>
+
+// Point the loader at the in-tree test_runtime and the layer manifests generated for loader_test.
+// Must be called before the first loader entry point is used, since the loader reads some of these
+// (XR_LOADER_DEBUG in particular) only once.
+void LoaderBenchmarkConfigureEnvironment(const std::string& loader_debug_level);
+
+// Set or clear XR_API_LAYER_PATH.  An empty path restores the default loader_test layer directory.
+void LoaderBenchmarkSetApiLayerPath(const std::string& path);
+
+// Directory containing the generated loader_test layer manifests.
+std::string LoaderBenchmarkDefaultApiLayerPath();
+
+// Write `count` copies of the XrApiLayer_test manifest (each with a unique layer name) into `directory`,
+// replacing anything already there.  Used to measure manifest discovery cost.
+bool LoaderBenchmarkWriteSyntheticManifests(const std::string& directory, uint32_t count);
+
+// Keep the runtime and test layer libraries mapped for the lifetime of the object so that instance
+// creation measures only the loader's own work rather than dlopen/dlclose.
+class LoaderBenchmarkLibraryPin {
+   public:
+    LoaderBenchmarkLibraryPin();
+    ~LoaderBenchmarkLibraryPin();
+    LoaderBenchmarkLibraryPin(const LoaderBenchmarkLibraryPin&) = delete;
+    LoaderBenchmarkLibraryPin& operator=(const LoaderBenchmarkLibraryPin&) = delete;
+
+    // The test_runtime's own xrGetInstanceProcAddr, for calling the runtime without going through the loader.
+    PFN_xrGetInstanceProcAddr RuntimeGetInstanceProcAddr() const { return runtime_gipa_; }
+
+   private:
+    void* runtime_library_ = nullptr;
+    void* layer_library_ = nullptr;
+    PFN_xrGetInstanceProcAddr runtime_gipa_ = nullptr;
+};
+
+// A headless instance/session on top of test_runtime with everything needed to exercise the
+// per-frame trampolines: a running session, two reference spaces and an attached action set.
+class LoaderBenchmarkSession {
+   public:
+    LoaderBenchmarkSession(std::vector<std::string> layers, std::vector<std::string> extensions = {});
+    ~LoaderBenchmarkSession();
+    LoaderBenchmarkSession(const LoaderBenchmarkSession&) = delete;
+    LoaderBenchmarkSession& operator=(const LoaderBenchmarkSession&) = delete;
+
+    // Returns the first failing result, if any.
+    XrResult Result() const { return result_; }
+
+    XrInstance instance = XR_NULL_HANDLE;
+    XrSystemId system_id = XR_NULL_SYSTEM_ID;
+    XrSession session = XR_NULL_HANDLE;
+    XrSpace local_space = XR_NULL_HANDLE;
+    XrSpace view_space = XR_NULL_HANDLE;
+    XrActionSet action_set = XR_NULL_HANDLE;
+    XrAction float_action = XR_NULL_HANDLE;
+
+   private:
+    XrResult Check(XrResult result);
+
+    std::vector<std::string> layers_;
+    std::vector<std::string> extensions_;
+    XrResult result_ = XR_SUCCESS;
+};
+
+// Create and immediately destroy an instance with the given layers enabled.
+XrResult LoaderBenchmarkCreateDestroyInstance(const std::vector<const char*>& layers);
@@ -0,0 +1,556 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Multi-threaded contention stress test for the loader, API layers and test_runtime.
+//
+// N threads hammer xrLocateSpace, xrGetActionStateFloat, xrSessionInsertDebugUtilsLabelEXT and
+// xrSubmitDebugUtilsMessageEXT through a configurable layer stack.  For each thread count we report
+// calls per second, tail latencies, and lock contention.  With --churn, one more thread creates and
+// destroys reference spaces for the whole run, so handle lookups in the layers race with inserts and
+// erases the way they do when an application creates spaces while other threads render.
+//
+// Lock contention is measured without touching the loader or layers: this executable exports its own
+// pthread_mutex_lock / pthread_rwlock_{rd,wr}lock, which take precedence over libc for every library in
+// the process.  Each acquisition first tries the lock; only when that fails is the blocking wait timed
+// and charged to the mutex, along with the library the lock was taken from.  That is enough to tell
+// LoaderLogger::_mutex and RuntimeInterface::_dispatch_table_mutex (loader) apart from
+// the HandleInfoBase shard locks (core_validation) and the runtime's own locks.
+//
+
+#include "loader_benchmark_utils.hpp"
+
+#include "xr_dependencies.h"
+#include <openxr/openxr.h>
+
+#include <dlfcn.h>
+#include <pthread.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+//
+// Lock profiling
+//
+
+using PFN_pthread_mutex = int (*)(pthread_mutex_t*);
+using PFN_pthread_rwlock = int (*)(pthread_rwlock_t*);
+
+PFN_pthread_mutex g_real_mutex_lock = nullptr;
+PFN_pthread_mutex g_real_mutex_trylock = nullptr;
+PFN_pthread_rwlock g_real_rwlock_rdlock = nullptr;
+PFN_pthread_rwlock g_real_rwlock_tryrdlock = nullptr;
+PFN_pthread_rwlock g_real_rwlock_wrlock = nullptr;
+PFN_pthread_rwlock g_real_rwlock_trywrlock = nullptr;
+
+void ResolveRealLockFunctions() {
+    if (g_real_mutex_lock != nullptr) {
+        return;
+    }
+    g_real_mutex_trylock = reinterpret_cast<PFN_pthread_mutex>(dlsym(RTLD_NEXT, "pthread_mutex_trylock"));
+    g_real_rwlock_rdlock = reinterpret_cast<PFN_pthread_rwlock>(dlsym(RTLD_NEXT, "pthread_rwlock_rdlock"));
+    g_real_rwlock_tryrdlock = reinterpret_cast<PFN_pthread_rwlock>(dlsym(RTLD_NEXT, "pthread_rwlock_tryrdlock"));
+    g_real_rwlock_wrlock = reinterpret_cast<PFN_pthread_rwlock>(dlsym(RTLD_NEXT, "pthread_rwlock_wrlock"));
+    g_real_rwlock_trywrlock = reinterpret_cast<PFN_pthread_rwlock>(dlsym(RTLD_NEXT, "pthread_rwlock_trywrlock"));
+    g_real_mutex_lock = reinterpret_cast<PFN_pthread_mutex>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+}
+
+__attribute__((constructor)) void InitLockProfiling() { ResolveRealLockFunctions(); }
+
+std::atomic<bool> g_lock_profiling{false};
+
+// Fixed-size, lock-free table of contended locks keyed by address.
+struct LockStats {
+    std::atomic<uintptr_t> lock{0};
+    std::atomic<uintptr_t> caller{0};
+    std::atomic<uint64_t> contended{0};
+    std::atomic<uint64_t> wait_ns{0};
+};
+constexpr size_t kLockTableSize = 1024;
+std::array<LockStats, kLockTableSize> g_lock_table;
+std::atomic<uint64_t> g_lock_acquisitions{0};
+
+void RecordContention(const void* lock, const void* caller, uint64_t wait_ns) {
+    const auto key = reinterpret_cast<uintptr_t>(lock);
+    for (size_t probe = 0; probe < kLockTableSize; ++probe) {
+        LockStats& entry = g_lock_table[(key / sizeof(void*) + probe) % kLockTableSize];
+        uintptr_t existing = entry.lock.load(std::memory_order_acquire);
+        if (existing == 0 && entry.lock.compare_exchange_strong(existing, key)) {
+            entry.caller.store(reinterpret_cast<uintptr_t>(caller), std::memory_order_relaxed);
+            existing = key;
+        }
+        if (existing == key) {
+            entry.contended.fetch_add(1, std::memory_order_relaxed);
+            entry.wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+void ResetLockStats() {
+    for (auto& entry : g_lock_table) {
+        entry.lock.store(0);
+        entry.caller.store(0);
+        entry.contended.store(0);
+        entry.wait_ns.store(0);
+    }
+    g_lock_acquisitions.store(0);
+}
+
+uint64_t NowNs() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+template <typename Lock, typename TryFn, typename LockFn>
+int ProfiledLock(Lock* lock, TryFn try_fn, LockFn lock_fn, const void* caller) {
+    if (!g_lock_profiling.load(std::memory_order_relaxed) || try_fn == nullptr) {
+        return lock_fn(lock);
+    }
+    g_lock_acquisitions.fetch_add(1, std::memory_order_relaxed);
+    if (try_fn(lock) == 0) {
+        return 0;
+    }
+    const uint64_t start = NowNs();
+    const int result = lock_fn(lock);
+    RecordContention(lock, caller, NowNs() - start);
+    return result;
+}
+
+}  // namespace
+
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex) {
+    ResolveRealLockFunctions();
+    return ProfiledLock(mutex, g_real_mutex_trylock, g_real_mutex_lock, __builtin_return_address(0));
+}
+
+extern "C" int pthread_rwlock_rdlock(pthread_rwlock_t* rwlock) {
+    ResolveRealLockFunctions();
+    return ProfiledLock(rwlock, g_real_rwlock_tryrdlock, g_real_rwlock_rdlock, __builtin_return_address(0));
+}
+
+extern "C" int pthread_rwlock_wrlock(pthread_rwlock_t* rwlock) {
+    ResolveRealLockFunctions();
+    return ProfiledLock(rwlock, g_real_rwlock_trywrlock, g_real_rwlock_wrlock, __builtin_return_address(0));
+}
+
+namespace {
+
+//
+// Latency histogram: 16 linear sub-buckets per power of two, so percentiles are within ~6%.
+//
+
+class LatencyHistogram {
+   public:
+    void Add(uint64_t ns) { ++counts_[Index(ns)]; }
+
+    void Merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            counts_[i] += other.counts_[i];
+        }
+    }
+
+    uint64_t Count() const {
+        uint64_t total = 0;
+        for (auto c : counts_) {
+            total += c;
+        }
+        return total;
+    }
+
+    uint64_t Percentile(double p) const {
+        const uint64_t total = Count();
+        if (total == 0) {
+            return 0;
+        }
+        const auto target = static_cast<uint64_t>(p * static_cast<double>(total - 1));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            seen += counts_[i];
+            if (seen > target) {
+                return Value(static_cast<uint32_t>(i));
+            }
+        }
+        return Value(static_cast<uint32_t>(counts_.size() - 1));
+    }
+
+   private:
+    static constexpr uint32_t kSubBuckets = 16;
+
+    static uint32_t Index(uint64_t ns) {
+        if (ns < kSubBuckets) {
+            return static_cast<uint32_t>(ns);
+        }
+        const uint32_t msb = 63u - static_cast<uint32_t>(__builtin_clzll(ns));
+        const uint32_t shift = msb - 4;
+        return (msb - 3) * kSubBuckets + static_cast<uint32_t>((ns >> shift) & (kSubBuckets - 1));
+    }
+
+    static uint64_t Value(uint32_t index) {
+        if (index < kSubBuckets) {
+            return index;
+        }
+        const uint32_t shift = index / kSubBuckets - 1;
+        return (uint64_t{kSubBuckets} + index % kSubBuckets) << shift;
+    }
+
+    std::array<uint64_t, 64 * kSubBuckets> counts_{};
+};
+
+//
+// Stress workload
+//
+
+enum StressCall { CALL_LOCATE_SPACE = 0, CALL_GET_ACTION_STATE_FLOAT, CALL_INSERT_LABEL, CALL_SUBMIT_MESSAGE, CALL_COUNT };
+const char* const kStressCallNames[CALL_COUNT] = {"xrLocateSpace", "xrGetActionStateFloat", "xrSessionInsertDebugUtilsLabelEXT",
+                                                  "xrSubmitDebugUtilsMessageEXT"};
+
+struct StressOptions {
+    std::vector<uint32_t> thread_counts{1, 2, 4, 8, 16, 32};
+    uint32_t duration_ms = 1000;
+    std::vector<std::string> layers;
+    std::string json_file;
+    bool profile_locks = true;
+    bool churn = false;
+};
+
+struct ThreadResult {
+    std::array<LatencyHistogram, CALL_COUNT> histograms;
+    uint64_t failures = 0;
+};
+
+struct ContendedLock {
+    std::string library;
+    uintptr_t address;
+    uint64_t contended;
+    uint64_t wait_ns;
+};
+
+struct RunResult {
+    uint32_t threads;
+    double seconds;
+    std::array<LatencyHistogram, CALL_COUNT> histograms;
+    LatencyHistogram all;
+    uint64_t failures;
+    uint64_t churn_cycles;
+    uint64_t lock_acquisitions;
+    std::vector<ContendedLock> locks;
+};
+
+XrBool32 XRAPI_CALL StressDebugCallback(XrDebugUtilsMessageSeverityFlagsEXT, XrDebugUtilsMessageTypeFlagsEXT,
+                                        const XrDebugUtilsMessengerCallbackDataEXT*, void* user_data) {
+    static_cast<std::atomic<uint64_t>*>(user_data)->fetch_add(1, std::memory_order_relaxed);
+    return XR_FALSE;
+}
+
+std::string LibraryName(uintptr_t caller) {
+    Dl_info info{};
+    if (caller == 0 || dladdr(reinterpret_cast<void*>(caller), &info) == 0 || info.dli_fname == nullptr) {
+        return "unknown";
+    }
+    std::string name = info.dli_fname;
+    const auto slash = name.find_last_of('/');
+    return slash == std::string::npos ? name : name.substr(slash + 1);
+}
+
+void StressThread(LoaderBenchmarkSession& session, PFN_xrSessionInsertDebugUtilsLabelEXT insert_label,
+                  PFN_xrSubmitDebugUtilsMessageEXT submit_message, const std::atomic<bool>& start, const std::atomic<bool>& stop,
+                  ThreadResult& result) {
+    XrSpaceLocation location{XR_TYPE_SPACE_LOCATION};
+    XrActionStateGetInfo get_info{XR_TYPE_ACTION_STATE_GET_INFO};
+    get_info.action = session.float_action;
+    XrActionStateFloat state{XR_TYPE_ACTION_STATE_FLOAT};
+    XrDebugUtilsLabelEXT label{XR_TYPE_DEBUG_UTILS_LABEL_EXT};
+    label.labelName = "loader_stress";
+    XrDebugUtilsMessengerCallbackDataEXT callback_data{XR_TYPE_DEBUG_UTILS_MESSENGER_CALLBACK_DATA_EXT};
+    callback_data.messageId = "loader_stress";
+    callback_data.functionName = "StressThread";
+    callback_data.message = "stress";
+
+    while (!start.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    uint32_t call = 0;
+    while (!stop.load(std::memory_order_relaxed)) {
+        XrResult xr_result = XR_SUCCESS;
+        const uint64_t begin = NowNs();
+        switch (call) {
+            case CALL_LOCATE_SPACE:
+                xr_result = xrLocateSpace(session.view_space, session.local_space, 1, &location);
+                break;
+            case CALL_GET_ACTION_STATE_FLOAT:
+                xr_result = xrGetActionStateFloat(session.session, &get_info, &state);
+                break;
+            case CALL_INSERT_LABEL:
+                xr_result = insert_label(session.session, &label);
+                break;
+            case CALL_SUBMIT_MESSAGE:
+                xr_result = submit_message(session.instance, XR_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT,
+                                           XR_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT, &callback_data);
+                break;
+            default:
+                break;
+        }
+        result.histograms[call].Add(NowNs() - begin);
+        if (XR_FAILED(xr_result)) {
+            ++result.failures;
+        }
+        call = (call + 1) % CALL_COUNT;
+    }
+}
+
+// Create and destroy a reference space until stopped, counting completed cycles.
+void ChurnThread(LoaderBenchmarkSession& session, const std::atomic<bool>& start, const std::atomic<bool>& stop,
+                 uint64_t& cycles, uint64_t& failures) {
+    XrReferenceSpaceCreateInfo create_info{XR_TYPE_REFERENCE_SPACE_CREATE_INFO};
+    create_info.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL;
+    create_info.poseInReferenceSpace.orientation.w = 1.0f;
+
+    while (!start.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    while (!stop.load(std::memory_order_relaxed)) {
+        XrSpace space = XR_NULL_HANDLE;
+        if (XR_FAILED(xrCreateReferenceSpace(session.session, &create_info, &space)) || XR_FAILED(xrDestroySpace(space))) {
+            ++failures;
+            continue;
+        }
+        ++cycles;
+    }
+}
+
+bool RunStress(const StressOptions& options, uint32_t thread_count, RunResult& run) {
+    LoaderBenchmarkSession session(options.layers, {XR_EXT_DEBUG_UTILS_EXTENSION_NAME});
+    if (XR_FAILED(session.Result())) {
+        fprintf(stderr, "loader_stress: session setup failed with %d\n", static_cast<int>(session.Result()));
+        return false;
+    }
+
+    PFN_xrCreateDebugUtilsMessengerEXT create_messenger = nullptr;
+    PFN_xrSessionInsertDebugUtilsLabelEXT insert_label = nullptr;
+    PFN_xrSubmitDebugUtilsMessageEXT submit_message = nullptr;
+    xrGetInstanceProcAddr(session.instance, "xrCreateDebugUtilsMessengerEXT",
+                          reinterpret_cast<PFN_xrVoidFunction*>(&create_messenger));
+    xrGetInstanceProcAddr(session.instance, "xrSessionInsertDebugUtilsLabelEXT",
+                          reinterpret_cast<PFN_xrVoidFunction*>(&insert_label));
+    xrGetInstanceProcAddr(session.instance, "xrSubmitDebugUtilsMessageEXT", reinterpret_cast<PFN_xrVoidFunction*>(&submit_message));
+    if (create_messenger == nullptr || insert_label == nullptr || submit_message == nullptr) {
+        fprintf(stderr, "loader_stress: XR_EXT_debug_utils entry points unavailable\n");
+        return false;
+    }
+
+    // A typical application messenger, so submitted messages go through the full logger path.
+    std::atomic<uint64_t> callback_count{0};
+    XrDebugUtilsMessengerCreateInfoEXT messenger_info{XR_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT};
+    messenger_info.messageSeverities = XR_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT | XR_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT |
+                                       XR_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT |
+                                       XR_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+    messenger_info.messageTypes = XR_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT;
+    messenger_info.userCallback = StressDebugCallback;
+    messenger_info.userData = &callback_count;
+    XrDebugUtilsMessengerEXT messenger = XR_NULL_HANDLE;
+    if (XR_FAILED(create_messenger(session.instance, &messenger_info, &messenger))) {
+        fprintf(stderr, "loader_stress: xrCreateDebugUtilsMessengerEXT failed\n");
+        return false;
+    }
+
+    std::vector<ThreadResult> results(thread_count);
+    std::vector<std::thread> threads;
+    std::atomic<bool> start{false};
+    std::atomic<bool> stop{false};
+    for (uint32_t i = 0; i < thread_count; ++i) {
+        threads.emplace_back(StressThread, std::ref(session), insert_label, submit_message, std::cref(start), std::cref(stop),
+                             std::ref(results[i]));
+    }
+    uint64_t churn_cycles = 0;
+    uint64_t churn_failures = 0;
+    if (options.churn) {
+        threads.emplace_back(ChurnThread, std::ref(session), std::cref(start), std::cref(stop), std::ref(churn_cycles),
+                             std::ref(churn_failures));
+    }
+
+    ResetLockStats();
+    g_lock_profiling.store(options.profile_locks);
+    const auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::milliseconds(options.duration_ms));
+    stop.store(true);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    g_lock_profiling.store(false);
+
+    run.threads = thread_count;
+    run.seconds = std::chrono::duration<double>(end - begin).count();
+    run.failures = churn_failures;
+    run.churn_cycles = churn_cycles;
+    for (const auto& result : results) {
+        for (uint32_t call = 0; call < CALL_COUNT; ++call) {
+            run.histograms[call].Merge(result.histograms[call]);
+            run.all.Merge(result.histograms[call]);
+        }
+        run.failures += result.failures;
+    }
+    run.lock_acquisitions = g_lock_acquisitions.load();
+    for (const auto& entry : g_lock_table) {
+        if (entry.lock.load() != 0) {
+            run.locks.push_back({LibraryName(entry.caller.load()), entry.lock.load(), entry.contended.load(), entry.wait_ns.load()});
+        }
+    }
+    std::sort(run.locks.begin(), run.locks.end(),
+              [](const ContendedLock& a, const ContendedLock& b) { return a.wait_ns > b.wait_ns; });
+    return true;
+}
+
+void PrintRun(const RunResult& run) {
+    const double calls = static_cast<double>(run.all.Count());
+    printf("threads %2" PRIu32 ": %12.0f calls/s, p50 %7" PRIu64 " ns, p99 %8" PRIu64 " ns, p99.9 %9" PRIu64 " ns, failures %" PRIu64
+           "\n",
+           run.threads, calls / run.seconds, run.all.Percentile(0.5), run.all.Percentile(0.99), run.all.Percentile(0.999),
+           run.failures);
+    if (run.churn_cycles != 0) {
+        printf("    %-36s %12.0f create/destroy cycles/s\n", "churn", static_cast<double>(run.churn_cycles) / run.seconds);
+    }
+    for (uint32_t call = 0; call < CALL_COUNT; ++call) {
+        const auto& histogram = run.histograms[call];
+        printf("    %-36s p50 %7" PRIu64 " ns, p99 %8" PRIu64 " ns, p99.9 %9" PRIu64 " ns\n", kStressCallNames[call],
+               histogram.Percentile(0.5), histogram.Percentile(0.99), histogram.Percentile(0.999));
+    }
+    const double thread_ns = run.seconds * 1e9 * run.threads;
+    for (size_t i = 0; i < run.locks.size() && i < 8; ++i) {
+        const auto& lock = run.locks[i];
+        printf("    lock %-28s 0x%012" PRIxPTR ": %10" PRIu64 " contended, %9.3f ms waiting (%5.1f%% of thread time)\n",
+               lock.library.c_str(), lock.address, lock.contended, static_cast<double>(lock.wait_ns) / 1e6,
+               100.0 * static_cast<double>(lock.wait_ns) / thread_ns);
+    }
+}
+
+void WriteJson(const std::string& file_name, const StressOptions& options, const std::vector<RunResult>& runs) {
+    std::ofstream json(file_name, std::ios::out | std::ios::trunc);
+    json << "{\n    \"layers\": [";
+    for (size_t i = 0; i < options.layers.size(); ++i) {
+        json << (i == 0 ? "" : ", ") << "\"" << options.layers[i] << "\"";
+    }
+    json << "],\n    \"duration_ms\": " << options.duration_ms << ",\n    \"churn\": " << (options.churn ? "true" : "false")
+         << ",\n    \"runs\": [";
+    for (size_t r = 0; r < runs.size(); ++r) {
+        const auto& run = runs[r];
+        json << (r == 0 ? "\n" : ",\n");
+        json << "        {\"threads\": " << run.threads << ", \"calls_per_second\": " << run.all.Count() / run.seconds
+             << ", \"p50_ns\": " << run.all.Percentile(0.5) << ", \"p99_ns\": " << run.all.Percentile(0.99)
+             << ", \"p999_ns\": " << run.all.Percentile(0.999) << ", \"failures\": " << run.failures
+             << ", \"churn_cycles_per_second\": " << run.churn_cycles / run.seconds
+             << ", \"lock_acquisitions\": " << run.lock_acquisitions << ",\n         \"calls\": {";
+        for (uint32_t call = 0; call < CALL_COUNT; ++call) {
+            const auto& histogram = run.histograms[call];
+            json << (call == 0 ? "" : ", ") << "\"" << kStressCallNames[call] << "\": {\"count\": " << histogram.Count()
+                 << ", \"p50_ns\": " << histogram.Percentile(0.5) << ", \"p99_ns\": " << histogram.Percentile(0.99)
+                 << ", \"p999_ns\": " << histogram.Percentile(0.999) << "}";
+        }
+        json << "},\n         \"contended_locks\": [";
+        for (size_t i = 0; i < run.locks.size(); ++i) {
+            const auto& lock = run.locks[i];
+            json << (i == 0 ? "" : ", ") << "{\"library\": \"" << lock.library << "\", \"address\": " << lock.address
+                 << ", \"contended\": " << lock.contended << ", \"wait_ns\": " << lock.wait_ns << "}";
+        }
+        json << "]}";
+    }
+    json << "\n    ]\n}\n";
+}
+
+std::vector<std::string> SplitList(const std::string& list) {
+    std::vector<std::string> items;
+    std::istringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+void PrintUsage() {
+    printf(
+        "usage: loader_stress [--threads 1,2,4,8,16,32] [--duration-ms 1000] [--layers LAYER[,LAYER...]]\n"
+        "                     [--json FILE] [--no-lock-profiling] [--churn] [--loader-debug LEVEL]\n"
+        "\n"
+        "--churn adds a thread that creates and destroys reference spaces throughout each run.\n"
+        "Layers are found in the loader_test layer directory, e.g. XR_APILAYER_test,\n"
+        "XR_APILAYER_LUNARG_core_validation, XR_APILAYER_LUNARG_api_dump.\n");
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    StressOptions options;
+    std::string loader_debug_level = "none";
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--threads" && has_value) {
+            options.thread_counts.clear();
+            for (const auto& count : SplitList(argv[++i])) {
+                options.thread_counts.push_back(static_cast<uint32_t>(std::stoul(count)));
+            }
+        } else if (arg == "--duration-ms" && has_value) {
+            options.duration_ms = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--layers" && has_value) {
+            options.layers = SplitList(argv[++i]);
+        } else if (arg == "--json" && has_value) {
+            options.json_file = argv[++i];
+        } else if (arg == "--loader-debug" && has_value) {
+            loader_debug_level = argv[++i];
+        } else if (arg == "--no-lock-profiling") {
+            options.profile_locks = false;
+        } else if (arg == "--churn") {
+            options.churn = true;
+        } else {
+            PrintUsage();
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    LoaderBenchmarkConfigureEnvironment(loader_debug_level);
+
+    std::vector<RunResult> runs;
+    for (uint32_t thread_count : options.thread_counts) {
+        RunResult run{};
+        if (thread_count == 0 || !RunStress(options, thread_count, run)) {
+            return 1;
+        }
+        PrintRun(run);
+        runs.push_back(std::move(run));
+    }
+
+    if (!options.json_file.empty()) {
+        WriteJson(options.json_file, options, runs);
+    }
+    return 0;
+}
@@ -21,16 +21,35 @@
 //
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <functional>
 #include <iostream>
+#include <map>
 #include <sstream>
+#include <thread>
 #include <type_traits>
 #include <vector>
 #include <filesystem>
+#include <fstream>
 
 #include "filesystem_utils.hpp"
 #include "loader_test_utils.hpp"
+#include "test_runtime_swapchain.h"
+#include "xr_layer_handle_data.h"
+
+#if defined(XR_OS_LINUX) || defined(XR_OS_APPLE)
+#include "frame_timing_shm.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif  // defined(XR_OS_LINUX) || defined(XR_OS_APPLE)
 
 #if defined(XR_USE_PLATFORM_ANDROID)
 #include <android_native_app_glue.h>
@@ -42,6 +61,7 @@
 #include <openxr/openxr_platform.h>
 #include <openxr/openxr_reflection.h>
 
+#include <catch2/catch_approx.hpp>
 #include <catch2/catch_message.hpp>
 #include <catch2/catch_session.hpp>
 #include <catch2/catch_test_case_info.hpp>
@@ -342,7 +362,7 @@ TEST_CASE("TestEnumLayers", "") {
     // Tests with some explicit layers instead
     in_layer_value = 0;
     out_layer_value = 0;
-    uint32_t num_valid_jsons = 8;
+    uint32_t num_valid_jsons = 14;
 
 #if defined(XR_USE_PLATFORM_ANDROID)
     // API layers from apk on Android are always available and do not require override.
@@ -754,6 +774,1519 @@ TEST_CASE("TestCreateDestroyAction", "") {
     CleanupEnvironmentVariables();
 }
 
+// Exercise the per-handle data slot table the loader hands to API layers through xrGetInstanceProcAddr.
+TEST_CASE("TestLayerHandleDataSlots", "") {
+    if (!g_has_installed_runtime) {
+        SKIP("Skipped - no runtime installed");
+    }
+
+    XrApplicationInfo app_info = {};
+    strcpy(app_info.applicationName, "Loader Test");
+    app_info.applicationVersion = 688;
+    strcpy(app_info.engineName, "Infinite Improbability Drive");
+    app_info.engineVersion = 42;
+    app_info.apiVersion = XR_CURRENT_API_VERSION;
+
+    XrInstanceCreateInfo instance_ci = {XR_TYPE_INSTANCE_CREATE_INFO};
+    instance_ci.applicationInfo = app_info;
+    auto platform_instance_create = GetPlatformInstanceCreateExtension();
+    instance_ci.next = &platform_instance_create;
+    instance_ci.enabledExtensionCount = base_extension_count;
+    instance_ci.enabledExtensionNames = base_extension_names;
+
+    auto get_table = [](XrInstance instance) -> XrLayerHandleDataTable* {
+        PFN_xrGetLayerHandleDataTableLOADER get_table_fn = nullptr;
+        if (XR_FAILED(xrGetInstanceProcAddr(instance, XR_LOADER_LAYER_HANDLE_DATA_FUNCTION_NAME,
+                                            reinterpret_cast<PFN_xrVoidFunction*>(&get_table_fn))) ||
+            get_table_fn == nullptr) {
+            return nullptr;
+        }
+        XrLayerHandleDataTable* table = nullptr;
+        if (XR_FAILED(get_table_fn(instance, &table))) {
+            return nullptr;
+        }
+        return table;
+    };
+
+    XrInstance instance = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateInstance(&instance_ci, &instance));
+
+    XrLayerHandleDataTable* table = get_table(instance);
+    REQUIRE(XrLayerHandleDataTableIsCompatible(table));
+
+    uint32_t slot_a = 0;
+    uint32_t slot_b = 0;
+    uint32_t slot_again = 0;
+    CHECK(XR_SUCCESS == table->acquire_slot("XR_APILAYER_TEST_a", &slot_a));
+    CHECK(XR_SUCCESS == table->acquire_slot("XR_APILAYER_TEST_b", &slot_b));
+    CHECK(XR_SUCCESS == table->acquire_slot("XR_APILAYER_TEST_a", &slot_again));
+    CHECK(slot_a != slot_b);
+    CHECK(slot_a == slot_again);
+
+    int value_a = 0;
+    int value_b = 0;
+    const uint64_t handle = 0x1000;
+    CHECK(XR_SUCCESS == table->set(XR_OBJECT_TYPE_SESSION, handle, slot_a, &value_a));
+    CHECK(XR_SUCCESS == table->set(XR_OBJECT_TYPE_SESSION, handle, slot_b, &value_b));
+    CHECK(&value_a == XrLayerHandleDataGet(table, XR_OBJECT_TYPE_SESSION, handle, slot_a));
+    CHECK(&value_b == XrLayerHandleDataGet(table, XR_OBJECT_TYPE_SESSION, handle, slot_b));
+    // Same value, different object type: a different handle.
+    CHECK(nullptr == XrLayerHandleDataGet(table, XR_OBJECT_TYPE_SPACE, handle, slot_a));
+
+    // The entry survives until every layer has cleared its slot.
+    CHECK(XR_SUCCESS == table->set(XR_OBJECT_TYPE_SESSION, handle, slot_a, nullptr));
+    CHECK(nullptr == XrLayerHandleDataGet(table, XR_OBJECT_TYPE_SESSION, handle, slot_a));
+    CHECK(&value_b == XrLayerHandleDataGet(table, XR_OBJECT_TYPE_SESSION, handle, slot_b));
+    CHECK(XR_SUCCESS == table->set(XR_OBJECT_TYPE_SESSION, handle, slot_b, nullptr));
+    CHECK(nullptr == XrLayerHandleDataGet(table, XR_OBJECT_TYPE_SESSION, handle, slot_b));
+
+    // Fill well past a single probe chain, remove half, and make sure the rest are still found.
+    std::vector<int> values(1024);
+    for (uint64_t i = 0; i < values.size(); ++i) {
+        CHECK(XR_SUCCESS == table->set(XR_OBJECT_TYPE_SPACE, (i + 1) * 16, slot_a, &values[i]));
+    }
+    for (uint64_t i = 0; i < values.size(); i += 2) {
+        CHECK(XR_SUCCESS == table->set(XR_OBJECT_TYPE_SPACE, (i + 1) * 16, slot_a, nullptr));
+    }
+    bool all_found = true;
+    for (uint64_t i = 0; i < values.size(); ++i) {
+        void* expected = (i % 2 == 0) ? nullptr : &values[i];
+        all_found = all_found && expected == XrLayerHandleDataGet(table, XR_OBJECT_TYPE_SPACE, (i + 1) * 16, slot_a);
+    }
+    CHECK(all_found);
+
+    // Churn through many times the capacity of the table, keeping a window of handles alive, while another
+    // thread looks handles up.  Removed entries must be reclaimed so that inserts keep succeeding, and a
+    // lookup must never see the data of another handle that reused its entry.  Each handle stores its own
+    // value as its data.
+    constexpr uint64_t churn_window = 2000;
+    constexpr uint64_t churn_count = 4 * kXrLayerHandleDataCapacity;
+    auto churn_handle = [](uint64_t i) { return 0x100000 + i * 8; };
+    std::atomic<bool> churning{true};
+    std::atomic<bool> lookups_consistent{true};
+    std::thread reader([&] {
+        uint64_t i = 0;
+        while (churning.load()) {
+            const uint64_t looked_up = churn_handle(i++ % churn_count);
+            void* data = XrLayerHandleDataGet(table, XR_OBJECT_TYPE_SWAPCHAIN, looked_up, slot_a);
+            if (data != nullptr && data != reinterpret_cast<void*>(static_cast<uintptr_t>(looked_up))) {
+                lookups_consistent = false;
+            }
+        }
+    });
+    bool churn_succeeded = true;
+    for (uint64_t i = 0; i < churn_count; ++i) {
+        const uint64_t added = churn_handle(i);
+        void* data = reinterpret_cast<void*>(static_cast<uintptr_t>(added));
+        churn_succeeded = churn_succeeded && XR_SUCCESS == table->set(XR_OBJECT_TYPE_SWAPCHAIN, added, slot_a, data);
+        if (i >= churn_window) {
+            const uint64_t removed = churn_handle(i - churn_window);
+            churn_succeeded = churn_succeeded && XR_SUCCESS == table->set(XR_OBJECT_TYPE_SWAPCHAIN, removed, slot_a, nullptr);
+        }
+    }
+    churning = false;
+    reader.join();
+    CHECK(churn_succeeded);
+    CHECK(lookups_consistent);
+    bool churn_found = true;
+    for (uint64_t i = 0; i < churn_count; ++i) {
+        const bool alive = i + churn_window >= churn_count;
+        void* expected = alive ? reinterpret_cast<void*>(static_cast<uintptr_t>(churn_handle(i))) : nullptr;
+        churn_found = churn_found && expected == XrLayerHandleDataGet(table, XR_OBJECT_TYPE_SWAPCHAIN, churn_handle(i), slot_a);
+    }
+    CHECK(churn_found);
+    // Removed entries do not pile up as tombstones, which would make every lookup of a missing handle
+    // walk the whole table.
+    uint32_t tombstones = 0;
+    for (const auto& entry : table->entries) {
+        tombstones += entry.handle.load() == kXrLayerHandleDataTombstone ? 1 : 0;
+    }
+    CHECK(tombstones < kXrLayerHandleDataCapacity / 4);
+    all_found = true;
+    for (uint64_t i = 1; i < values.size(); i += 2) {
+        all_found = all_found && &values[i] == XrLayerHandleDataGet(table, XR_OBJECT_TYPE_SPACE, (i + 1) * 16, slot_a);
+    }
+    CHECK(all_found);
+
+    CHECK(XR_SUCCESS == xrDestroyInstance(instance));
+
+    // Destroying the instance releases every entry and slot reservation.
+    instance = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateInstance(&instance_ci, &instance));
+    table = get_table(instance);
+    REQUIRE(XrLayerHandleDataTableIsCompatible(table));
+    CHECK(nullptr == XrLayerHandleDataGet(table, XR_OBJECT_TYPE_SPACE, 32, slot_a));
+    uint32_t slot_b_again = 0;
+    CHECK(XR_SUCCESS == table->acquire_slot("XR_APILAYER_TEST_b", &slot_b_again));
+    CHECK(0 == slot_b_again);
+    CHECK(XR_SUCCESS == xrDestroyInstance(instance));
+
+    // Cleanup
+    CleanupEnvironmentVariables();
+}
+
+#if !defined(XR_USE_PLATFORM_ANDROID)
+// The space cache layer must give the same locations as the runtime, while calling it less.  api_dump is
+// enabled below the layer so that the calls that reach the runtime can be counted.
+TEST_CASE("TestSpaceCacheLayer", "") {
+    if (!g_has_installed_runtime) {
+        SKIP("Skipped - no runtime installed");
+    }
+
+    LoaderTestSetEnvironmentVariable("XR_API_LAYER_PATH", "./resources/layers");
+    // api_dump appends to an existing file.
+    std::remove("space_cache_api_dump.txt");
+    LoaderTestSetEnvironmentVariable("XR_API_DUMP_FILE_NAME", "space_cache_api_dump.txt");
+
+    LoaderTestHeadlessSession headless;
+    XrResult result = LoaderTestCreateHeadlessSession(
+        XR_API_VERSION_1_1, {"XR_APILAYER_KHRONOS_space_cache", "XR_APILAYER_LUNARG_api_dump"}, true, headless);
+    if (XR_ERROR_EXTENSION_NOT_PRESENT == result) {
+        LoaderTestUnsetEnvironmentVariable("XR_API_DUMP_FILE_NAME");
+        CleanupEnvironmentVariables();
+        SKIP("Skipped - runtime does not support " XR_MND_HEADLESS_EXTENSION_NAME);
+    }
+    REQUIRE(XR_SUCCESS == result);
+    XrInstance instance = headless.instance;
+    XrSession session = headless.session;
+
+    auto create_space = [&](float x) {
+        XrReferenceSpaceCreateInfo space_ci = {XR_TYPE_REFERENCE_SPACE_CREATE_INFO};
+        space_ci.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL;
+        space_ci.poseInReferenceSpace.orientation.w = 1.0f;
+        space_ci.poseInReferenceSpace.position.x = x;
+        XrSpace space = XR_NULL_HANDLE;
+        CHECK(XR_SUCCESS == xrCreateReferenceSpace(session, &space_ci, &space));
+        return space;
+    };
+
+    // Every space is an offset along x from the base space.
+    XrSpace base_space = create_space(0.0f);
+    std::vector<XrSpace> spaces;
+    std::vector<float> offsets = {1.0f, 2.0f, 3.0f, 4.0f};
+    for (float offset : offsets) {
+        spaces.push_back(create_space(offset));
+    }
+
+    uint32_t app_locate_calls = 0;
+    auto check_location = [&](size_t index, XrTime time, bool with_velocity) {
+        INFO("space " << index);
+        XrSpaceVelocity velocity = {XR_TYPE_SPACE_VELOCITY};
+        XrSpaceLocation location = {XR_TYPE_SPACE_LOCATION};
+        location.next = with_velocity ? &velocity : nullptr;
+        app_locate_calls++;
+        REQUIRE(XR_SUCCESS == xrLocateSpace(spaces[index], base_space, time, &location));
+        CHECK((location.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) != 0);
+        CHECK(offsets[index] == location.pose.position.x);
+        CHECK(0.0f == location.pose.position.y);
+        CHECK(1.0f == location.pose.orientation.w);
+    };
+    auto wait_frame = [&]() {
+        XrFrameState frame_state = {XR_TYPE_FRAME_STATE};
+        REQUIRE(XR_SUCCESS == xrWaitFrame(session, nullptr, &frame_state));
+        return frame_state.predictedDisplayTime;
+    };
+
+    // Before the first xrWaitFrame every call reaches the runtime.
+    check_location(0, 1, false);
+
+    // The first frame has nothing to prefetch, so each space is located once and then cached.
+    XrTime time = wait_frame();
+    for (size_t i = 0; i < spaces.size(); ++i) {
+        check_location(i, time, false);
+        check_location(i, time, false);
+    }
+
+    // The second frame locates every space of the first frame in one xrLocateSpaces call.
+    time = wait_frame();
+    check_location(0, time, true);
+    for (size_t i = 0; i < spaces.size(); ++i) {
+        check_location(i, time, false);
+        check_location(i, time, true);
+    }
+
+    // A space destroyed and created again, possibly with the same handle value, must not be answered
+    // from the old entries.
+    REQUIRE(XR_SUCCESS == xrDestroySpace(spaces[1]));
+    offsets[1] = 10.0f;
+    spaces[1] = create_space(offsets[1]);
+    check_location(1, time, false);
+    check_location(1, time, false);
+
+    time = wait_frame();
+    for (size_t i = 0; i < spaces.size(); ++i) {
+        check_location(i, time, false);
+    }
+
+    CHECK(XR_SUCCESS == xrDestroyInstance(instance));
+
+    uint32_t runtime_locate_space_calls = 0;
+    uint32_t runtime_locate_spaces_calls = 0;
+    std::ifstream dump("space_cache_api_dump.txt");
+    for (std::string line; std::getline(dump, line);) {
+        if (line == "XrResult xrLocateSpace") {
+            runtime_locate_space_calls++;
+        } else if (line == "XrResult xrLocateSpaces") {
+            runtime_locate_spaces_calls++;
+        }
+    }
+    INFO("xrLocateSpace called " << app_locate_calls << " times by the application");
+    // One before the first frame, one per space in the first frame, one for the recreated space.
+    CHECK(6 == runtime_locate_space_calls);
+    // One prefetch in each of the last two frames.
+    CHECK(2 == runtime_locate_spaces_calls);
+
+    // Cleanup
+    LoaderTestUnsetEnvironmentVariable("XR_API_DUMP_FILE_NAME");
+    CleanupEnvironmentVariables();
+}
+
+// The action snapshot layer must give the same action states as the runtime, and only query the runtime
+// once per pair and sync.  The runtime's simulated input changes every state with every sync, so a state
+// answered from an old snapshot shows.  api_dump is enabled below the layer so that the calls that reach the
+// runtime can be counted.
+TEST_CASE("TestActionSnapshotLayer", "") {
+    if (!g_has_installed_runtime) {
+        SKIP("Skipped - no runtime installed");
+    }
+
+    LoaderTestSetEnvironmentVariable("XR_API_LAYER_PATH", "./resources/layers");
+    // api_dump appends to an existing file.
+    std::remove("action_snapshot_api_dump.txt");
+    LoaderTestSetEnvironmentVariable("XR_API_DUMP_FILE_NAME", "action_snapshot_api_dump.txt");
+    LoaderTestSetEnvironmentVariable("XR_TEST_RUNTIME_SIMULATED_INPUT", "1");
+
+    LoaderTestHeadlessSession headless;
+    XrResult result = LoaderTestCreateHeadlessSession(
+        XR_CURRENT_API_VERSION, {"XR_APILAYER_KHRONOS_action_snapshot", "XR_APILAYER_LUNARG_api_dump"}, true, headless);
+    if (XR_ERROR_EXTENSION_NOT_PRESENT == result) {
+        LoaderTestUnsetEnvironmentVariable("XR_API_DUMP_FILE_NAME");
+        LoaderTestUnsetEnvironmentVariable("XR_TEST_RUNTIME_SIMULATED_INPUT");
+        CleanupEnvironmentVariables();
+        SKIP("Skipped - runtime does not support " XR_MND_HEADLESS_EXTENSION_NAME);
+    }
+    REQUIRE(XR_SUCCESS == result);
+    XrInstance instance = headless.instance;
+    XrSession session = headless.session;
+
+    XrPath hands[2] = {XR_NULL_PATH, XR_NULL_PATH};
+    REQUIRE(XR_SUCCESS == xrStringToPath(instance, "/user/hand/left", &hands[0]));
+    REQUIRE(XR_SUCCESS == xrStringToPath(instance, "/user/hand/right", &hands[1]));
+
+    XrActionSetCreateInfo action_set_ci = {XR_TYPE_ACTION_SET_CREATE_INFO};
+    strcpy(action_set_ci.actionSetName, "snapshot");
+    strcpy(action_set_ci.localizedActionSetName, "Snapshot");
+    XrActionSet action_set = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateActionSet(instance, &action_set_ci, &action_set));
+
+    XrActionCreateInfo action_ci = {XR_TYPE_ACTION_CREATE_INFO};
+    action_ci.actionType = XR_ACTION_TYPE_FLOAT_INPUT;
+    strcpy(action_ci.actionName, "grab");
+    strcpy(action_ci.localizedActionName, "Grab");
+    action_ci.countSubactionPaths = 2;
+    action_ci.subactionPaths = hands;
+    XrAction grab_action = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateAction(action_set, &action_ci, &grab_action));
+    action_ci.actionType = XR_ACTION_TYPE_BOOLEAN_INPUT;
+    strcpy(action_ci.actionName, "quit");
+    strcpy(action_ci.localizedActionName, "Quit");
+    action_ci.countSubactionPaths = 0;
+    action_ci.subactionPaths = nullptr;
+    XrAction quit_action = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateAction(action_set, &action_ci, &quit_action));
+
+    XrSessionActionSetsAttachInfo attach_info = {XR_TYPE_SESSION_ACTION_SETS_ATTACH_INFO};
+    attach_info.countActionSets = 1;
+    attach_info.actionSets = &action_set;
+    REQUIRE(XR_SUCCESS == xrAttachSessionActionSets(session, &attach_info));
+
+    // The simulated input after the nth sync: grab is ((n + hand) % 8) / 8 and quit is true when n is odd.
+    uint64_t syncs = 0;
+    auto check_grab = [&](int hand) {
+        INFO("hand " << hand << " after sync " << syncs);
+        XrActionStateGetInfo get_info = {XR_TYPE_ACTION_STATE_GET_INFO};
+        get_info.action = grab_action;
+        get_info.subactionPath = hands[hand];
+        XrActionStateFloat state = {XR_TYPE_ACTION_STATE_FLOAT};
+        state.isActive = XR_TRUE;
+        REQUIRE(XR_SUCCESS == xrGetActionStateFloat(session, &get_info, &state));
+        CHECK(XR_TYPE_ACTION_STATE_FLOAT == state.type);
+        CHECK((syncs > 0 ? XR_TRUE : XR_FALSE) == state.isActive);
+        if (syncs > 0) {
+            CHECK(static_cast<float>((syncs + hand) % 8) / 8.0f == state.currentState);
+            CHECK((syncs > 1 ? XR_TRUE : XR_FALSE) == state.changedSinceLastSync);
+        }
+    };
+    auto check_quit = [&]() {
+        INFO("after sync " << syncs);
+        XrActionStateGetInfo get_info = {XR_TYPE_ACTION_STATE_GET_INFO};
+        get_info.action = quit_action;
+        XrActionStateBoolean state = {XR_TYPE_ACTION_STATE_BOOLEAN};
+        state.isActive = XR_TRUE;
+        REQUIRE(XR_SUCCESS == xrGetActionStateBoolean(session, &get_info, &state));
+        CHECK((syncs > 0 ? XR_TRUE : XR_FALSE) == state.isActive);
+        if (syncs > 0) {
+            CHECK((syncs % 2 == 1 ? XR_TRUE : XR_FALSE) == state.currentState);
+            CHECK((syncs > 1 ? XR_TRUE : XR_FALSE) == state.changedSinceLastSync);
+        }
+    };
+    auto sync = [&]() {
+        XrActiveActionSet active_action_set = {action_set, XR_NULL_PATH};
+        XrActionsSyncInfo sync_info = {XR_TYPE_ACTIONS_SYNC_INFO};
+        sync_info.countActiveActionSets = 1;
+        sync_info.activeActionSets = &active_action_set;
+        REQUIRE(XR_SUCCESS == xrSyncActions(session, &sync_info));
+        syncs++;
+    };
+
+    // Before the first sync every query reaches the runtime.
+    check_grab(0);
+
+    // Nothing has been queried yet at the first sync, so the first query of each pair reaches the runtime.
+    sync();
+    for (int i = 0; i < 2; ++i) {
+        check_grab(0);
+        check_grab(1);
+        check_quit();
+    }
+
+    // The second sync fetches the three pairs, and every query is answered from the snapshot.
+    sync();
+    for (int i = 0; i < 2; ++i) {
+        check_grab(0);
+        check_grab(1);
+        check_quit();
+    }
+
+    sync();
+    check_grab(0);
+
+    // Failures are passed through, and not answered from the snapshot.
+    {
+        XrActionStateGetInfo get_info = {XR_TYPE_ACTION_STATE_GET_INFO};
+        get_info.action = grab_action;
+        XrActionStateBoolean state = {XR_TYPE_ACTION_STATE_BOOLEAN};
+        CHECK(XR_ERROR_ACTION_TYPE_MISMATCH == xrGetActionStateBoolean(session, &get_info, &state));
+    }
+
+    CHECK(XR_SUCCESS == xrDestroyInstance(instance));
+
+    uint32_t runtime_float_calls = 0;
+    uint32_t runtime_boolean_calls = 0;
+    std::ifstream dump("action_snapshot_api_dump.txt");
+    for (std::string line; std::getline(dump, line);) {
+        if (line == "XrResult xrGetActionStateFloat") {
+            runtime_float_calls++;
+        } else if (line == "XrResult xrGetActionStateBoolean") {
+            runtime_boolean_calls++;
+        }
+    }
+    // One before the first sync, one per hand after it, and two per sync after that.
+    CHECK(7 == runtime_float_calls);
+    // One after the first sync, one per sync after that, and the mismatched query.
+    CHECK(4 == runtime_boolean_calls);
+
+    // Cleanup
+    LoaderTestUnsetEnvironmentVariable("XR_API_DUMP_FILE_NAME");
+    LoaderTestUnsetEnvironmentVariable("XR_TEST_RUNTIME_SIMULATED_INPUT");
+    CleanupEnvironmentVariables();
+}
+
+// The best practices layer's performance lints, read back from XR_BEST_PRACTICES_FILE_NAME: a frame begun late, too
+// many xrLocateSpace calls in one frame, and a quad layer submitted unchanged while its image is rendered every frame.
+TEST_CASE("TestBestPracticesLints", "") {
+    if (!g_has_installed_runtime) {
+        SKIP("Skipped - no runtime installed");
+    }
+
+    LoaderTestSetEnvironmentVariable("XR_API_LAYER_PATH", "./resources/layers");
+    // The output is appended to.
+    std::remove("best_practices.txt");
+    LoaderTestSetEnvironmentVariable("XR_BEST_PRACTICES_FILE_NAME", "best_practices.txt");
+    // A late xrBeginFrame is measured against the display period, which is 0 without pacing.
+    LoaderTestSetEnvironmentVariable("XR_TEST_RUNTIME_REFRESH_RATE", "100");
+    auto unset_lint_variables = []() {
+        LoaderTestUnsetEnvironmentVariable("XR_BEST_PRACTICES_FILE_NAME");
+        LoaderTestUnsetEnvironmentVariable("XR_TEST_RUNTIME_REFRESH_RATE");
+        CleanupEnvironmentVariables();
+    };
+
+    // xrLocateSpaces is only suggested where it is available.
+    LoaderTestHeadlessSession headless;
+    XrResult result =
+        LoaderTestCreateHeadlessSession(XR_API_VERSION_1_1, {"XR_APILAYER_KHRONOS_best_practices_validation"}, true, headless);
+    if (XR_ERROR_EXTENSION_NOT_PRESENT == result) {
+        unset_lint_variables();
+        SKIP("Skipped - runtime does not support " XR_MND_HEADLESS_EXTENSION_NAME);
+    }
+    REQUIRE(XR_SUCCESS == result);
+    XrInstance instance = headless.instance;
+    XrSession session = headless.session;
+
+    XrReferenceSpaceCreateInfo space_ci = {XR_TYPE_REFERENCE_SPACE_CREATE_INFO};
+    space_ci.poseInReferenceSpace.orientation.w = 1.0f;
+    space_ci.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL;
+    XrSpace local_space = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateReferenceSpace(session, &space_ci, &local_space));
+    space_ci.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_VIEW;
+    XrSpace view_space = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateReferenceSpace(session, &space_ci, &view_space));
+
+    XrSwapchainCreateInfo swapchain_ci = {XR_TYPE_SWAPCHAIN_CREATE_INFO};
+    swapchain_ci.usageFlags = XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT;
+    swapchain_ci.format = XR_SWAPCHAIN_FORMAT_R8G8B8A8_SRGB_TEST;
+    swapchain_ci.sampleCount = 1;
+    swapchain_ci.width = 16;
+    swapchain_ci.height = 16;
+    swapchain_ci.faceCount = 1;
+    swapchain_ci.arraySize = 1;
+    swapchain_ci.mipCount = 1;
+    XrSwapchain swapchain = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateSwapchain(session, &swapchain_ci, &swapchain));
+
+    XrCompositionLayerQuad quad = {XR_TYPE_COMPOSITION_LAYER_QUAD};
+    quad.space = local_space;
+    quad.eyeVisibility = XR_EYE_VISIBILITY_BOTH;
+    quad.subImage.swapchain = swapchain;
+    quad.subImage.imageRect.extent = {16, 16};
+    quad.pose.orientation.w = 1.0f;
+    quad.pose.position.z = -1.0f;
+    quad.size = {1.0f, 1.0f};
+    const XrCompositionLayerBaseHeader* layers[] = {reinterpret_cast<const XrCompositionLayerBaseHeader*>(&quad)};
+
+    constexpr XrDuration period = 10000000;  // 100 Hz
+    auto run_frame = [&](bool late, uint32_t locate_count, bool submit_quad) {
+        XrFrameState frame_state = {XR_TYPE_FRAME_STATE};
+        REQUIRE(XR_SUCCESS == xrWaitFrame(session, nullptr, &frame_state));
+        if (late) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(2 * period));
+        }
+        REQUIRE(XR_SUCCESS == xrBeginFrame(session, nullptr));
+        for (uint32_t i = 0; i < locate_count; ++i) {
+            XrSpaceLocation location = {XR_TYPE_SPACE_LOCATION};
+            REQUIRE(XR_SUCCESS == xrLocateSpace(view_space, local_space, frame_state.predictedDisplayTime, &location));
+        }
+        XrFrameEndInfo end_info = {XR_TYPE_FRAME_END_INFO};
+        end_info.displayTime = frame_state.predictedDisplayTime;
+        end_info.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+        if (submit_quad) {
+            // The same image rendered again every frame.
+            uint32_t index = 0;
+            REQUIRE(XR_SUCCESS == xrAcquireSwapchainImage(swapchain, nullptr, &index));
+            XrSwapchainImageWaitInfo wait_info = {XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO};
+            wait_info.timeout = XR_INFINITE_DURATION;
+            REQUIRE(XR_SUCCESS == xrWaitSwapchainImage(swapchain, &wait_info));
+            REQUIRE(XR_SUCCESS == xrReleaseSwapchainImage(swapchain, nullptr));
+            end_info.layerCount = 1;
+            end_info.layers = layers;
+        }
+        REQUIRE(XR_SUCCESS == xrEndFrame(session, &end_info));
+    };
+
+    run_frame(false, 0, false);
+    run_frame(true, 0, false);
+    // Four calls are still fine, five could have been one xrLocateSpaces call.
+    run_frame(false, 4, false);
+    run_frame(false, 5, false);
+    // Reported after the layer was submitted unchanged and rendered again for 90 frames after the first one.
+    for (int frame = 0; frame < 91; ++frame) {
+        run_frame(false, 0, true);
+    }
+
+    CHECK(XR_SUCCESS == xrDestroyInstance(instance));
+
+    // Each message starts with its name in brackets; the summary written at the end lists the names without them.
+    auto count_messages = [](const std::string& name) {
+        std::ifstream output("best_practices.txt");
+        uint32_t count = 0;
+        for (std::string line; std::getline(output, line);) {
+            if (line.compare(0, name.size() + 2, "[" + name + "]") == 0) {
+                count++;
+            }
+        }
+        return count;
+    };
+    CHECK(1 == count_messages("BestPractices-Perf-LateBeginFrame"));
+    CHECK(1 == count_messages("BestPractices-Perf-LocateSpaceNotBatched"));
+    CHECK(1 == count_messages("BestPractices-Perf-UnchangedQuadLayer"));
+
+    // Cleanup
+    unset_lint_variables();
+}
+
+// The api_stats layer writes a table of the calls made since xrCreateInstance when the instance is destroyed.
+TEST_CASE("TestApiStatsLayer", "") {
+    if (!g_has_installed_runtime) {
+        SKIP("Skipped - no runtime installed");
+    }
+
+    LoaderTestSetEnvironmentVariable("XR_API_LAYER_PATH", "./resources/layers");
+    std::remove("api_stats.txt");
+    LoaderTestSetEnvironmentVariable("XR_API_STATS_FILE", "api_stats.txt");
+    // Only the final table, no periodic ones.
+    LoaderTestSetEnvironmentVariable("XR_API_STATS_INTERVAL_MS", "0");
+    auto unset_stats_variables = []() {
+        LoaderTestUnsetEnvironmentVariable("XR_API_STATS_FILE");
+        LoaderTestUnsetEnvironmentVariable("XR_API_STATS_INTERVAL_MS");
+        CleanupEnvironmentVariables();
+    };
+
+    LoaderTestHeadlessSession headless;
+    XrResult result = LoaderTestCreateHeadlessSession(XR_API_VERSION_1_0, {"XR_APILAYER_KHRONOS_api_stats"}, true, headless);
+    if (XR_ERROR_EXTENSION_NOT_PRESENT == result) {
+        unset_stats_variables();
+        SKIP("Skipped - runtime does not support " XR_MND_HEADLESS_EXTENSION_NAME);
+    }
+    REQUIRE(XR_SUCCESS == result);
+    XrInstance instance = headless.instance;
+    XrSession session = headless.session;
+
+    // test_runtime only has head mounted displays, so this call fails.
+    XrSystemGetInfo system_get_info = {XR_TYPE_SYSTEM_GET_INFO};
+    system_get_info.formFactor = XR_FORM_FACTOR_HANDHELD_DISPLAY;
+    XrSystemId system_id = XR_NULL_SYSTEM_ID;
+    CHECK(XR_ERROR_FORM_FACTOR_UNSUPPORTED == xrGetSystem(instance, &system_get_info, &system_id));
+
+    XrReferenceSpaceCreateInfo space_ci = {XR_TYPE_REFERENCE_SPACE_CREATE_INFO};
+    space_ci.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL;
+    space_ci.poseInReferenceSpace.orientation.w = 1.0f;
+    XrSpace local_space = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateReferenceSpace(session, &space_ci, &local_space));
+    space_ci.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_VIEW;
+    XrSpace view_space = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateReferenceSpace(session, &space_ci, &view_space));
+
+    constexpr uint64_t frame_count = 5;
+    constexpr uint64_t locates_per_frame = 3;
+    for (uint64_t frame = 0; frame < frame_count; ++frame) {
+        XrFrameState frame_state = {XR_TYPE_FRAME_STATE};
+        REQUIRE(XR_SUCCESS == xrWaitFrame(session, nullptr, &frame_state));
+        REQUIRE(XR_SUCCESS == xrBeginFrame(session, nullptr));
+        for (uint64_t i = 0; i < locates_per_frame; ++i) {
+            XrSpaceLocation location = {XR_TYPE_SPACE_LOCATION};
+            REQUIRE(XR_SUCCESS == xrLocateSpace(view_space, local_space, frame_state.predictedDisplayTime, &location));
+        }
+        XrFrameEndInfo end_info = {XR_TYPE_FRAME_END_INFO};
+        end_info.displayTime = frame_state.predictedDisplayTime;
+        end_info.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+        REQUIRE(XR_SUCCESS == xrEndFrame(session, &end_info));
+    }
+
+    CHECK(XR_SUCCESS == xrDestroyInstance(instance));
+
+    struct StatsRow {
+        uint64_t calls;
+        uint64_t failed;
+        double total_ms;
+        double p50_us;
+        double p99_us;
+        double p999_us;
+    };
+    std::map<std::string, StatsRow> rows;
+    std::vector<double> total_ms_in_order;
+    uint32_t tables = 0;
+    std::ifstream output("api_stats.txt");
+    for (std::string line; std::getline(output, line);) {
+        if (line.rfind("==== OpenXR API statistics, since xrCreateInstance (", 0) == 0) {
+            tables++;
+            continue;
+        }
+        if (line.rfind("xr", 0) != 0) {
+            continue;
+        }
+        // command, calls, calls/s, failed, total ms, mean us, p50 us, p99 us, p99.9 us
+        std::istringstream fields(line);
+        std::string command;
+        double calls_per_s = 0.0;
+        double mean_us = 0.0;
+        StatsRow row{};
+        fields >> command >> row.calls >> calls_per_s >> row.failed >> row.total_ms >> mean_us >> row.p50_us >> row.p99_us >>
+            row.p999_us;
+        REQUIRE(!fields.fail());
+        rows[command] = row;
+        total_ms_in_order.push_back(row.total_ms);
+    }
+    CHECK(1 == tables);
+
+    // Calls made before xrCreateInstance returned are not counted; xrGetSystem was also called once to create the session.
+    CHECK(0 == rows.count("xrCreateInstance"));
+    REQUIRE(1 == rows.count("xrGetSystem"));
+    CHECK(2 == rows["xrGetSystem"].calls);
+    CHECK(1 == rows["xrGetSystem"].failed);
+    for (const char* command : {"xrWaitFrame", "xrBeginFrame", "xrEndFrame"}) {
+        INFO(command);
+        REQUIRE(1 == rows.count(command));
+        CHECK(frame_count == rows[command].calls);
+        CHECK(0 == rows[command].failed);
+    }
+    REQUIRE(1 == rows.count("xrLocateSpace"));
+    CHECK(frame_count * locates_per_frame == rows["xrLocateSpace"].calls);
+    for (const auto& row : rows) {
+        INFO(row.first);
+        CHECK(row.second.p50_us <= row.second.p99_us);
+        CHECK(row.second.p99_us <= row.second.p999_us);
+    }
+    // The commands that took the most time come first.
+    CHECK(std::is_sorted(total_ms_in_order.rbegin(), total_ms_in_order.rend()));
+
+    // Cleanup
+    unset_stats_variables();
+}
+
+#if defined(XR_OS_LINUX) || defined(XR_OS_APPLE)
+// The frame timing layer publishes the statistics of each session and a record of each frame in shared memory, which
+// this process maps the same way xr_frame_monitor does.
+TEST_CASE("TestFrameTimingSharedMemory", "") {
+    if (!g_has_installed_runtime) {
+        SKIP("Skipped - no runtime installed");
+    }
+
+    LoaderTestSetEnvironmentVariable("XR_API_LAYER_PATH", "./resources/layers");
+    // Missed frames and jitter are only measured against a display period, which is 0 without pacing.
+    LoaderTestSetEnvironmentVariable("XR_TEST_RUNTIME_REFRESH_RATE", "100");
+
+    LoaderTestHeadlessSession headless;
+    XrResult result = LoaderTestCreateHeadlessSession(XR_API_VERSION_1_0, {"XR_APILAYER_KHRONOS_frame_timing"}, true, headless);
+    if (XR_ERROR_EXTENSION_NOT_PRESENT == result) {
+        LoaderTestUnsetEnvironmentVariable("XR_TEST_RUNTIME_REFRESH_RATE");
+        CleanupEnvironmentVariables();
+        SKIP("Skipped - runtime does not support " XR_MND_HEADLESS_EXTENSION_NAME);
+    }
+    REQUIRE(XR_SUCCESS == result);
+    XrInstance instance = headless.instance;
+    XrSession session = headless.session;
+
+    const std::string shm_name = FRAME_TIMING_SHM_PREFIX + std::to_string(getpid());
+    int fd = shm_open(shm_name.c_str(), O_RDONLY, 0);
+    REQUIRE(fd >= 0);
+    void* memory = mmap(nullptr, sizeof(FrameTimingShm), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    REQUIRE(memory != MAP_FAILED);
+    const FrameTimingShm& shm = *static_cast<const FrameTimingShm*>(memory);
+
+    CHECK(0 == memcmp(shm.magic, kFrameTimingShmMagic, sizeof(kFrameTimingShmMagic)));
+    CHECK(FRAME_TIMING_SHM_VERSION == shm.version);
+    CHECK(static_cast<uint32_t>(getpid()) == shm.process_id);
+    CHECK(kFrameTimingRingSize == shm.ring_size);
+    CHECK(kFrameTimingMaxSessions == shm.max_sessions);
+    CHECK(std::string("Loader Test") == shm.application_name);
+    CHECK(0 == shm.records_written.load());
+
+    constexpr XrDuration period = 10000000;  // 100 Hz
+    constexpr uint32_t frame_count = 8;
+    constexpr uint32_t skipped_frame = 4;
+    XrTime last_display_time = 0;
+    for (uint32_t frame = 1; frame <= frame_count; ++frame) {
+        XrFrameState frame_state = {XR_TYPE_FRAME_STATE};
+        REQUIRE(XR_SUCCESS == xrWaitFrame(session, nullptr, &frame_state));
+        REQUIRE(XR_SUCCESS == xrBeginFrame(session, nullptr));
+        XrFrameEndInfo end_info = {XR_TYPE_FRAME_END_INFO};
+        end_info.displayTime = frame_state.predictedDisplayTime;
+        end_info.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+        REQUIRE(XR_SUCCESS == xrEndFrame(session, &end_info));
+        if (frame == skipped_frame) {
+            // The next xrWaitFrame returns at least one display period later than it would have.
+            std::this_thread::sleep_for(std::chrono::nanoseconds(2 * period));
+        }
+        last_display_time = frame_state.predictedDisplayTime;
+    }
+
+    // Each frame reached xrEndFrame and was recorded in the order of its frame index.
+    REQUIRE(frame_count == shm.records_written.load());
+    uint32_t missed_frames = 0;
+    for (uint32_t i = 0; i < frame_count; ++i) {
+        INFO("Record " << i);
+        FrameTimingRecord record;
+        REQUIRE(FrameTimingRead(shm.ring[i], record));
+        CHECK(0 == record.session_slot);
+        CHECK(i + 1 == record.frame_index);
+        CHECK(record.wait_entry_ns <= record.wait_exit_ns);
+        CHECK(record.wait_exit_ns <= record.begin_ns);
+        CHECK(record.begin_ns <= record.end_ns);
+        CHECK(period == record.predicted_display_period);
+        if (i == 0) {
+            CHECK(0 == record.jitter_ns);
+        }
+        if (i == frame_count - 1) {
+            CHECK(last_display_time == record.predicted_display_time);
+        }
+        missed_frames += record.missed_frames;
+    }
+    CHECK(missed_frames >= 1);
+
+    FrameTimingSessionStats stats;
+    REQUIRE(FrameTimingRead(shm.sessions[0], stats));
+    CHECK(1 == stats.active);
+    CHECK(reinterpret_cast<uint64_t>(session) == stats.session_handle);
+    CHECK(frame_count == stats.frames);
+    CHECK(missed_frames == stats.missed_frames);
+    CHECK(period == stats.last_predicted_display_period);
+    CHECK(stats.mean_cpu_frame_ns > 0);
+    for (const FrameTimingHistogram* histogram : {&stats.cpu_frame, &stats.wait, &stats.render, &stats.abs_jitter}) {
+        uint64_t counted = 0;
+        for (uint64_t bin : histogram->bins) {
+            counted += bin;
+        }
+        CHECK(frame_count == counted);
+        CHECK(histogram->bin_width_ns > 0);
+    }
+
+    // The statistics of a destroyed session stay readable.
+    CHECK(XR_SUCCESS == xrDestroySession(session));
+    REQUIRE(FrameTimingRead(shm.sessions[0], stats));
+    CHECK(0 == stats.active);
+    CHECK(frame_count == stats.frames);
+
+    munmap(memory, sizeof(FrameTimingShm));
+    CHECK(XR_SUCCESS == xrDestroyInstance(instance));
+
+    // The block is removed with the instance.
+    fd = shm_open(shm_name.c_str(), O_RDONLY, 0);
+    CHECK(fd < 0);
+    if (fd >= 0) {
+        close(fd);
+    }
+
+    // Cleanup
+    LoaderTestUnsetEnvironmentVariable("XR_TEST_RUNTIME_REFRESH_RATE");
+    CleanupEnvironmentVariables();
+}
+#endif  // defined(XR_OS_LINUX) || defined(XR_OS_APPLE)
+
+#if defined(XR_REPLAY_PATH)
+// A session recorded by the capture layer must replay on the same runtime with xr_replay: every recorded call
+// is made again, and each one succeeds or fails as it did when captured.
+TEST_CASE("TestCaptureReplay", "") {
+    if (!g_has_installed_runtime) {
+        SKIP("Skipped - no runtime installed");
+    }
+
+    LoaderTestSetEnvironmentVariable("XR_API_LAYER_PATH", "./resources/layers");
+    std::remove("capture_replay.trace");
+    LoaderTestSetEnvironmentVariable("XR_CAPTURE_FILE_NAME", "capture_replay.trace");
+
+    LoaderTestHeadlessSession headless;
+    XrResult result = LoaderTestCreateHeadlessSession(XR_API_VERSION_1_0, {"XR_APILAYER_KHRONOS_capture"}, true, headless);
+    if (XR_ERROR_EXTENSION_NOT_PRESENT == result) {
+        LoaderTestUnsetEnvironmentVariable("XR_CAPTURE_FILE_NAME");
+        CleanupEnvironmentVariables();
+        SKIP("Skipped - runtime does not support " XR_MND_HEADLESS_EXTENSION_NAME);
+    }
+    REQUIRE(XR_SUCCESS == result);
+    XrInstance instance = headless.instance;
+    XrSession session = headless.session;
+
+    XrReferenceSpaceCreateInfo space_ci = {XR_TYPE_REFERENCE_SPACE_CREATE_INFO};
+    space_ci.poseInReferenceSpace.orientation.w = 1.0f;
+    space_ci.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL;
+    XrSpace local_space = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateReferenceSpace(session, &space_ci, &local_space));
+    space_ci.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_VIEW;
+    XrSpace view_space = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateReferenceSpace(session, &space_ci, &view_space));
+
+    constexpr uint64_t frame_count = 5;
+    XrFrameEndInfo end_info = {XR_TYPE_FRAME_END_INFO};
+    end_info.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+    for (uint64_t frame = 0; frame < frame_count; ++frame) {
+        XrFrameState frame_state = {XR_TYPE_FRAME_STATE};
+        REQUIRE(XR_SUCCESS == xrWaitFrame(session, nullptr, &frame_state));
+        REQUIRE(XR_SUCCESS == xrBeginFrame(session, nullptr));
+        XrSpaceLocation location = {XR_TYPE_SPACE_LOCATION};
+        REQUIRE(XR_SUCCESS == xrLocateSpace(view_space, local_space, frame_state.predictedDisplayTime, &location));
+        end_info.displayTime = frame_state.predictedDisplayTime;
+        REQUIRE(XR_SUCCESS == xrEndFrame(session, &end_info));
+    }
+    // Fails, and must fail again in the replay.
+    CHECK(XR_ERROR_CALL_ORDER_INVALID == xrEndFrame(session, &end_info));
+
+    REQUIRE(XR_SUCCESS == xrRequestExitSession(session));
+    REQUIRE(XR_SUCCESS == xrEndSession(session));
+    CHECK(XR_SUCCESS == xrDestroyInstance(instance));
+
+    {
+        std::ifstream trace("capture_replay.trace", std::ios::binary);
+        char magic[8] = {};
+        REQUIRE(trace.read(magic, sizeof(magic)));
+        CHECK(0 == memcmp(magic, "XRTRACE", sizeof(magic)));
+    }
+
+    std::remove("capture_replay.txt");
+    std::string command = std::string("\"") + XR_REPLAY_PATH + "\" capture_replay.trace > capture_replay.txt";
+#if defined(_WIN32)
+    // cmd.exe drops the outer quotes when the command starts with one.
+    command = "\"" + command + "\"";
+#endif
+    REQUIRE(0 == std::system(command.c_str()));
+
+    // One line per replayed command: its name, the number of calls, six latencies and the result mismatches.
+    std::map<std::string, std::pair<uint64_t, uint64_t>> replayed;
+    std::ifstream report("capture_replay.txt");
+    for (std::string line; std::getline(report, line);) {
+        if (line.compare(0, 2, "xr") != 0) {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string name;
+        uint64_t calls = 0;
+        double latency = 0.0;
+        uint64_t mismatches = 0;
+        fields >> name >> calls;
+        for (int i = 0; i < 6; ++i) {
+            fields >> latency;
+        }
+        fields >> mismatches;
+        REQUIRE(fields);
+        replayed[name] = {calls, mismatches};
+    }
+    auto calls = [&](const std::string& name) {
+        auto it = replayed.find(name);
+        return it != replayed.end() ? it->second.first : 0;
+    };
+    CHECK(1 == calls("xrCreateInstance"));
+    CHECK(1 == calls("xrCreateSession"));
+    CHECK(1 == calls("xrBeginSession"));
+    CHECK(2 == calls("xrCreateReferenceSpace"));
+    CHECK(frame_count == calls("xrWaitFrame"));
+    CHECK(frame_count == calls("xrBeginFrame"));
+    CHECK(frame_count + 1 == calls("xrEndFrame"));
+    CHECK(frame_count == calls("xrLocateSpace"));
+    CHECK(1 == calls("xrEndSession"));
+    CHECK(1 == calls("xrDestroyInstance"));
+    for (const auto& entry : replayed) {
+        INFO(entry.first);
+        CHECK(0 == entry.second.second);
+    }
+
+    // Cleanup
+    LoaderTestUnsetEnvironmentVariable("XR_CAPTURE_FILE_NAME");
+    CleanupEnvironmentVariables();
+}
+#endif  // defined(XR_REPLAY_PATH)
+
+// Core validation must reject a handle once it is destroyed.  With handle wrapping, that must hold even
+// after another handle of the same type is created, which could otherwise get the destroyed one's wrapper.
+TEST_CASE("TestCoreValidationDestroyedHandle", "") {
+    if (!g_has_installed_runtime) {
+        SKIP("Skipped - no runtime installed");
+    }
+
+    LoaderTestSetEnvironmentVariable("XR_API_LAYER_PATH", "./resources/layers");
+    LoaderTestSetEnvironmentVariable("XR_CORE_VALIDATION_EXPORT_TYPE", "none");
+
+    LoaderTestHeadlessSession headless;
+    XrResult result = LoaderTestCreateHeadlessSession(XR_API_VERSION_1_0, {"XR_APILAYER_LUNARG_core_validation"}, true, headless);
+    if (XR_ERROR_EXTENSION_NOT_PRESENT == result) {
+        LoaderTestUnsetEnvironmentVariable("XR_CORE_VALIDATION_EXPORT_TYPE");
+        CleanupEnvironmentVariables();
+        SKIP("Skipped - runtime does not support " XR_MND_HEADLESS_EXTENSION_NAME);
+    }
+    REQUIRE(XR_SUCCESS == result);
+    XrInstance instance = headless.instance;
+    XrSession session = headless.session;
+
+    XrReferenceSpaceCreateInfo space_ci = {XR_TYPE_REFERENCE_SPACE_CREATE_INFO};
+    space_ci.poseInReferenceSpace.orientation.w = 1.0f;
+    space_ci.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL;
+    XrSpace base_space = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateReferenceSpace(session, &space_ci, &base_space));
+    space_ci.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_VIEW;
+    XrSpace destroyed_space = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateReferenceSpace(session, &space_ci, &destroyed_space));
+
+    XrSpaceLocation location = {XR_TYPE_SPACE_LOCATION};
+    CHECK(XR_SUCCESS == xrLocateSpace(destroyed_space, base_space, 1, &location));
+    REQUIRE(XR_SUCCESS == xrDestroySpace(destroyed_space));
+    CHECK(XR_ERROR_HANDLE_INVALID == xrLocateSpace(destroyed_space, base_space, 1, &location));
+
+#if defined(XR_CORE_VALIDATION_WRAP_HANDLES)
+    // The runtime may well give the new spaces the destroyed one's address, but the layer must not give
+    // them its wrapper.
+    std::vector<XrSpace> spaces(16, XR_NULL_HANDLE);
+    for (XrSpace& space : spaces) {
+        REQUIRE(XR_SUCCESS == xrCreateReferenceSpace(session, &space_ci, &space));
+        CHECK(destroyed_space != space);
+        CHECK(XR_ERROR_HANDLE_INVALID == xrLocateSpace(destroyed_space, base_space, 1, &location));
+        CHECK(XR_SUCCESS == xrLocateSpace(space, base_space, 1, &location));
+        REQUIRE(XR_SUCCESS == xrDestroySpace(space));
+    }
+#endif
+
+    CHECK(XR_SUCCESS == xrDestroyInstance(instance));
+
+    // Cleanup
+    LoaderTestUnsetEnvironmentVariable("XR_CORE_VALIDATION_EXPORT_TYPE");
+    CleanupEnvironmentVariables();
+}
+
+// Core validation tiers.  A sampled command fully validates its first calls and then one call in every interval,
+// and a structural command does not validate next chains.  Invalid structures that test_runtime happens to
+// accept show which calls were validated: those fail or are reported, the others reach the runtime and succeed.
+// (An invalid handle would show it as well, but test_runtime dereferences the handles of the calls let through.)
+TEST_CASE("TestCoreValidationTiers", "") {
+    if (!g_has_installed_runtime) {
+        SKIP("Skipped - no runtime installed");
+    }
+
+    LoaderTestSetEnvironmentVariable("XR_API_LAYER_PATH", "./resources/layers");
+    // The text output is appended to.
+    std::remove("core_validation_tiers.txt");
+    LoaderTestSetEnvironmentVariable("XR_CORE_VALIDATION_FILE_NAME", "core_validation_tiers.txt");
+    LoaderTestSetEnvironmentVariable("XR_CORE_VALIDATION_DUPLICATE_LIMIT", "0");
+    LoaderTestSetEnvironmentVariable("XR_CORE_VALIDATION_TIER", "xrLocateSpace=sampled, xrWaitFrame=structural");
+    LoaderTestSetEnvironmentVariable("XR_CORE_VALIDATION_SAMPLE_FIRST", "2");
+    LoaderTestSetEnvironmentVariable("XR_CORE_VALIDATION_SAMPLE_INTERVAL", "3");
+    auto unset_tier_variables = []() {
+        LoaderTestUnsetEnvironmentVariable("XR_CORE_VALIDATION_FILE_NAME");
+        LoaderTestUnsetEnvironmentVariable("XR_CORE_VALIDATION_DUPLICATE_LIMIT");
+        LoaderTestUnsetEnvironmentVariable("XR_CORE_VALIDATION_TIER");
+        LoaderTestUnsetEnvironmentVariable("XR_CORE_VALIDATION_SAMPLE_FIRST");
+        LoaderTestUnsetEnvironmentVariable("XR_CORE_VALIDATION_SAMPLE_INTERVAL");
+        CleanupEnvironmentVariables();
+    };
+
+    LoaderTestHeadlessSession headless;
+    XrResult result = LoaderTestCreateHeadlessSession(XR_API_VERSION_1_0, {"XR_APILAYER_LUNARG_core_validation"}, true, headless);
+    if (XR_ERROR_EXTENSION_NOT_PRESENT == result) {
+        unset_tier_variables();
+        SKIP("Skipped - runtime does not support " XR_MND_HEADLESS_EXTENSION_NAME);
+    }
+    REQUIRE(XR_SUCCESS == result);
+    XrInstance instance = headless.instance;
+    XrSession session = headless.session;
+
+    XrReferenceSpaceCreateInfo space_ci = {XR_TYPE_REFERENCE_SPACE_CREATE_INFO};
+    space_ci.poseInReferenceSpace.orientation.w = 1.0f;
+    space_ci.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL;
+    XrSpace base_space = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateReferenceSpace(session, &space_ci, &base_space));
+    space_ci.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_VIEW;
+    XrSpace view_space = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateReferenceSpace(session, &space_ci, &view_space));
+
+    // XrSpaceVelocity may extend XrSpaceLocation, but not XrFrameState.
+    XrSpaceVelocity velocity = {XR_TYPE_SPACE_VELOCITY};
+    XrFrameState frame_state = {XR_TYPE_FRAME_STATE};
+    frame_state.next = &velocity;
+    for (int frame = 0; frame < 3; ++frame) {
+        CHECK(XR_SUCCESS == xrWaitFrame(session, nullptr, &frame_state));
+        frame_state.type = XR_TYPE_FRAME_STATE;
+    }
+
+    // The structure type is checked by the structural depth too, so it tells skipped calls from the others.
+    XrSpaceLocation location = {XR_TYPE_SPACE_VELOCITY};
+    for (int call = 0; call < 11; ++call) {
+        INFO("call " << call);
+        const bool validated = call < 2 || (call - 2) % 3 == 0;
+#if defined(XR_CORE_VALIDATION_WRAP_HANDLES)
+        // Calls that are not sampled still get the structural depth, since their handles have to be unwrapped.
+        (void)validated;
+        CHECK(XR_ERROR_VALIDATION_FAILURE == xrLocateSpace(view_space, base_space, frame_state.predictedDisplayTime, &location));
+#else
+        CHECK((validated ? XR_ERROR_VALIDATION_FAILURE : XR_SUCCESS) ==
+              xrLocateSpace(view_space, base_space, frame_state.predictedDisplayTime, &location));
+#endif
+        location.type = XR_TYPE_SPACE_VELOCITY;
+    }
+
+    // Commands left at the full tier still validate every next chain.
+    XrFrameBeginInfo begin_info = {XR_TYPE_FRAME_BEGIN_INFO};
+    begin_info.next = &velocity;
+    CHECK(XR_SUCCESS == xrBeginFrame(session, &begin_info));
+
+    CHECK(XR_SUCCESS == xrDestroyInstance(instance));
+
+    // Unknown structures in a next chain are only reported, so the output tells which chains were validated.
+    auto count_messages = [](const std::string& message_id) {
+        std::ifstream output("core_validation_tiers.txt");
+        uint32_t count = 0;
+        for (std::string line; std::getline(output, line);) {
+            if (line.find(message_id) != std::string::npos) {
+                count++;
+            }
+        }
+        return count;
+    };
+    CHECK(0 == count_messages("VUID-XrFrameState-next-unknown"));
+    CHECK(1 == count_messages("VUID-XrFrameBeginInfo-next-unknown"));
+#if !defined(XR_CORE_VALIDATION_WRAP_HANDLES)
+    CHECK(5 == count_messages("VUID-XrSpaceLocation-type-type"));
+#endif
+
+    // Cleanup
+    unset_tier_variables();
+}
+
+#if !defined(XR_CORE_VALIDATION_WRAP_HANDLES)
+// With XR_CORE_VALIDATION_DEFERRED, the per-frame commands reach the runtime at once and are validated later on
+// the layer's own thread.  The errors must still be reported, each naming the thread that made the call and its
+// place among the deferred calls.
+TEST_CASE("TestCoreValidationDeferred", "") {
+    if (!g_has_installed_runtime) {
+        SKIP("Skipped - no runtime installed");
+    }
+
+    LoaderTestSetEnvironmentVariable("XR_API_LAYER_PATH", "./resources/layers");
+    // The text output is appended to.
+    std::remove("core_validation_deferred.txt");
+    LoaderTestSetEnvironmentVariable("XR_CORE_VALIDATION_FILE_NAME", "core_validation_deferred.txt");
+    LoaderTestSetEnvironmentVariable("XR_CORE_VALIDATION_DEFERRED", "1");
+    auto unset_deferred_variables = []() {
+        LoaderTestUnsetEnvironmentVariable("XR_CORE_VALIDATION_FILE_NAME");
+        LoaderTestUnsetEnvironmentVariable("XR_CORE_VALIDATION_DEFERRED");
+        CleanupEnvironmentVariables();
+    };
+
+    LoaderTestHeadlessSession headless;
+    XrResult result = LoaderTestCreateHeadlessSession(XR_API_VERSION_1_0, {"XR_APILAYER_LUNARG_core_validation"}, true, headless);
+    if (XR_ERROR_EXTENSION_NOT_PRESENT == result) {
+        unset_deferred_variables();
+        SKIP("Skipped - runtime does not support " XR_MND_HEADLESS_EXTENSION_NAME);
+    }
+    REQUIRE(XR_SUCCESS == result);
+    XrInstance instance = headless.instance;
+    XrSession session = headless.session;
+
+    XrReferenceSpaceCreateInfo space_ci = {XR_TYPE_REFERENCE_SPACE_CREATE_INFO};
+    space_ci.poseInReferenceSpace.orientation.w = 1.0f;
+    space_ci.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL;
+    XrSpace base_space = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateReferenceSpace(session, &space_ci, &base_space));
+    space_ci.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_VIEW;
+    XrSpace view_space = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateReferenceSpace(session, &space_ci, &view_space));
+
+    // test_runtime ignores the structure type, so these calls only fail once validated.
+    auto locate_with_wrong_type = [&]() {
+        XrSpaceLocation location = {XR_TYPE_SPACE_VELOCITY};
+        return xrLocateSpace(view_space, base_space, 1, &location);
+    };
+    std::ostringstream main_thread;
+    main_thread << std::this_thread::get_id();
+    CHECK(XR_SUCCESS == locate_with_wrong_type());
+    std::ostringstream worker_thread;
+    XrResult worker_result = XR_ERROR_RUNTIME_FAILURE;
+    std::thread worker([&]() {
+        worker_thread << std::this_thread::get_id();
+        worker_result = locate_with_wrong_type();
+    });
+    worker.join();
+    CHECK(XR_SUCCESS == worker_result);
+
+    // Destroying the instance validates whatever is still queued.
+    CHECK(XR_SUCCESS == xrDestroyInstance(instance));
+
+    // Each report ends with " (deferred call <sequence> from thread <id>)".
+    std::vector<std::pair<uint64_t, std::string>> deferred_errors;
+    std::ifstream output("core_validation_deferred.txt");
+    const std::string marker = " (deferred call ";
+    for (std::string line; std::getline(output, line);) {
+        const size_t pos = line.find(marker);
+        if (line.find("VUID-XrSpaceLocation-type-type") == std::string::npos || pos == std::string::npos) {
+            continue;
+        }
+        std::istringstream fields(line.substr(pos + marker.size()));
+        uint64_t sequence = 0;
+        std::string from;
+        std::string thread_word;
+        std::string thread;
+        fields >> sequence >> from >> thread_word >> thread;
+        REQUIRE(!thread.empty());
+        REQUIRE(')' == thread.back());
+        thread.pop_back();
+        deferred_errors.emplace_back(sequence, thread);
+    }
+    REQUIRE(2 == deferred_errors.size());
+    CHECK(deferred_errors[0].first < deferred_errors[1].first);
+    CHECK(main_thread.str() == deferred_errors[0].second);
+    CHECK(worker_thread.str() == deferred_errors[1].second);
+
+    // Cleanup
+    unset_deferred_variables();
+}
+#endif  // !defined(XR_CORE_VALIDATION_WRAP_HANDLES)
+
+// A headless session on test_runtime gets swapchains in host memory, so that a whole frame loop can run
+// without a GPU.
+TEST_CASE("TestCpuSwapchains", "") {
+    if (!g_has_installed_runtime) {
+        SKIP("Skipped - no runtime installed");
+    }
+
+    LoaderTestSetEnvironmentVariable("XR_TEST_RUNTIME_SWAPCHAIN_IMAGE_COUNT", "2");
+
+    LoaderTestHeadlessSession headless;
+    XrResult result = LoaderTestCreateHeadlessSession(XR_API_VERSION_1_0, {}, true, headless);
+    if (XR_ERROR_EXTENSION_NOT_PRESENT == result) {
+        LoaderTestUnsetEnvironmentVariable("XR_TEST_RUNTIME_SWAPCHAIN_IMAGE_COUNT");
+        CleanupEnvironmentVariables();
+        SKIP("Skipped - runtime does not support " XR_MND_HEADLESS_EXTENSION_NAME);
+    }
+    REQUIRE(XR_SUCCESS == result);
+    XrInstance instance = headless.instance;
+    XrSession session = headless.session;
+
+    uint32_t format_count = 0;
+    REQUIRE(XR_SUCCESS == xrEnumerateSwapchainFormats(session, 0, &format_count, nullptr));
+    std::vector<int64_t> formats(format_count);
+    REQUIRE(XR_SUCCESS == xrEnumerateSwapchainFormats(session, format_count, &format_count, formats.data()));
+    CHECK(std::find(formats.begin(), formats.end(), XR_SWAPCHAIN_FORMAT_R8G8B8A8_SRGB_TEST) != formats.end());
+
+    XrSwapchainCreateInfo swapchain_ci = {XR_TYPE_SWAPCHAIN_CREATE_INFO};
+    swapchain_ci.usageFlags = XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT;
+    swapchain_ci.format = XR_SWAPCHAIN_FORMAT_R8G8B8A8_SRGB_TEST;
+    swapchain_ci.sampleCount = 1;
+    swapchain_ci.width = 30;
+    swapchain_ci.height = 20;
+    swapchain_ci.faceCount = 1;
+    swapchain_ci.arraySize = 2;
+    swapchain_ci.mipCount = 1;
+
+    XrSwapchain swapchain = XR_NULL_HANDLE;
+    swapchain_ci.format = 0;
+    CHECK(XR_ERROR_SWAPCHAIN_FORMAT_UNSUPPORTED == xrCreateSwapchain(session, &swapchain_ci, &swapchain));
+    swapchain_ci.format = XR_SWAPCHAIN_FORMAT_R8G8B8A8_SRGB_TEST;
+    REQUIRE(XR_SUCCESS == xrCreateSwapchain(session, &swapchain_ci, &swapchain));
+
+    uint32_t image_count = 0;
+    REQUIRE(XR_SUCCESS == xrEnumerateSwapchainImages(swapchain, 0, &image_count, nullptr));
+    REQUIRE(2 == image_count);
+    std::vector<XrSwapchainImageCpuTEST> images(image_count, {XR_TYPE_SWAPCHAIN_IMAGE_CPU_TEST});
+    REQUIRE(XR_SUCCESS == xrEnumerateSwapchainImages(swapchain, image_count, &image_count,
+                                                     reinterpret_cast<XrSwapchainImageBaseHeader*>(images.data())));
+    for (const auto& image : images) {
+        CHECK(nullptr != image.data);
+        CHECK(0 == reinterpret_cast<uintptr_t>(image.data) % 64);
+        CHECK(128 == image.rowPitch);
+        CHECK(128 * 20 * 2 == image.size);
+    }
+
+    // Wait and release need an acquired image.
+    CHECK(XR_ERROR_CALL_ORDER_INVALID == xrWaitSwapchainImage(swapchain, nullptr));
+    CHECK(XR_ERROR_CALL_ORDER_INVALID == xrReleaseSwapchainImage(swapchain, nullptr));
+
+    for (uint32_t frame = 0; frame < 4; ++frame) {
+        XrFrameState frame_state = {XR_TYPE_FRAME_STATE};
+        REQUIRE(XR_SUCCESS == xrWaitFrame(session, nullptr, &frame_state));
+        CHECK(frame_state.shouldRender);
+        REQUIRE(XR_SUCCESS == xrBeginFrame(session, nullptr));
+
+        uint32_t index = UINT32_MAX;
+        REQUIRE(XR_SUCCESS == xrAcquireSwapchainImage(swapchain, nullptr, &index));
+        CHECK(frame % image_count == index);
+        XrSwapchainImageWaitInfo wait_info = {XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO};
+        wait_info.timeout = XR_INFINITE_DURATION;
+        REQUIRE(XR_SUCCESS == xrWaitSwapchainImage(swapchain, &wait_info));
+        CHECK(XR_ERROR_CALL_ORDER_INVALID == xrWaitSwapchainImage(swapchain, &wait_info));
+        memset(images[index].data, static_cast<int>(frame), static_cast<size_t>(images[index].size));
+        REQUIRE(XR_SUCCESS == xrReleaseSwapchainImage(swapchain, nullptr));
+
+        XrFrameEndInfo end_info = {XR_TYPE_FRAME_END_INFO};
+        end_info.displayTime = frame_state.predictedDisplayTime;
+        end_info.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+        REQUIRE(XR_SUCCESS == xrEndFrame(session, &end_info));
+    }
+
+    // Every image can be acquired at once, but no more.
+    uint32_t index = UINT32_MAX;
+    CHECK(XR_SUCCESS == xrAcquireSwapchainImage(swapchain, nullptr, &index));
+    CHECK(XR_SUCCESS == xrAcquireSwapchainImage(swapchain, nullptr, &index));
+    CHECK(XR_ERROR_CALL_ORDER_INVALID == xrAcquireSwapchainImage(swapchain, nullptr, &index));
+    CHECK(XR_SUCCESS == xrDestroySwapchain(swapchain));
+
+    // A static swapchain has one image, acquired once.
+    swapchain_ci.createFlags = XR_SWAPCHAIN_CREATE_STATIC_IMAGE_BIT;
+    REQUIRE(XR_SUCCESS == xrCreateSwapchain(session, &swapchain_ci, &swapchain));
+    REQUIRE(XR_SUCCESS == xrEnumerateSwapchainImages(swapchain, 0, &image_count, nullptr));
+    CHECK(1 == image_count);
+    CHECK(XR_SUCCESS == xrAcquireSwapchainImage(swapchain, nullptr, &index));
+    CHECK(XR_SUCCESS == xrWaitSwapchainImage(swapchain, nullptr));
+    CHECK(XR_SUCCESS == xrReleaseSwapchainImage(swapchain, nullptr));
+    CHECK(XR_ERROR_CALL_ORDER_INVALID == xrAcquireSwapchainImage(swapchain, nullptr, &index));
+
+    // Swapchains left alive are destroyed with the session.
+    CHECK(XR_SUCCESS == xrDestroyInstance(instance));
+
+    // Cleanup
+    LoaderTestUnsetEnvironmentVariable("XR_TEST_RUNTIME_SWAPCHAIN_IMAGE_COUNT");
+    CleanupEnvironmentVariables();
+}
+
+// With a refresh rate set, test_runtime paces xrWaitFrame to simulated vsyncs and reports the frame
+// statistics of the session when it ends.
+TEST_CASE("TestFramePacing", "") {
+    if (!g_has_installed_runtime) {
+        SKIP("Skipped - no runtime installed");
+    }
+
+    LoaderTestSetEnvironmentVariable("XR_TEST_RUNTIME_REFRESH_RATE", "100");
+    LoaderTestSetEnvironmentVariable("XR_TEST_RUNTIME_MISSED_FRAME_INTERVAL", "4");
+    std::remove("frame_stats.txt");
+    LoaderTestSetEnvironmentVariable("XR_TEST_RUNTIME_FRAME_STATS_FILE", "frame_stats.txt");
+
+    LoaderTestHeadlessSession headless;
+    XrResult result = LoaderTestCreateHeadlessSession(XR_API_VERSION_1_0, {}, true, headless);
+    if (XR_ERROR_EXTENSION_NOT_PRESENT == result) {
+        LoaderTestUnsetEnvironmentVariable("XR_TEST_RUNTIME_REFRESH_RATE");
+        LoaderTestUnsetEnvironmentVariable("XR_TEST_RUNTIME_MISSED_FRAME_INTERVAL");
+        LoaderTestUnsetEnvironmentVariable("XR_TEST_RUNTIME_FRAME_STATS_FILE");
+        CleanupEnvironmentVariables();
+        SKIP("Skipped - runtime does not support " XR_MND_HEADLESS_EXTENSION_NAME);
+    }
+    REQUIRE(XR_SUCCESS == result);
+    XrInstance instance = headless.instance;
+    XrSession session = headless.session;
+
+    constexpr XrDuration period = 10000000;  // 100 Hz
+    XrTime last_display_time = 0;
+    auto wait_frame = [&]() {
+        XrFrameState frame_state = {XR_TYPE_FRAME_STATE};
+        REQUIRE(XR_SUCCESS == xrWaitFrame(session, nullptr, &frame_state));
+        CHECK(period == frame_state.predictedDisplayPeriod);
+        CHECK(frame_state.shouldRender);
+        // Frames are shown on consecutive vsyncs or later ones, never twice on the same one.
+        if (last_display_time != 0) {
+            CHECK(frame_state.predictedDisplayTime > last_display_time);
+            CHECK(0 == (frame_state.predictedDisplayTime - last_display_time) % period);
+        }
+        last_display_time = frame_state.predictedDisplayTime;
+    };
+    XrFrameEndInfo end_info = {XR_TYPE_FRAME_END_INFO};
+    end_info.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+
+    CHECK(XR_ERROR_CALL_ORDER_INVALID == xrBeginFrame(session, nullptr));
+    CHECK(XR_ERROR_CALL_ORDER_INVALID == xrEndFrame(session, &end_info));
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < 8; ++frame) {
+        wait_frame();
+        REQUIRE(XR_SUCCESS == xrBeginFrame(session, nullptr));
+        end_info.displayTime = last_display_time;
+        REQUIRE(XR_SUCCESS == xrEndFrame(session, &end_info));
+    }
+    // xrWaitFrame blocked for vsyncs.  Only a loose bound: the first wait may return at once, and the
+    // display times checked above already tell how many vsyncs went by.
+    CHECK(std::chrono::steady_clock::now() - start >= std::chrono::nanoseconds(4 * period));
+
+    // A frame begun over another one discards it.
+    wait_frame();
+    REQUIRE(XR_SUCCESS == xrBeginFrame(session, nullptr));
+    wait_frame();
+    CHECK(XR_FRAME_DISCARDED == xrBeginFrame(session, nullptr));
+    end_info.displayTime = last_display_time;
+    REQUIRE(XR_SUCCESS == xrEndFrame(session, &end_info));
+
+    // A frame that takes more than a period to render is ended late, and the next one skips vsyncs.
+    wait_frame();
+    REQUIRE(XR_SUCCESS == xrBeginFrame(session, nullptr));
+    // Sleeping lasts at least this long, so the frame is late however the thread is scheduled.
+    std::this_thread::sleep_for(std::chrono::nanoseconds(3 * period));
+    end_info.displayTime = last_display_time;
+    REQUIRE(XR_SUCCESS == xrEndFrame(session, &end_info));
+    wait_frame();
+    REQUIRE(XR_SUCCESS == xrBeginFrame(session, nullptr));
+    end_info.displayTime = last_display_time;
+    REQUIRE(XR_SUCCESS == xrEndFrame(session, &end_info));
+
+    REQUIRE(XR_SUCCESS == xrRequestExitSession(session));
+    REQUIRE(XR_SUCCESS == xrEndSession(session));
+    CHECK(XR_SUCCESS == xrDestroyInstance(instance));
+
+    std::ifstream stats_file("frame_stats.txt");
+    std::string stats;
+    REQUIRE(std::getline(stats_file, stats));
+    INFO(stats);
+    auto stat = [&stats](const std::string& key) {
+        const size_t pos = stats.find(" " + key + "=");
+        REQUIRE(pos != std::string::npos);
+        return std::stoull(stats.substr(pos + key.size() + 2));
+    };
+    CHECK(12 == stat("frames_waited"));
+    CHECK(12 == stat("frames_begun"));
+    CHECK(11 == stat("frames_ended"));
+    CHECK(1 == stat("frames_discarded"));
+    CHECK(1 <= stat("late_end_frames"));
+    CHECK(1 <= stat("missed_vsyncs"));
+    CHECK(1 <= stat("skipped_vsyncs"));
+    // Reported once per session.
+    CHECK_FALSE(std::getline(stats_file, stats));
+
+    // Cleanup
+    LoaderTestUnsetEnvironmentVariable("XR_TEST_RUNTIME_REFRESH_RATE");
+    LoaderTestUnsetEnvironmentVariable("XR_TEST_RUNTIME_MISSED_FRAME_INTERVAL");
+    LoaderTestUnsetEnvironmentVariable("XR_TEST_RUNTIME_FRAME_STATS_FILE");
+    CleanupEnvironmentVariables();
+}
+
+TEST_CASE("TestTrajectoryPlayback", "") {
+    if (!g_has_installed_runtime) {
+        SKIP("Skipped - no runtime installed");
+    }
+
+    // Ten seconds of motion sampled every 10 ms.
+    constexpr XrDuration second = 1000000000;
+    REQUIRE(LoaderTestWriteTrajectoryFile("trajectory.bin", 1000, 10000000));
+
+    // A trajectory that cannot be read fails the session.
+    LoaderTestSetEnvironmentVariable("XR_TEST_RUNTIME_TRAJECTORY_FILE", "missing_trajectory.bin");
+    LoaderTestHeadlessSession headless;
+    XrResult result = LoaderTestCreateHeadlessSession(XR_API_VERSION_1_1, {}, true, headless);
+    if (XR_ERROR_EXTENSION_NOT_PRESENT == result) {
+        LoaderTestUnsetEnvironmentVariable("XR_TEST_RUNTIME_TRAJECTORY_FILE");
+        CleanupEnvironmentVariables();
+        SKIP("Skipped - runtime does not support " XR_MND_HEADLESS_EXTENSION_NAME);
+    }
+    CHECK(XR_ERROR_RUNTIME_FAILURE == result);
+
+    LoaderTestSetEnvironmentVariable("XR_TEST_RUNTIME_TRAJECTORY_FILE", "trajectory.bin");
+    REQUIRE(XR_SUCCESS == LoaderTestCreateHeadlessSession(XR_API_VERSION_1_1, {}, true, headless));
+    XrInstance instance = headless.instance;
+    XrSession session = headless.session;
+
+    XrReferenceSpaceCreateInfo space_ci = {XR_TYPE_REFERENCE_SPACE_CREATE_INFO};
+    space_ci.poseInReferenceSpace.orientation.w = 1.0f;
+    space_ci.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL;
+    XrSpace local_space = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateReferenceSpace(session, &space_ci, &local_space));
+    space_ci.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_VIEW;
+    XrSpace view_space = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateReferenceSpace(session, &space_ci, &view_space));
+
+    XrPath left_hand = XR_NULL_PATH;
+    XrPath right_hand = XR_NULL_PATH;
+    REQUIRE(XR_SUCCESS == xrStringToPath(instance, "/user/hand/left", &left_hand));
+    REQUIRE(XR_SUCCESS == xrStringToPath(instance, "/user/hand/right", &right_hand));
+    const XrPath hands[] = {left_hand, right_hand};
+
+    XrActionSetCreateInfo action_set_ci = {XR_TYPE_ACTION_SET_CREATE_INFO};
+    strcpy(action_set_ci.actionSetName, "trajectory");
+    strcpy(action_set_ci.localizedActionSetName, "Trajectory");
+    XrActionSet action_set = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateActionSet(instance, &action_set_ci, &action_set));
+    XrActionCreateInfo action_ci = {XR_TYPE_ACTION_CREATE_INFO};
+    action_ci.actionType = XR_ACTION_TYPE_POSE_INPUT;
+    action_ci.countSubactionPaths = 2;
+    action_ci.subactionPaths = hands;
+    strcpy(action_ci.actionName, "hand_aim");
+    strcpy(action_ci.localizedActionName, "Hand Aim");
+    XrAction aim_action = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateAction(action_set, &action_ci, &aim_action));
+    strcpy(action_ci.actionName, "hand_pose");
+    strcpy(action_ci.localizedActionName, "Hand Pose");
+    XrAction grip_action = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateAction(action_set, &action_ci, &grip_action));
+
+    XrActionSpaceCreateInfo action_space_ci = {XR_TYPE_ACTION_SPACE_CREATE_INFO};
+    action_space_ci.poseInActionSpace.orientation.w = 1.0f;
+    action_space_ci.action = aim_action;
+    action_space_ci.subactionPath = left_hand;
+    XrSpace left_aim_space = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateActionSpace(session, &action_space_ci, &left_aim_space));
+    action_space_ci.action = grip_action;
+    action_space_ci.subactionPath = right_hand;
+    XrSpace right_grip_space = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateActionSpace(session, &action_space_ci, &right_grip_space));
+    action_space_ci.subactionPath = XR_NULL_PATH;
+    XrSpace untracked_space = XR_NULL_HANDLE;
+    REQUIRE(XR_SUCCESS == xrCreateActionSpace(session, &action_space_ci, &untracked_space));
+
+    XrSpaceVelocity velocity = {XR_TYPE_SPACE_VELOCITY};
+    XrSpaceLocation location = {XR_TYPE_SPACE_LOCATION, &velocity};
+    auto locate = [&](XrSpace space, XrSpace base_space, XrTime time) {
+        REQUIRE(XR_SUCCESS == xrLocateSpace(space, base_space, time, &location));
+    };
+    const XrSpaceLocationFlags valid_and_tracked =
+        XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT |
+        XR_SPACE_LOCATION_POSITION_TRACKED_BIT;
+
+    // The head walks along -z at 1 m/s from the start of playback, which is when the session began.
+    XrFrameState frame_state = {XR_TYPE_FRAME_STATE};
+    REQUIRE(XR_SUCCESS == xrWaitFrame(session, nullptr, &frame_state));
+    locate(view_space, local_space, frame_state.predictedDisplayTime);
+    REQUIRE(valid_and_tracked == location.locationFlags);
+    const XrTime start = frame_state.predictedDisplayTime + static_cast<XrTime>(location.pose.position.z * second);
+
+    locate(view_space, local_space, start + 2 * second + second / 2);
+    CHECK(valid_and_tracked == location.locationFlags);
+    CHECK(location.pose.position.x == Catch::Approx(0.0f).margin(1e-4));
+    CHECK(location.pose.position.y == Catch::Approx(1.5f));
+    CHECK(location.pose.position.z == Catch::Approx(-2.5f).margin(1e-3));
+    CHECK(location.pose.orientation.y == Catch::Approx(std::sin(0.625f)).margin(1e-4));
+    CHECK(location.pose.orientation.w == Catch::Approx(std::cos(0.625f)).margin(1e-4));
+    CHECK((XR_SPACE_VELOCITY_LINEAR_VALID_BIT | XR_SPACE_VELOCITY_ANGULAR_VALID_BIT) == velocity.velocityFlags);
+    CHECK(velocity.linearVelocity.z == Catch::Approx(-1.0f).margin(1e-3));
+    CHECK(velocity.angularVelocity.y == Catch::Approx(0.5f).margin(1e-3));
+
+    // Before the first sample the head rests there, and playback loops after the last one (9.99 s).
+    locate(view_space, local_space, start - second);
+    CHECK(location.pose.position.z == Catch::Approx(0.0f).margin(1e-4));
+    locate(view_space, local_space, start + 12 * second + second / 2);
+    CHECK(location.pose.position.z == Catch::Approx(-2.51f).margin(1e-3));
+
+    // The eyes are either side of the head.
+    XrViewLocateInfo view_locate_info = {XR_TYPE_VIEW_LOCATE_INFO};
+    view_locate_info.viewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+    view_locate_info.displayTime = start + 2 * second + second / 2;
+    view_locate_info.space = local_space;
+    XrViewState view_state = {XR_TYPE_VIEW_STATE};
+    std::array<XrView, 2> views{{{XR_TYPE_VIEW}, {XR_TYPE_VIEW}}};
+    uint32_t view_count = 0;
+    REQUIRE(XR_SUCCESS == xrLocateViews(session, &view_locate_info, &view_state, 2, &view_count, views.data()));
+    CHECK(0 != (view_state.viewStateFlags & XR_VIEW_STATE_POSITION_TRACKED_BIT));
+    const float eye_dx = views[1].pose.position.x - views[0].pose.position.x;
+    const float eye_dz = views[1].pose.position.z - views[0].pose.position.z;
+    CHECK(std::sqrt(eye_dx * eye_dx + eye_dz * eye_dz) == Catch::Approx(0.064f).margin(1e-4));
+    CHECK((views[0].pose.position.z + views[1].pose.position.z) / 2 == Catch::Approx(-2.5f).margin(1e-3));
+
+    // Action spaces follow the aim or grip pose of their hand.
+    locate(left_aim_space, local_space, start + second);
+    CHECK(valid_and_tracked == location.locationFlags);
+    CHECK(location.pose.position.x == Catch::Approx(2.0f));
+    CHECK(location.pose.position.z == Catch::Approx(-1.0f).margin(1e-3));
+    locate(right_grip_space, local_space, start + second);
+    CHECK(location.pose.position.x == Catch::Approx(3.0f));
+    locate(untracked_space, local_space, start + second);
+    CHECK(0 == location.locationFlags);
+
+    // Relative to the moving head, the hand is still 3 m away at head height, without velocities.
+    locate(right_grip_space, view_space, start + second);
+    CHECK(valid_and_tracked == location.locationFlags);
+    CHECK(location.pose.position.y == Catch::Approx(0.0f).margin(1e-4));
+    CHECK(std::sqrt(location.pose.position.x * location.pose.position.x + location.pose.position.z * location.pose.position.z) ==
+          Catch::Approx(3.0f).margin(1e-3));
+    CHECK(0 == velocity.velocityFlags);
+
+    // xrLocateSpaces agrees with xrLocateSpace.
+    PFN_xrLocateSpaces locate_spaces = nullptr;
+    REQUIRE(XR_SUCCESS == xrGetInstanceProcAddr(instance, "xrLocateSpaces", reinterpret_cast<PFN_xrVoidFunction*>(&locate_spaces)));
+    const XrSpace spaces[] = {view_space, left_aim_space, right_grip_space};
+    XrSpaceLocationData location_data[3] = {};
+    XrSpaceLocations locations = {XR_TYPE_SPACE_LOCATIONS};
+    locations.locationCount = 3;
+    locations.locations = location_data;
+    XrSpacesLocateInfo locate_info = {XR_TYPE_SPACES_LOCATE_INFO};
+    locate_info.baseSpace = local_space;
+    locate_info.time = start + second;
+    locate_info.spaceCount = 3;
+    locate_info.spaces = spaces;
+    REQUIRE(XR_SUCCESS == locate_spaces(session, &locate_info, &locations));
+    for (uint32_t i = 0; i < 3; ++i) {
+        locate(spaces[i], local_space, start + second);
+        CHECK(location.pose.position.x == location_data[i].pose.position.x);
+        CHECK(location.pose.position.z == location_data[i].pose.position.z);
+    }
+
+    REQUIRE(XR_SUCCESS == xrRequestExitSession(session));
+    REQUIRE(XR_SUCCESS == xrEndSession(session));
+    CHECK(XR_SUCCESS == xrDestroyInstance(instance));
+    std::remove("trajectory.bin");
+
+    // Cleanup
+    LoaderTestUnsetEnvironmentVariable("XR_TEST_RUNTIME_TRAJECTORY_FILE");
+    CleanupEnvironmentVariables();
+}
+#endif  // !defined(XR_USE_PLATFORM_ANDROID)
+
 TEST_CASE("TestLoaderInitialize") {
     if (!g_has_installed_runtime) {
         SKIP("Skipped - no runtime installed");
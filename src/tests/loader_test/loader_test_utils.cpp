@@ -22,9 +22,15 @@
 
 #include "loader_test_utils.hpp"
 #include "xr_dependencies.h"
+#include "test_runtime_trajectory.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <vector>
 
 #if defined(XR_OS_WINDOWS)
 
@@ -102,3 +108,105 @@ bool LoaderTestUnsetEnvironmentVariable(const std::string& /*variable*/) { retur
 #error "Unsupported platform"
 
 #endif
+
+bool LoaderTestWriteTrajectoryFile(const std::string& fileName, uint64_t sampleCount, int64_t samplePeriod) {
+    static const std::array<const char*, 6> roles{{"/user/head", "/user/hand/left/input/grip/pose", "/user/hand/left/input/aim/pose",
+                                                   "/user/hand/right/input/grip/pose", "/user/hand/right/input/aim/pose",
+                                                   "/user/vive_tracker_htcx/role/waist/input/grip/pose"}};
+    const uint32_t trackCount = static_cast<uint32_t>(roles.size());
+
+    FILE* file = fopen(fileName.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    XrTrajectoryFileHeaderTEST header{};
+    memcpy(header.magic, XR_TRAJECTORY_FILE_MAGIC_TEST, sizeof(header.magic));
+    header.version = XR_TRAJECTORY_FILE_VERSION_TEST;
+    header.trackCount = trackCount;
+    header.sampleCount = sampleCount;
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    for (const char* role : roles) {
+        XrTrajectoryTrackTEST track{};
+        strncpy(track.role, role, sizeof(track.role) - 1);
+        written = written && fwrite(&track, sizeof(track), 1, file) == 1;
+    }
+
+    for (uint64_t i = 0; written && i < sampleCount; ++i) {
+        const int64_t time = static_cast<int64_t>(i) * samplePeriod;
+        written = fwrite(&time, sizeof(time), 1, file) == 1;
+    }
+
+    std::vector<float> sample(7 * trackCount);
+    for (uint64_t i = 0; written && i < sampleCount; ++i) {
+        const double seconds = static_cast<double>(i) * static_cast<double>(samplePeriod) * 1e-9;
+        const float halfAngle = static_cast<float>(0.25 * seconds);
+        for (uint32_t t = 0; t < trackCount; ++t) {
+            sample[0 * trackCount + t] = static_cast<float>(t);
+            sample[1 * trackCount + t] = 1.5f;
+            sample[2 * trackCount + t] = static_cast<float>(-seconds);
+            sample[3 * trackCount + t] = 0.0f;
+            sample[4 * trackCount + t] = std::sin(halfAngle);
+            sample[5 * trackCount + t] = 0.0f;
+            sample[6 * trackCount + t] = std::cos(halfAngle);
+        }
+        written = fwrite(sample.data(), sizeof(float), sample.size(), file) == sample.size();
+    }
+
+    return fclose(file) == 0 && written;
+}
+
+XrResult LoaderTestCreateHeadlessSession(XrVersion api_version, const std::vector<const char *> &layer_names, bool begin,
+                                         LoaderTestHeadlessSession &headless) {
+    headless = {};
+    uint32_t extension_count = 0;
+    XrResult result = xrEnumerateInstanceExtensionProperties(nullptr, 0, &extension_count, nullptr);
+    if (XR_FAILED(result)) {
+        return result;
+    }
+    std::vector<XrExtensionProperties> extensions(extension_count, {XR_TYPE_EXTENSION_PROPERTIES});
+    result = xrEnumerateInstanceExtensionProperties(nullptr, extension_count, &extension_count, extensions.data());
+    if (XR_FAILED(result)) {
+        return result;
+    }
+    if (std::none_of(extensions.begin(), extensions.end(), [](const XrExtensionProperties &extension) {
+            return 0 == strcmp(extension.extensionName, XR_MND_HEADLESS_EXTENSION_NAME);
+        })) {
+        return XR_ERROR_EXTENSION_NOT_PRESENT;
+    }
+
+    const char *const extension_names[] = {XR_MND_HEADLESS_EXTENSION_NAME};
+    XrInstanceCreateInfo instance_ci = {XR_TYPE_INSTANCE_CREATE_INFO};
+    strcpy(instance_ci.applicationInfo.applicationName, "Loader Test");
+    instance_ci.applicationInfo.apiVersion = api_version;
+    instance_ci.enabledApiLayerCount = static_cast<uint32_t>(layer_names.size());
+    instance_ci.enabledApiLayerNames = layer_names.data();
+    instance_ci.enabledExtensionCount = 1;
+    instance_ci.enabledExtensionNames = extension_names;
+    result = xrCreateInstance(&instance_ci, &headless.instance);
+    if (XR_FAILED(result)) {
+        headless = {};
+        return result;
+    }
+
+    XrSystemGetInfo system_get_info = {XR_TYPE_SYSTEM_GET_INFO};
+    system_get_info.formFactor = XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY;
+    result = xrGetSystem(headless.instance, &system_get_info, &headless.system_id);
+    if (XR_SUCCEEDED(result)) {
+        XrSessionCreateInfo session_ci = {XR_TYPE_SESSION_CREATE_INFO};
+        session_ci.systemId = headless.system_id;
+        result = xrCreateSession(headless.instance, &session_ci, &headless.session);
+    }
+    if (XR_SUCCEEDED(result) && begin) {
+        XrSessionBeginInfo begin_info = {XR_TYPE_SESSION_BEGIN_INFO};
+        begin_info.primaryViewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+        result = xrBeginSession(headless.session, &begin_info);
+    }
+    if (XR_FAILED(result)) {
+        // Destroying the instance destroys the session too.
+        xrDestroyInstance(headless.instance);
+        headless = {};
+    }
+    return result;
+}
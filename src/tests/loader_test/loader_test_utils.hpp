@@ -21,7 +21,11 @@
 
 #pragma once
 
+#include <openxr/openxr.h>
+
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #if defined(XR_OS_ANDROID) || defined(XR_OS_LINUX) || defined(XR_OS_APPLE)
 #include <unistd.h>
@@ -39,3 +43,22 @@
 bool LoaderTestSetEnvironmentVariable(const std::string& variable, const std::string& value);
 bool LoaderTestGetEnvironmentVariable(const std::string& variable, std::string& value);
 bool LoaderTestUnsetEnvironmentVariable(const std::string& variable);
+
+// Writes a test_runtime trajectory file with a head, both hands' grip and aim poses and a waist tracker.
+// Track i sits at x = i and y = 1.5, moves along -z at 1 m/s and turns about +y at 0.5 rad/s; the first
+// sample is at time 0.
+bool LoaderTestWriteTrajectoryFile(const std::string& fileName, uint64_t sampleCount, int64_t samplePeriod);
+
+// An instance with XR_MND_headless, its head-mounted system and a session on it.
+struct LoaderTestHeadlessSession {
+    XrInstance instance = XR_NULL_HANDLE;
+    XrSystemId system_id = XR_NULL_SYSTEM_ID;
+    XrSession session = XR_NULL_HANDLE;
+};
+
+// Creates a headless instance with the given API version and layers, gets its system and creates a session,
+// which is begun with the stereo view configuration if `begin` is set.  Returns XR_ERROR_EXTENSION_NOT_PRESENT
+// if the runtime does not offer XR_MND_headless.  On failure nothing is left created and the failing result
+// is returned.
+XrResult LoaderTestCreateHeadlessSession(XrVersion api_version, const std::vector<const char*>& layer_names, bool begin,
+                                         LoaderTestHeadlessSession& headless);
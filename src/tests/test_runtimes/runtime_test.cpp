@@ -22,14 +22,22 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <deque>
 #include <iostream>
-#include <map>
 #include <memory>
 #include <mutex>
 #include <math.h>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include "xr_dependencies.h"
@@ -39,6 +47,20 @@
 #include <openxr/openxr_reflection.h>
 
 #include "common/xr_linear.h"
+#include "test_runtime_swapchain.h"
+#include "test_runtime_trajectory.h"
+
+#if defined(XR_OS_WINDOWS)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif  // !NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #if defined(__GNUC__) && __GNUC__ >= 4
 #define RUNTIME_EXPORT __attribute__((visibility("default")))
@@ -48,10 +70,21 @@
 #define RUNTIME_EXPORT
 #endif
 
+// Sessions created with XrGraphicsBindingEGLMNDX get OpenGL swapchains, allocated in the application's
+// context through the EGL and OpenGL entry points returned by its getProcAddress.
+#if defined(XR_USE_PLATFORM_EGL) && defined(XR_USE_GRAPHICS_API_OPENGL)
+#define RUNTIME_TEST_EGL_OPENGL
+#endif
+
 namespace {
 
 constexpr XrSystemId VALID_SYSTEM_ID = 1;
 
+constexpr uint32_t cMaxSwapchainImageSize = 4096;
+
+// Half the distance between the eyes of views located on a trajectory, in meters.
+constexpr float cTrajectoryHalfIpd = 0.032f;
+
 struct XrSpace_T {
     enum class SpaceType {
         Unknown,
@@ -68,13 +101,373 @@ struct XrSpace_T {
     XrReferenceSpaceType referenceSpaceType{XR_REFERENCE_SPACE_TYPE_MAX_ENUM};
     XrPosef poseInReferenceSpace{};
 
+    // action space
+    XrPosef poseInActionSpace{};
+
+    // trajectory track the space follows, if any
+    int32_t trajectoryTrack{-1};
+
     ~XrSpace_T();
 };
 
+// Read-only mapping of a whole file.
+class MappedFile {
+   public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+#if defined(XR_OS_WINDOWS)
+        if (data_ != nullptr) {
+            UnmapViewOfFile(data_);
+        }
+        if (mapping_ != nullptr) {
+            CloseHandle(mapping_);
+        }
+        if (file_ != INVALID_HANDLE_VALUE) {
+            CloseHandle(file_);
+        }
+#else
+        if (data_ != nullptr) {
+            munmap(const_cast<uint8_t*>(data_), size_);
+        }
+#endif
+    }
+
+    bool Open(const char* fileName) {
+#if defined(XR_OS_WINDOWS)
+        file_ = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        LARGE_INTEGER size{};
+        if (file_ == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_, &size) || size.QuadPart == 0) {
+            return false;
+        }
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_ == nullptr) {
+            return false;
+        }
+        data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        size_ = static_cast<size_t>(size.QuadPart);
+#else
+        const int fd = open(fileName, O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat status {};
+        if (fstat(fd, &status) != 0 || status.st_size == 0) {
+            close(fd);
+            return false;
+        }
+        void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) {
+            return false;
+        }
+        data_ = static_cast<const uint8_t*>(data);
+        size_ = static_cast<size_t>(status.st_size);
+#endif
+        return data_ != nullptr;
+    }
+
+    const uint8_t* Data() const { return data_; }
+    size_t Size() const { return size_; }
+
+   private:
+    const uint8_t* data_{nullptr};
+    size_t size_{0};
+#if defined(XR_OS_WINDOWS)
+    HANDLE file_{INVALID_HANDLE_VALUE};
+    HANDLE mapping_{nullptr};
+#endif
+};
+
+// Every track of a trajectory at one time, laid out like a sample of the file.
+struct TrajectorySample {
+    uint32_t trackCount{0};
+    std::array<float, 7 * XR_TRAJECTORY_MAX_TRACKS_TEST> components;
+
+    // the two samples interpolated, for velocities
+    const float* before{nullptr};
+    const float* after{nullptr};
+    float interval{0.0f};  // seconds from before to after, 0 when clamped
+
+    XrPosef Pose(uint32_t track) const {
+        const float* c = components.data() + track;
+        const uint32_t n = trackCount;
+        return XrPosef{{c[3 * n], c[4 * n], c[5 * n], c[6 * n]}, {c[0], c[n], c[2 * n]}};
+    }
+
+    // Velocities in the trajectory's space, by finite difference of the samples around the time.
+    void Velocity(uint32_t track, XrVector3f* linear, XrVector3f* angular) const {
+        *linear = {0, 0, 0};
+        *angular = {0, 0, 0};
+        if (interval <= 0.0f) {
+            return;
+        }
+        const uint32_t n = trackCount;
+        const float* a = before + track;
+        const float* b = after + track;
+        *linear = {(b[0] - a[0]) / interval, (b[n] - a[n]) / interval, (b[2 * n] - a[2 * n]) / interval};
+
+        // Rotation from a to b, as an angular velocity for small angles.
+        const XrQuaternionf qa{a[3 * n], a[4 * n], a[5 * n], a[6 * n]};
+        XrQuaternionf qb{b[3 * n], b[4 * n], b[5 * n], b[6 * n]};
+        if (qa.x * qb.x + qa.y * qb.y + qa.z * qb.z + qa.w * qb.w < 0.0f) {
+            qb = {-qb.x, -qb.y, -qb.z, -qb.w};
+        }
+        XrQuaternionf qaInverse;
+        XrQuaternionf_Invert(&qaInverse, &qa);
+        XrQuaternionf delta;
+        XrQuaternionf_Multiply(&delta, &qaInverse, &qb);
+        *angular = {2.0f * delta.x / interval, 2.0f * delta.y / interval, 2.0f * delta.z / interval};
+    }
+};
+
+// A trajectory file mapped in memory; see test_runtime_trajectory.h.
+class Trajectory {
+   public:
+    // Returns nullptr when the file cannot be mapped or is malformed.
+    static std::unique_ptr<Trajectory> Load(const char* fileName) {
+        auto trajectory = std::make_unique<Trajectory>();
+        if (!trajectory->file_.Open(fileName) || trajectory->file_.Size() < sizeof(XrTrajectoryFileHeaderTEST)) {
+            return nullptr;
+        }
+
+        XrTrajectoryFileHeaderTEST header;
+        memcpy(&header, trajectory->file_.Data(), sizeof(header));
+        if (memcmp(header.magic, XR_TRAJECTORY_FILE_MAGIC_TEST, sizeof(header.magic)) != 0 ||
+            header.version != XR_TRAJECTORY_FILE_VERSION_TEST || header.trackCount == 0 ||
+            header.trackCount > XR_TRAJECTORY_MAX_TRACKS_TEST || header.sampleCount == 0) {
+            return nullptr;
+        }
+        const uint64_t sampleSize = sizeof(int64_t) + 7 * sizeof(float) * uint64_t{header.trackCount};
+        const uint64_t tracksSize = sizeof(XrTrajectoryTrackTEST) * uint64_t{header.trackCount};
+        const uint64_t size = trajectory->file_.Size() - sizeof(header);
+        if (tracksSize > size || header.sampleCount > (size - tracksSize) / sampleSize) {
+            return nullptr;
+        }
+
+        trajectory->trackCount_ = header.trackCount;
+        trajectory->sampleCount_ = header.sampleCount;
+        const uint8_t* data = trajectory->file_.Data() + sizeof(header);
+        for (uint32_t i = 0; i < header.trackCount; ++i) {
+            const auto* track = reinterpret_cast<const XrTrajectoryTrackTEST*>(data) + i;
+            trajectory->roles_.emplace_back(track->role, strnlen(track->role, sizeof(track->role)));
+        }
+        data += tracksSize;
+        trajectory->times_ = reinterpret_cast<const int64_t*>(data);
+        trajectory->samples_ = reinterpret_cast<const float*>(data + sizeof(int64_t) * header.sampleCount);
+
+        // Interpolation divides by the time between samples.
+        for (uint64_t i = 1; i < header.sampleCount; ++i) {
+            if (trajectory->times_[i] <= trajectory->times_[i - 1]) {
+                return nullptr;
+            }
+        }
+        return trajectory;
+    }
+
+    // Index of the track with this role, or -1.
+    int32_t FindTrack(const std::string& role) const {
+        const auto it = std::find(roles_.begin(), roles_.end(), role);
+        return it == roles_.end() ? -1 : static_cast<int32_t>(it - roles_.begin());
+    }
+
+    // Interpolates every track at a time counted from the start of playback.
+    void Sample(XrDuration time, TrajectorySample* sample) const {
+        const int64_t first = times_[0];
+        const int64_t last = times_[sampleCount_ - 1];
+        if (time > last && last > first) {
+            time = first + (time - first) % (last - first);
+        }
+
+        const int64_t* upper = std::upper_bound(times_, times_ + sampleCount_, time);
+        const uint64_t i = upper == times_ ? 0 : static_cast<uint64_t>(upper - times_) - 1;
+        const uint64_t j = std::min(i + 1, sampleCount_ - 1);
+        const bool clamped = i == j || time < first;
+        const float f = clamped ? 0.0f : static_cast<float>(time - times_[i]) / static_cast<float>(times_[j] - times_[i]);
+
+        const uint32_t n = trackCount_;
+        const float* a = samples_ + i * 7 * n;
+        const float* b = samples_ + j * 7 * n;
+        float* out = sample->components.data();
+        sample->trackCount = n;
+        sample->before = a;
+        sample->after = b;
+        sample->interval = clamped ? 0.0f : static_cast<float>(times_[j] - times_[i]) * 1e-9f;
+
+        // Positions.
+        for (uint32_t k = 0; k < 3 * n; ++k) {
+            out[k] = a[k] + (b[k] - a[k]) * f;
+        }
+
+        // Orientations, normalized linear interpolation along the shorter arc.
+        const float* qa = a + 3 * n;
+        const float* qb = b + 3 * n;
+        float* q = out + 3 * n;
+        std::array<float, XR_TRAJECTORY_MAX_TRACKS_TEST> scale;
+        for (uint32_t t = 0; t < n; ++t) {
+            const float dot = qa[t] * qb[t] + qa[n + t] * qb[n + t] + qa[2 * n + t] * qb[2 * n + t] + qa[3 * n + t] * qb[3 * n + t];
+            scale[t] = dot < 0.0f ? -1.0f : 1.0f;
+        }
+        for (uint32_t c = 0; c < 4 * n; c += n) {
+            for (uint32_t t = 0; t < n; ++t) {
+                q[c + t] = qa[c + t] + (qb[c + t] * scale[t] - qa[c + t]) * f;
+            }
+        }
+        for (uint32_t t = 0; t < n; ++t) {
+            scale[t] = 1.0f / sqrtf(q[t] * q[t] + q[n + t] * q[n + t] + q[2 * n + t] * q[2 * n + t] + q[3 * n + t] * q[3 * n + t]);
+        }
+        for (uint32_t c = 0; c < 4 * n; c += n) {
+            for (uint32_t t = 0; t < n; ++t) {
+                q[c + t] *= scale[t];
+            }
+        }
+    }
+
+   private:
+    MappedFile file_;
+    uint32_t trackCount_{0};
+    uint64_t sampleCount_{0};
+    std::vector<std::string> roles_;
+    const int64_t* times_{nullptr};
+    const float* samples_{nullptr};
+};
+
+#ifdef RUNTIME_TEST_EGL_OPENGL
+// The application's EGL context, and the OpenGL entry points used to manage swapchain textures.
+struct EglOpenGL {
+    EGLDisplay display{EGL_NO_DISPLAY};
+    EGLContext context{EGL_NO_CONTEXT};
+
+    PFNEGLGETCURRENTDISPLAYPROC getCurrentDisplay{nullptr};
+    PFNEGLGETCURRENTCONTEXTPROC getCurrentContext{nullptr};
+    PFNEGLGETCURRENTSURFACEPROC getCurrentSurface{nullptr};
+    PFNEGLMAKECURRENTPROC makeCurrent{nullptr};
+
+    void (*getIntegerv)(uint32_t name, int32_t* data){nullptr};
+    void (*genTextures)(int32_t n, uint32_t* textures){nullptr};
+    void (*deleteTextures)(int32_t n, const uint32_t* textures){nullptr};
+    void (*bindTexture)(uint32_t target, uint32_t texture){nullptr};
+    void (*texStorage2D)(uint32_t target, int32_t levels, uint32_t internalFormat, int32_t width, int32_t height){nullptr};
+    void (*texStorage3D)(uint32_t target, int32_t levels, uint32_t internalFormat, int32_t width, int32_t height,
+                         int32_t depth){nullptr};
+};
+
+// Makes the application's context current, without a surface, for the lifetime of the object if it is
+// not current already; the previous context is restored afterwards.
+class EglContextScope {
+   public:
+    explicit EglContextScope(const EglOpenGL& egl) : egl_(egl) {
+        if (egl_.getCurrentContext() == egl_.context) {
+            return;
+        }
+        display_ = egl_.getCurrentDisplay();
+        context_ = egl_.getCurrentContext();
+        draw_ = egl_.getCurrentSurface(EGL_DRAW);
+        read_ = egl_.getCurrentSurface(EGL_READ);
+        switched_ = egl_.makeCurrent(egl_.display, EGL_NO_SURFACE, EGL_NO_SURFACE, egl_.context) == EGL_TRUE;
+        failed_ = !switched_;
+    }
+    ~EglContextScope() {
+        if (!switched_) {
+            return;
+        }
+        if (context_ == EGL_NO_CONTEXT) {
+            egl_.makeCurrent(egl_.display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        } else {
+            egl_.makeCurrent(display_, draw_, read_, context_);
+        }
+    }
+    EglContextScope(const EglContextScope&) = delete;
+    EglContextScope& operator=(const EglContextScope&) = delete;
+
+    bool Failed() const { return failed_; }
+
+   private:
+    const EglOpenGL& egl_;
+    EGLDisplay display_{EGL_NO_DISPLAY};
+    EGLContext context_{EGL_NO_CONTEXT};
+    EGLSurface draw_{EGL_NO_SURFACE};
+    EGLSurface read_{EGL_NO_SURFACE};
+    bool switched_ = false;
+    bool failed_ = false;
+};
+#endif  // RUNTIME_TEST_EGL_OPENGL
+
+struct XrSwapchain_T {
+    // parent
+    XrSession session{XR_NULL_HANDLE};
+
+    int64_t format{0};
+    uint32_t width{0};
+    uint32_t height{0};
+    uint32_t arraySize{0};
+    bool isStatic = false;
+
+    // host memory images
+    std::unique_ptr<uint8_t[]> memory;
+    std::vector<XrSwapchainImageCpuTEST> cpuImages;
+
+    // OpenGL images
+    std::vector<uint32_t> glImages;
+
+    // acquired images, oldest first; the oldest one has been waited on if imageWaited is set
+    std::mutex imagesMutex;
+    std::deque<uint32_t> acquiredImages;
+    bool imageWaited = false;
+    uint32_t nextImage = 0;
+    bool staticImageAcquired = false;
+
+    ~XrSwapchain_T();
+};
+
+// Simulated display of a session.  xrWaitFrame wakes once per vsync and predicts display one period later;
+// the compositor can be made to miss vsyncs and to wake late.  Configured when the session is created:
+//   XR_TEST_RUNTIME_REFRESH_RATE           refresh rate in Hz; unset or 0 leaves xrWaitFrame unthrottled
+//   XR_TEST_RUNTIME_VSYNC_JITTER_US        xrWaitFrame wakes up to this many microseconds after each vsync
+//   XR_TEST_RUNTIME_MISSED_FRAME_INTERVAL  the compositor misses every Nth vsync
+//   XR_TEST_RUNTIME_FRAME_SEED             seed of the jitter sequence
+//   XR_TEST_RUNTIME_FRAME_STATS_FILE       file that frame statistics are appended to when the session ends
+struct FramePacer {
+    XrDuration period{0};  // 0 when unthrottled
+    XrDuration jitter{0};
+    uint64_t missedFrameInterval{0};
+    uint64_t seed{0};
+
+    // frames in flight
+    std::mutex mutex;
+    XrTime startTime{0};
+    uint64_t lastVsync{0};
+    bool frameWaited = false;
+    bool frameBegun = false;
+    XrTime waitedWakeTime{0};
+    XrTime waitedDisplayTime{0};
+    XrTime begunWakeTime{0};
+    XrTime begunDisplayTime{0};
+
+    // statistics since the session began
+    uint64_t framesWaited{0};
+    uint64_t framesBegun{0};
+    uint64_t framesEnded{0};
+    uint64_t framesDiscarded{0};
+    uint64_t lateEndFrames{0};
+    uint64_t missedVsyncs{0};
+    uint64_t skippedVsyncs{0};
+    XrDuration totalFrameTime{0};
+    XrDuration maxFrameTime{0};
+    bool reported = false;
+};
+
 struct XrSession_T {
     // parent
     XrInstance instance{XR_NULL_HANDLE};
 
+#ifdef RUNTIME_TEST_EGL_OPENGL
+    // graphics binding, unset for host memory swapchains
+    std::unique_ptr<EglOpenGL> eglOpenGL;
+#endif
+
     // session state
     XrSessionState sessionState{XR_SESSION_STATE_UNKNOWN};
     bool hasBegun = false;
@@ -88,6 +481,25 @@ struct XrSession_T {
     bool actionsetsAttached = false;
     std::vector<XrActionSet> attachedActionSets;
 
+    // simulated input, see simulatedInputSync
+    bool simulatedInput = false;
+    std::mutex syncMutex;
+    uint64_t syncCount{0};
+    XrTime lastSyncTime{0};
+    std::vector<XrActionSet> activeActionSets;
+
+    // swapchains
+    std::mutex swapchainsMutex;
+    std::vector<std::unique_ptr<XrSwapchain_T>> swapchains;
+
+    // frame loop
+    FramePacer framePacer;
+
+    // recorded motion, unset when poses are static
+    std::unique_ptr<Trajectory> trajectory;
+    int32_t trajectoryHeadTrack{-1};
+    std::atomic<XrTime> trajectoryStart{0};
+
     ~XrSession_T();
 };
 
@@ -116,6 +528,91 @@ struct XrActionSet_T {
     std::vector<std::unique_ptr<XrAction_T>> actions;
 };
 
+// Interned path strings.  Strings are copied once into an arena and never move, a hash index maps
+// strings to paths, and a dense table maps paths back to strings.  The dense table is split into
+// fixed-size chunks that are never reallocated, so PathToString reads it without taking the lock:
+// an entry is fully written before the path count that covers it is published.
+class PathTable {
+   public:
+    PathTable() = default;
+    PathTable(const PathTable&) = delete;
+    PathTable& operator=(const PathTable&) = delete;
+
+    ~PathTable() {
+        for (auto& chunk : chunks_) {
+            delete[] chunk.load(std::memory_order_relaxed);
+        }
+    }
+
+    XrResult Intern(const char* pathString, XrPath* path) {
+        const std::string_view str(pathString);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        const auto it = index_.find(str);
+        if (it != index_.end()) {
+            *path = it->second;
+            return XR_SUCCESS;
+        }
+
+        const uint64_t count = count_.load(std::memory_order_relaxed);
+        const uint64_t chunkIndex = count / kChunkSize;
+        if (chunkIndex >= kMaxChunks) {
+            return XR_ERROR_PATH_COUNT_EXCEEDED;
+        }
+        std::string_view* chunk = chunks_[chunkIndex].load(std::memory_order_relaxed);
+        if (chunk == nullptr) {
+            chunk = new std::string_view[kChunkSize];
+            chunks_[chunkIndex].store(chunk, std::memory_order_release);
+        }
+
+        const std::string_view stored = Store(str);
+        chunk[count % kChunkSize] = stored;
+        index_.emplace(stored, static_cast<XrPath>(count));
+        count_.store(count + 1, std::memory_order_release);
+
+        *path = static_cast<XrPath>(count);
+        return XR_SUCCESS;
+    }
+
+    // Lock-free; returns false for paths that were never interned.
+    bool Lookup(XrPath path, std::string_view* str) const {
+        if (path == XR_NULL_PATH || path >= count_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        const std::string_view* chunk = chunks_[path / kChunkSize].load(std::memory_order_acquire);
+        *str = chunk[path % kChunkSize];
+        return true;
+    }
+
+   private:
+    static constexpr uint64_t kChunkSize = 1024;
+    static constexpr uint64_t kMaxChunks = 4096;
+    static constexpr size_t kArenaBlockSize = 64 * 1024;
+
+    // Copy a string (with its terminator) into the arena.
+    std::string_view Store(std::string_view str) {
+        const size_t size = str.size() + 1;
+        if (arena_.empty() || arenaUsed_ + size > kArenaBlockSize) {
+            arena_.emplace_back(new char[std::max(size, kArenaBlockSize)]);
+            arenaUsed_ = 0;
+        }
+        char* dst = arena_.back().get() + arenaUsed_;
+        memcpy(dst, str.data(), str.size());
+        dst[str.size()] = '\0';
+        arenaUsed_ += size;
+        return {dst, str.size()};
+    }
+
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<char[]>> arena_;
+    size_t arenaUsed_ = 0;
+    std::unordered_map<std::string_view, XrPath> index_;
+
+    // Path 0 is XR_NULL_PATH, so the first interned path is 1.
+    std::atomic<uint64_t> count_{1};
+    std::array<std::atomic<std::string_view*>, kMaxChunks> chunks_{};
+};
+
 struct XrInstance_T {
     // no parent
 
@@ -136,9 +633,7 @@ struct XrInstance_T {
     std::vector<std::unique_ptr<XrActionSet_T>> actionSets;
 
     // paths
-    std::mutex pathsMutex;
-    std::map<XrPath, std::string> paths;
-    XrPath lastPath = 1;
+    PathTable paths;
 };
 
 struct GlobalImpl {
@@ -892,6 +1387,19 @@ XrTime currentXrTime() {
     return std::chrono::nanoseconds(current - g.initialTime).count();
 }
 
+void sleepUntilXrTime(XrTime time) { std::this_thread::sleep_until(g.initialTime + std::chrono::nanoseconds(time)); }
+
+// Returns defaultValue when the variable is unset or not a number.
+double getEnvNumber(const char* name, double defaultValue) {
+    const char* value = getenv(name);
+    if (value == nullptr) {
+        return defaultValue;
+    }
+    char* end = nullptr;
+    const double number = strtod(value, &end);
+    return (end == value) ? defaultValue : number;
+}
+
 bool validateQuat(const XrQuaternionf& quat) {
     // tolerance for unit quats is 1%
     float norm = sqrtf(quat.x * quat.x + quat.y * quat.y + quat.z * quat.z + quat.w * quat.w);
@@ -930,6 +1438,18 @@ XrSpace_T::~XrSpace_T() {
     purgeEvents<XrSpace>(sessionPtr->instance, promoteToHandle<XrSpace, XrSpace_T>(this));
 }
 
+XrSwapchain_T::~XrSwapchain_T() {
+#ifdef RUNTIME_TEST_EGL_OPENGL
+    if (!glImages.empty()) {
+        const EglOpenGL& egl = *demoteFromHandle<XrSession, XrSession_T>(session)->eglOpenGL;
+        EglContextScope scope(egl);
+        if (!scope.Failed()) {
+            egl.deleteTextures(static_cast<int32_t>(glImages.size()), glImages.data());
+        }
+    }
+#endif  // RUNTIME_TEST_EGL_OPENGL
+}
+
 void switchSessionState(XrSession session, XrSessionState newSessionState) {
     XrSession_T* sessionPtr = demoteFromHandle<XrSession, XrSession_T>(session);
 
@@ -1013,10 +1533,13 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrEnumerateInstanceExtensionProperties
     }
 
 #ifdef XR_USE_PLATFORM_ANDROID
-    static constexpr std::size_t extension_count = 4;
+    static constexpr std::size_t platform_extension_count = 1;
+#elif defined(RUNTIME_TEST_EGL_OPENGL)
+    static constexpr std::size_t platform_extension_count = 2;
 #else
-    static constexpr std::size_t extension_count = 3;
+    static constexpr std::size_t platform_extension_count = 0;
 #endif
+    static constexpr std::size_t extension_count = 3 + platform_extension_count;
 
     static constexpr std::array<XrExtensionProperties, extension_count> runtimeExtensions = {{
         XrExtensionProperties{
@@ -1044,6 +1567,19 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrEnumerateInstanceExtensionProperties
             /*.extensionName =*/XR_KHR_ANDROID_CREATE_INSTANCE_EXTENSION_NAME,
             /*.extensionVersion =*/XR_KHR_android_create_instance_SPEC_VERSION,
         },
+#elif defined(RUNTIME_TEST_EGL_OPENGL)
+        XrExtensionProperties{
+            /*.type =*/XR_TYPE_EXTENSION_PROPERTIES,
+            /*.next =*/nullptr,
+            /*.extensionName =*/XR_KHR_OPENGL_ENABLE_EXTENSION_NAME,
+            /*.extensionVersion =*/XR_KHR_opengl_enable_SPEC_VERSION,
+        },
+        XrExtensionProperties{
+            /*.type =*/XR_TYPE_EXTENSION_PROPERTIES,
+            /*.next =*/nullptr,
+            /*.extensionName =*/XR_MNDX_EGL_ENABLE_EXTENSION_NAME,
+            /*.extensionVersion =*/XR_MNDX_egl_enable_SPEC_VERSION,
+        },
 #endif
     }};
 
@@ -1070,8 +1606,8 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrGetSystemProperties(XrInstance insta
     }
 
     properties->graphicsProperties.maxLayerCount = 16;
-    properties->graphicsProperties.maxSwapchainImageHeight = 1;
-    properties->graphicsProperties.maxSwapchainImageWidth = 1;
+    properties->graphicsProperties.maxSwapchainImageHeight = cMaxSwapchainImageSize;
+    properties->graphicsProperties.maxSwapchainImageWidth = cMaxSwapchainImageSize;
     properties->systemId = systemId;
     strcpy(properties->systemName, "Test system");
     properties->vendorId = 0x0;
@@ -1204,6 +1740,73 @@ RuntimeTestXrStructureTypeToString(XrInstance /*instance*/, XrStructureType valu
 // Session
 //
 
+void configureFramePacer(FramePacer& pacer) {
+    const double refreshRate = getEnvNumber("XR_TEST_RUNTIME_REFRESH_RATE", 0.0);
+    pacer.period = refreshRate > 0.0 ? static_cast<XrDuration>(1e9 / refreshRate) : 0;
+    // Jitter is kept below one period so that vsyncs are woken in order.
+    const auto jitter = static_cast<XrDuration>(getEnvNumber("XR_TEST_RUNTIME_VSYNC_JITTER_US", 0.0) * 1000.0);
+    pacer.jitter = std::max<XrDuration>(0, std::min(jitter, pacer.period - 1));
+    pacer.missedFrameInterval = static_cast<uint64_t>(std::max(0.0, getEnvNumber("XR_TEST_RUNTIME_MISSED_FRAME_INTERVAL", 0.0)));
+    pacer.seed = static_cast<uint64_t>(getEnvNumber("XR_TEST_RUNTIME_FRAME_SEED", 0.0));
+}
+
+// Appends one line of key=value pairs to XR_TEST_RUNTIME_FRAME_STATS_FILE, once per session.
+void reportFrameStats(XrSession session) {
+    XrSession_T* sessionPtr = demoteFromHandle<XrSession, XrSession_T>(session);
+    FramePacer& pacer = sessionPtr->framePacer;
+
+    std::unique_lock<std::mutex> lock(pacer.mutex);
+    if (pacer.reported) {
+        return;
+    }
+    pacer.reported = true;
+
+    const char* fileName = getenv("XR_TEST_RUNTIME_FRAME_STATS_FILE");
+    if (fileName == nullptr || fileName[0] == '\0') {
+        return;
+    }
+    FILE* file = fopen(fileName, "a");
+    if (file == nullptr) {
+        return;
+    }
+    const double meanFrameTimeUs =
+        pacer.framesEnded == 0 ? 0.0 : static_cast<double>(pacer.totalFrameTime) / static_cast<double>(pacer.framesEnded) / 1e3;
+    fprintf(file,
+            "period_ns=%lld frames_waited=%llu frames_begun=%llu frames_ended=%llu frames_discarded=%llu late_end_frames=%llu "
+            "missed_vsyncs=%llu skipped_vsyncs=%llu frame_time_mean_us=%.1f frame_time_max_us=%.1f\n",
+            static_cast<long long>(pacer.period), static_cast<unsigned long long>(pacer.framesWaited),
+            static_cast<unsigned long long>(pacer.framesBegun), static_cast<unsigned long long>(pacer.framesEnded),
+            static_cast<unsigned long long>(pacer.framesDiscarded), static_cast<unsigned long long>(pacer.lateEndFrames),
+            static_cast<unsigned long long>(pacer.missedVsyncs), static_cast<unsigned long long>(pacer.skippedVsyncs),
+            meanFrameTimeUs, static_cast<double>(pacer.maxFrameTime) / 1e3);
+    fclose(file);
+}
+
+#ifdef RUNTIME_TEST_EGL_OPENGL
+std::unique_ptr<EglOpenGL> loadEglOpenGL(const XrGraphicsBindingEGLMNDX& binding) {
+    if (binding.getProcAddress == nullptr || binding.display == EGL_NO_DISPLAY || binding.context == EGL_NO_CONTEXT) {
+        return nullptr;
+    }
+
+    auto egl = std::make_unique<EglOpenGL>();
+    egl->display = binding.display;
+    egl->context = binding.context;
+
+    auto load = [&binding](auto& function, const char* name) {
+        function = reinterpret_cast<std::remove_reference_t<decltype(function)>>(binding.getProcAddress(name));
+        return function != nullptr;
+    };
+    if (!load(egl->getCurrentDisplay, "eglGetCurrentDisplay") || !load(egl->getCurrentContext, "eglGetCurrentContext") ||
+        !load(egl->getCurrentSurface, "eglGetCurrentSurface") || !load(egl->makeCurrent, "eglMakeCurrent") ||
+        !load(egl->getIntegerv, "glGetIntegerv") || !load(egl->genTextures, "glGenTextures") ||
+        !load(egl->deleteTextures, "glDeleteTextures") || !load(egl->bindTexture, "glBindTexture") ||
+        !load(egl->texStorage2D, "glTexStorage2D") || !load(egl->texStorage3D, "glTexStorage3D")) {
+        return nullptr;
+    }
+    return egl;
+}
+#endif  // RUNTIME_TEST_EGL_OPENGL
+
 XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrCreateSession(XrInstance instance, const XrSessionCreateInfo* createInfo,
                                                           XrSession* session) {
     if (createInfo->systemId != VALID_SYSTEM_ID) {
@@ -1212,6 +1815,31 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrCreateSession(XrInstance instance, c
 
     auto sessionPtr = std::make_unique<XrSession_T>();
     sessionPtr->instance = instance;
+    configureFramePacer(sessionPtr->framePacer);
+
+    const char* simulatedInput = getenv("XR_TEST_RUNTIME_SIMULATED_INPUT");
+    sessionPtr->simulatedInput = simulatedInput != nullptr && simulatedInput[0] != '\0' && strcmp(simulatedInput, "0") != 0;
+
+    const char* trajectoryFile = getenv("XR_TEST_RUNTIME_TRAJECTORY_FILE");
+    if (trajectoryFile != nullptr && trajectoryFile[0] != '\0') {
+        sessionPtr->trajectory = Trajectory::Load(trajectoryFile);
+        if (sessionPtr->trajectory == nullptr) {
+            return XR_ERROR_RUNTIME_FAILURE;
+        }
+        sessionPtr->trajectoryHeadTrack = sessionPtr->trajectory->FindTrack("/user/head");
+        sessionPtr->trajectoryStart = currentXrTime();
+    }
+
+#ifdef RUNTIME_TEST_EGL_OPENGL
+    for (auto next = reinterpret_cast<const XrBaseInStructure*>(createInfo->next); next != nullptr; next = next->next) {
+        if (next->type == XR_TYPE_GRAPHICS_BINDING_EGL_MNDX) {
+            sessionPtr->eglOpenGL = loadEglOpenGL(*reinterpret_cast<const XrGraphicsBindingEGLMNDX*>(next));
+            if (sessionPtr->eglOpenGL == nullptr) {
+                return XR_ERROR_GRAPHICS_DEVICE_INVALID;
+            }
+        }
+    }
+#endif  // RUNTIME_TEST_EGL_OPENGL
 
     *session = promoteToHandle<XrSession, XrSession_T>(sessionPtr.get());
 
@@ -1228,6 +1856,10 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrCreateSession(XrInstance instance, c
 }
 
 XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrDestroySession(XrSession session) {
+    if (demoteFromHandle<XrSession, XrSession_T>(session)->hasBegun) {
+        reportFrameStats(session);
+    }
+
     {
         XrSession_T* sessionPtr = demoteFromHandle<XrSession, XrSession_T>(session);
         XrInstance_T* instancePtr = demoteFromHandle<XrInstance, XrInstance_T>(sessionPtr->instance);
@@ -1253,6 +1885,17 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrBeginSession(XrSession session, cons
 
     sessionPtr->hasBegun = true;
 
+    {
+        FramePacer& pacer = sessionPtr->framePacer;
+        std::unique_lock<std::mutex> lock(pacer.mutex);
+        pacer.startTime = currentXrTime();
+        pacer.lastVsync = 0;
+        pacer.frameWaited = false;
+        pacer.frameBegun = false;
+        pacer.reported = false;
+    }
+    sessionPtr->trajectoryStart = currentXrTime();
+
     switchSessionState(session, XR_SESSION_STATE_SYNCHRONIZED);
     switchSessionState(session, XR_SESSION_STATE_VISIBLE);
     switchSessionState(session, XR_SESSION_STATE_FOCUSED);
@@ -1267,6 +1910,7 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrEndSession(XrSession session) {
     }
 
     sessionPtr->hasBegun = false;
+    reportFrameStats(session);
 
     switchSessionState(session, XR_SESSION_STATE_IDLE);
     switchSessionState(session, XR_SESSION_STATE_EXITING);
@@ -1360,6 +2004,9 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrCreateReferenceSpace(XrSession sessi
     spacePtr->spaceType = XrSpace_T::SpaceType::ReferenceSpace;
     spacePtr->referenceSpaceType = createInfo->referenceSpaceType;
     spacePtr->poseInReferenceSpace = createInfo->poseInReferenceSpace;
+    if (createInfo->referenceSpaceType == XR_REFERENCE_SPACE_TYPE_VIEW) {
+        spacePtr->trajectoryTrack = sessionPtr->trajectoryHeadTrack;
+    }
 
     {
         std::unique_lock<std::mutex> lock(sessionPtr->spacesMutex);
@@ -1396,6 +2043,75 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrGetReferenceSpaceBoundsRect(XrSessio
     }
 }
 
+static constexpr XrSpaceLocationFlags validAndTracked =
+    XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT |
+    XR_SPACE_LOCATION_POSITION_TRACKED_BIT;
+
+static constexpr XrSpaceLocationFlags validOnly = XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT;
+
+static constexpr XrSpaceVelocityFlags velocityTracked = XR_SPACE_VELOCITY_LINEAR_VALID_BIT | XR_SPACE_VELOCITY_ANGULAR_VALID_BIT;
+
+// Pose and velocities of a space in the trajectory's LOCAL space; false when the space has no track to follow.
+bool trajectorySpacePose(const XrSpace_T& space, const TrajectorySample& sample, XrPosef* pose, XrVector3f* linearVelocity,
+                         XrVector3f* angularVelocity) {
+    const bool isActionSpace = space.spaceType == XrSpace_T::SpaceType::ActionSpace;
+    const XrPosef& offset = isActionSpace ? space.poseInActionSpace : space.poseInReferenceSpace;
+    if (space.trajectoryTrack < 0) {
+        *pose = offset;
+        *linearVelocity = {0, 0, 0};
+        *angularVelocity = {0, 0, 0};
+        return !isActionSpace;
+    }
+
+    const auto track = static_cast<uint32_t>(space.trajectoryTrack);
+    const XrPosef trackPose = sample.Pose(track);
+    XrPosef_Multiply(pose, &trackPose, &offset);
+
+    // The offset point also moves with the track's rotation.
+    XrVector3f trackVelocity;
+    sample.Velocity(track, &trackVelocity, angularVelocity);
+    XrVector3f lever;
+    XrVector3f_Sub(&lever, &pose->position, &trackPose.position);
+    XrVector3f spin;
+    XrVector3f_Cross(&spin, angularVelocity, &lever);
+    XrVector3f_Add(linearVelocity, &trackVelocity, &spin);
+    return true;
+}
+
+void locateSpaceOnTrajectory(const XrSpace_T& space, const XrSpace_T& baseSpace, const TrajectorySample& sample,
+                             XrSpaceLocation* location, XrSpaceVelocity* spaceVelocity) {
+    XrPosef worldFromSpace;
+    XrPosef worldFromBase;
+    XrVector3f linearVelocity;
+    XrVector3f angularVelocity;
+    XrVector3f baseLinearVelocity;
+    XrVector3f baseAngularVelocity;
+    if (!trajectorySpacePose(space, sample, &worldFromSpace, &linearVelocity, &angularVelocity) ||
+        !trajectorySpacePose(baseSpace, sample, &worldFromBase, &baseLinearVelocity, &baseAngularVelocity)) {
+        location->locationFlags = 0;
+        if (spaceVelocity != nullptr) {
+            spaceVelocity->velocityFlags = 0;
+        }
+        return;
+    }
+
+    XrPosef baseFromWorld;
+    XrPosef_Invert(&baseFromWorld, &worldFromBase);
+    XrPosef_Multiply(&location->pose, &baseFromWorld, &worldFromSpace);
+    location->locationFlags = validAndTracked;
+
+    if (spaceVelocity != nullptr) {
+        // Velocities relative to a moving base are not reported.
+        if (baseSpace.trajectoryTrack >= 0) {
+            spaceVelocity->velocityFlags = 0;
+            return;
+        }
+        spaceVelocity->velocityFlags = velocityTracked;
+        XrQuaternionf_RotateVector3f(&spaceVelocity->linearVelocity, &baseFromWorld.orientation, &linearVelocity);
+        XrQuaternionf_RotateVector3f(&spaceVelocity->angularVelocity, &baseFromWorld.orientation, &angularVelocity);
+    }
+}
+
 XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrLocateSpace(XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation* location) {
     if (time <= 0) {
         return XR_ERROR_TIME_INVALID;
@@ -1403,19 +2119,17 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrLocateSpace(XrSpace space, XrSpace b
 
     auto* spaceVelocity = findInNextChain<XrSpaceVelocity, XR_TYPE_SPACE_VELOCITY>(location->next);
 
-    static constexpr XrSpaceLocationFlags validAndTracked =
-        XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT |
-        XR_SPACE_LOCATION_POSITION_TRACKED_BIT;
-
-    static constexpr XrSpaceLocationFlags validOnly =
-        XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT;
-
-    static constexpr XrSpaceVelocityFlags velocityTracked =
-        XR_SPACE_VELOCITY_LINEAR_VALID_BIT | XR_SPACE_VELOCITY_ANGULAR_VALID_BIT;
-
     XrSpace_T* spacePtr = demoteFromHandle<XrSpace, XrSpace_T>(space);
     XrSpace_T* baseSpacePtr = demoteFromHandle<XrSpace, XrSpace_T>(baseSpace);
 
+    const XrSession_T* sessionPtr = demoteFromHandle<XrSession, XrSession_T>(spacePtr->session);
+    if (sessionPtr->trajectory != nullptr) {
+        TrajectorySample sample;
+        sessionPtr->trajectory->Sample(time - sessionPtr->trajectoryStart, &sample);
+        locateSpaceOnTrajectory(*spacePtr, *baseSpacePtr, sample, location, spaceVelocity);
+        return XR_SUCCESS;
+    }
+
     if (spacePtr->spaceType == XrSpace_T::SpaceType::ActionSpace &&
         baseSpacePtr->spaceType == XrSpace_T::SpaceType::ReferenceSpace) {
         location->locationFlags = 0;
@@ -1465,7 +2179,7 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrLocateSpace(XrSpace space, XrSpace b
     }
 }
 
-XRAPI_ATTR XrResult XRAPI_CALL TestRuntimeXrLocateSpaces(XrSession /*session*/, const XrSpacesLocateInfo* locateInfo,
+XRAPI_ATTR XrResult XRAPI_CALL TestRuntimeXrLocateSpaces(XrSession session, const XrSpacesLocateInfo* locateInfo,
                                                          XrSpaceLocations* spaceLocations) {
     if (locateInfo->time <= 0) {
         return XR_ERROR_TIME_INVALID;
@@ -1481,12 +2195,25 @@ XRAPI_ATTR XrResult XRAPI_CALL TestRuntimeXrLocateSpaces(XrSession /*session*/,
         }
     }
 
+    // One interpolation of the trajectory serves every space.
+    const XrSession_T* sessionPtr = demoteFromHandle<XrSession, XrSession_T>(session);
+    const bool onTrajectory = sessionPtr->trajectory != nullptr;
+    TrajectorySample sample;
+    if (onTrajectory) {
+        sessionPtr->trajectory->Sample(locateInfo->time - sessionPtr->trajectoryStart, &sample);
+    }
+
     for (uint32_t i = 0; i < locateInfo->spaceCount; ++i) {
         XrSpaceVelocity vel{XR_TYPE_SPACE_VELOCITY};
         XrSpaceLocation loc{XR_TYPE_SPACE_LOCATION, &vel};
-        XrResult res = RuntimeTestXrLocateSpace(locateInfo->spaces[i], locateInfo->baseSpace, locateInfo->time, &loc);
-        if (res != XR_SUCCESS) {
-            return res;
+        if (onTrajectory) {
+            locateSpaceOnTrajectory(*demoteFromHandle<XrSpace, XrSpace_T>(locateInfo->spaces[i]),
+                                    *demoteFromHandle<XrSpace, XrSpace_T>(locateInfo->baseSpace), sample, &loc, &vel);
+        } else {
+            XrResult res = RuntimeTestXrLocateSpace(locateInfo->spaces[i], locateInfo->baseSpace, locateInfo->time, &loc);
+            if (res != XR_SUCCESS) {
+                return res;
+            }
         }
         spaceLocations->locations[i].locationFlags = loc.locationFlags;
         spaceLocations->locations[i].pose = loc.pose;
@@ -1585,43 +2312,22 @@ bool validatePath(const char* path) {
 XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrStringToPath(XrInstance instance, const char* pathString, XrPath* path) {
     XrInstance_T* instancePtr = demoteFromHandle<XrInstance, XrInstance_T>(instance);
 
-    {
-        std::unique_lock<std::mutex> lock(instancePtr->pathsMutex);
-        const auto& it = std::find_if(instancePtr->paths.begin(), instancePtr->paths.end(),
-                                      [pathString](const auto& i) { return strcmp(i.second.c_str(), pathString) == 0; });
-        if (it != instancePtr->paths.end()) {
-            *path = it->first;
-            return XR_SUCCESS;
-        }
-
-        if (!validatePath(pathString)) {
-            return XR_ERROR_PATH_FORMAT_INVALID;
-        }
-
-        XrPath currentPath = instancePtr->lastPath;
-        instancePtr->lastPath++;
-        instancePtr->paths[currentPath] = pathString;
-        *path = currentPath;
-        return XR_SUCCESS;
+    if (!validatePath(pathString)) {
+        return XR_ERROR_PATH_FORMAT_INVALID;
     }
+
+    return instancePtr->paths.Intern(pathString, path);
 }
 
 XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrPathToString(XrInstance instance, XrPath path, uint32_t bufferCapacityInput,
                                                          uint32_t* bufferCountOutput, char* buffer) {
     XrInstance_T* instancePtr = demoteFromHandle<XrInstance, XrInstance_T>(instance);
 
-    {
-        std::unique_lock<std::mutex> lock(instancePtr->pathsMutex);
-        const auto& it =
-            std::find_if(instancePtr->paths.begin(), instancePtr->paths.end(), [path](const auto& i) { return i.first == path; });
-
-        if (it != instancePtr->paths.end()) {
-            std::string str = it->second;
-            return ElementCapacityWrite(bufferCapacityInput, bufferCountOutput, buffer, str.data(), str.size() + 1);
-        }
-
+    std::string_view str;
+    if (!instancePtr->paths.Lookup(path, &str)) {
         return XR_ERROR_PATH_INVALID;
     }
+    return ElementCapacityWrite(bufferCapacityInput, bufferCountOutput, buffer, str.data(), str.size() + 1);
 }
 
 XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrCreateActionSet(XrInstance instance, const XrActionSetCreateInfo* createInfo,
@@ -1918,6 +2624,34 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrGetCurrentInteractionProfile(XrSessi
     return XR_SUCCESS;
 }
 
+// Simulated input, enabled with XR_TEST_RUNTIME_SIMULATED_INPUT when the session is created, so that action
+// states change from one xrSyncActions to the next.  Every input action of the action sets active in the last
+// successful sync is active.  With n the number of syncs so far and i the index of the subaction path (0 for
+// XR_NULL_PATH), a boolean action is true when n is odd and a float or vector2f action is ((n + i) % 8) / 8,
+// with y = -x.  Every state has changed since the previous sync, except after the first one.  Returns false,
+// leaving the outputs alone, when the action is not active.
+static bool simulatedInputSync(XrSession_T& session, const XrAction_T& action, XrPath subactionPath, uint64_t& sync,
+                               uint32_t& subactionIndex, XrTime& syncTime) {
+    if (!session.simulatedInput) {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(session.syncMutex);
+    if (session.syncCount == 0 || std::find(session.activeActionSets.begin(), session.activeActionSets.end(),
+                                            action.actionSet) == session.activeActionSets.end()) {
+        return false;
+    }
+    sync = session.syncCount;
+    syncTime = session.lastSyncTime;
+    auto subaction = std::find(action.subactionPaths.begin(), action.subactionPaths.end(), subactionPath);
+    subactionIndex =
+        subaction == action.subactionPaths.end() ? 0 : static_cast<uint32_t>(subaction - action.subactionPaths.begin());
+    return true;
+}
+
+static float simulatedInputValue(uint64_t sync, uint32_t subactionIndex) {
+    return static_cast<float>((sync + subactionIndex) % 8) / 8.0f;
+}
+
 XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrGetActionStateBoolean(XrSession session, const XrActionStateGetInfo* getInfo,
                                                                   XrActionStateBoolean* state) {
     XrSession_T* sessionPtr = demoteFromHandle<XrSession, XrSession_T>(session);
@@ -1937,6 +2671,17 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrGetActionStateBoolean(XrSession sess
         }
     }
 
+    uint64_t sync = 0;
+    uint32_t subactionIndex = 0;
+    XrTime syncTime = 0;
+    if (simulatedInputSync(*sessionPtr, *actionPtr, getInfo->subactionPath, sync, subactionIndex, syncTime)) {
+        state->isActive = XR_TRUE;
+        state->currentState = (sync % 2) == 1 ? XR_TRUE : XR_FALSE;
+        state->changedSinceLastSync = sync > 1 ? XR_TRUE : XR_FALSE;
+        state->lastChangeTime = syncTime;
+        return XR_SUCCESS;
+    }
+
     state->isActive = XR_FALSE;
     return XR_SUCCESS;
 }
@@ -1960,6 +2705,17 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrGetActionStateFloat(XrSession sessio
         }
     }
 
+    uint64_t sync = 0;
+    uint32_t subactionIndex = 0;
+    XrTime syncTime = 0;
+    if (simulatedInputSync(*sessionPtr, *actionPtr, getInfo->subactionPath, sync, subactionIndex, syncTime)) {
+        state->isActive = XR_TRUE;
+        state->currentState = simulatedInputValue(sync, subactionIndex);
+        state->changedSinceLastSync = sync > 1 ? XR_TRUE : XR_FALSE;
+        state->lastChangeTime = syncTime;
+        return XR_SUCCESS;
+    }
+
     state->isActive = XR_FALSE;
     return XR_SUCCESS;
 }
@@ -1983,6 +2739,18 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrGetActionStateVector2f(XrSession ses
         }
     }
 
+    uint64_t sync = 0;
+    uint32_t subactionIndex = 0;
+    XrTime syncTime = 0;
+    if (simulatedInputSync(*sessionPtr, *actionPtr, getInfo->subactionPath, sync, subactionIndex, syncTime)) {
+        state->isActive = XR_TRUE;
+        state->currentState.x = simulatedInputValue(sync, subactionIndex);
+        state->currentState.y = -state->currentState.x;
+        state->changedSinceLastSync = sync > 1 ? XR_TRUE : XR_FALSE;
+        state->lastChangeTime = syncTime;
+        return XR_SUCCESS;
+    }
+
     state->isActive = XR_FALSE;
     return XR_SUCCESS;
 }
@@ -2006,11 +2774,15 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrGetActionStatePose(XrSession session
         }
     }
 
-    state->isActive = XR_FALSE;
+    uint64_t sync = 0;
+    uint32_t subactionIndex = 0;
+    XrTime syncTime = 0;
+    state->isActive =
+        simulatedInputSync(*sessionPtr, *actionPtr, getInfo->subactionPath, sync, subactionIndex, syncTime) ? XR_TRUE : XR_FALSE;
     return XR_SUCCESS;
 }
 
-XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrSyncActions(XrSession session, const XrActionsSyncInfo* /*syncInfo*/) {
+XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrSyncActions(XrSession session, const XrActionsSyncInfo* syncInfo) {
     XrSession_T* sessionPtr = demoteFromHandle<XrSession, XrSession_T>(session);
 
     if (!sessionPtr->actionsetsAttached) {
@@ -2021,6 +2793,16 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrSyncActions(XrSession session, const
         return XR_SESSION_NOT_FOCUSED;
     }
 
+    if (sessionPtr->simulatedInput) {
+        std::unique_lock<std::mutex> lock(sessionPtr->syncMutex);
+        sessionPtr->syncCount++;
+        sessionPtr->lastSyncTime = currentXrTime();
+        sessionPtr->activeActionSets.clear();
+        for (uint32_t i = 0; i < syncInfo->countActiveActionSets; ++i) {
+            sessionPtr->activeActionSets.push_back(syncInfo->activeActionSets[i].actionSet);
+        }
+    }
+
     return XR_SUCCESS;
 }
 
@@ -2095,7 +2877,7 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrStopHapticFeedback(XrSession session
     return XR_SUCCESS;
 }
 
-XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrCreateActionSpace(XrSession session, const XrActionSpaceCreateInfo* /*createInfo*/,
+XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrCreateActionSpace(XrSession session, const XrActionSpaceCreateInfo* createInfo,
                                                               XrSpace* space) {
     // TODO CTS: https://gitlab.khronos.org/openxr/openxr/-/issues/2485#core-functions
     // if (!validateQuat(createInfo->poseInReferenceSpace.orientation)) {
@@ -2108,6 +2890,13 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrCreateActionSpace(XrSession session,
     *space = promoteToHandle<XrSpace, XrSpace_T>(spacePtr.get());
     spacePtr->session = session;
     spacePtr->spaceType = XrSpace_T::SpaceType::ActionSpace;
+    spacePtr->poseInActionSpace = createInfo->poseInActionSpace;
+    if (sessionPtr->trajectory != nullptr && createInfo->subactionPath != XR_NULL_PATH) {
+        const XrAction_T* actionPtr = demoteFromHandle<XrAction, XrAction_T>(createInfo->action);
+        const char* pose = actionPtr->actionName.find("aim") != std::string::npos ? "/input/aim/pose" : "/input/grip/pose";
+        const std::string role = pathToStdString(sessionPtr->instance, createInfo->subactionPath) + pose;
+        spacePtr->trajectoryTrack = sessionPtr->trajectory->FindTrack(role);
+    }
 
     {
         std::unique_lock<std::mutex> lock(sessionPtr->spacesMutex);
@@ -2118,8 +2907,22 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrCreateActionSpace(XrSession session,
 }
 
 //
-// Unimplemented graphics bindings functions
+// Frame loop
 //
+
+// Wake-up delay of vsync index, in [0, jitter]; the same for a given seed whatever the call order.
+XrDuration vsyncJitter(const FramePacer& pacer, uint64_t vsync) {
+    if (pacer.jitter == 0) {
+        return 0;
+    }
+    // splitmix64
+    uint64_t z = pacer.seed + vsync * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z = z ^ (z >> 31);
+    return static_cast<XrDuration>(z % static_cast<uint64_t>(pacer.jitter + 1));
+}
+
 XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrWaitFrame(XrSession session, const XrFrameWaitInfo* /*frameWaitInfo*/,
                                                       XrFrameState* frameState) {
     XrSession_T* sessionPtr = demoteFromHandle<XrSession, XrSession_T>(session);
@@ -2127,22 +2930,103 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrWaitFrame(XrSession session, const X
         return XR_ERROR_SESSION_NOT_RUNNING;
     }
 
-    frameState->shouldRender = XR_FALSE;
-    frameState->predictedDisplayTime = currentXrTime();
-    frameState->predictedDisplayPeriod = (1.f / 60.f) * 1e9;  // 60 Hz
+    FramePacer& pacer = sessionPtr->framePacer;
+    std::unique_lock<std::mutex> lock(pacer.mutex);
+    const XrTime now = currentXrTime();
+
+    XrTime vsyncTime = now;
+    XrTime wakeTime = now;
+    XrDuration displayPeriod = static_cast<XrDuration>((1.f / 60.f) * 1e9);  // 60 Hz
+    if (pacer.period > 0) {
+        // Next vsync after the previous frame's that is still ahead of us, skipping the ones the
+        // compositor misses.
+        const uint64_t nextVsync = static_cast<uint64_t>((now - pacer.startTime) / pacer.period) + 1;
+        uint64_t vsync = std::max(pacer.lastVsync + 1, nextVsync);
+        pacer.skippedVsyncs += vsync - (pacer.lastVsync + 1);
+        while (pacer.missedFrameInterval > 0 && vsync % pacer.missedFrameInterval == 0) {
+            ++pacer.missedVsyncs;
+            ++vsync;
+        }
+        pacer.lastVsync = vsync;
+        vsyncTime = pacer.startTime + static_cast<XrDuration>(vsync) * pacer.period;
+        wakeTime = vsyncTime + vsyncJitter(pacer, vsync);
+        displayPeriod = pacer.period;
+    }
+    // Shown at the vsync after the one that woke the application.
+    const XrTime displayTime = vsyncTime + displayPeriod;
+
+    if (wakeTime > now) {
+        lock.unlock();
+        sleepUntilXrTime(wakeTime);
+        lock.lock();
+    }
+
+    pacer.frameWaited = true;
+    pacer.waitedWakeTime = wakeTime;
+    pacer.waitedDisplayTime = displayTime;
+    ++pacer.framesWaited;
+
+    frameState->shouldRender = (sessionPtr->sessionState == XR_SESSION_STATE_VISIBLE ||
+                                sessionPtr->sessionState == XR_SESSION_STATE_FOCUSED)
+                                   ? XR_TRUE
+                                   : XR_FALSE;
+    frameState->predictedDisplayTime = displayTime;
+    frameState->predictedDisplayPeriod = displayPeriod;
     return XR_SUCCESS;
 }
 
-XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrBeginFrame(XrSession /*session*/, const XrFrameBeginInfo* /*frameBeginInfo*/) {
-    return XR_SUCCESS;
+XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrBeginFrame(XrSession session, const XrFrameBeginInfo* /*frameBeginInfo*/) {
+    XrSession_T* sessionPtr = demoteFromHandle<XrSession, XrSession_T>(session);
+    if (!sessionPtr->hasBegun) {
+        return XR_ERROR_SESSION_NOT_RUNNING;
+    }
+
+    FramePacer& pacer = sessionPtr->framePacer;
+    std::unique_lock<std::mutex> lock(pacer.mutex);
+    if (!pacer.frameWaited) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    pacer.frameWaited = false;
+    ++pacer.framesBegun;
+
+    // A frame begun and not ended is discarded by the next xrBeginFrame.
+    const bool discarded = pacer.frameBegun;
+    if (discarded) {
+        ++pacer.framesDiscarded;
+    }
+    pacer.frameBegun = true;
+    pacer.begunWakeTime = pacer.waitedWakeTime;
+    pacer.begunDisplayTime = pacer.waitedDisplayTime;
+    return discarded ? XR_FRAME_DISCARDED : XR_SUCCESS;
 }
 
-XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrEndFrame(XrSession /*session*/, const XrFrameEndInfo* /*frameEndInfo*/) {
+XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrEndFrame(XrSession session, const XrFrameEndInfo* /*frameEndInfo*/) {
+    XrSession_T* sessionPtr = demoteFromHandle<XrSession, XrSession_T>(session);
+    if (!sessionPtr->hasBegun) {
+        return XR_ERROR_SESSION_NOT_RUNNING;
+    }
+
+    FramePacer& pacer = sessionPtr->framePacer;
+    std::unique_lock<std::mutex> lock(pacer.mutex);
+    if (!pacer.frameBegun) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    pacer.frameBegun = false;
+    ++pacer.framesEnded;
+
+    // The frame is late if it reaches the compositor after the vsync it was meant to be shown at.
+    const XrTime now = currentXrTime();
+    if (now > pacer.begunDisplayTime) {
+        ++pacer.lateEndFrames;
+    }
+    const XrDuration frameTime = now - pacer.begunWakeTime;
+    pacer.totalFrameTime += frameTime;
+    pacer.maxFrameTime = std::max(pacer.maxFrameTime, frameTime);
     return XR_SUCCESS;
 }
 
 XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrLocateViews(XrSession session, const XrViewLocateInfo* viewLocateInfo,
-                                                        XrViewState* /*viewState*/, uint32_t viewCapacityInput,
+                                                        XrViewState* viewState, uint32_t viewCapacityInput,
                                                         uint32_t* viewCountOutput, XrView* views) {
     XrSession_T* sessionPtr = demoteFromHandle<XrSession, XrSession_T>(session);
 
@@ -2162,6 +3046,38 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrLocateViews(XrSession session, const
         locatedView.fov.angleDown = -1.f;
     };
 
+    if (sessionPtr->trajectory != nullptr) {
+        TrajectorySample sample;
+        sessionPtr->trajectory->Sample(viewLocateInfo->displayTime - sessionPtr->trajectoryStart, &sample);
+
+        XrPosef worldFromBase;
+        XrVector3f linearVelocity;
+        XrVector3f angularVelocity;
+        if (!trajectorySpacePose(*demoteFromHandle<XrSpace, XrSpace_T>(viewLocateInfo->space), sample, &worldFromBase,
+                                 &linearVelocity, &angularVelocity)) {
+            viewState->viewStateFlags = 0;
+        } else {
+            XrPosef worldFromHead;
+            XrPosef_CreateIdentity(&worldFromHead);
+            if (sessionPtr->trajectoryHeadTrack >= 0) {
+                worldFromHead = sample.Pose(static_cast<uint32_t>(sessionPtr->trajectoryHeadTrack));
+            }
+            XrPosef baseFromWorld;
+            XrPosef_Invert(&baseFromWorld, &worldFromBase);
+            XrPosef baseFromHead;
+            XrPosef_Multiply(&baseFromHead, &baseFromWorld, &worldFromHead);
+
+            for (size_t eye = 0; eye < locatedViews.size(); ++eye) {
+                XrPosef headFromEye;
+                XrPosef_CreateIdentity(&headFromEye);
+                headFromEye.position.x = eye == 0 ? -cTrajectoryHalfIpd : cTrajectoryHalfIpd;
+                XrPosef_Multiply(&locatedViews[eye].pose, &baseFromHead, &headFromEye);
+            }
+            viewState->viewStateFlags = XR_VIEW_STATE_ORIENTATION_VALID_BIT | XR_VIEW_STATE_POSITION_VALID_BIT |
+                                        XR_VIEW_STATE_ORIENTATION_TRACKED_BIT | XR_VIEW_STATE_POSITION_TRACKED_BIT;
+        }
+    }
+
     return XrElementCapacityWrite(viewCapacityInput, viewCountOutput, views, locatedViews.data(), locatedViews.size());
 }
 
@@ -2211,40 +3127,295 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrGetViewConfigurationProperties(XrIns
     return XR_SUCCESS;
 }
 
-XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrEnumerateSwapchainFormats(XrSession /*session*/, uint32_t formatCapacityInput,
+struct CpuSwapchainFormat {
+    int64_t format;
+    uint32_t bytesPerPixel;
+};
+
+// Preferred formats first.
+constexpr std::array<CpuSwapchainFormat, 4> cCpuSwapchainFormats{{
+    {XR_SWAPCHAIN_FORMAT_R8G8B8A8_SRGB_TEST, 4},
+    {XR_SWAPCHAIN_FORMAT_R8G8B8A8_UNORM_TEST, 4},
+    {XR_SWAPCHAIN_FORMAT_R16G16B16A16_SFLOAT_TEST, 8},
+    {XR_SWAPCHAIN_FORMAT_D32_SFLOAT_TEST, 4},
+}};
+
+#ifdef RUNTIME_TEST_EGL_OPENGL
+constexpr uint32_t cGlTexture2D = 0x0DE1;
+constexpr uint32_t cGlTexture2DArray = 0x8C1A;
+constexpr uint32_t cGlTextureBinding2D = 0x8069;
+constexpr uint32_t cGlTextureBinding2DArray = 0x8C1D;
+
+constexpr std::array<int64_t, 4> cOpenGLSwapchainFormats{{
+    0x8C43,  // GL_SRGB8_ALPHA8
+    0x8058,  // GL_RGBA8
+    0x881A,  // GL_RGBA16F
+    0x8CAC,  // GL_DEPTH_COMPONENT32F
+}};
+
+XrResult createOpenGLImages(const EglOpenGL& egl, const XrSwapchainCreateInfo* createInfo, uint32_t imageCount,
+                            XrSwapchain_T* swapchainPtr) {
+    if (std::find(cOpenGLSwapchainFormats.begin(), cOpenGLSwapchainFormats.end(), createInfo->format) ==
+        cOpenGLSwapchainFormats.end()) {
+        return XR_ERROR_SWAPCHAIN_FORMAT_UNSUPPORTED;
+    }
+
+    EglContextScope scope(egl);
+    if (scope.Failed()) {
+        return XR_ERROR_GRAPHICS_DEVICE_INVALID;
+    }
+
+    const bool isArray = createInfo->arraySize > 1;
+    const uint32_t target = isArray ? cGlTexture2DArray : cGlTexture2D;
+    int32_t previousTexture = 0;
+    egl.getIntegerv(isArray ? cGlTextureBinding2DArray : cGlTextureBinding2D, &previousTexture);
+
+    swapchainPtr->glImages.resize(imageCount);
+    egl.genTextures(static_cast<int32_t>(imageCount), swapchainPtr->glImages.data());
+    for (uint32_t texture : swapchainPtr->glImages) {
+        egl.bindTexture(target, texture);
+        if (isArray) {
+            egl.texStorage3D(target, static_cast<int32_t>(createInfo->mipCount), static_cast<uint32_t>(createInfo->format),
+                             static_cast<int32_t>(createInfo->width), static_cast<int32_t>(createInfo->height),
+                             static_cast<int32_t>(createInfo->arraySize));
+        } else {
+            egl.texStorage2D(target, static_cast<int32_t>(createInfo->mipCount), static_cast<uint32_t>(createInfo->format),
+                             static_cast<int32_t>(createInfo->width), static_cast<int32_t>(createInfo->height));
+        }
+    }
+    egl.bindTexture(target, static_cast<uint32_t>(previousTexture));
+    return XR_SUCCESS;
+}
+#endif  // RUNTIME_TEST_EGL_OPENGL
+
+XrResult createCpuImages(const XrSwapchainCreateInfo* createInfo, uint32_t imageCount, XrSwapchain_T* swapchainPtr) {
+    const auto& it = std::find_if(cCpuSwapchainFormats.begin(), cCpuSwapchainFormats.end(),
+                                  [createInfo](const auto& i) { return i.format == createInfo->format; });
+    if (it == cCpuSwapchainFormats.end()) {
+        return XR_ERROR_SWAPCHAIN_FORMAT_UNSUPPORTED;
+    }
+    if (createInfo->mipCount != 1) {
+        return XR_ERROR_FEATURE_UNSUPPORTED;
+    }
+
+    constexpr uint64_t alignment = 64;
+    const uint64_t rowPitch = (uint64_t{createInfo->width} * it->bytesPerPixel + alignment - 1) & ~(alignment - 1);
+    const uint64_t imageSize = rowPitch * createInfo->height * createInfo->arraySize;
+
+    swapchainPtr->memory.reset(new (std::nothrow) uint8_t[imageSize * imageCount + alignment - 1]());
+    if (swapchainPtr->memory == nullptr) {
+        return XR_ERROR_OUT_OF_MEMORY;
+    }
+
+    const auto address = reinterpret_cast<uintptr_t>(swapchainPtr->memory.get());
+    uint8_t* data = swapchainPtr->memory.get() + ((alignment - address % alignment) % alignment);
+    for (uint32_t i = 0; i < imageCount; ++i) {
+        XrSwapchainImageCpuTEST image{XR_TYPE_SWAPCHAIN_IMAGE_CPU_TEST};
+        image.data = data + i * imageSize;
+        image.size = imageSize;
+        image.rowPitch = static_cast<uint32_t>(rowPitch);
+        swapchainPtr->cpuImages.push_back(image);
+    }
+    return XR_SUCCESS;
+}
+
+uint32_t swapchainImageCount() {
+    constexpr uint32_t defaultImageCount = 3;
+    const char* value = getenv("XR_TEST_RUNTIME_SWAPCHAIN_IMAGE_COUNT");
+    if (value == nullptr) {
+        return defaultImageCount;
+    }
+    const long count = strtol(value, nullptr, 10);
+    return (count >= 1 && count <= 16) ? static_cast<uint32_t>(count) : defaultImageCount;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrEnumerateSwapchainFormats(XrSession session, uint32_t formatCapacityInput,
                                                                       uint32_t* formatCountOutput, int64_t* formats) {
-    std::array<int64_t, 0> knownFormats{};
+#ifdef RUNTIME_TEST_EGL_OPENGL
+    XrSession_T* sessionPtr = demoteFromHandle<XrSession, XrSession_T>(session);
+    if (sessionPtr->eglOpenGL != nullptr) {
+        return ElementCapacityWrite(formatCapacityInput, formatCountOutput, formats, cOpenGLSwapchainFormats.data(),
+                                    cOpenGLSwapchainFormats.size());
+    }
+#else
+    (void)session;
+#endif  // RUNTIME_TEST_EGL_OPENGL
+
+    std::array<int64_t, cCpuSwapchainFormats.size()> knownFormats{};
+    std::transform(cCpuSwapchainFormats.begin(), cCpuSwapchainFormats.end(), knownFormats.begin(),
+                   [](const auto& i) { return i.format; });
     return ElementCapacityWrite(formatCapacityInput, formatCountOutput, formats, knownFormats.data(), knownFormats.size());
 }
 
-XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrCreateSwapchain(XrSession /*session*/, const XrSwapchainCreateInfo* /*createInfo*/,
-                                                            XrSwapchain* /*swapchain*/) {
-    return XR_ERROR_FUNCTION_UNSUPPORTED;
+XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrCreateSwapchain(XrSession session, const XrSwapchainCreateInfo* createInfo,
+                                                            XrSwapchain* swapchain) {
+    XrSession_T* sessionPtr = demoteFromHandle<XrSession, XrSession_T>(session);
+
+    if ((createInfo->createFlags & XR_SWAPCHAIN_CREATE_PROTECTED_CONTENT_BIT) != 0) {
+        return XR_ERROR_FEATURE_UNSUPPORTED;
+    }
+    if (createInfo->width == 0 || createInfo->height == 0 || createInfo->arraySize == 0 || createInfo->mipCount == 0 ||
+        createInfo->width > cMaxSwapchainImageSize || createInfo->height > cMaxSwapchainImageSize) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (createInfo->faceCount != 1 || createInfo->sampleCount != 1) {
+        return XR_ERROR_FEATURE_UNSUPPORTED;
+    }
+
+    auto swapchainPtr = std::make_unique<XrSwapchain_T>();
+    swapchainPtr->session = session;
+    swapchainPtr->format = createInfo->format;
+    swapchainPtr->width = createInfo->width;
+    swapchainPtr->height = createInfo->height;
+    swapchainPtr->arraySize = createInfo->arraySize;
+    swapchainPtr->isStatic = (createInfo->createFlags & XR_SWAPCHAIN_CREATE_STATIC_IMAGE_BIT) != 0;
+
+    const uint32_t imageCount = swapchainPtr->isStatic ? 1 : swapchainImageCount();
+
+    XrResult result = XR_SUCCESS;
+#ifdef RUNTIME_TEST_EGL_OPENGL
+    if (sessionPtr->eglOpenGL != nullptr) {
+        result = createOpenGLImages(*sessionPtr->eglOpenGL, createInfo, imageCount, swapchainPtr.get());
+    } else
+#endif  // RUNTIME_TEST_EGL_OPENGL
+    {
+        result = createCpuImages(createInfo, imageCount, swapchainPtr.get());
+    }
+    if (XR_FAILED(result)) {
+        return result;
+    }
+
+    *swapchain = promoteToHandle<XrSwapchain, XrSwapchain_T>(swapchainPtr.get());
+
+    {
+        std::unique_lock<std::mutex> lock(sessionPtr->swapchainsMutex);
+        sessionPtr->swapchains.push_back(std::move(swapchainPtr));
+    }
+
+    return XR_SUCCESS;
 }
 
-XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrDestroySwapchain(XrSwapchain /*swapchain*/) { return XR_ERROR_FUNCTION_UNSUPPORTED; }
+XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrDestroySwapchain(XrSwapchain swapchain) {
+    {
+        XrSwapchain_T* swapchainPtr = demoteFromHandle<XrSwapchain, XrSwapchain_T>(swapchain);
+        XrSession_T* sessionPtr = demoteFromHandle<XrSession, XrSession_T>(swapchainPtr->session);
+        std::unique_lock<std::mutex> lock(sessionPtr->swapchainsMutex);
+        const auto& it = std::find_if(sessionPtr->swapchains.begin(), sessionPtr->swapchains.end(),
+                                      [swapchainPtr](const auto& i) { return swapchainPtr == i.get(); });
+        if (it == sessionPtr->swapchains.end()) {
+            return XR_ERROR_HANDLE_INVALID;
+        }
+        sessionPtr->swapchains.erase(it);
+    }
 
-XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrEnumerateSwapchainImages(XrSwapchain /*swapchain*/, uint32_t /*imageCapacityInput*/,
-                                                                     uint32_t* /*imageCountOutput*/,
-                                                                     XrSwapchainImageBaseHeader* /*images*/) {
-    return XR_ERROR_FUNCTION_UNSUPPORTED;
+    return XR_SUCCESS;
 }
 
-XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrAcquireSwapchainImage(XrSwapchain /*swapchain*/,
+XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrEnumerateSwapchainImages(XrSwapchain swapchain, uint32_t imageCapacityInput,
+                                                                     uint32_t* imageCountOutput,
+                                                                     XrSwapchainImageBaseHeader* images) {
+    XrSwapchain_T* swapchainPtr = demoteFromHandle<XrSwapchain, XrSwapchain_T>(swapchain);
+
+    if (imageCountOutput == nullptr) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+
+    const bool isOpenGL = !swapchainPtr->glImages.empty();
+    const auto imageCount = static_cast<uint32_t>(isOpenGL ? swapchainPtr->glImages.size() : swapchainPtr->cpuImages.size());
+    *imageCountOutput = imageCount;
+
+    // request only
+    if (imageCapacityInput == 0) {
+        return XR_SUCCESS;
+    }
+
+    if (imageCapacityInput < imageCount) {
+        return XR_ERROR_SIZE_INSUFFICIENT;
+    }
+
+#ifdef RUNTIME_TEST_EGL_OPENGL
+    if (isOpenGL) {
+        if (images->type != XR_TYPE_SWAPCHAIN_IMAGE_OPENGL_KHR) {
+            return XR_ERROR_VALIDATION_FAILURE;
+        }
+        auto glImages = reinterpret_cast<XrSwapchainImageOpenGLKHR*>(images);
+        for (uint32_t i = 0; i < imageCount; ++i) {
+            glImages[i].image = swapchainPtr->glImages[i];
+        }
+        return XR_SUCCESS;
+    }
+#endif  // RUNTIME_TEST_EGL_OPENGL
+
+    if (images->type != XR_TYPE_SWAPCHAIN_IMAGE_CPU_TEST) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    auto cpuImages = reinterpret_cast<XrSwapchainImageCpuTEST*>(images);
+    for (uint32_t i = 0; i < imageCount; ++i) {
+        cpuImages[i].data = swapchainPtr->cpuImages[i].data;
+        cpuImages[i].size = swapchainPtr->cpuImages[i].size;
+        cpuImages[i].rowPitch = swapchainPtr->cpuImages[i].rowPitch;
+    }
+    return XR_SUCCESS;
+}
+
+// Images are handed out in order.  Nothing but the application writes to them, so an acquired image
+// is ready as soon as it is waited on.
+XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrAcquireSwapchainImage(XrSwapchain swapchain,
                                                                   const XrSwapchainImageAcquireInfo* /*acquireInfo*/,
-                                                                  uint32_t* /*index*/) {
-    return XR_ERROR_FUNCTION_UNSUPPORTED;
+                                                                  uint32_t* index) {
+    XrSwapchain_T* swapchainPtr = demoteFromHandle<XrSwapchain, XrSwapchain_T>(swapchain);
+    const auto imageCount = static_cast<uint32_t>(std::max(swapchainPtr->glImages.size(), swapchainPtr->cpuImages.size()));
+
+    std::unique_lock<std::mutex> lock(swapchainPtr->imagesMutex);
+    if (swapchainPtr->acquiredImages.size() == imageCount || (swapchainPtr->isStatic && swapchainPtr->staticImageAcquired)) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    swapchainPtr->staticImageAcquired = swapchainPtr->isStatic;
+
+    *index = swapchainPtr->nextImage;
+    swapchainPtr->acquiredImages.push_back(swapchainPtr->nextImage);
+    swapchainPtr->nextImage = (swapchainPtr->nextImage + 1) % imageCount;
+    return XR_SUCCESS;
 }
 
-XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrWaitSwapchainImage(XrSwapchain /*swapchain*/,
+XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrWaitSwapchainImage(XrSwapchain swapchain,
                                                                const XrSwapchainImageWaitInfo* /*waitInfo*/) {
-    return XR_ERROR_FUNCTION_UNSUPPORTED;
+    XrSwapchain_T* swapchainPtr = demoteFromHandle<XrSwapchain, XrSwapchain_T>(swapchain);
+
+    std::unique_lock<std::mutex> lock(swapchainPtr->imagesMutex);
+    if (swapchainPtr->acquiredImages.empty() || swapchainPtr->imageWaited) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    swapchainPtr->imageWaited = true;
+    return XR_SUCCESS;
 }
 
-XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrReleaseSwapchainImage(XrSwapchain /*swapchain*/,
+XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrReleaseSwapchainImage(XrSwapchain swapchain,
                                                                   const XrSwapchainImageReleaseInfo* /*releaseInfo*/) {
-    return XR_ERROR_FUNCTION_UNSUPPORTED;
+    XrSwapchain_T* swapchainPtr = demoteFromHandle<XrSwapchain, XrSwapchain_T>(swapchain);
+
+    std::unique_lock<std::mutex> lock(swapchainPtr->imagesMutex);
+    if (!swapchainPtr->imageWaited) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    swapchainPtr->acquiredImages.pop_front();
+    swapchainPtr->imageWaited = false;
+    return XR_SUCCESS;
+}
+
+#ifdef RUNTIME_TEST_EGL_OPENGL
+XRAPI_ATTR XrResult XRAPI_CALL
+RuntimeTestXrGetOpenGLGraphicsRequirementsKHR(XrInstance /*instance*/, XrSystemId systemId,
+                                              XrGraphicsRequirementsOpenGLKHR* graphicsRequirements) {
+    if (systemId != VALID_SYSTEM_ID) {
+        return XR_ERROR_SYSTEM_INVALID;
+    }
+    // glTexStorage2D/glTexStorage3D
+    graphicsRequirements->minApiVersionSupported = XR_MAKE_VERSION(4, 2, 0);
+    graphicsRequirements->maxApiVersionSupported = XR_MAKE_VERSION(4, 6, 0);
+    return XR_SUCCESS;
 }
+#endif  // RUNTIME_TEST_EGL_OPENGL
 
 //
 // xrGetInstanceProcAddr
@@ -2269,6 +3440,17 @@ XRAPI_ATTR XrResult XRAPI_CALL RuntimeTestXrGetInstanceProcAddr(XrInstance insta
         return XR_ERROR_HANDLE_INVALID;
     }
 
+#ifdef RUNTIME_TEST_EGL_OPENGL
+    if (0 == strcmp(name, "xrGetOpenGLGraphicsRequirementsKHR")) {
+        XrInstance_T* instancePtr = demoteFromHandle<XrInstance, XrInstance_T>(instance);
+        if (std::find(instancePtr->enabledExtensions.begin(), instancePtr->enabledExtensions.end(),
+                      XR_KHR_OPENGL_ENABLE_EXTENSION_NAME) != instancePtr->enabledExtensions.end()) {
+            *function = reinterpret_cast<PFN_xrVoidFunction>(RuntimeTestXrGetOpenGLGraphicsRequirementsKHR);
+            return XR_SUCCESS;
+        }
+    }
+#endif  // RUNTIME_TEST_EGL_OPENGL
+
 #define FUNCTIONINFO(functionName, _)                                                  \
     if (strcmp(name, "xr" #functionName) == 0) {                                       \
         *function = reinterpret_cast<PFN_xrVoidFunction>(RuntimeTestXr##functionName); \
@@ -0,0 +1,62 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Host memory swapchains of test_runtime.
+//
+// A session created without a graphics binding (for example with XR_MND_headless) gets swapchains
+// whose images live in host memory.  xrEnumerateSwapchainFormats returns the formats below, and
+// xrEnumerateSwapchainImages fills XrSwapchainImageCpuTEST structures.  None of this is part of the
+// OpenXR registry: the structure type and format values are private to test_runtime.
+//
+// The number of images in each swapchain is read from XR_TEST_RUNTIME_SWAPCHAIN_IMAGE_COUNT when the
+// swapchain is created (default 3).
+//
+// Where the build has EGL and OpenGL, a session created with XrGraphicsBindingEGLMNDX (for example on a
+// Mesa surfaceless context) gets OpenGL textures instead, enumerated as XrSwapchainImageOpenGLKHR.
+//
+
+#pragma once
+
+#include <openxr/openxr.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Values from 1000000000 up are allocated to extensions in blocks of 1000 (1000000000 + (number - 1) * 1000),
+// so any of them may one day belong to a registered extension.  Core structure types are numbered upward
+// from 1 and are nowhere near the top of the range below the extension base, so this one sits there.
+#define XR_TYPE_SWAPCHAIN_IMAGE_CPU_TEST ((XrStructureType)999999000U)
+
+// Format values match the VkFormat of the same layout.
+#define XR_SWAPCHAIN_FORMAT_R8G8B8A8_UNORM_TEST 37
+#define XR_SWAPCHAIN_FORMAT_R8G8B8A8_SRGB_TEST 43
+#define XR_SWAPCHAIN_FORMAT_R16G16B16A16_SFLOAT_TEST 97
+#define XR_SWAPCHAIN_FORMAT_D32_SFLOAT_TEST 126
+
+// Image i of a swapchain.  Layers are stored one after the other, each rowPitch * height bytes;
+// rowPitch and data are 64-byte aligned.  The memory stays valid until the swapchain is destroyed.
+typedef struct XrSwapchainImageCpuTEST {
+    XrStructureType type;
+    void* XR_MAY_ALIAS next;
+    void* data;
+    uint64_t size;
+    uint32_t rowPitch;
+} XrSwapchainImageCpuTEST;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,67 @@
+// Copyright (c) 2017-2026 The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Recorded trajectories played back by test_runtime.
+//
+// When XR_TEST_RUNTIME_TRAJECTORY_FILE names a trajectory file at xrCreateSession, the session maps the
+// file and answers xrLocateViews, xrLocateSpace and xrLocateSpaces by interpolating its tracks at the
+// requested time.  Sample times count from xrBeginSession (from xrCreateSession before that); times
+// before the first sample get the first sample, and playback loops after the last one.
+//
+// Every track has a role path.  "/user/head" drives the views and the VIEW reference space.  An action
+// space follows the track "<subaction path>/input/aim/pose" when its action name contains "aim", and
+// "<subaction path>/input/grip/pose" otherwise, e.g. "/user/hand/left/input/grip/pose" or
+// "/user/vive_tracker_htcx/role/waist/input/grip/pose".  Tracks are in the LOCAL reference space; STAGE
+// and LOCAL_FLOOR coincide with it.
+//
+// File layout, native byte order, no padding:
+//   XrTrajectoryFileHeaderTEST
+//   XrTrajectoryTrackTEST[trackCount]
+//   int64_t[sampleCount]               sample times in nanoseconds, strictly increasing
+//   float[sampleCount][7][trackCount]  position x, y, z and orientation x, y, z, w of every track
+//
+// Each sample stores its seven components as arrays over the tracks, so that all tracks are interpolated
+// together with straight loops over contiguous floats.
+//
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define XR_TRAJECTORY_FILE_MAGIC_TEST "XRTRAJ1"
+#define XR_TRAJECTORY_FILE_VERSION_TEST 1
+#define XR_TRAJECTORY_MAX_TRACKS_TEST 64
+#define XR_TRAJECTORY_ROLE_SIZE_TEST 64
+
+typedef struct XrTrajectoryFileHeaderTEST {
+    char magic[8];  // XR_TRAJECTORY_FILE_MAGIC_TEST, with its terminator
+    uint32_t version;
+    uint32_t trackCount;  // 1 to XR_TRAJECTORY_MAX_TRACKS_TEST
+    uint64_t sampleCount;  // at least 1
+    uint64_t reserved;
+} XrTrajectoryFileHeaderTEST;
+
+typedef struct XrTrajectoryTrackTEST {
+    char role[XR_TRAJECTORY_ROLE_SIZE_TEST];  // null-terminated path
+} XrTrajectoryTrackTEST;
+
+#ifdef __cplusplus
+}
+#endif